@@ -0,0 +1,62 @@
+#include <nano/ui/animation.h>
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+// Evaluates 50k concurrent float animations (mixed easings and springs) and
+// reports the cost of one animator::update() pass.
+int main(int, const char*[]) {
+  constexpr std::size_t animation_count = 50000;
+  constexpr std::size_t frame_count = 600;
+  constexpr double frame_time = 1.0 / 60.0;
+
+  std::vector<float> values(animation_count, 0.0f);
+  nano::animator anim;
+
+  const auto add_animations = [&]() {
+    for (std::size_t i = 0; i < animation_count; i++) {
+      const float to = static_cast<float>(i % 100);
+
+      if (i % 4 == 0) {
+        anim.animate_float(&values[i], to, nano::spring{});
+      }
+      else {
+        // Long enough to stay alive for the whole benchmark.
+        anim.animate_float(&values[i], to, 20.0, static_cast<nano::easing>(i % 7));
+      }
+    }
+  };
+
+  const auto t0 = std::chrono::steady_clock::now();
+  add_animations();
+  const auto t1 = std::chrono::steady_clock::now();
+
+  std::cout << "animations : " << anim.size() << " (" << anim.get_lane_count() << " lanes)" << std::endl;
+  std::cout << "setup      : " << std::chrono::duration<double, std::milli>(t1 - t0).count() << " ms" << std::endl;
+
+  double total = 0;
+  double worst = 0;
+
+  for (std::size_t i = 0; i < frame_count; i++) {
+    const auto start = std::chrono::steady_clock::now();
+    anim.update(frame_time);
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    total += ms;
+    worst = std::max(worst, ms);
+  }
+
+  std::cout << "frames     : " << frame_count << std::endl;
+  std::cout << "remaining  : " << anim.size() << std::endl;
+  std::cout << "avg update : " << total / static_cast<double>(frame_count) << " ms" << std::endl;
+  std::cout << "max update : " << worst << " ms" << std::endl;
+
+  // Retargeting every running animation at once.
+  const auto t2 = std::chrono::steady_clock::now();
+  add_animations();
+  const auto t3 = std::chrono::steady_clock::now();
+  std::cout << "retarget   : " << std::chrono::duration<double, std::milli>(t3 - t2).count() << " ms" << std::endl;
+
+  anim.cancel_all();
+  return 0;
+}
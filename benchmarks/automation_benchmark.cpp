@@ -0,0 +1,109 @@
+#include <nano/ui/automation.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+using ms_duration = std::chrono::duration<double, std::milli>;
+
+constexpr std::size_t point_count = 10000000;
+constexpr std::size_t column_count = 2000;
+
+/// the columns of a view by visiting every point, as without the index.
+void get_linear_columns(const std::vector<nano::automation_point>& points, double start_time, double time_per_column,
+    std::size_t count, nano::automation_column* columns) {
+  const auto first = std::lower_bound(points.begin(), points.end(), start_time,
+      [](const nano::automation_point& p, double t) { return p.time < t; });
+
+  auto it = first;
+  for (std::size_t i = 0; i < count; i++) {
+    const double end_time = start_time + static_cast<double>(i + 1) * time_per_column;
+    nano::automation_column r = { 1.0f, 0.0f };
+    for (; it != points.end() && it->time <= end_time; ++it) {
+      r.min = std::min(r.min, it->value);
+      r.max = std::max(r.max, it->value);
+    }
+
+    columns[i] = r;
+  }
+}
+} // namespace.
+
+// A curve of 10 million breakpoints, one every millisecond. The columns of a
+// 2000 point wide view are computed at zooms from one point per column to the
+// whole curve, compared with a scan of the visible points. The range of random
+// spans, edits and hit tests are timed at random times on the full curve.
+int main(int, const char*[]) {
+  std::mt19937 rng(1);
+  std::uniform_real_distribution<float> value(0.0f, 1.0f);
+
+  std::vector<nano::automation_point> points(point_count);
+  for (std::size_t i = 0; i < point_count; i++) {
+    points[i] = { static_cast<double>(i) * 0.001, value(rng) };
+  }
+
+  nano::automation_curve curve;
+  auto start = std::chrono::steady_clock::now();
+  curve.assign(points);
+  std::cout << "assign " << point_count << " points : " << ms_duration(std::chrono::steady_clock::now() - start).count()
+            << " ms, " << curve.get_chunk_count() << " chunks" << std::endl;
+
+  std::vector<nano::automation_column> columns(column_count);
+  const double duration = static_cast<double>(point_count) * 0.001;
+
+  for (double points_per_column : { 1.0, 10.0, 100.0, 1000.0, 5000.0 }) {
+    const double time_per_column = points_per_column * 0.001;
+    const double start_time = std::max(duration * 0.5 - time_per_column * column_count, 0.0);
+    constexpr int iterations = 20;
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+      curve.get_columns(start_time, time_per_column, column_count, columns.data());
+    }
+    const double indexed_ms = ms_duration(std::chrono::steady_clock::now() - start).count() / iterations;
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+      get_linear_columns(points, start_time, time_per_column, column_count, columns.data());
+    }
+    const double linear_ms = ms_duration(std::chrono::steady_clock::now() - start).count() / iterations;
+
+    std::cout << points_per_column << " points per column : indexed " << indexed_ms << " ms, linear scan "
+              << linear_ms << " ms" << std::endl;
+  }
+
+  std::uniform_real_distribution<double> time(0.0, duration);
+  constexpr int edit_count = 100000;
+
+  // The range of long spans, as for the selection or the scale of a lane.
+  float sum = 0.0f;
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < edit_count; i++) {
+    const double a = time(rng);
+    const double b = time(rng);
+    sum += curve.get_range(std::min(a, b), std::max(a, b)).max;
+  }
+  std::cout << "range of random spans : "
+            << ms_duration(std::chrono::steady_clock::now() - start).count() * 1000.0 / edit_count << " us, " << sum
+            << std::endl;
+
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < edit_count; i++) {
+    curve.erase(curve.insert({ time(rng), value(rng) }));
+  }
+  const double edit_us = ms_duration(std::chrono::steady_clock::now() - start).count() * 1000.0 / edit_count;
+  std::cout << "insert and erase : " << edit_us << " us" << std::endl;
+
+  nano::automation_curve::position p;
+  int hits = 0;
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < edit_count; i++) {
+    hits += curve.hit_test(time(rng), value(rng), 0.005, 0.05f, p) ? 1 : 0;
+  }
+  std::cout << "hit test : " << ms_duration(std::chrono::steady_clock::now() - start).count() * 1000.0 / edit_count
+            << " us, " << hits << " hits" << std::endl;
+  return 0;
+}
@@ -0,0 +1,136 @@
+#include <nano/ui/backing_store.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace {
+using ms_duration = std::chrono::duration<double, std::milli>;
+
+std::atomic<std::uint64_t> allocation_count = 0;
+std::atomic<std::uint64_t> allocated_bytes = 0;
+
+// Only buffer sized allocations are counted.
+constexpr std::size_t counted_size = 64 * 1024;
+
+struct sweep_result {
+  std::uint64_t allocations = 0;
+  std::uint64_t bytes = 0;
+  double ms = 0;
+};
+
+/// the window sizes of a live resize, one per frame, from 800x600 to 1920x1200 and back.
+std::vector<nano::size<int>> get_sweep_sizes() {
+  std::vector<nano::size<int>> sizes;
+  constexpr int step_count = 120;
+
+  for (int i = 0; i <= step_count; i++) {
+    sizes.emplace_back(800 + 1120 * i / step_count, 600 + 600 * i / step_count);
+  }
+
+  for (int i = step_count - 1; i >= 0; i--) {
+    sizes.push_back(sizes[static_cast<std::size_t>(i)]);
+  }
+
+  return sizes;
+}
+
+/// runs the sweep in each window, every frame is entirely redrawn as after any resize.
+template <class Resize>
+sweep_result run_sweep(const std::vector<nano::size<int>>& sizes, int window_count, Resize&& resize) {
+  const std::uint64_t count = allocation_count;
+  const std::uint64_t bytes = allocated_bytes;
+  const auto start = std::chrono::steady_clock::now();
+
+  for (int w = 0; w < window_count; w++) {
+    for (const nano::size<int>& size : sizes) {
+      nano::pixel_buffer& buffer = resize(w, size);
+      buffer.fill(buffer.get_bounds(), nano::make_pixel(30, 30, 30, 255));
+    }
+  }
+
+  sweep_result r;
+  r.ms = ms_duration(std::chrono::steady_clock::now() - start).count();
+  r.allocations = allocation_count - count;
+  r.bytes = allocated_bytes - bytes;
+  return r;
+}
+
+void print(const char* name, const sweep_result& r, std::size_t frame_count) {
+  std::cout << name << " : " << r.allocations << " allocations, " << static_cast<double>(r.bytes) / (1024.0 * 1024.0)
+            << " MB allocated, " << r.ms / static_cast<double>(frame_count) << " ms per frame" << std::endl;
+}
+} // namespace.
+
+void* operator new(std::size_t size) {
+  if (size >= counted_size) {
+    allocation_count++;
+    allocated_bytes += size;
+  }
+
+  if (void* p = std::malloc(size ? size : 1)) {
+    return p;
+  }
+
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+// Allocations and bytes allocated by live resize sweeps of a 2x window, when the
+// buffer is resized at every frame and with backing stores sharing a pool.
+// Each window does the sweep in turn, as when resizing several windows.
+int main(int, const char*[]) {
+  constexpr float scale = 2.0f;
+  constexpr int window_count = 3;
+
+  const std::vector<nano::size<int>> sizes = get_sweep_sizes();
+  const std::size_t frame_count = sizes.size() * window_count;
+
+  {
+    std::vector<nano::pixel_buffer> buffers(window_count);
+    const auto resize = [&](int w, const nano::size<int>& size) -> nano::pixel_buffer& {
+      nano::pixel_buffer& buffer = buffers[static_cast<std::size_t>(w)];
+      buffer.resize(static_cast<int>(static_cast<float>(size.width) * scale),
+          static_cast<int>(static_cast<float>(size.height) * scale));
+      return buffer;
+    };
+
+    print("pixel_buffer::resize", run_sweep(sizes, window_count, resize), frame_count);
+  }
+
+  {
+    nano::backing_store_pool pool;
+    std::vector<std::unique_ptr<nano::backing_store>> stores;
+    for (int i = 0; i < window_count; i++) {
+      stores.push_back(std::make_unique<nano::backing_store>(pool));
+    }
+
+    const auto resize = [&](int w, const nano::size<int>& size) -> nano::pixel_buffer& {
+      nano::backing_store& store = *stores[static_cast<std::size_t>(w)];
+      store.resize(size, scale);
+      return store.get_buffer();
+    };
+
+    const sweep_result r = run_sweep(sizes, window_count, resize);
+
+    // The sizes have settled.
+    for (const auto& store : stores) {
+      store->trim(std::chrono::steady_clock::now() + nano::backing_store::settle_delay);
+    }
+
+    print("backing_store       ", r, frame_count);
+
+    const nano::backing_store_pool::stats stats = pool.get_stats();
+    std::cout << "pool : " << stats.allocations << " allocations, " << stats.reuses << " reuses, "
+              << static_cast<double>(stats.pooled_bytes) / (1024.0 * 1024.0) << " MB pooled after trim" << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,81 @@
+#include <nano/ui/blur.h>
+
+#include <chrono>
+#include <iostream>
+
+namespace {
+using ms_duration = std::chrono::duration<double, std::milli>;
+
+void benchmark_blur(const char* name, int width, int height) {
+  constexpr int iterations = 10;
+
+  nano::pixel_buffer buffer(width, height);
+  for (int y = 0; y < height; y++) {
+    for (int x = 0; x < width; x++) {
+      const std::uint8_t v = static_cast<std::uint8_t>((x ^ y) & 0xFF);
+      buffer.set_pixel(x, y, nano::make_pixel(v, v, v, 255));
+    }
+  }
+
+  for (float sigma : { 2.0f, 8.0f, 32.0f }) {
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+      nano::box_blur(buffer, buffer.get_bounds(), sigma);
+    }
+
+    const double ms = ms_duration(std::chrono::steady_clock::now() - start).count() / iterations;
+    const double megapixels = static_cast<double>(width) * static_cast<double>(height) / 1e6;
+
+    std::cout << name << " sigma " << sigma << " : " << ms << " ms (" << megapixels / (ms / 1000.0) << " Mpx/s)"
+              << std::endl;
+  }
+}
+} // namespace.
+
+// Throughput of the box blur on full frames and cost of the shadow mask cache.
+int main(int, const char*[]) {
+  benchmark_blur("1080p", 1920, 1080);
+  benchmark_blur("4K   ", 3840, 2160);
+
+  // 500 shadowed panels per frame, with a few distinct sizes.
+  constexpr int panel_count = 500;
+  constexpr int frame_count = 20;
+
+  nano::pixel_buffer buffer(1920, 1080);
+  nano::shadow s;
+  s.blur = 12.0f;
+
+  const auto draw_panels = [&]() {
+    for (int i = 0; i < panel_count; i++) {
+      const nano::rect<float> r(static_cast<float>((i * 97) % 1700), static_cast<float>((i * 53) % 900),
+          static_cast<float>(120 + (i % 4) * 20), 80.0f);
+      nano::draw_shadow(buffer, r, 6.0f, s, 2.0f);
+    }
+  };
+
+  nano::shadow_cache& cache = nano::shadow_cache::get_main();
+
+  // Without capacity, every mask is created again.
+  cache.set_capacity(0);
+
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < frame_count; i++) {
+    draw_panels();
+  }
+  const double uncached = ms_duration(std::chrono::steady_clock::now() - start).count() / frame_count;
+
+  cache.set_capacity(nano::shadow_cache::default_capacity);
+  cache.reset_stats();
+
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < frame_count; i++) {
+    draw_panels();
+  }
+  const double cached = ms_duration(std::chrono::steady_clock::now() - start).count() / frame_count;
+
+  const nano::shadow_cache::stats stats = cache.get_stats();
+  std::cout << "shadows uncached : " << uncached << " ms per frame" << std::endl;
+  std::cout << "shadows cached   : " << cached << " ms per frame (" << stats.hits << " hits, " << stats.misses
+            << " misses, " << stats.byte_size / 1024 << " KB)" << std::endl;
+  return 0;
+}
@@ -0,0 +1,99 @@
+#include <nano/ui/color_conversion.h>
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+namespace {
+using ms_duration = std::chrono::duration<double, std::milli>;
+
+constexpr int iterations = 50;
+
+template <class Fct>
+void run(const char* name, std::size_t pixel_count, Fct&& fct) {
+  fct();
+
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; i++) {
+    fct();
+  }
+
+  const double ms = ms_duration(std::chrono::steady_clock::now() - start).count() / iterations;
+  std::cout << name << " : " << ms << " ms (" << static_cast<double>(pixel_count) / 1e6 / (ms / 1000.0) << " Mpx/s)"
+            << std::endl;
+}
+
+// Straightforward per pixel versions, as a reference.
+void scalar_premultiply(const std::uint32_t* src, std::uint32_t* dst, std::size_t count) {
+  for (std::size_t i = 0; i < count; i++) {
+    const float a = static_cast<float>(src[i] >> 24) / 255.0f;
+    const auto c = [&](int shift) {
+      return static_cast<std::uint8_t>(std::lround(static_cast<float>((src[i] >> shift) & 0xFF) * a));
+    };
+    dst[i] = nano::make_pixel(c(0), c(8), c(16), static_cast<std::uint8_t>(src[i] >> 24));
+  }
+}
+
+void scalar_unpremultiply(const std::uint32_t* src, std::uint32_t* dst, std::size_t count) {
+  for (std::size_t i = 0; i < count; i++) {
+    const float a = static_cast<float>(src[i] >> 24);
+    const auto c = [&](int shift) {
+      return a == 0.0f ? std::uint8_t(0)
+                       : static_cast<std::uint8_t>(
+                           std::fmin(std::lround(static_cast<float>((src[i] >> shift) & 0xFF) * 255.0f / a), 255.0f));
+    };
+    dst[i] = nano::make_pixel(c(0), c(8), c(16), static_cast<std::uint8_t>(src[i] >> 24));
+  }
+}
+
+void scalar_linear_to_srgb(const float* src, std::uint32_t* dst, std::size_t count) {
+  for (std::size_t i = 0; i < count; i++) {
+    const auto c = [&](float v) {
+      v = std::fmin(std::fmax(v, 0.0f), 1.0f);
+      v = v <= 0.0031308f ? v * 12.92f : 1.055f * std::pow(v, 1.0f / 2.4f) - 0.055f;
+      return static_cast<std::uint8_t>(std::lround(v * 255.0f));
+    };
+    const float* s = src + i * 4;
+    dst[i] = nano::make_pixel(c(s[0]), c(s[1]), c(s[2]), static_cast<std::uint8_t>(std::lround(s[3] * 255.0f)));
+  }
+}
+} // namespace.
+
+// Conversions of a 1080p frame, with the scalar references.
+int main(int, const char*[]) {
+  constexpr int width = 1920;
+  constexpr int height = 1080;
+  constexpr std::size_t count = static_cast<std::size_t>(width * height);
+
+  std::vector<std::uint32_t> src(count);
+  for (std::size_t i = 0; i < count; i++) {
+    const std::uint8_t v = static_cast<std::uint8_t>(i * 31);
+    src[i] = nano::make_pixel(v, static_cast<std::uint8_t>(v / 2), static_cast<std::uint8_t>(255 - v), v);
+  }
+
+  std::vector<std::uint32_t> dst(count);
+  std::vector<float> linear(count * 4);
+
+  run("swap red blue      ", count, [&]() { nano::swap_red_blue(src.data(), dst.data(), count); });
+  run("premultiply        ", count, [&]() { nano::premultiply(src.data(), dst.data(), count); });
+  run("premultiply scalar ", count, [&]() { scalar_premultiply(src.data(), dst.data(), count); });
+  run("unpremultiply      ", count, [&]() { nano::unpremultiply(src.data(), dst.data(), count); });
+  run("unpremultiply scal.", count, [&]() { scalar_unpremultiply(src.data(), dst.data(), count); });
+  run("srgb to linear     ", count, [&]() { nano::srgb_to_linear(src.data(), linear.data(), count); });
+  run("linear to srgb     ", count, [&]() { nano::linear_to_srgb(linear.data(), dst.data(), count); });
+  run("linear to srgb pow ", count, [&]() { scalar_linear_to_srgb(linear.data(), dst.data(), count); });
+
+  // Frame output: premultiplied rgba to the bgra display format.
+  nano::pixel_buffer frame(width, height);
+  run("export bgra        ", count, [&]() {
+    nano::export_pixels(frame, dst.data(), width * sizeof(std::uint32_t), nano::pixel_format::bgra_premultiplied);
+  });
+
+  // Image upload: straight rgba (e.g. png) to the pixel buffer.
+  run("import rgba        ", count, [&]() {
+    nano::import_pixels(frame, src.data(), width, height, width * sizeof(std::uint32_t), nano::pixel_format::rgba);
+  });
+
+  return 0;
+}
@@ -0,0 +1,119 @@
+#include <nano/ui/compositor.h>
+#include <nano/ui/headless.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+// The views are drawn with CoreGraphics, which has no linux backend yet.
+#if defined(__APPLE__)
+
+namespace {
+/// a view with an expensive on_draw.
+class heavy_view : public nano::view {
+public:
+  heavy_view(nano::view* parent, const nano::rect<int>& rect, std::size_t shape_count)
+      : nano::view(parent, rect)
+      , m_shape_count(shape_count) {}
+
+protected:
+  void on_draw(nano::graphic_context& gc, const nano::rect<float>& dirty_rect) override {
+    NANO_UNUSED(dirty_rect);
+    const float w = static_cast<float>(get_frame().width);
+    const float h = static_cast<float>(get_frame().height);
+
+    for (std::size_t i = 0; i < m_shape_count; i++) {
+      const float x = static_cast<float>((i * 37) % 997) / 997.0f * w;
+      const float y = static_cast<float>((i * 91) % 991) / 991.0f * h;
+      gc.set_fill_color(nano::color(static_cast<std::uint32_t>(0x20406080 + i * 0x010203)));
+      gc.fill_rounded_rect(nano::rect<float>(x, y, 24.0f, 16.0f), 4.0f);
+    }
+  }
+
+private:
+  std::size_t m_shape_count;
+};
+
+using ms_duration = std::chrono::duration<double, std::milli>;
+} // namespace.
+
+// Compares the main thread time spent per frame when a heavy view tree is drawn
+// directly against the time spent recording it for the compositor thread.
+// The main thread time is the bound on input latency.
+int main(int, const char*[]) {
+  constexpr std::size_t frame_count = 120;
+  constexpr std::size_t shape_count = 20000;
+
+  auto root = std::make_unique<nano::view>(nano::rect<int>(0, 0, 1280, 800));
+  std::vector<std::unique_ptr<heavy_view>> views;
+
+  for (int i = 0; i < 4; i++) {
+    views.push_back(std::make_unique<heavy_view>(
+        root.get(), nano::rect<int>((i % 2) * 640, (i / 2) * 400, 640, 400), shape_count / 4));
+  }
+
+  double direct_total = 0;
+  double direct_worst = 0;
+
+  {
+    nano::headless_surface surface(root.get(), 2.0f);
+
+    for (std::size_t i = 0; i < frame_count; i++) {
+      const auto start = std::chrono::steady_clock::now();
+      surface.render();
+      const double ms = ms_duration(std::chrono::steady_clock::now() - start).count();
+      direct_total += ms;
+      direct_worst = std::max(direct_worst, ms);
+    }
+  }
+
+  double main_total = 0;
+  double main_worst = 0;
+  double latency_total = 0;
+  double raster_total = 0;
+  nano::headless_presenter presenter;
+
+  {
+    nano::compositor comp(root.get(), &presenter, 2.0f);
+
+    for (std::size_t i = 0; i < frame_count; i++) {
+      views[i % views.size()]->redraw();
+
+      const auto start = std::chrono::steady_clock::now();
+      comp.commit();
+      const double ms = ms_duration(std::chrono::steady_clock::now() - start).count();
+      main_total += ms;
+      main_worst = std::max(main_worst, ms);
+
+      // Gives the compositor a chance to present, as a 60 Hz run loop would.
+      comp.flush();
+      const nano::compositor::stats stats = comp.get_stats();
+      latency_total += stats.last_latency_ms;
+      raster_total += stats.last_raster_ms;
+    }
+
+    const nano::compositor::stats stats = comp.get_stats();
+    std::cout << "frames            : " << stats.frames << " (" << stats.dropped_frames << " dropped)" << std::endl;
+  }
+
+  const double n = static_cast<double>(frame_count);
+  std::cout << "direct draw       : avg " << direct_total / n << " ms, max " << direct_worst << " ms" << std::endl;
+  std::cout << "compositor commit : avg " << main_total / n << " ms, max " << main_worst << " ms" << std::endl;
+  std::cout << "compositor raster : avg " << raster_total / n << " ms" << std::endl;
+  std::cout << "commit to present : avg " << latency_total / n << " ms" << std::endl;
+
+  views.clear();
+  root.reset();
+  return 0;
+}
+
+#else
+
+int main(int, const char*[]) {
+  std::cout << "the views are only drawn on macos" << std::endl;
+  return 0;
+}
+
+#endif
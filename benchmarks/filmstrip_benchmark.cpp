@@ -0,0 +1,144 @@
+#include <nano/ui/compositor.h>
+#include <nano/ui/filmstrip.h>
+#include <nano/ui/headless.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+// The views are drawn with CoreGraphics, which has no linux backend yet.
+#if defined(__APPLE__)
+
+namespace {
+using ms_duration = std::chrono::duration<double, std::milli>;
+
+constexpr int columns = 40;
+constexpr int rows = 25;
+constexpr int knob_size = 32;
+constexpr int strip_frames = 128;
+constexpr int frame_count = 600;
+constexpr float scale = 2.0f;
+
+/// an @2x knob filmstrip: a disk with a pointer turning over 270 degrees.
+nano::pixel_buffer make_knob_filmstrip() {
+  const int size = knob_size * 2;
+  nano::pixel_buffer image(size, size * strip_frames);
+
+  for (int i = 0; i < strip_frames; i++) {
+    const float angle = 3.14159265f * (0.75f + 1.5f * static_cast<float>(i) / (strip_frames - 1));
+    const float c = static_cast<float>(size) * 0.5f;
+
+    for (int y = 0; y < size; y++) {
+      for (int x = 0; x < size; x++) {
+        const float dx = static_cast<float>(x) + 0.5f - c;
+        const float dy = static_cast<float>(y) + 0.5f - c;
+        const float d = std::sqrt(dx * dx + dy * dy);
+        const float coverage = std::clamp(c - 1.0f - d, 0.0f, 1.0f);
+        const float along = dx * std::cos(angle) + dy * std::sin(angle);
+        const float across = std::abs(dy * std::cos(angle) - dx * std::sin(angle));
+        const std::uint8_t a = static_cast<std::uint8_t>(coverage * 255.0f);
+        const std::uint8_t v = along > 0 && across < 2.0f ? a : static_cast<std::uint8_t>(a / 3);
+        image.set_pixel(x, i * size + y, nano::make_pixel(v, v, v, a));
+      }
+    }
+  }
+
+  return image;
+}
+} // namespace.
+
+// A window of 1000 knobs of 32 points, all animated at 60 fps for 10 seconds
+// and rendered at 2x. The sheets are made once by the shared cache, compared
+// with every knob decoding and slicing its own copy of the filmstrip. The main
+// thread time is setting the values, the invalidations and the commit. The blit
+// time is drawing the frame of every knob that changed into a 2x window buffer.
+int main(int, const char*[]) {
+  const nano::pixel_buffer image = make_knob_filmstrip();
+  nano::sprite_asset asset;
+  asset.path = "knob.png";
+  asset.frame_count = strip_frames;
+  asset.scale = 2.0f;
+
+  // Without the cache, every knob slices its own sheet. They are not kept, the
+  // memory they would use is added up.
+  auto start = std::chrono::steady_clock::now();
+  std::size_t copies_size = 0;
+  for (int i = 0; i < columns * rows; i++) {
+    copies_size += nano::make_sprite_sheet(image, asset, scale).get_byte_size();
+  }
+  const double copies_ms = ms_duration(std::chrono::steady_clock::now() - start).count();
+
+  nano::sprite_cache& cache = nano::sprite_cache::get_main();
+  cache.add_image(asset.path, image);
+
+  start = std::chrono::steady_clock::now();
+  std::vector<std::shared_ptr<const nano::sprite_sheet>> shared;
+  for (int i = 0; i < columns * rows; i++) {
+    shared.push_back(cache.get(asset, scale));
+  }
+  const double shared_ms = ms_duration(std::chrono::steady_clock::now() - start).count();
+
+  std::cout << "sheets for " << columns * rows << " knobs : per knob " << copies_ms << " ms, "
+            << static_cast<double>(copies_size) / (1024.0 * 1024.0) << " MB, shared " << shared_ms << " ms, "
+            << static_cast<double>(cache.get_stats().byte_size) / (1024.0 * 1024.0) << " MB" << std::endl;
+
+  auto root = std::make_unique<nano::view>(nano::rect<int>(0, 0, columns * knob_size, rows * knob_size));
+  std::vector<std::unique_ptr<nano::filmstrip_knob>> knobs;
+  for (int i = 0; i < columns * rows; i++) {
+    const nano::rect<int> rect((i % columns) * knob_size, (i / columns) * knob_size, knob_size, knob_size);
+    knobs.push_back(std::make_unique<nano::filmstrip_knob>(root.get(), rect, asset));
+  }
+
+  nano::headless_presenter presenter;
+  nano::compositor comp(root.get(), &presenter, scale);
+  comp.commit();
+  comp.flush();
+
+  nano::pixel_buffer window(columns * knob_size * 2, rows * knob_size * 2);
+  const nano::sprite_sheet& sheet = *shared.front();
+  double main_ms = 0;
+  double blit_ms = 0;
+  std::size_t redrawn = 0;
+
+  for (int f = 0; f < frame_count; f++) {
+    start = std::chrono::steady_clock::now();
+    std::vector<std::size_t> changed;
+    for (std::size_t i = 0; i < knobs.size(); i++) {
+      const float t = static_cast<float>(f) / 60.0f;
+      const float value = 0.5f + 0.5f * std::sin(t * (0.2f + 0.002f * static_cast<float>(i)));
+      if (knobs[i]->set_value(value)) {
+        changed.push_back(i);
+      }
+    }
+
+    comp.commit();
+    main_ms += ms_duration(std::chrono::steady_clock::now() - start).count();
+    comp.flush();
+
+    start = std::chrono::steady_clock::now();
+    for (std::size_t i : changed) {
+      const nano::rect<int> r = knobs[i]->get_frame();
+      nano::draw_sprite(window, sheet, knobs[i]->get_frame_index(), nano::point<int>(r.x * 2, r.y * 2));
+    }
+    blit_ms += ms_duration(std::chrono::steady_clock::now() - start).count();
+    redrawn += changed.size();
+  }
+
+  std::cout << "animated knobs : " << static_cast<double>(redrawn) / frame_count << " redrawn per frame, main thread "
+            << main_ms / frame_count << " ms, blit " << blit_ms / frame_count << " ms per frame" << std::endl;
+
+  knobs.clear();
+  return 0;
+}
+
+#else
+
+int main(int, const char*[]) {
+  std::cout << "the views are only drawn on macos" << std::endl;
+  return 0;
+}
+
+#endif
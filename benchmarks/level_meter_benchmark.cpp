@@ -0,0 +1,111 @@
+#include <nano/ui/compositor.h>
+#include <nano/ui/headless.h>
+#include <nano/ui/level_meter.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+// The views are drawn with CoreGraphics, which has no linux backend yet.
+#if defined(__APPLE__)
+
+namespace {
+using ms_duration = std::chrono::duration<double, std::milli>;
+
+constexpr int meter_count = 128;
+constexpr int frame_count = 600;
+constexpr double frame_time = 1.0 / 60.0;
+
+struct run_result {
+  double update_ms = 0;
+  double commit_ms = 0;
+  double raster_ms = 0;
+  std::uint64_t painted_pixels = 0;
+};
+
+/// a meter bridge of 128 mono meters fed with a different envelope per channel.
+///
+/// @param full_repaint redraws every meter on every frame, as without partial repaint.
+run_result run(bool full_repaint) {
+  auto root = std::make_unique<nano::view>(nano::rect<int>(0, 0, meter_count * 12, 320));
+  nano::level_meter_group group;
+  std::vector<std::shared_ptr<nano::level_meter_source>> sources;
+  std::vector<std::unique_ptr<nano::level_meter_view>> meters;
+
+  for (int i = 0; i < meter_count; i++) {
+    sources.push_back(std::make_shared<nano::level_meter_source>(1, 48000.0f));
+    const nano::rect<int> rect(i * 12, 0, 12, 320);
+    meters.push_back(std::make_unique<nano::level_meter_view>(root.get(), rect, sources.back(), group));
+  }
+
+  nano::headless_presenter presenter;
+  nano::compositor comp(root.get(), &presenter, 2.0f);
+  comp.commit();
+  comp.flush();
+  const std::uint64_t initial_pixels = comp.get_stats().painted_pixels;
+
+  // One audio block per frame and per channel.
+  std::vector<float> block(800);
+  const float* channels[1] = { block.data() };
+  run_result r;
+
+  for (int f = 0; f < frame_count; f++) {
+    for (int i = 0; i < meter_count; i++) {
+      const float t = static_cast<float>(f) * static_cast<float>(frame_time);
+      const float envelope = 0.5f + 0.5f * std::sin(t * (0.5f + 0.05f * static_cast<float>(i)));
+      for (std::size_t k = 0; k < block.size(); k++) {
+        block[k] = envelope * std::sin(static_cast<float>(k) * 0.05f);
+      }
+      sources[static_cast<std::size_t>(i)]->process(channels, block.size());
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    group.update(frame_time);
+    if (full_repaint) {
+      for (auto& m : meters) {
+        m->redraw();
+      }
+    }
+    r.update_ms += ms_duration(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    comp.commit();
+    r.commit_ms += ms_duration(std::chrono::steady_clock::now() - start).count();
+
+    comp.flush();
+    r.raster_ms += comp.get_stats().last_raster_ms;
+  }
+
+  r.painted_pixels = comp.get_stats().painted_pixels - initial_pixels;
+  meters.clear();
+  return r;
+}
+
+void print(const char* name, const run_result& r) {
+  const double n = static_cast<double>(frame_count);
+  std::cout << name << " : main thread " << (r.update_ms + r.commit_ms) / n << " ms, raster " << r.raster_ms / n
+            << " ms, " << static_cast<double>(r.painted_pixels) / n << " pixels painted per frame" << std::endl;
+}
+} // namespace.
+
+// A bridge of 128 meters updated at 60 fps for 10 seconds, rendered headless
+// through the compositor at 2x. The ballistics run once per frame, compared
+// with the same meters repainted entirely on every frame. The main thread time
+// is the ballistics, the invalidations and the commit of the recorded meters.
+int main(int, const char*[]) {
+  print("full repaint   ", run(true));
+  print("partial repaint", run(false));
+  return 0;
+}
+
+#else
+
+int main(int, const char*[]) {
+  std::cout << "the views are only drawn on macos" << std::endl;
+  return 0;
+}
+
+#endif
@@ -0,0 +1,128 @@
+#include <nano/ui/headless.h>
+#include <nano/ui/menu.h>
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+using ms_duration = std::chrono::duration<double, std::milli>;
+
+constexpr int window_count = 50;
+constexpr int submenu_count = 8;
+constexpr int items_per_submenu = 24;
+
+/// the menu bar of an editor, about 200 items.
+std::vector<nano::menu_item> build_editor_menu() {
+  std::vector<nano::menu_item> items = nano::menu_model::get_default_items();
+  nano::command_id command = nano::first_user_command;
+
+  for (int i = 0; i < submenu_count; i++) {
+    nano::menu_item submenu;
+    submenu.title = "Menu " + std::to_string(i);
+
+    for (int j = 0; j < items_per_submenu; j++) {
+      if (j % 8 == 7) {
+        submenu.items.push_back(nano::menu_item::make_separator());
+        continue;
+      }
+
+      nano::menu_item item;
+      item.title = "Command " + std::to_string(command);
+      item.command = command++;
+      item.key_equivalent = j < 4 ? std::string(1, static_cast<char>('a' + j)) : std::string();
+      submenu.items.push_back(std::move(item));
+    }
+
+    items.push_back(std::move(submenu));
+  }
+
+  return items;
+}
+
+/// what opening a window costs without the native window: the content view tree and its first frame.
+void open_window(std::vector<std::unique_ptr<nano::view>>& views) {
+  auto root = std::make_unique<nano::view>(nano::rect<int>(0, 0, 800, 600));
+  for (int i = 0; i < 16; i++) {
+    const nano::rect<int> frame((i % 4) * 200, (i / 4) * 150, 200, 150);
+    views.push_back(std::make_unique<nano::view>(root.get(), frame));
+  }
+
+  nano::headless_surface surface(root.get());
+  surface.render();
+  views.push_back(std::move(root));
+}
+
+struct result {
+  double total_ms = 0;
+  double menu_ms = 0;
+};
+
+template <class MenuFn>
+result open_windows(MenuFn&& menu_fn) {
+  std::vector<std::unique_ptr<nano::view>> views;
+  result r;
+
+  for (int i = 0; i < window_count; i++) {
+    const auto start = std::chrono::steady_clock::now();
+    open_window(views);
+
+    const auto menu_start = std::chrono::steady_clock::now();
+    menu_fn();
+
+    const auto end = std::chrono::steady_clock::now();
+    r.menu_ms += ms_duration(end - menu_start).count();
+    r.total_ms += ms_duration(end - start).count();
+  }
+
+  // The children were added before their parents.
+  for (std::unique_ptr<nano::view>& v : views) {
+    v.reset();
+  }
+
+  return r;
+}
+
+void print_result(const char* name, const result& r) {
+  std::cout << name << " : " << r.total_ms << " ms for " << window_count << " windows, "
+            << r.total_ms / window_count << " ms per window, menu " << r.menu_ms << " ms" << std::endl;
+}
+} // namespace.
+
+// Opens 50 windows in the headless backend (a content view tree rendered once)
+// and installs the menu the way each window used to: a menu built and
+// translated for every window, against the shared menu model that is built and
+// translated once and only checked afterwards. The headless translator copies
+// the items, a native one allocates an object per item and is slower.
+int main(int, const char*[]) {
+  // Per window.
+  nano::headless_menu per_window_translator;
+  const result per_window = open_windows([&]() {
+    nano::menu_model model;
+    model.set_builder(&build_editor_menu);
+    model.set_translator(&per_window_translator);
+    model.update_native();
+  });
+
+  // Shared.
+  nano::menu_model shared;
+  nano::headless_menu shared_translator;
+  shared.set_builder(&build_editor_menu);
+  shared.set_translator(&shared_translator);
+  const result shared_result = open_windows([&]() { shared.update_native(); });
+
+  print_result("menu per window", per_window);
+  print_result("shared menu    ", shared_result);
+  std::cout << "shared menu : " << shared.get_stats().builds << " builds, " << shared.get_stats().translations
+            << " translations" << std::endl;
+
+  // A state change afterwards only updates the item.
+  shared.set_checked(nano::first_user_command, true);
+  const auto start = std::chrono::steady_clock::now();
+  shared.update_native();
+  std::cout << "state change : " << ms_duration(std::chrono::steady_clock::now() - start).count() << " ms, "
+            << shared_translator.get_updated_item_count() << " item updated" << std::endl;
+  return 0;
+}
@@ -0,0 +1,171 @@
+#include <nano/ui/compositor.h>
+#include <nano/ui/headless.h>
+#include <nano/ui/node_graph.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+// The views are drawn with CoreGraphics, which has no linux backend yet.
+#if defined(__APPLE__)
+
+namespace {
+using ms_duration = std::chrono::duration<double, std::milli>;
+
+constexpr int columns = 100;
+constexpr int rows = 100;
+constexpr float spacing_x = 48.0f;
+constexpr float spacing_y = 32.0f;
+constexpr int wires_per_node = 2;
+constexpr int hover_count = 100000;
+constexpr int linear_hover_count = 500;
+constexpr int drag_steps = 120;
+
+struct lcg {
+  std::uint32_t seed = 1;
+
+  inline std::uint32_t next() noexcept {
+    seed = seed * 1664525u + 1013904223u;
+    return seed >> 8;
+  }
+
+  inline float next_float(float range) noexcept { return static_cast<float>(next()) / 16777216.0f * range; }
+};
+
+struct drag_result {
+  double main_ms = 0;
+  double raster_ms = 0;
+  std::uint64_t painted_pixels = 0;
+};
+
+/// a grid of 10k nodes, each with two cables to nodes of the next few columns.
+std::shared_ptr<nano::node_graph> make_graph() {
+  auto graph = std::make_shared<nano::node_graph>();
+  lcg r;
+
+  for (int y = 0; y < rows; y++) {
+    for (int x = 0; x < columns; x++) {
+      const nano::point<float> p(static_cast<float>(x) * spacing_x + 8.0f, static_cast<float>(y) * spacing_y + 4.0f);
+      graph->add_node(nano::rect<float>(p.x, p.y, 24.0f, 24.0f), 2, 2);
+    }
+  }
+
+  for (int i = 0; i < columns * rows; i++) {
+    const int x = i % columns;
+    const int y = i / columns;
+
+    for (int w = 0; w < wires_per_node; w++) {
+      const int tx = std::min(x + 1 + static_cast<int>(r.next() % 4), columns - 1);
+      const int ty = std::clamp(y + static_cast<int>(r.next() % 9) - 4, 0, rows - 1);
+      graph->connect(static_cast<nano::node_id>(i), w, static_cast<nano::node_id>(ty * columns + tx), w);
+    }
+  }
+
+  return graph;
+}
+
+/// drags a node of the middle of the grid by 2 points per frame.
+///
+/// @param full_repaint redraws the whole canvas on every step, as without incremental redraw.
+drag_result run_drag(std::shared_ptr<nano::node_graph> graph, bool full_repaint) {
+  const nano::rect<int> bounds(0, 0, static_cast<int>(columns * spacing_x), static_cast<int>(rows * spacing_y));
+  auto root = std::make_unique<nano::view>(bounds);
+  auto view = std::make_unique<nano::node_graph_view>(root.get(), bounds);
+  view->set_graph(graph);
+
+  nano::headless_presenter presenter;
+  nano::compositor comp(root.get(), &presenter);
+  comp.commit();
+  comp.flush();
+  const std::uint64_t initial_pixels = comp.get_stats().painted_pixels;
+
+  const nano::graph_node& node = *graph->find_node(static_cast<nano::node_id>(rows / 2 * columns + columns / 2));
+  nano::point<float> pos(node.rect.x + 10.0f, node.rect.y + 10.0f);
+  view->begin_drag(pos);
+  drag_result r;
+
+  for (int i = 0; i < drag_steps; i++) {
+    pos = nano::point<float>(pos.x + (i < drag_steps / 2 ? 2.0f : -2.0f), pos.y + 1.0f);
+
+    const auto start = std::chrono::steady_clock::now();
+    view->drag(pos);
+    if (full_repaint) {
+      view->redraw();
+    }
+    comp.commit();
+    r.main_ms += ms_duration(std::chrono::steady_clock::now() - start).count();
+
+    comp.flush();
+    r.raster_ms += comp.get_stats().last_raster_ms;
+  }
+
+  view->end_drag();
+  r.painted_pixels = comp.get_stats().painted_pixels - initial_pixels;
+  return r;
+}
+
+void print(const char* name, const drag_result& r) {
+  const double n = static_cast<double>(drag_steps);
+  std::cout << name << " : main thread " << r.main_ms / n << " ms, raster " << r.raster_ms / n << " ms, "
+            << static_cast<double>(r.painted_pixels) / n << " pixels painted per step" << std::endl;
+}
+} // namespace.
+
+// A canvas of 10k nodes and 20k cables. Hovering is hit testing random points
+// through the spatial hash, compared with measuring the distance to every
+// cable. Dragging a node moves it by 2 points per step, redrawing only the
+// bounds of the node and of its cables, compared with repainting the canvas.
+int main(int, const char*[]) {
+  auto start = std::chrono::steady_clock::now();
+  std::shared_ptr<nano::node_graph> graph = make_graph();
+  std::cout << "build : " << ms_duration(std::chrono::steady_clock::now() - start).count() << " ms, "
+            << graph->get_node_count() << " nodes, " << graph->get_wire_count() << " wires" << std::endl;
+
+  const float width = columns * spacing_x;
+  const float height = rows * spacing_y;
+  std::vector<nano::point<float>> points(hover_count);
+  lcg r;
+  for (nano::point<float>& p : points) {
+    p = nano::point<float>(r.next_float(width), r.next_float(height));
+  }
+
+  // Every cable is measured, as before the spatial hash.
+  start = std::chrono::steady_clock::now();
+  int linear_hits = 0;
+  for (int i = 0; i < linear_hover_count; i++) {
+    for (std::size_t w = 0; w < graph->get_wire_count(); w++) {
+      if (nano::get_distance(*graph->find_wire(static_cast<nano::wire_id>(w)), points[static_cast<std::size_t>(i)])
+          <= 4.0f) {
+        linear_hits++;
+        break;
+      }
+    }
+  }
+  const double linear_us = ms_duration(std::chrono::steady_clock::now() - start).count() * 1000.0 / linear_hover_count;
+
+  start = std::chrono::steady_clock::now();
+  int hits = 0;
+  for (const nano::point<float>& p : points) {
+    hits += graph->hit_test_wire(p, 4.0f) != nano::invalid_wire_id;
+  }
+  const double hashed_us = ms_duration(std::chrono::steady_clock::now() - start).count() * 1000.0 / hover_count;
+
+  std::cout << "hover : linear " << linear_us << " us, spatial hash " << hashed_us << " us per hit test, "
+            << 100.0 * hits / hover_count << "% hits (" << 100.0 * linear_hits / linear_hover_count << "% linear)"
+            << std::endl;
+
+  print("drag full repaint", run_drag(graph, true));
+  print("drag incremental ", run_drag(graph, false));
+  return 0;
+}
+
+#else
+
+int main(int, const char*[]) {
+  std::cout << "the views are only drawn on macos" << std::endl;
+  return 0;
+}
+
+#endif
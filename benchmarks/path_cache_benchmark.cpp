@@ -0,0 +1,72 @@
+#include <nano/ui/path_cache.h>
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+// Draws 5k knob value arcs per frame in a 1080p buffer, flattening every arc
+// on each draw versus going through the path cache.
+int main(int, const char*[]) {
+  constexpr std::size_t knob_count = 5000;
+  constexpr std::size_t frame_count = 60;
+  constexpr int knob_size = 40;
+  constexpr float scale = 2.0f;
+
+  // Knob values are quantized as they would be by their parameter resolution.
+  constexpr int value_steps = 128;
+
+  constexpr float start_angle = 2.356f;
+  constexpr float sweep = 4.712f;
+
+  nano::pixel_buffer buffer(1920, 1080);
+  const std::uint32_t arc_color = nano::make_pixel(70, 141, 231, 255);
+  const int columns = buffer.get_width() / knob_size;
+
+  const auto get_arc = [&](std::size_t knob, std::size_t frame, nano::path_geometry& path) {
+    const int step = static_cast<int>((knob * 7 + frame) % value_steps);
+    const float value = static_cast<float>(step) / static_cast<float>(value_steps - 1);
+    const float center = static_cast<float>(knob_size) * 0.5f / scale;
+
+    path.clear();
+    path.add_arc_stroke(nano::point<float>(center, center), center - 3.0f, start_angle,
+        start_angle + sweep * std::max(value, 0.01f), 2.0f);
+  };
+
+  const auto get_position = [&](std::size_t knob) {
+    const int index = static_cast<int>(knob) % (columns * (buffer.get_height() / knob_size));
+    return nano::point<int>((index % columns) * knob_size, (index / columns) * knob_size);
+  };
+
+  const auto run = [&](const char* name, auto&& draw_knob) {
+    nano::path_geometry path;
+    const auto start = std::chrono::steady_clock::now();
+
+    for (std::size_t frame = 0; frame < frame_count; frame++) {
+      buffer.clear();
+
+      for (std::size_t knob = 0; knob < knob_count; knob++) {
+        get_arc(knob, frame, path);
+        draw_knob(path, get_position(knob));
+      }
+    }
+
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << name << " : " << ms / static_cast<double>(frame_count) << " ms per frame" << std::endl;
+  };
+
+  run("uncached", [&](const nano::path_geometry& path, const nano::point<int>& pos) {
+    nano::fill(buffer, nano::flatten(path, scale), pos, arc_color);
+  });
+
+  nano::path_cache cache;
+  run("cached  ", [&](const nano::path_geometry& path, const nano::point<int>& pos) {
+    nano::fill(buffer, *cache.get(path, scale), pos, arc_color);
+  });
+
+  const nano::path_cache::stats stats = cache.get_stats();
+  std::cout << "hits      : " << stats.hits << std::endl;
+  std::cout << "misses    : " << stats.misses << std::endl;
+  std::cout << "evictions : " << stats.evictions << std::endl;
+  std::cout << "entries   : " << stats.entry_count << " (" << stats.byte_size / 1024 << " KB)" << std::endl;
+  return 0;
+}
@@ -0,0 +1,126 @@
+#include <nano/ui/piano_roll.h>
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+using ms_duration = std::chrono::duration<double, std::milli>;
+
+constexpr std::size_t note_count = 1000000;
+constexpr int iterations = 200;
+
+/// the notes of a visible area by iterating the whole clip, as without the index.
+std::size_t query_linear(const std::vector<nano::piano_note>& notes, double start, double end, int low, int high) {
+  std::size_t count = 0;
+  for (const nano::piano_note& n : notes) {
+    count += n.pitch >= low && n.pitch <= high && n.start < end && n.get_end() > start ? 1 : 0;
+  }
+
+  return count;
+}
+} // namespace.
+
+// A clip of one million notes over an hour, mostly short with a few long ones,
+// spread over five octaves. The notes of a view of 16 seconds and two octaves
+// are queried at random positions, compared with iterating the whole clip.
+// Selecting with a marquee and moving the selection are timed on the index,
+// then the query again with a note over the whole clip on every pitch.
+int main(int, const char*[]) {
+  std::mt19937 rng(1);
+  std::uniform_real_distribution<double> time(0.0, 3600.0);
+  std::uniform_real_distribution<double> length(0.05, 0.5);
+  std::uniform_int_distribution<int> pitch(36, 96);
+
+  nano::note_index index;
+  std::vector<nano::piano_note> notes;
+  std::vector<nano::note_id> ids;
+  notes.reserve(note_count);
+  ids.reserve(note_count);
+
+  auto start = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < note_count; i++) {
+    const double l = i % 1000 == 0 ? 8.0 : length(rng);
+    const nano::piano_note n = { time(rng), l, 0, static_cast<std::uint8_t>(pitch(rng)), 100, false };
+    ids.push_back(index.insert(n.start, n.length, n.pitch, n.velocity));
+    notes.push_back(n);
+  }
+
+  std::cout << "insert " << note_count << " notes : " << ms_duration(std::chrono::steady_clock::now() - start).count()
+            << " ms" << std::endl;
+
+  std::vector<double> positions(iterations);
+  for (double& p : positions) {
+    p = time(rng);
+  }
+
+  std::size_t indexed_count = 0;
+  start = std::chrono::steady_clock::now();
+  for (double p : positions) {
+    index.query(p, p + 16.0, 48, 72, [&](const nano::piano_note&) { indexed_count++; });
+  }
+  const double indexed_ms = ms_duration(std::chrono::steady_clock::now() - start).count() / iterations;
+
+  std::size_t linear_count = 0;
+  start = std::chrono::steady_clock::now();
+  for (double p : positions) {
+    linear_count += query_linear(notes, p, p + 16.0, 48, 72);
+  }
+  const double linear_ms = ms_duration(std::chrono::steady_clock::now() - start).count() / iterations;
+
+  std::cout << "visible notes : " << indexed_count / iterations << " (" << linear_count / iterations
+            << " by scan), indexed " << indexed_ms << " ms, linear scan " << linear_ms << " ms" << std::endl;
+
+  // A marquee of 4 seconds over an octave, then its notes moved by a step.
+  std::vector<nano::note_id> selection;
+  double select_ms = 0;
+  double move_ms = 0;
+  std::size_t moved = 0;
+
+  for (int i = 0; i < iterations; i++) {
+    const double p = positions[static_cast<std::size_t>(i)];
+    selection.clear();
+
+    start = std::chrono::steady_clock::now();
+    index.query(p, p + 4.0, 60, 72, [&](const nano::piano_note& n) { selection.push_back(n.id); });
+    for (nano::note_id id : selection) {
+      index.set_selected(id, true);
+    }
+    select_ms += ms_duration(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    for (nano::note_id id : selection) {
+      const nano::piano_note* n = index.find(id);
+      index.move(id, n->start + 0.125, static_cast<std::uint8_t>(n->pitch + 1));
+    }
+    move_ms += ms_duration(std::chrono::steady_clock::now() - start).count();
+    moved += selection.size();
+  }
+
+  std::cout << "marquee selection of " << moved / iterations << " notes : " << select_ms / iterations << " ms, move : "
+            << move_ms / iterations << " ms" << std::endl;
+
+  // A note over the whole clip on every pitch, then removed.
+  std::vector<nano::note_id> long_ids;
+  for (int p = 36; p <= 96; p++) {
+    long_ids.push_back(index.insert(0.0, 3600.0, static_cast<std::uint8_t>(p)));
+  }
+
+  indexed_count = 0;
+  start = std::chrono::steady_clock::now();
+  for (double p : positions) {
+    index.query(p, p + 16.0, 48, 72, [&](const nano::piano_note&) { indexed_count++; });
+  }
+  const double long_ms = ms_duration(std::chrono::steady_clock::now() - start).count() / iterations;
+
+  start = std::chrono::steady_clock::now();
+  for (nano::note_id id : long_ids) {
+    index.erase(id);
+  }
+  const double erase_ms = ms_duration(std::chrono::steady_clock::now() - start).count();
+
+  std::cout << "with a note over the clip on every pitch : " << indexed_count / iterations << " visible notes, "
+            << long_ms << " ms, erasing them " << erase_ms << " ms" << std::endl;
+  return 0;
+}
@@ -0,0 +1,182 @@
+#include <nano/ui/headless.h>
+#include <nano/ui/path_cache.h>
+
+#include "main_view.h"
+#include "toolbar.h"
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// The views are drawn with CoreGraphics, which has no linux backend yet.
+#if defined(__APPLE__)
+
+namespace {
+/// a control panel cell: background, knob and value arc.
+class knob_view : public nano::view {
+public:
+  knob_view(nano::view* parent, const nano::rect<int>& rect)
+      : nano::view(parent, rect) {
+    // Built at the origin, every knob shares the flattened arc.
+    const float radius = static_cast<float>(rect.width) * 0.5f - 10.0f;
+    m_arc.add_arc_stroke(nano::point<float>(radius + 2.0f, radius + 2.0f), radius, 2.356f, 6.0f, 2.0f);
+  }
+
+protected:
+  void on_draw(nano::graphic_context& gc, const nano::rect<float>& dirty_rect) override {
+    NANO_UNUSED(dirty_rect);
+    const nano::rect<float> bounds(get_bounds());
+
+    gc.set_fill_color(0x2A2A2AFF);
+    gc.fill_rounded_rect(bounds, 4.0f);
+
+    const nano::rect<float> knob = bounds.reduced({ 8.0f, 8.0f });
+    gc.set_fill_color(0x555555FF);
+    gc.fill_ellipse(knob);
+
+    nano::fill_path(gc, m_arc, nano::point<float>(knob.x, knob.y), 0x468DE7FF);
+  }
+
+private:
+  nano::path_geometry m_arc;
+};
+
+class fill_view : public nano::view {
+public:
+  fill_view(nano::view* parent, const nano::rect<int>& rect, const nano::color& c)
+      : nano::view(parent, rect)
+      , m_color(c) {}
+
+  fill_view(const nano::rect<int>& rect, const nano::color& c)
+      : nano::view(rect)
+      , m_color(c) {}
+
+protected:
+  void on_draw(nano::graphic_context& gc, const nano::rect<float>& dirty_rect) override {
+    NANO_UNUSED(dirty_rect);
+    gc.set_fill_color(m_color);
+    gc.fill_rect(nano::rect<float>(get_bounds()));
+  }
+
+private:
+  nano::color m_color;
+};
+
+struct scene {
+  std::string name;
+  std::unique_ptr<nano::view> root;
+  std::vector<std::unique_ptr<nano::view>> views;
+
+  scene(std::string n, const nano::rect<int>& rect)
+      : name(std::move(n))
+      , root(std::make_unique<fill_view>(rect, nano::color(0x333333FF))) {}
+
+  scene(scene&&) = default;
+
+  ~scene() {
+    // Children are destroyed before their parent.
+    while (!views.empty()) {
+      views.pop_back();
+    }
+  }
+};
+
+scene make_basic_scene() {
+  scene s("basic example", nano::rect<int>(0, 0, 1024, 768));
+  s.views.push_back(std::make_unique<Toolbar>(s.root.get(), nano::rect<int>(0, 0, 1024, 50)));
+  s.views.push_back(std::make_unique<MainView>(s.root.get(), nano::rect<int>(10, 60, 1004, 698)));
+  return s;
+}
+
+scene make_knob_grid_scene() {
+  scene s("knob grid 32x16", nano::rect<int>(0, 0, 1280, 640));
+
+  for (int y = 0; y < 16; y++) {
+    for (int x = 0; x < 32; x++) {
+      s.views.push_back(std::make_unique<knob_view>(s.root.get(), nano::rect<int>(x * 40, y * 40, 40, 40)));
+    }
+  }
+
+  return s;
+}
+
+scene make_nested_scene() {
+  scene s("nested panels x8", nano::rect<int>(0, 0, 1024, 768));
+  nano::view* parent = s.root.get();
+
+  for (int i = 0; i < 8; i++) {
+    const nano::size<int> size = parent->get_frame().size;
+    s.views.push_back(std::make_unique<fill_view>(parent, nano::rect<int>(16, 16, size.width - 32, size.height - 32),
+        nano::color(static_cast<std::uint32_t>(0x404040FF + i * 0x10101000))));
+    parent = s.views.back().get();
+  }
+
+  return s;
+}
+
+void run_scene(scene& s, float scale) {
+  constexpr std::size_t frame_count = 200;
+
+  nano::headless_surface surface(s.root.get(), scale);
+  surface.render();
+
+  const auto start = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < frame_count; i++) {
+    surface.render();
+  }
+  const double total_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+  // Profiling is done in a separate pass since it flushes after each view.
+  surface.set_profiling(true);
+  for (std::size_t i = 0; i < frame_count; i++) {
+    surface.render();
+  }
+
+  std::vector<std::pair<const nano::view*, nano::view_draw_stats>> stats(
+      surface.get_draw_stats().begin(), surface.get_draw_stats().end());
+  std::sort(stats.begin(), stats.end(),
+      [](const auto& a, const auto& b) { return a.second.total_ms > b.second.total_ms; });
+
+  std::cout << s.name << " @" << scale << "x" << std::endl;
+  std::cout << "  fps        : " << static_cast<double>(frame_count) * 1000.0 / total_ms << std::endl;
+  std::cout << "  frame time : " << total_ms / static_cast<double>(frame_count) << " ms" << std::endl;
+  std::cout << "  views      : " << stats.size() << std::endl;
+
+  // The most expensive views.
+  for (std::size_t i = 0; i < std::min<std::size_t>(stats.size(), 4); i++) {
+    const nano::view_draw_stats& vs = stats[i].second;
+    const nano::rect<int> frame = stats[i].first->get_frame();
+    std::cout << "  view " << std::setw(4) << frame.width << "x" << std::setw(4) << frame.height << " : avg "
+              << vs.total_ms / static_cast<double>(vs.draw_count) << " ms, max " << vs.max_ms << " ms" << std::endl;
+  }
+}
+} // namespace.
+
+// Renders canned scenes with the headless backend and reports the frames per
+// second and the draw time of the most expensive views.
+int main(int, const char*[]) {
+  std::vector<std::function<scene()>> scenes = { make_basic_scene, make_knob_grid_scene, make_nested_scene };
+
+  for (const auto& make_scene : scenes) {
+    for (float scale : { 1.0f, 2.0f }) {
+      scene s = make_scene();
+      run_scene(s, scale);
+    }
+  }
+
+  return 0;
+}
+
+#else
+
+int main(int, const char*[]) {
+  std::cout << "the views are only drawn on macos" << std::endl;
+  return 0;
+}
+
+#endif
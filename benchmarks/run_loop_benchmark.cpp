@@ -0,0 +1,149 @@
+#include <nano/ui/run_loop.h>
+
+#include <iostream>
+
+#if defined(__linux__)
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+using ms_duration = std::chrono::duration<double, std::milli>;
+using us_duration = std::chrono::duration<double, std::micro>;
+
+constexpr int latency_count = 2000;
+constexpr int throughput_count = 1000000;
+constexpr std::uint32_t timer_interval_ms = 5;
+constexpr int timer_count = 200;
+
+class latency_message : public nano::message {
+public:
+  latency_message(std::vector<double>& latencies, std::atomic<int>& done)
+      : m_latencies(latencies)
+      , m_done(done)
+      , m_posted(std::chrono::steady_clock::now()) {}
+
+  virtual ~latency_message() override = default;
+
+  virtual void call() override {
+    m_latencies.push_back(us_duration(std::chrono::steady_clock::now() - m_posted).count());
+    m_done.store(1, std::memory_order_release);
+  }
+
+private:
+  std::vector<double>& m_latencies;
+  std::atomic<int>& m_done;
+  std::chrono::steady_clock::time_point m_posted;
+};
+
+class count_message : public nano::message {
+public:
+  count_message(std::uint64_t& count)
+      : m_count(count) {}
+
+  virtual ~count_message() override = default;
+
+  virtual void call() override { m_count++; }
+
+private:
+  std::uint64_t& m_count;
+};
+
+void print_percentiles(const char* name, std::vector<double> values, const char* unit) {
+  std::sort(values.begin(), values.end());
+  const auto at = [&](double p) {
+    return values[static_cast<std::size_t>(p * static_cast<double>(values.size() - 1))];
+  };
+  std::cout << name << " : p50 " << at(0.5) << " " << unit << ", p99 " << at(0.99) << " " << unit << ", max "
+            << values.back() << " " << unit << std::endl;
+}
+} // namespace.
+
+// The loop waits in epoll_wait() while another thread posts messages. The
+// latency is from post() to the call of the message, one message at a time so
+// that every post wakes the loop. The throughput run posts a million messages
+// from another thread and counts how many wakeups they cost, since the eventfd
+// is only written when the queue was empty. Timer jitter is the distance
+// between consecutive calls of a 5 ms timer.
+int main(int, const char*[]) {
+  nano::run_loop loop;
+  if (!loop.is_valid()) {
+    std::cout << "epoll unavailable" << std::endl;
+    return 1;
+  }
+
+  // Wakeup latency.
+  std::vector<double> latencies;
+  latencies.reserve(latency_count);
+  std::atomic<int> done(0);
+
+  std::thread producer([&]() {
+    for (int i = 0; i < latency_count; i++) {
+      done.store(0, std::memory_order_relaxed);
+      loop.post(std::make_shared<latency_message>(latencies, done));
+      while (!done.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+      }
+
+      // Lets the loop go back to sleep.
+      std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+    loop.quit();
+  });
+
+  loop.run();
+  producer.join();
+  print_percentiles("post to dispatch latency", latencies, "us");
+
+  // Throughput and coalescing.
+  loop.reset_stats();
+  std::uint64_t count = 0;
+  auto start = std::chrono::steady_clock::now();
+
+  producer = std::thread([&]() {
+    for (int i = 0; i < throughput_count; i++) {
+      loop.post(std::make_shared<count_message>(count));
+    }
+    loop.quit();
+  });
+
+  loop.run();
+  producer.join();
+  const double throughput_ms = ms_duration(std::chrono::steady_clock::now() - start).count();
+  std::cout << "throughput : " << count << " messages in " << throughput_ms << " ms, "
+            << static_cast<double>(count) / throughput_ms / 1000.0 << " M/s, " << loop.get_stats().wakeups
+            << " wakeups" << std::endl;
+
+  // Timer jitter.
+  std::vector<double> intervals;
+  intervals.reserve(timer_count);
+  auto last = std::chrono::steady_clock::now();
+  const int id = loop.add_timer(timer_interval_ms, [&]() {
+    const auto now = std::chrono::steady_clock::now();
+    intervals.push_back(std::abs(ms_duration(now - last).count() - timer_interval_ms) * 1000.0);
+    last = now;
+
+    if (intervals.size() == timer_count) {
+      loop.quit();
+    }
+  });
+
+  loop.run();
+  loop.remove_timer(id);
+  print_percentiles("timer jitter", intervals, "us");
+  return 0;
+}
+
+#else
+
+int main(int, const char*[]) {
+  std::cout << "the run loop is only used on linux" << std::endl;
+  return 0;
+}
+
+#endif
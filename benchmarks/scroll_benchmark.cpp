@@ -0,0 +1,134 @@
+#include <nano/ui/compositor.h>
+#include <nano/ui/headless.h>
+#include <nano/ui/scroll_view.h>
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+// The views are drawn with CoreGraphics, which has no linux backend yet.
+#if defined(__APPLE__)
+
+namespace {
+/// a list row with a few shapes.
+class row_view : public nano::view {
+public:
+  row_view(nano::view* parent, const nano::rect<int>& rect, int index)
+      : nano::view(parent, rect)
+      , m_index(index) {}
+
+protected:
+  void on_draw(nano::graphic_context& gc, const nano::rect<float>& dirty_rect) override {
+    NANO_UNUSED(dirty_rect);
+    const float w = static_cast<float>(get_frame().width);
+    const float h = static_cast<float>(get_frame().height);
+
+    gc.set_fill_color(m_index % 2 ? nano::color(0x202428FF) : nano::color(0x2A2E33FF));
+    gc.fill_rect(nano::rect<float>(0.0f, 0.0f, w, h));
+
+    for (int i = 0; i < 24; i++) {
+      gc.set_fill_color(nano::color(static_cast<std::uint32_t>(0x3080C0FF + ((m_index + i) % 7) * 0x10000000)));
+      gc.fill_rounded_rect(nano::rect<float>(8.0f + static_cast<float>(i) * 52.0f, 6.0f, 44.0f, h - 12.0f), 4.0f);
+    }
+  }
+
+private:
+  int m_index;
+};
+
+/// header drawn over the list, it does not scroll.
+class header_view : public nano::view {
+public:
+  using nano::view::view;
+
+protected:
+  void on_draw(nano::graphic_context& gc, const nano::rect<float>& dirty_rect) override {
+    NANO_UNUSED(dirty_rect);
+    gc.set_fill_color(nano::color(0x101010E0));
+    gc.fill_rect(nano::rect<float>(
+        0.0f, 0.0f, static_cast<float>(get_frame().width), static_cast<float>(get_frame().height)));
+  }
+};
+
+using ms_duration = std::chrono::duration<double, std::milli>;
+} // namespace.
+
+// Pixels painted and raster time per scroll step of a long list, when the
+// back buffer is moved (scroll_rect) and when the whole viewport is redrawn.
+int main(int, const char*[]) {
+  constexpr int width = 1280;
+  constexpr int height = 800;
+  constexpr int row_height = 40;
+  constexpr int row_count = 2000;
+  constexpr int step_count = 200;
+  constexpr int step = 12;
+  constexpr float scale = 2.0f;
+
+  auto root = std::make_unique<nano::view>(nano::rect<int>(0, 0, width, height));
+  auto scroller = std::make_unique<nano::scroll_view>(root.get(), nano::rect<int>(0, 0, width, height));
+  auto content = std::make_unique<nano::view>(scroller.get(), nano::rect<int>(0, 0, width, row_count * row_height));
+
+  std::vector<std::unique_ptr<row_view>> rows;
+  for (int i = 0; i < row_count; i++) {
+    rows.push_back(std::make_unique<row_view>(content.get(), nano::rect<int>(0, i * row_height, width, row_height), i));
+  }
+
+  auto header = std::make_unique<header_view>(scroller.get(), nano::rect<int>(0, 0, width, 32));
+  scroller->set_content(content.get());
+  scroller->set_overlay(header.get());
+
+  const auto run = [&](const char* name, bool blit) {
+    scroller->set_scroll_offset(nano::point<int>(0, 0));
+
+    nano::headless_presenter presenter;
+    nano::compositor comp(root.get(), &presenter, scale);
+    comp.commit();
+    comp.flush();
+
+    const nano::compositor::stats start_stats = comp.get_stats();
+    double raster_total = 0;
+
+    for (int i = 0; i < step_count; i++) {
+      if (blit) {
+        scroller->scroll_by(nano::point<int>(0, step));
+      }
+      else {
+        const nano::point<int> offset = scroller->get_scroll_offset();
+        content->set_frame_position(nano::point<int>(0, -(offset.y + step)));
+        scroller->redraw();
+      }
+
+      comp.commit();
+      comp.flush();
+      raster_total += comp.get_stats().last_raster_ms;
+    }
+
+    const nano::compositor::stats stats = comp.get_stats();
+    const double n = static_cast<double>(step_count);
+    const double viewport = static_cast<double>(width) * static_cast<double>(height) * scale * scale;
+    const double painted = static_cast<double>(stats.painted_pixels - start_stats.painted_pixels) / n;
+
+    std::cout << name << " : " << painted << " px painted per step (" << 100.0 * painted / viewport
+              << "% of the viewport), raster avg " << raster_total / n << " ms" << std::endl;
+  };
+
+  run("full redraw  ", false);
+  run("scroll blit  ", true);
+
+  header.reset();
+  rows.clear();
+  content.reset();
+  scroller.reset();
+  root.reset();
+  return 0;
+}
+
+#else
+
+int main(int, const char*[]) {
+  std::cout << "the views are only drawn on macos" << std::endl;
+  return 0;
+}
+
+#endif
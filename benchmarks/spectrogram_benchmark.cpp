@@ -0,0 +1,159 @@
+#include <nano/ui/compositor.h>
+#include <nano/ui/headless.h>
+#include <nano/ui/spectrogram.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <unistd.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace {
+using ms_duration = std::chrono::duration<double, std::milli>;
+
+constexpr int view_width = 1920;
+constexpr int view_height = 256;
+constexpr int frame_count = 600;
+
+/// returns the resident memory of the process in MB, the peak where the current size is not available.
+double get_resident_mb() {
+#if defined(__linux__)
+  std::FILE* file = std::fopen("/proc/self/statm", "r");
+  if (!file) {
+    return 0;
+  }
+
+  unsigned long size = 0;
+  unsigned long resident = 0;
+  const int count = std::fscanf(file, "%lu %lu", &size, &resident);
+  std::fclose(file);
+  return count == 2 ? static_cast<double>(resident) * static_cast<double>(sysconf(_SC_PAGESIZE)) / (1024.0 * 1024.0)
+                    : 0;
+#else
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return static_cast<double>(usage.ru_maxrss) / (1024.0 * 1024.0);
+#endif
+}
+
+/// writes minutes of mono float at 48 kHz: a slow sweep over noise.
+bool write_file(const std::string& path, std::uint64_t minutes) {
+  std::FILE* file = std::fopen(path.c_str(), "wb");
+  if (!file) {
+    return false;
+  }
+
+  std::vector<float> chunk(48000);
+  std::uint32_t seed = 1;
+  double phase = 0;
+
+  for (std::uint64_t s = 0; s < minutes * 60; s++) {
+    const double frequency = 100.0 + 9900.0 * (0.5 + 0.5 * std::sin(static_cast<double>(s) * 0.05));
+    for (float& sample : chunk) {
+      seed = seed * 1664525u + 1013904223u;
+      const float noise = static_cast<float>(seed >> 8) / 8388608.0f - 1.0f;
+      phase += 2.0 * 3.14159265358979323846 * frequency / 48000.0;
+      sample = 0.5f * static_cast<float>(std::sin(phase)) + 0.01f * noise;
+    }
+
+    if (std::fwrite(chunk.data(), sizeof(float), chunk.size(), file) != chunk.size()) {
+      std::fclose(file);
+      return false;
+    }
+  }
+
+  return std::fclose(file) == 0;
+}
+} // namespace.
+
+// Pyramid build time of a long recording, then the frame time and the resident
+// memory of a full hd wide view scrolling through it at the finest level and
+// zoomed out, by 16 points per frame. The frame time is the commit, the tiles
+// that are not prefetched yet are rendered in it.
+//
+// usage: spectrogram_benchmark [path] [minutes]
+int main(int argc, const char* argv[]) {
+  const std::string path = argc > 1 ? argv[1] : "/tmp/nano_spectrogram_benchmark.raw";
+  const std::uint64_t minutes = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 20;
+  const std::string pyramid_path = path + ".pyramid";
+
+  std::remove(pyramid_path.c_str());
+  if (!write_file(path, minutes)) {
+    std::cerr << "could not write " << path << std::endl;
+    return 1;
+  }
+
+  std::shared_ptr<nano::mapped_audio_file> file = std::make_shared<nano::mapped_audio_file>();
+  if (!file->open_raw(path, nano::audio_format{ nano::sample_format::float32, 1, 48000 })) {
+    std::cerr << "could not map " << path << std::endl;
+    return 1;
+  }
+
+  const double start_mb = get_resident_mb();
+  auto data = std::make_shared<nano::spectrogram_data>(file, nano::spectrogram_data::options());
+
+  auto start = std::chrono::steady_clock::now();
+  data->build(pyramid_path);
+  data->wait();
+  std::cout << "build : " << ms_duration(std::chrono::steady_clock::now() - start).count() << " ms, "
+            << data->get_column_count(0) << " columns, "
+            << static_cast<double>(data->get_mapped_size()) / (1024.0 * 1024.0) << " MB pyramid, "
+            << get_resident_mb() - start_mb << " MB resident" << std::endl;
+
+  // The views are drawn with CoreGraphics, which has no linux backend yet.
+#if defined(__APPLE__)
+  auto root = std::make_unique<nano::view>(nano::rect<int>(0, 0, view_width, view_height));
+  auto view = std::make_unique<nano::spectrogram_view>(root.get(), nano::rect<int>(0, 0, view_width, view_height));
+  view->set_data(data);
+
+  nano::headless_presenter presenter;
+  auto comp = std::make_unique<nano::compositor>(root.get(), &presenter);
+
+  const double hop = static_cast<double>(data->get_options().hop_size);
+  for (double zoom : { 1.0, 16.0 }) {
+    view->get_tile_cache().clear();
+    view->get_tile_cache().reset_stats();
+    view->set_visible_range(0, hop * zoom);
+    comp->commit();
+    comp->flush();
+
+    double average = 0;
+    double max = 0;
+    for (int i = 0; i < frame_count; i++) {
+      start = std::chrono::steady_clock::now();
+      view->scroll(16.0f);
+      comp->commit();
+      const double ms = ms_duration(std::chrono::steady_clock::now() - start).count();
+      comp->flush();
+
+      average += ms / frame_count;
+      max = std::max(max, ms);
+    }
+
+    const nano::spectrogram_tile_cache::stats stats = view->get_tile_cache().get_stats();
+    std::cout << "scroll level " << view->get_level() << " : " << average << " ms per frame, " << max
+              << " ms max, " << stats.renders << " tiles rendered, " << stats.misses << " missed, "
+              << static_cast<double>(stats.byte_size) / (1024.0 * 1024.0) << " MB of tiles, "
+              << get_resident_mb() - start_mb << " MB resident" << std::endl;
+  }
+
+  comp.reset();
+  view.reset();
+#else
+  std::cout << "scroll : the views are only drawn on macos" << std::endl;
+#endif
+
+  std::remove(pyramid_path.c_str());
+  std::remove(path.c_str());
+  return 0;
+}
@@ -0,0 +1,56 @@
+#include <nano/ui/spectrum.h>
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+namespace {
+using us_duration = std::chrono::duration<double, std::micro>;
+
+constexpr int update_count = 2000;
+constexpr float refresh_rate = 60.0f;
+
+/// returns the time of one update of a single channel analyzer, in microseconds.
+double time_update(std::size_t fft_size) {
+  nano::spectrum_analyzer::options opts;
+  opts.fft_size = fft_size;
+  opts.channel_count = 1;
+  opts.refresh_rate = refresh_rate;
+  nano::spectrum_analyzer analyzer(opts);
+
+  // The samples pushed by the audio thread between two updates.
+  const std::size_t hop = static_cast<std::size_t>(opts.sample_rate / refresh_rate);
+  std::vector<float> samples(hop);
+  std::uint32_t seed = 1;
+  for (float& s : samples) {
+    seed = seed * 1664525u + 1013904223u;
+    s = static_cast<float>(seed >> 8) / 8388608.0f - 1.0f;
+  }
+
+  const float* channels[1] = { samples.data() };
+  double total = 0;
+
+  for (int i = 0; i < update_count; i++) {
+    analyzer.push(channels, hop);
+
+    const auto start = std::chrono::steady_clock::now();
+    analyzer.update();
+    total += us_duration(std::chrono::steady_clock::now() - start).count();
+  }
+
+  return total / update_count;
+}
+} // namespace.
+
+// Worker cost of one channel at 60 updates per second, for each fft size: the
+// window, the transform, the power and the reduction to 256 log spaced bins.
+int main(int, const char*[]) {
+  for (std::size_t fft_size = 1024; fft_size <= 16384; fft_size *= 2) {
+    const double us = time_update(fft_size);
+    std::cout << "fft " << fft_size << " : " << us << " us per update, " << us * refresh_rate / 10000.0
+              << " % of a core per channel at 60 fps" << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,136 @@
+#include <nano/ui/compositor.h>
+#include <nano/ui/headless.h>
+#include <nano/ui/strip_chart.h>
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+// The views are drawn with CoreGraphics, which has no linux backend yet.
+#if defined(__APPLE__)
+
+namespace {
+using ms_duration = std::chrono::duration<double, std::milli>;
+
+constexpr int series_count = 32;
+constexpr float sample_rate = 10000.0f;
+constexpr int frame_count = 600;
+constexpr std::size_t frames_per_update = 10000 / 60;
+
+struct run_result {
+  double update_ms = 0;
+  double commit_ms = 0;
+  double raster_ms = 0;
+  std::uint64_t painted_pixels = 0;
+};
+
+/// fills frame_count frames of every series, a slow sine with noise at a different rate per series.
+void make_values(std::vector<std::vector<float>>& values, std::uint64_t first_frame, std::size_t frame_count) {
+  std::uint32_t seed = static_cast<std::uint32_t>(first_frame) + 1;
+
+  for (std::size_t s = 0; s < values.size(); s++) {
+    values[s].resize(frame_count);
+    for (std::size_t i = 0; i < frame_count; i++) {
+      seed = seed * 1664525u + 1013904223u;
+      const float noise = static_cast<float>(seed >> 8) / 16777216.0f;
+      const float t = static_cast<float>(first_frame + i) / sample_rate;
+      values[s][i] = 0.5f + 0.4f * std::sin(t * (0.5f + 0.1f * static_cast<float>(s))) + 0.05f * noise;
+    }
+  }
+}
+
+/// a chart of 32 series over 10 seconds, fed with a sixtieth of a second per frame.
+///
+/// @param full_repaint redraws the whole chart on every frame, as when drawing the polylines again.
+run_result run(bool full_repaint) {
+  auto root = std::make_unique<nano::view>(nano::rect<int>(0, 0, 1920, 600));
+  auto ring = std::make_shared<nano::sample_ring>(16384, series_count);
+  auto chart = std::make_unique<nano::strip_chart_view>(root.get(), nano::rect<int>(0, 0, 1920, 600));
+  chart->set_source(ring, sample_rate);
+  chart->set_time_span(10.0f);
+
+  nano::headless_presenter presenter;
+  nano::compositor comp(root.get(), &presenter, 2.0f);
+  comp.commit();
+  comp.flush();
+  const std::uint64_t initial_pixels = comp.get_stats().painted_pixels;
+
+  std::vector<std::vector<float>> values(series_count);
+  std::vector<const float*> pointers(series_count);
+  run_result r;
+
+  for (int f = 0; f < frame_count; f++) {
+    make_values(values, static_cast<std::uint64_t>(f) * frames_per_update, frames_per_update);
+    for (std::size_t s = 0; s < values.size(); s++) {
+      pointers[s] = values[s].data();
+    }
+    ring->write(pointers.data(), frames_per_update);
+
+    auto start = std::chrono::steady_clock::now();
+    chart->update();
+    if (full_repaint) {
+      chart->redraw();
+    }
+    r.update_ms += ms_duration(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    comp.commit();
+    r.commit_ms += ms_duration(std::chrono::steady_clock::now() - start).count();
+
+    comp.flush();
+    r.raster_ms += comp.get_stats().last_raster_ms;
+  }
+
+  r.painted_pixels = comp.get_stats().painted_pixels - initial_pixels;
+  chart.reset();
+  return r;
+}
+
+void print(const char* name, const run_result& r) {
+  const double n = static_cast<double>(frame_count);
+  std::cout << name << " : main thread " << (r.update_ms + r.commit_ms) / n << " ms, raster " << r.raster_ms / n
+            << " ms, " << static_cast<double>(r.painted_pixels) / n << " pixels painted per frame" << std::endl;
+}
+} // namespace.
+
+// 32 series at 10 kHz in a full hd wide chart showing the last 10 seconds,
+// updated at 60 fps for 10 seconds and rendered headless at 2x. Scrolling the
+// drawn columns and painting only the new ones is compared with repainting the
+// whole chart on every frame. The main thread time is draining the ring, the
+// decimation and the commit. The decimation alone is measured first.
+int main(int, const char*[]) {
+  {
+    nano::strip_chart_history history(series_count, 4096);
+    history.set_frames_per_column(sample_rate * 10.0 / 1920.0);
+
+    std::vector<std::vector<float>> values(series_count);
+    std::vector<const float*> pointers(series_count);
+    make_values(values, 0, static_cast<std::size_t>(sample_rate));
+    for (std::size_t s = 0; s < values.size(); s++) {
+      pointers[s] = values[s].data();
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 60; i++) {
+      history.append(pointers.data(), values[0].size());
+    }
+    const double ms = ms_duration(std::chrono::steady_clock::now() - start).count();
+    std::cout << "decimation : " << ms / 60.0 << " ms per second of input, "
+              << 60.0 * series_count * static_cast<double>(sample_rate) / (ms * 1000.0) << " M values/s" << std::endl;
+  }
+
+  print("full repaint", run(true));
+  print("scroll      ", run(false));
+  return 0;
+}
+
+#else
+
+int main(int, const char*[]) {
+  std::cout << "the views are only drawn on macos" << std::endl;
+  return 0;
+}
+
+#endif
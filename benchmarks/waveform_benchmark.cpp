@@ -0,0 +1,136 @@
+#include <nano/ui/waveform.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+using ms_duration = std::chrono::duration<double, std::milli>;
+
+constexpr std::size_t column_count = 1920;
+constexpr int frame_count = 240;
+
+struct frame_times {
+  double average = 0;
+  double max = 0;
+};
+
+/// writes size bytes of mono float noise with a slow envelope.
+bool write_file(const std::string& path, std::uint64_t size) {
+  std::FILE* file = std::fopen(path.c_str(), "wb");
+  if (!file) {
+    return false;
+  }
+
+  std::vector<float> chunk(1024 * 1024);
+  std::uint32_t seed = 1;
+  std::uint64_t frame = 0;
+
+  for (std::uint64_t written = 0; written < size; written += chunk.size() * sizeof(float)) {
+    for (float& s : chunk) {
+      seed = seed * 1664525u + 1013904223u;
+      const float noise = static_cast<float>(seed >> 8) / 8388608.0f - 1.0f;
+      s = noise * std::abs(std::sin(static_cast<float>(frame++) * 1e-7f));
+    }
+
+    if (std::fwrite(chunk.data(), sizeof(float), chunk.size(), file) != chunk.size()) {
+      std::fclose(file);
+      return false;
+    }
+  }
+
+  return std::fclose(file) == 0;
+}
+
+/// reads the columns of a 1920 points wide view for each frame of an animation.
+template <class Range>
+frame_times run_frames(const nano::waveform_summary& summary, Range&& range) {
+  std::vector<nano::waveform_peak> columns(column_count);
+  frame_times times;
+
+  for (int i = 0; i < frame_count; i++) {
+    double start_frame = 0;
+    double frames_per_column = 0;
+    range(i, start_frame, frames_per_column);
+
+    const auto start = std::chrono::steady_clock::now();
+    summary.get_columns(0, start_frame, frames_per_column, column_count, columns.data());
+    const double ms = ms_duration(std::chrono::steady_clock::now() - start).count();
+
+    times.average += ms / frame_count;
+    times.max = std::max(times.max, ms);
+  }
+
+  return times;
+}
+
+void print(const char* name, const frame_times& times) {
+  std::cout << name << " : " << times.average << " ms per frame, " << times.max << " ms max" << std::endl;
+}
+} // namespace.
+
+// Summary build time of a 2 GB file, then the time to read the columns of a
+// full hd wide view while zooming from the whole file to the samples and while
+// scrolling. Drawing the columns is left out, it only depends on the width.
+//
+// usage: waveform_benchmark [path] [size in MB]
+int main(int argc, const char* argv[]) {
+  const std::string path = argc > 1 ? argv[1] : "/tmp/nano_waveform_benchmark.raw";
+  const std::uint64_t size = (argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 2048) * 1024 * 1024;
+  const std::string sidecar_path = path + ".peaks";
+
+  std::remove(sidecar_path.c_str());
+  if (!write_file(path, size)) {
+    std::cerr << "could not write " << path << std::endl;
+    return 1;
+  }
+
+  std::shared_ptr<nano::mapped_audio_file> file = std::make_shared<nano::mapped_audio_file>();
+  if (!file->open_raw(path, nano::audio_format())) {
+    std::cerr << "could not map " << path << std::endl;
+    return 1;
+  }
+
+  const double file_frames = static_cast<double>(file->get_frame_count());
+
+  {
+    nano::waveform_summary summary(file);
+    const auto start = std::chrono::steady_clock::now();
+    summary.build(sidecar_path);
+    summary.wait();
+    const double ms = ms_duration(std::chrono::steady_clock::now() - start).count();
+    std::cout << "build : " << ms << " ms, " << static_cast<double>(size) / (1024.0 * 1024.0) / (ms / 1000.0)
+              << " MB/s, " << summary.get_level_count() << " levels" << std::endl;
+  }
+
+  nano::waveform_summary summary(file);
+  const auto start = std::chrono::steady_clock::now();
+  summary.build(sidecar_path);
+  summary.wait();
+  std::cout << "sidecar load : " << ms_duration(std::chrono::steady_clock::now() - start).count() << " ms"
+            << std::endl;
+
+  // Zooms in geometrically from the whole file to 1/4 frame per column, around the middle.
+  print("zoom   ", run_frames(summary, [&](int i, double& start_frame, double& frames_per_column) {
+    frames_per_column = file_frames / column_count * std::pow(0.25 / (file_frames / column_count), i / 239.0);
+    start_frame = file_frames * 0.5 - frames_per_column * column_count * 0.5;
+  }));
+
+  // Scrolls a view at 1, 100 and 10000 frames per column, by a third of the view per frame.
+  for (double zoom : { 1.0, 100.0, 10000.0 }) {
+    const std::string name = "scroll " + std::to_string(static_cast<int>(zoom));
+    print(name.c_str(), run_frames(summary, [&](int i, double& start_frame, double& frames_per_column) {
+      frames_per_column = zoom;
+      start_frame = std::fmod(i * zoom * column_count / 3.0, file_frames);
+    }));
+  }
+
+  std::remove(sidecar_path.c_str());
+  std::remove(path.c_str());
+  return 0;
+}
@@ -0,0 +1,146 @@
+#include <nano/ui/x11.h>
+
+#include <iostream>
+
+#if defined(__linux__)
+
+#include <nano/ui/pixel_buffer.h>
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include <X11/Xlib.h>
+
+namespace {
+using ms_duration = std::chrono::duration<double, std::milli>;
+using us_duration = std::chrono::duration<double, std::micro>;
+
+constexpr int window_size = 512;
+constexpr int damage_size = 64;
+constexpr int full_frame_count = 200;
+constexpr int damaged_frame_count = 2000;
+constexpr int latency_count = 500;
+
+void print_throughput(const char* name, int frames, int pixels_per_frame, double total_ms) {
+  std::cout << name << " : " << frames / total_ms * 1000.0 << " frames/s, "
+            << static_cast<double>(frames) * pixels_per_frame / total_ms / 1000.0 << " Mpixels/s" << std::endl;
+}
+
+void print_percentiles(const char* name, std::vector<double> values, const char* unit) {
+  std::sort(values.begin(), values.end());
+  const auto at = [&](double p) {
+    return values[static_cast<std::size_t>(p * static_cast<double>(values.size() - 1))];
+  };
+  std::cout << name << " : p50 " << at(0.5) << " " << unit << ", p99 " << at(0.99) << " " << unit << ", max "
+            << values.back() << " " << unit << std::endl;
+}
+} // namespace.
+
+// A 512x512 window is presented from a pixel buffer, first whole and then
+// with a 64x64 damaged rect moving around, which is what a caret or a meter
+// costs. The input to present latency is from XSendEvent() to the end of the
+// present() done by the event handler: the event goes through the server, the
+// connection's run loop source and the window handler, the same path as a
+// real click. Run under Xvfb (e.g. xvfb-run) on machines without a display,
+// with and without MIT-SHM (xvfb-run -s "-extension MIT-SHM").
+int main(int, const char*[]) {
+  nano::run_loop loop;
+  nano::x11_connection connection(loop);
+  if (!connection.is_valid()) {
+    std::cout << "no display" << std::endl;
+    return 0;
+  }
+
+  Display* display = connection.get_display();
+  const nano::x11_window_id window
+      = XCreateSimpleWindow(display, connection.get_root_window(), 0, 0, window_size, window_size, 0, 0, 0);
+  XMapWindow(display, window);
+  connection.sync();
+
+  nano::x11_presenter presenter(connection, window);
+  nano::pixel_buffer frame(window_size, window_size);
+  std::cout << "mit-shm : " << (connection.has_shm() ? "yes" : "no") << std::endl;
+
+  // Full frames.
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < full_frame_count; i++) {
+    frame.clear(nano::make_pixel(static_cast<std::uint8_t>(i), 0, 0, 255));
+    presenter.present(frame, nano::region(frame.get_bounds()));
+  }
+  print_throughput("full frames", full_frame_count, window_size * window_size,
+      ms_duration(std::chrono::steady_clock::now() - start).count());
+
+  // Damaged rects.
+  constexpr int steps = window_size / damage_size;
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < damaged_frame_count; i++) {
+    const int x = (i % steps) * damage_size;
+    const int y = ((i / steps) % steps) * damage_size;
+    const nano::rect<int> rect(x, y, damage_size, damage_size);
+    frame.fill(rect, nano::make_pixel(0, static_cast<std::uint8_t>(i), 0, 255));
+    presenter.present(frame, nano::region(rect));
+  }
+  print_throughput("damaged rects", damaged_frame_count, damage_size * damage_size,
+      ms_duration(std::chrono::steady_clock::now() - start).count());
+
+  // Input to present.
+  std::vector<double> latencies;
+  latencies.reserve(latency_count);
+  std::chrono::steady_clock::time_point sent;
+  bool presented = false;
+
+  connection.add_window(window, [&](XEvent& evt) {
+    if (evt.type != ButtonPress) {
+      return;
+    }
+
+    const nano::rect<int> rect(evt.xbutton.x, evt.xbutton.y, damage_size, damage_size);
+    frame.fill(rect, nano::make_pixel(0, 0, 255, 255));
+    presenter.present(frame, nano::region(rect));
+    latencies.push_back(us_duration(std::chrono::steady_clock::now() - sent).count());
+    presented = true;
+  });
+
+  for (int i = 0; i < latency_count; i++) {
+    XEvent press = {};
+    press.xbutton.type = ButtonPress;
+    press.xbutton.window = window;
+    press.xbutton.button = Button1;
+    press.xbutton.x = (i % steps) * damage_size;
+    press.xbutton.y = ((i / steps) % steps) * damage_size;
+
+    presented = false;
+    sent = std::chrono::steady_clock::now();
+    XSendEvent(display, window, False, NoEventMask, &press);
+    connection.flush();
+
+    while (!presented && loop.run_once(1000)) {
+    }
+  }
+
+  connection.remove_window(window);
+  if (latencies.empty()) {
+    std::cout << "no input event received" << std::endl;
+    return 1;
+  }
+
+  print_percentiles("input to present latency", latencies, "us");
+
+  const nano::x11_presenter::stats stats = presenter.get_stats();
+  std::cout << "presenter : " << stats.frames << " frames, " << stats.uploaded_pixels << " pixels uploaded, "
+            << stats.allocations << " allocations" << std::endl;
+
+  XDestroyWindow(display, window);
+  connection.sync();
+  return 0;
+}
+
+#else
+
+int main(int, const char*[]) {
+  std::cout << "the x11 backend is only used on linux" << std::endl;
+  return 0;
+}
+
+#endif
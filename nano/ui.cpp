@@ -12,11 +12,27 @@
  */
 
 #include <nano/ui.h>
+
+#if defined(__APPLE__)
+
+#include <nano/ui/blur.h>
+#include <nano/ui/color_conversion.h>
+#include <nano/ui/compositor.h>
+#include <nano/ui/filmstrip.h>
+#include <nano/ui/headless.h>
+#include <nano/ui/menu.h>
+#include <nano/ui/path_cache.h>
 #include <nano/objc.h>
 #include <CoreFoundation/CoreFoundation.h>
 #include <CoreGraphics/CoreGraphics.h>
+#include <ImageIO/ImageIO.h>
 #include <dispatch/dispatch.h>
 
+#include <cmath>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
 extern "C" {
 extern CFStringRef NSViewFrameDidChangeNotification;
 }
@@ -38,6 +54,64 @@ NANO_INLINE_CXPR objc::ns_uint_t uiNSTrackingMouseMoved = 0x02;
 NANO_INLINE_CXPR objc::ns_uint_t uiNSTrackingInVisibleRect = 0x200;
 
 namespace {
+  /// the pdf context of compositor::record() on this thread, and the scale its list is rasterized at.
+  thread_local CGContextRef recording_context = nullptr;
+  thread_local float recording_scale = 1.0f;
+
+  /// returns the number of pixels per point the context draws at.
+  /// @details a recording is a pdf context at a scale of 1, the cached bitmaps
+  ///          (shadows, sprites, paths) are picked at the scale it is rasterized at.
+  float get_device_scale(CGContextRef ctx) {
+    const CGAffineTransform tr = CGContextGetUserSpaceToDeviceSpaceTransform(ctx);
+    const float scale = static_cast<float>(std::hypot(tr.a, tr.b));
+    return ctx == recording_context ? scale * recording_scale : scale;
+  }
+
+  /// draws a rounded rect shadow from the shadow mask cache.
+  void draw_shadow_mask(
+      CGContextRef ctx, const nano::rect<float>& rect, float corner_radius, const nano::shadow& s, float opacity) {
+    const float scale = get_device_scale(ctx);
+
+    std::shared_ptr<const shadow_mask> mask
+        = shadow_cache::get_main().get_rounded_rect(rect.size, corner_radius, s.blur, scale);
+
+    if (mask->mask.empty()) {
+      return;
+    }
+
+    const std::size_t width = static_cast<std::size_t>(mask->mask.get_width());
+    const std::size_t height = static_cast<std::size_t>(mask->mask.get_height());
+
+    // The provider keeps the mask alive for as long as CoreGraphics needs it.
+    auto* holder = new std::shared_ptr<const shadow_mask>(mask);
+    CGDataProviderRef provider = CGDataProviderCreateWithData(holder, mask->mask.data(), mask->mask.get_byte_size(),
+        [](void* info, const void*, std::size_t) { delete static_cast<std::shared_ptr<const shadow_mask>*>(info); });
+
+    CGColorSpaceRef gray = CGColorSpaceCreateDeviceGray();
+    CGImageRef image = CGImageCreate(
+        width, height, 8, 8, width, gray, kCGImageAlphaNone, provider, nullptr, false, kCGRenderingIntentDefault);
+    CGColorSpaceRelease(gray);
+    CGDataProviderRelease(provider);
+
+    // The mask of a rounded rect is symmetric, flipped contexts don't matter.
+    const float x = rect.x + s.offset.x + static_cast<float>(mask->offset.x) / scale;
+    const float y = rect.y + s.offset.y + static_cast<float>(mask->offset.y) / scale;
+    const float w = static_cast<float>(width) / scale;
+    const float h = static_cast<float>(height) / scale;
+    const CGRect dst = CGRectMake(
+        static_cast<CGFloat>(x), static_cast<CGFloat>(y), static_cast<CGFloat>(w), static_cast<CGFloat>(h));
+
+    CGContextSaveGState(ctx);
+    CGContextClipToMask(ctx, dst, image);
+    CGContextSetRGBFillColor(ctx, static_cast<CGFloat>(s.color.red<float>()),
+        static_cast<CGFloat>(s.color.green<float>()), static_cast<CGFloat>(s.color.blue<float>()),
+        static_cast<CGFloat>(s.color.alpha<float>() * opacity));
+    CGContextFillRect(ctx, dst);
+    CGContextRestoreGState(ctx);
+
+    CGImageRelease(image);
+  }
+
   inline nano::point<int> get_location_in_view(native_event_handle handle, nano::view* view) {
     CGPoint locInWindow = objc::call<CGPoint>(handle, "locationInWindow");
     return objc::call<CGPoint, CGPoint, objc::obj_t*>(reinterpret_cast<objc::obj_t*>(view->get_native_handle()),
@@ -227,6 +301,123 @@ std::u16string event::get_key() const noexcept {
 // CGEventKeyboardGetUnicodeString(CGEventRef event, UniCharCount maxStringLength, UniCharCount *actualStringLength,
 // UniChar *unicodeString);
 
+//
+// MARK: - menu -
+//
+
+// The main menu of the application, translated from the shared menu_model.
+// The items have no target, their action goes up the responder chain to the
+// delegate of the key window, or to the application delegate when no window
+// is open, which dispatch the tag to the model.
+class native_menu_translator : public menu_model::translator {
+public:
+  ~native_menu_translator() override {
+    if (m_main_menu) {
+      objc::release(m_main_menu);
+    }
+  }
+
+  static native_menu_translator& get() {
+    NANO_CLANG_PUSH_WARNING("-Wexit-time-destructors")
+    static native_menu_translator translator;
+    NANO_CLANG_POP_WARNING()
+    return translator;
+  }
+
+  void translate(const std::vector<menu_item>& items, const menu_diff& diff) override {
+    if (diff.structure || !m_main_menu) {
+      objc::obj_t* menu = create_menu("Main", items);
+      objc_object* sharedApplication = objc::get_class_property("NSApplication", "sharedApplication");
+      objc::call<void, objc_object*>(sharedApplication, "setMainMenu:", menu);
+
+      if (m_main_menu) {
+        objc::release(m_main_menu);
+      }
+
+      m_main_menu = menu;
+      return;
+    }
+
+    for (const std::vector<std::size_t>& path : diff.changed_items) {
+      const menu_item* item = find_menu_item(items, path);
+      objc::obj_t* native_item = find_native_item(path);
+
+      if (item && native_item) {
+        update_item(native_item, *item);
+      }
+    }
+  }
+
+private:
+  objc::obj_t* m_main_menu = nullptr;
+
+  static objc::obj_t* create_menu(const char* title, const std::vector<menu_item>& items) {
+    static objc::selector_t* addItemSelector = objc::get_selector("addItem:");
+
+    objc::obj_t* menu = objc::create_object<void, CFStringRef>("NSMenu", "initWithTitle:", cf::create_string(title));
+
+    // The enabled state comes from the model.
+    objc::call<void, bool>(menu, "setAutoenablesItems:", false);
+
+    for (const menu_item& item : items) {
+      if (item.separator) {
+        objc::icall(menu, addItemSelector, objc::get_class_property("NSMenuItem", "separatorItem"));
+        continue;
+      }
+
+      objc::obj_t* native_item = create_item(item);
+      objc::icall(menu, addItemSelector, native_item);
+      objc::release(native_item);
+    }
+
+    return menu;
+  }
+
+  static objc::obj_t* create_item(const menu_item& item) {
+    static objc::selector_t* initItemWithTitleSelector = objc::get_selector("initWithTitle:action:keyEquivalent:");
+    static objc::selector_t* menuActionSelector = objc::get_selector("menuAction:");
+
+    objc::obj_t* native_item = objc::create_class_instance("NSMenuItem");
+    objc::call<void, CFStringRef, objc::selector_t*, CFStringRef>(native_item, initItemWithTitleSelector,
+        cf::create_string(item.title.c_str()), item.is_submenu() ? nullptr : menuActionSelector,
+        cf::create_string(item.key_equivalent.c_str()));
+
+    objc::call<void, long>(native_item, "setTag:", static_cast<long>(item.command));
+    update_item(native_item, item);
+
+    if (item.is_submenu()) {
+      objc::obj_t* submenu = create_menu(item.title.c_str(), item.items);
+      objc::icall(native_item, "setSubmenu:", submenu);
+      objc::release(submenu);
+    }
+
+    return native_item;
+  }
+
+  static void update_item(objc::obj_t* native_item, const menu_item& item) {
+    objc::call<void, CFStringRef>(native_item, "setTitle:", cf::create_string(item.title.c_str()));
+    objc::call<void, CFStringRef>(native_item, "setKeyEquivalent:", cf::create_string(item.key_equivalent.c_str()));
+    objc::call<void, bool>(native_item, "setEnabled:", item.enabled);
+    objc::call<void, long>(native_item, "setState:", item.checked ? 1 : 0);
+  }
+
+  objc::obj_t* find_native_item(const std::vector<std::size_t>& path) const {
+    objc::obj_t* menu = m_main_menu;
+    objc::obj_t* native_item = nullptr;
+
+    for (std::size_t index : path) {
+      if (!menu) {
+        return nullptr;
+      }
+
+      native_item = objc::call<objc::obj_t*, long>(menu, "itemAtIndex:", static_cast<long>(index));
+      menu = native_item ? objc::call<objc::obj_t*>(native_item, "submenu") : nullptr;
+    }
+
+    return native_item;
+  }
+};
+
 class window_object {
 public:
   static constexpr const char* className = "NanoWindowObject";
@@ -292,8 +483,13 @@ public:
     objc::icall(m_window, "makeKeyAndOrderFront:");
     objc::call(m_window, "center");
 
-    create_menu();
-    //
+    // The menu is shared by the windows, it is only translated when it changed.
+    menu_model& menu = menu_model::get_main();
+    if (!menu.get_translator()) {
+      menu.set_translator(&native_menu_translator::get());
+    }
+
+    menu.update_native();
   }
 
   ~window_object() {
@@ -386,71 +582,6 @@ public:
 
   void set_delegate(window_proxy::delegate* d) { m_window_delegate = d; }
 
-  inline objc::obj_t* create_menu_item(const char* title, const char* keyEquivalent, long tag) {
-    static objc::selector_t* initItemWithTitleSelector = objc::get_selector("initWithTitle:action:keyEquivalent:");
-    static objc::selector_t* menuActionSelector = objc::get_selector("menuAction:");
-
-    objc::obj_t* item = objc::create_class_instance("NSMenuItem");
-    objc::call<void, CFStringRef, objc::selector_t*, CFStringRef>(item, initItemWithTitleSelector,
-        cf::create_string(title), menuActionSelector, cf::create_string(keyEquivalent));
-
-    objc::call<void, long>(item, "setTag:", tag);
-    objc::icall(item, "setTarget:", m_obj);
-
-    return item;
-  }
-
-  inline objc::obj_t* create_menu(const char* title) {
-
-    return objc::create_object<void, CFStringRef>("NSMenu", "initWithTitle:", cf::create_string(title));
-  }
-
-  inline void add_menu_item(objc::obj_t* menu, objc::obj_t* item, bool release_item = false) {
-    static objc::selector_t* addItemSelector = objc::get_selector("addItem:");
-    objc::icall(menu, addItemSelector, item);
-
-    if (release_item) {
-      objc::release(item);
-    }
-  }
-
-  inline void set_submenu(objc::obj_t* item, objc::obj_t* submenu, bool release_submenu = false) {
-    static objc::selector_t* selector = objc::get_selector("setSubmenu:");
-    objc::icall(item, selector, submenu);
-
-    if (release_submenu) {
-      objc::release(submenu);
-    }
-  }
-
-  void create_menu() {
-
-    objc::obj_t* mainMenu = create_menu("Title");
-
-    {
-      objc::obj_t* aboutMenu = create_menu("AppName");
-      add_menu_item(aboutMenu, create_menu_item("About AppName", "", 1111), true);
-      add_menu_item(aboutMenu, create_menu_item("Quit AppName", "q", 128932), true);
-
-      objc::obj_t* aboutMenuItem = create_menu_item("UI", "", 0);
-      set_submenu(aboutMenuItem, aboutMenu, true);
-      add_menu_item(mainMenu, aboutMenuItem, true);
-    }
-
-    {
-      objc::obj_t* fileMenu = create_menu("File");
-      add_menu_item(fileMenu, create_menu_item("New", "", 232), true);
-
-      objc::obj_t* fileMenuItem = create_menu_item("UI", "", 0);
-      set_submenu(fileMenuItem, fileMenu, true);
-      add_menu_item(mainMenu, fileMenuItem, true);
-    }
-
-    objc_object* sharedApplication = objc::get_class_property("NSApplication", "sharedApplication");
-    objc::call<void, objc_object*>(sharedApplication, "setMainMenu:", mainMenu);
-    objc::release(mainMenu);
-  }
-
   nano::view* m_view;
   objc::obj_t* m_window = nullptr;
   objc::obj_t* m_obj;
@@ -531,16 +662,8 @@ public:
   }
 
   void on_menu_action(objc::obj_t* sender) {
-    long tag = objc::call<long>(sender, "tag");
-
-    if (tag == 128932) {
-      nano::application::quit();
-      return;
-    }
-    //        NSLog(@"About %@ %@ %d", sender, [sender title], (int)[sender
-    //        tag]);
-    //        [[NSApplication sharedApplication] terminate:self];
-    std::cout << "on_menu_action " << tag << std::endl;
+    const long tag = objc::call<long>(sender, "tag");
+    menu_model::get_main().dispatch(static_cast<command_id>(tag));
   }
 
   void on_dealloc() { std::cout << "WindowComponent->on_dealloc" << std::endl; }
@@ -757,6 +880,10 @@ public:
 
   bool is_hidden() const { return objc::call<bool>(m_obj, "isHidden"); }
 
+  void set_opacity(float opacity) { objc::call<void, CGFloat>(m_obj, "setAlphaValue:", static_cast<CGFloat>(opacity)); }
+
+  float get_opacity() const { return static_cast<float>(objc::call<CGFloat>(m_obj, "alphaValue")); }
+
   void set_frame(const nano::rect<int>& rect) { objc::call<void, CGRect>(m_obj, "setFrame:", rect.convert<CGRect>()); }
 
   void set_frame_position(const nano::point<int>& pos) {
@@ -847,7 +974,49 @@ public:
     objc::call<void, CGRect>(m_obj, "setNeedsDisplayInRect:", rect.convert<CGRect>());
   }
 
-  void on_resize([[maybe_unused]] objc::obj_t* evt) { m_view->on_frame_changed(); }
+  void on_resize([[maybe_unused]] objc::obj_t* evt) {
+    // Composited views are laid out at the compositor's pace during a live resize.
+    if (compositor* c = find_compositor(); c && c->defer_layout(m_view)) {
+      return;
+    }
+
+    m_view->on_frame_changed();
+  }
+
+  void on_will_start_live_resize() {
+    if (compositor* c = find_compositor()) {
+      // AppKit sends this to every view, the compositor notifies its whole tree.
+      if (c->get_view() == m_view) {
+        c->begin_live_resize();
+      }
+    }
+    else {
+      m_view->on_will_start_live_resize();
+    }
+
+    classObject.send_superclass_message<void>(m_obj, "viewWillStartLiveResize");
+  }
+
+  void on_did_end_live_resize() {
+    if (compositor* c = find_compositor()) {
+      if (c->get_view() == m_view) {
+        c->end_live_resize();
+      }
+    }
+    else {
+      m_view->on_did_end_live_resize();
+    }
+
+    classObject.send_superclass_message<void>(m_obj, "viewDidEndLiveResize");
+  }
+
+  bool is_in_live_resize() const {
+    if (compositor* c = find_compositor()) {
+      return c->is_in_live_resize();
+    }
+
+    return objc::call<bool>(m_obj, "inLiveResize");
+  }
 
   inline event create_event(objc::obj_t* evt) { return event(reinterpret_cast<native_event_handle>(evt), m_view); }
 
@@ -891,10 +1060,18 @@ public:
   void on_will_draw() { m_view->on_will_draw(); }
 
   void on_draw(nano::rect<float> rect) {
+    // The content of composited views is presented through their layer.
+    if (find_compositor()) {
+      return;
+    }
+
     objc::obj_t* nsContext = objc::get_class_property("NSGraphicsContext", "currentContext");
-    nano::graphic_context gc(
-        reinterpret_cast<nano::graphic_context::handle>(objc::call<CGContextRef>(nsContext, "CGContext")));
+    CGContextRef ctx = objc::call<CGContextRef>(nsContext, "CGContext");
+    nano::graphic_context gc(reinterpret_cast<nano::graphic_context::handle>(ctx));
     m_view->on_draw(gc, rect);
+
+    // Subviews are drawn after their parent, over their shadows.
+    draw_subview_shadows(m_view, ctx);
   }
 
   void on_did_hide() { m_view->on_hide(); }
@@ -924,6 +1101,85 @@ public:
   std::unique_ptr<window_object> m_win;
   view* m_parent = nullptr;
   std::vector<view*> m_children;
+  compositor* m_compositor = nullptr;
+  std::optional<nano::shadow> m_shadow;
+  float m_shadow_corner_radius = 0.0f;
+
+  /// returns the compositor attached to the root of this view, if any.
+  compositor* find_compositor() const {
+    const pimpl* p = this;
+    while (p->m_parent) {
+      p = p->m_parent->m_pimpl.get();
+    }
+
+    return p->m_compositor;
+  }
+
+  /// draws the shadows of the subviews, in a context whose origin is the top-left of the view.
+  static void draw_subview_shadows(view* v, CGContextRef ctx) {
+    for (view* child : v->m_pimpl->m_children) {
+      const pimpl& p = *child->m_pimpl;
+
+      if (p.m_shadow && !child->is_hidden()) {
+        draw_shadow_mask(
+            ctx, nano::rect<float>(child->get_frame()), p.m_shadow_corner_radius, *p.m_shadow, child->get_opacity());
+      }
+    }
+  }
+
+  /// draws a view and its subviews in a context whose origin is the top-left of the view.
+  static void draw_tree(view* v, CGContextRef ctx, const nano::rect<int>& dirty_rect, float opacity,
+      std::unordered_map<const view*, view_draw_stats>* stats = nullptr) {
+    if (v->is_hidden()) {
+      return;
+    }
+
+    const nano::size<int> size = v->get_frame().size;
+    const nano::rect<int> bounds(0, 0, size.width, size.height);
+    const nano::rect<int> area = get_intersection(dirty_rect, bounds);
+
+    if (is_empty(area)) {
+      return;
+    }
+
+    CGContextSaveGState(ctx);
+    CGContextClipToRect(ctx, bounds.convert<CGRect>());
+    CGContextSetAlpha(ctx, static_cast<CGFloat>(opacity));
+
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    v->on_will_draw();
+    nano::graphic_context gc(reinterpret_cast<nano::graphic_context::handle>(ctx));
+    v->on_draw(gc, nano::rect<float>(area));
+
+    if (stats) {
+      // Includes the time to flush the drawing of the view.
+      CGContextFlush(ctx);
+      const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+      view_draw_stats& s = (*stats)[v];
+      s.draw_count++;
+      s.total_ms += ms;
+      s.max_ms = std::max(s.max_ms, ms);
+    }
+
+    draw_subview_shadows(v, ctx);
+
+    for (view* child : v->m_pimpl->m_children) {
+      const nano::rect<int> frame = child->get_frame();
+
+      CGContextSaveGState(ctx);
+      CGContextTranslateCTM(ctx, static_cast<CGFloat>(frame.x), static_cast<CGFloat>(frame.y));
+      draw_tree(child,
+          ctx,
+          nano::rect<int>(area.x - frame.x, area.y - frame.y, area.width, area.height),
+          opacity * child->get_opacity(),
+          stats);
+      CGContextRestoreGState(ctx);
+    }
+
+    CGContextRestoreGState(ctx);
+  }
 
 private:
   class ClassObject : public objc::class_descriptor<pimpl> {
@@ -974,6 +1230,8 @@ private:
       add_method<&ClassType::on_did_hide>("viewDidHide", "v@:");
       add_method<&ClassType::on_did_unhide>("viewDidUnhide", "v@:");
       add_method<&ClassType::on_update_tracking_areas>("updateTrackingAreas", "v@:");
+      add_method<&ClassType::on_will_start_live_resize>("viewWillStartLiveResize", "v@:");
+      add_method<&ClassType::on_did_end_live_resize>("viewDidEndLiveResize", "v@:");
 
       if (!add_method<draw_rect>("drawRect:", "v@:{CGRect={CGPoint=dd}{CGSize=dd}}")) {
         std::cout << "ERROR" << std::endl;
@@ -1052,7 +1310,15 @@ view::view(native_view_handle parent, const nano::rect<int>& rect, view_flags fl
   }
 }
 
+view::view(const nano::rect<int>& rect) { m_pimpl = std::unique_ptr<pimpl>(new pimpl(this, rect)); }
+
 view::~view() {
+  if (compositor* c = m_pimpl->find_compositor(); c && m_pimpl->m_parent) {
+    c->m_dirty_views.erase(this);
+    c->m_deferred_layouts.erase(this);
+    c->invalidate(m_pimpl->m_parent, get_frame());
+  }
+
   auto& children = m_pimpl->m_children;
 
   if (!children.empty()) {
@@ -1196,6 +1462,29 @@ void view::set_hidden(bool hidden) { m_pimpl->set_hidden(hidden); }
 
 bool view::is_hidden() const { return m_pimpl->is_hidden(); }
 
+void view::set_opacity(float opacity) { m_pimpl->set_opacity(opacity); }
+
+float view::get_opacity() const { return m_pimpl->get_opacity(); }
+
+void view::set_shadow(const nano::shadow& s, float corner_radius) {
+  m_pimpl->m_shadow = s;
+  m_pimpl->m_shadow_corner_radius = corner_radius;
+
+  if (view* parent = get_parent()) {
+    parent->redraw();
+  }
+}
+
+void view::remove_shadow() {
+  m_pimpl->m_shadow.reset();
+
+  if (view* parent = get_parent()) {
+    parent->redraw();
+  }
+}
+
+bool view::has_shadow() const { return m_pimpl->m_shadow.has_value(); }
+
 void view::focus() { m_pimpl->focus(); }
 
 void view::unfocus() { m_pimpl->unfocus(); }
@@ -1204,12 +1493,40 @@ bool view::is_focused() const { return m_pimpl->is_focused(); }
 
 bool view::is_dirty_rect(const nano::rect<int>& rect) const { return m_pimpl->is_dirty_rect(rect); }
 
-void view::redraw() { m_pimpl->redraw(); }
+void view::redraw() {
+  if (compositor* c = m_pimpl->find_compositor()) {
+    c->invalidate(this);
+    return;
+  }
+
+  m_pimpl->redraw();
+}
 
-void view::redraw(const nano::rect<int>& rect) { m_pimpl->redraw(rect); }
+void view::redraw(const nano::rect<int>& rect) {
+  if (compositor* c = m_pimpl->find_compositor()) {
+    c->invalidate(this, rect);
+    return;
+  }
+
+  m_pimpl->redraw(rect);
+}
+
+void view::scroll_rect(const nano::rect<int>& rect, const nano::point<int>& delta) {
+  if (compositor* c = m_pimpl->find_compositor()) {
+    c->scroll(this, rect, delta);
+    return;
+  }
+
+  // Layer backed views have no back buffer to move.
+  m_pimpl->redraw(rect);
+}
+
+bool view::is_in_live_resize() const { return m_pimpl->is_in_live_resize(); }
 
 view* view::get_parent() const { return m_pimpl->m_parent; }
 
+const std::vector<view*>& view::get_children() const { return m_pimpl->m_children; }
+
 nano::rect<int> get_native_view_bounds(nano::native_view_handle native_view) {
   return nano::rect<int>(objc::call<CGRect>(reinterpret_cast<objc::obj_t*>(native_view), "bounds"));
 }
@@ -1336,6 +1653,20 @@ public:
   void application_did_finish_launching(objc_object*) {
     std::cout << "application_did_finish_launching" << std::endl;
     m_app->initialise();
+
+    // The menu is installed even if no window is opened.
+    menu_model& menu = menu_model::get_main();
+    if (!menu.get_translator()) {
+      menu.set_translator(&native_menu_translator::get());
+    }
+
+    menu.update_native();
+  }
+
+  // The menu actions that no window handled, e.g. Quit with every window closed.
+  void on_menu_action(objc::obj_t* sender) {
+    const long tag = objc::call<long>(sender, "tag");
+    menu_model::get_main().dispatch(static_cast<command_id>(tag));
   }
 
   void application_did_become_active(objc_object*) {
@@ -1402,6 +1733,7 @@ private:
       add_notification_method<&ClassType::application_did_become_active>("applicationDidBecomeActive:");
       add_notification_method<&ClassType::application_did_resign_active>("applicationDidResignActive:");
       add_notification_method<&ClassType::application_will_terminate>("applicationWillTerminate:");
+      add_notification_method<&ClassType::on_menu_action>("menuAction:");
 
       if (!add_method<&ClassType::application_should_terminate>("applicationShouldTerminate:", "L@:@")) {
         std::cerr << "ERROR add_method applicationShouldTerminate" << std::endl;
@@ -1473,6 +1805,92 @@ void application::quit() {
   objc::call<void, objc_object*>(sharedApplication, "terminate:", nullptr);
 }
 
+// A dispatch source for each direction on the main queue. They are level-triggered,
+// they fire again for as long as the descriptor stays ready.
+struct fd_watchers {
+  struct watch {
+    dispatch_source_t read_source = nullptr;
+    dispatch_source_t write_source = nullptr;
+  };
+
+  static inline std::unordered_map<int, watch>& get_watches() {
+    NANO_CLANG_PUSH_WARNING("-Wexit-time-destructors")
+    static std::unordered_map<int, watch> watches;
+    NANO_CLANG_POP_WARNING()
+    return watches;
+  }
+
+  static inline dispatch_source_t create_source(
+      dispatch_source_type_t type, int fd, fd_events events, std::shared_ptr<application::fd_callback> callback) {
+    dispatch_source_t source
+        = dispatch_source_create(type, static_cast<std::uintptr_t>(fd), 0, dispatch_get_main_queue());
+    if (!source) {
+      return nullptr;
+    }
+
+    dispatch_source_set_event_handler(source, ^{
+        // A read source with nothing to read is the end of the stream.
+        const bool hang_up = type == DISPATCH_SOURCE_TYPE_READ && dispatch_source_get_data(source) == 0;
+        (*callback)(fd, hang_up ? events | fd_events::hang_up : events);
+    });
+
+    dispatch_resume(source);
+    return source;
+  }
+
+  static inline void release_source(dispatch_source_t source) {
+    if (source) {
+      dispatch_source_cancel(source);
+      dispatch_release(source);
+    }
+  }
+};
+
+bool application::watch_fd(int fd, fd_events events, fd_callback callback) {
+  std::unordered_map<int, fd_watchers::watch>& watches = fd_watchers::get_watches();
+  if (fd < 0 || watches.count(fd)) {
+    return false;
+  }
+
+  auto shared_callback = std::make_shared<fd_callback>(std::move(callback));
+
+  fd_watchers::watch w;
+  if ((events & fd_events::readable) != 0) {
+    w.read_source = fd_watchers::create_source(DISPATCH_SOURCE_TYPE_READ, fd, fd_events::readable, shared_callback);
+  }
+
+  if ((events & fd_events::writable) != 0) {
+    w.write_source = fd_watchers::create_source(DISPATCH_SOURCE_TYPE_WRITE, fd, fd_events::writable, shared_callback);
+  }
+
+  // Both directions or none.
+  const bool read_failed = (events & fd_events::readable) != 0 && !w.read_source;
+  const bool write_failed = (events & fd_events::writable) != 0 && !w.write_source;
+
+  if (read_failed || write_failed || (!w.read_source && !w.write_source)) {
+    fd_watchers::release_source(w.read_source);
+    fd_watchers::release_source(w.write_source);
+    return false;
+  }
+
+  watches.emplace(fd, w);
+  return true;
+}
+
+bool application::unwatch_fd(int fd) {
+  std::unordered_map<int, fd_watchers::watch>& watches = fd_watchers::get_watches();
+  const auto it = watches.find(fd);
+  if (it == watches.end()) {
+    return false;
+  }
+
+  // The blocks keep the callback alive until they are released, even when called from it.
+  fd_watchers::release_source(it->second.read_source);
+  fd_watchers::release_source(it->second.write_source);
+  watches.erase(it);
+  return true;
+}
+
 std::string application::get_command_line_arguments() const {
   const std::vector<std::string>& args = m_native->m_args;
 
@@ -1567,5 +1985,502 @@ void post_message(std::shared_ptr<message> msg) {
   //    void dispatch_async_f(dispatch_queue_t queue, void *context, dispatch_function_t work);
 }
 
+// The main queue is drained by the host's run loop.
+// The main queue is drained by the host, there is nothing to report.
+pump_result pump(std::chrono::microseconds) { return pump_result(); }
+
+//
+// MARK: - timer -
+//
+
+class timer::native {
+public:
+  native(timer* t)
+      : m_timer(t) {}
+
+  ~native() { stop(); }
+
+  void start(std::uint32_t interval_ms) {
+    stop();
+
+    m_source = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, dispatch_get_main_queue());
+
+    const std::uint64_t interval = static_cast<std::uint64_t>(interval_ms) * NSEC_PER_MSEC;
+    dispatch_source_set_timer(m_source, dispatch_time(DISPATCH_TIME_NOW, static_cast<std::int64_t>(interval)),
+        interval, NSEC_PER_MSEC);
+
+    timer* t = m_timer;
+    dispatch_source_set_event_handler(m_source, ^{
+        t->on_timer();
+    });
+
+    dispatch_resume(m_source);
+  }
+
+  void stop() {
+    if (m_source) {
+      dispatch_source_cancel(m_source);
+      dispatch_release(m_source);
+      m_source = nullptr;
+    }
+  }
+
+  bool is_running() const { return m_source != nullptr; }
+
+  timer* m_timer;
+  dispatch_source_t m_source = nullptr;
+};
+
+timer::timer() { m_native = std::unique_ptr<native>(new native(this)); }
+
+timer::~timer() {}
+
+void timer::start(std::uint32_t interval_ms) { m_native->start(interval_ms); }
+
+void timer::stop() { m_native->stop(); }
+
+bool timer::is_running() const { return m_native->is_running(); }
+
+//
+// MARK: - headless -
+//
+
+namespace {
+  inline CGContextRef create_bitmap_context(pixel_buffer& buffer) {
+    CGColorSpaceRef color_space = CGColorSpaceCreateWithName(kCGColorSpaceSRGB);
+    CGContextRef ctx = CGBitmapContextCreate(buffer.data(), static_cast<std::size_t>(buffer.get_width()),
+        static_cast<std::size_t>(buffer.get_height()), 8,
+        static_cast<std::size_t>(buffer.get_stride()) * sizeof(pixel_buffer::pixel_type), color_space,
+        kCGImageAlphaPremultipliedLast | kCGBitmapByteOrder32Big);
+    CGColorSpaceRelease(color_space);
+    return ctx;
+  }
+
+  /// copies the buffer into an image of the given format.
+  /// @details bgra_premultiplied is the native format of the display, rgba is
+  ///          the one of png files. Both avoid a conversion by CoreGraphics.
+  inline CGImageRef create_image(const pixel_buffer& buffer, pixel_format format) {
+    const std::size_t bytes_per_row = static_cast<std::size_t>(buffer.get_width()) * sizeof(std::uint32_t);
+    const CFIndex byte_size = static_cast<CFIndex>(bytes_per_row * static_cast<std::size_t>(buffer.get_height()));
+
+    CFMutableDataRef data = CFDataCreateMutable(kCFAllocatorDefault, byte_size);
+    CFDataSetLength(data, byte_size);
+    export_pixels(buffer, CFDataGetMutableBytePtr(data), bytes_per_row, format);
+
+    CGDataProviderRef provider = CGDataProviderCreateWithCFData(data);
+    CFRelease(data);
+
+    CGBitmapInfo info = 0;
+    switch (format) {
+    case pixel_format::rgba_premultiplied:
+      info = kCGImageAlphaPremultipliedLast | kCGBitmapByteOrder32Big;
+      break;
+    case pixel_format::bgra_premultiplied:
+      info = kCGImageAlphaPremultipliedFirst | kCGBitmapByteOrder32Little;
+      break;
+    case pixel_format::rgba:
+      info = kCGImageAlphaLast | kCGBitmapByteOrder32Big;
+      break;
+    case pixel_format::bgra:
+      info = kCGImageAlphaFirst | kCGBitmapByteOrder32Little;
+      break;
+    }
+
+    CGColorSpaceRef color_space = CGColorSpaceCreateWithName(kCGColorSpaceSRGB);
+    CGImageRef image = CGImageCreate(static_cast<std::size_t>(buffer.get_width()),
+        static_cast<std::size_t>(buffer.get_height()), 8, 32, bytes_per_row, color_space, info, provider, nullptr,
+        false, kCGRenderingIntentDefault);
+
+    CGColorSpaceRelease(color_space);
+    CGDataProviderRelease(provider);
+    return image;
+  }
+
+  /// returns the format of 8 bit srgb images that can be imported without drawing them.
+  inline std::optional<pixel_format> get_importable_format(CGImageRef image) {
+    if (CGImageGetBitsPerComponent(image) != 8 || CGImageGetBitsPerPixel(image) != 32
+        || (CGImageGetBytesPerRow(image) % sizeof(std::uint32_t)) != 0) {
+      return std::nullopt;
+    }
+
+    CGColorSpaceRef color_space = CGImageGetColorSpace(image);
+    if (!color_space || CGColorSpaceGetModel(color_space) != kCGColorSpaceModelRGB) {
+      return std::nullopt;
+    }
+
+    CFStringRef name = CGColorSpaceCopyName(color_space);
+    const bool is_srgb = name && CFStringCompare(name, kCGColorSpaceSRGB, 0) == kCFCompareEqualTo;
+    if (name) {
+      CFRelease(name);
+    }
+
+    if (!is_srgb) {
+      return std::nullopt;
+    }
+
+    const CGBitmapInfo info = CGImageGetBitmapInfo(image);
+    const CGBitmapInfo byte_order = info & kCGBitmapByteOrderMask;
+    const bool big = byte_order == kCGBitmapByteOrderDefault || byte_order == kCGBitmapByteOrder32Big;
+    const bool little = byte_order == kCGBitmapByteOrder32Little;
+
+    if ((info & kCGBitmapFloatComponents) != 0) {
+      return std::nullopt;
+    }
+
+    switch (static_cast<CGImageAlphaInfo>(info & kCGBitmapAlphaInfoMask)) {
+    case kCGImageAlphaLast:
+      return big ? std::optional<pixel_format>(pixel_format::rgba) : std::nullopt;
+    case kCGImageAlphaPremultipliedLast:
+      return big ? std::optional<pixel_format>(pixel_format::rgba_premultiplied) : std::nullopt;
+    case kCGImageAlphaFirst:
+      return little ? std::optional<pixel_format>(pixel_format::bgra) : std::nullopt;
+    case kCGImageAlphaPremultipliedFirst:
+      return little ? std::optional<pixel_format>(pixel_format::bgra_premultiplied) : std::nullopt;
+    default:
+      return std::nullopt;
+    }
+  }
+} // namespace.
+
+void headless_surface::render_tree(view* root, pixel_buffer& buffer, const nano::rect<int>& dirty_rect, float scale,
+    std::unordered_map<const view*, view_draw_stats>* stats) {
+  if (buffer.empty()) {
+    return;
+  }
+
+  CGContextRef ctx = create_bitmap_context(buffer);
+
+  // Flip the context so that the origin is the top-left of the root view.
+  CGContextTranslateCTM(ctx, 0, static_cast<CGFloat>(buffer.get_height()));
+  CGContextScaleCTM(ctx, static_cast<CGFloat>(scale), static_cast<CGFloat>(-scale));
+
+  CGContextClipToRect(ctx, dirty_rect.convert<CGRect>());
+  CGContextClearRect(ctx, dirty_rect.convert<CGRect>());
+
+  view::pimpl::draw_tree(root, ctx, dirty_rect, 1.0f, stats);
+  CGContextRelease(ctx);
+}
+
+bool write_png(const pixel_buffer& buffer, const std::string& path) {
+  if (buffer.empty()) {
+    return false;
+  }
+
+  CFURLRef url = CFURLCreateFromFileSystemRepresentation(
+      kCFAllocatorDefault, reinterpret_cast<const UInt8*>(path.c_str()), static_cast<CFIndex>(path.size()), false);
+
+  if (!url) {
+    return false;
+  }
+
+  CGImageDestinationRef dst = CGImageDestinationCreateWithURL(url, CFSTR("public.png"), 1, nullptr);
+  CFRelease(url);
+
+  if (!dst) {
+    return false;
+  }
+
+  CGImageRef image = create_image(buffer, pixel_format::rgba);
+  CGImageDestinationAddImage(dst, image, nullptr);
+  const bool result = CGImageDestinationFinalize(dst);
+
+  CGImageRelease(image);
+  CFRelease(dst);
+  return result;
+}
+
+bool read_png(pixel_buffer& buffer, const std::string& path) {
+  CFURLRef url = CFURLCreateFromFileSystemRepresentation(
+      kCFAllocatorDefault, reinterpret_cast<const UInt8*>(path.c_str()), static_cast<CFIndex>(path.size()), false);
+
+  if (!url) {
+    return false;
+  }
+
+  CGImageSourceRef src = CGImageSourceCreateWithURL(url, nullptr);
+  CFRelease(url);
+
+  if (!src) {
+    return false;
+  }
+
+  CGImageRef image = CGImageSourceCreateImageAtIndex(src, 0, nullptr);
+  CFRelease(src);
+
+  if (!image) {
+    return false;
+  }
+
+  const std::size_t width = CGImageGetWidth(image);
+  const std::size_t height = CGImageGetHeight(image);
+
+  // Common 8 bit srgb images are converted directly, the others are drawn.
+  if (std::optional<pixel_format> format = get_importable_format(image)) {
+    if (CFDataRef data = CGDataProviderCopyData(CGImageGetDataProvider(image))) {
+      import_pixels(buffer, CFDataGetBytePtr(data), static_cast<int>(width), static_cast<int>(height),
+          CGImageGetBytesPerRow(image), *format);
+      CFRelease(data);
+      CGImageRelease(image);
+      return true;
+    }
+  }
+
+  buffer.resize(static_cast<int>(width), static_cast<int>(height));
+
+  CGContextRef ctx = create_bitmap_context(buffer);
+  CGContextSetBlendMode(ctx, kCGBlendModeCopy);
+  CGContextDrawImage(ctx, CGRectMake(0, 0, static_cast<CGFloat>(width), static_cast<CGFloat>(height)), image);
+
+  CGContextRelease(ctx);
+  CGImageRelease(image);
+  return true;
+}
+
+void draw_shadow(
+    nano::graphic_context& gc, const nano::rect<float>& rect, float corner_radius, const nano::shadow& s) {
+  draw_shadow_mask(reinterpret_cast<CGContextRef>(gc.get_handle()), rect, corner_radius, s, 1.0f);
+}
+
+void fill_path(nano::graphic_context& gc, const path_geometry& path, const nano::point<float>& offset,
+    const nano::color& c) {
+  CGContextRef ctx = reinterpret_cast<CGContextRef>(gc.get_handle());
+  const float scale = get_device_scale(ctx);
+
+  std::shared_ptr<const flattened_path> flat = path_cache::get_main().get(path, scale);
+  if (flat->contours.empty()) {
+    return;
+  }
+
+  // The contours are in pixels.
+  CGContextSaveGState(ctx);
+  CGContextTranslateCTM(ctx, static_cast<CGFloat>(offset.x), static_cast<CGFloat>(offset.y));
+  CGContextScaleCTM(ctx, static_cast<CGFloat>(1.0f / scale), static_cast<CGFloat>(1.0f / scale));
+  CGContextBeginPath(ctx);
+
+  std::vector<CGPoint> points;
+  for (const std::vector<nano::point<float>>& contour : flat->contours) {
+    points.resize(contour.size());
+    for (std::size_t i = 0; i < contour.size(); i++) {
+      points[i] = CGPointMake(static_cast<CGFloat>(contour[i].x), static_cast<CGFloat>(contour[i].y));
+    }
+
+    CGContextAddLines(ctx, points.data(), points.size());
+    CGContextClosePath(ctx);
+  }
+
+  CGContextSetRGBFillColor(ctx, static_cast<CGFloat>(c.red<float>()), static_cast<CGFloat>(c.green<float>()),
+      static_cast<CGFloat>(c.blue<float>()), static_cast<CGFloat>(c.alpha<float>()));
+  CGContextFillPath(ctx);
+  CGContextRestoreGState(ctx);
+}
+
+void draw_image(nano::graphic_context& gc, std::shared_ptr<const pixel_buffer> image, const nano::rect<int>& src_rect,
+    const nano::rect<float>& dst_rect) {
+  const nano::rect<int> src = get_intersection(src_rect, image->get_bounds());
+  if (is_empty(src)) {
+    return;
+  }
+
+  CGContextRef ctx = reinterpret_cast<CGContextRef>(gc.get_handle());
+  const std::size_t bytes_per_row = static_cast<std::size_t>(image->get_stride()) * sizeof(std::uint32_t);
+  const std::uint32_t* pixels = image->row(src.y) + src.x;
+  const std::size_t byte_size = bytes_per_row * static_cast<std::size_t>(src.height - 1)
+      + static_cast<std::size_t>(src.width) * sizeof(std::uint32_t);
+
+  // The image is drawn from the memory of the buffer, which the provider keeps alive.
+  auto* holder = new std::shared_ptr<const pixel_buffer>(std::move(image));
+  CGDataProviderRef provider = CGDataProviderCreateWithData(holder, pixels, byte_size,
+      [](void* info, const void*, std::size_t) { delete static_cast<std::shared_ptr<const pixel_buffer>*>(info); });
+
+  CGColorSpaceRef color_space = CGColorSpaceCreateWithName(kCGColorSpaceSRGB);
+  CGImageRef cg_image = CGImageCreate(static_cast<std::size_t>(src.width), static_cast<std::size_t>(src.height), 8,
+      32, bytes_per_row, color_space, kCGImageAlphaPremultipliedLast | kCGBitmapByteOrder32Big, provider, nullptr,
+      false, kCGRenderingIntentDefault);
+  CGColorSpaceRelease(color_space);
+  CGDataProviderRelease(provider);
+
+  const CGRect dst = CGRectMake(static_cast<CGFloat>(dst_rect.x), static_cast<CGFloat>(dst_rect.y),
+      static_cast<CGFloat>(dst_rect.width), static_cast<CGFloat>(dst_rect.height));
+
+  CGContextSaveGState(ctx);
+
+  // Images are drawn bottom up, flipped contexts draw them upside down.
+  if (CGContextGetCTM(ctx).d < 0) {
+    CGContextTranslateCTM(ctx, 0, dst.origin.y * 2 + dst.size.height);
+    CGContextScaleCTM(ctx, 1, -1);
+  }
+
+  CGContextSetInterpolationQuality(ctx, kCGInterpolationLow);
+  CGContextDrawImage(ctx, dst, cg_image);
+  CGContextRestoreGState(ctx);
+  CGImageRelease(cg_image);
+}
+
+void draw_sprite(nano::graphic_context& gc, const sprite_asset& asset, int frame, const nano::rect<float>& rect) {
+  CGContextRef ctx = reinterpret_cast<CGContextRef>(gc.get_handle());
+  const float scale = get_device_scale(ctx);
+
+  std::shared_ptr<const sprite_sheet> sheet = sprite_cache::get_main().get(asset, scale);
+
+  if (frame < 0 || frame >= static_cast<int>(sheet->frames.size())) {
+    return;
+  }
+
+  // The frame shares the ownership of its sheet.
+  const pixel_buffer& pixels = sheet->frames[static_cast<std::size_t>(frame)];
+  draw_image(gc, std::shared_ptr<const pixel_buffer>(sheet, &pixels), pixels.get_bounds(), rect);
+}
+
+//
+// MARK: - compositor -
+//
+
+/// display lists are recorded as a single pdf page.
+class display_list::native {
+public:
+  native(CFDataRef data)
+      : m_data(data) {}
+
+  ~native() {
+    if (m_document) {
+      CGPDFDocumentRelease(m_document);
+    }
+
+    CFRelease(m_data);
+  }
+
+  /// only called from the compositor thread.
+  CGPDFPageRef get_page() {
+    if (!m_document) {
+      CGDataProviderRef provider = CGDataProviderCreateWithCFData(m_data);
+      m_document = CGPDFDocumentCreateWithProvider(provider);
+      CGDataProviderRelease(provider);
+    }
+
+    return m_document ? CGPDFDocumentGetPage(m_document, 1) : nullptr;
+  }
+
+  CFDataRef m_data;
+  CGPDFDocumentRef m_document = nullptr;
+};
+
+display_list::display_list(std::unique_ptr<native> n, const nano::size<int>& size)
+    : m_native(std::move(n))
+    , m_size(size) {}
+
+display_list::~display_list() {}
+
+std::size_t display_list::get_byte_size() const noexcept {
+  return static_cast<std::size_t>(CFDataGetLength(m_native->m_data));
+}
+
+bool compositor::can_draw() noexcept { return true; }
+
+void compositor::attach(view* root, compositor* c) {
+  root->m_pimpl->m_compositor = c;
+
+  // The view draws itself again once detached.
+  if (!c) {
+    root->m_pimpl->redraw();
+  }
+}
+
+std::shared_ptr<const display_list> compositor::record(view* v, float scale) {
+  const nano::size<int> size = v->get_frame().size;
+  const CGRect media_box = CGRectMake(0, 0, static_cast<CGFloat>(size.width), static_cast<CGFloat>(size.height));
+
+  CFMutableDataRef data = CFDataCreateMutable(kCFAllocatorDefault, 0);
+  CGDataConsumerRef consumer = CGDataConsumerCreateWithCFData(data);
+  CGContextRef ctx = CGPDFContextCreate(consumer, &media_box, nullptr);
+  CGDataConsumerRelease(consumer);
+
+  CGPDFContextBeginPage(ctx, nullptr);
+  CGContextTranslateCTM(ctx, 0, static_cast<CGFloat>(size.height));
+  CGContextScaleCTM(ctx, 1, -1);
+
+  recording_context = ctx;
+  recording_scale = scale;
+
+  v->on_will_draw();
+  nano::graphic_context gc(reinterpret_cast<nano::graphic_context::handle>(ctx));
+  v->on_draw(gc, nano::rect<float>(0.0f, 0.0f, static_cast<float>(size.width), static_cast<float>(size.height)));
+  view::pimpl::draw_subview_shadows(v, ctx);
+
+  recording_context = nullptr;
+
+  CGPDFContextEndPage(ctx);
+  CGPDFContextClose(ctx);
+  CGContextRelease(ctx);
+
+  return std::make_shared<const display_list>(
+      std::unique_ptr<display_list::native>(new display_list::native(data)), size);
+}
+
+void compositor::draw(const display_list& list, pixel_buffer& buffer, const nano::rect<int>& frame,
+    const nano::rect<int>& clip, float opacity, float scale) {
+  CGPDFPageRef page = list.m_native->get_page();
+
+  if (!page) {
+    return;
+  }
+
+  const CGFloat s = static_cast<CGFloat>(scale);
+  const CGFloat buffer_height = static_cast<CGFloat>(buffer.get_height());
+
+  CGContextRef ctx = create_bitmap_context(buffer);
+
+  // The bitmap context origin is bottom-left, clip and frame are top-left based.
+  CGContextClipToRect(ctx,
+      CGRectMake(clip.x * s, buffer_height - (clip.y + clip.height) * s, clip.width * s, clip.height * s));
+  CGContextSetAlpha(ctx, static_cast<CGFloat>(opacity));
+  CGContextTranslateCTM(ctx, frame.x * s, buffer_height - (frame.y + frame.height) * s);
+  CGContextScaleCTM(ctx, s, s);
+  CGContextDrawPDFPage(ctx, page);
+
+  CGContextRelease(ctx);
+}
+
+namespace {
+  /// presents the compositor frames as the contents of the view's layer.
+  class native_layer_presenter : public compositor::presenter {
+  public:
+    native_layer_presenter(view* root, float scale)
+        : m_obj(reinterpret_cast<objc::obj_t*>(root->get_native_handle())) {
+      CFRetain(m_obj);
+
+      // NSViewLayerContentsRedrawNever = 0
+      objc::call<void, bool>(m_obj, "setWantsLayer:", true);
+      objc::call<void, long>(m_obj, "setLayerContentsRedrawPolicy:", 0);
+
+      objc::obj_t* layer = objc::call<objc::obj_t*>(m_obj, "layer");
+      objc::call<void, CGFloat>(layer, "setContentsScale:", static_cast<CGFloat>(scale));
+    }
+
+    ~native_layer_presenter() override { CFRelease(m_obj); }
+
+    void present(const pixel_buffer& frame, [[maybe_unused]] const region& damage) override {
+      CGImageRef image = create_image(frame, pixel_format::bgra_premultiplied);
+      objc::obj_t* obj = m_obj;
+      CFRetain(obj);
+
+      dispatch_async(dispatch_get_main_queue(), ^{
+          objc::obj_t* layer = objc::call<objc::obj_t*>(obj, "layer");
+          objc::call<void, CGImageRef>(layer, "setContents:", image);
+          CGImageRelease(image);
+          CFRelease(obj);
+      });
+    }
+
+  private:
+    objc::obj_t* m_obj;
+  };
+} // namespace.
+
+std::unique_ptr<compositor::presenter> compositor::create_native_presenter(view* root, float scale) {
+  return std::unique_ptr<presenter>(new native_layer_presenter(root, scale));
+}
+
 } // namespace nano.
 NANO_CLANG_DIAGNOSTIC_POP()
+
+#endif
@@ -25,7 +25,9 @@
 
 #include <array>
 #include <cassert>
+#include <chrono>
 #include <cstdlib>
+#include <functional>
 #include <iomanip>
 #include <iterator>
 #include <mutex>
@@ -49,11 +51,13 @@ namespace nano {
 /// Native view handle.
 /// NSView* on mac.
 /// HWND on windows.
+/// Window on linux (x11), only for windows and embedded views.
 typedef struct native_view_handle_type* native_view_handle;
 
 /// Native window handle.
 /// NSWindow* on mac.
 /// HWND on windows.
+/// Window on linux (x11).
 typedef struct native_window_handle_type* native_window_handle;
 
 /// Native display handle.
@@ -62,6 +66,7 @@ typedef struct native_display_handle_type* native_display_handle;
 /// Native event handle.
 /// NSEvent* on mac.
 /// nullptr on windows.
+/// XEvent* on linux (x11).
 typedef struct native_event_handle_type* native_event_handle;
 
 /// Native menu handle.
@@ -70,6 +75,9 @@ typedef struct native_menu_handle_type* native_menu_handle;
 ///
 class view;
 
+class compositor;
+class headless_surface;
+
 ///
 enum class window_flags {
   border_less = 0,
@@ -89,6 +97,16 @@ enum class view_flags { none = 0, auto_resize = 1 << 0, default_flags = none };
 
 NANO_ENUM_CLASS_FLAGS(view_flags)
 
+/// drop shadow of a view or shape.
+struct shadow {
+  nano::color color = 0x00000080;
+
+  /// standard deviation of the blur, in points.
+  float blur = 8.0f;
+
+  nano::point<float> offset = { 0.0f, 2.0f };
+};
+
 enum class event_type : std::uint64_t {
   none,
 
@@ -325,6 +343,9 @@ public:
   /// create view from platform native view.
   view(native_view_handle parent, const nano::rect<int>& rect, view_flags flags = view_flags::default_flags);
 
+  /// creates a detached root view (e.g. for headless rendering).
+  view(const nano::rect<int>& rect);
+
   virtual ~view();
 
   native_view_handle get_native_handle() const;
@@ -365,6 +386,16 @@ public:
   inline void set_visible(bool visible);
   inline bool is_visible() const;
 
+  /// sets the opacity of the view, from 0 (transparent) to 1 (opaque).
+  void set_opacity(float opacity);
+  float get_opacity() const;
+
+  /// sets a drop shadow with the shape of the view's rounded bounds.
+  /// @details the shadow is drawn by the parent view, under its subviews.
+  void set_shadow(const nano::shadow& s, float corner_radius = 0.0f);
+  void remove_shadow();
+  bool has_shadow() const;
+
   bool is_focused() const;
   void focus();
   void unfocus();
@@ -379,6 +410,8 @@ public:
 
   view* get_parent() const;
 
+  const std::vector<view*>& get_children() const;
+
   // MARK: painting
 
   /// marks the viewr’s entire bounds rectangle as needing to be redrawn.
@@ -395,6 +428,21 @@ public:
   /// display, increasing the view’s existing invalid region to include it.
   void redraw(const nano::rect<int>& rect);
 
+  /// moves what is already drawn within the rectangle by delta and marks only
+  /// the area left uncovered as needing to be redrawn.
+  ///
+  /// @details everything drawn over the rectangle moves, including subviews and
+  ///          siblings. the pixels are only moved when a compositor is attached,
+  ///          otherwise the whole rectangle is redrawn.
+  void scroll_rect(const nano::rect<int>& rect, const nano::point<int>& delta);
+
+  /// returns true while the window of the view is being resized interactively.
+  ///
+  /// @details views can check it in on_draw() and on_frame_changed() to use a
+  ///          cheaper draw or layout path. everything is redrawn once the
+  ///          resize ends.
+  bool is_in_live_resize() const;
+
   //  bool set_responder(responder* d);
 
   ///
@@ -413,6 +461,10 @@ protected:
 
   virtual void on_frame_changed() {}
 
+  /// called on every view of the window when a live resize starts and ends.
+  virtual void on_will_start_live_resize() {}
+  virtual void on_did_end_live_resize() {}
+
   virtual void on_show() {}
   virtual void on_hide() {}
 
@@ -457,6 +509,8 @@ private:
   void initialize();
 
   friend class window_proxy;
+  friend class compositor;
+  friend class headless_surface;
   friend nano::rect<int> get_native_view_bounds(nano::native_view_handle);
 };
 
@@ -490,6 +544,29 @@ private:
   native* m_native;
 };
 
+/// repeating timer called on the main thread.
+class timer {
+public:
+  class native;
+
+  timer();
+
+  virtual ~timer();
+
+  /// starts (or restarts) the timer with the given interval in milliseconds.
+  void start(std::uint32_t interval_ms);
+
+  void stop();
+
+  bool is_running() const;
+
+protected:
+  virtual void on_timer() = 0;
+
+private:
+  std::unique_ptr<native> m_native;
+};
+
 #ifdef WIN32
   #define NANO_APPLICATION_MAIN_ARGS 0, nullptr
   #define UIApplicationMain()                                                                                          \
@@ -499,6 +576,19 @@ private:
   #define UIApplicationMain() main(int argc, const char* argv[])
 #endif
 
+/// readiness of a watched file descriptor.
+enum class fd_events {
+  none = 0,
+  readable = 1 << 0,
+  writable = 1 << 1,
+  /// the peer closed the connection, only reported.
+  hang_up = 1 << 2,
+  /// only reported.
+  error = 1 << 3
+};
+
+NANO_ENUM_CLASS_FLAGS(fd_events)
+
 class application {
 public:
   class native;
@@ -531,6 +621,29 @@ public:
   ///          shutdown() method will be called, and the app will exit
   static void quit();
 
+  /// called on the main thread when a watched file descriptor becomes ready.
+  using fd_callback = std::function<void(int fd, fd_events events)>;
+
+  /// watches a file descriptor (e.g. a socket or a pipe to another process)
+  /// from the main loop, its callback is dispatched alongside the posted messages.
+  ///
+  /// @details the callback is called when the descriptor becomes ready and
+  ///          should read (or write) until EAGAIN. on linux the watch is
+  ///          edge-triggered and it isn't called again for data that was already
+  ///          there. on macos it is level-triggered and it is called again for as
+  ///          long as the descriptor stays ready, so a callback may find nothing
+  ///          to do. the descriptor should be non-blocking and is still owned by
+  ///          the caller, it must be unwatched before being closed.
+  ///
+  ///          must be called on the main thread.
+  ///
+  /// @param events readable and/or writable, hang_up and error are always reported.
+  /// @returns false if the descriptor can't be watched or already is.
+  static bool watch_fd(int fd, fd_events events, fd_callback callback);
+
+  /// stops watching a file descriptor, it can be called from its callback.
+  static bool unwatch_fd(int fd);
+
   /// returns the application's command line arguments as a single string.
   std::string get_command_line_arguments() const;
 
@@ -742,6 +855,35 @@ inline void post_message(Fct&& fct) {
   post_message(std::shared_ptr<message>(new callback(std::forward<Fct>(fct))));
 }
 
+/// the work left after pump().
+struct pump_result {
+  /// the number of messages, timers and file descriptor callbacks dispatched.
+  std::size_t dispatched = 0;
+
+  /// the posted messages left in the queue, either posted during the pump or not reached within the budget.
+  std::size_t pending_messages = 0;
+
+  /// milliseconds until the next timer is due, -1 without timers.
+  int next_timer_ms = -1;
+
+  inline bool has_pending_work() const noexcept { return pending_messages != 0 || next_timer_ms == 0; }
+};
+
+/// processes the main loop's work when there is no application::run(), e.g.
+/// when embedded in a plugin host through view(native_view_handle, ...).
+///
+/// @details meant to be called from the host's idle or timer callback. the
+///          due timers and ready file descriptors are dispatched first, then
+///          the posted messages in order until the budget is spent (at least
+///          one is always dispatched). the messages posted meanwhile wait for
+///          the next pump, since the compositor commits through a posted message
+///          and coalesces its invalidations, this is at most one frame per pump.
+///
+///          on macos the host's run loop already drains the main queue and
+///          nothing is done: the result is always empty and says nothing about
+///          the work left, has_pending_work() is false even with messages queued.
+pump_result pump(std::chrono::microseconds time_budget);
+
 } // namespace nano
 
 NANO_CLANG_DIAGNOSTIC_POP()
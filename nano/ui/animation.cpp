@@ -0,0 +1,429 @@
+/*
+ * Nano Library
+ *
+ * Copyright (C) 2022, Meta-Sonic
+ * All rights reserved.
+ *
+ * Proprietary and confidential.
+ * Any unauthorized copying, alteration, distribution, transmission, performance,
+ * display or other use of this material is strictly prohibited.
+ *
+ * Written by Alexandre Arsenault <alx.arsenault@gmail.com>
+ */
+
+#include <nano/ui/animation.h>
+
+#include <algorithm>
+#include <cmath>
+
+NANO_CLANG_DIAGNOSTIC_PUSH()
+NANO_CLANG_DIAGNOSTIC(warning, "-Weverything")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wc++98-compat")
+
+namespace nano {
+
+namespace {
+  /// cubic coefficients (a, b, c) of each easing curve.
+  constexpr float easing_coefficients[][3] = {
+    { 0.0f, 0.0f, 1.0f }, // linear
+    { 0.0f, 1.0f, 0.0f }, // ease_in
+    { 0.0f, -1.0f, 2.0f }, // ease_out
+    { -2.0f, 3.0f, 0.0f }, // ease_in_out
+    { 1.0f, 0.0f, 0.0f }, // ease_in_cubic
+    { 1.0f, -3.0f, 3.0f }, // ease_out_cubic
+    { 2.70158f, -6.40316f, 4.70158f } // ease_out_back
+  };
+
+  /// springs are integrated with semi-implicit euler, larger steps are clamped
+  /// to keep the integration stable after a stall.
+  constexpr double max_time_step = 1.0 / 30.0;
+
+  constexpr float rest_threshold = 1e-3f;
+
+  /// single branchless pass over every lane, both the tween and the spring are
+  /// evaluated and blended with the is_spring mask so that the loop vectorizes.
+  void update_lanes(std::size_t count, float dt, const float* __restrict from, const float* __restrict to,
+      const float* __restrict inv_duration, const float* __restrict ca, const float* __restrict cb,
+      const float* __restrict cc, const float* __restrict stiffness, const float* __restrict damping,
+      const float* __restrict is_spring, float* __restrict time, float* __restrict value, float* __restrict velocity,
+      float* __restrict done) {
+    for (std::size_t i = 0; i < count; i++) {
+      const float t = time[i] + dt;
+      const float p = std::min(t * inv_duration[i], 1.0f);
+      const float eased = ((ca[i] * p + cb[i]) * p + cc[i]) * p;
+      const float tween = from[i] + (to[i] - from[i]) * eased;
+
+      const float displacement = value[i] - to[i];
+      const float v = velocity[i] + (-stiffness[i] * displacement - damping[i] * velocity[i]) * dt;
+      const float x = value[i] + v * dt;
+
+      const float s = is_spring[i];
+      const float tween_done = p >= 1.0f ? 1.0f : 0.0f;
+      const float spring_done = std::max(std::abs(x - to[i]), std::abs(v)) < rest_threshold ? 1.0f : 0.0f;
+
+      time[i] = t;
+      velocity[i] = v * s;
+      value[i] = tween + (x - tween) * s;
+      done[i] = tween_done + (spring_done - tween_done) * s;
+    }
+  }
+
+  inline nano::rect<int> get_frame_from_lanes(const float* values) {
+    return nano::rect<int>(static_cast<int>(std::lround(values[0])), static_cast<int>(std::lround(values[1])),
+        static_cast<int>(std::lround(values[2])), static_cast<int>(std::lround(values[3])));
+  }
+} // namespace.
+
+animator::animator() {}
+
+animator::~animator() {}
+
+animator& animator::get_main() {
+  NANO_CLANG_PUSH_WARNING("-Wexit-time-destructors")
+  static animator main_animator;
+  NANO_CLANG_POP_WARNING()
+  return main_animator;
+}
+
+animator::id_type animator::animate_frame(view* v, const nano::rect<int>& to, double duration, easing e) {
+  const nano::rect<int> frame = v->get_frame();
+  const lane_desc lanes[4] = {
+    { static_cast<float>(frame.x), static_cast<float>(to.x), 0.0f },
+    { static_cast<float>(frame.y), static_cast<float>(to.y), 0.0f },
+    { static_cast<float>(frame.width), static_cast<float>(to.width), 0.0f },
+    { static_cast<float>(frame.height), static_cast<float>(to.height), 0.0f },
+  };
+
+  return add(target_type::frame, v, nullptr, lanes, 4, duration, e, nullptr);
+}
+
+animator::id_type animator::animate_frame(view* v, const nano::rect<int>& to, const spring& s) {
+  const nano::rect<int> frame = v->get_frame();
+  const lane_desc lanes[4] = {
+    { static_cast<float>(frame.x), static_cast<float>(to.x), 0.0f },
+    { static_cast<float>(frame.y), static_cast<float>(to.y), 0.0f },
+    { static_cast<float>(frame.width), static_cast<float>(to.width), 0.0f },
+    { static_cast<float>(frame.height), static_cast<float>(to.height), 0.0f },
+  };
+
+  return add(target_type::frame, v, nullptr, lanes, 4, 0.0, easing::linear, &s);
+}
+
+animator::id_type animator::animate_opacity(view* v, float to, double duration, easing e) {
+  const lane_desc desc = { v->get_opacity(), to, 0.0f };
+  return add(target_type::opacity, v, nullptr, &desc, 1, duration, e, nullptr);
+}
+
+animator::id_type animator::animate_opacity(view* v, float to, const spring& s) {
+  const lane_desc desc = { v->get_opacity(), to, 0.0f };
+  return add(target_type::opacity, v, nullptr, &desc, 1, 0.0, easing::linear, &s);
+}
+
+animator::id_type animator::animate_float(float* value, float to, double duration, easing e, view* owner) {
+  const lane_desc desc = { *value, to, 0.0f };
+  return add(target_type::value, owner, value, &desc, 1, duration, e, nullptr);
+}
+
+animator::id_type animator::animate_float(float* value, float to, const spring& s, view* owner) {
+  const lane_desc desc = { *value, to, 0.0f };
+  return add(target_type::value, owner, value, &desc, 1, 0.0, easing::linear, &s);
+}
+
+animator::id_type animator::add(target_type type, view* v, float* value, const lane_desc* lanes, std::uint32_t count,
+    double duration, easing e, const spring* s) {
+  const std::uintptr_t key = type == target_type::value ? make_key(type, value) : make_key(type, v);
+
+  reserve_lanes(count);
+
+  const std::size_t first = m_lane_count;
+  m_lane_count += count;
+
+  const float* coefs = easing_coefficients[static_cast<std::size_t>(e)];
+  const float inv_duration = duration > 0.0 ? static_cast<float>(1.0 / duration) : 1e30f;
+
+  for (std::uint32_t i = 0; i < count; i++) {
+    const std::size_t k = first + i;
+    lane(f_from)[k] = lanes[i].from;
+    lane(f_to)[k] = lanes[i].to;
+    lane(f_value)[k] = lanes[i].from;
+    lane(f_velocity)[k] = lanes[i].velocity;
+    lane(f_time)[k] = 0.0f;
+    lane(f_inv_duration)[k] = s ? 0.0f : inv_duration;
+    lane(f_a)[k] = coefs[0];
+    lane(f_b)[k] = coefs[1];
+    lane(f_c)[k] = coefs[2];
+    lane(f_stiffness)[k] = s ? s->stiffness / s->mass : 0.0f;
+    lane(f_damping)[k] = s ? s->damping / s->mass : 0.0f;
+    lane(f_is_spring)[k] = s ? 1.0f : 0.0f;
+    lane(f_done)[k] = 0.0f;
+  }
+
+  // Retarget from the current value and velocity of the running animation.
+  if (auto it = m_index.find(key); it != m_index.end()) {
+    const animation& prev = m_animations[it->second];
+
+    for (std::uint32_t i = 0; i < std::min(count, prev.lane_count); i++) {
+      const std::size_t k = first + i;
+      lane(f_from)[k] = lane(f_value)[prev.first_lane + i];
+      lane(f_value)[k] = lane(f_from)[k];
+      lane(f_velocity)[k] = s ? lane(f_velocity)[prev.first_lane + i] : 0.0f;
+    }
+
+    kill(it->second);
+  }
+
+  const id_type id = m_next_id++;
+  if (m_next_id == invalid_id) {
+    m_next_id = 1;
+  }
+
+  const nano::rect<int> applied_frame
+      = type == target_type::frame ? get_frame_from_lanes(lane(f_from) + first) : nano::rect<int>();
+
+  m_index[key] = static_cast<std::uint32_t>(m_animations.size());
+  m_animations.push_back(animation{ id, type, v, value, static_cast<std::uint32_t>(first), count, applied_frame });
+
+  start_timer();
+  return id;
+}
+
+void animator::cancel(id_type id) {
+  for (std::size_t i = 0; i < m_animations.size(); i++) {
+    if (m_animations[i].id == id) {
+      kill(i);
+      return;
+    }
+  }
+}
+
+void animator::cancel(view* v) {
+  for (std::size_t i = 0; i < m_animations.size(); i++) {
+    if (m_animations[i].id != invalid_id && m_animations[i].target_view == v) {
+      kill(i);
+    }
+  }
+
+  m_dirty.erase(std::remove_if(m_dirty.begin(), m_dirty.end(),
+                    [v](const dirty_region& r) { return r.target_view == v; }),
+      m_dirty.end());
+}
+
+void animator::cancel_all() {
+  m_animations.clear();
+  m_index.clear();
+  m_dirty.clear();
+  m_lane_count = 0;
+  m_has_dead = false;
+  timer::stop();
+}
+
+bool animator::is_running(id_type id) const {
+  return id != invalid_id
+      && std::find_if(m_animations.begin(), m_animations.end(), [id](const animation& a) { return a.id == id; })
+      != m_animations.end();
+}
+
+void animator::set_frame_interval(std::uint32_t interval_ms) {
+  m_frame_interval = interval_ms;
+
+  if (timer::is_running()) {
+    timer::start(m_frame_interval);
+  }
+}
+
+bool animator::update(double dt) {
+  if (m_has_dead) {
+    compact();
+  }
+
+  if (m_animations.empty()) {
+    return false;
+  }
+
+  const float fdt = static_cast<float>(std::min(dt, max_time_step));
+
+  update_lanes(m_lane_count, fdt, lane(f_from), lane(f_to), lane(f_inv_duration), lane(f_a), lane(f_b), lane(f_c),
+      lane(f_stiffness), lane(f_damping), lane(f_is_spring), lane(f_time), lane(f_value), lane(f_velocity),
+      lane(f_done));
+
+  // Setting a frame or an opacity can reenter the animator (e.g. an animation
+  // started from on_frame_changed()) and reallocate the animations and the
+  // lanes. Only the animations of this pass are applied, fetched by index.
+  const std::size_t count = m_animations.size();
+
+  for (std::size_t i = 0; i < std::min(count, m_animations.size()); i++) {
+    const animation a = m_animations[i];
+    if (a.id == invalid_id) {
+      continue;
+    }
+
+    float* values = lane(f_value) + a.first_lane;
+    const float* done = lane(f_done) + a.first_lane;
+
+    bool finished = true;
+    for (std::uint32_t k = 0; k < a.lane_count; k++) {
+      finished = finished && done[k] != 0.0f;
+    }
+
+    if (finished) {
+      std::copy_n(lane(f_to) + a.first_lane, a.lane_count, values);
+    }
+
+    switch (a.type) {
+    case target_type::frame: {
+      const nano::rect<int> frame = get_frame_from_lanes(values);
+
+      if (frame != a.applied_frame) {
+        m_animations[i].applied_frame = frame;
+        a.target_view->set_frame(frame);
+
+        if (view* parent = a.target_view->get_parent()) {
+          add_dirty(parent, get_union(a.applied_frame, frame));
+        }
+        else {
+          add_dirty(a.target_view);
+        }
+      }
+    } break;
+
+    case target_type::opacity:
+      a.target_view->set_opacity(values[0]);
+      add_dirty(a.target_view);
+      break;
+
+    case target_type::value:
+      *a.target_value = values[0];
+
+      if (a.target_view) {
+        add_dirty(a.target_view);
+      }
+      break;
+    }
+
+    // Unless it was cancelled or retargeted meanwhile.
+    if (finished && i < m_animations.size() && m_animations[i].id == a.id) {
+      kill(i);
+    }
+  }
+
+  flush_dirty();
+
+  if (m_has_dead) {
+    compact();
+  }
+
+  return !m_animations.empty();
+}
+
+void animator::reserve_lanes(std::size_t count) {
+  const std::size_t needed = m_lane_count + count;
+  if (needed <= m_capacity) {
+    return;
+  }
+
+  const std::size_t capacity = std::max<std::size_t>({ 64, m_capacity * 2, needed });
+  std::vector<float> storage(capacity * field_count, 0.0f);
+
+  for (std::size_t f = 0; f < field_count; f++) {
+    std::copy_n(m_storage.data() + f * m_capacity, m_lane_count, storage.data() + f * capacity);
+  }
+
+  m_storage = std::move(storage);
+  m_capacity = capacity;
+}
+
+void animator::kill(std::size_t index) {
+  animation& a = m_animations[index];
+
+  if (auto it = m_index.find(make_key(a)); it != m_index.end() && it->second == index) {
+    m_index.erase(it);
+  }
+
+  a.id = invalid_id;
+  m_has_dead = true;
+}
+
+void animator::compact() {
+  std::size_t write_index = 0;
+  std::uint32_t write_lane = 0;
+
+  for (std::size_t i = 0; i < m_animations.size(); i++) {
+    animation a = m_animations[i];
+
+    if (a.id == invalid_id) {
+      continue;
+    }
+
+    if (a.first_lane != write_lane) {
+      for (std::size_t f = 0; f < field_count; f++) {
+        float* data = lane(static_cast<field>(f));
+        std::copy_n(data + a.first_lane, a.lane_count, data + write_lane);
+      }
+
+      a.first_lane = write_lane;
+    }
+
+    if (write_index != i) {
+      m_index[make_key(a)] = static_cast<std::uint32_t>(write_index);
+    }
+
+    write_lane += a.lane_count;
+    m_animations[write_index++] = a;
+  }
+
+  m_animations.resize(write_index);
+  m_lane_count = write_lane;
+  m_has_dead = false;
+}
+
+void animator::add_dirty(view* v) { m_dirty.push_back(dirty_region{ v, nano::rect<int>(), true }); }
+
+void animator::add_dirty(view* v, const nano::rect<int>& rect) { m_dirty.push_back(dirty_region{ v, rect, false }); }
+
+void animator::flush_dirty() {
+  if (m_dirty.empty()) {
+    return;
+  }
+
+  std::sort(m_dirty.begin(), m_dirty.end(), [](const dirty_region& a, const dirty_region& b) {
+    return std::less<view*>()(a.target_view, b.target_view);
+  });
+
+  for (std::size_t i = 0; i < m_dirty.size();) {
+    dirty_region entry = m_dirty[i++];
+
+    for (; i < m_dirty.size() && m_dirty[i].target_view == entry.target_view; i++) {
+      entry.full = entry.full || m_dirty[i].full;
+      entry.rect = entry.full ? entry.rect : get_union(entry.rect, m_dirty[i].rect);
+    }
+
+    if (entry.full) {
+      entry.target_view->redraw();
+    }
+    else {
+      entry.target_view->redraw(entry.rect);
+    }
+  }
+
+  m_dirty.clear();
+}
+
+void animator::start_timer() {
+  if (!timer::is_running()) {
+    m_last_time = std::chrono::steady_clock::now();
+    timer::start(m_frame_interval);
+  }
+}
+
+void animator::on_timer() {
+  const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+  const double dt = std::chrono::duration<double>(now - m_last_time).count();
+  m_last_time = now;
+
+  if (!update(dt)) {
+    timer::stop();
+  }
+}
+} // namespace nano.
+
+NANO_CLANG_DIAGNOSTIC_POP()
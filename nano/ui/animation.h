@@ -0,0 +1,204 @@
+/*
+ * Nano Library
+ *
+ * Copyright (C) 2022, Meta-Sonic
+ * All rights reserved.
+ *
+ * Proprietary and confidential.
+ * Any unauthorized copying, alteration, distribution, transmission, performance,
+ * display or other use of this material is strictly prohibited.
+ *
+ * Written by Alexandre Arsenault <alx.arsenault@gmail.com>
+ */
+
+#pragma once
+
+/*!
+ * @file      nano/ui/animation.h
+ * @brief     nano ui animation
+ * @copyright Copyright (C) 2022, Meta-Sonic
+ * @author    Alexandre Arsenault alx.arsenault@gmail.com
+ * @date      Created 16/06/2022
+ */
+
+#include <nano/ui.h>
+#include <nano/ui/region.h>
+
+#include <chrono>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+NANO_CLANG_DIAGNOSTIC_PUSH()
+NANO_CLANG_DIAGNOSTIC(warning, "-Weverything")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wc++98-compat")
+
+namespace nano {
+
+/// easing curve of a tween animation.
+///
+/// @details every curve is stored as the coefficients of a cubic polynomial
+///          (a.t^3 + b.t^2 + c.t) so that all the animations can be evaluated
+///          in the same branchless loop.
+enum class easing : std::uint8_t {
+  linear,
+  ease_in,
+  ease_out,
+  ease_in_out,
+  ease_in_cubic,
+  ease_out_cubic,
+  ease_out_back
+};
+
+/// damped spring parameters.
+struct spring {
+  float stiffness = 170.0f;
+  float damping = 26.0f;
+  float mass = 1.0f;
+};
+
+/// animates view frames, view opacities and custom float properties.
+///
+/// @details all the running animations are stored in a single contiguous
+///          block of memory laid out as a structure of arrays (one float lane
+///          per animated scalar). every frame, update() evaluates all the lanes
+///          in one vectorizable pass, writes the values back to their targets
+///          and then issues a single redraw per invalidated view.
+///
+///          starting a new animation on a property that is already animated
+///          retargets it from its current value (and velocity for springs).
+///
+///          a view must not be destroyed while it is animated, call cancel(view*)
+///          from its destructor when in doubt.
+class animator : private timer {
+public:
+  using id_type = std::uint32_t;
+
+  static constexpr id_type invalid_id = 0;
+
+  animator();
+
+  ~animator() override;
+
+  /// returns the animator driven by the main thread frame timer.
+  static animator& get_main();
+
+  id_type animate_frame(view* v, const nano::rect<int>& to, double duration, easing e = easing::ease_in_out);
+  id_type animate_frame(view* v, const nano::rect<int>& to, const spring& s);
+
+  id_type animate_opacity(view* v, float to, double duration, easing e = easing::ease_in_out);
+  id_type animate_opacity(view* v, float to, const spring& s);
+
+  /// animates a custom float property.
+  /// @param owner the view redrawn every time the value changes, can be null.
+  id_type animate_float(float* value, float to, double duration, easing e = easing::linear, view* owner = nullptr);
+  id_type animate_float(float* value, float to, const spring& s, view* owner = nullptr);
+
+  /// stops an animation, the property keeps its current value.
+  void cancel(id_type id);
+
+  /// stops every animation targeting or owned by the view.
+  void cancel(view* v);
+
+  void cancel_all();
+
+  bool is_running(id_type id) const;
+
+  /// returns the number of running animations.
+  inline std::size_t size() const noexcept { return m_animations.size(); }
+
+  /// returns the number of animated scalars (a frame animation uses four).
+  inline std::size_t get_lane_count() const noexcept { return m_lane_count; }
+
+  /// sets the interval of the frame timer in milliseconds (16 by default).
+  void set_frame_interval(std::uint32_t interval_ms);
+
+  /// advances every animation by dt seconds.
+  ///
+  /// @details this is called by the frame timer but can also be called
+  ///          manually (e.g. for testing). returns true while animations remain.
+  bool update(double dt);
+
+private:
+  enum class target_type : std::uint8_t { frame, opacity, value };
+
+  enum field : std::size_t {
+    f_from,
+    f_to,
+    f_time,
+    f_inv_duration,
+    f_a,
+    f_b,
+    f_c,
+    f_value,
+    f_velocity,
+    f_stiffness,
+    f_damping,
+    f_is_spring,
+    f_done,
+    field_count
+  };
+
+  struct animation {
+    id_type id;
+    target_type type;
+    view* target_view;
+    float* target_value;
+    std::uint32_t first_lane;
+    std::uint32_t lane_count;
+    nano::rect<int> applied_frame;
+  };
+
+  struct lane_desc {
+    float from;
+    float to;
+    float velocity;
+  };
+
+  struct dirty_region {
+    view* target_view;
+    nano::rect<int> rect;
+    bool full;
+  };
+
+  std::vector<float> m_storage;
+  std::vector<animation> m_animations;
+  std::unordered_map<std::uintptr_t, std::uint32_t> m_index;
+  std::vector<dirty_region> m_dirty;
+  std::chrono::steady_clock::time_point m_last_time;
+  std::size_t m_lane_count = 0;
+  std::size_t m_capacity = 0;
+  std::uint32_t m_frame_interval = 16;
+  id_type m_next_id = 1;
+  bool m_has_dead = false;
+
+  inline float* lane(field f) noexcept { return m_storage.data() + static_cast<std::size_t>(f) * m_capacity; }
+
+  inline const float* lane(field f) const noexcept {
+    return m_storage.data() + static_cast<std::size_t>(f) * m_capacity;
+  }
+
+  static inline std::uintptr_t make_key(target_type type, const void* ptr) noexcept {
+    return reinterpret_cast<std::uintptr_t>(ptr) | static_cast<std::uintptr_t>(type);
+  }
+
+  static inline std::uintptr_t make_key(const animation& a) noexcept {
+    return a.type == target_type::value ? make_key(a.type, a.target_value) : make_key(a.type, a.target_view);
+  }
+
+  id_type add(target_type type, view* v, float* value, const lane_desc* lanes, std::uint32_t count, double duration,
+      easing e, const spring* s);
+
+  void reserve_lanes(std::size_t count);
+  void kill(std::size_t index);
+  void compact();
+  void add_dirty(view* v);
+  void add_dirty(view* v, const nano::rect<int>& rect);
+  void flush_dirty();
+  void start_timer();
+
+  virtual void on_timer() override;
+};
+} // namespace nano.
+
+NANO_CLANG_DIAGNOSTIC_POP()
@@ -0,0 +1,243 @@
+/*
+ * Nano Library
+ *
+ * Copyright (C) 2022, Meta-Sonic
+ * All rights reserved.
+ *
+ * Proprietary and confidential.
+ * Any unauthorized copying, alteration, distribution, transmission, performance,
+ * display or other use of this material is strictly prohibited.
+ *
+ * Written by Alexandre Arsenault <alx.arsenault@gmail.com>
+ */
+
+#include <nano/ui/audio_file.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+NANO_CLANG_DIAGNOSTIC_PUSH()
+NANO_CLANG_DIAGNOSTIC(warning, "-Weverything")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wc++98-compat")
+
+namespace nano {
+
+namespace {
+  inline std::uint32_t read_u32(const std::uint8_t* p) noexcept {
+    return static_cast<std::uint32_t>(p[0]) | (static_cast<std::uint32_t>(p[1]) << 8)
+        | (static_cast<std::uint32_t>(p[2]) << 16) | (static_cast<std::uint32_t>(p[3]) << 24);
+  }
+
+  inline std::uint16_t read_u16(const std::uint8_t* p) noexcept {
+    return static_cast<std::uint16_t>(p[0] | (p[1] << 8));
+  }
+
+  inline float to_float(const std::uint8_t* p, sample_format format) noexcept {
+    switch (format) {
+    case sample_format::int16:
+      return static_cast<float>(static_cast<std::int16_t>(read_u16(p))) * (1.0f / 32768.0f);
+
+    case sample_format::int24:
+      // The sample is placed in the high bytes to keep its sign.
+      return static_cast<float>(static_cast<std::int32_t>(
+                 (static_cast<std::uint32_t>(p[0]) << 8) | (static_cast<std::uint32_t>(p[1]) << 16)
+                 | (static_cast<std::uint32_t>(p[2]) << 24)))
+          * (1.0f / 2147483648.0f);
+
+    case sample_format::int32:
+      return static_cast<float>(static_cast<std::int32_t>(read_u32(p))) * (1.0f / 2147483648.0f);
+
+    case sample_format::float32: {
+      float value;
+      std::memcpy(&value, p, sizeof(float));
+      return value;
+    }
+    }
+
+    return 0.0f;
+  }
+
+  constexpr std::uint16_t wave_format_pcm = 1;
+  constexpr std::uint16_t wave_format_float = 3;
+  constexpr std::uint16_t wave_format_extensible = 0xFFFE;
+} // namespace.
+
+mapped_audio_file::~mapped_audio_file() { close(); }
+
+bool mapped_audio_file::map(const std::string& path) {
+  close();
+
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+
+  struct stat st;
+  if (::fstat(fd, &st) != 0 || st.st_size <= 0) {
+    ::close(fd);
+    return false;
+  }
+
+  void* mapping = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+
+  // The mapping keeps its own reference to the file.
+  ::close(fd);
+
+  if (mapping == MAP_FAILED) {
+    return false;
+  }
+
+  m_path = path;
+  m_mapping = mapping;
+  m_mapping_size = static_cast<std::size_t>(st.st_size);
+  m_file_size = static_cast<std::uint64_t>(st.st_size);
+  m_modification_time = static_cast<std::int64_t>(st.st_mtime);
+  return true;
+}
+
+bool mapped_audio_file::open_raw(const std::string& path, const audio_format& format, std::size_t data_offset) {
+  if (format.channel_count <= 0 || !map(path)) {
+    return false;
+  }
+
+  if (data_offset > m_mapping_size) {
+    close();
+    return false;
+  }
+
+  m_format = format;
+  m_data = static_cast<const std::uint8_t*>(m_mapping) + data_offset;
+  m_frame_count = (m_mapping_size - data_offset) / format.get_frame_size();
+  return true;
+}
+
+bool mapped_audio_file::open_wav(const std::string& path) {
+  if (!map(path)) {
+    return false;
+  }
+
+  const std::uint8_t* file = static_cast<const std::uint8_t*>(m_mapping);
+  const std::size_t size = m_mapping_size;
+
+  if (size < 12 || std::memcmp(file, "RIFF", 4) != 0 || std::memcmp(file + 8, "WAVE", 4) != 0) {
+    close();
+    return false;
+  }
+
+  bool has_format = false;
+  std::size_t position = 12;
+
+  while (position + 8 <= size) {
+    const std::uint8_t* chunk = file + position;
+    const std::size_t chunk_size = read_u32(chunk + 4);
+    const std::size_t body = position + 8;
+
+    if (std::memcmp(chunk, "fmt ", 4) == 0 && chunk_size >= 16 && body + 16 <= size) {
+      std::uint16_t tag = read_u16(file + body);
+      const int channels = read_u16(file + body + 2);
+      const int bits = read_u16(file + body + 14);
+
+      if (tag == wave_format_extensible && chunk_size >= 26 && body + 26 <= size) {
+        // The sub format guid starts with the format tag.
+        tag = read_u16(file + body + 24);
+      }
+
+      m_format.channel_count = channels;
+      m_format.sample_rate = static_cast<int>(read_u32(file + body + 4));
+
+      if (tag == wave_format_float && bits == 32) {
+        m_format.format = sample_format::float32;
+      }
+      else if (tag == wave_format_pcm && (bits == 16 || bits == 24 || bits == 32)) {
+        m_format.format = bits == 16 ? sample_format::int16 : bits == 24 ? sample_format::int24 : sample_format::int32;
+      }
+      else {
+        break;
+      }
+
+      has_format = channels > 0;
+    }
+    else if (std::memcmp(chunk, "data", 4) == 0) {
+      if (!has_format) {
+        break;
+      }
+
+      // Large files written in one pass can have an unknown (0xFFFFFFFF) data size.
+      m_data = file + body;
+      m_frame_count = std::min(chunk_size, size - body) / m_format.get_frame_size();
+      return true;
+    }
+
+    // Chunks are padded to an even size.
+    position = body + chunk_size + (chunk_size & 1);
+  }
+
+  close();
+  return false;
+}
+
+void mapped_audio_file::close() {
+  if (m_mapping) {
+    ::munmap(m_mapping, m_mapping_size);
+  }
+
+  m_path.clear();
+  m_mapping = nullptr;
+  m_mapping_size = 0;
+  m_data = nullptr;
+  m_format = audio_format();
+  m_frame_count = 0;
+  m_file_size = 0;
+  m_modification_time = 0;
+}
+
+float mapped_audio_file::get_sample(std::uint64_t frame, int channel) const noexcept {
+  return to_float(get_frame(frame) + static_cast<std::size_t>(channel) * get_sample_size(m_format.format),
+      m_format.format);
+}
+
+void mapped_audio_file::read_channel(std::uint64_t frame, std::size_t count, int channel, float* dst) const noexcept {
+  const std::size_t frame_size = m_format.get_frame_size();
+  const std::uint8_t* src = get_frame(frame) + static_cast<std::size_t>(channel) * get_sample_size(m_format.format);
+
+  if (m_format.format == sample_format::float32 && m_format.channel_count == 1) {
+    std::memcpy(dst, src, count * sizeof(float));
+    return;
+  }
+
+  // The switch is outside of the loops so that each one can be vectorized.
+  switch (m_format.format) {
+  case sample_format::int16:
+    for (std::size_t i = 0; i < count; i++) {
+      dst[i] = static_cast<float>(static_cast<std::int16_t>(read_u16(src + i * frame_size))) * (1.0f / 32768.0f);
+    }
+    break;
+
+  case sample_format::float32:
+    for (std::size_t i = 0; i < count; i++) {
+      std::memcpy(dst + i, src + i * frame_size, sizeof(float));
+    }
+    break;
+
+  case sample_format::int24:
+  case sample_format::int32:
+    for (std::size_t i = 0; i < count; i++) {
+      dst[i] = to_float(src + i * frame_size, m_format.format);
+    }
+    break;
+  }
+}
+
+void mapped_audio_file::advise_sequential() const noexcept {
+  if (m_mapping) {
+    ::madvise(m_mapping, m_mapping_size, MADV_SEQUENTIAL);
+  }
+}
+} // namespace nano.
+
+NANO_CLANG_DIAGNOSTIC_POP()
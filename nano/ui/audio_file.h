@@ -0,0 +1,135 @@
+/*
+ * Nano Library
+ *
+ * Copyright (C) 2022, Meta-Sonic
+ * All rights reserved.
+ *
+ * Proprietary and confidential.
+ * Any unauthorized copying, alteration, distribution, transmission, performance,
+ * display or other use of this material is strictly prohibited.
+ *
+ * Written by Alexandre Arsenault <alx.arsenault@gmail.com>
+ */
+
+#pragma once
+
+/*!
+ * @file      nano/ui/audio_file.h
+ * @brief     nano ui memory mapped audio file
+ * @copyright Copyright (C) 2022, Meta-Sonic
+ * @author    Alexandre Arsenault alx.arsenault@gmail.com
+ * @date      Created 16/06/2022
+ */
+
+#include <nano/graphics.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+NANO_CLANG_DIAGNOSTIC_PUSH()
+NANO_CLANG_DIAGNOSTIC(warning, "-Weverything")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wc++98-compat")
+
+namespace nano {
+
+enum class sample_format : std::uint8_t { int16, int24, int32, float32 };
+
+/// returns the size of one sample in bytes.
+inline constexpr std::size_t get_sample_size(sample_format format) noexcept {
+  switch (format) {
+  case sample_format::int16:
+    return 2;
+  case sample_format::int24:
+    return 3;
+  case sample_format::int32:
+  case sample_format::float32:
+    return 4;
+  }
+
+  return 0;
+}
+
+/// little endian interleaved samples.
+struct audio_format {
+  sample_format format = sample_format::float32;
+  int channel_count = 1;
+  int sample_rate = 48000;
+
+  /// returns the size of one frame (one sample per channel) in bytes.
+  inline std::size_t get_frame_size() const noexcept {
+    return get_sample_size(format) * static_cast<std::size_t>(channel_count);
+  }
+};
+
+/// read only memory mapping of the samples of an audio file.
+///
+/// @details the file is never read as a whole, the pages are loaded by the
+///          system when the samples are accessed. multi-gigabyte files only
+///          use address space.
+class mapped_audio_file {
+public:
+  mapped_audio_file() = default;
+
+  mapped_audio_file(const mapped_audio_file&) = delete;
+  mapped_audio_file(mapped_audio_file&&) = delete;
+
+  ~mapped_audio_file();
+
+  mapped_audio_file& operator=(const mapped_audio_file&) = delete;
+  mapped_audio_file& operator=(mapped_audio_file&&) = delete;
+
+  /// maps a wav file with 16, 24 or 32 bit integer or 32 bit float samples.
+  bool open_wav(const std::string& path);
+
+  /// maps a file of interleaved samples without header.
+  /// @param data_offset the position of the first sample in the file, in bytes.
+  bool open_raw(const std::string& path, const audio_format& format, std::size_t data_offset = 0);
+
+  void close();
+
+  inline bool is_open() const noexcept { return m_mapping != nullptr; }
+
+  inline const std::string& get_path() const noexcept { return m_path; }
+
+  inline const audio_format& get_format() const noexcept { return m_format; }
+
+  inline std::uint64_t get_frame_count() const noexcept { return m_frame_count; }
+
+  /// returns the first sample.
+  inline const std::uint8_t* get_data() const noexcept { return m_data; }
+
+  /// returns the first sample of a frame.
+  inline const std::uint8_t* get_frame(std::uint64_t index) const noexcept {
+    return m_data + index * m_format.get_frame_size();
+  }
+
+  inline std::uint64_t get_file_size() const noexcept { return m_file_size; }
+
+  /// returns the modification time of the file in seconds, to validate cached data.
+  inline std::int64_t get_modification_time() const noexcept { return m_modification_time; }
+
+  /// reads one sample as a float in [-1, 1].
+  float get_sample(std::uint64_t frame, int channel) const noexcept;
+
+  /// converts count frames of a channel to floats in [-1, 1].
+  void read_channel(std::uint64_t frame, std::size_t count, int channel, float* dst) const noexcept;
+
+  /// tells the system that the samples are about to be read sequentially.
+  void advise_sequential() const noexcept;
+
+private:
+  std::string m_path;
+  void* m_mapping = nullptr;
+  std::size_t m_mapping_size = 0;
+  const std::uint8_t* m_data = nullptr;
+  audio_format m_format;
+  std::uint64_t m_frame_count = 0;
+  std::uint64_t m_file_size = 0;
+  std::int64_t m_modification_time = 0;
+
+  bool map(const std::string& path);
+};
+} // namespace nano.
+
+NANO_CLANG_DIAGNOSTIC_POP()
@@ -0,0 +1,675 @@
+/*
+ * Nano Library
+ *
+ * Copyright (C) 2022, Meta-Sonic
+ * All rights reserved.
+ *
+ * Proprietary and confidential.
+ * Any unauthorized copying, alteration, distribution, transmission, performance,
+ * display or other use of this material is strictly prohibited.
+ *
+ * Written by Alexandre Arsenault <alx.arsenault@gmail.com>
+ */
+
+#include <nano/ui/automation.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+NANO_CLANG_DIAGNOSTIC_PUSH()
+NANO_CLANG_DIAGNOSTIC(warning, "-Weverything")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wc++98-compat")
+
+namespace nano {
+
+namespace {
+  constexpr automation_column empty_range
+      = { std::numeric_limits<float>::max(), std::numeric_limits<float>::lowest() };
+
+  inline void add(automation_column& r, float value) noexcept {
+    r.min = std::min(r.min, value);
+    r.max = std::max(r.max, value);
+  }
+
+  inline void add(automation_column& r, const automation_column& other) noexcept {
+    r.min = std::min(r.min, other.min);
+    r.max = std::max(r.max, other.max);
+  }
+
+  inline bool is_before(const automation_point& p, double time) noexcept { return p.time < time; }
+
+  inline bool is_after(double time, const automation_point& p) noexcept { return time < p.time; }
+
+  /// chunks are filled to half their capacity by assign(), to leave room for edits.
+  constexpr std::size_t fill_size = automation_curve::max_chunk_size / 2;
+
+  /// a chunk smaller than this is merged with a neighbour.
+  constexpr std::size_t merge_size = automation_curve::max_chunk_size / 4;
+} // namespace.
+
+//
+// MARK: - automation_curve -
+//
+
+automation_curve::automation_curve(float default_value)
+    : m_default_value(default_value) {}
+
+void automation_curve::assign(std::vector<automation_point> points) {
+  const auto is_earlier = [](const automation_point& a, const automation_point& b) { return a.time < b.time; };
+  if (!std::is_sorted(points.begin(), points.end(), is_earlier)) {
+    std::stable_sort(points.begin(), points.end(), is_earlier);
+  }
+
+  m_chunks.clear();
+  m_chunks.reserve((points.size() + fill_size - 1) / fill_size);
+  m_size = points.size();
+
+  for (std::size_t i = 0; i < points.size(); i += fill_size) {
+    chunk& c = m_chunks.emplace_back();
+    const auto first = points.begin() + static_cast<std::ptrdiff_t>(i);
+    c.points.reserve(max_chunk_size);
+    c.points.assign(first, first + static_cast<std::ptrdiff_t>(std::min(fill_size, points.size() - i)));
+    update_summary(c, 0);
+  }
+
+  build_tree();
+}
+
+void automation_curve::clear() {
+  m_chunks.clear();
+  m_tree.clear();
+  m_size = 0;
+}
+
+void automation_curve::update_summary(chunk& c, std::size_t from) noexcept {
+  const std::size_t size = c.points.size();
+  c.blocks.resize((size + block_size - 1) / block_size);
+
+  for (std::size_t b = from / block_size; b < c.blocks.size(); b++) {
+    automation_column r = empty_range;
+    const std::size_t last = std::min(size, (b + 1) * block_size);
+
+    for (std::size_t i = b * block_size; i < last; i++) {
+      add(r, c.points[i].value);
+    }
+
+    c.blocks[b] = r;
+  }
+
+  c.range = empty_range;
+  for (const automation_column& r : c.blocks) {
+    add(c.range, r);
+  }
+}
+
+void automation_curve::update_chunk(std::size_t index, std::size_t from) noexcept {
+  update_summary(m_chunks[index], from);
+
+  std::size_t node = m_chunks.size() + index;
+  m_tree[node] = m_chunks[index].range;
+
+  for (node >>= 1; node > 0; node >>= 1) {
+    m_tree[node] = m_tree[2 * node];
+    add(m_tree[node], m_tree[2 * node + 1]);
+  }
+}
+
+void automation_curve::build_tree() {
+  const std::size_t n = m_chunks.size();
+  m_tree.resize(2 * n);
+
+  for (std::size_t i = 0; i < n; i++) {
+    m_tree[n + i] = m_chunks[i].range;
+  }
+
+  for (std::size_t node = n; node-- > 1;) {
+    m_tree[node] = m_tree[2 * node];
+    add(m_tree[node], m_tree[2 * node + 1]);
+  }
+}
+
+automation_column automation_curve::get_tree_range(std::size_t first, std::size_t last) const noexcept {
+  automation_column r = empty_range;
+  const std::size_t n = m_chunks.size();
+
+  // Bottom up, only the nodes at the edges of the span that their parent doesn't cover.
+  for (first += n, last += n; first < last; first >>= 1, last >>= 1) {
+    if (first & 1) {
+      add(r, m_tree[first++]);
+    }
+
+    if (last & 1) {
+      add(r, m_tree[--last]);
+    }
+  }
+
+  return r;
+}
+
+automation_curve::position automation_curve::next(const position& pos) const noexcept {
+  if (pos.index + 1 < m_chunks[pos.chunk].points.size()) {
+    return position{ pos.chunk, pos.index + 1 };
+  }
+
+  return position{ pos.chunk + 1, 0 };
+}
+
+automation_curve::position automation_curve::previous(const position& pos) const noexcept {
+  if (pos.index > 0) {
+    return position{ pos.chunk, pos.index - 1 };
+  }
+
+  if (pos.chunk == 0) {
+    return end();
+  }
+
+  return position{ pos.chunk - 1, m_chunks[pos.chunk - 1].points.size() - 1 };
+}
+
+automation_curve::position automation_curve::lower_bound(double time) const noexcept {
+  const auto it = std::partition_point(
+      m_chunks.begin(), m_chunks.end(), [time](const chunk& c) { return c.points.back().time < time; });
+
+  if (it == m_chunks.end()) {
+    return end();
+  }
+
+  const auto p = std::lower_bound(it->points.begin(), it->points.end(), time, is_before);
+  return position{ static_cast<std::size_t>(it - m_chunks.begin()), static_cast<std::size_t>(p - it->points.begin()) };
+}
+
+automation_curve::position automation_curve::upper_bound(double time) const noexcept {
+  const auto it = std::partition_point(
+      m_chunks.begin(), m_chunks.end(), [time](const chunk& c) { return c.points.back().time <= time; });
+
+  if (it == m_chunks.end()) {
+    return end();
+  }
+
+  const auto p = std::upper_bound(it->points.begin(), it->points.end(), time, is_after);
+  return position{ static_cast<std::size_t>(it - m_chunks.begin()), static_cast<std::size_t>(p - it->points.begin()) };
+}
+
+std::size_t automation_curve::count(const position& first, const position& last) const noexcept {
+  if (first.chunk == last.chunk) {
+    return last.index - first.index;
+  }
+
+  std::size_t n = m_chunks[first.chunk].points.size() - first.index + last.index;
+  for (std::size_t c = first.chunk + 1; c < last.chunk; c++) {
+    n += m_chunks[c].points.size();
+  }
+
+  return n;
+}
+
+float automation_curve::get_value(const position& upper, double time) const noexcept {
+  if (m_size == 0) {
+    return m_default_value;
+  }
+
+  if (upper == begin()) {
+    return m_chunks.front().points.front().value;
+  }
+
+  const automation_point& a = get_point(previous(upper));
+  if (upper == end()) {
+    return a.value;
+  }
+
+  const automation_point& b = get_point(upper);
+  if (b.time <= a.time) {
+    return b.value;
+  }
+
+  const double t = (time - a.time) / (b.time - a.time);
+  return static_cast<float>(static_cast<double>(a.value) + t * static_cast<double>(b.value - a.value));
+}
+
+float automation_curve::get_value(double time) const noexcept { return get_value(upper_bound(time), time); }
+
+automation_curve::position automation_curve::seek(const position& from, double time, bool strict) const noexcept {
+  const auto is_past = [time, strict](const automation_point& p) { return strict ? p.time > time : p.time >= time; };
+
+  std::size_t ci = from.chunk;
+  std::size_t index = from.index;
+
+  // The next chunk is tried before searching the remaining ones.
+  if (ci < m_chunks.size() && !is_past(m_chunks[ci].points.back())) {
+    ci++;
+    index = 0;
+
+    if (ci < m_chunks.size() && !is_past(m_chunks[ci].points.back())) {
+      ci = static_cast<std::size_t>(
+          std::partition_point(m_chunks.begin() + static_cast<std::ptrdiff_t>(ci), m_chunks.end(),
+              [&is_past](const chunk& c) { return !is_past(c.points.back()); })
+          - m_chunks.begin());
+    }
+  }
+
+  if (ci >= m_chunks.size()) {
+    return end();
+  }
+
+  const std::vector<automation_point>& points = m_chunks[ci].points;
+  const auto it = std::partition_point(points.begin() + static_cast<std::ptrdiff_t>(index), points.end(),
+      [&is_past](const automation_point& p) { return !is_past(p); });
+  return position{ ci, static_cast<std::size_t>(it - points.begin()) };
+}
+
+automation_column automation_curve::get_chunk_range(
+    const chunk& c, std::size_t first, std::size_t last) const noexcept {
+  automation_column r = empty_range;
+  std::size_t i = first;
+
+  // The points up to a block boundary, the whole blocks and the remaining points.
+  for (; i < last && i % block_size != 0; i++) {
+    add(r, c.points[i].value);
+  }
+
+  for (; i + block_size <= last; i += block_size) {
+    add(r, c.blocks[i / block_size]);
+  }
+
+  for (; i < last; i++) {
+    add(r, c.points[i].value);
+  }
+
+  return r;
+}
+
+automation_column automation_curve::get_points_range(const position& first, const position& last) const noexcept {
+  if (first.chunk == last.chunk) {
+    return first.chunk < m_chunks.size() ? get_chunk_range(m_chunks[first.chunk], first.index, last.index)
+                                         : empty_range;
+  }
+
+  const chunk& head = m_chunks[first.chunk];
+  automation_column r
+      = first.index == 0 ? head.range : get_chunk_range(head, first.index, head.points.size());
+
+  add(r, get_tree_range(first.chunk + 1, std::min(last.chunk, m_chunks.size())));
+
+  if (last.chunk < m_chunks.size() && last.index > 0) {
+    add(r, get_chunk_range(m_chunks[last.chunk], 0, last.index));
+  }
+
+  return r;
+}
+
+automation_column automation_curve::get_range(double start_time, double end_time) const noexcept {
+  automation_column r = get_points_range(lower_bound(start_time), upper_bound(end_time));
+  add(r, get_value(start_time));
+  add(r, get_value(end_time));
+  return r;
+}
+
+void automation_curve::get_columns(
+    double start_time, double time_per_column, std::size_t count, automation_column* columns) const noexcept {
+  if (m_size == 0) {
+    std::fill_n(columns, count, automation_column{ m_default_value, m_default_value });
+    return;
+  }
+
+  // The columns are swept forward from the first one, the value at the end
+  // of a column is the value at the start of the next one.
+  position lower = lower_bound(start_time);
+  float start_value = get_value(start_time);
+
+  for (std::size_t i = 0; i < count; i++) {
+    const double a = start_time + static_cast<double>(i) * time_per_column;
+    const double b = start_time + static_cast<double>(i + 1) * time_per_column;
+    lower = seek(lower, a, false);
+    const position upper = seek(lower, b, true);
+    const float end_value = get_value(upper, b);
+
+    automation_column r = get_points_range(lower, upper);
+    add(r, start_value);
+    add(r, end_value);
+    columns[i] = r;
+    start_value = end_value;
+  }
+}
+
+automation_curve::position automation_curve::insert(const automation_point& p) {
+  std::size_t ci = 0;
+
+  if (m_chunks.empty()) {
+    // The first point goes in a new chunk, which has no front point to search.
+    m_chunks.emplace_back().points.reserve(max_chunk_size);
+    update_summary(m_chunks.back(), 0);
+    build_tree();
+  }
+  else {
+    // The last chunk starting at or before the time.
+    const auto it = std::partition_point(
+        m_chunks.begin(), m_chunks.end(), [&p](const chunk& c) { return c.points.front().time <= p.time; });
+    ci = it == m_chunks.begin() ? 0 : static_cast<std::size_t>(it - m_chunks.begin()) - 1;
+  }
+
+  std::vector<automation_point>& points = m_chunks[ci].points;
+  const std::size_t index = static_cast<std::size_t>(
+      std::upper_bound(points.begin(), points.end(), p.time, is_after) - points.begin());
+
+  points.insert(points.begin() + static_cast<std::ptrdiff_t>(index), p);
+  m_size++;
+
+  if (points.size() <= max_chunk_size) {
+    update_chunk(ci, index);
+    return position{ ci, index };
+  }
+
+  // A full chunk is split in two halves.
+  const std::size_t half = points.size() / 2;
+  chunk second;
+  second.points.reserve(max_chunk_size);
+  second.points.assign(points.begin() + static_cast<std::ptrdiff_t>(half), points.end());
+  points.resize(half);
+
+  m_chunks.insert(m_chunks.begin() + static_cast<std::ptrdiff_t>(ci + 1), std::move(second));
+  update_summary(m_chunks[ci], 0);
+  update_summary(m_chunks[ci + 1], 0);
+  build_tree();
+
+  return index < half ? position{ ci, index } : position{ ci + 1, index - half };
+}
+
+void automation_curve::erase(const position& pos) {
+  std::vector<automation_point>& points = m_chunks[pos.chunk].points;
+  points.erase(points.begin() + static_cast<std::ptrdiff_t>(pos.index));
+  m_size--;
+
+  update_chunk(pos.chunk, pos.index);
+  remove_chunk_if_small(pos.chunk);
+}
+
+std::size_t automation_curve::erase(double start_time, double end_time) {
+  const position first = lower_bound(start_time);
+  const position last = lower_bound(end_time);
+  const std::size_t n = count(first, last);
+
+  if (n == 0) {
+    return 0;
+  }
+
+  if (first.chunk == last.chunk) {
+    std::vector<automation_point>& points = m_chunks[first.chunk].points;
+    points.erase(points.begin() + static_cast<std::ptrdiff_t>(first.index),
+        points.begin() + static_cast<std::ptrdiff_t>(last.index));
+    update_chunk(first.chunk, first.index);
+  }
+  else {
+    // The head of the last chunk, the chunks in between and the tail of the first one.
+    if (last.chunk < m_chunks.size()) {
+      std::vector<automation_point>& points = m_chunks[last.chunk].points;
+      points.erase(points.begin(), points.begin() + static_cast<std::ptrdiff_t>(last.index));
+      update_summary(m_chunks[last.chunk], 0);
+    }
+
+    m_chunks[first.chunk].points.resize(first.index);
+    update_summary(m_chunks[first.chunk], first.index);
+
+    m_chunks.erase(m_chunks.begin() + static_cast<std::ptrdiff_t>(first.chunk + 1),
+        m_chunks.begin() + static_cast<std::ptrdiff_t>(last.chunk));
+    build_tree();
+  }
+
+  m_size -= n;
+
+  // The first chunk and the one after it may now be small.
+  remove_chunk_if_small(first.chunk + 1);
+  remove_chunk_if_small(first.chunk);
+  return n;
+}
+
+void automation_curve::remove_chunk_if_small(std::size_t index) {
+  if (index >= m_chunks.size()) {
+    return;
+  }
+
+  const std::size_t size = m_chunks[index].points.size();
+
+  if (size == 0) {
+    m_chunks.erase(m_chunks.begin() + static_cast<std::ptrdiff_t>(index));
+    build_tree();
+    return;
+  }
+
+  if (size >= merge_size) {
+    return;
+  }
+
+  // Merged into the previous chunk or with the next one, when the result is not full.
+  std::size_t into = index;
+  std::size_t from = index + 1;
+
+  if (index > 0 && m_chunks[index - 1].points.size() + size <= fill_size) {
+    into = index - 1;
+    from = index;
+  }
+  else if (from >= m_chunks.size() || m_chunks[from].points.size() + size > fill_size) {
+    return;
+  }
+
+  std::vector<automation_point>& dst = m_chunks[into].points;
+  const std::size_t offset = dst.size();
+  dst.insert(dst.end(), m_chunks[from].points.begin(), m_chunks[from].points.end());
+  update_summary(m_chunks[into], offset);
+  m_chunks.erase(m_chunks.begin() + static_cast<std::ptrdiff_t>(from));
+  build_tree();
+}
+
+bool automation_curve::hit_test(
+    double time, float value, double time_tolerance, float value_tolerance, position& result) const {
+  if (m_size == 0 || time_tolerance <= 0 || value_tolerance <= 0) {
+    return false;
+  }
+
+  const position first = lower_bound(time - time_tolerance);
+  const position last = upper_bound(time + time_tolerance);
+  const float low = value - value_tolerance;
+  const float high = value + value_tolerance;
+
+  double best = std::numeric_limits<double>::max();
+
+  for (std::size_t ci = first.chunk; ci <= last.chunk && ci < m_chunks.size(); ci++) {
+    const chunk& c = m_chunks[ci];
+    if (c.range.max < low || c.range.min > high) {
+      continue;
+    }
+
+    std::size_t i = ci == first.chunk ? first.index : 0;
+    const std::size_t end_index = ci == last.chunk ? last.index : c.points.size();
+
+    // Blocks outside of the value range are skipped.
+    while (i < end_index) {
+      const automation_column& block = c.blocks[i / block_size];
+      const std::size_t block_end = std::min((i / block_size + 1) * block_size, end_index);
+
+      if (block.max < low || block.min > high) {
+        i = block_end;
+        continue;
+      }
+
+      for (; i < block_end; i++) {
+        const automation_point& p = c.points[i];
+        const double dt = (p.time - time) / time_tolerance;
+        const double dv = static_cast<double>((p.value - value) / value_tolerance);
+        const double d = dt * dt + dv * dv;
+
+        if (std::abs(dv) <= 1.0 && d < best) {
+          best = d;
+          result = position{ ci, i };
+        }
+      }
+    }
+  }
+
+  return best != std::numeric_limits<double>::max();
+}
+
+//
+// MARK: - automation_lane_view -
+//
+
+automation_lane_view::automation_lane_view(view* parent, const nano::rect<int>& rect)
+    : view(parent, rect) {}
+
+void automation_lane_view::set_curve(std::shared_ptr<automation_curve> curve) {
+  m_curve = std::move(curve);
+  m_dragging = false;
+  redraw();
+}
+
+void automation_lane_view::set_visible_range(double start_time, double time_per_point) {
+  m_start_time = start_time;
+  m_time_per_point = std::max(time_per_point, std::numeric_limits<double>::min());
+  redraw();
+}
+
+void automation_lane_view::set_colors(
+    const nano::color& background, const nano::color& line, const nano::color& point) {
+  m_background = background;
+  m_line_color = line;
+  m_point_color = point;
+  redraw();
+}
+
+double automation_lane_view::get_time(float x) const noexcept {
+  return m_start_time + static_cast<double>(x) * m_time_per_point;
+}
+
+float automation_lane_view::get_x(double time) const noexcept {
+  return static_cast<float>((time - m_start_time) / m_time_per_point);
+}
+
+float automation_lane_view::get_value(float y) const noexcept {
+  return std::clamp(1.0f - y / static_cast<float>(std::max(get_frame().height, 1)), 0.0f, 1.0f);
+}
+
+float automation_lane_view::get_y(float value) const noexcept {
+  return (1.0f - value) * static_cast<float>(get_frame().height);
+}
+
+bool automation_lane_view::hit_test(const nano::point<float>& pos, automation_curve::position& result) const {
+  const float height = static_cast<float>(std::max(get_frame().height, 1));
+  return m_curve
+      && m_curve->hit_test(get_time(pos.x), get_value(pos.y), static_cast<double>(hit_radius) * m_time_per_point,
+          hit_radius / height, result);
+}
+
+void automation_lane_view::redraw_neighbours(const automation_curve::position& pos) {
+  const automation_curve::position prev = m_curve->previous(pos);
+  const automation_curve::position next = m_curve->next(pos);
+  const float width = static_cast<float>(get_frame().width);
+
+  // The curve extends flat before the first point and after the last one.
+  const float x0 = prev == m_curve->end() ? 0.0f : std::max(get_x(m_curve->get_point(prev).time), 0.0f);
+  const float x1 = next == m_curve->end() ? width : std::min(get_x(m_curve->get_point(next).time), width);
+
+  const int left = static_cast<int>(std::floor(x0 - handle_size));
+  const int right = static_cast<int>(std::ceil(x1 + handle_size));
+  if (right > left) {
+    redraw(nano::rect<int>(left, 0, right - left, get_frame().height));
+  }
+}
+
+void automation_lane_view::begin_drag(const nano::point<float>& pos) {
+  if (!m_curve) {
+    return;
+  }
+
+  if (!hit_test(pos, m_drag_position)) {
+    m_drag_position = m_curve->insert(automation_point{ get_time(pos.x), get_value(pos.y) });
+  }
+
+  m_dragging = true;
+  redraw_neighbours(m_drag_position);
+}
+
+void automation_lane_view::drag(const nano::point<float>& pos) {
+  if (!m_dragging || !m_curve) {
+    return;
+  }
+
+  redraw_neighbours(m_drag_position);
+  m_curve->erase(m_drag_position);
+  m_drag_position = m_curve->insert(automation_point{ get_time(pos.x), get_value(pos.y) });
+  redraw_neighbours(m_drag_position);
+}
+
+void automation_lane_view::end_drag() { m_dragging = false; }
+
+bool automation_lane_view::remove_point(const nano::point<float>& pos) {
+  automation_curve::position p;
+  if (m_dragging || !hit_test(pos, p)) {
+    return false;
+  }
+
+  redraw_neighbours(p);
+  m_curve->erase(p);
+  return true;
+}
+
+void automation_lane_view::on_mouse_down(const nano::event& evt) {
+  if (evt.get_click_count() == 2) {
+    remove_point(evt.get_position());
+    return;
+  }
+
+  begin_drag(evt.get_position());
+}
+
+void automation_lane_view::on_mouse_dragged(const nano::event& evt) { drag(evt.get_position()); }
+
+void automation_lane_view::on_mouse_up(const nano::event& evt) {
+  NANO_UNUSED(evt);
+  end_drag();
+}
+
+void automation_lane_view::on_draw(nano::graphic_context& gc, const nano::rect<float>& dirty_rect) {
+  gc.set_fill_color(m_background);
+  gc.fill_rect(dirty_rect);
+
+  if (!m_curve) {
+    return;
+  }
+
+  const int width = get_frame().width;
+  const int x0 = std::max(static_cast<int>(std::floor(dirty_rect.x)), 0);
+  const int x1 = std::min(static_cast<int>(std::ceil(dirty_rect.x + dirty_rect.width)), width);
+  if (x1 <= x0) {
+    return;
+  }
+
+  // One decimated column per point, a line through the points at any zoom.
+  const std::size_t count = static_cast<std::size_t>(x1 - x0);
+  m_columns.resize(count);
+  m_curve->get_columns(get_time(static_cast<float>(x0)), m_time_per_point, count, m_columns.data());
+
+  gc.set_fill_color(m_line_color);
+  for (std::size_t i = 0; i < count; i++) {
+    const float top = get_y(m_columns[i].max) - 0.5f;
+    const float bottom = get_y(m_columns[i].min) + 0.5f;
+    gc.fill_rect(nano::rect<float>(static_cast<float>(x0) + static_cast<float>(i), top, 1.0f, bottom - top));
+  }
+
+  // The handles are only drawn when they do not overlap.
+  const automation_curve::position first = m_curve->lower_bound(get_time(static_cast<float>(x0) - handle_size));
+  const automation_curve::position last = m_curve->lower_bound(get_time(static_cast<float>(x1) + handle_size));
+  if (m_curve->count(first, last) * static_cast<std::size_t>(handle_size * 2.0f) > count + 4 * handle_size) {
+    return;
+  }
+
+  gc.set_fill_color(m_point_color);
+  for (automation_curve::position p = first; p != last; p = m_curve->next(p)) {
+    const automation_point& pt = m_curve->get_point(p);
+    const float x = get_x(pt.time);
+    const float y = get_y(pt.value);
+    gc.fill_rect(nano::rect<float>(x - handle_size * 0.5f, y - handle_size * 0.5f, handle_size, handle_size));
+  }
+}
+} // namespace nano.
+
+NANO_CLANG_DIAGNOSTIC_POP()
@@ -0,0 +1,255 @@
+/*
+ * Nano Library
+ *
+ * Copyright (C) 2022, Meta-Sonic
+ * All rights reserved.
+ *
+ * Proprietary and confidential.
+ * Any unauthorized copying, alteration, distribution, transmission, performance,
+ * display or other use of this material is strictly prohibited.
+ *
+ * Written by Alexandre Arsenault <alx.arsenault@gmail.com>
+ */
+
+#pragma once
+
+/*!
+ * @file      nano/ui/automation.h
+ * @brief     nano ui automation curve and lane view
+ * @copyright Copyright (C) 2022, Meta-Sonic
+ * @author    Alexandre Arsenault alx.arsenault@gmail.com
+ * @date      Created 16/06/2022
+ */
+
+#include <nano/ui.h>
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+NANO_CLANG_DIAGNOSTIC_PUSH()
+NANO_CLANG_DIAGNOSTIC(warning, "-Weverything")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wc++98-compat")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wpadded")
+
+namespace nano {
+
+struct automation_point {
+  double time;
+  float value;
+};
+
+/// the lowest and highest values of a curve over a range of time.
+struct automation_column {
+  float min;
+  float max;
+};
+
+/// breakpoints of a piecewise linear curve, sorted by time.
+///
+/// @details the points are stored in chunks of at most max_chunk_size points,
+///          each chunk keeps the min and max value of its blocks of block_size
+///          points, and a tree over the chunks keeps the min and max of any
+///          span of chunks. finding a time is a binary search over the chunks
+///          then within one, and the range of a span of points reads the blocks
+///          of the two chunks at its ends and O(log chunks) nodes of the tree,
+///          without visiting the points.
+///
+///          an insertion or removal only shifts the points of one chunk and
+///          updates its summaries and its path in the tree, chunks are split
+///          when full and merged with a neighbour when mostly empty, which
+///          builds the tree again.
+class automation_curve {
+public:
+  /// the location of a point, invalidated by any edit.
+  struct position {
+    std::size_t chunk = 0;
+    std::size_t index = 0;
+
+    inline bool operator==(const position& p) const noexcept { return chunk == p.chunk && index == p.index; }
+    inline bool operator!=(const position& p) const noexcept { return !operator==(p); }
+  };
+
+  static constexpr std::size_t max_chunk_size = 1024;
+  static constexpr std::size_t block_size = 32;
+
+  /// @param default_value the value of an empty curve.
+  automation_curve(float default_value = 0.0f);
+
+  /// replaces all the points, they are sorted by time first.
+  void assign(std::vector<automation_point> points);
+
+  void clear();
+
+  inline std::size_t size() const noexcept { return m_size; }
+
+  inline bool empty() const noexcept { return m_size == 0; }
+
+  inline std::size_t get_chunk_count() const noexcept { return m_chunks.size(); }
+
+  /// inserts a point after the points at the same time.
+  position insert(const automation_point& p);
+
+  void erase(const position& pos);
+
+  /// removes the points in [start_time, end_time).
+  /// @returns the number of points removed.
+  std::size_t erase(double start_time, double end_time);
+
+  inline const automation_point& get_point(const position& pos) const noexcept {
+    return m_chunks[pos.chunk].points[pos.index];
+  }
+
+  inline position begin() const noexcept { return position{ 0, 0 }; }
+
+  inline position end() const noexcept { return position{ m_chunks.size(), 0 }; }
+
+  position next(const position& pos) const noexcept;
+
+  /// returns the end position for the first point.
+  position previous(const position& pos) const noexcept;
+
+  /// returns the first point at or after the time.
+  position lower_bound(double time) const noexcept;
+
+  /// returns the first point after the time.
+  position upper_bound(double time) const noexcept;
+
+  /// returns the number of points between two positions.
+  std::size_t count(const position& first, const position& last) const noexcept;
+
+  /// returns the value of the curve at a time, the first and last values extend the curve.
+  float get_value(double time) const noexcept;
+
+  /// returns the range of the curve over [start_time, end_time].
+  automation_column get_range(double start_time, double end_time) const noexcept;
+
+  /// returns the range of each column of time_per_column, starting at start_time.
+  ///
+  /// @details this is the curve decimated for drawing: a column is the span a
+  ///          line through the points would cover in one pixel, so no peak is
+  ///          lost at any zoom.
+  void get_columns(
+      double start_time, double time_per_column, std::size_t count, automation_column* columns) const noexcept;
+
+  /// calls fn(const automation_point&) for the points in [start_time, end_time).
+  template <class Fn>
+  void for_each(double start_time, double end_time, Fn&& fn) const;
+
+  /// finds the point closest to (time, value) within the tolerances.
+  /// @returns false if there is none.
+  bool hit_test(double time, float value, double time_tolerance, float value_tolerance, position& result) const;
+
+private:
+  struct chunk {
+    std::vector<automation_point> points;
+    std::vector<automation_column> blocks;
+    automation_column range;
+  };
+
+  std::vector<chunk> m_chunks;
+  /// the ranges of the chunks are the leaves, from m_chunks.size().
+  std::vector<automation_column> m_tree;
+  std::size_t m_size = 0;
+  float m_default_value;
+
+  void update_summary(chunk& c, std::size_t from) noexcept;
+
+  /// updates the summaries of a chunk and its path in the tree.
+  void update_chunk(std::size_t index, std::size_t from) noexcept;
+  void build_tree();
+
+  /// returns the range of the chunks in [first, last).
+  automation_column get_tree_range(std::size_t first, std::size_t last) const noexcept;
+  automation_column get_chunk_range(const chunk& c, std::size_t first, std::size_t last) const noexcept;
+  automation_column get_points_range(const position& first, const position& last) const noexcept;
+
+  /// returns the value at a time, from the first point after it.
+  float get_value(const position& upper, double time) const noexcept;
+
+  /// returns the first point after (or at, if not strict) the time, starting
+  /// the search from a position that is not past it.
+  position seek(const position& from, double time, bool strict) const noexcept;
+
+  void remove_chunk_if_small(std::size_t index);
+};
+
+/// draws and edits an automation curve with values in [0, 1].
+///
+/// @details drawing reads one decimated column per point of the dirty area and
+///          the breakpoints are only drawn when they are far enough apart. an
+///          edit redraws the span between the neighbours of the moved point.
+class automation_lane_view : public view {
+public:
+  automation_lane_view(view* parent, const nano::rect<int>& rect);
+
+  ~automation_lane_view() override = default;
+
+  void set_curve(std::shared_ptr<automation_curve> curve);
+
+  inline const std::shared_ptr<automation_curve>& get_curve() const noexcept { return m_curve; }
+
+  /// sets the time at the left edge and the zoom.
+  void set_visible_range(double start_time, double time_per_point);
+
+  inline double get_start_time() const noexcept { return m_start_time; }
+
+  inline double get_time_per_point() const noexcept { return m_time_per_point; }
+
+  void set_colors(const nano::color& background, const nano::color& line, const nano::color& point);
+
+  double get_time(float x) const noexcept;
+  float get_x(double time) const noexcept;
+  float get_value(float y) const noexcept;
+  float get_y(float value) const noexcept;
+
+  /// starts moving the point under the position, a point is added if there is none.
+  void begin_drag(const nano::point<float>& pos);
+
+  /// moves the dragged point.
+  void drag(const nano::point<float>& pos);
+
+  void end_drag();
+
+  inline bool is_dragging() const noexcept { return m_dragging; }
+
+  /// removes the point under the position.
+  bool remove_point(const nano::point<float>& pos);
+
+protected:
+  void on_mouse_down(const nano::event& evt) override;
+  void on_mouse_dragged(const nano::event& evt) override;
+  void on_mouse_up(const nano::event& evt) override;
+
+  void on_draw(nano::graphic_context& gc, const nano::rect<float>& dirty_rect) override;
+
+private:
+  static constexpr float hit_radius = 5.0f;
+  static constexpr float handle_size = 5.0f;
+
+  std::shared_ptr<automation_curve> m_curve;
+  std::vector<automation_column> m_columns;
+  double m_start_time = 0;
+  double m_time_per_point = 1;
+  automation_curve::position m_drag_position;
+  bool m_dragging = false;
+  nano::color m_background = nano::color(0x18191BFF);
+  nano::color m_line_color = nano::color(0xF5A93FFF);
+  nano::color m_point_color = nano::color(0xFFFFFFFF);
+
+  bool hit_test(const nano::point<float>& pos, automation_curve::position& result) const;
+
+  /// redraws the lines from the previous to the next point of a position.
+  void redraw_neighbours(const automation_curve::position& pos);
+};
+
+template <class Fn>
+void automation_curve::for_each(double start_time, double end_time, Fn&& fn) const {
+  const position last = lower_bound(end_time);
+  for (position p = lower_bound(start_time); p != last; p = next(p)) {
+    fn(get_point(p));
+  }
+}
+} // namespace nano.
+
+NANO_CLANG_DIAGNOSTIC_POP()
@@ -0,0 +1,215 @@
+/*
+ * Nano Library
+ *
+ * Copyright (C) 2022, Meta-Sonic
+ * All rights reserved.
+ *
+ * Proprietary and confidential.
+ * Any unauthorized copying, alteration, distribution, transmission, performance,
+ * display or other use of this material is strictly prohibited.
+ *
+ * Written by Alexandre Arsenault <alx.arsenault@gmail.com>
+ */
+
+#include <nano/ui/backing_store.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+NANO_CLANG_DIAGNOSTIC_PUSH()
+NANO_CLANG_DIAGNOSTIC(warning, "-Weverything")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wc++98-compat")
+
+namespace nano {
+
+namespace {
+  // Rows start on 64 byte boundaries relative to the storage.
+  constexpr int row_alignment = 16;
+
+  inline int align_width(int width) noexcept { return (width + row_alignment - 1) / row_alignment * row_alignment; }
+
+  inline std::size_t get_byte_size(const backing_store_pool::storage_type& storage) noexcept {
+    return storage.size() * sizeof(pixel_buffer::pixel_type);
+  }
+} // namespace.
+
+//
+// MARK: - backing_store_pool -
+//
+
+backing_store_pool::backing_store_pool(std::size_t capacity)
+    : m_capacity(capacity) {}
+
+backing_store_pool& backing_store_pool::get_main() {
+  NANO_CLANG_PUSH_WARNING("-Wexit-time-destructors")
+  static backing_store_pool pool;
+  NANO_CLANG_POP_WARNING()
+  return pool;
+}
+
+backing_store_pool::storage_type backing_store_pool::acquire(std::size_t pixel_count) {
+  if (pixel_count == 0) {
+    return storage_type();
+  }
+
+  std::scoped_lock<std::mutex> lock(m_mutex);
+
+  auto best = m_storage.end();
+  for (auto it = m_storage.begin(); it != m_storage.end(); ++it) {
+    const bool fits = it->size() >= pixel_count && it->size() < 2 * pixel_count;
+    if (fits && (best == m_storage.end() || it->size() < best->size())) {
+      best = it;
+    }
+  }
+
+  if (best != m_storage.end()) {
+    storage_type storage = std::move(*best);
+    m_storage.erase(best);
+    m_byte_size -= get_byte_size(storage);
+    m_stats.reuses++;
+    return storage;
+  }
+
+  m_stats.allocations++;
+  m_stats.allocated_bytes += pixel_count * sizeof(pixel_buffer::pixel_type);
+  return storage_type(pixel_count);
+}
+
+void backing_store_pool::release(storage_type&& storage) {
+  if (storage.empty()) {
+    return;
+  }
+
+  std::scoped_lock<std::mutex> lock(m_mutex);
+  m_byte_size += get_byte_size(storage);
+  m_storage.push_back(std::move(storage));
+  evict(m_capacity);
+}
+
+void backing_store_pool::set_capacity(std::size_t capacity) {
+  std::scoped_lock<std::mutex> lock(m_mutex);
+  m_capacity = capacity;
+  evict(capacity);
+}
+
+std::size_t backing_store_pool::get_capacity() const {
+  std::scoped_lock<std::mutex> lock(m_mutex);
+  return m_capacity;
+}
+
+void backing_store_pool::clear() {
+  std::scoped_lock<std::mutex> lock(m_mutex);
+  evict(0);
+}
+
+backing_store_pool::stats backing_store_pool::get_stats() const {
+  std::scoped_lock<std::mutex> lock(m_mutex);
+  stats s = m_stats;
+  s.pooled_count = m_storage.size();
+  s.pooled_bytes = m_byte_size;
+  return s;
+}
+
+void backing_store_pool::reset_stats() {
+  std::scoped_lock<std::mutex> lock(m_mutex);
+  m_stats = stats();
+}
+
+void backing_store_pool::evict(std::size_t capacity) {
+  while (m_byte_size > capacity && !m_storage.empty()) {
+    m_byte_size -= get_byte_size(m_storage.front());
+    m_storage.pop_front();
+  }
+}
+
+//
+// MARK: - backing_store -
+//
+
+backing_store::backing_store(backing_store_pool& pool)
+    : m_pool(pool) {}
+
+backing_store::~backing_store() { m_pool.release(m_buffer.release()); }
+
+bool backing_store::resize(const nano::size<int>& size, float scale, clock::time_point now) {
+  const nano::size<int> pixels(std::max(static_cast<int>(std::ceil(static_cast<float>(size.width) * scale)), 0),
+      std::max(static_cast<int>(std::ceil(static_cast<float>(size.height) * scale)), 0));
+
+  if (m_buffer.get_size() == pixels) {
+    return false;
+  }
+
+  m_last_resize = now;
+
+  if (pixels.width <= m_capacity.width && pixels.height <= m_capacity.height) {
+    m_buffer.assign(m_buffer.release(), pixels.width, pixels.height, m_capacity.width);
+    return true;
+  }
+
+  // The first allocation is exact, then every dimension that no longer fits grows
+  // geometrically so that a live resize only reallocates a few times.
+  nano::size<int> capacity = pixels;
+
+  if (m_capacity.width > 0 && m_capacity.height > 0) {
+    if (pixels.width > m_capacity.width) {
+      capacity.width = std::max(pixels.width, static_cast<int>(static_cast<float>(m_capacity.width) * growth_factor));
+    }
+    else {
+      capacity.width = m_capacity.width;
+    }
+
+    if (pixels.height > m_capacity.height) {
+      capacity.height
+          = std::max(pixels.height, static_cast<int>(static_cast<float>(m_capacity.height) * growth_factor));
+    }
+    else {
+      capacity.height = m_capacity.height;
+    }
+  }
+
+  reallocate(pixels, capacity, false);
+  return true;
+}
+
+void backing_store::release() {
+  m_pool.release(m_buffer.release());
+  m_capacity = nano::size<int>(0, 0);
+}
+
+bool backing_store::needs_trim() const noexcept {
+  return m_capacity != nano::size<int>(align_width(m_buffer.get_width()), m_buffer.get_height());
+}
+
+bool backing_store::trim(clock::time_point now) {
+  if (!needs_trim() || now < get_trim_time()) {
+    return false;
+  }
+
+  reallocate(m_buffer.get_size(), m_buffer.get_size(), true);
+  return true;
+}
+
+void backing_store::reallocate(const nano::size<int>& size, const nano::size<int>& capacity, bool keep_content) {
+  const nano::size<int> aligned(align_width(capacity.width), capacity.height);
+
+  backing_store_pool::storage_type storage
+      = m_pool.acquire(static_cast<std::size_t>(aligned.width) * static_cast<std::size_t>(aligned.height));
+
+  if (keep_content) {
+    const int width = std::min(size.width, m_buffer.get_width());
+    const int height = std::min(size.height, m_buffer.get_height());
+
+    for (int y = 0; y < height; y++) {
+      std::memcpy(storage.data() + static_cast<std::size_t>(y) * static_cast<std::size_t>(aligned.width),
+          m_buffer.row(y), static_cast<std::size_t>(width) * sizeof(pixel_buffer::pixel_type));
+    }
+  }
+
+  m_pool.release(m_buffer.release());
+  m_buffer.assign(std::move(storage), size.width, size.height, aligned.width);
+  m_capacity = aligned;
+}
+} // namespace nano.
+
+NANO_CLANG_DIAGNOSTIC_POP()
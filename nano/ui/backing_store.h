@@ -0,0 +1,158 @@
+/*
+ * Nano Library
+ *
+ * Copyright (C) 2022, Meta-Sonic
+ * All rights reserved.
+ *
+ * Proprietary and confidential.
+ * Any unauthorized copying, alteration, distribution, transmission, performance,
+ * display or other use of this material is strictly prohibited.
+ *
+ * Written by Alexandre Arsenault <alx.arsenault@gmail.com>
+ */
+
+#pragma once
+
+/*!
+ * @file      nano/ui/backing_store.h
+ * @brief     nano ui resizable backing store
+ * @copyright Copyright (C) 2022, Meta-Sonic
+ * @author    Alexandre Arsenault alx.arsenault@gmail.com
+ * @date      Created 16/06/2022
+ */
+
+#include <nano/graphics.h>
+#include <nano/ui/pixel_buffer.h>
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+NANO_CLANG_DIAGNOSTIC_PUSH()
+NANO_CLANG_DIAGNOSTIC(warning, "-Weverything")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wc++98-compat")
+
+namespace nano {
+
+/// pixel storage released by backing stores, kept for reuse by any window.
+///
+/// @details the pool can be used from any thread. the oldest storage is freed
+///          when the pooled size exceeds the capacity.
+class backing_store_pool {
+public:
+  using storage_type = std::vector<pixel_buffer::pixel_type>;
+
+  struct stats {
+    std::uint64_t allocations = 0;
+    std::uint64_t allocated_bytes = 0;
+    std::uint64_t reuses = 0;
+    std::size_t pooled_count = 0;
+    std::size_t pooled_bytes = 0;
+  };
+
+  static constexpr std::size_t default_capacity = 64 * 1024 * 1024;
+
+  /// @param capacity the maximum size of the pooled storage in bytes.
+  backing_store_pool(std::size_t capacity = default_capacity);
+
+  backing_store_pool(const backing_store_pool&) = delete;
+  backing_store_pool(backing_store_pool&&) = delete;
+
+  ~backing_store_pool() = default;
+
+  backing_store_pool& operator=(const backing_store_pool&) = delete;
+  backing_store_pool& operator=(backing_store_pool&&) = delete;
+
+  static backing_store_pool& get_main();
+
+  /// returns storage of at least pixel_count pixels, with undefined content.
+  /// @details the smallest pooled storage that is less than twice as large is reused,
+  ///          otherwise a new one is allocated.
+  storage_type acquire(std::size_t pixel_count);
+
+  void release(storage_type&& storage);
+
+  void set_capacity(std::size_t capacity);
+
+  std::size_t get_capacity() const;
+
+  void clear();
+
+  stats get_stats() const;
+
+  void reset_stats();
+
+private:
+  mutable std::mutex m_mutex;
+
+  // Oldest first.
+  std::deque<storage_type> m_storage;
+  std::size_t m_capacity;
+  std::size_t m_byte_size = 0;
+  stats m_stats;
+
+  void evict(std::size_t capacity);
+};
+
+/// pixel buffer of a window, sized in points and allocated at device scale.
+///
+/// @details during a live resize the buffer is resized many times in a row.
+///          instead of reallocating at every intermediate size, the storage
+///          grows geometrically and smaller sizes reuse it with a larger
+///          stride. once the size has not changed for settle_delay, trim()
+///          moves the content to storage of the exact size. the storage comes
+///          from and goes back to a pool shared by every window.
+class backing_store {
+public:
+  using clock = std::chrono::steady_clock;
+
+  static constexpr float growth_factor = 1.5f;
+  static constexpr std::chrono::milliseconds settle_delay{ 300 };
+
+  backing_store(backing_store_pool& pool = backing_store_pool::get_main());
+
+  backing_store(const backing_store&) = delete;
+  backing_store(backing_store&&) = delete;
+
+  ~backing_store();
+
+  backing_store& operator=(const backing_store&) = delete;
+  backing_store& operator=(backing_store&&) = delete;
+
+  /// sets the size in points, the buffer is ceil(size * scale) pixels.
+  /// @returns true when the buffer size changed, its content is then undefined.
+  bool resize(const nano::size<int>& size, float scale, clock::time_point now = clock::now());
+
+  /// moves the content to storage of the exact size if the size has settled.
+  /// @returns true when the storage was replaced.
+  bool trim(clock::time_point now = clock::now());
+
+  /// gives the storage back to the pool, the buffer becomes empty.
+  void release();
+
+  /// returns true when the storage is larger than needed and trim() will replace it.
+  bool needs_trim() const noexcept;
+
+  /// returns the time from which trim() replaces the oversized storage.
+  inline clock::time_point get_trim_time() const noexcept { return m_last_resize + settle_delay; }
+
+  inline pixel_buffer& get_buffer() noexcept { return m_buffer; }
+
+  inline const pixel_buffer& get_buffer() const noexcept { return m_buffer; }
+
+  /// returns the size of the storage in pixels.
+  inline const nano::size<int>& get_capacity() const noexcept { return m_capacity; }
+
+private:
+  backing_store_pool& m_pool;
+  pixel_buffer m_buffer;
+  nano::size<int> m_capacity = { 0, 0 };
+  clock::time_point m_last_resize;
+
+  void reallocate(const nano::size<int>& size, const nano::size<int>& capacity, bool keep_content);
+};
+} // namespace nano.
+
+NANO_CLANG_DIAGNOSTIC_POP()
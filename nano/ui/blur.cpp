@@ -0,0 +1,524 @@
+/*
+ * Nano Library
+ *
+ * Copyright (C) 2022, Meta-Sonic
+ * All rights reserved.
+ *
+ * Proprietary and confidential.
+ * Any unauthorized copying, alteration, distribution, transmission, performance,
+ * display or other use of this material is strictly prohibited.
+ *
+ * Written by Alexandre Arsenault <alx.arsenault@gmail.com>
+ */
+
+#include <nano/ui/blur.h>
+#include <nano/ui/path_cache.h>
+#include <nano/ui/region.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <functional>
+#include <thread>
+
+NANO_CLANG_DIAGNOSTIC_PUSH()
+NANO_CLANG_DIAGNOSTIC(warning, "-Weverything")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wc++98-compat")
+
+namespace nano {
+
+namespace {
+  /// runs the iterations of a loop on a fixed set of threads.
+  ///
+  /// @details the calling thread also takes part in the work, run() returns
+  ///          once every iteration is done.
+  class worker_pool {
+  public:
+    static worker_pool& get() {
+      NANO_CLANG_PUSH_WARNING("-Wexit-time-destructors")
+      static worker_pool pool;
+      NANO_CLANG_POP_WARNING()
+      return pool;
+    }
+
+    worker_pool() {
+      const unsigned int count = std::clamp(std::thread::hardware_concurrency(), 1u, 16u) - 1;
+
+      for (unsigned int i = 0; i < count; i++) {
+        m_threads.emplace_back([this]() { work(); });
+      }
+    }
+
+    ~worker_pool() {
+      {
+        std::scoped_lock<std::mutex> lock(m_mutex);
+        m_quit = true;
+      }
+
+      m_condition.notify_all();
+
+      for (std::thread& t : m_threads) {
+        t.join();
+      }
+    }
+
+    inline std::size_t get_thread_count() const noexcept { return m_threads.size() + 1; }
+
+    void run(std::size_t count, const std::function<void(std::size_t)>& fct) {
+      if (count == 0) {
+        return;
+      }
+
+      if (count == 1 || m_threads.empty()) {
+        for (std::size_t i = 0; i < count; i++) {
+          fct(i);
+        }
+        return;
+      }
+
+      // One loop at a time.
+      std::scoped_lock<std::mutex> run_lock(m_run_mutex);
+
+      job j(fct, count);
+
+      {
+        std::scoped_lock<std::mutex> lock(m_mutex);
+        m_job = &j;
+        m_generation++;
+      }
+
+      m_condition.notify_all();
+      process(j);
+
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_done_condition.wait(lock, [&]() { return j.done.load() == count && m_active == 0; });
+      m_job = nullptr;
+    }
+
+  private:
+    struct job {
+      job(const std::function<void(std::size_t)>& f, std::size_t c)
+          : fct(f)
+          , count(c) {}
+
+      const std::function<void(std::size_t)>& fct;
+      const std::size_t count;
+      std::atomic<std::size_t> next = 0;
+      std::atomic<std::size_t> done = 0;
+    };
+
+    std::vector<std::thread> m_threads;
+    std::mutex m_run_mutex;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::condition_variable m_done_condition;
+    job* m_job = nullptr;
+    std::size_t m_generation = 0;
+    std::size_t m_active = 0;
+    bool m_quit = false;
+
+    static void process(job& j) {
+      for (std::size_t i = j.next++; i < j.count; i = j.next++) {
+        j.fct(i);
+        j.done++;
+      }
+    }
+
+    void work() {
+      std::size_t generation = 0;
+
+      for (;;) {
+        job* j = nullptr;
+
+        {
+          std::unique_lock<std::mutex> lock(m_mutex);
+          m_condition.wait(lock, [&]() { return m_quit || m_generation != generation; });
+
+          if (m_quit) {
+            return;
+          }
+
+          generation = m_generation;
+          j = m_job;
+
+          if (!j) {
+            continue;
+          }
+
+          m_active++;
+        }
+
+        process(*j);
+
+        {
+          std::scoped_lock<std::mutex> lock(m_mutex);
+          m_active--;
+        }
+
+        m_done_condition.notify_all();
+      }
+    }
+  };
+
+  constexpr int column_block_size = 64;
+
+  /// rounded reciprocal of the box size in 16.16 fixed point.
+  inline std::uint32_t get_box_scale(int size) noexcept {
+    const std::uint32_t s = static_cast<std::uint32_t>(size);
+    return ((1u << 16) + s / 2) / s;
+  }
+
+  inline std::uint8_t get_box_average(std::uint32_t sum, std::uint32_t scale) noexcept {
+    return static_cast<std::uint8_t>(std::min((sum * scale + 0x8000u) >> 16, 255u));
+  }
+
+  /// box blur of a block of columns (one lane per byte).
+  /// @details the block is stored row by row with a stride of column_block_size.
+  void blur_columns(const std::uint8_t* __restrict src, std::uint8_t* __restrict dst, int count, int size) {
+    const int radius = size / 2;
+    const std::uint32_t scale = get_box_scale(size);
+    std::uint32_t sum[column_block_size] = {};
+
+    for (int y = 0; y < std::min(radius, count); y++) {
+      const std::uint8_t* row = src + y * column_block_size;
+      for (int i = 0; i < column_block_size; i++) {
+        sum[i] += row[i];
+      }
+    }
+
+    for (int y = 0; y < count; y++) {
+      const int add = y + radius;
+      const int sub = y - radius;
+
+      if (add < count) {
+        const std::uint8_t* row = src + add * column_block_size;
+        for (int i = 0; i < column_block_size; i++) {
+          sum[i] += row[i];
+        }
+      }
+
+      std::uint8_t* out = dst + y * column_block_size;
+      for (int i = 0; i < column_block_size; i++) {
+        out[i] = get_box_average(sum[i], scale);
+      }
+
+      if (sub >= 0) {
+        const std::uint8_t* row = src + sub * column_block_size;
+        for (int i = 0; i < column_block_size; i++) {
+          sum[i] -= row[i];
+        }
+      }
+    }
+  }
+
+  /// three box blurs in each direction, in place.
+  /// @param data the first byte of the area.
+  template <int Channels>
+  void blur_image(std::uint8_t* data, std::size_t stride, int width, int height, const std::array<int, 3>& sizes) {
+    worker_pool& pool = worker_pool::get();
+    const std::size_t row_bytes = static_cast<std::size_t>(width * Channels);
+
+    // Horizontal passes. A block of rows is transposed so that each x becomes
+    // a row of column_block_size bytes (rows_per_block pixels), which is then
+    // blurred with the same vectorized loops as the vertical passes.
+    constexpr int rows_per_block = column_block_size / Channels;
+    const std::size_t row_job_count = static_cast<std::size_t>((height + rows_per_block - 1) / rows_per_block);
+
+    pool.run(row_job_count, [&](std::size_t job) {
+      const std::size_t block_bytes = static_cast<std::size_t>(width * column_block_size);
+      thread_local std::vector<std::uint8_t> block_a;
+      thread_local std::vector<std::uint8_t> block_b;
+      block_a.assign(block_bytes, 0);
+      block_b.resize(block_bytes);
+
+      const int y_begin = static_cast<int>(job) * rows_per_block;
+      const int rows = std::min(rows_per_block, height - y_begin);
+
+      for (int r = 0; r < rows; r++) {
+        const std::uint8_t* row = data + static_cast<std::size_t>(y_begin + r) * stride;
+        std::uint8_t* dst = block_a.data() + r * Channels;
+
+        for (int x = 0; x < width; x++) {
+          std::memcpy(dst + x * column_block_size, row + x * Channels, Channels);
+        }
+      }
+
+      blur_columns(block_a.data(), block_b.data(), width, sizes[0]);
+      blur_columns(block_b.data(), block_a.data(), width, sizes[1]);
+      blur_columns(block_a.data(), block_b.data(), width, sizes[2]);
+
+      for (int r = 0; r < rows; r++) {
+        std::uint8_t* row = data + static_cast<std::size_t>(y_begin + r) * stride;
+        const std::uint8_t* src = block_b.data() + r * Channels;
+
+        for (int x = 0; x < width; x++) {
+          std::memcpy(row + x * Channels, src + x * column_block_size, Channels);
+        }
+      }
+    });
+
+    // Vertical passes, a block of columns per job so that the inner loops run on contiguous bytes.
+    const std::size_t column_job_count = (row_bytes + column_block_size - 1) / column_block_size;
+    pool.run(column_job_count, [&](std::size_t job) {
+      const std::size_t block_bytes = static_cast<std::size_t>(height * column_block_size);
+      thread_local std::vector<std::uint8_t> block_a;
+      thread_local std::vector<std::uint8_t> block_b;
+      block_a.assign(block_bytes, 0);
+      block_b.resize(block_bytes);
+
+      const std::size_t x_begin = job * column_block_size;
+      const std::size_t lanes = std::min<std::size_t>(column_block_size, row_bytes - x_begin);
+
+      for (int y = 0; y < height; y++) {
+        std::memcpy(
+            block_a.data() + y * column_block_size, data + static_cast<std::size_t>(y) * stride + x_begin, lanes);
+      }
+
+      blur_columns(block_a.data(), block_b.data(), height, sizes[0]);
+      blur_columns(block_b.data(), block_a.data(), height, sizes[1]);
+      blur_columns(block_a.data(), block_b.data(), height, sizes[2]);
+
+      for (int y = 0; y < height; y++) {
+        std::memcpy(
+            data + static_cast<std::size_t>(y) * stride + x_begin, block_b.data() + y * column_block_size, lanes);
+      }
+    });
+  }
+
+  inline std::uint32_t float_bits(float value) noexcept {
+    std::uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+  }
+} // namespace.
+
+//
+// MARK: - alpha_mask -
+//
+
+alpha_mask::alpha_mask(int width, int height) { resize(width, height); }
+
+void alpha_mask::resize(int width, int height) {
+  m_width = std::max(width, 0);
+  m_height = std::max(height, 0);
+  m_data.assign(static_cast<std::size_t>(m_width) * static_cast<std::size_t>(m_height), 0);
+}
+
+//
+// MARK: - box_blur -
+//
+
+std::array<int, 3> get_box_blur_sizes(float sigma) noexcept {
+  // Box sizes whose successive application has the variance of the gaussian.
+  constexpr float n = 3.0f;
+  const float ideal = std::sqrt(12.0f * sigma * sigma / n + 1.0f);
+
+  int lower = static_cast<int>(std::floor(ideal));
+  if (lower % 2 == 0) {
+    lower--;
+  }
+
+  lower = std::max(lower, 1);
+  const int upper = lower + 2;
+
+  const float l = static_cast<float>(lower);
+  const float m_ideal = (12.0f * sigma * sigma - n * l * l - 4.0f * n * l - 3.0f * n) / (-4.0f * l - 4.0f);
+  const int m = static_cast<int>(std::lround(m_ideal));
+
+  std::array<int, 3> sizes;
+  for (int i = 0; i < 3; i++) {
+    sizes[static_cast<std::size_t>(i)] = i < m ? lower : upper;
+  }
+
+  return sizes;
+}
+
+void box_blur(pixel_buffer& buffer, const nano::rect<int>& area, float sigma) {
+  const nano::rect<int> r = get_intersection(area, buffer.get_bounds());
+
+  if (sigma <= 0.0f || is_empty(r)) {
+    return;
+  }
+
+  std::uint8_t* data = reinterpret_cast<std::uint8_t*>(buffer.row(r.y) + r.x);
+  const std::size_t stride = static_cast<std::size_t>(buffer.get_stride()) * sizeof(pixel_buffer::pixel_type);
+  blur_image<4>(data, stride, r.width, r.height, get_box_blur_sizes(sigma));
+}
+
+void box_blur(alpha_mask& mask, float sigma) {
+  if (sigma <= 0.0f || mask.empty()) {
+    return;
+  }
+
+  const std::size_t stride = static_cast<std::size_t>(mask.get_width());
+  blur_image<1>(mask.data(), stride, mask.get_width(), mask.get_height(), get_box_blur_sizes(sigma));
+}
+
+//
+// MARK: - shadows -
+//
+
+shadow_mask create_rounded_rect_shadow(int width, int height, float corner_radius, float blur) {
+  // The blur spreads the shape by about three standard deviations.
+  const int padding = static_cast<int>(std::ceil(blur * 3.0f));
+
+  shadow_mask result;
+  result.offset = nano::point<int>(-padding, -padding);
+  result.mask.resize(width + 2 * padding, height + 2 * padding);
+
+  path_geometry path;
+  path.add_rounded_rect(nano::rect<float>(static_cast<float>(padding), static_cast<float>(padding),
+                            static_cast<float>(width), static_cast<float>(height)),
+      corner_radius);
+
+  const flattened_path flat = flatten(path, 1.0f);
+  const int mask_width = result.mask.get_width();
+  const int mask_height = result.mask.get_height();
+
+  for (const coverage_span& span : flat.spans) {
+    if (span.y < 0 || span.y >= mask_height) {
+      continue;
+    }
+
+    const int x0 = std::max(span.x, 0);
+    const int x1 = std::min(span.x + span.length, mask_width);
+
+    if (x0 < x1) {
+      std::memset(result.mask.row(span.y) + x0, span.coverage, static_cast<std::size_t>(x1 - x0));
+    }
+  }
+
+  box_blur(result.mask, blur);
+  return result;
+}
+
+std::size_t shadow_cache::key_hash::operator()(const key& k) const noexcept {
+  std::size_t h = static_cast<std::size_t>(k.width) * 73856093u;
+  h ^= static_cast<std::size_t>(k.height) * 19349663u;
+  h ^= static_cast<std::size_t>(float_bits(k.corner_radius)) * 83492791u;
+  h ^= static_cast<std::size_t>(float_bits(k.blur)) * 2654435761u;
+  return h;
+}
+
+shadow_cache::shadow_cache(std::size_t capacity)
+    : m_capacity(capacity) {}
+
+shadow_cache& shadow_cache::get_main() {
+  NANO_CLANG_PUSH_WARNING("-Wexit-time-destructors")
+  static shadow_cache cache;
+  NANO_CLANG_POP_WARNING()
+  return cache;
+}
+
+std::shared_ptr<const shadow_mask> shadow_cache::get_rounded_rect(
+    const nano::size<float>& size, float corner_radius, float blur, float scale) {
+  // Radius and blur are rounded to half pixels to share more masks.
+  const key k = { static_cast<int>(std::lround(size.width * scale)), static_cast<int>(std::lround(size.height * scale)),
+    std::round(corner_radius * scale * 2.0f) * 0.5f, std::round(blur * scale * 2.0f) * 0.5f };
+
+  {
+    std::scoped_lock<std::mutex> lock(m_mutex);
+
+    if (auto it = m_index.find(k); it != m_index.end()) {
+      m_stats.hits++;
+      m_entries.splice(m_entries.begin(), m_entries, it->second);
+      return it->second->mask;
+    }
+
+    m_stats.misses++;
+  }
+
+  // Created outside the lock, two threads can create the same mask.
+  std::shared_ptr<const shadow_mask> mask
+      = std::make_shared<const shadow_mask>(create_rounded_rect_shadow(k.width, k.height, k.corner_radius, k.blur));
+
+  const std::size_t byte_size = mask->mask.get_byte_size();
+
+  std::scoped_lock<std::mutex> lock(m_mutex);
+
+  if (byte_size > m_capacity || m_index.count(k)) {
+    return mask;
+  }
+
+  evict(m_capacity - byte_size);
+  m_entries.push_front(entry{ k, mask });
+  m_index.emplace(k, m_entries.begin());
+  m_byte_size += byte_size;
+  return mask;
+}
+
+void shadow_cache::set_capacity(std::size_t capacity) {
+  std::scoped_lock<std::mutex> lock(m_mutex);
+  m_capacity = capacity;
+  evict(capacity);
+}
+
+std::size_t shadow_cache::get_capacity() const {
+  std::scoped_lock<std::mutex> lock(m_mutex);
+  return m_capacity;
+}
+
+void shadow_cache::clear() {
+  std::scoped_lock<std::mutex> lock(m_mutex);
+  m_entries.clear();
+  m_index.clear();
+  m_byte_size = 0;
+}
+
+shadow_cache::stats shadow_cache::get_stats() const {
+  std::scoped_lock<std::mutex> lock(m_mutex);
+  stats s = m_stats;
+  s.entry_count = m_entries.size();
+  s.byte_size = m_byte_size;
+  return s;
+}
+
+void shadow_cache::reset_stats() {
+  std::scoped_lock<std::mutex> lock(m_mutex);
+  m_stats = stats();
+}
+
+void shadow_cache::evict(std::size_t capacity) {
+  while (m_byte_size > capacity && !m_entries.empty()) {
+    const entry& last = m_entries.back();
+    m_index.erase(last.k);
+    m_byte_size -= last.mask->mask.get_byte_size();
+    m_entries.pop_back();
+    m_stats.evictions++;
+  }
+}
+
+void draw_shadow(
+    pixel_buffer& buffer, const nano::rect<float>& rect, float corner_radius, const nano::shadow& s, float scale) {
+  const std::shared_ptr<const shadow_mask> shadow
+      = shadow_cache::get_main().get_rounded_rect(rect.size, corner_radius, s.blur, scale);
+
+  const alpha_mask& mask = shadow->mask;
+  const int left = static_cast<int>(std::lround((rect.x + s.offset.x) * scale)) + shadow->offset.x;
+  const int top = static_cast<int>(std::lround((rect.y + s.offset.y) * scale)) + shadow->offset.y;
+
+  const nano::rect<int> area = get_intersection(
+      nano::rect<int>(left, top, mask.get_width(), mask.get_height()), buffer.get_bounds());
+
+  if (is_empty(area)) {
+    return;
+  }
+
+  const std::uint32_t pixel = to_pixel(s.color);
+
+  for (int y = area.y; y < area.y + area.height; y++) {
+    const std::uint8_t* coverage = mask.row(y - top) + (area.x - left);
+    pixel_buffer::pixel_type* row = buffer.row(y) + area.x;
+
+    for (int x = 0; x < area.width; x++) {
+      if (coverage[x]) {
+        row[x] = blend_pixel(row[x], pixel, coverage[x]);
+      }
+    }
+  }
+}
+} // namespace nano.
+
+NANO_CLANG_DIAGNOSTIC_POP()
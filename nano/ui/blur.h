@@ -0,0 +1,186 @@
+/*
+ * Nano Library
+ *
+ * Copyright (C) 2022, Meta-Sonic
+ * All rights reserved.
+ *
+ * Proprietary and confidential.
+ * Any unauthorized copying, alteration, distribution, transmission, performance,
+ * display or other use of this material is strictly prohibited.
+ *
+ * Written by Alexandre Arsenault <alx.arsenault@gmail.com>
+ */
+
+#pragma once
+
+/*!
+ * @file      nano/ui/blur.h
+ * @brief     nano ui blur and shadows
+ * @copyright Copyright (C) 2022, Meta-Sonic
+ * @author    Alexandre Arsenault alx.arsenault@gmail.com
+ * @date      Created 16/06/2022
+ */
+
+#include <nano/ui.h>
+#include <nano/ui/pixel_buffer.h>
+
+#include <array>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+NANO_CLANG_DIAGNOSTIC_PUSH()
+NANO_CLANG_DIAGNOSTIC(warning, "-Weverything")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wc++98-compat")
+
+namespace nano {
+
+/// single channel 8 bit image.
+class alpha_mask {
+public:
+  alpha_mask() = default;
+
+  alpha_mask(int width, int height);
+
+  /// resizes the mask, the content is cleared.
+  void resize(int width, int height);
+
+  inline int get_width() const noexcept { return m_width; }
+
+  inline int get_height() const noexcept { return m_height; }
+
+  inline bool empty() const noexcept { return m_width == 0 || m_height == 0; }
+
+  inline std::uint8_t* data() noexcept { return m_data.data(); }
+
+  inline const std::uint8_t* data() const noexcept { return m_data.data(); }
+
+  inline std::uint8_t* row(int y) noexcept { return m_data.data() + static_cast<std::size_t>(y * m_width); }
+
+  inline const std::uint8_t* row(int y) const noexcept {
+    return m_data.data() + static_cast<std::size_t>(y * m_width);
+  }
+
+  inline std::size_t get_byte_size() const noexcept { return m_data.size(); }
+
+private:
+  std::vector<std::uint8_t> m_data;
+  int m_width = 0;
+  int m_height = 0;
+};
+
+/// returns the sizes of the three box blurs approximating a gaussian blur.
+std::array<int, 3> get_box_blur_sizes(float sigma) noexcept;
+
+/// approximates a gaussian blur with three separable box blurs.
+///
+/// @details rows and column blocks are processed in parallel and pixels
+///          outside the area are considered transparent.
+/// @param sigma the standard deviation of the gaussian, in pixels.
+void box_blur(pixel_buffer& buffer, const nano::rect<int>& area, float sigma);
+
+void box_blur(alpha_mask& mask, float sigma);
+
+/// blurred coverage of a shape.
+struct shadow_mask {
+  alpha_mask mask;
+
+  /// position of the mask relative to the top-left of the shape, in pixels.
+  nano::point<int> offset = { 0, 0 };
+};
+
+/// least recently used cache of rounded rect shadow masks.
+///
+/// @details masks are keyed by size, corner radius and blur in pixels.
+///          the cache can be used from any thread.
+class shadow_cache {
+public:
+  struct stats {
+    std::uint64_t hits = 0;
+    std::uint64_t misses = 0;
+    std::uint64_t evictions = 0;
+    std::size_t entry_count = 0;
+    std::size_t byte_size = 0;
+  };
+
+  static constexpr std::size_t default_capacity = 16 * 1024 * 1024;
+
+  shadow_cache(std::size_t capacity = default_capacity);
+
+  shadow_cache(const shadow_cache&) = delete;
+  shadow_cache(shadow_cache&&) = delete;
+
+  ~shadow_cache() = default;
+
+  shadow_cache& operator=(const shadow_cache&) = delete;
+  shadow_cache& operator=(shadow_cache&&) = delete;
+
+  static shadow_cache& get_main();
+
+  /// @param size the size of the shape in points.
+  /// @param scale the number of pixels per point.
+  std::shared_ptr<const shadow_mask> get_rounded_rect(
+      const nano::size<float>& size, float corner_radius, float blur, float scale);
+
+  void set_capacity(std::size_t capacity);
+
+  std::size_t get_capacity() const;
+
+  void clear();
+
+  stats get_stats() const;
+
+  void reset_stats();
+
+private:
+  struct key {
+    int width;
+    int height;
+    float corner_radius;
+    float blur;
+
+    inline bool operator==(const key& k) const noexcept {
+      return width == k.width && height == k.height && corner_radius == k.corner_radius && blur == k.blur;
+    }
+  };
+
+  struct key_hash {
+    std::size_t operator()(const key& k) const noexcept;
+  };
+
+  struct entry {
+    key k;
+    std::shared_ptr<const shadow_mask> mask;
+  };
+
+  using entry_list = std::list<entry>;
+
+  mutable std::mutex m_mutex;
+
+  // Most recently used first.
+  entry_list m_entries;
+  std::unordered_map<key, entry_list::iterator, key_hash> m_index;
+  std::size_t m_capacity;
+  std::size_t m_byte_size = 0;
+  stats m_stats;
+
+  void evict(std::size_t capacity);
+};
+
+/// creates the blurred mask of a rounded rect, without cache.
+/// @details all the values are in pixels.
+shadow_mask create_rounded_rect_shadow(int width, int height, float corner_radius, float blur);
+
+/// draws the shadow of a rounded rect into the buffer.
+/// @param rect the shape, in points.
+void draw_shadow(pixel_buffer& buffer, const nano::rect<float>& rect, float corner_radius, const nano::shadow& s,
+    float scale = 1.0f);
+
+/// draws the shadow of a rounded rect in a graphic context.
+void draw_shadow(nano::graphic_context& gc, const nano::rect<float>& rect, float corner_radius, const nano::shadow& s);
+} // namespace nano.
+
+NANO_CLANG_DIAGNOSTIC_POP()
@@ -0,0 +1,389 @@
+/*
+ * Nano Library
+ *
+ * Copyright (C) 2022, Meta-Sonic
+ * All rights reserved.
+ *
+ * Proprietary and confidential.
+ * Any unauthorized copying, alteration, distribution, transmission, performance,
+ * display or other use of this material is strictly prohibited.
+ *
+ * Written by Alexandre Arsenault <alx.arsenault@gmail.com>
+ */
+
+#include <nano/ui/color_conversion.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#endif
+#if defined(__SSE4_1__)
+#include <smmintrin.h>
+#endif
+#endif
+
+NANO_CLANG_DIAGNOSTIC_PUSH()
+NANO_CLANG_DIAGNOSTIC(warning, "-Weverything")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wc++98-compat")
+
+namespace nano {
+
+namespace {
+  constexpr std::size_t linear_table_size = 4096;
+
+  struct conversion_tables {
+    conversion_tables() {
+      unpremultiply[0] = 0;
+      for (std::uint32_t a = 1; a < 256; a++) {
+        unpremultiply[a] = (255u * 65536u + a / 2) / a;
+      }
+
+      for (std::size_t i = 0; i < srgb_to_linear.size(); i++) {
+        const double v = static_cast<double>(i) / 255.0;
+        srgb_to_linear[i] = static_cast<float>(v <= 0.04045 ? v / 12.92 : std::pow((v + 0.055) / 1.055, 2.4));
+      }
+
+      for (std::size_t i = 0; i < linear_to_srgb.size(); i++) {
+        const double v = static_cast<double>(i) / static_cast<double>(linear_table_size - 1);
+        const double s = v <= 0.0031308 ? v * 12.92 : 1.055 * std::pow(v, 1.0 / 2.4) - 0.055;
+        linear_to_srgb[i] = static_cast<std::uint8_t>(std::lround(std::clamp(s, 0.0, 1.0) * 255.0));
+      }
+    }
+
+    /// 16.16 reciprocals of alpha times 255.
+    std::array<std::uint32_t, 256> unpremultiply;
+    std::array<float, 256> srgb_to_linear;
+    std::array<std::uint8_t, linear_table_size> linear_to_srgb;
+  };
+
+  const conversion_tables& get_tables() {
+    static const conversion_tables tables;
+    return tables;
+  }
+
+  /// x / 255 rounded to the nearest, for x <= 255 * 255.
+  inline constexpr std::uint32_t div_255(std::uint32_t x) noexcept {
+    x += 128;
+    return (x + (x >> 8)) >> 8;
+  }
+
+  inline constexpr std::uint32_t swap_red_blue_pixel(std::uint32_t p) noexcept {
+    return (p & 0xFF00FF00u) | ((p & 0xFFu) << 16) | ((p >> 16) & 0xFFu);
+  }
+
+  inline constexpr std::uint32_t premultiply_pixel(std::uint32_t p) noexcept {
+    const std::uint32_t a = p >> 24;
+    return div_255((p & 0xFFu) * a) | (div_255(((p >> 8) & 0xFFu) * a) << 8)
+        | (div_255(((p >> 16) & 0xFFu) * a) << 16) | (a << 24);
+  }
+
+  inline std::uint32_t unpremultiply_pixel(std::uint32_t p, const conversion_tables& tables) noexcept {
+    const std::uint32_t a = p >> 24;
+    const std::uint32_t f = tables.unpremultiply[a];
+    const auto component = [f](std::uint32_t c) { return std::min((c * f + 0x8000u) >> 16, 255u); };
+    return component(p & 0xFFu) | (component((p >> 8) & 0xFFu) << 8) | (component((p >> 16) & 0xFFu) << 16)
+        | (a << 24);
+  }
+
+  /// clamps to [0, 1], nan becomes zero.
+  inline float clamp_unit(float v) noexcept { return v > 0.0f ? (v < 1.0f ? v : 1.0f) : 0.0f; }
+} // namespace.
+
+//
+// MARK: - channel order -
+//
+
+void swap_red_blue(const std::uint32_t* src, std::uint32_t* dst, std::size_t count) noexcept {
+  std::size_t i = 0;
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+  for (; i + 16 <= count; i += 16) {
+    uint8x16x4_t p = vld4q_u8(reinterpret_cast<const std::uint8_t*>(src + i));
+    std::swap(p.val[0], p.val[2]);
+    vst4q_u8(reinterpret_cast<std::uint8_t*>(dst + i), p);
+  }
+#elif defined(__SSSE3__)
+  const __m128i mask = _mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+
+  for (; i + 4 <= count; i += 4) {
+    const __m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_shuffle_epi8(p, mask));
+  }
+#elif defined(__SSE2__) || defined(_M_X64)
+  const __m128i ga_mask = _mm_set1_epi32(static_cast<int>(0xFF00FF00u));
+  const __m128i low_mask = _mm_set1_epi32(0xFF);
+
+  for (; i + 4 <= count; i += 4) {
+    const __m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    const __m128i r = _mm_slli_epi32(_mm_and_si128(p, low_mask), 16);
+    const __m128i b = _mm_and_si128(_mm_srli_epi32(p, 16), low_mask);
+    const __m128i ga = _mm_and_si128(p, ga_mask);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_or_si128(ga, _mm_or_si128(r, b)));
+  }
+#endif
+
+  for (; i < count; i++) {
+    dst[i] = swap_red_blue_pixel(src[i]);
+  }
+}
+
+//
+// MARK: - alpha -
+//
+
+void premultiply(const std::uint32_t* src, std::uint32_t* dst, std::size_t count) noexcept {
+  std::size_t i = 0;
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+  const auto mul = [](uint8x16_t c, uint8x16_t a) {
+    // Exact rounded division by 255: (t + ((t + 128) >> 8) + 128) >> 8.
+    const uint16x8_t lo = vmull_u8(vget_low_u8(c), vget_low_u8(a));
+    const uint16x8_t hi = vmull_u8(vget_high_u8(c), vget_high_u8(a));
+    return vcombine_u8(vraddhn_u16(lo, vrshrq_n_u16(lo, 8)), vraddhn_u16(hi, vrshrq_n_u16(hi, 8)));
+  };
+
+  for (; i + 16 <= count; i += 16) {
+    uint8x16x4_t p = vld4q_u8(reinterpret_cast<const std::uint8_t*>(src + i));
+    p.val[0] = mul(p.val[0], p.val[3]);
+    p.val[1] = mul(p.val[1], p.val[3]);
+    p.val[2] = mul(p.val[2], p.val[3]);
+    vst4q_u8(reinterpret_cast<std::uint8_t*>(dst + i), p);
+  }
+#elif defined(__SSE2__) || defined(_M_X64)
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i color_mask = _mm_setr_epi16(-1, -1, -1, 0, -1, -1, -1, 0);
+
+  // The alpha lane is multiplied by 255 to stay unchanged.
+  const __m128i alpha_255 = _mm_setr_epi16(0, 0, 0, 255, 0, 0, 0, 255);
+  const __m128i half = _mm_set1_epi16(128);
+
+  const auto mul = [&](__m128i c) {
+    __m128i a = _mm_shufflehi_epi16(_mm_shufflelo_epi16(c, 0xFF), 0xFF);
+    a = _mm_or_si128(_mm_and_si128(a, color_mask), alpha_255);
+
+    const __m128i t = _mm_add_epi16(_mm_mullo_epi16(c, a), half);
+    return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+  };
+
+  for (; i + 4 <= count; i += 4) {
+    const __m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    const __m128i lo = mul(_mm_unpacklo_epi8(p, zero));
+    const __m128i hi = mul(_mm_unpackhi_epi8(p, zero));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(lo, hi));
+  }
+#endif
+
+  for (; i < count; i++) {
+    dst[i] = premultiply_pixel(src[i]);
+  }
+}
+
+void unpremultiply(const std::uint32_t* src, std::uint32_t* dst, std::size_t count) noexcept {
+  const conversion_tables& tables = get_tables();
+  std::size_t i = 0;
+
+  // Each pixel is widened to four 32 bit lanes and multiplied by its alpha
+  // reciprocal. The alpha lane is multiplied by 1.0 (65536).
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+  const uint32x4_t half = vdupq_n_u32(0x8000u);
+  const uint32x4_t max = vdupq_n_u32(255u);
+
+  const auto div = [&](uint16x4_t c, std::uint32_t a) {
+    const std::uint32_t f = tables.unpremultiply[a];
+    const std::uint32_t factors[4] = { f, f, f, 65536u };
+    const uint32x4_t t = vaddq_u32(vmulq_u32(vmovl_u16(c), vld1q_u32(factors)), half);
+    return vmovn_u32(vminq_u32(vshrq_n_u32(t, 16), max));
+  };
+
+  for (; i + 4 <= count; i += 4) {
+    const uint8x16_t p = vld1q_u8(reinterpret_cast<const std::uint8_t*>(src + i));
+    const uint16x8_t lo = vmovl_u8(vget_low_u8(p));
+    const uint16x8_t hi = vmovl_u8(vget_high_u8(p));
+
+    const uint16x8_t r_lo
+        = vcombine_u16(div(vget_low_u16(lo), src[i] >> 24), div(vget_high_u16(lo), src[i + 1] >> 24));
+    const uint16x8_t r_hi
+        = vcombine_u16(div(vget_low_u16(hi), src[i + 2] >> 24), div(vget_high_u16(hi), src[i + 3] >> 24));
+    vst1q_u8(reinterpret_cast<std::uint8_t*>(dst + i), vcombine_u8(vmovn_u16(r_lo), vmovn_u16(r_hi)));
+  }
+#elif defined(__SSE4_1__)
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i half = _mm_set1_epi32(0x8000);
+  const __m128i max = _mm_set1_epi32(255);
+
+  const auto div = [&](__m128i c, std::uint32_t a) {
+    const int f = static_cast<int>(tables.unpremultiply[a]);
+    const __m128i t = _mm_add_epi32(_mm_mullo_epi32(c, _mm_setr_epi32(f, f, f, 65536)), half);
+    return _mm_min_epu32(_mm_srli_epi32(t, 16), max);
+  };
+
+  for (; i + 4 <= count; i += 4) {
+    const __m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    const __m128i lo = _mm_unpacklo_epi8(p, zero);
+    const __m128i hi = _mm_unpackhi_epi8(p, zero);
+
+    const __m128i p0 = div(_mm_unpacklo_epi16(lo, zero), src[i] >> 24);
+    const __m128i p1 = div(_mm_unpackhi_epi16(lo, zero), src[i + 1] >> 24);
+    const __m128i p2 = div(_mm_unpacklo_epi16(hi, zero), src[i + 2] >> 24);
+    const __m128i p3 = div(_mm_unpackhi_epi16(hi, zero), src[i + 3] >> 24);
+
+    const __m128i r = _mm_packus_epi16(_mm_packus_epi32(p0, p1), _mm_packus_epi32(p2, p3));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), r);
+  }
+#endif
+
+  for (; i < count; i++) {
+    dst[i] = unpremultiply_pixel(src[i], tables);
+  }
+}
+
+void convert_pixels(const std::uint32_t* src, pixel_format src_format, std::uint32_t* dst, pixel_format dst_format,
+    std::size_t count) noexcept {
+  const auto is_bgra = [](pixel_format f) { return f == pixel_format::bgra || f == pixel_format::bgra_premultiplied; };
+  const auto is_premultiplied
+      = [](pixel_format f) { return f == pixel_format::rgba_premultiplied || f == pixel_format::bgra_premultiplied; };
+
+  const bool swap = is_bgra(src_format) != is_bgra(dst_format);
+
+  if (is_premultiplied(src_format) == is_premultiplied(dst_format)) {
+    if (swap) {
+      swap_red_blue(src, dst, count);
+    }
+    else if (src != dst) {
+      std::memcpy(dst, src, count * sizeof(std::uint32_t));
+    }
+    return;
+  }
+
+  if (is_premultiplied(src_format)) {
+    unpremultiply(src, dst, count);
+  }
+  else {
+    premultiply(src, dst, count);
+  }
+
+  // Alpha is the last byte in both orders, the swap can happen afterward.
+  if (swap) {
+    swap_red_blue(dst, dst, count);
+  }
+}
+
+void to_pixels(const nano::color* colors, std::uint32_t* dst, std::size_t count) noexcept {
+  const auto to_byte
+      = [](float v) { return static_cast<std::uint8_t>(std::lround(std::clamp(v, 0.0f, 1.0f) * 255.0f)); };
+
+  for (std::size_t i = 0; i < count; i++) {
+    const nano::color& c = colors[i];
+    dst[i] = make_pixel(to_byte(c.red<float>()), to_byte(c.green<float>()), to_byte(c.blue<float>()),
+        to_byte(c.alpha<float>()));
+  }
+
+  premultiply(dst, dst, count);
+}
+
+//
+// MARK: - srgb -
+//
+
+void srgb_to_linear(const std::uint32_t* src, float* dst, std::size_t count) noexcept {
+  const std::array<float, 256>& table = get_tables().srgb_to_linear;
+
+  for (std::size_t i = 0; i < count; i++) {
+    const std::uint32_t p = src[i];
+    float* d = dst + i * 4;
+    d[0] = table[p & 0xFFu];
+    d[1] = table[(p >> 8) & 0xFFu];
+    d[2] = table[(p >> 16) & 0xFFu];
+    d[3] = static_cast<float>(p >> 24) * (1.0f / 255.0f);
+  }
+}
+
+void linear_to_srgb(const float* src, std::uint32_t* dst, std::size_t count) noexcept {
+  const std::array<std::uint8_t, linear_table_size>& table = get_tables().linear_to_srgb;
+  constexpr float table_scale = static_cast<float>(linear_table_size - 1);
+  std::size_t i = 0;
+
+  // The color lanes become table indices and the alpha lane the alpha byte.
+#if defined(__aarch64__)
+  const float scales[4] = { table_scale, table_scale, table_scale, 255.0f };
+  const float32x4_t scale = vld1q_f32(scales);
+  const float32x4_t zero = vdupq_n_f32(0.0f);
+  const float32x4_t one = vdupq_n_f32(1.0f);
+  const float32x4_t half = vdupq_n_f32(0.5f);
+
+  for (; i < count; i++) {
+    // vmaxnm returns the number when one operand is nan.
+    const float32x4_t v = vminq_f32(vmaxnmq_f32(vld1q_f32(src + i * 4), zero), one);
+    std::uint32_t index[4];
+    vst1q_u32(index, vcvtq_u32_f32(vaddq_f32(vmulq_f32(v, scale), half)));
+    dst[i] = make_pixel(table[index[0]], table[index[1]], table[index[2]], static_cast<std::uint8_t>(index[3]));
+  }
+#elif defined(__SSE2__) || defined(_M_X64)
+  const __m128 scale = _mm_setr_ps(table_scale, table_scale, table_scale, 255.0f);
+  const __m128 zero = _mm_setzero_ps();
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 half = _mm_set1_ps(0.5f);
+
+  for (; i < count; i++) {
+    // _mm_max_ps returns the second operand when the first one is nan.
+    const __m128 v = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i * 4), zero), one);
+    alignas(16) std::int32_t index[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(index), _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(v, scale), half)));
+    dst[i] = make_pixel(table[static_cast<std::size_t>(index[0])], table[static_cast<std::size_t>(index[1])],
+        table[static_cast<std::size_t>(index[2])], static_cast<std::uint8_t>(index[3]));
+  }
+#endif
+
+  for (; i < count; i++) {
+    const float* s = src + i * 4;
+    const auto index = [&](float v) { return static_cast<std::size_t>(clamp_unit(v) * table_scale + 0.5f); };
+    dst[i] = make_pixel(table[index(s[0])], table[index(s[1])], table[index(s[2])],
+        static_cast<std::uint8_t>(clamp_unit(s[3]) * 255.0f + 0.5f));
+  }
+}
+
+float srgb_to_linear(std::uint8_t value) noexcept { return get_tables().srgb_to_linear[value]; }
+
+std::uint8_t linear_to_srgb(float value) noexcept {
+  return get_tables().linear_to_srgb[static_cast<std::size_t>(
+      clamp_unit(value) * static_cast<float>(linear_table_size - 1) + 0.5f)];
+}
+
+//
+// MARK: - import / export -
+//
+
+void import_pixels(
+    pixel_buffer& buffer, const void* data, int width, int height, std::size_t bytes_per_row, pixel_format format) {
+  buffer.resize(width, height);
+
+  const std::uint8_t* bytes = static_cast<const std::uint8_t*>(data);
+  const std::size_t count = static_cast<std::size_t>(buffer.get_width());
+
+  for (int y = 0; y < buffer.get_height(); y++) {
+    const std::uint8_t* row = bytes + static_cast<std::size_t>(y) * bytes_per_row;
+    convert_pixels(reinterpret_cast<const std::uint32_t*>(row), format, buffer.row(y), pixel_format::rgba_premultiplied,
+        count);
+  }
+}
+
+void export_pixels(const pixel_buffer& buffer, void* data, std::size_t bytes_per_row, pixel_format format) noexcept {
+  std::uint8_t* bytes = static_cast<std::uint8_t*>(data);
+  const std::size_t count = static_cast<std::size_t>(buffer.get_width());
+
+  for (int y = 0; y < buffer.get_height(); y++) {
+    std::uint32_t* dst = reinterpret_cast<std::uint32_t*>(bytes + static_cast<std::size_t>(y) * bytes_per_row);
+    convert_pixels(buffer.row(y), pixel_format::rgba_premultiplied, dst, format, count);
+  }
+}
+} // namespace nano.
+
+NANO_CLANG_DIAGNOSTIC_POP()
@@ -0,0 +1,99 @@
+/*
+ * Nano Library
+ *
+ * Copyright (C) 2022, Meta-Sonic
+ * All rights reserved.
+ *
+ * Proprietary and confidential.
+ * Any unauthorized copying, alteration, distribution, transmission, performance,
+ * display or other use of this material is strictly prohibited.
+ *
+ * Written by Alexandre Arsenault <alx.arsenault@gmail.com>
+ */
+
+#pragma once
+
+/*!
+ * @file      nano/ui/color_conversion.h
+ * @brief     nano ui batch pixel and color conversions
+ * @copyright Copyright (C) 2022, Meta-Sonic
+ * @author    Alexandre Arsenault alx.arsenault@gmail.com
+ * @date      Created 16/06/2022
+ */
+
+#include <nano/graphics.h>
+#include <nano/ui/pixel_buffer.h>
+
+#include <cstddef>
+#include <cstdint>
+
+NANO_CLANG_DIAGNOSTIC_PUSH()
+NANO_CLANG_DIAGNOSTIC(warning, "-Weverything")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wc++98-compat")
+
+namespace nano {
+
+/// memory layout of 8 bit per component pixels.
+enum class pixel_format : std::uint8_t {
+  /// r, g, b, a bytes with premultiplied alpha, the pixel_buffer format.
+  rgba_premultiplied,
+
+  /// b, g, r, a bytes with premultiplied alpha, the native format of most display surfaces.
+  bgra_premultiplied,
+
+  /// r, g, b, a bytes with straight alpha (e.g. png).
+  rgba,
+
+  /// b, g, r, a bytes with straight alpha.
+  bgra
+};
+
+//
+// The batch conversions below use SSE or NEON when available and process any
+// count of pixels. src and dst can be the same buffer but must not otherwise
+// overlap. Alpha is always the last byte so the alpha conversions work with
+// both channel orders.
+//
+
+/// converts rgba pixels to bgra and the other way around.
+void swap_red_blue(const std::uint32_t* src, std::uint32_t* dst, std::size_t count) noexcept;
+
+/// multiplies the color components by alpha, rounded to the nearest.
+void premultiply(const std::uint32_t* src, std::uint32_t* dst, std::size_t count) noexcept;
+
+/// divides the color components by alpha, pixels with zero alpha become zero.
+void unpremultiply(const std::uint32_t* src, std::uint32_t* dst, std::size_t count) noexcept;
+
+/// converts pixels between any two formats.
+void convert_pixels(const std::uint32_t* src, pixel_format src_format, std::uint32_t* dst, pixel_format dst_format,
+    std::size_t count) noexcept;
+
+/// converts colors to premultiplied pixels, same as to_pixel().
+void to_pixels(const nano::color* colors, std::uint32_t* dst, std::size_t count) noexcept;
+
+/// converts the color components of srgb encoded pixels to linear floats.
+///
+/// @details dst receives four floats per pixel in the same order as src, alpha
+///          is only normalized. premultiplied pixels should be unpremultiplied
+///          first for exact results.
+void srgb_to_linear(const std::uint32_t* src, float* dst, std::size_t count) noexcept;
+
+/// converts four linear floats per pixel to srgb encoded pixels.
+/// @details values are clamped to [0, 1], the error is at most one step.
+void linear_to_srgb(const float* src, std::uint32_t* dst, std::size_t count) noexcept;
+
+/// single component conversions, with the same tables as the batch ones.
+float srgb_to_linear(std::uint8_t value) noexcept;
+std::uint8_t linear_to_srgb(float value) noexcept;
+
+/// copies an image of the given format into the buffer (e.g. decoded image data).
+/// @details the buffer is resized to the image size, rows must be 4 byte aligned.
+void import_pixels(
+    pixel_buffer& buffer, const void* data, int width, int height, std::size_t bytes_per_row, pixel_format format);
+
+/// copies the buffer into an image of the given format (e.g. a frame for the display).
+/// @details data must hold get_height() rows of bytes_per_row bytes, rows must be 4 byte aligned.
+void export_pixels(const pixel_buffer& buffer, void* data, std::size_t bytes_per_row, pixel_format format) noexcept;
+} // namespace nano.
+
+NANO_CLANG_DIAGNOSTIC_POP()
@@ -0,0 +1,653 @@
+/*
+ * Nano Library
+ *
+ * Copyright (C) 2022, Meta-Sonic
+ * All rights reserved.
+ *
+ * Proprietary and confidential.
+ * Any unauthorized copying, alteration, distribution, transmission, performance,
+ * display or other use of this material is strictly prohibited.
+ *
+ * Written by Alexandre Arsenault <alx.arsenault@gmail.com>
+ */
+
+#include <nano/ui/compositor.h>
+
+#include <cmath>
+
+NANO_CLANG_DIAGNOSTIC_PUSH()
+NANO_CLANG_DIAGNOSTIC(warning, "-Weverything")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wc++98-compat")
+
+namespace nano {
+
+namespace {
+  /// the time between the frames presented for the debug overlay alone.
+  constexpr std::chrono::milliseconds overlay_frame_interval = std::chrono::milliseconds(16);
+
+  inline double get_elapsed_ms(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  }
+
+  inline nano::rect<int> to_pixels(const nano::rect<int>& r, float scale) {
+    const int left = static_cast<int>(std::floor(static_cast<float>(r.x) * scale));
+    const int top = static_cast<int>(std::floor(static_cast<float>(r.y) * scale));
+    const int right = static_cast<int>(std::ceil(static_cast<float>(r.x + r.width) * scale));
+    const int bottom = static_cast<int>(std::ceil(static_cast<float>(r.y + r.height) * scale));
+    return nano::rect<int>(left, top, right - left, bottom - top);
+  }
+
+  inline std::uint64_t get_pixel_count(const nano::rect<int>& r) {
+    return static_cast<std::uint64_t>(r.width) * static_cast<std::uint64_t>(r.height);
+  }
+
+  /// returns the rect moved by delta, clipped to the area.
+  inline nano::rect<int> get_scrolled_rect(
+      const nano::rect<int>& r, const nano::rect<int>& area, const nano::point<int>& delta) {
+    return get_intersection(nano::rect<int>(r.x + delta.x, r.y + delta.y, r.width, r.height), area);
+  }
+
+  /// adds the parts of the area that nothing moves into.
+  inline void add_exposed(region& damage, const nano::rect<int>& area, const nano::point<int>& delta) {
+    const nano::rect<int> moved = get_scrolled_rect(area, area, delta);
+
+    if (is_empty(moved)) {
+      damage.add(area);
+      return;
+    }
+
+    // Full width strip above or below, then the remaining rows on the left or right.
+    if (delta.y > 0) {
+      damage.add(nano::rect<int>(area.x, area.y, area.width, delta.y));
+    }
+    else if (delta.y < 0) {
+      damage.add(nano::rect<int>(area.x, area.y + area.height + delta.y, area.width, -delta.y));
+    }
+
+    if (delta.x > 0) {
+      damage.add(nano::rect<int>(area.x, moved.y, delta.x, moved.height));
+    }
+    else if (delta.x < 0) {
+      damage.add(nano::rect<int>(area.x + area.width + delta.x, moved.y, -delta.x, moved.height));
+    }
+  }
+
+  /// the damaged pixels that are moved stay damaged at their new position.
+  inline void add_scrolled_damage(region& damage, const nano::rect<int>& area, const nano::point<int>& delta) {
+    region moved;
+    for (const nano::rect<int>& r : damage.get_rects()) {
+      moved.add(get_scrolled_rect(get_intersection(r, area), area, delta));
+    }
+
+    damage.add(moved);
+  }
+
+  /// calls fct on the view and its descendants, parents first.
+  template <class Fct>
+  inline void for_each_view(view* v, Fct&& fct) {
+    fct(v);
+
+    for (view* child : v->get_children()) {
+      for_each_view(child, fct);
+    }
+  }
+} // namespace.
+
+compositor::compositor(view* root, presenter* p, float scale)
+    : m_root(root)
+    , m_presenter(p)
+    , m_scale(scale) {
+
+  if (!m_presenter) {
+    m_native_presenter = create_native_presenter(root, scale);
+    m_presenter = m_native_presenter.get();
+  }
+
+  attach(m_root, this);
+  m_thread = std::thread([this]() { run(); });
+
+  invalidate(m_root);
+}
+
+compositor::~compositor() {
+  timer::stop();
+  attach(m_root, nullptr);
+
+  {
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    m_quit = true;
+  }
+
+  m_condition.notify_all();
+  m_thread.join();
+}
+
+void compositor::invalidate(view* v) {
+  const nano::size<int> size = v->get_frame().size;
+  invalidate(v, nano::rect<int>(0, 0, size.width, size.height));
+}
+
+void compositor::invalidate(view* v, const nano::rect<int>& rect) {
+  m_dirty_views.insert(v);
+
+  // Damage is accumulated in root view coordinates.
+  const nano::point<int> origin = get_root_position(v);
+  m_damage.add(nano::rect<int>(rect.x + origin.x, rect.y + origin.y, rect.width, rect.height));
+  post_commit();
+}
+
+void compositor::scroll(view* v, const nano::rect<int>& rect, const nano::point<int>& delta) {
+  const float dx = static_cast<float>(delta.x) * m_scale;
+  const float dy = static_cast<float>(delta.y) * m_scale;
+
+  if (dx != std::round(dx) || dy != std::round(dy)) {
+    invalidate(v, rect);
+    return;
+  }
+
+  // Only the pixels of the view that are presented are moved.
+  const nano::point<int> origin = get_root_position(v);
+  const nano::rect<int> area = get_intersection(
+      nano::rect<int>(rect.x + origin.x, rect.y + origin.y, rect.width, rect.height), get_visible_rect(v));
+
+  if (is_empty(area) || (delta.x == 0 && delta.y == 0)) {
+    return;
+  }
+
+  add_scrolled_damage(m_damage, area, delta);
+  add_exposed(m_damage, area, delta);
+  m_scrolls.push_back(scroll_op{ area, delta });
+  post_commit();
+}
+
+nano::point<int> compositor::get_root_position(view* v) const {
+  nano::point<int> origin(0, 0);
+  for (view* p = v; p && p != m_root; p = p->get_parent()) {
+    origin = origin + p->get_frame().position;
+  }
+
+  return origin;
+}
+
+nano::rect<int> compositor::get_visible_rect(view* v) const {
+  nano::point<int> origin = get_root_position(v);
+  nano::rect<int> visible(origin, v->get_frame().size);
+
+  // Each view is clipped to its parent, as in collect_layers().
+  for (view* p = v; p != m_root; p = p->get_parent()) {
+    view* parent = p->get_parent();
+    if (!parent || p->is_hidden()) {
+      return nano::rect<int>();
+    }
+
+    origin = origin - p->get_frame().position;
+    visible = get_intersection(visible, nano::rect<int>(origin, parent->get_frame().size));
+  }
+
+  return m_root->is_hidden() ? nano::rect<int>() : visible;
+}
+
+void compositor::post_commit() {
+  if (!m_commit_posted) {
+    m_commit_posted = true;
+
+    std::weak_ptr<int> token = m_token;
+    post_message([this, token]() {
+      if (token.lock()) {
+        commit();
+      }
+    });
+  }
+}
+
+void compositor::commit() {
+  m_commit_posted = false;
+
+  // During a live resize, the views are laid out at most once per layout interval,
+  // the last frame is presented at the sizes in between.
+  if (m_live_resize) {
+    const nano::size<int> size = m_root->get_frame().size;
+
+    if (size != m_layout_size || !m_deferred_layouts.empty()) {
+      if (std::chrono::steady_clock::now() - m_last_layout
+          >= std::chrono::milliseconds(m_live_resize_options.layout_interval)) {
+        layout_live_resize();
+      }
+      else if (size != m_layout_size) {
+        commit_snapshot(size);
+        return;
+      }
+    }
+  }
+
+  if (m_damage.empty() && m_dirty_views.empty()) {
+    return;
+  }
+
+  const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+  std::unique_ptr<layer_tree> tree(new layer_tree());
+  tree->size = m_root->get_frame().size;
+
+  if (tree->size != m_last_size) {
+    m_last_size = tree->size;
+    m_damage.add(nano::rect<int>(0, 0, tree->size.width, tree->size.height));
+  }
+
+  std::unordered_map<view*, std::shared_ptr<const display_list>> recordings;
+  recordings.reserve(m_recordings.size());
+
+  std::uint64_t recorded = 0;
+  const nano::rect<int> root_rect(0, 0, tree->size.width, tree->size.height);
+  collect_layers(m_root, nano::point<int>(0, 0), root_rect, 1.0f, *tree, recordings, recorded);
+
+  // Recordings of views that are no longer in the tree are released here.
+  m_recordings = std::move(recordings);
+  m_dirty_views.clear();
+
+  m_damage.clip(root_rect);
+  tree->damage = std::move(m_damage);
+  tree->scrolls = std::move(m_scrolls);
+  tree->commit_time = std::chrono::steady_clock::now();
+  tree->live_resize = m_live_resize;
+  m_damage.clear();
+  m_scrolls.clear();
+
+  const double record_ms = get_elapsed_ms(start);
+
+  {
+    std::scoped_lock<std::mutex> lock(m_mutex);
+
+    if (m_pending && m_pending->snapshot) {
+      m_stats.dropped_frames++;
+    }
+    else if (m_pending) {
+      // The dropped tree's scrolls come first and its damage moves with the new ones.
+      for (const scroll_op& op : tree->scrolls) {
+        add_scrolled_damage(m_pending->damage, op.area, op.delta);
+      }
+
+      tree->damage.add(m_pending->damage);
+      tree->scrolls.insert(tree->scrolls.begin(), m_pending->scrolls.begin(), m_pending->scrolls.end());
+      tree->record_times.insert(
+          tree->record_times.end(), m_pending->record_times.begin(), m_pending->record_times.end());
+      m_stats.dropped_frames++;
+    }
+
+    m_pending = std::move(tree);
+    m_stats.commits++;
+    m_stats.recorded_views += recorded;
+    m_stats.last_record_ms = record_ms;
+  }
+
+  m_condition.notify_all();
+}
+
+void compositor::commit_snapshot(const nano::size<int>& size) {
+  std::unique_ptr<layer_tree> tree(new layer_tree());
+  tree->size = size;
+  tree->commit_time = std::chrono::steady_clock::now();
+  tree->snapshot = true;
+  tree->live_resize = true;
+  tree->resize_options = m_live_resize_options;
+
+  {
+    std::scoped_lock<std::mutex> lock(m_mutex);
+
+    // A pending tree that is not a snapshot has damage that must be rasterized,
+    // the next snapshot will follow it.
+    if (m_pending && !m_pending->snapshot) {
+      return;
+    }
+
+    if (m_pending) {
+      m_stats.dropped_frames++;
+    }
+
+    m_pending = std::move(tree);
+    m_stats.commits++;
+  }
+
+  m_condition.notify_all();
+}
+
+void compositor::flush() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_condition.wait(lock, [this]() { return !m_pending && !m_busy; });
+}
+
+compositor::stats compositor::get_stats() const {
+  std::scoped_lock<std::mutex> lock(m_mutex);
+  return m_stats;
+}
+
+//
+// MARK: - live resize -
+//
+
+void compositor::set_live_resize_options(const live_resize_options& options) {
+  m_live_resize_options = options;
+
+  if (m_live_resize) {
+    timer::start(std::max(m_live_resize_options.layout_interval, 1u));
+  }
+}
+
+void compositor::begin_live_resize() {
+  if (m_live_resize) {
+    return;
+  }
+
+  m_live_resize = true;
+  m_layout_size = m_root->get_frame().size;
+  m_last_layout = std::chrono::steady_clock::now();
+
+  for_each_view(m_root, [](view* v) { v->on_will_start_live_resize(); });
+
+  // Lays out the sizes that are left behind when the resize pauses.
+  timer::start(std::max(m_live_resize_options.layout_interval, 1u));
+}
+
+void compositor::end_live_resize() {
+  if (!m_live_resize) {
+    return;
+  }
+
+  timer::stop();
+  m_live_resize = false;
+  layout_live_resize();
+
+  for_each_view(m_root, [](view* v) { v->on_did_end_live_resize(); });
+
+  // Views drew with their cheaper path during the resize.
+  for_each_view(m_root, [this](view* v) { m_dirty_views.insert(v); });
+  invalidate(m_root);
+  commit();
+}
+
+bool compositor::defer_layout(view* v) {
+  if (!m_live_resize) {
+    return false;
+  }
+
+  m_deferred_layouts.insert(v);
+  post_commit();
+  return true;
+}
+
+void compositor::layout_live_resize() {
+  m_layout_size = m_root->get_frame().size;
+  m_last_layout = std::chrono::steady_clock::now();
+
+  // The snapshot is replaced even if no view redraws.
+  if (m_layout_size != m_last_size) {
+    m_damage.add(nano::rect<int>(0, 0, m_layout_size.width, m_layout_size.height));
+  }
+
+  if (m_deferred_layouts.empty()) {
+    return;
+  }
+
+  // Parents are laid out before their children. The views resized by a layout
+  // are deferred again and laid out in the same pass, not at the next interval.
+  while (!m_deferred_layouts.empty()) {
+    std::unordered_set<view*> views = std::move(m_deferred_layouts);
+    m_deferred_layouts.clear();
+
+    for_each_view(m_root, [this, &views](view* v) {
+      if (views.count(v)) {
+        // A frame set by an ancestor earlier in this round is laid out now.
+        m_deferred_layouts.erase(v);
+        v->on_frame_changed();
+      }
+    });
+  }
+}
+
+void compositor::on_timer() {
+  if (m_root->get_frame().size != m_layout_size || !m_deferred_layouts.empty()) {
+    layout_live_resize();
+    commit();
+  }
+}
+
+void compositor::collect_layers(view* v, const nano::point<int>& origin, const nano::rect<int>& clip, float opacity,
+    layer_tree& tree, std::unordered_map<view*, std::shared_ptr<const display_list>>& recordings,
+    std::uint64_t& recorded) {
+
+  if (v->is_hidden()) {
+    return;
+  }
+
+  const nano::rect<int> frame(origin, v->get_frame().size);
+  const nano::rect<int> layer_clip = get_intersection(clip, frame);
+
+  if (is_empty(layer_clip)) {
+    return;
+  }
+
+  std::shared_ptr<const display_list> list;
+
+  if (auto it = m_recordings.find(v); it != m_recordings.end() && m_dirty_views.count(v) == 0) {
+    list = it->second;
+  }
+  else {
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    list = record(v, m_scale);
+    tree.record_times.push_back(debug_overlay::view_time{ v, frame, get_elapsed_ms(start) });
+    recorded++;
+  }
+
+  const float layer_opacity = v == m_root ? opacity : opacity * v->get_opacity();
+  recordings[v] = list;
+  tree.layers.push_back(layer{ list, frame, layer_clip, layer_opacity });
+
+  for (view* child : v->get_children()) {
+    collect_layers(
+        child, origin + child->get_frame().position, layer_clip, layer_opacity, tree, recordings, recorded);
+  }
+}
+
+void compositor::run() {
+  for (;;) {
+    std::unique_ptr<layer_tree> tree;
+
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      const auto is_ready = [this]() { return m_quit || m_pending; };
+
+      // The back buffer storage is trimmed once a live resize has settled.
+      while (!is_ready()) {
+        debug_overlay* overlay = m_debug_overlay.load();
+
+        // The repaint flashes keep fading out without new frames, up to one
+        // frame after the last one was visible to clear it.
+        if (overlay && overlay->is_enabled() && !m_back_store.get_buffer().empty()
+            && overlay->is_animating(std::chrono::steady_clock::now() - overlay_frame_interval)) {
+          if (!m_condition.wait_for(lock, overlay_frame_interval, is_ready)) {
+            lock.unlock();
+            present_overlay(*overlay);
+            lock.lock();
+          }
+        }
+        else if (!m_back_store.needs_trim()) {
+          m_condition.wait(lock, is_ready);
+        }
+        else if (!m_condition.wait_until(lock, m_back_store.get_trim_time(), is_ready)) {
+          lock.unlock();
+          m_back_store.trim();
+          lock.lock();
+        }
+      }
+
+      if (m_quit) {
+        return;
+      }
+
+      tree = std::move(m_pending);
+      m_busy = true;
+    }
+
+    if (tree->snapshot) {
+      const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+      present_snapshot(*tree);
+      m_needs_full_present = true;
+
+      {
+        std::scoped_lock<std::mutex> lock(m_mutex);
+        m_busy = false;
+        m_stats.frames++;
+        m_stats.snapshot_frames++;
+        m_stats.last_raster_ms = get_elapsed_ms(start);
+        m_stats.last_latency_ms = get_elapsed_ms(tree->commit_time);
+      }
+
+      m_condition.notify_all();
+      continue;
+    }
+
+    if (!tree->live_resize) {
+      m_snapshot_store.release();
+    }
+
+    debug_overlay* overlay = m_debug_overlay.load();
+    if (overlay && !overlay->is_enabled()) {
+      overlay = nullptr;
+    }
+
+    if (overlay) {
+      overlay->begin_frame(tree->size);
+
+      for (const nano::rect<int>& r : tree->damage.get_rects()) {
+        overlay->add_repaint(r);
+      }
+
+      for (const debug_overlay::view_time& t : tree->record_times) {
+        overlay->add_draw_time(t.v, t.frame, t.ms);
+      }
+    }
+
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    rasterize(*tree, overlay);
+    const double raster_ms = get_elapsed_ms(start);
+
+    region damage;
+    std::uint64_t painted = 0;
+    for (const nano::rect<int>& r : tree->damage.get_rects()) {
+      const nano::rect<int> px = to_pixels(r, m_scale);
+      damage.add(px);
+      painted += get_pixel_count(px);
+    }
+
+    // Scrolled pixels changed as well, without being painted.
+    std::uint64_t scrolled = 0;
+    for (const scroll_op& op : tree->scrolls) {
+      const nano::rect<int> px = to_pixels(op.area, m_scale);
+      damage.add(px);
+      scrolled += get_pixel_count(get_scrolled_rect(px, px,
+          nano::point<int>(static_cast<int>(std::lround(static_cast<float>(op.delta.x) * m_scale)),
+              static_cast<int>(std::lround(static_cast<float>(op.delta.y) * m_scale)))));
+    }
+
+    if (overlay) {
+      overlay->end_frame();
+      present_overlay(*overlay);
+    }
+    else if (m_needs_full_present) {
+      // Replaces the overlay or the snapshot in the presented frame.
+      m_presenter->present(m_back_store.get_buffer(), region(m_back_store.get_buffer().get_bounds()));
+      m_needs_full_present = false;
+    }
+    else {
+      m_presenter->present(m_back_store.get_buffer(), damage);
+    }
+
+    {
+      std::scoped_lock<std::mutex> lock(m_mutex);
+      m_busy = false;
+      m_stats.frames++;
+      m_stats.last_raster_ms = raster_ms;
+      m_stats.last_latency_ms = get_elapsed_ms(tree->commit_time);
+      m_stats.painted_pixels += painted;
+      m_stats.scrolled_pixels += scrolled;
+    }
+
+    m_condition.notify_all();
+  }
+}
+
+void compositor::present_overlay(const debug_overlay& overlay) {
+  // The overlay is drawn over a copy, the back buffer is only partially redrawn.
+  m_debug_frame = m_back_store.get_buffer();
+  overlay.compose(m_debug_frame, m_scale);
+  m_presenter->present(m_debug_frame, region(m_debug_frame.get_bounds()));
+  m_needs_full_present = true;
+}
+
+void compositor::present_snapshot(const layer_tree& tree) {
+  const pixel_buffer& src = m_back_store.get_buffer();
+  m_snapshot_store.resize(tree.size, m_scale);
+  pixel_buffer& dst = m_snapshot_store.get_buffer();
+
+  if (tree.resize_options.mode == live_resize_mode::stretch && !src.empty()) {
+    // Nearest neighbor, the snapshot is only shown for a few frames.
+    std::vector<int> columns(static_cast<std::size_t>(dst.get_width()));
+    for (int x = 0; x < dst.get_width(); x++) {
+      columns[static_cast<std::size_t>(x)] = static_cast<int>(
+          static_cast<std::int64_t>(x) * src.get_width() / dst.get_width());
+    }
+
+    for (int y = 0; y < dst.get_height(); y++) {
+      const std::uint32_t* src_row = src.row(static_cast<int>(
+          static_cast<std::int64_t>(y) * src.get_height() / dst.get_height()));
+      std::uint32_t* dst_row = dst.row(y);
+
+      for (int x = 0; x < dst.get_width(); x++) {
+        dst_row[x] = src_row[columns[static_cast<std::size_t>(x)]];
+      }
+    }
+  }
+  else {
+    const nano::rect<int> covered = get_intersection(src.get_bounds(), dst.get_bounds());
+    dst.copy_from(src, covered, nano::point<int>(0, 0));
+
+    // Right strip and bottom strip.
+    dst.fill(nano::rect<int>(covered.width, 0, dst.get_width() - covered.width, covered.height),
+        tree.resize_options.background);
+    dst.fill(nano::rect<int>(0, covered.height, dst.get_width(), dst.get_height() - covered.height),
+        tree.resize_options.background);
+  }
+
+  m_presenter->present(dst, region(dst.get_bounds()));
+}
+
+void compositor::rasterize(const layer_tree& tree, debug_overlay* overlay) {
+  // A size change always comes with a full damage, the content does not need to be kept.
+  m_back_store.resize(tree.size, m_scale);
+  pixel_buffer& buffer = m_back_store.get_buffer();
+
+  for (const scroll_op& op : tree.scrolls) {
+    buffer.scroll(to_pixels(op.area, m_scale),
+        nano::point<int>(static_cast<int>(std::lround(static_cast<float>(op.delta.x) * m_scale)),
+            static_cast<int>(std::lround(static_cast<float>(op.delta.y) * m_scale))));
+  }
+
+  for (const nano::rect<int>& damage : tree.damage.get_rects()) {
+    buffer.fill(to_pixels(damage, m_scale), 0);
+
+    for (const layer& l : tree.layers) {
+      const nano::rect<int> area = get_intersection(damage, l.clip);
+
+      if (!is_empty(area)) {
+        draw(*l.list, buffer, l.frame, area, l.opacity, m_scale);
+
+        if (overlay) {
+          overlay->add_draw(area);
+        }
+      }
+    }
+  }
+}
+} // namespace nano.
+
+NANO_CLANG_DIAGNOSTIC_POP()
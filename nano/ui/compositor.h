@@ -0,0 +1,313 @@
+/*
+ * Nano Library
+ *
+ * Copyright (C) 2022, Meta-Sonic
+ * All rights reserved.
+ *
+ * Proprietary and confidential.
+ * Any unauthorized copying, alteration, distribution, transmission, performance,
+ * display or other use of this material is strictly prohibited.
+ *
+ * Written by Alexandre Arsenault <alx.arsenault@gmail.com>
+ */
+
+#pragma once
+
+/*!
+ * @file      nano/ui/compositor.h
+ * @brief     nano ui compositor
+ * @copyright Copyright (C) 2022, Meta-Sonic
+ * @author    Alexandre Arsenault alx.arsenault@gmail.com
+ * @date      Created 16/06/2022
+ */
+
+#include <nano/ui.h>
+#include <nano/ui/backing_store.h>
+#include <nano/ui/debug_overlay.h>
+#include <nano/ui/pixel_buffer.h>
+#include <nano/ui/region.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+NANO_CLANG_DIAGNOSTIC_PUSH()
+NANO_CLANG_DIAGNOSTIC(warning, "-Weverything")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wc++98-compat")
+
+namespace nano {
+
+/// immutable recording of the drawing commands issued by a view's on_draw().
+///
+/// @details recordings are made on the main thread and replayed on the
+///          compositor thread.
+class display_list {
+public:
+  class native;
+
+  display_list(std::unique_ptr<native> n, const nano::size<int>& size);
+
+  display_list(const display_list&) = delete;
+  display_list(display_list&&) = delete;
+
+  ~display_list();
+
+  display_list& operator=(const display_list&) = delete;
+  display_list& operator=(display_list&&) = delete;
+
+  inline const nano::size<int>& get_size() const noexcept { return m_size; }
+
+  /// returns the size of the recorded commands in bytes.
+  std::size_t get_byte_size() const noexcept;
+
+private:
+  friend class compositor;
+  std::unique_ptr<native> m_native;
+  nano::size<int> m_size;
+};
+
+/// threaded rasterization for a view tree.
+///
+/// @details once a compositor is attached to a root view, redraw() no longer
+///          draws on the main thread: it marks the view and the damaged area,
+///          and a commit is posted to the main queue. the commit only records
+///          what the dirty views draw (as display lists) and snapshots the
+///          layer tree (one layer per view with its frame, clip and opacity).
+///
+///          the compositor thread then rasterizes the damaged area of the
+///          newest layer tree into its back buffer and hands it to the presenter.
+///          when the compositor is slower than the main thread, intermediate
+///          layer trees are dropped and their damage is merged into the next one,
+///          so the main thread never waits for rasterization.
+///
+///          the back buffer is a backing_store, it is not reallocated at every
+///          size of a live resize and is trimmed on the compositor thread once
+///          the size has settled.
+///
+///          during a live resize (see begin_live_resize()), the views are only
+///          laid out and recorded every layout_interval. the frames in between
+///          are snapshots of the last rasterized frame, cropped or stretched to
+///          the new size.
+///
+///          layers are composited in tree order with the product of their
+///          ancestors' opacity (there is no group opacity). the compositor must
+///          be destroyed before the root view.
+class compositor : private timer {
+public:
+  /// receives the rasterized frames, always called on the compositor thread.
+  class presenter {
+  public:
+    presenter() = default;
+
+    virtual ~presenter() = default;
+
+    /// @param frame the back buffer, only valid during the call.
+    /// @param damage the area (in pixels) that changed since the last frame.
+    virtual void present(const pixel_buffer& frame, const region& damage) = 0;
+  };
+
+  struct stats {
+    std::uint64_t commits = 0;
+    std::uint64_t frames = 0;
+    std::uint64_t dropped_frames = 0;
+    std::uint64_t recorded_views = 0;
+    double last_record_ms = 0;
+    double last_raster_ms = 0;
+    /// time between a commit and the presentation of its frame.
+    double last_latency_ms = 0;
+    /// number of pixels rasterized from display lists.
+    std::uint64_t painted_pixels = 0;
+    /// number of pixels moved by scroll().
+    std::uint64_t scrolled_pixels = 0;
+    /// number of frames presented from the snapshot during live resizes.
+    std::uint64_t snapshot_frames = 0;
+  };
+
+  enum class live_resize_mode : std::uint8_t {
+    /// the snapshot keeps its size at the top left, the uncovered area is filled with the background.
+    crop,
+
+    /// the snapshot is scaled to the new size.
+    stretch
+  };
+
+  struct live_resize_options {
+    live_resize_mode mode = live_resize_mode::crop;
+
+    /// minimum time between two layouts of the views in milliseconds.
+    std::uint32_t layout_interval = 100;
+
+    /// premultiplied pixel of the area uncovered by the snapshot.
+    std::uint32_t background = 0;
+  };
+
+  /// returns false when the platform has no drawing backend (linux for now).
+  /// @details recording or rasterizing a view then aborts, as does rendering a
+  ///          headless_surface, and native windows have no compositor.
+  static bool can_draw() noexcept;
+
+  /// attaches a compositor to a root view.
+  /// @param p the presenter, if null the frames are presented in the native view.
+  compositor(view* root, presenter* p = nullptr, float scale = 1.0f);
+
+  compositor(const compositor&) = delete;
+  compositor(compositor&&) = delete;
+
+  ~compositor();
+
+  compositor& operator=(const compositor&) = delete;
+  compositor& operator=(compositor&&) = delete;
+
+  /// marks the view's area as needing to be recorded and composited.
+  /// @details this is what view::redraw() calls when a compositor is attached.
+  void invalidate(view* v);
+  void invalidate(view* v, const nano::rect<int>& rect);
+
+  /// moves the pixels of the back buffer within the view's rect by delta and
+  /// only damages the area that is left uncovered.
+  ///
+  /// @details this is what view::scroll_rect() calls when a compositor is attached.
+  ///          when delta is not a whole number of pixels, the rect is invalidated.
+  void scroll(view* v, const nano::rect<int>& rect, const nano::point<int>& delta);
+
+  /// records the dirty views and sends the new layer tree to the compositor thread.
+  /// @details this is called from the main queue after an invalidation but can
+  ///          also be called manually (e.g. in tests or when there is no run loop).
+  void commit();
+
+  /// blocks until every committed layer tree has been presented.
+  void flush();
+
+  /// reports every frame to the overlay and presents the frames with the overlay drawn over them.
+  /// @details the overlay can be changed or toggled at any time, it must outlive the compositor.
+  ///          while its repaint flashes fade out, frames with only the overlay changed are presented.
+  inline void set_debug_overlay(debug_overlay* overlay) noexcept { m_debug_overlay = overlay; }
+
+  // MARK: live resize
+
+  void set_live_resize_options(const live_resize_options& options);
+
+  inline const live_resize_options& get_live_resize_options() const noexcept { return m_live_resize_options; }
+
+  /// starts presenting snapshots when the root view is resized and calls
+  /// on_will_start_live_resize() on every view.
+  /// @details the platform calls it when the user starts resizing the window.
+  void begin_live_resize();
+
+  /// lays out the views, calls on_did_end_live_resize() on every view and
+  /// redraws everything.
+  void end_live_resize();
+
+  inline bool is_in_live_resize() const noexcept { return m_live_resize; }
+
+  /// defers the view's on_frame_changed() to the next layout during a live resize.
+  ///
+  /// @details the platform calls it when the frame of a view changes.
+  /// @returns false when there is no live resize, on_frame_changed() should then be called right away.
+  bool defer_layout(view* v);
+
+  inline view* get_view() const noexcept { return m_root; }
+
+  stats get_stats() const;
+
+private:
+  struct layer {
+    std::shared_ptr<const display_list> list;
+    nano::rect<int> frame;
+    nano::rect<int> clip;
+    float opacity;
+  };
+
+  /// a move of the back buffer content, in root view coordinates.
+  struct scroll_op {
+    nano::rect<int> area;
+    nano::point<int> delta;
+  };
+
+  struct layer_tree {
+    std::vector<layer> layers;
+    /// applied to the back buffer, in order, before the damage is rasterized.
+    std::vector<scroll_op> scrolls;
+    /// time spent recording each view, for the debug overlay.
+    std::vector<debug_overlay::view_time> record_times;
+    region damage;
+    nano::size<int> size;
+    std::chrono::steady_clock::time_point commit_time;
+    /// the last frame is presented at the new size, nothing is rasterized.
+    bool snapshot = false;
+    bool live_resize = false;
+    live_resize_options resize_options;
+  };
+
+  view* m_root;
+  presenter* m_presenter;
+  std::unique_ptr<presenter> m_native_presenter;
+  float m_scale;
+
+  // Main thread.
+  std::unordered_map<view*, std::shared_ptr<const display_list>> m_recordings;
+  std::unordered_set<view*> m_dirty_views;
+  region m_damage;
+  std::vector<scroll_op> m_scrolls;
+  nano::size<int> m_last_size = { 0, 0 };
+  bool m_commit_posted = false;
+  bool m_live_resize = false;
+  live_resize_options m_live_resize_options;
+  std::unordered_set<view*> m_deferred_layouts;
+  nano::size<int> m_layout_size = { 0, 0 };
+  std::chrono::steady_clock::time_point m_last_layout;
+  std::shared_ptr<int> m_token = std::make_shared<int>(0);
+
+  // Shared.
+  mutable std::mutex m_mutex;
+  std::condition_variable m_condition;
+  std::unique_ptr<layer_tree> m_pending;
+  bool m_busy = false;
+  bool m_quit = false;
+  stats m_stats;
+  std::atomic<debug_overlay*> m_debug_overlay = nullptr;
+
+  // Compositor thread.
+  backing_store m_back_store;
+  pixel_buffer m_debug_frame;
+  backing_store m_snapshot_store;
+  /// the presented frame is not the back buffer (overlay or snapshot).
+  bool m_needs_full_present = false;
+  std::thread m_thread;
+
+  nano::point<int> get_root_position(view* v) const;
+
+  /// returns the part of the view that is presented, in root coordinates.
+  nano::rect<int> get_visible_rect(view* v) const;
+  void post_commit();
+  void commit_snapshot(const nano::size<int>& size);
+  void layout_live_resize();
+  void run();
+  void present_snapshot(const layer_tree& tree);
+  void present_overlay(const debug_overlay& overlay);
+  void rasterize(const layer_tree& tree, debug_overlay* overlay);
+  void collect_layers(view* v, const nano::point<int>& origin, const nano::rect<int>& clip, float opacity,
+      layer_tree& tree, std::unordered_map<view*, std::shared_ptr<const display_list>>& recordings,
+      std::uint64_t& recorded);
+
+  virtual void on_timer() override;
+
+  // Platform specific.
+  static void attach(view* root, compositor* c);
+  /// @param scale the scale the list is rasterized at, for the drawing that depends on it (e.g. sprites).
+  static std::shared_ptr<const display_list> record(view* v, float scale);
+  static void draw(const display_list& list, pixel_buffer& buffer, const nano::rect<int>& frame,
+      const nano::rect<int>& clip, float opacity, float scale);
+  static std::unique_ptr<presenter> create_native_presenter(view* root, float scale);
+
+  friend class view;
+};
+} // namespace nano.
+
+NANO_CLANG_DIAGNOSTIC_POP()
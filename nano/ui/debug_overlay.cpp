@@ -0,0 +1,327 @@
+/*
+ * Nano Library
+ *
+ * Copyright (C) 2022, Meta-Sonic
+ * All rights reserved.
+ *
+ * Proprietary and confidential.
+ * Any unauthorized copying, alteration, distribution, transmission, performance,
+ * display or other use of this material is strictly prohibited.
+ *
+ * Written by Alexandre Arsenault <alx.arsenault@gmail.com>
+ */
+
+#include <nano/ui/debug_overlay.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+
+NANO_CLANG_DIAGNOSTIC_PUSH()
+NANO_CLANG_DIAGNOSTIC(warning, "-Weverything")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wc++98-compat")
+
+namespace nano {
+
+namespace {
+  /// premultiplied pixel from straight components.
+  inline constexpr std::uint32_t make_tint(
+      std::uint32_t r, std::uint32_t g, std::uint32_t b, std::uint32_t a) noexcept {
+    return make_pixel(static_cast<std::uint8_t>(r * a / 255), static_cast<std::uint8_t>(g * a / 255),
+        static_cast<std::uint8_t>(b * a / 255), static_cast<std::uint8_t>(a));
+  }
+
+  // Overdraw colors for 2, 3, 4 and 5+ writes.
+  constexpr std::array<std::uint32_t, 4> overdraw_tints = {
+    make_tint(40, 90, 255, 110),
+    make_tint(40, 200, 60, 110),
+    make_tint(255, 100, 200, 120),
+    make_tint(255, 30, 30, 140),
+  };
+
+  constexpr std::uint32_t outline_pixel = make_tint(255, 40, 40, 255);
+  constexpr std::uint32_t label_background = make_tint(0, 0, 0, 200);
+  constexpr std::uint32_t label_text = make_tint(255, 255, 255, 255);
+
+  /// 3x5 glyphs, one row of 3 bits per entry, the leftmost pixel in the highest bit.
+  struct glyph {
+    char c;
+    std::array<std::uint8_t, 5> rows;
+  };
+
+  constexpr std::array<glyph, 15> glyphs = { {
+      { '0', { 7, 5, 5, 5, 7 } },
+      { '1', { 2, 6, 2, 2, 7 } },
+      { '2', { 7, 1, 7, 4, 7 } },
+      { '3', { 7, 1, 7, 1, 7 } },
+      { '4', { 5, 5, 7, 1, 1 } },
+      { '5', { 7, 4, 7, 1, 7 } },
+      { '6', { 7, 4, 7, 5, 7 } },
+      { '7', { 7, 1, 1, 1, 1 } },
+      { '8', { 7, 5, 7, 5, 7 } },
+      { '9', { 7, 5, 7, 1, 7 } },
+      { '.', { 0, 0, 0, 0, 2 } },
+      { '#', { 5, 7, 5, 7, 5 } },
+      { 'm', { 0, 0, 7, 7, 5 } },
+      { 's', { 0, 3, 6, 1, 6 } },
+      { ' ', { 0, 0, 0, 0, 0 } },
+  } };
+
+  inline const glyph* find_glyph(char c) noexcept {
+    for (const glyph& g : glyphs) {
+      if (g.c == c) {
+        return &g;
+      }
+    }
+    return nullptr;
+  }
+
+  inline nano::rect<int> to_pixels(const nano::rect<int>& r, float scale) {
+    const int left = static_cast<int>(std::floor(static_cast<float>(r.x) * scale));
+    const int top = static_cast<int>(std::floor(static_cast<float>(r.y) * scale));
+    const int right = static_cast<int>(std::ceil(static_cast<float>(r.x + r.width) * scale));
+    const int bottom = static_cast<int>(std::ceil(static_cast<float>(r.y + r.height) * scale));
+    return nano::rect<int>(left, top, right - left, bottom - top);
+  }
+
+  void tint(pixel_buffer& frame, const nano::rect<int>& rect, std::uint32_t pixel) {
+    const nano::rect<int> r = get_intersection(rect, frame.get_bounds());
+
+    if (is_empty(r)) {
+      return;
+    }
+
+    for (int y = r.y; y < r.y + r.height; y++) {
+      std::uint32_t* row = frame.row(y);
+      for (int x = r.x; x < r.x + r.width; x++) {
+        row[x] = blend_pixel(row[x], pixel, 255);
+      }
+    }
+  }
+
+  void outline(pixel_buffer& frame, const nano::rect<int>& r, int width, std::uint32_t pixel) {
+    tint(frame, nano::rect<int>(r.x, r.y, r.width, width), pixel);
+    tint(frame, nano::rect<int>(r.x, r.y + r.height - width, r.width, width), pixel);
+    tint(frame, nano::rect<int>(r.x, r.y + width, width, r.height - 2 * width), pixel);
+    tint(frame, nano::rect<int>(r.x + r.width - width, r.y + width, width, r.height - 2 * width), pixel);
+  }
+
+  /// draws a label with a background at the given position, in pixels.
+  void draw_label(pixel_buffer& frame, const nano::point<int>& pos, const char* text, int pixel_size) {
+    constexpr int advance = 4;
+    const int length = static_cast<int>(std::char_traits<char>::length(text));
+    const int padding = pixel_size;
+
+    tint(frame,
+        nano::rect<int>(pos.x, pos.y, (length * advance - 1) * pixel_size + 2 * padding, 5 * pixel_size + 2 * padding),
+        label_background);
+
+    for (int i = 0; i < length; i++) {
+      const glyph* g = find_glyph(text[i]);
+
+      if (!g) {
+        continue;
+      }
+
+      for (int gy = 0; gy < 5; gy++) {
+        for (int gx = 0; gx < 3; gx++) {
+          if (g->rows[static_cast<std::size_t>(gy)] & (4 >> gx)) {
+            tint(frame,
+                nano::rect<int>(pos.x + padding + (i * advance + gx) * pixel_size, pos.y + padding + gy * pixel_size,
+                    pixel_size, pixel_size),
+                label_text);
+          }
+        }
+      }
+    }
+  }
+} // namespace.
+
+debug_overlay::debug_overlay(layers l)
+    : m_layers(l) {}
+
+void debug_overlay::set_layers(layers l) {
+  std::scoped_lock<std::mutex> lock(m_mutex);
+  m_layers = l;
+}
+
+debug_overlay::layers debug_overlay::get_layers() const {
+  std::scoped_lock<std::mutex> lock(m_mutex);
+  return m_layers;
+}
+
+void debug_overlay::set_label_count(std::size_t count) {
+  std::scoped_lock<std::mutex> lock(m_mutex);
+  m_label_count = count;
+}
+
+bool debug_overlay::has_layer(layers l) const noexcept {
+  return (static_cast<std::uint8_t>(m_layers) & static_cast<std::uint8_t>(l)) != 0;
+}
+
+//
+// MARK: - reporting -
+//
+
+void debug_overlay::begin_frame(const nano::size<int>& size) {
+  std::scoped_lock<std::mutex> lock(m_mutex);
+  m_current.size = nano::size<int>(std::max(size.width, 0), std::max(size.height, 0));
+  m_current.overdraw.assign(
+      static_cast<std::size_t>(m_current.size.width) * static_cast<std::size_t>(m_current.size.height), 0);
+  m_current.repaint.clear();
+  m_current.times.clear();
+}
+
+void debug_overlay::add_repaint(const nano::rect<int>& rect) {
+  std::scoped_lock<std::mutex> lock(m_mutex);
+  m_current.repaint.add(rect);
+}
+
+void debug_overlay::add_draw(const nano::rect<int>& rect) {
+  std::scoped_lock<std::mutex> lock(m_mutex);
+  const nano::rect<int> r
+      = get_intersection(rect, nano::rect<int>(0, 0, m_current.size.width, m_current.size.height));
+
+  if (is_empty(r)) {
+    return;
+  }
+
+  for (int y = r.y; y < r.y + r.height; y++) {
+    std::uint8_t* row = m_current.overdraw.data() + static_cast<std::size_t>(y * m_current.size.width);
+    for (int x = r.x; x < r.x + r.width; x++) {
+      row[x] = static_cast<std::uint8_t>(std::min(row[x] + 1, 255));
+    }
+  }
+}
+
+void debug_overlay::add_draw_time(const view* v, const nano::rect<int>& frame, double ms) {
+  std::scoped_lock<std::mutex> lock(m_mutex);
+  m_current.times.push_back(view_time{ v, frame, ms });
+}
+
+void debug_overlay::end_frame() {
+  std::scoped_lock<std::mutex> lock(m_mutex);
+
+  std::stable_sort(m_current.times.begin(), m_current.times.end(),
+      [](const view_time& a, const view_time& b) { return a.ms > b.ms; });
+
+  // The flashes fade out with time, the frames can be far apart.
+  const clock_type::time_point now = clock_type::now();
+  m_flashes.erase(std::remove_if(m_flashes.begin(), m_flashes.end(),
+                      [now](const flash& f) { return now - f.time >= flash_duration; }),
+      m_flashes.end());
+
+  for (const nano::rect<int>& r : m_current.repaint.get_rects()) {
+    m_flashes.push_back(flash{ r, now });
+  }
+
+  std::swap(m_last, m_current);
+  m_frame_count++;
+}
+
+//
+// MARK: - last frame -
+//
+
+std::uint64_t debug_overlay::get_frame_count() const {
+  std::scoped_lock<std::mutex> lock(m_mutex);
+  return m_frame_count;
+}
+
+std::uint8_t debug_overlay::get_overdraw(int x, int y) const {
+  std::scoped_lock<std::mutex> lock(m_mutex);
+
+  if (x < 0 || y < 0 || x >= m_last.size.width || y >= m_last.size.height) {
+    return 0;
+  }
+
+  return m_last.overdraw[static_cast<std::size_t>(y * m_last.size.width + x)];
+}
+
+std::size_t debug_overlay::get_overdraw_area(int count) const {
+  std::scoped_lock<std::mutex> lock(m_mutex);
+  return static_cast<std::size_t>(std::count_if(
+      m_last.overdraw.begin(), m_last.overdraw.end(), [count](std::uint8_t c) { return c >= count; }));
+}
+
+region debug_overlay::get_repaint() const {
+  std::scoped_lock<std::mutex> lock(m_mutex);
+  return m_last.repaint;
+}
+
+std::vector<debug_overlay::view_time> debug_overlay::get_slowest_views() const {
+  std::scoped_lock<std::mutex> lock(m_mutex);
+  return m_last.times;
+}
+
+bool debug_overlay::is_animating(clock_type::time_point now) const {
+  std::scoped_lock<std::mutex> lock(m_mutex);
+  return has_layer(layers::repaint) && std::any_of(m_flashes.begin(), m_flashes.end(), [now](const flash& f) {
+    return now - f.time < flash_duration;
+  });
+}
+
+void debug_overlay::compose(pixel_buffer& frame, float scale, clock_type::time_point now) const {
+  std::scoped_lock<std::mutex> lock(m_mutex);
+
+  if (has_layer(layers::overdraw)) {
+    // Runs of points with the same count are tinted at once.
+    for (int y = 0; y < m_last.size.height; y++) {
+      const std::uint8_t* row = m_last.overdraw.data() + static_cast<std::size_t>(y * m_last.size.width);
+
+      for (int x = 0; x < m_last.size.width;) {
+        const int count = std::min<int>(row[x], 5);
+        int end = x + 1;
+        while (end < m_last.size.width && std::min<int>(row[end], 5) == count) {
+          end++;
+        }
+
+        if (count >= 2) {
+          tint(frame, to_pixels(nano::rect<int>(x, y, end - x, 1), scale),
+              overdraw_tints[static_cast<std::size_t>(count - 2)]);
+        }
+
+        x = end;
+      }
+    }
+  }
+
+  if (has_layer(layers::repaint)) {
+    using ms_duration = std::chrono::duration<double, std::milli>;
+    const double duration = ms_duration(flash_duration).count();
+
+    for (const flash& f : m_flashes) {
+      const double age = std::max(ms_duration(now - f.time).count(), 0.0);
+      if (age < duration) {
+        const std::uint32_t alpha = static_cast<std::uint32_t>(110.0 * (duration - age) / duration);
+        tint(frame, to_pixels(f.rect, scale), make_tint(255, 210, 0, alpha));
+      }
+    }
+  }
+
+  if (has_layer(layers::slow_views)) {
+    const int line_width = std::max(1, static_cast<int>(std::lround(scale)));
+    const int pixel_size = std::max(1, static_cast<int>(std::lround(2.0f * scale)));
+    const std::size_t count = std::min(m_label_count, m_last.times.size());
+
+    for (std::size_t i = 0; i < count; i++) {
+      const view_time& t = m_last.times[i];
+      const nano::rect<int> r = to_pixels(t.frame, scale);
+      outline(frame, r, line_width, outline_pixel);
+
+      char text[32];
+      std::snprintf(text, sizeof(text), "#%zu %.1fms", i + 1, t.ms);
+      draw_label(frame, nano::point<int>(r.x + line_width, r.y + line_width), text, pixel_size);
+    }
+  }
+}
+
+bool debug_overlay::write_png(const pixel_buffer& frame, float scale, const std::string& path) const {
+  pixel_buffer copy = frame;
+  compose(copy, scale);
+  return nano::write_png(copy, path);
+}
+} // namespace nano.
+
+NANO_CLANG_DIAGNOSTIC_POP()
@@ -0,0 +1,170 @@
+/*
+ * Nano Library
+ *
+ * Copyright (C) 2022, Meta-Sonic
+ * All rights reserved.
+ *
+ * Proprietary and confidential.
+ * Any unauthorized copying, alteration, distribution, transmission, performance,
+ * display or other use of this material is strictly prohibited.
+ *
+ * Written by Alexandre Arsenault <alx.arsenault@gmail.com>
+ */
+
+#pragma once
+
+/*!
+ * @file      nano/ui/debug_overlay.h
+ * @brief     nano ui repaint and overdraw debug overlay
+ * @copyright Copyright (C) 2022, Meta-Sonic
+ * @author    Alexandre Arsenault alx.arsenault@gmail.com
+ * @date      Created 16/06/2022
+ */
+
+#include <nano/ui.h>
+#include <nano/ui/pixel_buffer.h>
+#include <nano/ui/region.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+NANO_CLANG_DIAGNOSTIC_PUSH()
+NANO_CLANG_DIAGNOSTIC(warning, "-Weverything")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wc++98-compat")
+
+namespace nano {
+
+/// debugging aid showing what is drawn in each frame.
+///
+/// @details attached to a compositor or a headless surface, it receives the
+///          repainted area, the area written by each view and the time spent
+///          in each view's on_draw() for every frame. compose() draws it over
+///          a frame:
+///          - repaint: repainted areas flash in yellow and fade out over
+///            flash_duration, whether or not other frames are drawn.
+///          - overdraw: points written twice are blue, three times green, four
+///            times pink and five times or more red.
+///          - slow views: the views with the longest on_draw() are outlined in
+///            red and labeled with their rank and time in milliseconds.
+///
+///          coordinates are in root view points. frames can be reported and
+///          composed from any thread.
+class debug_overlay {
+public:
+  enum class layers : std::uint8_t {
+    none = 0,
+    repaint = 1 << 0,
+    overdraw = 1 << 1,
+    slow_views = 1 << 2,
+    all = repaint | overdraw | slow_views
+  };
+
+  struct view_time {
+    const view* v;
+    nano::rect<int> frame;
+    double ms;
+  };
+
+  using clock_type = std::chrono::steady_clock;
+
+  static constexpr std::chrono::milliseconds flash_duration = std::chrono::milliseconds(100);
+
+  debug_overlay(layers l = layers::all);
+
+  debug_overlay(const debug_overlay&) = delete;
+  debug_overlay(debug_overlay&&) = delete;
+
+  ~debug_overlay() = default;
+
+  debug_overlay& operator=(const debug_overlay&) = delete;
+  debug_overlay& operator=(debug_overlay&&) = delete;
+
+  /// when disabled, frames are neither reported nor composed.
+  inline void set_enabled(bool enabled) noexcept { m_enabled = enabled; }
+
+  inline bool is_enabled() const noexcept { return m_enabled; }
+
+  void set_layers(layers l);
+
+  layers get_layers() const;
+
+  /// sets the number of slow views that are labeled.
+  void set_label_count(std::size_t count);
+
+  // MARK: reporting
+
+  void begin_frame(const nano::size<int>& size);
+
+  void add_repaint(const nano::rect<int>& rect);
+
+  /// adds one write of every point of the rect.
+  void add_draw(const nano::rect<int>& rect);
+
+  /// @param frame the view's frame in root view coordinates.
+  void add_draw_time(const view* v, const nano::rect<int>& frame, double ms);
+
+  void end_frame();
+
+  // MARK: last frame
+
+  std::uint64_t get_frame_count() const;
+
+  /// returns the number of times the point was written in the last frame.
+  std::uint8_t get_overdraw(int x, int y) const;
+
+  /// returns the number of points written at least count times in the last frame.
+  std::size_t get_overdraw_area(int count) const;
+
+  region get_repaint() const;
+
+  /// returns the slowest views of the last frame, slowest first.
+  std::vector<view_time> get_slowest_views() const;
+
+  /// returns true while a repaint flash is fading out, the frame changes without being reported.
+  bool is_animating(clock_type::time_point now = clock_type::now()) const;
+
+  /// draws the enabled layers over the frame.
+  /// @param scale the number of frame pixels per point.
+  /// @param now the time the repaint flashes are faded at.
+  void compose(pixel_buffer& frame, float scale, clock_type::time_point now = clock_type::now()) const;
+
+  /// composes the overlay over a copy of the frame and writes it as a png file.
+  bool write_png(const pixel_buffer& frame, float scale, const std::string& path) const;
+
+private:
+  struct frame_data {
+    nano::size<int> size = { 0, 0 };
+    std::vector<std::uint8_t> overdraw;
+    region repaint;
+    std::vector<view_time> times;
+  };
+
+  struct flash {
+    nano::rect<int> rect;
+    clock_type::time_point time;
+  };
+
+  std::atomic<bool> m_enabled = true;
+  mutable std::mutex m_mutex;
+  layers m_layers;
+  std::size_t m_label_count = 5;
+
+  // Frame being reported.
+  frame_data m_current;
+
+  // Last complete frame.
+  frame_data m_last;
+  std::vector<flash> m_flashes;
+  std::uint64_t m_frame_count = 0;
+
+  bool has_layer(layers l) const noexcept;
+};
+
+NANO_ENUM_CLASS_FLAGS(debug_overlay::layers)
+} // namespace nano.
+
+NANO_CLANG_DIAGNOSTIC_POP()
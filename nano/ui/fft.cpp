@@ -0,0 +1,280 @@
+/*
+ * Nano Library
+ *
+ * Copyright (C) 2022, Meta-Sonic
+ * All rights reserved.
+ *
+ * Proprietary and confidential.
+ * Any unauthorized copying, alteration, distribution, transmission, performance,
+ * display or other use of this material is strictly prohibited.
+ *
+ * Written by Alexandre Arsenault <alx.arsenault@gmail.com>
+ */
+
+#include <nano/ui/fft.h>
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+NANO_CLANG_DIAGNOSTIC_PUSH()
+NANO_CLANG_DIAGNOSTIC(warning, "-Weverything")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wc++98-compat")
+
+namespace nano {
+
+namespace {
+  constexpr double pi = 3.14159265358979323846;
+
+  /// butterflies of count pairs, a = a + w * b and b = a - w * b.
+  inline void butterflies(float* ar, float* ai, float* br, float* bi, const float* wr, const float* wi,
+      std::size_t count) noexcept {
+    std::size_t k = 0;
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+    for (; k + 4 <= count; k += 4) {
+      const float32x4_t xr = vld1q_f32(br + k);
+      const float32x4_t xi = vld1q_f32(bi + k);
+      const float32x4_t cr = vld1q_f32(wr + k);
+      const float32x4_t ci = vld1q_f32(wi + k);
+      const float32x4_t tr = vmlsq_f32(vmulq_f32(xr, cr), xi, ci);
+      const float32x4_t ti = vmlaq_f32(vmulq_f32(xr, ci), xi, cr);
+      const float32x4_t yr = vld1q_f32(ar + k);
+      const float32x4_t yi = vld1q_f32(ai + k);
+      vst1q_f32(ar + k, vaddq_f32(yr, tr));
+      vst1q_f32(ai + k, vaddq_f32(yi, ti));
+      vst1q_f32(br + k, vsubq_f32(yr, tr));
+      vst1q_f32(bi + k, vsubq_f32(yi, ti));
+    }
+#elif defined(__SSE2__) || defined(_M_X64)
+    for (; k + 4 <= count; k += 4) {
+      const __m128 xr = _mm_loadu_ps(br + k);
+      const __m128 xi = _mm_loadu_ps(bi + k);
+      const __m128 cr = _mm_loadu_ps(wr + k);
+      const __m128 ci = _mm_loadu_ps(wi + k);
+      const __m128 tr = _mm_sub_ps(_mm_mul_ps(xr, cr), _mm_mul_ps(xi, ci));
+      const __m128 ti = _mm_add_ps(_mm_mul_ps(xr, ci), _mm_mul_ps(xi, cr));
+      const __m128 yr = _mm_loadu_ps(ar + k);
+      const __m128 yi = _mm_loadu_ps(ai + k);
+      _mm_storeu_ps(ar + k, _mm_add_ps(yr, tr));
+      _mm_storeu_ps(ai + k, _mm_add_ps(yi, ti));
+      _mm_storeu_ps(br + k, _mm_sub_ps(yr, tr));
+      _mm_storeu_ps(bi + k, _mm_sub_ps(yi, ti));
+    }
+#endif
+
+    for (; k < count; k++) {
+      const float tr = br[k] * wr[k] - bi[k] * wi[k];
+      const float ti = br[k] * wi[k] + bi[k] * wr[k];
+      br[k] = ar[k] - tr;
+      bi[k] = ai[k] - ti;
+      ar[k] += tr;
+      ai[k] += ti;
+    }
+  }
+} // namespace.
+
+real_fft::real_fft(std::size_t size)
+    : m_size(size) {
+  const std::size_t half = size / 2;
+
+  std::size_t bits = 0;
+  while ((std::size_t(1) << bits) < half) {
+    bits++;
+  }
+
+  m_bit_reverse.resize(half);
+  for (std::size_t i = 0; i < half; i++) {
+    std::uint32_t r = 0;
+    for (std::size_t b = 0; b < bits; b++) {
+      r |= static_cast<std::uint32_t>(((i >> b) & 1) << (bits - 1 - b));
+    }
+    m_bit_reverse[i] = r;
+  }
+
+  m_twiddle_real.resize(half);
+  m_twiddle_imag.resize(half);
+  for (std::size_t h = 1; h < half; h *= 2) {
+    for (std::size_t k = 0; k < h; k++) {
+      const double angle = -pi * static_cast<double>(k) / static_cast<double>(h);
+      m_twiddle_real[h - 1 + k] = static_cast<float>(std::cos(angle));
+      m_twiddle_imag[h - 1 + k] = static_cast<float>(std::sin(angle));
+    }
+  }
+
+  // Twiddles of the split of the half size transform into the real spectrum.
+  m_split_real.resize(half + 1);
+  m_split_imag.resize(half + 1);
+  for (std::size_t k = 0; k <= half; k++) {
+    const double angle = -2.0 * pi * static_cast<double>(k) / static_cast<double>(size);
+    m_split_real[k] = static_cast<float>(std::cos(angle));
+    m_split_imag[k] = static_cast<float>(std::sin(angle));
+  }
+
+  m_real.resize(half);
+  m_imag.resize(half);
+}
+
+void real_fft::forward(const float* input, float* real, float* imag) noexcept {
+  const std::size_t half = m_size / 2;
+  float* zr = m_real.data();
+  float* zi = m_imag.data();
+
+  // The even samples are the real part and the odd ones the imaginary part.
+  for (std::size_t i = 0; i < half; i++) {
+    const std::uint32_t r = m_bit_reverse[i];
+    zr[r] = input[2 * i];
+    zi[r] = input[2 * i + 1];
+  }
+
+  // The first two stages have trivial twiddles and too few butterflies per group to be vectorized.
+  for (std::size_t j = 0; j < half; j += 2) {
+    const float ar = zr[j];
+    const float ai = zi[j];
+    zr[j] = ar + zr[j + 1];
+    zi[j] = ai + zi[j + 1];
+    zr[j + 1] = ar - zr[j + 1];
+    zi[j + 1] = ai - zi[j + 1];
+  }
+
+  for (std::size_t j = 0; j < half; j += 4) {
+    float ar = zr[j];
+    float ai = zi[j];
+    zr[j] = ar + zr[j + 2];
+    zi[j] = ai + zi[j + 2];
+    zr[j + 2] = ar - zr[j + 2];
+    zi[j + 2] = ai - zi[j + 2];
+
+    // w = -i.
+    ar = zr[j + 1];
+    ai = zi[j + 1];
+    const float tr = zi[j + 3];
+    const float ti = -zr[j + 3];
+    zr[j + 1] = ar + tr;
+    zi[j + 1] = ai + ti;
+    zr[j + 3] = ar - tr;
+    zi[j + 3] = ai - ti;
+  }
+
+  for (std::size_t h = 4; h < half; h *= 2) {
+    const float* wr = m_twiddle_real.data() + h - 1;
+    const float* wi = m_twiddle_imag.data() + h - 1;
+
+    for (std::size_t j = 0; j < half; j += 2 * h) {
+      butterflies(zr + j, zi + j, zr + j + h, zi + j + h, wr, wi, h);
+    }
+  }
+
+  // X[k] = E[k] + w^k O[k], with E and O the transforms of the even and odd samples:
+  // E[k] = (Z[k] + conj(Z[half - k])) / 2 and O[k] = -i (Z[k] - conj(Z[half - k])) / 2.
+  for (std::size_t k = 0; k <= half; k++) {
+    const std::size_t a = k == half ? 0 : k;
+    const std::size_t b = k == 0 ? 0 : half - k;
+
+    const float er = 0.5f * (zr[a] + zr[b]);
+    const float ei = 0.5f * (zi[a] - zi[b]);
+    const float or_ = 0.5f * (zi[a] + zi[b]);
+    const float oi = -0.5f * (zr[a] - zr[b]);
+
+    real[k] = er + m_split_real[k] * or_ - m_split_imag[k] * oi;
+    imag[k] = ei + m_split_real[k] * oi + m_split_imag[k] * or_;
+  }
+}
+
+std::vector<float> make_hann_window(std::size_t size) {
+  std::vector<float> window(size);
+  for (std::size_t i = 0; i < size; i++) {
+    window[i] = static_cast<float>(0.5 - 0.5 * std::cos(2.0 * pi * static_cast<double>(i) / static_cast<double>(size)));
+  }
+
+  return window;
+}
+
+void apply_window(const float* src, const float* window, float* dst, std::size_t count) noexcept {
+  std::size_t i = 0;
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+  for (; i + 4 <= count; i += 4) {
+    vst1q_f32(dst + i, vmulq_f32(vld1q_f32(src + i), vld1q_f32(window + i)));
+  }
+#elif defined(__SSE2__) || defined(_M_X64)
+  for (; i + 4 <= count; i += 4) {
+    _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_loadu_ps(src + i), _mm_loadu_ps(window + i)));
+  }
+#endif
+
+  for (; i < count; i++) {
+    dst[i] = src[i] * window[i];
+  }
+}
+
+void get_power(const float* real, const float* imag, float* dst, std::size_t count, float scale) noexcept {
+  std::size_t i = 0;
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+  const float32x4_t s = vdupq_n_f32(scale);
+  for (; i + 4 <= count; i += 4) {
+    const float32x4_t r = vld1q_f32(real + i);
+    const float32x4_t m = vld1q_f32(imag + i);
+    vst1q_f32(dst + i, vmulq_f32(vmlaq_f32(vmulq_f32(r, r), m, m), s));
+  }
+#elif defined(__SSE2__) || defined(_M_X64)
+  const __m128 s = _mm_set1_ps(scale);
+  for (; i + 4 <= count; i += 4) {
+    const __m128 r = _mm_loadu_ps(real + i);
+    const __m128 m = _mm_loadu_ps(imag + i);
+    _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_add_ps(_mm_mul_ps(r, r), _mm_mul_ps(m, m)), s));
+  }
+#endif
+
+  for (; i < count; i++) {
+    dst[i] = (real[i] * real[i] + imag[i] * imag[i]) * scale;
+  }
+}
+
+float get_max(const float* values, std::size_t count) noexcept {
+  if (count == 0) {
+    return 0.0f;
+  }
+
+  float result = values[0];
+  std::size_t i = 0;
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+  if (count >= 4) {
+    float32x4_t m = vld1q_f32(values);
+    for (i = 4; i + 4 <= count; i += 4) {
+      m = vmaxq_f32(m, vld1q_f32(values + i));
+    }
+
+    float lanes[4];
+    vst1q_f32(lanes, m);
+    result = std::max(std::max(lanes[0], lanes[1]), std::max(lanes[2], lanes[3]));
+  }
+#elif defined(__SSE2__) || defined(_M_X64)
+  if (count >= 4) {
+    __m128 m = _mm_loadu_ps(values);
+    for (i = 4; i + 4 <= count; i += 4) {
+      m = _mm_max_ps(m, _mm_loadu_ps(values + i));
+    }
+
+    float lanes[4];
+    _mm_storeu_ps(lanes, m);
+    result = std::max(std::max(lanes[0], lanes[1]), std::max(lanes[2], lanes[3]));
+  }
+#endif
+
+  for (; i < count; i++) {
+    result = std::max(result, values[i]);
+  }
+
+  return result;
+}
+} // namespace nano.
+
+NANO_CLANG_DIAGNOSTIC_POP()
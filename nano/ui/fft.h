@@ -0,0 +1,81 @@
+/*
+ * Nano Library
+ *
+ * Copyright (C) 2022, Meta-Sonic
+ * All rights reserved.
+ *
+ * Proprietary and confidential.
+ * Any unauthorized copying, alteration, distribution, transmission, performance,
+ * display or other use of this material is strictly prohibited.
+ *
+ * Written by Alexandre Arsenault <alx.arsenault@gmail.com>
+ */
+
+#pragma once
+
+/*!
+ * @file      nano/ui/fft.h
+ * @brief     nano ui real fft and spectrum helpers
+ * @copyright Copyright (C) 2022, Meta-Sonic
+ * @author    Alexandre Arsenault alx.arsenault@gmail.com
+ * @date      Created 16/06/2022
+ */
+
+#include <nano/graphics.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+NANO_CLANG_DIAGNOSTIC_PUSH()
+NANO_CLANG_DIAGNOSTIC(warning, "-Weverything")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wc++98-compat")
+
+namespace nano {
+
+/// forward fft of a real signal.
+///
+/// @details the signal is transformed as a complex signal of half the size,
+///          stored as separate real and imaginary arrays so that the
+///          butterflies of every stage but the first two are vectorized.
+///          an instance holds its scratch buffers and must not be shared
+///          between threads.
+class real_fft {
+public:
+  /// @param size a power of two, at least 8.
+  real_fft(std::size_t size);
+
+  inline std::size_t get_size() const noexcept { return m_size; }
+
+  /// returns the number of bins, size / 2 + 1.
+  inline std::size_t get_bin_count() const noexcept { return m_size / 2 + 1; }
+
+  /// computes the bins of size samples, without scaling.
+  void forward(const float* input, float* real, float* imag) noexcept;
+
+private:
+  std::size_t m_size;
+  std::vector<std::uint32_t> m_bit_reverse;
+  /// the twiddles of the stage of half size h start at h - 1.
+  std::vector<float> m_twiddle_real;
+  std::vector<float> m_twiddle_imag;
+  std::vector<float> m_split_real;
+  std::vector<float> m_split_imag;
+  std::vector<float> m_real;
+  std::vector<float> m_imag;
+};
+
+/// returns a hann window of size samples.
+std::vector<float> make_hann_window(std::size_t size);
+
+/// dst[i] = src[i] * window[i].
+void apply_window(const float* src, const float* window, float* dst, std::size_t count) noexcept;
+
+/// dst[i] = (real[i]^2 + imag[i]^2) * scale.
+void get_power(const float* real, const float* imag, float* dst, std::size_t count, float scale) noexcept;
+
+/// returns the largest of count values.
+float get_max(const float* values, std::size_t count) noexcept;
+} // namespace nano.
+
+NANO_CLANG_DIAGNOSTIC_POP()
@@ -0,0 +1,438 @@
+/*
+ * Nano Library
+ *
+ * Copyright (C) 2022, Meta-Sonic
+ * All rights reserved.
+ *
+ * Proprietary and confidential.
+ * Any unauthorized copying, alteration, distribution, transmission, performance,
+ * display or other use of this material is strictly prohibited.
+ *
+ * Written by Alexandre Arsenault <alx.arsenault@gmail.com>
+ */
+
+#include <nano/ui/filmstrip.h>
+#include <nano/ui/region.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+
+NANO_CLANG_DIAGNOSTIC_PUSH()
+NANO_CLANG_DIAGNOSTIC(warning, "-Weverything")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wc++98-compat")
+
+namespace nano {
+
+namespace {
+  inline std::uint32_t float_bits(float value) noexcept {
+    std::uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+  }
+
+  struct filter_tap {
+    int index;
+    float weight;
+  };
+
+  /// the source pixels contributing to each destination pixel of a row or column.
+  /// @details pixels are averaged over their area when reducing and interpolated when enlarging.
+  std::vector<std::vector<filter_tap>> make_filter(int src_size, int dst_size) {
+    const float ratio = static_cast<float>(src_size) / static_cast<float>(dst_size);
+    std::vector<std::vector<filter_tap>> filter(static_cast<std::size_t>(dst_size));
+
+    for (int i = 0; i < dst_size; i++) {
+      std::vector<filter_tap>& taps = filter[static_cast<std::size_t>(i)];
+
+      if (ratio >= 1.0f) {
+        const float begin = static_cast<float>(i) * ratio;
+        const float end = begin + ratio;
+        const int last = std::min(static_cast<int>(std::ceil(end)), src_size);
+
+        for (int s = static_cast<int>(begin); s < last; s++) {
+          const float w = std::min(end, static_cast<float>(s + 1)) - std::max(begin, static_cast<float>(s));
+          if (w > 0.0f) {
+            taps.push_back(filter_tap{ s, w / ratio });
+          }
+        }
+      }
+      else {
+        const float center = (static_cast<float>(i) + 0.5f) * ratio - 0.5f;
+        const int s = static_cast<int>(std::floor(center));
+        const float t = center - static_cast<float>(s);
+        taps.push_back(filter_tap{ std::clamp(s, 0, src_size - 1), 1.0f - t });
+        taps.push_back(filter_tap{ std::clamp(s + 1, 0, src_size - 1), t });
+      }
+    }
+
+    return filter;
+  }
+
+  inline std::uint8_t to_component(float value) noexcept {
+    return static_cast<std::uint8_t>(std::clamp(std::lround(value), 0L, 255L));
+  }
+
+  /// resamples a rect of the image, the pixels being premultiplied they are filtered as is.
+  pixel_buffer resample(const pixel_buffer& image, const nano::rect<int>& rect, const nano::size<int>& size) {
+    pixel_buffer dst(size.width, size.height);
+
+    if (size == rect.size) {
+      dst.copy_from(image, rect, nano::point<int>(0, 0));
+      return dst;
+    }
+
+    const std::vector<std::vector<filter_tap>> h_filter = make_filter(rect.width, size.width);
+    const std::vector<std::vector<filter_tap>> v_filter = make_filter(rect.height, size.height);
+
+    // Horizontal pass into the source rows, then vertical pass into the frame.
+    using components = std::array<float, 4>;
+    std::vector<components> rows(static_cast<std::size_t>(rect.height * size.width));
+
+    for (int y = 0; y < rect.height; y++) {
+      const pixel_buffer::pixel_type* src = image.row(rect.y + y) + rect.x;
+      components* row = rows.data() + static_cast<std::size_t>(y * size.width);
+
+      for (int x = 0; x < size.width; x++) {
+        components c = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+        for (const filter_tap& tap : h_filter[static_cast<std::size_t>(x)]) {
+          const std::uint32_t p = src[tap.index];
+          c[0] += tap.weight * static_cast<float>(get_pixel_red(p));
+          c[1] += tap.weight * static_cast<float>(get_pixel_green(p));
+          c[2] += tap.weight * static_cast<float>(get_pixel_blue(p));
+          c[3] += tap.weight * static_cast<float>(get_pixel_alpha(p));
+        }
+
+        row[x] = c;
+      }
+    }
+
+    for (int y = 0; y < size.height; y++) {
+      pixel_buffer::pixel_type* out = dst.row(y);
+
+      for (int x = 0; x < size.width; x++) {
+        components c = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+        for (const filter_tap& tap : v_filter[static_cast<std::size_t>(y)]) {
+          const components& s = rows[static_cast<std::size_t>(tap.index * size.width + x)];
+          for (std::size_t k = 0; k < 4; k++) {
+            c[k] += tap.weight * s[k];
+          }
+        }
+
+        // A premultiplied component can't exceed the alpha.
+        const std::uint8_t a = to_component(c[3]);
+        out[x] = make_pixel(std::min(to_component(c[0]), a), std::min(to_component(c[1]), a),
+            std::min(to_component(c[2]), a), a);
+      }
+    }
+
+    return dst;
+  }
+} // namespace.
+
+//
+// MARK: - sprite_sheet -
+//
+
+std::size_t sprite_sheet::get_byte_size() const noexcept {
+  std::size_t size = sizeof(sprite_sheet);
+  for (const pixel_buffer& frame : frames) {
+    size += frame.get_byte_size();
+  }
+
+  return size;
+}
+
+sprite_sheet make_sprite_sheet(const pixel_buffer& image, const sprite_asset& asset, float scale) {
+  sprite_sheet sheet;
+  sheet.scale = scale;
+
+  if (image.empty() || asset.frame_count <= 0 || asset.scale <= 0.0f || scale <= 0.0f) {
+    return sheet;
+  }
+
+  const bool vertical = asset.orientation == filmstrip_orientation::vertical;
+  const nano::size<int> frame_pixels = vertical
+      ? nano::size<int>(image.get_width(), image.get_height() / asset.frame_count)
+      : nano::size<int>(image.get_width() / asset.frame_count, image.get_height());
+
+  if (frame_pixels.width <= 0 || frame_pixels.height <= 0) {
+    return sheet;
+  }
+
+  sheet.frame_size = nano::size<float>(static_cast<float>(frame_pixels.width) / asset.scale,
+      static_cast<float>(frame_pixels.height) / asset.scale);
+
+  const nano::size<int> size(std::max(static_cast<int>(std::lround(sheet.frame_size.width * scale)), 1),
+      std::max(static_cast<int>(std::lround(sheet.frame_size.height * scale)), 1));
+
+  sheet.frames.reserve(static_cast<std::size_t>(asset.frame_count));
+
+  for (int i = 0; i < asset.frame_count; i++) {
+    const nano::point<int> position
+        = vertical ? nano::point<int>(0, i * frame_pixels.height) : nano::point<int>(i * frame_pixels.width, 0);
+    sheet.frames.push_back(resample(image, nano::rect<int>(position, frame_pixels), size));
+  }
+
+  return sheet;
+}
+
+//
+// MARK: - sprite_cache -
+//
+
+std::size_t sprite_cache::key_hash::operator()(const key& k) const noexcept {
+  std::size_t h = std::hash<std::string>()(k.path);
+  h ^= static_cast<std::size_t>(k.frame_count) * 73856093u;
+  h ^= static_cast<std::size_t>(k.orientation) * 19349663u;
+  h ^= static_cast<std::size_t>(float_bits(k.asset_scale)) * 83492791u;
+  h ^= static_cast<std::size_t>(float_bits(k.scale)) * 2654435761u;
+  return h;
+}
+
+sprite_cache::sprite_cache(std::size_t capacity)
+    : m_capacity(capacity) {}
+
+sprite_cache& sprite_cache::get_main() {
+  NANO_CLANG_PUSH_WARNING("-Wexit-time-destructors")
+  static sprite_cache cache;
+  NANO_CLANG_POP_WARNING()
+  return cache;
+}
+
+void sprite_cache::add_image(const std::string& path, pixel_buffer image) {
+  m_images[path] = std::move(image);
+
+  for (auto it = m_entries.begin(); it != m_entries.end();) {
+    auto next = std::next(it);
+    if (it->k.path == path) {
+      erase(it);
+    }
+
+    it = next;
+  }
+}
+
+std::shared_ptr<const sprite_sheet> sprite_cache::get(const sprite_asset& asset, float scale) {
+  key k{ asset.path, asset.frame_count, asset.orientation, asset.scale, scale };
+
+  if (auto it = m_index.find(k); it != m_index.end()) {
+    m_stats.hits++;
+    m_entries.splice(m_entries.begin(), m_entries, it->second);
+    return it->second->sheet;
+  }
+
+  m_stats.misses++;
+
+  std::shared_ptr<const sprite_sheet> sheet;
+
+  if (auto it = m_images.find(asset.path); it != m_images.end()) {
+    sheet = std::make_shared<const sprite_sheet>(make_sprite_sheet(it->second, asset, scale));
+  }
+  else {
+    pixel_buffer image;
+    if (!read_png(image, asset.path)) {
+      image = pixel_buffer();
+    }
+
+    sheet = std::make_shared<const sprite_sheet>(make_sprite_sheet(image, asset, scale));
+  }
+
+  const std::size_t byte_size = sheet->get_byte_size();
+  if (byte_size > m_capacity) {
+    return sheet;
+  }
+
+  evict(m_capacity - byte_size);
+
+  m_entries.push_front(entry{ k, sheet });
+  m_index.emplace(std::move(k), m_entries.begin());
+  m_byte_size += byte_size;
+  return sheet;
+}
+
+void sprite_cache::set_capacity(std::size_t capacity) {
+  m_capacity = capacity;
+  evict(capacity);
+}
+
+void sprite_cache::clear() {
+  m_entries.clear();
+  m_index.clear();
+  m_byte_size = 0;
+}
+
+sprite_cache::stats sprite_cache::get_stats() const noexcept {
+  stats s = m_stats;
+  s.entry_count = m_entries.size();
+  s.byte_size = m_byte_size;
+  return s;
+}
+
+void sprite_cache::reset_stats() noexcept { m_stats = stats(); }
+
+void sprite_cache::evict(std::size_t capacity) {
+  while (m_byte_size > capacity && !m_entries.empty()) {
+    erase(std::prev(m_entries.end()));
+    m_stats.evictions++;
+  }
+}
+
+void sprite_cache::erase(entry_list::iterator it) {
+  m_byte_size -= it->sheet->get_byte_size();
+  m_index.erase(it->k);
+  m_entries.erase(it);
+}
+
+//
+// MARK: - draw_sprite -
+//
+
+void draw_sprite(pixel_buffer& buffer, const sprite_sheet& sheet, int frame, const nano::point<int>& pos) {
+  if (frame < 0 || frame >= static_cast<int>(sheet.frames.size())) {
+    return;
+  }
+
+  const pixel_buffer& src = sheet.frames[static_cast<std::size_t>(frame)];
+  const nano::rect<int> r = get_intersection(nano::rect<int>(pos, src.get_size()), buffer.get_bounds());
+
+  if (is_empty(r)) {
+    return;
+  }
+
+  for (int y = r.y; y < r.y + r.height; y++) {
+    const pixel_buffer::pixel_type* s = src.row(y - pos.y) + (r.x - pos.x);
+    pixel_buffer::pixel_type* d = buffer.row(y) + r.x;
+
+    for (int x = 0; x < r.width; x++) {
+      // Most pixels of a control are either transparent or opaque.
+      const std::uint8_t alpha = get_pixel_alpha(s[x]);
+      if (alpha == 255) {
+        d[x] = s[x];
+      }
+      else if (alpha) {
+        d[x] = blend_pixel(d[x], s[x], 255);
+      }
+    }
+  }
+}
+
+//
+// MARK: - filmstrip_control -
+//
+
+filmstrip_control::filmstrip_control(view* parent, const nano::rect<int>& rect, const sprite_asset& asset)
+    : view(parent, rect)
+    , m_asset(asset) {}
+
+void filmstrip_control::set_asset(const sprite_asset& asset) {
+  m_asset = asset;
+  m_frame_index = get_frame_index(m_value);
+  redraw();
+}
+
+bool filmstrip_control::set_value(float value) {
+  m_value = std::clamp(value, 0.0f, 1.0f);
+
+  const int frame_index = get_frame_index(m_value);
+  if (frame_index == m_frame_index) {
+    return false;
+  }
+
+  m_frame_index = frame_index;
+  redraw();
+  return true;
+}
+
+void filmstrip_control::change_value(float value) {
+  value = std::clamp(value, 0.0f, 1.0f);
+  if (value == m_value) {
+    return;
+  }
+
+  set_value(value);
+
+  if (m_callback) {
+    m_callback(m_value);
+  }
+}
+
+int filmstrip_control::get_frame_index(float value) const noexcept {
+  if (m_asset.frame_count <= 1) {
+    return 0;
+  }
+
+  return static_cast<int>(std::lround(value * static_cast<float>(m_asset.frame_count - 1)));
+}
+
+void filmstrip_control::on_draw(nano::graphic_context& gc, const nano::rect<float>& dirty_rect) {
+  NANO_UNUSED(dirty_rect);
+
+  const nano::size<int> size = get_frame().size;
+  draw_sprite(gc, m_asset, m_frame_index,
+      nano::rect<float>(0.0f, 0.0f, static_cast<float>(size.width), static_cast<float>(size.height)));
+}
+
+//
+// MARK: - filmstrip_knob -
+//
+
+filmstrip_knob::filmstrip_knob(view* parent, const nano::rect<int>& rect, const sprite_asset& asset)
+    : filmstrip_control(parent, rect, asset) {}
+
+void filmstrip_knob::begin_drag(const nano::point<float>& pos) {
+  m_drag_origin = pos;
+  m_drag_value = get_value();
+}
+
+void filmstrip_knob::drag(const nano::point<float>& pos) {
+  change_value(m_drag_value + (m_drag_origin.y - pos.y) / std::max(m_sensitivity, 1.0f));
+}
+
+void filmstrip_knob::on_mouse_down(const nano::event& evt) { begin_drag(evt.get_position()); }
+
+void filmstrip_knob::on_mouse_dragged(const nano::event& evt) { drag(evt.get_position()); }
+
+//
+// MARK: - filmstrip_slider -
+//
+
+filmstrip_slider::filmstrip_slider(view* parent, const nano::rect<int>& rect, const sprite_asset& asset, bool vertical)
+    : filmstrip_control(parent, rect, asset)
+    , m_vertical(vertical) {}
+
+float filmstrip_slider::get_value_at(const nano::point<float>& pos) const noexcept {
+  const nano::size<int> size = get_frame().size;
+
+  const float value = m_vertical ? 1.0f - pos.y / static_cast<float>(std::max(size.height, 1))
+                                 : pos.x / static_cast<float>(std::max(size.width, 1));
+  return std::clamp(value, 0.0f, 1.0f);
+}
+
+void filmstrip_slider::drag(const nano::point<float>& pos) { change_value(get_value_at(pos)); }
+
+void filmstrip_slider::on_mouse_down(const nano::event& evt) { drag(evt.get_position()); }
+
+void filmstrip_slider::on_mouse_dragged(const nano::event& evt) { drag(evt.get_position()); }
+
+//
+// MARK: - filmstrip_switch -
+//
+
+filmstrip_switch::filmstrip_switch(view* parent, const nano::rect<int>& rect, const sprite_asset& asset)
+    : filmstrip_control(parent, rect, asset) {}
+
+void filmstrip_switch::set_on(bool on) { set_value(on ? 1.0f : 0.0f); }
+
+void filmstrip_switch::toggle() { change_value(is_on() ? 0.0f : 1.0f); }
+
+void filmstrip_switch::on_mouse_down(const nano::event& evt) {
+  NANO_UNUSED(evt);
+  toggle();
+}
+} // namespace nano.
+
+NANO_CLANG_DIAGNOSTIC_POP()
@@ -0,0 +1,270 @@
+/*
+ * Nano Library
+ *
+ * Copyright (C) 2022, Meta-Sonic
+ * All rights reserved.
+ *
+ * Proprietary and confidential.
+ * Any unauthorized copying, alteration, distribution, transmission, performance,
+ * display or other use of this material is strictly prohibited.
+ *
+ * Written by Alexandre Arsenault <alx.arsenault@gmail.com>
+ */
+
+#pragma once
+
+/*!
+ * @file      nano/ui/filmstrip.h
+ * @brief     nano ui filmstrip
+ * @copyright Copyright (C) 2022, Meta-Sonic
+ * @author    Alexandre Arsenault alx.arsenault@gmail.com
+ * @date      Created 16/06/2022
+ */
+
+#include <nano/ui.h>
+#include <nano/ui/pixel_buffer.h>
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+NANO_CLANG_DIAGNOSTIC_PUSH()
+NANO_CLANG_DIAGNOSTIC(warning, "-Weverything")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wc++98-compat")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wpadded")
+
+namespace nano {
+
+enum class filmstrip_orientation : std::uint8_t { vertical, horizontal };
+
+/// an image made of frames of the same size, stacked vertically or horizontally.
+struct sprite_asset {
+  std::string path;
+  int frame_count = 1;
+  filmstrip_orientation orientation = filmstrip_orientation::vertical;
+  /// the number of image pixels per point, e.g. 2 for an @2x image.
+  float scale = 1.0f;
+};
+
+/// the frames of a filmstrip, sliced and resampled for one scale.
+struct sprite_sheet {
+  std::vector<pixel_buffer> frames;
+  /// the size of a frame in points.
+  nano::size<float> frame_size = { 0.0f, 0.0f };
+  /// the number of pixels per point of the frames.
+  float scale = 1.0f;
+
+  inline bool empty() const noexcept { return frames.empty(); }
+
+  std::size_t get_byte_size() const noexcept;
+};
+
+/// slices a decoded filmstrip into frames of scale pixels per point.
+/// @details the frames are resampled when the scale differs from the one of the asset.
+sprite_sheet make_sprite_sheet(const pixel_buffer& image, const sprite_asset& asset, float scale);
+
+/// least recently used cache of sprite sheets, keyed by asset and scale.
+///
+/// @details a filmstrip is decoded and sliced once per scale, then shared by
+///          every control drawing it. an image that could not be read gives an
+///          empty sheet, which is cached too.
+///
+///          the cache is not thread safe, get_main() is meant to be used on
+///          the main thread only.
+class sprite_cache {
+public:
+  struct stats {
+    std::uint64_t hits = 0;
+    std::uint64_t misses = 0;
+    std::uint64_t evictions = 0;
+    std::size_t entry_count = 0;
+    std::size_t byte_size = 0;
+  };
+
+  static constexpr std::size_t default_capacity = 32 * 1024 * 1024;
+
+  /// @param capacity the maximum size of the cached sheets in bytes.
+  sprite_cache(std::size_t capacity = default_capacity);
+
+  sprite_cache(const sprite_cache&) = delete;
+  sprite_cache(sprite_cache&&) = delete;
+
+  ~sprite_cache() = default;
+
+  sprite_cache& operator=(const sprite_cache&) = delete;
+  sprite_cache& operator=(sprite_cache&&) = delete;
+
+  static sprite_cache& get_main();
+
+  /// registers a decoded image for a path, it is used instead of reading the file (e.g. embedded assets).
+  /// @details the sheets already made from this path are removed.
+  void add_image(const std::string& path, pixel_buffer image);
+
+  /// returns the sheet of the asset, reading and slicing it on a miss.
+  /// @param scale the number of pixels per point.
+  /// @details the returned sheet stays valid after being evicted.
+  std::shared_ptr<const sprite_sheet> get(const sprite_asset& asset, float scale);
+
+  void set_capacity(std::size_t capacity);
+
+  inline std::size_t get_capacity() const noexcept { return m_capacity; }
+
+  /// removes the sheets, the registered images are kept.
+  void clear();
+
+  stats get_stats() const noexcept;
+
+  void reset_stats() noexcept;
+
+private:
+  struct key {
+    std::string path;
+    int frame_count;
+    filmstrip_orientation orientation;
+    float asset_scale;
+    float scale;
+
+    inline bool operator==(const key& k) const noexcept {
+      return frame_count == k.frame_count && orientation == k.orientation && asset_scale == k.asset_scale
+          && scale == k.scale && path == k.path;
+    }
+  };
+
+  struct key_hash {
+    std::size_t operator()(const key& k) const noexcept;
+  };
+
+  struct entry {
+    key k;
+    std::shared_ptr<const sprite_sheet> sheet;
+  };
+
+  using entry_list = std::list<entry>;
+
+  // Most recently used first.
+  entry_list m_entries;
+  std::unordered_map<key, entry_list::iterator, key_hash> m_index;
+  std::unordered_map<std::string, pixel_buffer> m_images;
+  std::size_t m_capacity;
+  std::size_t m_byte_size = 0;
+  stats m_stats;
+
+  void evict(std::size_t capacity);
+  void erase(entry_list::iterator it);
+};
+
+/// blends a frame of the sheet at a position in pixels (source over).
+void draw_sprite(pixel_buffer& buffer, const sprite_sheet& sheet, int frame, const nano::point<int>& pos);
+
+/// draws a frame of the filmstrip in a rect, with the sheet of the main cache for the scale of the context.
+void draw_sprite(nano::graphic_context& gc, const sprite_asset& asset, int frame, const nano::rect<float>& rect);
+
+/// a control drawn with the frames of a filmstrip.
+///
+/// @details the value goes from 0 to 1 and is mapped to a frame, changing it
+///          redraws the rect of the control only when the frame changes. the
+///          frames come from the main sprite cache, they are shared by all
+///          the controls drawing the same asset.
+class filmstrip_control : public view {
+public:
+  filmstrip_control(view* parent, const nano::rect<int>& rect, const sprite_asset& asset);
+
+  ~filmstrip_control() override = default;
+
+  void set_asset(const sprite_asset& asset);
+
+  inline const sprite_asset& get_asset() const noexcept { return m_asset; }
+
+  /// sets the value without calling the callback, it is clamped to [0, 1].
+  /// @returns true if the frame changed.
+  bool set_value(float value);
+
+  inline float get_value() const noexcept { return m_value; }
+
+  inline int get_frame_index() const noexcept { return m_frame_index; }
+
+  /// sets the function called when the value is changed by the user.
+  inline void set_callback(std::function<void(float)> callback) { m_callback = std::move(callback); }
+
+protected:
+  void on_draw(nano::graphic_context& gc, const nano::rect<float>& dirty_rect) override;
+
+  /// sets the value and calls the callback if it changed.
+  void change_value(float value);
+
+private:
+  sprite_asset m_asset;
+  std::function<void(float)> m_callback;
+  float m_value = 0.0f;
+  int m_frame_index = 0;
+
+  int get_frame_index(float value) const noexcept;
+};
+
+/// a rotary knob, dragging up increases the value.
+class filmstrip_knob : public filmstrip_control {
+public:
+  filmstrip_knob(view* parent, const nano::rect<int>& rect, const sprite_asset& asset);
+
+  ~filmstrip_knob() override = default;
+
+  /// sets the drag distance in points that covers the whole range.
+  inline void set_sensitivity(float distance) noexcept { m_sensitivity = distance; }
+
+  void begin_drag(const nano::point<float>& pos);
+  void drag(const nano::point<float>& pos);
+
+protected:
+  void on_mouse_down(const nano::event& evt) override;
+  void on_mouse_dragged(const nano::event& evt) override;
+
+private:
+  nano::point<float> m_drag_origin;
+  float m_drag_value = 0.0f;
+  float m_sensitivity = 200.0f;
+};
+
+/// a linear slider, the value follows the position of the mouse.
+class filmstrip_slider : public filmstrip_control {
+public:
+  filmstrip_slider(view* parent, const nano::rect<int>& rect, const sprite_asset& asset, bool vertical = true);
+
+  ~filmstrip_slider() override = default;
+
+  /// returns the value at a position, from the bottom or the left of the control.
+  float get_value_at(const nano::point<float>& pos) const noexcept;
+
+  void drag(const nano::point<float>& pos);
+
+protected:
+  void on_mouse_down(const nano::event& evt) override;
+  void on_mouse_dragged(const nano::event& evt) override;
+
+private:
+  bool m_vertical;
+};
+
+/// an on and off switch, with the off state on the first frame and the on state on the last one.
+class filmstrip_switch : public filmstrip_control {
+public:
+  filmstrip_switch(view* parent, const nano::rect<int>& rect, const sprite_asset& asset);
+
+  ~filmstrip_switch() override = default;
+
+  inline bool is_on() const noexcept { return get_value() >= 0.5f; }
+
+  void set_on(bool on);
+
+  /// switches the state and calls the callback.
+  void toggle();
+
+protected:
+  void on_mouse_down(const nano::event& evt) override;
+};
+} // namespace nano.
+
+NANO_CLANG_DIAGNOSTIC_POP()
@@ -0,0 +1,179 @@
+/*
+ * Nano Library
+ *
+ * Copyright (C) 2022, Meta-Sonic
+ * All rights reserved.
+ *
+ * Proprietary and confidential.
+ * Any unauthorized copying, alteration, distribution, transmission, performance,
+ * display or other use of this material is strictly prohibited.
+ *
+ * Written by Alexandre Arsenault <alx.arsenault@gmail.com>
+ */
+
+#include <nano/ui/headless.h>
+
+#include <algorithm>
+#include <cmath>
+
+NANO_CLANG_DIAGNOSTIC_PUSH()
+NANO_CLANG_DIAGNOSTIC(warning, "-Weverything")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wc++98-compat")
+
+namespace nano {
+
+//
+// MARK: - headless_surface -
+//
+
+headless_surface::headless_surface(view* root, float scale)
+    : m_view(root)
+    , m_scale(scale) {}
+
+namespace {
+  /// reports the area drawn by each view, as clipped by draw_tree().
+  void add_draws(view* v, const nano::point<int>& origin, const nano::rect<int>& area,
+      const std::unordered_map<const view*, view_draw_stats>& stats, debug_overlay& overlay) {
+    if (v->is_hidden()) {
+      return;
+    }
+
+    const nano::rect<int> frame(origin, v->get_frame().size);
+    const nano::rect<int> view_area = get_intersection(area, frame);
+
+    if (is_empty(view_area)) {
+      return;
+    }
+
+    overlay.add_draw(view_area);
+
+    if (auto it = stats.find(v); it != stats.end()) {
+      overlay.add_draw_time(v, frame, it->second.total_ms);
+    }
+
+    for (view* child : v->get_children()) {
+      add_draws(child, origin + child->get_frame().position, view_area, stats, overlay);
+    }
+  }
+} // namespace.
+
+void headless_surface::render() {
+  update_size();
+  const nano::size<int> size = m_view->get_frame().size;
+  render_area(nano::rect<int>(0, 0, size.width, size.height));
+}
+
+void headless_surface::render(const nano::rect<int>& dirty_rect) {
+  if (update_size()) {
+    render();
+    return;
+  }
+
+  render_area(dirty_rect);
+}
+
+void headless_surface::render_area(const nano::rect<int>& dirty_rect) {
+  if (!m_debug_overlay || !m_debug_overlay->is_enabled()) {
+    render_tree(m_view, m_buffer, dirty_rect, m_scale, m_profiling ? &m_draw_stats : nullptr);
+    return;
+  }
+
+  // The overlay needs the draw time of this render only.
+  std::unordered_map<const view*, view_draw_stats> stats;
+  render_tree(m_view, m_buffer, dirty_rect, m_scale, &stats);
+
+  const nano::size<int> size = m_view->get_frame().size;
+  const nano::rect<int> area = get_intersection(dirty_rect, nano::rect<int>(0, 0, size.width, size.height));
+
+  m_debug_overlay->begin_frame(size);
+  m_debug_overlay->add_repaint(area);
+  add_draws(m_view, nano::point<int>(0, 0), area, stats, *m_debug_overlay);
+  m_debug_overlay->end_frame();
+
+  if (m_profiling) {
+    for (const auto& [v, s] : stats) {
+      view_draw_stats& total = m_draw_stats[v];
+      total.draw_count += s.draw_count;
+      total.total_ms += s.total_ms;
+      total.max_ms = std::max(total.max_ms, s.max_ms);
+    }
+  }
+}
+
+bool headless_surface::update_size() {
+  const nano::size<int> size = m_view->get_frame().size;
+  const int width = static_cast<int>(std::ceil(static_cast<float>(size.width) * m_scale));
+  const int height = static_cast<int>(std::ceil(static_cast<float>(size.height) * m_scale));
+
+  if (m_buffer.get_width() == width && m_buffer.get_height() == height) {
+    return false;
+  }
+
+  m_buffer.resize(width, height);
+  return true;
+}
+
+//
+// MARK: - headless_presenter -
+//
+
+void headless_presenter::present(const pixel_buffer& frame, const region& damage) {
+  std::scoped_lock<std::mutex> lock(m_mutex);
+
+  if (m_frame.get_size() != frame.get_size()) {
+    m_frame = frame;
+  }
+  else {
+    for (const nano::rect<int>& r : damage.get_rects()) {
+      m_frame.copy_from(frame, r, r.position);
+    }
+  }
+
+  m_last_damage = damage;
+  m_frame_count++;
+}
+
+pixel_buffer headless_presenter::get_frame() const {
+  std::scoped_lock<std::mutex> lock(m_mutex);
+  return m_frame;
+}
+
+region headless_presenter::get_last_damage() const {
+  std::scoped_lock<std::mutex> lock(m_mutex);
+  return m_last_damage;
+}
+
+std::uint64_t headless_presenter::get_frame_count() const {
+  std::scoped_lock<std::mutex> lock(m_mutex);
+  return m_frame_count;
+}
+
+//
+// MARK: - headless_menu -
+//
+
+void headless_menu::translate(const std::vector<menu_item>& items, const menu_diff& diff) {
+  if (diff.structure) {
+    m_items = items;
+    m_rebuild_count++;
+    return;
+  }
+
+  // Only the state of the changed items, their submenus are left as they are.
+  for (const std::vector<std::size_t>& path : diff.changed_items) {
+    const menu_item* src = find_menu_item(items, path);
+    menu_item* dst = const_cast<menu_item*>(find_menu_item(m_items, path));
+    if (!src || !dst) {
+      continue;
+    }
+
+    dst->title = src->title;
+    dst->key_equivalent = src->key_equivalent;
+    dst->enabled = src->enabled;
+    dst->checked = src->checked;
+    m_updated_item_count++;
+  }
+}
+} // namespace nano.
+
+NANO_CLANG_DIAGNOSTIC_POP()
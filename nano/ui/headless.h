@@ -0,0 +1,146 @@
+/*
+ * Nano Library
+ *
+ * Copyright (C) 2022, Meta-Sonic
+ * All rights reserved.
+ *
+ * Proprietary and confidential.
+ * Any unauthorized copying, alteration, distribution, transmission, performance,
+ * display or other use of this material is strictly prohibited.
+ *
+ * Written by Alexandre Arsenault <alx.arsenault@gmail.com>
+ */
+
+#pragma once
+
+/*!
+ * @file      nano/ui/headless.h
+ * @brief     nano ui headless backend
+ * @copyright Copyright (C) 2022, Meta-Sonic
+ * @author    Alexandre Arsenault alx.arsenault@gmail.com
+ * @date      Created 16/06/2022
+ */
+
+#include <nano/ui.h>
+#include <nano/ui/compositor.h>
+#include <nano/ui/debug_overlay.h>
+#include <nano/ui/menu.h>
+#include <nano/ui/pixel_buffer.h>
+#include <nano/ui/region.h>
+
+#include <mutex>
+#include <unordered_map>
+
+NANO_CLANG_DIAGNOSTIC_PUSH()
+NANO_CLANG_DIAGNOSTIC(warning, "-Weverything")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wc++98-compat")
+
+namespace nano {
+
+/// time spent in a view's on_will_draw() and on_draw(), children excluded.
+struct view_draw_stats {
+  std::size_t draw_count = 0;
+  double total_ms = 0;
+  double max_ms = 0;
+};
+
+/// renders a view tree into a pixel buffer without any window.
+///
+/// @details the root view is usually created with view(const nano::rect<int>&).
+///          rendering is synchronous and happens on the calling thread.
+class headless_surface {
+public:
+  headless_surface(view* root, float scale = 1.0f);
+
+  /// renders the whole view tree.
+  void render();
+
+  /// renders the part of the view tree within the rect (in root view coordinates).
+  void render(const nano::rect<int>& dirty_rect);
+
+  inline view* get_view() const noexcept { return m_view; }
+
+  inline float get_scale() const noexcept { return m_scale; }
+
+  inline const pixel_buffer& get_buffer() const noexcept { return m_buffer; }
+
+  inline pixel_buffer& get_buffer() noexcept { return m_buffer; }
+
+  /// when enabled, the draw time of each view is accumulated in get_draw_stats().
+  inline void set_profiling(bool enabled) noexcept { m_profiling = enabled; }
+
+  inline const std::unordered_map<const view*, view_draw_stats>& get_draw_stats() const noexcept {
+    return m_draw_stats;
+  }
+
+  inline void reset_draw_stats() { m_draw_stats.clear(); }
+
+  /// reports every render to the overlay.
+  /// @details the buffer is left untouched, the overlay can be drawn over a copy
+  ///          with debug_overlay::compose() or debug_overlay::write_png().
+  inline void set_debug_overlay(debug_overlay* overlay) noexcept { m_debug_overlay = overlay; }
+
+private:
+  view* m_view;
+  pixel_buffer m_buffer;
+  float m_scale;
+  bool m_profiling = false;
+  std::unordered_map<const view*, view_draw_stats> m_draw_stats;
+  debug_overlay* m_debug_overlay = nullptr;
+
+  bool update_size();
+  void render_area(const nano::rect<int>& dirty_rect);
+
+  // Platform specific.
+  static void render_tree(view* root, pixel_buffer& buffer, const nano::rect<int>& dirty_rect, float scale,
+      std::unordered_map<const view*, view_draw_stats>* stats);
+};
+
+/// compositor presenter keeping a copy of the last presented frame.
+class headless_presenter : public compositor::presenter {
+public:
+  headless_presenter() = default;
+
+  ~headless_presenter() override = default;
+
+  void present(const pixel_buffer& frame, const region& damage) override;
+
+  /// returns a copy of the last presented frame.
+  pixel_buffer get_frame() const;
+
+  region get_last_damage() const;
+
+  std::uint64_t get_frame_count() const;
+
+private:
+  mutable std::mutex m_mutex;
+  pixel_buffer m_frame;
+  region m_last_damage;
+  std::uint64_t m_frame_count = 0;
+};
+
+/// menu translator keeping the translated menu, as the native menu would.
+class headless_menu : public menu_model::translator {
+public:
+  headless_menu() = default;
+
+  ~headless_menu() override = default;
+
+  void translate(const std::vector<menu_item>& items, const menu_diff& diff) override;
+
+  inline const std::vector<menu_item>& get_items() const noexcept { return m_items; }
+
+  /// the number of translations that rebuilt the whole menu.
+  inline std::uint64_t get_rebuild_count() const noexcept { return m_rebuild_count; }
+
+  /// the number of items updated in place.
+  inline std::uint64_t get_updated_item_count() const noexcept { return m_updated_item_count; }
+
+private:
+  std::vector<menu_item> m_items;
+  std::uint64_t m_rebuild_count = 0;
+  std::uint64_t m_updated_item_count = 0;
+};
+} // namespace nano.
+
+NANO_CLANG_DIAGNOSTIC_POP()
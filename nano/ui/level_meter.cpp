@@ -0,0 +1,321 @@
+/*
+ * Nano Library
+ *
+ * Copyright (C) 2022, Meta-Sonic
+ * All rights reserved.
+ *
+ * Proprietary and confidential.
+ * Any unauthorized copying, alteration, distribution, transmission, performance,
+ * display or other use of this material is strictly prohibited.
+ *
+ * Written by Alexandre Arsenault <alx.arsenault@gmail.com>
+ */
+
+#include <nano/ui/level_meter.h>
+#include <nano/ui/region.h>
+
+#include <algorithm>
+#include <cmath>
+
+NANO_CLANG_DIAGNOSTIC_PUSH()
+NANO_CLANG_DIAGNOSTIC(warning, "-Weverything")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wc++98-compat")
+
+namespace nano {
+
+namespace {
+  inline nano::rect<float> to_float_rect(const nano::rect<int>& r) noexcept {
+    return nano::rect<float>(static_cast<float>(r.x), static_cast<float>(r.y), static_cast<float>(r.width),
+        static_cast<float>(r.height));
+  }
+
+  inline nano::rect<int> to_int_rect(const nano::rect<float>& r) noexcept {
+    const int x = static_cast<int>(std::floor(r.x));
+    const int y = static_cast<int>(std::floor(r.y));
+    return nano::rect<int>(x, y, static_cast<int>(std::ceil(r.x + r.width)) - x,
+        static_cast<int>(std::ceil(r.y + r.height)) - y);
+  }
+} // namespace.
+
+//
+// MARK: - level_meter_source -
+//
+
+level_meter_source::level_meter_source(int channel_count, float sample_rate, float rms_window)
+    : m_channels(new channel_levels[static_cast<std::size_t>(std::max(channel_count, 1))])
+    , m_channel_count(std::max(channel_count, 1))
+    , m_sample_rate(sample_rate)
+    , m_rms_window(rms_window) {}
+
+void level_meter_source::process(const float* const* channels, std::size_t frame_count) noexcept {
+  if (frame_count == 0) {
+    return;
+  }
+
+  // The mean square follows the blocks with a one pole filter of the window's time constant.
+  const float coefficient = 1.0f - std::exp(-static_cast<float>(frame_count) / (m_rms_window * m_sample_rate));
+
+  for (int c = 0; c < m_channel_count; c++) {
+    const float* samples = channels[c];
+    float peak = 0.0f;
+    float sum = 0.0f;
+
+    for (std::size_t i = 0; i < frame_count; i++) {
+      peak = std::max(peak, std::abs(samples[i]));
+      sum += samples[i] * samples[i];
+    }
+
+    channel_levels& ch = m_channels[static_cast<std::size_t>(c)];
+    ch.mean_square += (sum / static_cast<float>(frame_count) - ch.mean_square) * coefficient;
+    set_levels(c, peak, std::sqrt(ch.mean_square));
+  }
+}
+
+void level_meter_source::set_levels(int channel, float peak, float rms) noexcept {
+  channel_levels& ch = m_channels[static_cast<std::size_t>(channel)];
+
+  // Only fails when the ui took the peak in between.
+  float previous = ch.peak.load(std::memory_order_relaxed);
+  while (peak > previous && !ch.peak.compare_exchange_weak(previous, peak, std::memory_order_relaxed)) {
+  }
+
+  ch.rms.store(rms, std::memory_order_relaxed);
+}
+
+float level_meter_source::take_peak(int channel) noexcept {
+  return m_channels[static_cast<std::size_t>(channel)].peak.exchange(0.0f, std::memory_order_relaxed);
+}
+
+float level_meter_source::get_rms(int channel) const noexcept {
+  return m_channels[static_cast<std::size_t>(channel)].rms.load(std::memory_order_relaxed);
+}
+
+//
+// MARK: - level_meter_group -
+//
+
+level_meter_group::~level_meter_group() { timer::stop(); }
+
+level_meter_group& level_meter_group::get_main() {
+  NANO_CLANG_PUSH_WARNING("-Wexit-time-destructors")
+  static level_meter_group main_group;
+  NANO_CLANG_POP_WARNING()
+  return main_group;
+}
+
+void level_meter_group::add(level_meter_view* meter) {
+  if (std::find(m_meters.begin(), m_meters.end(), meter) != m_meters.end()) {
+    return;
+  }
+
+  m_meters.push_back(meter);
+
+  if (m_meters.size() == 1) {
+    m_last_update = std::chrono::steady_clock::now();
+    timer::start(m_frame_interval);
+  }
+}
+
+void level_meter_group::remove(level_meter_view* meter) {
+  m_meters.erase(std::remove(m_meters.begin(), m_meters.end(), meter), m_meters.end());
+
+  if (m_meters.empty()) {
+    timer::stop();
+  }
+}
+
+void level_meter_group::set_frame_interval(std::uint32_t interval_ms) {
+  m_frame_interval = interval_ms;
+
+  if (!m_meters.empty()) {
+    timer::start(m_frame_interval);
+  }
+}
+
+void level_meter_group::update(double dt) {
+  for (level_meter_view* meter : m_meters) {
+    meter->update(dt);
+  }
+}
+
+void level_meter_group::on_timer() {
+  const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+  const double dt = std::chrono::duration<double>(now - m_last_update).count();
+  m_last_update = now;
+  update(dt);
+}
+
+//
+// MARK: - level_meter_view -
+//
+
+level_meter_view::level_meter_view(
+    view* parent, const nano::rect<int>& rect, std::shared_ptr<level_meter_source> source, level_meter_group& group)
+    : view(parent, rect)
+    , m_group(group)
+    , m_source(std::move(source)) {
+  reset_channels();
+  m_group.add(this);
+}
+
+level_meter_view::~level_meter_view() { m_group.remove(this); }
+
+void level_meter_view::set_source(std::shared_ptr<level_meter_source> source) {
+  m_source = std::move(source);
+  reset_channels();
+  redraw();
+}
+
+void level_meter_view::set_ballistics(const ballistics& b) {
+  m_ballistics = b;
+  m_ballistics.max_db = std::max(m_ballistics.max_db, m_ballistics.min_db + 1.0f);
+  reset_channels();
+  redraw();
+}
+
+void level_meter_view::set_colors(
+    const nano::color& background, const nano::color& peak, const nano::color& rms, const nano::color& hold) {
+  m_background = background;
+  m_peak_color = peak;
+  m_rms_color = rms;
+  m_hold_color = hold;
+  redraw();
+}
+
+void level_meter_view::reset_channels() {
+  const std::size_t count = m_source ? static_cast<std::size_t>(m_source->get_channel_count()) : 0;
+  const float floor_db = m_ballistics.min_db - 1.0f;
+  const int bottom = get_frame().height;
+  m_channels.assign(count, { floor_db, floor_db, floor_db, 0.0f, bottom, bottom, bottom });
+}
+
+float level_meter_view::get_level_db(int channel) const noexcept {
+  return m_channels[static_cast<std::size_t>(channel)].level_db;
+}
+
+float level_meter_view::get_hold_db(int channel) const noexcept {
+  return m_channels[static_cast<std::size_t>(channel)].hold_db;
+}
+
+int level_meter_view::get_y(float db) const noexcept {
+  const float height = static_cast<float>(get_frame().height);
+  const float t = (m_ballistics.max_db - std::clamp(db, m_ballistics.min_db, m_ballistics.max_db))
+      / (m_ballistics.max_db - m_ballistics.min_db);
+  return static_cast<int>(std::lround(t * height));
+}
+
+nano::rect<int> level_meter_view::get_channel_rect(std::size_t channel) const noexcept {
+  const nano::size<int> size = get_frame().size;
+  const int count = static_cast<int>(m_channels.size());
+  const int c = static_cast<int>(channel);
+  const int x0 = c * size.width / count;
+  const int x1 = (c + 1) * size.width / count;
+
+  // One point between the channels when there is room for it.
+  const int gap = x1 - x0 > 2 && c + 1 < count ? 1 : 0;
+  return nano::rect<int>(x0, 0, x1 - x0 - gap, size.height);
+}
+
+void level_meter_view::update(double dt) {
+  if (!m_source || m_channels.empty()) {
+    return;
+  }
+
+  const float elapsed = static_cast<float>(dt);
+  const float floor_db = m_ballistics.min_db - 1.0f;
+  const auto to_db = [floor_db](float value) {
+    return value > 0.0f ? std::max(20.0f * std::log10(value), floor_db) : floor_db;
+  };
+
+  for (std::size_t c = 0; c < m_channels.size(); c++) {
+    channel_state& st = m_channels[c];
+    const int channel = static_cast<int>(c);
+
+    st.level_db = std::max(to_db(m_source->take_peak(channel)), st.level_db - m_ballistics.decay * elapsed);
+    st.rms_db = to_db(m_source->get_rms(channel));
+
+    if (st.level_db >= st.hold_db) {
+      st.hold_db = st.level_db;
+      st.hold_elapsed = 0.0f;
+    }
+    else if ((st.hold_elapsed += elapsed) > m_ballistics.hold_time) {
+      st.hold_db = std::max(st.level_db, st.hold_db - m_ballistics.hold_decay * elapsed);
+    }
+
+    const int level_y = get_y(st.level_db);
+    const int rms_y = get_y(st.rms_db);
+    const int hold_y = get_y(st.hold_db);
+    const nano::rect<int> r = get_channel_rect(c);
+
+    // The rows between the old and new tops of the bars are redrawn as one span.
+    int first = r.height;
+    int last = 0;
+    const auto add_span = [&](int from, int to) {
+      if (from != to) {
+        first = std::min({ first, from, to });
+        last = std::max({ last, from, to });
+      }
+    };
+
+    add_span(st.level_y, level_y);
+    add_span(st.rms_y, rms_y);
+
+    if (first < last) {
+      redraw(nano::rect<int>(r.x, first, r.width, last - first));
+    }
+
+    st.level_y = level_y;
+    st.rms_y = rms_y;
+
+    if (hold_y != st.hold_y) {
+      redraw(nano::rect<int>(r.x, st.hold_y, r.width, hold_height));
+      redraw(nano::rect<int>(r.x, hold_y, r.width, hold_height));
+      st.hold_y = hold_y;
+    }
+  }
+}
+
+void level_meter_view::on_frame_changed() {
+  const int bottom = get_frame().height;
+  for (channel_state& st : m_channels) {
+    st.level_y = bottom;
+    st.rms_y = bottom;
+    st.hold_y = bottom;
+  }
+
+  redraw();
+}
+
+void level_meter_view::on_draw(nano::graphic_context& gc, const nano::rect<float>& dirty_rect) {
+  const nano::rect<int> dirty = to_int_rect(dirty_rect);
+
+  gc.set_fill_color(m_background);
+  gc.fill_rect(dirty_rect);
+
+  const auto fill = [&](const nano::rect<int>& r, const nano::color& c) {
+    const nano::rect<int> area = get_intersection(r, dirty);
+    if (area.width > 0 && area.height > 0) {
+      gc.set_fill_color(c);
+      gc.fill_rect(to_float_rect(area));
+    }
+  };
+
+  for (std::size_t c = 0; c < m_channels.size(); c++) {
+    const channel_state& st = m_channels[c];
+    const nano::rect<int> r = get_channel_rect(c);
+
+    if (r.x >= dirty.x + dirty.width || r.x + r.width <= dirty.x) {
+      continue;
+    }
+
+    fill(nano::rect<int>(r.x, st.level_y, r.width, r.height - st.level_y), m_peak_color);
+    fill(nano::rect<int>(r.x, st.rms_y, r.width, r.height - st.rms_y), m_rms_color);
+
+    if (st.hold_y < r.height) {
+      fill(nano::rect<int>(r.x, st.hold_y, r.width, hold_height), m_hold_color);
+    }
+  }
+}
+} // namespace nano.
+
+NANO_CLANG_DIAGNOSTIC_POP()
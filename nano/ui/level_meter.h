@@ -0,0 +1,197 @@
+/*
+ * Nano Library
+ *
+ * Copyright (C) 2022, Meta-Sonic
+ * All rights reserved.
+ *
+ * Proprietary and confidential.
+ * Any unauthorized copying, alteration, distribution, transmission, performance,
+ * display or other use of this material is strictly prohibited.
+ *
+ * Written by Alexandre Arsenault <alx.arsenault@gmail.com>
+ */
+
+#pragma once
+
+/*!
+ * @file      nano/ui/level_meter.h
+ * @brief     nano ui level meter
+ * @copyright Copyright (C) 2022, Meta-Sonic
+ * @author    Alexandre Arsenault alx.arsenault@gmail.com
+ * @date      Created 16/06/2022
+ */
+
+#include <nano/ui.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+NANO_CLANG_DIAGNOSTIC_PUSH()
+NANO_CLANG_DIAGNOSTIC(warning, "-Weverything")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wc++98-compat")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wpadded")
+
+namespace nano {
+
+class level_meter_view;
+
+/// peak and rms levels written by the audio thread.
+///
+/// @details the audio side only measures its blocks and writes two atomic
+///          floats per channel, it never waits for the ui. the peak is the
+///          largest absolute sample since the ui last took it, the rms is
+///          integrated over rms_window seconds.
+class level_meter_source {
+public:
+  level_meter_source(int channel_count, float sample_rate, float rms_window = 0.3f);
+
+  level_meter_source(const level_meter_source&) = delete;
+  level_meter_source(level_meter_source&&) = delete;
+
+  ~level_meter_source() = default;
+
+  level_meter_source& operator=(const level_meter_source&) = delete;
+  level_meter_source& operator=(level_meter_source&&) = delete;
+
+  inline int get_channel_count() const noexcept { return m_channel_count; }
+
+  /// measures a block of samples, from the audio thread.
+  void process(const float* const* channels, std::size_t frame_count) noexcept;
+
+  /// sets levels measured elsewhere, from the audio thread.
+  void set_levels(int channel, float peak, float rms) noexcept;
+
+  /// returns the peak since the last call and resets it, from the ui thread.
+  float take_peak(int channel) noexcept;
+
+  float get_rms(int channel) const noexcept;
+
+private:
+  static constexpr std::size_t cache_line_size = 64;
+
+  struct alignas(cache_line_size) channel_levels {
+    std::atomic<float> peak = 0.0f;
+    std::atomic<float> rms = 0.0f;
+    /// audio thread only.
+    float mean_square = 0.0f;
+  };
+
+  std::unique_ptr<channel_levels[]> m_channels;
+  int m_channel_count;
+  float m_sample_rate;
+  float m_rms_window;
+};
+
+/// drives the ballistics of level meters from a single frame timer.
+class level_meter_group : private timer {
+public:
+  level_meter_group() = default;
+
+  ~level_meter_group() override;
+
+  /// returns the group driven by the main thread frame timer.
+  static level_meter_group& get_main();
+
+  void add(level_meter_view* meter);
+
+  void remove(level_meter_view* meter);
+
+  inline std::size_t size() const noexcept { return m_meters.size(); }
+
+  /// sets the interval of the frame timer in milliseconds (16 by default).
+  void set_frame_interval(std::uint32_t interval_ms);
+
+  /// advances every meter by dt seconds.
+  ///
+  /// @details this is called by the frame timer but can also be called
+  ///          manually (e.g. for testing).
+  void update(double dt);
+
+private:
+  std::vector<level_meter_view*> m_meters;
+  std::uint32_t m_frame_interval = 16;
+  std::chrono::steady_clock::time_point m_last_update;
+
+  virtual void on_timer() override;
+};
+
+/// vertical peak and rms bars, one per channel of a source.
+///
+/// @details the ballistics are computed once per frame by the group, then
+///          only the rows of pixels that changed since the last frame are
+///          redrawn: the part of the bars between their old and new heights
+///          and the old and new peak hold lines.
+class level_meter_view : public view {
+public:
+  struct ballistics {
+    /// how fast the peak bar falls, in decibels per second.
+    float decay = 24.0f;
+    /// how long the peak hold line stays before falling, in seconds.
+    float hold_time = 1.5f;
+    float hold_decay = 12.0f;
+    /// the levels at the bottom and top of the meter.
+    float min_db = -60.0f;
+    float max_db = 6.0f;
+  };
+
+  level_meter_view(view* parent, const nano::rect<int>& rect, std::shared_ptr<level_meter_source> source = nullptr,
+      level_meter_group& group = level_meter_group::get_main());
+
+  ~level_meter_view() override;
+
+  void set_source(std::shared_ptr<level_meter_source> source);
+
+  inline const std::shared_ptr<level_meter_source>& get_source() const noexcept { return m_source; }
+
+  void set_ballistics(const ballistics& b);
+
+  inline const ballistics& get_ballistics() const noexcept { return m_ballistics; }
+
+  void set_colors(
+      const nano::color& background, const nano::color& peak, const nano::color& rms, const nano::color& hold);
+
+  /// takes the levels of the source, advances the ballistics by dt seconds and
+  /// redraws what changed.
+  void update(double dt);
+
+  float get_level_db(int channel) const noexcept;
+
+  float get_hold_db(int channel) const noexcept;
+
+protected:
+  void on_frame_changed() override;
+
+  void on_draw(nano::graphic_context& gc, const nano::rect<float>& dirty_rect) override;
+
+private:
+  struct channel_state {
+    float level_db;
+    float rms_db;
+    float hold_db;
+    float hold_elapsed;
+    /// the rows drawn for the last frame.
+    int level_y;
+    int rms_y;
+    int hold_y;
+  };
+
+  static constexpr int hold_height = 2;
+
+  level_meter_group& m_group;
+  std::shared_ptr<level_meter_source> m_source;
+  std::vector<channel_state> m_channels;
+  ballistics m_ballistics;
+  nano::color m_background = nano::color(0x18191BFF);
+  nano::color m_peak_color = nano::color(0x3FBF5FFF);
+  nano::color m_rms_color = nano::color(0x8FE0A0FF);
+  nano::color m_hold_color = nano::color(0xF5D03FFF);
+
+  void reset_channels();
+  int get_y(float db) const noexcept;
+  nano::rect<int> get_channel_rect(std::size_t channel) const noexcept;
+};
+} // namespace nano.
+
+NANO_CLANG_DIAGNOSTIC_POP()
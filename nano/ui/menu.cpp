@@ -0,0 +1,353 @@
+/*
+ * Nano Library
+ *
+ * Copyright (C) 2022, Meta-Sonic
+ * All rights reserved.
+ *
+ * Proprietary and confidential.
+ * Any unauthorized copying, alteration, distribution, transmission, performance,
+ * display or other use of this material is strictly prohibited.
+ *
+ * Written by Alexandre Arsenault <alx.arsenault@gmail.com>
+ */
+
+#include <nano/ui/menu.h>
+
+NANO_CLANG_DIAGNOSTIC_PUSH()
+NANO_CLANG_DIAGNOSTIC(warning, "-Weverything")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wc++98-compat")
+
+namespace nano {
+
+//
+// MARK: - diff -
+//
+
+namespace {
+  inline bool is_same_structure(const menu_item& a, const menu_item& b) noexcept {
+    return a.command == b.command && a.separator == b.separator && a.is_submenu() == b.is_submenu();
+  }
+
+  inline bool is_same_state(const menu_item& a, const menu_item& b) noexcept {
+    return a.title == b.title && a.key_equivalent == b.key_equivalent && a.enabled == b.enabled
+        && a.checked == b.checked;
+  }
+
+  /// returns false when the structure differs.
+  bool diff_items(const std::vector<menu_item>& from, const std::vector<menu_item>& to,
+      std::vector<std::size_t>& path, std::vector<std::vector<std::size_t>>& changed) {
+    if (from.size() != to.size()) {
+      return false;
+    }
+
+    for (std::size_t i = 0; i < from.size(); i++) {
+      if (!is_same_structure(from[i], to[i])) {
+        return false;
+      }
+
+      path.push_back(i);
+      if (!is_same_state(from[i], to[i])) {
+        changed.push_back(path);
+      }
+
+      const bool same = diff_items(from[i].items, to[i].items, path, changed);
+      path.pop_back();
+
+      if (!same) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  void add_paths(const std::vector<menu_item>& items, std::vector<std::size_t>& path,
+      std::unordered_map<command_id, std::vector<std::size_t>>& paths) {
+    for (std::size_t i = 0; i < items.size(); i++) {
+      path.push_back(i);
+      if (items[i].command != no_command) {
+        paths[items[i].command] = path;
+      }
+
+      add_paths(items[i].items, path, paths);
+      path.pop_back();
+    }
+  }
+} // namespace.
+
+menu_diff diff_menus(const std::vector<menu_item>& from, const std::vector<menu_item>& to) {
+  menu_diff diff;
+  std::vector<std::size_t> path;
+
+  if (!diff_items(from, to, path, diff.changed_items)) {
+    diff.structure = true;
+    diff.changed_items.clear();
+  }
+
+  return diff;
+}
+
+const menu_item* find_menu_item(const std::vector<menu_item>& items, const std::vector<std::size_t>& path) {
+  const std::vector<menu_item>* level = &items;
+  const menu_item* item = nullptr;
+
+  for (std::size_t index : path) {
+    if (index >= level->size()) {
+      return nullptr;
+    }
+
+    item = &(*level)[index];
+    level = &item->items;
+  }
+
+  return item;
+}
+
+//
+// MARK: - menu_model -
+//
+
+menu_model::menu_model()
+    : m_builder(&menu_model::get_default_items) {}
+
+menu_model::~menu_model() {}
+
+menu_model& menu_model::get_main() {
+  NANO_CLANG_PUSH_WARNING("-Wexit-time-destructors")
+  static menu_model model;
+  NANO_CLANG_POP_WARNING()
+
+  static bool initialized = false;
+  if (!initialized) {
+    initialized = true;
+    model.set_action(quit_command, []() { application::quit(); });
+  }
+
+  return model;
+}
+
+std::vector<menu_item> menu_model::get_default_items() {
+  menu_item about;
+  about.title = "About AppName";
+  about.command = about_command;
+
+  menu_item quit;
+  quit.title = "Quit AppName";
+  quit.command = quit_command;
+  quit.key_equivalent = "q";
+
+  menu_item app_menu;
+  app_menu.title = "AppName";
+  app_menu.items = { about, menu_item::make_separator(), quit };
+
+  menu_item new_item;
+  new_item.title = "New";
+  new_item.command = new_command;
+  new_item.key_equivalent = "n";
+
+  menu_item file_menu;
+  file_menu.title = "File";
+  file_menu.items = { new_item };
+
+  return { app_menu, file_menu };
+}
+
+void menu_model::set_builder(builder b) {
+  m_builder = std::move(b);
+  invalidate();
+}
+
+void menu_model::invalidate() {
+  m_built = false;
+  changed();
+}
+
+const std::vector<menu_item>& menu_model::get_items() {
+  if (!m_built) {
+    build();
+  }
+
+  return m_items;
+}
+
+void menu_model::set_items(std::vector<menu_item> items) {
+  // Set by hand, the builder isn't called until the next invalidation.
+  const bool was_built = m_built;
+  m_built = true;
+
+  if (was_built && diff_menus(m_items, items).empty()) {
+    return;
+  }
+
+  m_items = std::move(items);
+  m_version++;
+  index_commands();
+  changed();
+}
+
+bool menu_model::set_enabled(command_id command, bool enabled) {
+  menu_item* item = find_mutable_item(command);
+  if (!item) {
+    return false;
+  }
+
+  if (item->enabled != enabled) {
+    item->enabled = enabled;
+    m_version++;
+    changed();
+  }
+
+  return true;
+}
+
+bool menu_model::set_checked(command_id command, bool checked) {
+  menu_item* item = find_mutable_item(command);
+  if (!item) {
+    return false;
+  }
+
+  if (item->checked != checked) {
+    item->checked = checked;
+    m_version++;
+    changed();
+  }
+
+  return true;
+}
+
+bool menu_model::set_title(command_id command, const std::string& title) {
+  menu_item* item = find_mutable_item(command);
+  if (!item) {
+    return false;
+  }
+
+  if (item->title != title) {
+    item->title = title;
+    m_version++;
+    changed();
+  }
+
+  return true;
+}
+
+const menu_item* menu_model::find_item(command_id command) { return find_mutable_item(command); }
+
+void menu_model::set_action(command_id command, action a) {
+  if (a) {
+    m_actions[command] = std::move(a);
+  }
+  else {
+    m_actions.erase(command);
+  }
+}
+
+bool menu_model::dispatch(command_id command) {
+  const auto it = m_actions.find(command);
+  if (it == m_actions.end()) {
+    return false;
+  }
+
+  // Commands that aren't in the menu (e.g. shortcuts) are always enabled.
+  const menu_item* item = find_item(command);
+  if (item && !item->enabled) {
+    return false;
+  }
+
+  m_stats.dispatched++;
+
+  // The action may change the actions.
+  const action a = it->second;
+  a();
+  return true;
+}
+
+void menu_model::set_translator(translator* t) {
+  m_translator = t;
+  m_translated = false;
+  m_translated_items.clear();
+}
+
+void menu_model::update_native() {
+  m_update_posted = false;
+
+  if (!m_translator) {
+    return;
+  }
+
+  get_items();
+  if (m_translated && m_translated_version == m_version) {
+    return;
+  }
+
+  menu_diff diff;
+  if (m_translated) {
+    diff = diff_menus(m_translated_items, m_items);
+  }
+  else {
+    diff.structure = true;
+  }
+
+  m_translated = true;
+  m_translated_version = m_version;
+
+  if (diff.empty()) {
+    return;
+  }
+
+  m_stats.translations++;
+  if (diff.structure) {
+    m_stats.structural_translations++;
+  }
+
+  m_translator->translate(m_items, diff);
+  m_translated_items = m_items;
+}
+
+void menu_model::build() {
+  m_built = true;
+  m_stats.builds++;
+
+  std::vector<menu_item> items = m_builder ? m_builder() : std::vector<menu_item>();
+  if (diff_menus(m_items, items).empty()) {
+    return;
+  }
+
+  m_items = std::move(items);
+  m_version++;
+  index_commands();
+}
+
+void menu_model::changed() {
+  // Nothing is built or translated until a window needs the menu.
+  if (!m_translator || !m_translated || m_update_posted) {
+    return;
+  }
+
+  m_update_posted = true;
+  std::weak_ptr<int> token = m_token;
+  post_message([this, token]() {
+    if (token.lock()) {
+      update_native();
+    }
+  });
+}
+
+void menu_model::index_commands() {
+  m_paths.clear();
+  std::vector<std::size_t> path;
+  add_paths(m_items, path, m_paths);
+}
+
+menu_item* menu_model::find_mutable_item(command_id command) {
+  get_items();
+
+  const auto it = m_paths.find(command);
+  if (it == m_paths.end()) {
+    return nullptr;
+  }
+
+  return const_cast<menu_item*>(find_menu_item(m_items, it->second));
+}
+} // namespace nano.
+
+NANO_CLANG_DIAGNOSTIC_POP()
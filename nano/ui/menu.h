@@ -0,0 +1,211 @@
+/*
+ * Nano Library
+ *
+ * Copyright (C) 2022, Meta-Sonic
+ * All rights reserved.
+ *
+ * Proprietary and confidential.
+ * Any unauthorized copying, alteration, distribution, transmission, performance,
+ * display or other use of this material is strictly prohibited.
+ *
+ * Written by Alexandre Arsenault <alx.arsenault@gmail.com>
+ */
+
+#pragma once
+
+/*!
+ * @file      nano/ui/menu.h
+ * @brief     nano ui menu model
+ * @copyright Copyright (C) 2022, Meta-Sonic
+ * @author    Alexandre Arsenault alx.arsenault@gmail.com
+ * @date      Created 16/06/2022
+ */
+
+#include <nano/ui.h>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+NANO_CLANG_DIAGNOSTIC_PUSH()
+NANO_CLANG_DIAGNOSTIC(warning, "-Weverything")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wc++98-compat")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wpadded")
+
+namespace nano {
+
+/// identifies a menu command, it is the tag of the native menu item.
+using command_id = std::uint32_t;
+
+/// the item is not a command (e.g. a submenu or a separator).
+constexpr command_id no_command = 0;
+constexpr command_id about_command = 1;
+constexpr command_id quit_command = 2;
+constexpr command_id new_command = 3;
+
+/// the ids of the application's own commands start here.
+constexpr command_id first_user_command = 1024;
+
+struct menu_item {
+  std::string title;
+  command_id command = no_command;
+
+  /// e.g. "q" for cmd+q.
+  std::string key_equivalent;
+
+  bool enabled = true;
+  bool checked = false;
+  bool separator = false;
+
+  /// the items of a submenu.
+  std::vector<menu_item> items;
+
+  static inline menu_item make_separator() {
+    menu_item item;
+    item.separator = true;
+    return item;
+  }
+
+  inline bool is_submenu() const noexcept { return !items.empty(); }
+};
+
+/// what changed between two versions of a menu.
+struct menu_diff {
+  /// items were added, removed, reordered or became submenus, the native menu has to be rebuilt.
+  bool structure = false;
+
+  /// the index paths of the items whose title, key, enabled or checked state changed.
+  std::vector<std::vector<std::size_t>> changed_items;
+
+  inline bool empty() const noexcept { return !structure && changed_items.empty(); }
+};
+
+/// compares two menus, the changed items are only listed when the structure is the same.
+menu_diff diff_menus(const std::vector<menu_item>& from, const std::vector<menu_item>& to);
+
+/// returns the item at an index path, or null.
+const menu_item* find_menu_item(const std::vector<menu_item>& items, const std::vector<std::size_t>& path);
+
+/// the application's menu, shared by every window.
+///
+/// @details the items are built lazily by the builder, the first time they
+///          are needed. a change is diffed against the current items and, when
+///          something changed, an update of the native menu is posted to the
+///          main queue. the translator then gets the diff from what it
+///          translated last, so it can update the items in place instead of
+///          rebuilding the whole menu. opening a window only translates the menu
+///          if it changed.
+///
+///          the native item of a command is tagged with its id, the actions
+///          are found by id in a hash map.
+///
+///          must be used on the main thread.
+class menu_model {
+public:
+  using builder = std::function<std::vector<menu_item>()>;
+  using action = std::function<void()>;
+
+  /// translates the model into a native menu.
+  class translator {
+  public:
+    translator() = default;
+
+    virtual ~translator() = default;
+
+    /// @param items the new menu.
+    /// @param diff from the previously translated menu, the structure has changed on the first translation.
+    virtual void translate(const std::vector<menu_item>& items, const menu_diff& diff) = 0;
+  };
+
+  struct stats {
+    /// calls to the builder.
+    std::uint64_t builds = 0;
+    std::uint64_t translations = 0;
+    /// translations that rebuilt the native menu.
+    std::uint64_t structural_translations = 0;
+    std::uint64_t dispatched = 0;
+  };
+
+  menu_model();
+
+  menu_model(const menu_model&) = delete;
+  menu_model(menu_model&&) = delete;
+
+  ~menu_model();
+
+  menu_model& operator=(const menu_model&) = delete;
+  menu_model& operator=(menu_model&&) = delete;
+
+  /// returns the menu of the application, quit_command quits it.
+  static menu_model& get_main();
+
+  /// returns the default menu, with about, quit and new.
+  static std::vector<menu_item> get_default_items();
+
+  /// replaces the builder, it is called the next time the items are needed.
+  void set_builder(builder b);
+
+  /// calls the builder again, the next time the items are needed.
+  void invalidate();
+
+  /// returns the items, built if needed.
+  const std::vector<menu_item>& get_items();
+
+  void set_items(std::vector<menu_item> items);
+
+  /// changes the state of the item of a command.
+  /// @returns false if the command is not in the menu.
+  bool set_enabled(command_id command, bool enabled);
+  bool set_checked(command_id command, bool checked);
+  bool set_title(command_id command, const std::string& title);
+
+  /// returns the item of a command, or null.
+  const menu_item* find_item(command_id command);
+
+  /// sets the action of a command, an empty action removes it.
+  void set_action(command_id command, action a);
+
+  /// calls the action of a command.
+  /// @returns false if the command has no action or its item is disabled.
+  bool dispatch(command_id command);
+
+  /// the translator is not owned, it must outlive the model or be reset.
+  void set_translator(translator* t);
+
+  inline translator* get_translator() const noexcept { return m_translator; }
+
+  /// translates the menu if it changed since the last translation.
+  /// @details on macos the application calls it once launched and the windows when they are created.
+  void update_native();
+
+  /// incremented at every change of the items.
+  inline std::uint64_t get_version() const noexcept { return m_version; }
+
+  inline const stats& get_stats() const noexcept { return m_stats; }
+
+private:
+  builder m_builder;
+  std::vector<menu_item> m_items;
+  std::vector<menu_item> m_translated_items;
+  std::unordered_map<command_id, std::vector<std::size_t>> m_paths;
+  std::unordered_map<command_id, action> m_actions;
+  translator* m_translator = nullptr;
+  std::uint64_t m_version = 0;
+  std::uint64_t m_translated_version = 0;
+  stats m_stats;
+  bool m_built = false;
+  bool m_translated = false;
+  bool m_update_posted = false;
+  std::shared_ptr<int> m_token = std::make_shared<int>(0);
+
+  void build();
+  void changed();
+  void index_commands();
+  menu_item* find_mutable_item(command_id command);
+};
+} // namespace nano.
+
+NANO_CLANG_DIAGNOSTIC_POP()
@@ -0,0 +1,599 @@
+/*
+ * Nano Library
+ *
+ * Copyright (C) 2022, Meta-Sonic
+ * All rights reserved.
+ *
+ * Proprietary and confidential.
+ * Any unauthorized copying, alteration, distribution, transmission, performance,
+ * display or other use of this material is strictly prohibited.
+ *
+ * Written by Alexandre Arsenault <alx.arsenault@gmail.com>
+ */
+
+#include <nano/ui/node_graph.h>
+#include <nano/ui/region.h>
+
+#include <algorithm>
+#include <cmath>
+
+NANO_CLANG_DIAGNOSTIC_PUSH()
+NANO_CLANG_DIAGNOSTIC(warning, "-Weverything")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wc++98-compat")
+
+namespace nano {
+
+namespace {
+  constexpr float port_radius = 4.0f;
+
+  inline nano::rect<int> to_int_rect(const nano::rect<float>& r) noexcept {
+    const int x = static_cast<int>(std::floor(r.x));
+    const int y = static_cast<int>(std::floor(r.y));
+    return nano::rect<int>(x, y, static_cast<int>(std::ceil(r.x + r.width)) - x,
+        static_cast<int>(std::ceil(r.y + r.height)) - y);
+  }
+
+  inline nano::rect<float> get_union(const nano::rect<float>& a, const nano::rect<float>& b) noexcept {
+    const float x = std::min(a.x, b.x);
+    const float y = std::min(a.y, b.y);
+    return nano::rect<float>(
+        x, y, std::max(a.x + a.width, b.x + b.width) - x, std::max(a.y + a.height, b.y + b.height) - y);
+  }
+
+  inline nano::rect<float> inflate(const nano::rect<float>& r, float d) noexcept {
+    return nano::rect<float>(r.x - d, r.y - d, r.width + 2.0f * d, r.height + 2.0f * d);
+  }
+
+  inline nano::point<float> get_bezier_point(const nano::point<float>* p, float t) noexcept {
+    const float u = 1.0f - t;
+    const float a = u * u * u;
+    const float b = 3.0f * u * u * t;
+    const float c = 3.0f * u * t * t;
+    const float d = t * t * t;
+    return nano::point<float>(a * p[0].x + b * p[1].x + c * p[2].x + d * p[3].x,
+        a * p[0].y + b * p[1].y + c * p[2].y + d * p[3].y);
+  }
+
+  /// the extrema of one coordinate of a cubic bezier, where its derivative is zero.
+  void add_extrema(float p0, float p1, float p2, float p3, float* t, int& count) noexcept {
+    // The derivative is 3 * (a * t^2 + b * t + c).
+    const float a = -p0 + 3.0f * p1 - 3.0f * p2 + p3;
+    const float b = 2.0f * (p0 - 2.0f * p1 + p2);
+    const float c = p1 - p0;
+
+    const auto add = [&](float r) {
+      if (r > 0.0f && r < 1.0f) {
+        t[count++] = r;
+      }
+    };
+
+    if (std::abs(a) < 1e-6f) {
+      if (std::abs(b) > 1e-6f) {
+        add(-c / b);
+      }
+      return;
+    }
+
+    const float delta = b * b - 4.0f * a * c;
+    if (delta < 0.0f) {
+      return;
+    }
+
+    const float s = std::sqrt(delta);
+    add((-b + s) / (2.0f * a));
+    add((-b - s) / (2.0f * a));
+  }
+
+  nano::rect<float> get_bezier_bounds(const nano::point<float>* p) noexcept {
+    float t[4];
+    int count = 0;
+    add_extrema(p[0].x, p[1].x, p[2].x, p[3].x, t, count);
+    add_extrema(p[0].y, p[1].y, p[2].y, p[3].y, t, count);
+
+    float x0 = std::min(p[0].x, p[3].x);
+    float y0 = std::min(p[0].y, p[3].y);
+    float x1 = std::max(p[0].x, p[3].x);
+    float y1 = std::max(p[0].y, p[3].y);
+
+    for (int i = 0; i < count; i++) {
+      const nano::point<float> e = get_bezier_point(p, t[i]);
+      x0 = std::min(x0, e.x);
+      y0 = std::min(y0, e.y);
+      x1 = std::max(x1, e.x);
+      y1 = std::max(y1, e.y);
+    }
+
+    return nano::rect<float>(x0, y0, x1 - x0, y1 - y0);
+  }
+
+  /// the number of segments a curve is drawn and measured with, from the length of its control polygon.
+  int get_segment_count(const nano::point<float>* p) noexcept {
+    float length = 0.0f;
+    for (int i = 0; i < 3; i++) {
+      length += std::hypot(p[i + 1].x - p[i].x, p[i + 1].y - p[i].y);
+    }
+
+    return std::clamp(static_cast<int>(length / 8.0f), 4, 64);
+  }
+
+  inline float get_segment_distance(
+      const nano::point<float>& p, const nano::point<float>& a, const nano::point<float>& b) noexcept {
+    const float dx = b.x - a.x;
+    const float dy = b.y - a.y;
+    const float length = dx * dx + dy * dy;
+    const float t = length > 0.0f ? std::clamp(((p.x - a.x) * dx + (p.y - a.y) * dy) / length, 0.0f, 1.0f) : 0.0f;
+    return std::hypot(p.x - (a.x + t * dx), p.y - (a.y + t * dy));
+  }
+
+  const std::vector<wire_id> empty_wires;
+} // namespace.
+
+//
+// MARK: - spatial_hash -
+//
+
+spatial_hash::spatial_hash(float cell_size)
+    : m_cell_size(std::max(cell_size, 1.0f)) {}
+
+spatial_hash::cell_range spatial_hash::get_cell_range(const nano::rect<float>& r) const noexcept {
+  return cell_range{ static_cast<std::int32_t>(std::floor(r.x / m_cell_size)),
+    static_cast<std::int32_t>(std::floor(r.y / m_cell_size)),
+    static_cast<std::int32_t>(std::floor((r.x + r.width) / m_cell_size)),
+    static_cast<std::int32_t>(std::floor((r.y + r.height) / m_cell_size)) };
+}
+
+void spatial_hash::insert(std::uint32_t id, const nano::rect<float>& bounds) {
+  const cell_range range = get_cell_range(bounds);
+
+  for (std::int32_t y = range.y0; y <= range.y1; y++) {
+    for (std::int32_t x = range.x0; x <= range.x1; x++) {
+      m_cells[get_key(x, y)].push_back(entry{ bounds, id });
+    }
+  }
+}
+
+void spatial_hash::erase(std::uint32_t id, const nano::rect<float>& bounds) {
+  const cell_range range = get_cell_range(bounds);
+
+  for (std::int32_t y = range.y0; y <= range.y1; y++) {
+    for (std::int32_t x = range.x0; x <= range.x1; x++) {
+      const auto it = m_cells.find(get_key(x, y));
+      if (it == m_cells.end()) {
+        continue;
+      }
+
+      std::vector<entry>& entries = it->second;
+      const auto e = std::find_if(entries.begin(), entries.end(), [id](const entry& en) { return en.id == id; });
+      if (e != entries.end()) {
+        *e = entries.back();
+        entries.pop_back();
+      }
+
+      if (entries.empty()) {
+        m_cells.erase(it);
+      }
+    }
+  }
+}
+
+void spatial_hash::clear() { m_cells.clear(); }
+
+//
+// MARK: - node_graph -
+//
+
+float get_distance(const graph_wire& wire, const nano::point<float>& p) noexcept {
+  const int count = get_segment_count(wire.points);
+  float distance = std::numeric_limits<float>::max();
+  nano::point<float> a = wire.points[0];
+
+  for (int i = 1; i <= count; i++) {
+    const nano::point<float> b = get_bezier_point(wire.points, static_cast<float>(i) / static_cast<float>(count));
+    distance = std::min(distance, get_segment_distance(p, a, b));
+    a = b;
+  }
+
+  return distance;
+}
+
+node_graph::node_graph(float cell_size)
+    : m_node_hash(cell_size)
+    , m_wire_hash(cell_size) {}
+
+void node_graph::clear() {
+  m_nodes.clear();
+  m_wires.clear();
+  m_free_node_ids.clear();
+  m_free_wire_ids.clear();
+  m_node_hash.clear();
+  m_wire_hash.clear();
+  m_node_count = 0;
+  m_wire_count = 0;
+}
+
+node_id node_graph::add_node(const nano::rect<float>& rect, int input_count, int output_count) {
+  node_id id;
+  if (!m_free_node_ids.empty()) {
+    id = m_free_node_ids.back();
+    m_free_node_ids.pop_back();
+  }
+  else {
+    id = static_cast<node_id>(m_nodes.size());
+    m_nodes.emplace_back();
+  }
+
+  node_slot& slot = m_nodes[id];
+  slot.node = graph_node{ rect, id, std::max(input_count, 0), std::max(output_count, 0), false };
+  slot.wires.clear();
+  slot.used = true;
+
+  m_node_hash.insert(id, rect);
+  m_node_count++;
+  return id;
+}
+
+bool node_graph::remove_node(node_id id) {
+  if (!find_node(id)) {
+    return false;
+  }
+
+  // Each wire removes itself from the lists of both its nodes.
+  while (!m_nodes[id].wires.empty()) {
+    erase_wire(m_nodes[id].wires.back());
+  }
+
+  m_node_hash.erase(id, m_nodes[id].node.rect);
+  m_nodes[id].used = false;
+  m_free_node_ids.push_back(id);
+  m_node_count--;
+  return true;
+}
+
+bool node_graph::move_node(node_id id, const nano::point<float>& position) {
+  if (!find_node(id)) {
+    return false;
+  }
+
+  node_slot& slot = m_nodes[id];
+  m_node_hash.erase(id, slot.node.rect);
+  slot.node.rect.x = position.x;
+  slot.node.rect.y = position.y;
+  m_node_hash.insert(id, slot.node.rect);
+
+  for (wire_id w : slot.wires) {
+    graph_wire& wire = m_wires[w].wire;
+    m_wire_hash.erase(w, wire.bounds);
+    update_curve(wire);
+    m_wire_hash.insert(w, wire.bounds);
+  }
+
+  return true;
+}
+
+bool node_graph::set_selected(node_id id, bool selected) {
+  if (!find_node(id)) {
+    return false;
+  }
+
+  m_nodes[id].node.selected = selected;
+  return true;
+}
+
+wire_id node_graph::connect(node_id from, int from_port, node_id to, int to_port) {
+  const graph_node* a = find_node(from);
+  const graph_node* b = find_node(to);
+  if (!a || !b || from_port < 0 || from_port >= a->output_count || to_port < 0 || to_port >= b->input_count) {
+    return invalid_wire_id;
+  }
+
+  wire_id id;
+  if (!m_free_wire_ids.empty()) {
+    id = m_free_wire_ids.back();
+    m_free_wire_ids.pop_back();
+  }
+  else {
+    id = static_cast<wire_id>(m_wires.size());
+    m_wires.emplace_back();
+  }
+
+  wire_slot& slot = m_wires[id];
+  slot.wire.id = id;
+  slot.wire.from = from;
+  slot.wire.to = to;
+  slot.wire.from_port = from_port;
+  slot.wire.to_port = to_port;
+  slot.used = true;
+  update_curve(slot.wire);
+
+  m_nodes[from].wires.push_back(id);
+  if (to != from) {
+    m_nodes[to].wires.push_back(id);
+  }
+
+  m_wire_hash.insert(id, slot.wire.bounds);
+  m_wire_count++;
+  return id;
+}
+
+bool node_graph::disconnect(wire_id id) {
+  if (!find_wire(id)) {
+    return false;
+  }
+
+  erase_wire(id);
+  return true;
+}
+
+void node_graph::erase_wire(wire_id id) {
+  const graph_wire& wire = m_wires[id].wire;
+
+  for (node_id n : { wire.from, wire.to }) {
+    std::vector<wire_id>& wires = m_nodes[n].wires;
+    const auto it = std::find(wires.begin(), wires.end(), id);
+    if (it != wires.end()) {
+      *it = wires.back();
+      wires.pop_back();
+    }
+  }
+
+  m_wire_hash.erase(id, wire.bounds);
+  m_wires[id].used = false;
+  m_free_wire_ids.push_back(id);
+  m_wire_count--;
+}
+
+const graph_node* node_graph::find_node(node_id id) const noexcept {
+  return id < m_nodes.size() && m_nodes[id].used ? &m_nodes[id].node : nullptr;
+}
+
+const graph_wire* node_graph::find_wire(wire_id id) const noexcept {
+  return id < m_wires.size() && m_wires[id].used ? &m_wires[id].wire : nullptr;
+}
+
+const std::vector<wire_id>& node_graph::get_node_wires(node_id id) const noexcept {
+  return find_node(id) ? m_nodes[id].wires : empty_wires;
+}
+
+nano::point<float> node_graph::get_input_position(const graph_node& node, int port) const noexcept {
+  return nano::point<float>(node.rect.x, node.rect.y + port_spacing * static_cast<float>(port + 1));
+}
+
+nano::point<float> node_graph::get_output_position(const graph_node& node, int port) const noexcept {
+  return nano::point<float>(node.rect.x + node.rect.width, node.rect.y + port_spacing * static_cast<float>(port + 1));
+}
+
+void node_graph::update_curve(graph_wire& wire) const noexcept {
+  const nano::point<float> a = get_output_position(m_nodes[wire.from].node, wire.from_port);
+  const nano::point<float> b = get_input_position(m_nodes[wire.to].node, wire.to_port);
+
+  // The tangents stay horizontal, and bend further out when the input is behind the output.
+  const float d = std::max(std::abs(b.x - a.x) * 0.5f, 40.0f);
+  wire.points[0] = a;
+  wire.points[1] = nano::point<float>(a.x + d, a.y);
+  wire.points[2] = nano::point<float>(b.x - d, b.y);
+  wire.points[3] = b;
+  wire.bounds = get_bezier_bounds(wire.points);
+}
+
+node_id node_graph::hit_test_node(const nano::point<float>& p) const {
+  node_id result = invalid_node_id;
+
+  m_node_hash.query(nano::rect<float>(p.x, p.y, 0.0f, 0.0f), [&](std::uint32_t id, const nano::rect<float>& r) {
+    if (p.x >= r.x && p.x < r.x + r.width && p.y >= r.y && p.y < r.y + r.height
+        && (result == invalid_node_id || id > result)) {
+      result = id;
+    }
+  });
+
+  return result;
+}
+
+wire_id node_graph::hit_test_wire(const nano::point<float>& p, float tolerance) const {
+  wire_id result = invalid_wire_id;
+  float nearest = tolerance;
+
+  // Only the curves whose bounds are within the tolerance are measured.
+  const nano::rect<float> area(p.x - tolerance, p.y - tolerance, 2.0f * tolerance, 2.0f * tolerance);
+  m_wire_hash.query(area, [&](std::uint32_t id, const nano::rect<float>&) {
+    const float distance = get_distance(m_wires[id].wire, p);
+    if (distance <= nearest) {
+      nearest = distance;
+      result = id;
+    }
+  });
+
+  return result;
+}
+
+//
+// MARK: - node_graph_view -
+//
+
+node_graph_view::node_graph_view(view* parent, const nano::rect<int>& rect)
+    : view(parent, rect) {}
+
+void node_graph_view::set_graph(std::shared_ptr<node_graph> graph) {
+  m_graph = std::move(graph);
+  m_hovered_wire = invalid_wire_id;
+  m_dragged_node = invalid_node_id;
+  redraw();
+}
+
+void node_graph_view::set_colors(const nano::color& background, const nano::color& node,
+    const nano::color& selected_node, const nano::color& wire, const nano::color& hovered_wire) {
+  m_background = background;
+  m_node_color = node;
+  m_selected_color = selected_node;
+  m_wire_color = wire;
+  m_hovered_color = hovered_wire;
+  redraw();
+}
+
+void node_graph_view::set_wire_width(float width, float hover_distance) {
+  m_wire_width = std::max(width, 0.5f);
+  m_hover_distance = std::max(hover_distance, 0.0f);
+  redraw();
+}
+
+nano::rect<int> node_graph_view::get_redraw_rect(const nano::rect<float>& bounds) const noexcept {
+  // Room for the line width and the anti-aliasing.
+  return to_int_rect(inflate(bounds, m_wire_width * 0.5f + 1.0f));
+}
+
+void node_graph_view::redraw_wire(wire_id id) {
+  if (const graph_wire* wire = m_graph ? m_graph->find_wire(id) : nullptr) {
+    redraw(get_redraw_rect(wire->bounds));
+  }
+}
+
+void node_graph_view::hover(const nano::point<float>& pos) {
+  if (!m_graph || m_dragged_node != invalid_node_id) {
+    return;
+  }
+
+  const wire_id id = m_graph->hit_test_node(pos) == invalid_node_id ? m_graph->hit_test_wire(pos, m_hover_distance)
+                                                                     : invalid_wire_id;
+  if (id == m_hovered_wire) {
+    return;
+  }
+
+  redraw_wire(m_hovered_wire);
+  m_hovered_wire = id;
+  redraw_wire(m_hovered_wire);
+}
+
+bool node_graph_view::begin_drag(const nano::point<float>& pos) {
+  const node_id id = m_graph ? m_graph->hit_test_node(pos) : invalid_node_id;
+  if (id == invalid_node_id) {
+    return false;
+  }
+
+  const nano::rect<float>& r = m_graph->find_node(id)->rect;
+  m_dragged_node = id;
+  m_drag_offset = nano::point<float>(pos.x - r.x, pos.y - r.y);
+  return true;
+}
+
+void node_graph_view::drag(const nano::point<float>& pos) {
+  const graph_node* node = m_graph ? m_graph->find_node(m_dragged_node) : nullptr;
+  if (!node) {
+    return;
+  }
+
+  const nano::point<float> position(pos.x - m_drag_offset.x, pos.y - m_drag_offset.y);
+  if (position.x == node->rect.x && position.y == node->rect.y) {
+    return;
+  }
+
+  // The old and new bounds are redrawn separately, the region merges them
+  // when a step of the drag mostly overlaps them.
+  const nano::rect<float> old_rect = node->rect;
+  const std::vector<wire_id>& wires = m_graph->get_node_wires(m_dragged_node);
+  std::vector<nano::rect<float>> old_bounds;
+  old_bounds.reserve(wires.size());
+  for (wire_id w : wires) {
+    old_bounds.push_back(m_graph->find_wire(w)->bounds);
+  }
+
+  m_graph->move_node(m_dragged_node, position);
+  redraw(to_int_rect(inflate(old_rect, port_radius + 1.0f)));
+  redraw(to_int_rect(inflate(node->rect, port_radius + 1.0f)));
+
+  for (std::size_t i = 0; i < wires.size(); i++) {
+    redraw(get_redraw_rect(old_bounds[i]));
+    redraw_wire(wires[i]);
+  }
+}
+
+void node_graph_view::end_drag() { m_dragged_node = invalid_node_id; }
+
+void node_graph_view::on_mouse_moved(const nano::event& evt) { hover(evt.get_position()); }
+
+void node_graph_view::on_mouse_exited(const nano::event& evt) {
+  NANO_UNUSED(evt);
+  redraw_wire(m_hovered_wire);
+  m_hovered_wire = invalid_wire_id;
+}
+
+void node_graph_view::on_mouse_down(const nano::event& evt) {
+  if (begin_drag(evt.get_position())) {
+    redraw_wire(m_hovered_wire);
+    m_hovered_wire = invalid_wire_id;
+  }
+}
+
+void node_graph_view::on_mouse_dragged(const nano::event& evt) { drag(evt.get_position()); }
+
+void node_graph_view::on_mouse_up(const nano::event& evt) {
+  end_drag();
+  hover(evt.get_position());
+}
+
+void node_graph_view::on_draw(nano::graphic_context& gc, const nano::rect<float>& dirty_rect) {
+  gc.set_fill_color(m_background);
+  gc.fill_rect(dirty_rect);
+
+  // Only the visible part of the canvas is drawn, the view is usually much larger.
+  const nano::rect<int> area = get_intersection(to_int_rect(dirty_rect), get_visible_rect());
+  if (!m_graph || is_empty(area)) {
+    return;
+  }
+
+  const nano::rect<float> query_rect(area);
+
+  // The wires under the nodes, the hovered one on top of the others.
+  gc.set_line_width(m_wire_width);
+  gc.set_stroke_color(m_wire_color);
+
+  const auto stroke_wire = [&](const graph_wire& w) {
+    const int count = get_segment_count(w.points);
+    nano::point<float> a = w.points[0];
+    for (int i = 1; i <= count; i++) {
+      const nano::point<float> b = get_bezier_point(w.points, static_cast<float>(i) / static_cast<float>(count));
+      gc.stroke_line(a, b);
+      a = b;
+    }
+  };
+
+  m_graph->query_wires(inflate(query_rect, m_wire_width), [&](const graph_wire& w) {
+    if (w.id != m_hovered_wire && is_dirty_rect(get_redraw_rect(w.bounds))) {
+      stroke_wire(w);
+    }
+  });
+
+  if (const graph_wire* hovered = m_graph->find_wire(m_hovered_wire)) {
+    if (is_dirty_rect(get_redraw_rect(hovered->bounds))) {
+      gc.set_stroke_color(m_hovered_color);
+      stroke_wire(*hovered);
+    }
+  }
+
+  // The nodes are drawn in the order of their ids, the highest one on top.
+  std::vector<const graph_node*> nodes;
+  m_graph->query_nodes(inflate(query_rect, port_radius), [&](const graph_node& n) {
+    if (is_dirty_rect(to_int_rect(inflate(n.rect, port_radius)))) {
+      nodes.push_back(&n);
+    }
+  });
+
+  std::sort(nodes.begin(), nodes.end(), [](const graph_node* a, const graph_node* b) { return a->id < b->id; });
+
+  for (const graph_node* n : nodes) {
+    gc.set_fill_color(n->selected ? m_selected_color : m_node_color);
+    gc.fill_rect(n->rect);
+
+    gc.set_fill_color(m_wire_color);
+    for (int i = 0; i < n->input_count; i++) {
+      const nano::point<float> p = m_graph->get_input_position(*n, i);
+      gc.fill_ellipse(nano::rect<float>(p.x - port_radius, p.y - port_radius, 2.0f * port_radius, 2.0f * port_radius));
+    }
+
+    for (int i = 0; i < n->output_count; i++) {
+      const nano::point<float> p = m_graph->get_output_position(*n, i);
+      gc.fill_ellipse(nano::rect<float>(p.x - port_radius, p.y - port_radius, 2.0f * port_radius, 2.0f * port_radius));
+    }
+  }
+}
+} // namespace nano.
+
+NANO_CLANG_DIAGNOSTIC_POP()
@@ -0,0 +1,305 @@
+/*
+ * Nano Library
+ *
+ * Copyright (C) 2022, Meta-Sonic
+ * All rights reserved.
+ *
+ * Proprietary and confidential.
+ * Any unauthorized copying, alteration, distribution, transmission, performance,
+ * display or other use of this material is strictly prohibited.
+ *
+ * Written by Alexandre Arsenault <alx.arsenault@gmail.com>
+ */
+
+#pragma once
+
+/*!
+ * @file      nano/ui/node_graph.h
+ * @brief     nano ui node graph
+ * @copyright Copyright (C) 2022, Meta-Sonic
+ * @author    Alexandre Arsenault alx.arsenault@gmail.com
+ * @date      Created 16/06/2022
+ */
+
+#include <nano/ui.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+NANO_CLANG_DIAGNOSTIC_PUSH()
+NANO_CLANG_DIAGNOSTIC(warning, "-Weverything")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wc++98-compat")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wpadded")
+
+namespace nano {
+
+using node_id = std::uint32_t;
+using wire_id = std::uint32_t;
+
+inline constexpr node_id invalid_node_id = std::numeric_limits<node_id>::max();
+inline constexpr wire_id invalid_wire_id = std::numeric_limits<wire_id>::max();
+
+/// items indexed by their bounds in a uniform grid of cells.
+///
+/// @details an item is kept in every cell its bounds overlap. a query only
+///          visits the cells of its rect and reports each item once, from the
+///          first cell shared by the item and the query.
+class spatial_hash {
+public:
+  static constexpr float default_cell_size = 128.0f;
+
+  spatial_hash(float cell_size = default_cell_size);
+
+  void insert(std::uint32_t id, const nano::rect<float>& bounds);
+
+  /// the bounds must be the ones the item was inserted with.
+  void erase(std::uint32_t id, const nano::rect<float>& bounds);
+
+  void clear();
+
+  inline float get_cell_size() const noexcept { return m_cell_size; }
+
+  inline std::size_t get_cell_count() const noexcept { return m_cells.size(); }
+
+  /// calls fn(std::uint32_t id, const nano::rect<float>& bounds) for the items overlapping the rect.
+  template <class Fn>
+  void query(const nano::rect<float>& rect, Fn&& fn) const;
+
+private:
+  struct entry {
+    nano::rect<float> bounds;
+    std::uint32_t id;
+  };
+
+  struct cell_range {
+    std::int32_t x0;
+    std::int32_t y0;
+    std::int32_t x1;
+    std::int32_t y1;
+  };
+
+  std::unordered_map<std::uint64_t, std::vector<entry>> m_cells;
+  float m_cell_size;
+
+  cell_range get_cell_range(const nano::rect<float>& r) const noexcept;
+
+  static inline std::uint64_t get_key(std::int32_t x, std::int32_t y) noexcept {
+    return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(x)) << 32) | static_cast<std::uint32_t>(y);
+  }
+};
+
+struct graph_node {
+  nano::rect<float> rect;
+  node_id id;
+  int input_count;
+  int output_count;
+  bool selected;
+};
+
+/// a cable from an output of a node to an input of another.
+struct graph_wire {
+  /// the cubic bezier of the cable, computed when a node it connects moves.
+  nano::point<float> points[4];
+  /// the bounds of the curve, without the line width.
+  nano::rect<float> bounds;
+  wire_id id;
+  node_id from;
+  node_id to;
+  int from_port;
+  int to_port;
+};
+
+/// returns the distance from a point to the curve of a wire.
+float get_distance(const graph_wire& wire, const nano::point<float>& p) noexcept;
+
+/// nodes and the wires between their ports, indexed by their bounds.
+///
+/// @details moving a node only updates the curves, bounds and cells of its own
+///          wires. the bounds of a wire are the exact bounds of its bezier so
+///          that hit testing and redrawing only visit the cables really near
+///          the point or the rect.
+class node_graph {
+public:
+  static constexpr float port_spacing = 16.0f;
+
+  node_graph(float cell_size = spatial_hash::default_cell_size);
+
+  node_id add_node(const nano::rect<float>& rect, int input_count, int output_count);
+
+  /// removes a node and its wires.
+  bool remove_node(node_id id);
+
+  /// moves a node and the wires connected to it.
+  bool move_node(node_id id, const nano::point<float>& position);
+
+  bool set_selected(node_id id, bool selected);
+
+  /// @returns invalid_wire_id if a node or a port doesn't exist.
+  wire_id connect(node_id from, int from_port, node_id to, int to_port);
+
+  bool disconnect(wire_id id);
+
+  void clear();
+
+  /// returns nullptr if there is no node with this id.
+  const graph_node* find_node(node_id id) const noexcept;
+
+  /// returns nullptr if there is no wire with this id.
+  const graph_wire* find_wire(wire_id id) const noexcept;
+
+  /// returns the wires connected to a node.
+  const std::vector<wire_id>& get_node_wires(node_id id) const noexcept;
+
+  inline std::size_t get_node_count() const noexcept { return m_node_count; }
+
+  inline std::size_t get_wire_count() const noexcept { return m_wire_count; }
+
+  nano::point<float> get_input_position(const graph_node& node, int port) const noexcept;
+  nano::point<float> get_output_position(const graph_node& node, int port) const noexcept;
+
+  /// calls fn(const graph_node&) for the nodes overlapping the rect, in no particular order.
+  template <class Fn>
+  void query_nodes(const nano::rect<float>& rect, Fn&& fn) const;
+
+  /// calls fn(const graph_wire&) for the wires whose bounds overlap the rect, in no particular order.
+  template <class Fn>
+  void query_wires(const nano::rect<float>& rect, Fn&& fn) const;
+
+  /// returns the node under a point with the highest id, the one drawn on top, or invalid_node_id.
+  /// @details the ids of removed nodes are reused, so this is not always the last added node.
+  node_id hit_test_node(const nano::point<float>& p) const;
+
+  /// returns the wire nearest to a point within a distance, or invalid_wire_id.
+  wire_id hit_test_wire(const nano::point<float>& p, float tolerance) const;
+
+private:
+  struct node_slot {
+    graph_node node;
+    std::vector<wire_id> wires;
+    bool used;
+  };
+
+  struct wire_slot {
+    graph_wire wire;
+    bool used;
+  };
+
+  std::vector<node_slot> m_nodes;
+  std::vector<wire_slot> m_wires;
+  std::vector<node_id> m_free_node_ids;
+  std::vector<wire_id> m_free_wire_ids;
+  spatial_hash m_node_hash;
+  spatial_hash m_wire_hash;
+  std::size_t m_node_count = 0;
+  std::size_t m_wire_count = 0;
+
+  void update_curve(graph_wire& wire) const noexcept;
+  void erase_wire(wire_id id);
+};
+
+/// a canvas of nodes and the bezier cables between them.
+///
+/// @details drawing only queries the wires and nodes of the dirty rects.
+///          dragging a node redraws its old and new rects and the old and new
+///          bounds of each of its wires, hovering a cable redraws its bounds.
+class node_graph_view : public view {
+public:
+  node_graph_view(view* parent, const nano::rect<int>& rect);
+
+  ~node_graph_view() override = default;
+
+  void set_graph(std::shared_ptr<node_graph> graph);
+
+  inline const std::shared_ptr<node_graph>& get_graph() const noexcept { return m_graph; }
+
+  void set_colors(const nano::color& background, const nano::color& node, const nano::color& selected_node,
+      const nano::color& wire, const nano::color& hovered_wire);
+
+  /// sets the width of the cables and the distance from which they are hovered.
+  void set_wire_width(float width, float hover_distance);
+
+  /// updates the hovered wire, it is only looked for when no node is under the position.
+  void hover(const nano::point<float>& pos);
+
+  inline wire_id get_hovered_wire() const noexcept { return m_hovered_wire; }
+
+  /// starts dragging the node under a position.
+  /// @returns false if there is no node under the position.
+  bool begin_drag(const nano::point<float>& pos);
+  void drag(const nano::point<float>& pos);
+  void end_drag();
+
+  inline node_id get_dragged_node() const noexcept { return m_dragged_node; }
+
+protected:
+  void on_mouse_moved(const nano::event& evt) override;
+  void on_mouse_exited(const nano::event& evt) override;
+  void on_mouse_down(const nano::event& evt) override;
+  void on_mouse_dragged(const nano::event& evt) override;
+  void on_mouse_up(const nano::event& evt) override;
+
+  void on_draw(nano::graphic_context& gc, const nano::rect<float>& dirty_rect) override;
+
+private:
+  std::shared_ptr<node_graph> m_graph;
+  wire_id m_hovered_wire = invalid_wire_id;
+  node_id m_dragged_node = invalid_node_id;
+  nano::point<float> m_drag_offset = { 0.0f, 0.0f };
+  float m_wire_width = 2.0f;
+  float m_hover_distance = 4.0f;
+
+  nano::color m_background = nano::color(0x202226FF);
+  nano::color m_node_color = nano::color(0x3A3D44FF);
+  nano::color m_selected_color = nano::color(0x5A5F6BFF);
+  nano::color m_wire_color = nano::color(0x3FA9F5FF);
+  nano::color m_hovered_color = nano::color(0xF5A93FFF);
+
+  void redraw_wire(wire_id id);
+  nano::rect<int> get_redraw_rect(const nano::rect<float>& bounds) const noexcept;
+};
+
+template <class Fn>
+void spatial_hash::query(const nano::rect<float>& rect, Fn&& fn) const {
+  const cell_range range = get_cell_range(rect);
+  const float right = rect.x + rect.width;
+  const float bottom = rect.y + rect.height;
+
+  for (std::int32_t y = range.y0; y <= range.y1; y++) {
+    for (std::int32_t x = range.x0; x <= range.x1; x++) {
+      const auto it = m_cells.find(get_key(x, y));
+      if (it == m_cells.end()) {
+        continue;
+      }
+
+      for (const entry& e : it->second) {
+        if (e.bounds.x > right || e.bounds.y > bottom || e.bounds.x + e.bounds.width < rect.x
+            || e.bounds.y + e.bounds.height < rect.y) {
+          continue;
+        }
+
+        // Only reported from the first cell shared with the query.
+        const cell_range r = get_cell_range(e.bounds);
+        if (x == std::max(r.x0, range.x0) && y == std::max(r.y0, range.y0)) {
+          fn(e.id, e.bounds);
+        }
+      }
+    }
+  }
+}
+
+template <class Fn>
+void node_graph::query_nodes(const nano::rect<float>& rect, Fn&& fn) const {
+  m_node_hash.query(rect, [&](std::uint32_t id, const nano::rect<float>&) { fn(m_nodes[id].node); });
+}
+
+template <class Fn>
+void node_graph::query_wires(const nano::rect<float>& rect, Fn&& fn) const {
+  m_wire_hash.query(rect, [&](std::uint32_t id, const nano::rect<float>&) { fn(m_wires[id].wire); });
+}
+} // namespace nano.
+
+NANO_CLANG_DIAGNOSTIC_POP()
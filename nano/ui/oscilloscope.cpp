@@ -0,0 +1,94 @@
+/*
+ * Nano Library
+ *
+ * Copyright (C) 2022, Meta-Sonic
+ * All rights reserved.
+ *
+ * Proprietary and confidential.
+ * Any unauthorized copying, alteration, distribution, transmission, performance,
+ * display or other use of this material is strictly prohibited.
+ *
+ * Written by Alexandre Arsenault <alx.arsenault@gmail.com>
+ */
+
+#include <nano/ui/oscilloscope.h>
+
+#include <algorithm>
+#include <cmath>
+
+NANO_CLANG_DIAGNOSTIC_PUSH()
+NANO_CLANG_DIAGNOSTIC(warning, "-Weverything")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wc++98-compat")
+
+namespace nano {
+
+//
+// MARK: - oscilloscope_view -
+//
+
+oscilloscope_view::oscilloscope_view(view* parent, const nano::rect<int>& rect)
+    : polled_view(parent, rect) {}
+
+void oscilloscope_view::set_range(float min_value, float max_value) {
+  m_min_value = min_value;
+  m_max_value = std::max(max_value, min_value + 1e-6f);
+  redraw();
+}
+
+void oscilloscope_view::set_colors(
+    const nano::color& background, const nano::color& trigger, const std::vector<nano::color>& channel_colors) {
+  m_background = background;
+  m_trigger_color = trigger;
+  m_channel_colors = channel_colors;
+  redraw();
+}
+
+void oscilloscope_view::on_draw(nano::graphic_context& gc, const nano::rect<float>& dirty_rect) {
+  gc.set_fill_color(m_background);
+  gc.fill_rect(dirty_rect);
+
+  const std::shared_ptr<oscilloscope_capture>& capture = get_source();
+  if (!capture || m_channel_colors.empty()) {
+    return;
+  }
+
+  set_drawn();
+
+  const oscilloscope_capture::options& opts = capture->get_options();
+  const oscilloscope_capture::frame& f = capture->get_frame();
+  const nano::size<int> size = get_frame().size;
+  const float width = static_cast<float>(size.width);
+  const float height = static_cast<float>(size.height);
+  const float scale = height / (m_max_value - m_min_value);
+
+  const auto get_y = [&](float value) { return std::clamp((m_max_value - value) * scale, 0.0f, height); };
+
+  // The trigger level and position.
+  if (opts.edge != oscilloscope_capture::trigger_edge::none) {
+    gc.set_fill_color(m_trigger_color);
+    gc.fill_rect(nano::rect<float>(0.0f, std::floor(get_y(opts.trigger_level)), width, 1.0f));
+    gc.fill_rect(nano::rect<float>(std::floor(opts.trigger_position * width), 0.0f, 1.0f, height));
+  }
+
+  const float point_width = width / static_cast<float>(opts.point_count);
+
+  for (std::size_t c = 0; c < static_cast<std::size_t>(opts.channel_count); c++) {
+    const float* mins = f.min.data() + c * opts.point_count;
+    const float* maxs = f.max.data() + c * opts.point_count;
+    gc.set_fill_color(m_channel_colors[c % m_channel_colors.size()]);
+
+    for (std::size_t j = 0; j < opts.point_count; j++) {
+      const float x = static_cast<float>(j) * point_width;
+      if (x + point_width < dirty_rect.x || x > dirty_rect.x + dirty_rect.width) {
+        continue;
+      }
+
+      const float top = get_y(maxs[j]) - 0.5f;
+      const float bottom = get_y(mins[j]) + 0.5f;
+      gc.fill_rect(nano::rect<float>(x, top, std::max(point_width, 1.0f), bottom - top));
+    }
+  }
+}
+} // namespace nano.
+
+NANO_CLANG_DIAGNOSTIC_POP()
@@ -0,0 +1,70 @@
+/*
+ * Nano Library
+ *
+ * Copyright (C) 2022, Meta-Sonic
+ * All rights reserved.
+ *
+ * Proprietary and confidential.
+ * Any unauthorized copying, alteration, distribution, transmission, performance,
+ * display or other use of this material is strictly prohibited.
+ *
+ * Written by Alexandre Arsenault <alx.arsenault@gmail.com>
+ */
+
+#pragma once
+
+/*!
+ * @file      nano/ui/oscilloscope.h
+ * @brief     nano ui oscilloscope
+ * @copyright Copyright (C) 2022, Meta-Sonic
+ * @author    Alexandre Arsenault alx.arsenault@gmail.com
+ * @date      Created 16/06/2022
+ */
+
+#include <nano/ui.h>
+#include <nano/ui/oscilloscope_capture.h>
+#include <nano/ui/polled_view.h>
+
+#include <memory>
+#include <vector>
+
+NANO_CLANG_DIAGNOSTIC_PUSH()
+NANO_CLANG_DIAGNOSTIC(warning, "-Weverything")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wc++98-compat")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wpadded")
+
+namespace nano {
+
+/// draws the windows of an oscilloscope capture.
+///
+/// @details a frame timer polls the capture and the view redraws only when a
+///          new window was published. each channel is drawn as one line
+///          through its decimated points, one vertical span per point.
+class oscilloscope_view : public polled_view<oscilloscope_capture> {
+public:
+  oscilloscope_view(view* parent, const nano::rect<int>& rect);
+
+  /// the capture can be shared by several views.
+  inline void set_capture(std::shared_ptr<oscilloscope_capture> capture) { set_source(std::move(capture)); }
+
+  inline const std::shared_ptr<oscilloscope_capture>& get_capture() const noexcept { return get_source(); }
+
+  /// sets the values at the bottom and top of the view.
+  void set_range(float min_value, float max_value);
+
+  void set_colors(
+      const nano::color& background, const nano::color& trigger, const std::vector<nano::color>& channel_colors);
+
+protected:
+  void on_draw(nano::graphic_context& gc, const nano::rect<float>& dirty_rect) override;
+
+private:
+  float m_min_value = -1.0f;
+  float m_max_value = 1.0f;
+  nano::color m_background = nano::color(0x18191BFF);
+  nano::color m_trigger_color = nano::color(0x5A5C60FF);
+  std::vector<nano::color> m_channel_colors = { nano::color(0x3FBF5FFF), nano::color(0x3FA9F5FF) };
+};
+} // namespace nano.
+
+NANO_CLANG_DIAGNOSTIC_POP()
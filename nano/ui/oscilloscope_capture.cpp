@@ -0,0 +1,221 @@
+/*
+ * Nano Library
+ *
+ * Copyright (C) 2022, Meta-Sonic
+ * All rights reserved.
+ *
+ * Proprietary and confidential.
+ * Any unauthorized copying, alteration, distribution, transmission, performance,
+ * display or other use of this material is strictly prohibited.
+ *
+ * Written by Alexandre Arsenault <alx.arsenault@gmail.com>
+ */
+
+#include <nano/ui/oscilloscope_capture.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+NANO_CLANG_DIAGNOSTIC_PUSH()
+NANO_CLANG_DIAGNOSTIC(warning, "-Weverything")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wc++98-compat")
+
+namespace nano {
+
+namespace {
+  oscilloscope_capture::options get_valid_options(oscilloscope_capture::options opts) {
+    opts.window_size = std::max<std::size_t>(opts.window_size, 2);
+    opts.point_count = std::clamp<std::size_t>(opts.point_count, 1, opts.window_size);
+    opts.channel_count = std::max(opts.channel_count, 1);
+    opts.trigger_channel = std::clamp(opts.trigger_channel, 0, opts.channel_count - 1);
+    opts.trigger_position = std::clamp(opts.trigger_position, 0.0f, 1.0f);
+    opts.hysteresis = std::max(opts.hysteresis, 0.0f);
+    opts.refresh_rate = std::max(opts.refresh_rate, 1.0f);
+    return opts;
+  }
+
+  /// the ring holds four windows or four refresh intervals, whichever is larger.
+  std::size_t get_ring_capacity(const oscilloscope_capture::options& opts) {
+    const std::size_t refresh_frames = static_cast<std::size_t>(opts.sample_rate / opts.refresh_rate);
+    return std::max(opts.window_size, refresh_frames) * 4;
+  }
+} // namespace.
+
+//
+// MARK: - oscilloscope_capture -
+//
+
+oscilloscope_capture::oscilloscope_capture(const options& opts)
+    : m_options(get_valid_options(opts))
+    , m_ring(get_ring_capacity(m_options), m_options.channel_count) {
+  const std::size_t window_size = m_options.window_size;
+  const std::size_t channel_count = static_cast<std::size_t>(m_options.channel_count);
+
+  m_pre_trigger = static_cast<std::size_t>(std::lround(m_options.trigger_position * static_cast<float>(window_size)));
+  m_pre_trigger = std::min(m_pre_trigger, window_size - 1);
+  m_auto_frames = std::max<std::uint64_t>(
+      window_size * 2, static_cast<std::uint64_t>(m_options.auto_time * m_options.sample_rate));
+
+  m_history_size = window_size * 2;
+  m_history.resize(m_history_size * channel_count, 0.0f);
+  m_read_pointers.resize(channel_count);
+
+  frame empty;
+  empty.min.resize(m_options.point_count * channel_count, 0.0f);
+  empty.max.resize(m_options.point_count * channel_count, 0.0f);
+  m_published.reset(empty);
+}
+
+oscilloscope_capture::~oscilloscope_capture() { stop(); }
+
+void oscilloscope_capture::start() { m_worker.start(m_options.refresh_rate, [this]() { update(); }); }
+
+void oscilloscope_capture::stop() { m_worker.stop(); }
+
+void oscilloscope_capture::detect_trigger(const float* samples, std::size_t count, std::uint64_t position) noexcept {
+  const float level = m_options.trigger_level;
+  const float rearm_level
+      = m_options.edge == trigger_edge::rising ? level - m_options.hysteresis : level + m_options.hysteresis;
+  const bool rising = m_options.edge == trigger_edge::rising;
+  const std::uint64_t history_start = m_position - m_history_count;
+
+  for (std::size_t i = 0; i < count; i++) {
+    const float x = samples[i];
+
+    // The trigger is armed once the signal went past the hysteresis, and fires when it crosses the level.
+    if (rising ? x < rearm_level : x > rearm_level) {
+      m_armed = true;
+      continue;
+    }
+
+    if (!m_armed || (rising ? x < level : x > level)) {
+      continue;
+    }
+
+    m_armed = false;
+    const std::uint64_t trigger = position + i;
+
+    if (trigger < m_holdoff_end || trigger < history_start + m_pre_trigger) {
+      continue;
+    }
+
+    // A newer trigger replaces a complete window that was not shown yet.
+    if (m_pending) {
+      decimate(m_pending_start, true);
+    }
+
+    m_trigger_count++;
+    m_pending = true;
+    m_pending_start = trigger - m_pre_trigger;
+    m_holdoff_end = m_pending_start + m_options.window_size;
+  }
+}
+
+void oscilloscope_capture::decimate(std::uint64_t start, bool triggered) noexcept {
+  const std::size_t window_size = m_options.window_size;
+  const std::size_t point_count = m_options.point_count;
+  const std::size_t offset = static_cast<std::size_t>(start - (m_position - m_history_count));
+
+  frame& f = m_published.get_back();
+  f.triggered = triggered;
+
+  for (std::size_t c = 0; c < static_cast<std::size_t>(m_options.channel_count); c++) {
+    const float* samples = m_history.data() + c * m_history_size + offset;
+    float* mins = f.min.data() + c * point_count;
+    float* maxs = f.max.data() + c * point_count;
+
+    for (std::size_t j = 0; j < point_count; j++) {
+      const std::size_t first = j * window_size / point_count;
+      const std::size_t last = (j + 1) * window_size / point_count;
+
+      // Each point starts from the last sample of the previous one, so the spans connect into one line.
+      float lo = samples[first > 0 ? first - 1 : 0];
+      float hi = lo;
+
+      for (std::size_t i = first; i < last; i++) {
+        lo = std::min(lo, samples[i]);
+        hi = std::max(hi, samples[i]);
+      }
+
+      mins[j] = lo;
+      maxs[j] = hi;
+    }
+  }
+
+  m_has_frame = true;
+}
+
+bool oscilloscope_capture::update() {
+  const std::size_t window_size = m_options.window_size;
+  const std::size_t channel_count = static_cast<std::size_t>(m_options.channel_count);
+
+  std::size_t available = m_ring.get_read_available();
+  if (available == 0) {
+    return false;
+  }
+
+  m_has_frame = false;
+
+  // Every frame is searched for triggers, the ring holds a few windows at most. The
+  // frames are read a window at a time, so the pending window is never shifted out.
+  while (available > 0) {
+    const std::size_t count = std::min(available, window_size);
+
+    if (m_history_count + count > m_history_size) {
+      const std::size_t shift = m_history_count + count - m_history_size;
+      for (std::size_t c = 0; c < channel_count; c++) {
+        float* history = m_history.data() + c * m_history_size;
+        std::memmove(history, history + shift, (m_history_count - shift) * sizeof(float));
+      }
+
+      m_history_count -= shift;
+    }
+
+    for (std::size_t c = 0; c < channel_count; c++) {
+      m_read_pointers[c] = m_history.data() + c * m_history_size + m_history_count;
+    }
+
+    m_ring.read(m_read_pointers.data(), count);
+    const std::uint64_t first = m_position;
+    m_history_count += count;
+    m_position += count;
+    available -= count;
+
+    if (m_options.edge != trigger_edge::none) {
+      const std::size_t trigger_channel = static_cast<std::size_t>(m_options.trigger_channel);
+      detect_trigger(m_read_pointers[trigger_channel], count, first);
+    }
+
+    if (m_pending && m_pending_start + window_size <= m_position) {
+      decimate(m_pending_start, true);
+      m_pending = false;
+    }
+  }
+
+  // Free running without a trigger, or when none was found for a while.
+  if (!m_has_frame && m_history_count >= window_size
+      && (m_options.edge == trigger_edge::none || m_position - m_last_publish >= m_auto_frames)) {
+    decimate(m_position - window_size, false);
+  }
+
+  if (!m_has_frame) {
+    return false;
+  }
+
+  m_last_publish = m_position;
+  m_published.publish();
+  return true;
+}
+
+bool oscilloscope_capture::poll() noexcept {
+  if (!m_published.update()) {
+    return false;
+  }
+
+  m_frame_index++;
+  return true;
+}
+} // namespace nano.
+
+NANO_CLANG_DIAGNOSTIC_POP()
@@ -0,0 +1,163 @@
+/*
+ * Nano Library
+ *
+ * Copyright (C) 2022, Meta-Sonic
+ * All rights reserved.
+ *
+ * Proprietary and confidential.
+ * Any unauthorized copying, alteration, distribution, transmission, performance,
+ * display or other use of this material is strictly prohibited.
+ *
+ * Written by Alexandre Arsenault <alx.arsenault@gmail.com>
+ */
+
+#pragma once
+
+/*!
+ * @file      nano/ui/oscilloscope_capture.h
+ * @brief     nano ui oscilloscope capture
+ * @copyright Copyright (C) 2022, Meta-Sonic
+ * @author    Alexandre Arsenault alx.arsenault@gmail.com
+ * @date      Created 16/06/2022
+ */
+
+#include <nano/graphics.h>
+#include <nano/ui/periodic_worker.h>
+#include <nano/ui/sample_ring.h>
+
+#include <cstdint>
+#include <vector>
+
+NANO_CLANG_DIAGNOSTIC_PUSH()
+NANO_CLANG_DIAGNOSTIC(warning, "-Weverything")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wc++98-compat")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wpadded")
+
+namespace nano {
+
+/// captures triggered windows of the samples pushed by the audio thread.
+///
+/// @details push() copies the samples into a lock-free ring and returns, it
+///          never allocates, locks or waits. a worker thread drains the ring,
+///          looks for the trigger edge on one channel and, once the window
+///          around a trigger is complete, decimates it to point_count min and
+///          max values per channel. only these points are published to the
+///          view, through a triple buffer.
+///
+///          without a trigger for auto_time seconds, the latest window is
+///          published untriggered so that a flat signal is still shown.
+class oscilloscope_capture {
+public:
+  enum class trigger_edge : std::uint8_t { none, rising, falling };
+
+  struct options {
+    /// the number of frames shown.
+    std::size_t window_size = 2048;
+    /// the number of decimated points per channel, at most window_size.
+    std::size_t point_count = 512;
+    int channel_count = 1;
+    float sample_rate = 48000.0f;
+    /// updates per second of the worker.
+    float refresh_rate = 60.0f;
+
+    trigger_edge edge = trigger_edge::rising;
+    int trigger_channel = 0;
+    float trigger_level = 0.0f;
+    /// how far the signal must go past the level, in the other direction, to rearm the trigger.
+    float hysteresis = 0.01f;
+    /// where the trigger is in the window, from 0 (left) to 1 (right).
+    float trigger_position = 0.25f;
+    /// the time without trigger after which the window is shown anyway, in seconds.
+    float auto_time = 0.1f;
+  };
+
+  /// the decimated window of every channel.
+  struct frame {
+    /// point_count values per channel.
+    std::vector<float> min;
+    std::vector<float> max;
+    bool triggered = false;
+  };
+
+  oscilloscope_capture(const options& opts);
+
+  oscilloscope_capture(const oscilloscope_capture&) = delete;
+  oscilloscope_capture(oscilloscope_capture&&) = delete;
+
+  /// stops the worker.
+  ~oscilloscope_capture();
+
+  oscilloscope_capture& operator=(const oscilloscope_capture&) = delete;
+  oscilloscope_capture& operator=(oscilloscope_capture&&) = delete;
+
+  inline const options& get_options() const noexcept { return m_options; }
+
+  /// copies samples from the audio thread, never blocks or allocates.
+  inline void push(const float* const* channels, std::size_t frame_count) noexcept {
+    m_ring.write(channels, frame_count);
+  }
+
+  /// returns the number of frames dropped because the worker was late.
+  inline std::uint64_t get_dropped_count() const noexcept { return m_ring.get_dropped_count(); }
+
+  /// starts the worker thread.
+  void start();
+
+  void stop();
+
+  inline bool is_running() const noexcept { return m_worker.is_running(); }
+
+  /// drains the ring, detects the triggers and publishes the latest complete window.
+  ///
+  /// @details this is called by the worker but can also be called manually
+  ///          (e.g. for testing) while it is not running.
+  /// @returns true if a new window was published.
+  bool update();
+
+  /// takes the latest published window, from the ui thread.
+  /// @returns true if it changed since the last call.
+  bool poll() noexcept;
+
+  /// returns the window taken by the last poll().
+  inline const frame& get_frame() const noexcept { return m_published.get_front(); }
+
+  /// returns the number of windows taken by poll().
+  inline std::uint64_t get_frame_index() const noexcept { return m_frame_index; }
+
+  /// returns the number of triggers found since the capture was created.
+  inline std::uint64_t get_trigger_count() const noexcept { return m_trigger_count; }
+
+private:
+  options m_options;
+  sample_ring m_ring;
+  std::size_t m_pre_trigger;
+  std::uint64_t m_auto_frames;
+
+  // Worker state, the history holds the last two windows of every channel.
+  std::vector<float> m_history;
+  std::vector<float*> m_read_pointers;
+  std::size_t m_history_size;
+  std::size_t m_history_count = 0;
+  /// the index of the frame after the last one read.
+  std::uint64_t m_position = 0;
+  /// the window start of a trigger waiting for its last frames.
+  std::uint64_t m_pending_start = 0;
+  std::uint64_t m_holdoff_end = 0;
+  std::uint64_t m_last_publish = 0;
+  std::uint64_t m_trigger_count = 0;
+  bool m_armed = false;
+  bool m_pending = false;
+  /// a window was decimated into the back buffer during this update.
+  bool m_has_frame = false;
+
+  triple_buffer<frame> m_published;
+  std::uint64_t m_frame_index = 0;
+
+  periodic_worker m_worker;
+
+  void detect_trigger(const float* samples, std::size_t count, std::uint64_t position) noexcept;
+  void decimate(std::uint64_t start, bool triggered) noexcept;
+};
+} // namespace nano.
+
+NANO_CLANG_DIAGNOSTIC_POP()
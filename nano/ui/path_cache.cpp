@@ -0,0 +1,572 @@
+/*
+ * Nano Library
+ *
+ * Copyright (C) 2022, Meta-Sonic
+ * All rights reserved.
+ *
+ * Proprietary and confidential.
+ * Any unauthorized copying, alteration, distribution, transmission, performance,
+ * display or other use of this material is strictly prohibited.
+ *
+ * Written by Alexandre Arsenault <alx.arsenault@gmail.com>
+ */
+
+#include <nano/ui/path_cache.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+NANO_CLANG_DIAGNOSTIC_PUSH()
+NANO_CLANG_DIAGNOSTIC(warning, "-Weverything")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wc++98-compat")
+
+namespace nano {
+
+namespace {
+  constexpr float pi = 3.14159265358979f;
+
+  // Distance of the control points of a cubic approximating a quarter circle.
+  constexpr float kappa = 0.5522847498f;
+
+  inline nano::point<float> lerp(const nano::point<float>& a, const nano::point<float>& b, float t) noexcept {
+    return nano::point<float>(a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t);
+  }
+
+  inline float length(float x, float y) noexcept { return std::sqrt(x * x + y * y); }
+
+  inline std::size_t hash_combine(std::size_t seed, std::uint32_t value) noexcept {
+    return seed ^ (static_cast<std::size_t>(value) + 0x9E3779B9u + (seed << 6) + (seed >> 2));
+  }
+
+  inline std::uint32_t float_bits(float value) noexcept {
+    std::uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+  }
+
+  /// number of lines needed to approximate a curve (Wang's formula).
+  inline int get_segment_count(float second_difference, float factor, float tolerance) noexcept {
+    const float n = std::ceil(std::sqrt(factor * second_difference / tolerance));
+    return std::clamp(static_cast<int>(n), 1, 256);
+  }
+
+  /// accumulates the signed area covered by a line in each pixel.
+  ///
+  /// @details the coverage of a pixel is the prefix sum of the accumulation
+  ///          buffer along its row. the buffer is width + 2 floats per row.
+  void accumulate_line(std::vector<float>& acc, int width, int height, nano::point<float> p0, nano::point<float> p1) {
+    if (p0.y == p1.y) {
+      return;
+    }
+
+    float dir = 1.0f;
+    if (p0.y > p1.y) {
+      std::swap(p0, p1);
+      dir = -1.0f;
+    }
+
+    const float dxdy = (p1.x - p0.x) / (p1.y - p0.y);
+    const int stride = width + 2;
+    float x = p0.x;
+
+    const int y_start = std::max(static_cast<int>(p0.y), 0);
+    const int y_end = std::min(static_cast<int>(std::ceil(p1.y)), height);
+
+    if (p0.y < 0.0f) {
+      x -= p0.y * dxdy;
+    }
+
+    for (int y = y_start; y < y_end; y++) {
+      float* row = acc.data() + static_cast<std::size_t>(y * stride);
+      const float dy = std::min(static_cast<float>(y + 1), p1.y) - std::max(static_cast<float>(y), p0.y);
+      const float x_next = x + dxdy * dy;
+      const float d = dy * dir;
+
+      const float x0 = std::clamp(std::min(x, x_next), 0.0f, static_cast<float>(width));
+      const float x1 = std::clamp(std::max(x, x_next), 0.0f, static_cast<float>(width));
+      const float x0_floor = std::floor(x0);
+      const float x1_ceil = std::ceil(x1);
+      const int x0i = static_cast<int>(x0_floor);
+      const int x1i = static_cast<int>(x1_ceil);
+
+      if (x1i <= x0i + 1) {
+        const float xm = 0.5f * (x0 + x1) - x0_floor;
+        row[x0i] += d - d * xm;
+        row[x0i + 1] += d * xm;
+      }
+      else {
+        const float s = 1.0f / (x1 - x0);
+        const float x0f = x0 - x0_floor;
+        const float a0 = 0.5f * s * (1.0f - x0f) * (1.0f - x0f);
+        const float x1f = x1 - x1_ceil + 1.0f;
+        const float am = 0.5f * s * x1f * x1f;
+
+        row[x0i] += d * a0;
+
+        if (x1i == x0i + 2) {
+          row[x0i + 1] += d * (1.0f - a0 - am);
+        }
+        else {
+          const float a1 = s * (1.5f - x0f);
+          row[x0i + 1] += d * (a1 - a0);
+
+          for (int xi = x0i + 2; xi < x1i - 1; xi++) {
+            row[xi] += d * s;
+          }
+
+          const float a2 = a1 + static_cast<float>(x1i - x0i - 3) * s;
+          row[x1i - 1] += d * (1.0f - a2 - am);
+        }
+
+        row[x1i] += d * am;
+      }
+
+      x = x_next;
+    }
+  }
+
+  void rasterize(flattened_path& path) {
+    const int width = path.bounds.width;
+    const int height = path.bounds.height;
+
+    if (width <= 0 || height <= 0) {
+      return;
+    }
+
+    // Reused between calls to avoid an allocation per path.
+    thread_local std::vector<float> acc;
+    acc.assign(static_cast<std::size_t>((width + 2) * height), 0.0f);
+
+    const nano::point<float> origin(static_cast<float>(path.bounds.x), static_cast<float>(path.bounds.y));
+
+    for (const std::vector<nano::point<float>>& contour : path.contours) {
+      for (std::size_t i = 0; i < contour.size(); i++) {
+        // Contours are implicitly closed.
+        const nano::point<float>& a = contour[i];
+        const nano::point<float>& b = contour[(i + 1) % contour.size()];
+        accumulate_line(acc, width, height, nano::point<float>(a.x - origin.x, a.y - origin.y),
+            nano::point<float>(b.x - origin.x, b.y - origin.y));
+      }
+    }
+
+    for (int y = 0; y < height; y++) {
+      const float* row = acc.data() + static_cast<std::size_t>(y * (width + 2));
+      float sum = 0.0f;
+      coverage_span span = { 0, path.bounds.y + y, 0, 0 };
+
+      for (int x = 0; x < width; x++) {
+        sum += row[x];
+        const std::uint8_t coverage
+            = static_cast<std::uint8_t>(std::lround(std::min(std::abs(sum), 1.0f) * 255.0f));
+
+        if (span.length && span.coverage == coverage) {
+          span.length++;
+          continue;
+        }
+
+        if (span.length && span.coverage) {
+          path.spans.push_back(span);
+        }
+
+        span = { path.bounds.x + x, path.bounds.y + y, 1, coverage };
+      }
+
+      if (span.length && span.coverage) {
+        path.spans.push_back(span);
+      }
+    }
+  }
+} // namespace.
+
+//
+// MARK: - path_geometry -
+//
+
+void path_geometry::move_to(const nano::point<float>& p) {
+  m_commands.push_back(command::move);
+  m_points.push_back(p);
+  m_hash = 0;
+}
+
+void path_geometry::line_to(const nano::point<float>& p) {
+  m_commands.push_back(command::line);
+  m_points.push_back(p);
+  m_hash = 0;
+}
+
+void path_geometry::quad_to(const nano::point<float>& c, const nano::point<float>& p) {
+  m_commands.push_back(command::quad);
+  m_points.push_back(c);
+  m_points.push_back(p);
+  m_hash = 0;
+}
+
+void path_geometry::cubic_to(const nano::point<float>& c1, const nano::point<float>& c2, const nano::point<float>& p) {
+  m_commands.push_back(command::cubic);
+  m_points.push_back(c1);
+  m_points.push_back(c2);
+  m_points.push_back(p);
+  m_hash = 0;
+}
+
+void path_geometry::close() {
+  m_commands.push_back(command::close);
+  m_hash = 0;
+}
+
+void path_geometry::add_rect(const nano::rect<float>& r) {
+  move_to(nano::point<float>(r.x, r.y));
+  line_to(nano::point<float>(r.x + r.width, r.y));
+  line_to(nano::point<float>(r.x + r.width, r.y + r.height));
+  line_to(nano::point<float>(r.x, r.y + r.height));
+  close();
+}
+
+void path_geometry::add_rounded_rect(const nano::rect<float>& r, float radius) {
+  radius = std::min(radius, std::min(r.width, r.height) * 0.5f);
+
+  if (radius <= 0.0f) {
+    add_rect(r);
+    return;
+  }
+
+  const float left = r.x;
+  const float top = r.y;
+  const float right = r.x + r.width;
+  const float bottom = r.y + r.height;
+
+  move_to(nano::point<float>(left + radius, top));
+  add_arc(nano::point<float>(right - radius, top + radius), radius, -pi * 0.5f, 0.0f, true);
+  add_arc(nano::point<float>(right - radius, bottom - radius), radius, 0.0f, pi * 0.5f, true);
+  add_arc(nano::point<float>(left + radius, bottom - radius), radius, pi * 0.5f, pi, true);
+  add_arc(nano::point<float>(left + radius, top + radius), radius, pi, pi * 1.5f, true);
+  close();
+}
+
+void path_geometry::add_ellipse(const nano::rect<float>& r) {
+  const float rx = r.width * 0.5f;
+  const float ry = r.height * 0.5f;
+  const float cx = r.x + rx;
+  const float cy = r.y + ry;
+  const float kx = rx * kappa;
+  const float ky = ry * kappa;
+
+  move_to(nano::point<float>(cx + rx, cy));
+  cubic_to(nano::point<float>(cx + rx, cy + ky), nano::point<float>(cx + kx, cy + ry), nano::point<float>(cx, cy + ry));
+  cubic_to(nano::point<float>(cx - kx, cy + ry), nano::point<float>(cx - rx, cy + ky), nano::point<float>(cx - rx, cy));
+  cubic_to(nano::point<float>(cx - rx, cy - ky), nano::point<float>(cx - kx, cy - ry), nano::point<float>(cx, cy - ry));
+  cubic_to(nano::point<float>(cx + kx, cy - ry), nano::point<float>(cx + rx, cy - ky), nano::point<float>(cx + rx, cy));
+  close();
+}
+
+void path_geometry::add_arc(
+    const nano::point<float>& center, float radius, float start_angle, float end_angle, bool connect) {
+  const auto point_at = [&](float angle) {
+    return nano::point<float>(center.x + radius * std::cos(angle), center.y + radius * std::sin(angle));
+  };
+
+  if (connect && !m_commands.empty()) {
+    line_to(point_at(start_angle));
+  }
+  else {
+    move_to(point_at(start_angle));
+  }
+
+  // One cubic per quarter circle at most.
+  const float sweep = end_angle - start_angle;
+  const int count = std::max(static_cast<int>(std::ceil(std::abs(sweep) / (pi * 0.5f) - 1e-4f)), 1);
+  const float step = sweep / static_cast<float>(count);
+  const float k = 4.0f / 3.0f * std::tan(step * 0.25f) * radius;
+
+  float angle = start_angle;
+  for (int i = 0; i < count; i++) {
+    const float next = angle + step;
+    const float c0 = std::cos(angle);
+    const float s0 = std::sin(angle);
+    const float c1 = std::cos(next);
+    const float s1 = std::sin(next);
+
+    cubic_to(nano::point<float>(center.x + radius * c0 - k * s0, center.y + radius * s0 + k * c0),
+        nano::point<float>(center.x + radius * c1 + k * s1, center.y + radius * s1 - k * c1),
+        nano::point<float>(center.x + radius * c1, center.y + radius * s1));
+    angle = next;
+  }
+}
+
+void path_geometry::add_arc_stroke(
+    const nano::point<float>& center, float radius, float start_angle, float end_angle, float line_width) {
+  const float half = line_width * 0.5f;
+  add_arc(center, radius + half, start_angle, end_angle);
+  add_arc(center, std::max(radius - half, 0.0f), end_angle, start_angle, true);
+  close();
+}
+
+void path_geometry::clear() {
+  m_commands.clear();
+  m_points.clear();
+  m_hash = 0;
+}
+
+std::size_t path_geometry::get_hash() const noexcept {
+  if (m_hash) {
+    return m_hash;
+  }
+
+  std::size_t hash = m_commands.size();
+
+  for (command c : m_commands) {
+    hash = hash_combine(hash, static_cast<std::uint32_t>(c));
+  }
+
+  for (const nano::point<float>& p : m_points) {
+    hash = hash_combine(hash, float_bits(p.x));
+    hash = hash_combine(hash, float_bits(p.y));
+  }
+
+  m_hash = hash;
+  return hash;
+}
+
+bool path_geometry::operator==(const path_geometry& other) const noexcept {
+  return m_commands == other.m_commands && m_points.size() == other.m_points.size()
+      && std::equal(m_points.begin(), m_points.end(), other.m_points.begin(),
+          [](const nano::point<float>& a, const nano::point<float>& b) { return a.x == b.x && a.y == b.y; });
+}
+
+//
+// MARK: - flatten -
+//
+
+std::size_t flattened_path::get_byte_size() const noexcept {
+  std::size_t size = sizeof(flattened_path) + spans.size() * sizeof(coverage_span);
+
+  for (const std::vector<nano::point<float>>& contour : contours) {
+    size += sizeof(contour) + contour.size() * sizeof(nano::point<float>);
+  }
+
+  return size;
+}
+
+flattened_path flatten(const path_geometry& path, float scale, float tolerance) {
+  flattened_path result;
+
+  const std::vector<path_geometry::command>& commands = path.get_commands();
+  const std::vector<nano::point<float>>& points = path.get_points();
+
+  std::vector<nano::point<float>>* contour = nullptr;
+  nano::point<float> current(0.0f, 0.0f);
+  std::size_t index = 0;
+
+  const auto next_point = [&]() {
+    const nano::point<float>& p = points[index++];
+    return nano::point<float>(p.x * scale, p.y * scale);
+  };
+
+  const auto current_contour = [&]() {
+    if (!contour) {
+      contour = &result.contours.emplace_back();
+      contour->push_back(current);
+    }
+    return contour;
+  };
+
+  for (path_geometry::command c : commands) {
+    switch (c) {
+    case path_geometry::command::move:
+      current = next_point();
+      contour = &result.contours.emplace_back();
+      contour->push_back(current);
+      break;
+
+    case path_geometry::command::line:
+      current = next_point();
+      current_contour()->push_back(current);
+      break;
+
+    case path_geometry::command::quad: {
+      const nano::point<float> p0 = current;
+      const nano::point<float> p1 = next_point();
+      const nano::point<float> p2 = next_point();
+      const float dd = length(p0.x - 2.0f * p1.x + p2.x, p0.y - 2.0f * p1.y + p2.y);
+      const int n = get_segment_count(dd, 0.25f, tolerance);
+
+      std::vector<nano::point<float>>* cont = current_contour();
+      for (int i = 1; i <= n; i++) {
+        const float t = static_cast<float>(i) / static_cast<float>(n);
+        cont->push_back(lerp(lerp(p0, p1, t), lerp(p1, p2, t), t));
+      }
+
+      current = p2;
+    } break;
+
+    case path_geometry::command::cubic: {
+      const nano::point<float> p0 = current;
+      const nano::point<float> p1 = next_point();
+      const nano::point<float> p2 = next_point();
+      const nano::point<float> p3 = next_point();
+      const float dd = std::max(length(p0.x - 2.0f * p1.x + p2.x, p0.y - 2.0f * p1.y + p2.y),
+          length(p1.x - 2.0f * p2.x + p3.x, p1.y - 2.0f * p2.y + p3.y));
+      const int n = get_segment_count(dd, 0.75f, tolerance);
+
+      std::vector<nano::point<float>>* cont = current_contour();
+      for (int i = 1; i <= n; i++) {
+        const float t = static_cast<float>(i) / static_cast<float>(n);
+        const nano::point<float> a = lerp(p0, p1, t);
+        const nano::point<float> b = lerp(p1, p2, t);
+        const nano::point<float> d = lerp(p2, p3, t);
+        cont->push_back(lerp(lerp(a, b, t), lerp(b, d, t), t));
+      }
+
+      current = p3;
+    } break;
+
+    case path_geometry::command::close:
+      if (contour) {
+        current = contour->front();
+      }
+
+      contour = nullptr;
+      break;
+    }
+  }
+
+  // Bounds.
+  float left = 0.0f;
+  float top = 0.0f;
+  float right = 0.0f;
+  float bottom = 0.0f;
+  bool first = true;
+
+  for (const std::vector<nano::point<float>>& cont : result.contours) {
+    for (const nano::point<float>& p : cont) {
+      left = first ? p.x : std::min(left, p.x);
+      top = first ? p.y : std::min(top, p.y);
+      right = first ? p.x : std::max(right, p.x);
+      bottom = first ? p.y : std::max(bottom, p.y);
+      first = false;
+    }
+  }
+
+  if (!first) {
+    const int x = static_cast<int>(std::floor(left));
+    const int y = static_cast<int>(std::floor(top));
+    result.bounds = nano::rect<int>(
+        x, y, static_cast<int>(std::ceil(right)) - x + 1, static_cast<int>(std::ceil(bottom)) - y + 1);
+  }
+
+  rasterize(result);
+  return result;
+}
+
+void fill(pixel_buffer& buffer, const flattened_path& path, const nano::point<int>& offset, std::uint32_t pixel) {
+  const nano::rect<int> buffer_bounds = buffer.get_bounds();
+  const bool opaque = get_pixel_alpha(pixel) == 255;
+
+  for (const coverage_span& span : path.spans) {
+    const int y = span.y + offset.y;
+    const int x0 = std::max(span.x + offset.x, 0);
+    const int x1 = std::min(span.x + offset.x + span.length, buffer_bounds.width);
+
+    if (y < 0 || y >= buffer_bounds.height || x0 >= x1) {
+      continue;
+    }
+
+    pixel_buffer::pixel_type* row = buffer.row(y);
+
+    if (span.coverage == 255 && opaque) {
+      std::fill(row + x0, row + x1, pixel);
+      continue;
+    }
+
+    for (int x = x0; x < x1; x++) {
+      row[x] = blend_pixel(row[x], pixel, span.coverage);
+    }
+  }
+}
+
+//
+// MARK: - path_cache -
+//
+
+path_cache::path_cache(std::size_t capacity)
+    : m_capacity(capacity) {}
+
+path_cache& path_cache::get_main() {
+  NANO_CLANG_PUSH_WARNING("-Wexit-time-destructors")
+  static path_cache cache;
+  NANO_CLANG_POP_WARNING()
+  return cache;
+}
+
+std::shared_ptr<const flattened_path> path_cache::get(const path_geometry& path, float scale) {
+  const std::size_t hash = hash_combine(path.get_hash(), float_bits(scale));
+  const auto range = m_index.equal_range(hash);
+
+  for (auto it = range.first; it != range.second; ++it) {
+    const entry_list::iterator entry_it = it->second;
+
+    if (entry_it->scale == scale && entry_it->path == path) {
+      m_stats.hits++;
+      m_entries.splice(m_entries.begin(), m_entries, entry_it);
+      return entry_it->flattened;
+    }
+  }
+
+  m_stats.misses++;
+
+  std::shared_ptr<const flattened_path> flattened = std::make_shared<const flattened_path>(flatten(path, scale));
+  const std::size_t byte_size = flattened->get_byte_size();
+
+  if (byte_size > m_capacity) {
+    return flattened;
+  }
+
+  evict(m_capacity - byte_size);
+
+  m_entries.push_front(entry{ path, scale, hash, flattened });
+  m_index.emplace(hash, m_entries.begin());
+  m_byte_size += byte_size;
+  return flattened;
+}
+
+void path_cache::set_capacity(std::size_t capacity) {
+  m_capacity = capacity;
+  evict(capacity);
+}
+
+void path_cache::clear() {
+  m_entries.clear();
+  m_index.clear();
+  m_byte_size = 0;
+}
+
+path_cache::stats path_cache::get_stats() const noexcept {
+  stats s = m_stats;
+  s.entry_count = m_entries.size();
+  s.byte_size = m_byte_size;
+  return s;
+}
+
+void path_cache::reset_stats() noexcept { m_stats = stats(); }
+
+void path_cache::evict(std::size_t capacity) {
+  while (m_byte_size > capacity && !m_entries.empty()) {
+    const entry& last = m_entries.back();
+
+    const auto range = m_index.equal_range(last.hash);
+    for (auto it = range.first; it != range.second; ++it) {
+      if (&*it->second == &last) {
+        m_index.erase(it);
+        break;
+      }
+    }
+
+    m_byte_size -= last.flattened->get_byte_size();
+    m_entries.pop_back();
+    m_stats.evictions++;
+  }
+}
+} // namespace nano.
+
+NANO_CLANG_DIAGNOSTIC_POP()
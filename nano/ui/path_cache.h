@@ -0,0 +1,189 @@
+/*
+ * Nano Library
+ *
+ * Copyright (C) 2022, Meta-Sonic
+ * All rights reserved.
+ *
+ * Proprietary and confidential.
+ * Any unauthorized copying, alteration, distribution, transmission, performance,
+ * display or other use of this material is strictly prohibited.
+ *
+ * Written by Alexandre Arsenault <alx.arsenault@gmail.com>
+ */
+
+#pragma once
+
+/*!
+ * @file      nano/ui/path_cache.h
+ * @brief     nano ui path flattening and cache
+ * @copyright Copyright (C) 2022, Meta-Sonic
+ * @author    Alexandre Arsenault alx.arsenault@gmail.com
+ * @date      Created 16/06/2022
+ */
+
+#include <nano/graphics.h>
+#include <nano/ui/pixel_buffer.h>
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+NANO_CLANG_DIAGNOSTIC_PUSH()
+NANO_CLANG_DIAGNOSTIC(warning, "-Weverything")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wc++98-compat")
+
+namespace nano {
+
+/// geometry of a path made of lines and bezier curves.
+///
+/// @details arcs, ellipses and rounded rects are converted to cubic curves.
+///          the geometry is the key of the path cache, so shapes that are drawn
+///          at many places (e.g. knobs) should be built at the origin and
+///          offset when filled.
+class path_geometry {
+public:
+  enum class command : std::uint8_t { move, line, quad, cubic, close };
+
+  path_geometry() = default;
+
+  void move_to(const nano::point<float>& p);
+  void line_to(const nano::point<float>& p);
+  void quad_to(const nano::point<float>& c, const nano::point<float>& p);
+  void cubic_to(const nano::point<float>& c1, const nano::point<float>& c2, const nano::point<float>& p);
+  void close();
+
+  void add_rect(const nano::rect<float>& r);
+  void add_rounded_rect(const nano::rect<float>& r, float radius);
+  void add_ellipse(const nano::rect<float>& r);
+
+  /// adds an arc of circle, angles are in radians and clockwise (y is down).
+  /// @param connect when true, the arc is connected to the current point instead of starting a new contour.
+  void add_arc(
+      const nano::point<float>& center, float radius, float start_angle, float end_angle, bool connect = false);
+
+  /// adds the closed outline of an arc stroked with the given line width (butt caps).
+  void add_arc_stroke(
+      const nano::point<float>& center, float radius, float start_angle, float end_angle, float line_width);
+
+  void clear();
+
+  inline bool empty() const noexcept { return m_commands.empty(); }
+
+  inline const std::vector<command>& get_commands() const noexcept { return m_commands; }
+
+  /// the points of all the commands, in order (1 for move and line, 2 for quad and 3 for cubic).
+  inline const std::vector<nano::point<float>>& get_points() const noexcept { return m_points; }
+
+  std::size_t get_hash() const noexcept;
+
+  bool operator==(const path_geometry& other) const noexcept;
+  inline bool operator!=(const path_geometry& other) const noexcept { return !operator==(other); }
+
+private:
+  std::vector<command> m_commands;
+  std::vector<nano::point<float>> m_points;
+  mutable std::size_t m_hash = 0;
+};
+
+/// horizontal run of pixels with the same coverage.
+struct coverage_span {
+  int x;
+  int y;
+  int length;
+  std::uint8_t coverage;
+};
+
+/// a path flattened into polylines and rasterized into coverage spans.
+///
+/// @details coordinates are in pixels (path coordinates times the scale).
+///          the spans are computed with the non-zero fill rule and exact area
+///          coverage for anti-aliasing.
+struct flattened_path {
+  std::vector<std::vector<nano::point<float>>> contours;
+  std::vector<coverage_span> spans;
+  nano::rect<int> bounds = { 0, 0, 0, 0 };
+
+  std::size_t get_byte_size() const noexcept;
+};
+
+/// flattens the curves with a maximum distance of tolerance pixels to the real curve.
+flattened_path flatten(const path_geometry& path, float scale, float tolerance = 0.25f);
+
+/// blends the coverage spans of a flattened path into the buffer (source over).
+/// @param pixel a premultiplied pixel (see to_pixel()).
+void fill(pixel_buffer& buffer, const flattened_path& path, const nano::point<int>& offset, std::uint32_t pixel);
+
+/// fills the path through path_cache::get_main(), offset by the given point.
+/// @details the path is flattened once per device scale of the context, its
+///          polygons are filled with the non-zero rule without flattening the
+///          curves again on every draw.
+void fill_path(nano::graphic_context& gc, const path_geometry& path, const nano::point<float>& offset,
+    const nano::color& c);
+
+/// least recently used cache of flattened paths, keyed by geometry and scale.
+///
+/// @details the cache is not thread safe, get_main() is meant to be used on
+///          the main thread only.
+class path_cache {
+public:
+  struct stats {
+    std::uint64_t hits = 0;
+    std::uint64_t misses = 0;
+    std::uint64_t evictions = 0;
+    std::size_t entry_count = 0;
+    std::size_t byte_size = 0;
+  };
+
+  static constexpr std::size_t default_capacity = 8 * 1024 * 1024;
+
+  /// @param capacity the maximum size of the cached paths in bytes.
+  path_cache(std::size_t capacity = default_capacity);
+
+  path_cache(const path_cache&) = delete;
+  path_cache(path_cache&&) = delete;
+
+  ~path_cache() = default;
+
+  path_cache& operator=(const path_cache&) = delete;
+  path_cache& operator=(path_cache&&) = delete;
+
+  static path_cache& get_main();
+
+  /// returns the flattened path, flattening it on a miss.
+  /// @details the returned path stays valid after being evicted.
+  std::shared_ptr<const flattened_path> get(const path_geometry& path, float scale);
+
+  void set_capacity(std::size_t capacity);
+
+  inline std::size_t get_capacity() const noexcept { return m_capacity; }
+
+  void clear();
+
+  stats get_stats() const noexcept;
+
+  void reset_stats() noexcept;
+
+private:
+  struct entry {
+    path_geometry path;
+    float scale;
+    std::size_t hash;
+    std::shared_ptr<const flattened_path> flattened;
+  };
+
+  using entry_list = std::list<entry>;
+
+  // Most recently used first.
+  entry_list m_entries;
+  std::unordered_multimap<std::size_t, entry_list::iterator> m_index;
+  std::size_t m_capacity;
+  std::size_t m_byte_size = 0;
+  stats m_stats;
+
+  void evict(std::size_t capacity);
+};
+} // namespace nano.
+
+NANO_CLANG_DIAGNOSTIC_POP()
@@ -0,0 +1,71 @@
+/*
+ * Nano Library
+ *
+ * Copyright (C) 2022, Meta-Sonic
+ * All rights reserved.
+ *
+ * Proprietary and confidential.
+ * Any unauthorized copying, alteration, distribution, transmission, performance,
+ * display or other use of this material is strictly prohibited.
+ *
+ * Written by Alexandre Arsenault <alx.arsenault@gmail.com>
+ */
+
+#include <nano/ui/periodic_worker.h>
+
+#include <algorithm>
+
+NANO_CLANG_DIAGNOSTIC_PUSH()
+NANO_CLANG_DIAGNOSTIC(warning, "-Weverything")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wc++98-compat")
+
+namespace nano {
+
+periodic_worker::~periodic_worker() { stop(); }
+
+void periodic_worker::start(float rate, std::function<void()> fn) {
+  if (m_thread.joinable()) {
+    return;
+  }
+
+  const auto interval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+      std::chrono::duration<double>(1.0 / static_cast<double>(std::max(rate, 1.0f))));
+
+  m_stop = false;
+  m_thread = std::thread([this, interval, fn = std::move(fn)]() { run(interval, fn); });
+}
+
+void periodic_worker::stop() {
+  if (!m_thread.joinable()) {
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+
+  m_condition.notify_one();
+  m_thread.join();
+}
+
+void periodic_worker::run(std::chrono::steady_clock::duration interval, const std::function<void()>& fn) {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  std::chrono::steady_clock::time_point next = std::chrono::steady_clock::now();
+
+  while (!m_stop) {
+    next += interval;
+
+    lock.unlock();
+    fn();
+    lock.lock();
+
+    m_condition.wait_until(lock, next, [this] { return m_stop; });
+
+    // Catches up without bursts after a stall.
+    next = std::max(next, std::chrono::steady_clock::now() - interval);
+  }
+}
+} // namespace nano.
+
+NANO_CLANG_DIAGNOSTIC_POP()
@@ -0,0 +1,76 @@
+/*
+ * Nano Library
+ *
+ * Copyright (C) 2022, Meta-Sonic
+ * All rights reserved.
+ *
+ * Proprietary and confidential.
+ * Any unauthorized copying, alteration, distribution, transmission, performance,
+ * display or other use of this material is strictly prohibited.
+ *
+ * Written by Alexandre Arsenault <alx.arsenault@gmail.com>
+ */
+
+#pragma once
+
+/*!
+ * @file      nano/ui/periodic_worker.h
+ * @brief     nano ui periodic worker thread
+ * @copyright Copyright (C) 2022, Meta-Sonic
+ * @author    Alexandre Arsenault alx.arsenault@gmail.com
+ * @date      Created 16/06/2022
+ */
+
+#include <nano/graphics.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+NANO_CLANG_DIAGNOSTIC_PUSH()
+NANO_CLANG_DIAGNOSTIC(warning, "-Weverything")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wc++98-compat")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wpadded")
+
+namespace nano {
+
+/// a thread calling a function at a fixed rate, e.g. to drain a sample_ring.
+///
+/// @details the calls are scheduled from the start time, so a slow call
+///          shortens the next wait. after a stall, the schedule restarts from
+///          the current time instead of making up for the missed calls.
+class periodic_worker {
+public:
+  periodic_worker() = default;
+
+  periodic_worker(const periodic_worker&) = delete;
+  periodic_worker(periodic_worker&&) = delete;
+
+  /// stops the thread.
+  ~periodic_worker();
+
+  periodic_worker& operator=(const periodic_worker&) = delete;
+  periodic_worker& operator=(periodic_worker&&) = delete;
+
+  /// starts calling fn rate times per second on a new thread, the first call is immediate.
+  /// @details does nothing if the thread is already running.
+  void start(float rate, std::function<void()> fn);
+
+  /// returns once the call in progress, if any, has returned.
+  void stop();
+
+  inline bool is_running() const noexcept { return m_thread.joinable(); }
+
+private:
+  std::thread m_thread;
+  std::mutex m_mutex;
+  std::condition_variable m_condition;
+  bool m_stop = false;
+
+  void run(std::chrono::steady_clock::duration interval, const std::function<void()>& fn);
+};
+} // namespace nano.
+
+NANO_CLANG_DIAGNOSTIC_POP()
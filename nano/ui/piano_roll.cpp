@@ -0,0 +1,581 @@
+/*
+ * Nano Library
+ *
+ * Copyright (C) 2022, Meta-Sonic
+ * All rights reserved.
+ *
+ * Proprietary and confidential.
+ * Any unauthorized copying, alteration, distribution, transmission, performance,
+ * display or other use of this material is strictly prohibited.
+ *
+ * Written by Alexandre Arsenault <alx.arsenault@gmail.com>
+ */
+
+#include <nano/ui/piano_roll.h>
+#include <nano/ui/region.h>
+
+#include <cmath>
+
+NANO_CLANG_DIAGNOSTIC_PUSH()
+NANO_CLANG_DIAGNOSTIC(warning, "-Weverything")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wc++98-compat")
+
+namespace nano {
+
+namespace {
+  inline nano::rect<int> to_int_rect(const nano::rect<float>& r) noexcept {
+    const int x = static_cast<int>(std::floor(r.x));
+    const int y = static_cast<int>(std::floor(r.y));
+    return nano::rect<int>(x, y, static_cast<int>(std::ceil(r.x + r.width)) - x,
+        static_cast<int>(std::ceil(r.y + r.height)) - y);
+  }
+
+  inline nano::rect<float> make_rect(const nano::point<float>& a, const nano::point<float>& b) noexcept {
+    return nano::rect<float>(std::min(a.x, b.x), std::min(a.y, b.y), std::abs(b.x - a.x), std::abs(b.y - a.y));
+  }
+
+  inline bool is_black_key(int pitch) noexcept {
+    const int k = pitch % 12;
+    return k == 1 || k == 3 || k == 6 || k == 8 || k == 10;
+  }
+} // namespace.
+
+//
+// MARK: - note_index -
+//
+
+note_index::note_index()
+    : m_lanes(pitch_count) {}
+
+void note_index::clear() {
+  m_lanes.assign(pitch_count, lane());
+  m_locations.clear();
+  m_free_ids.clear();
+  m_size = 0;
+}
+
+note_index::lane_position note_index::lower_bound(const lane& l, double start) noexcept {
+  const auto it = std::partition_point(
+      l.chunks.begin(), l.chunks.end(), [start](const chunk& c) { return c.notes.back().start < start; });
+
+  if (it == l.chunks.end()) {
+    return lane_position{ l.chunks.size(), 0 };
+  }
+
+  const auto n = std::partition_point(
+      it->notes.begin(), it->notes.end(), [start](const piano_note& p) { return p.start < start; });
+  return lane_position{ static_cast<std::size_t>(it - l.chunks.begin()),
+    static_cast<std::size_t>(n - it->notes.begin()) };
+}
+
+std::size_t note_index::find_chunk(const lane& l, std::size_t first, double time) noexcept {
+  if (first >= l.chunks.size()) {
+    return l.chunks.size();
+  }
+
+  const std::size_t leaf_count = l.max_ends.size() / 2;
+  std::size_t node = leaf_count + first;
+
+  // Moves right, climbing out of the right children, until a subtree reaches the time.
+  while (l.max_ends[node] <= time) {
+    while (node & 1) {
+      node >>= 1;
+    }
+
+    if (node == 0) {
+      return l.chunks.size();
+    }
+
+    node++;
+  }
+
+  // Then down to its first leaf that reaches it.
+  while (node < leaf_count) {
+    node = l.max_ends[2 * node] > time ? 2 * node : 2 * node + 1;
+  }
+
+  return node - leaf_count;
+}
+
+void note_index::update_chunk(chunk& c) noexcept {
+  c.max_end = std::numeric_limits<double>::lowest();
+  c.max_length = 0;
+
+  for (const piano_note& n : c.notes) {
+    c.max_end = std::max(c.max_end, n.get_end());
+    c.max_length = std::max(c.max_length, n.length);
+  }
+}
+
+void note_index::update_tree(lane& l, std::size_t chunk_index) noexcept {
+  std::size_t node = l.max_ends.size() / 2 + chunk_index;
+  l.max_ends[node] = l.chunks[chunk_index].max_end;
+
+  for (node >>= 1; node > 0; node >>= 1) {
+    l.max_ends[node] = std::max(l.max_ends[2 * node], l.max_ends[2 * node + 1]);
+  }
+}
+
+void note_index::build_tree(lane& l) {
+  std::size_t leaf_count = 1;
+  while (leaf_count < l.chunks.size()) {
+    leaf_count *= 2;
+  }
+
+  l.max_ends.assign(leaf_count * 2, std::numeric_limits<double>::lowest());
+
+  for (std::size_t i = 0; i < l.chunks.size(); i++) {
+    l.max_ends[leaf_count + i] = l.chunks[i].max_end;
+  }
+
+  for (std::size_t node = leaf_count - 1; node > 0; node--) {
+    l.max_ends[node] = std::max(l.max_ends[2 * node], l.max_ends[2 * node + 1]);
+  }
+}
+
+piano_note* note_index::find_note(note_id id, lane_position* position) noexcept {
+  if (id >= m_locations.size() || !m_locations[id].used) {
+    return nullptr;
+  }
+
+  const location& loc = m_locations[id];
+  lane& l = m_lanes[loc.pitch];
+
+  // The notes starting at the same time are searched for the id.
+  for (lane_position p = lower_bound(l, loc.start); p.chunk < l.chunks.size(); p = { p.chunk + 1, 0 }) {
+    std::vector<piano_note>& notes = l.chunks[p.chunk].notes;
+
+    for (; p.index < notes.size() && notes[p.index].start == loc.start; p.index++) {
+      if (notes[p.index].id == id) {
+        if (position) {
+          *position = p;
+        }
+
+        return &notes[p.index];
+      }
+    }
+
+    if (p.index < notes.size()) {
+      break;
+    }
+  }
+
+  return nullptr;
+}
+
+const piano_note* note_index::find(note_id id) const noexcept {
+  return const_cast<note_index*>(this)->find_note(id);
+}
+
+void note_index::insert_note(const piano_note& note) {
+  lane& l = m_lanes[note.pitch];
+
+  std::size_t ci = 0;
+
+  if (l.chunks.empty()) {
+    // The first note goes in a new chunk, which has no front note to search.
+    l.chunks.emplace_back().notes.reserve(max_chunk_size);
+    update_chunk(l.chunks.back());
+    build_tree(l);
+  }
+  else {
+    // The last chunk starting at or before the note.
+    const auto it = std::partition_point(
+        l.chunks.begin(), l.chunks.end(), [&note](const chunk& c) { return c.notes.front().start <= note.start; });
+    ci = it == l.chunks.begin() ? 0 : static_cast<std::size_t>(it - l.chunks.begin()) - 1;
+  }
+
+  chunk& c = l.chunks[ci];
+  const auto pos = std::partition_point(
+      c.notes.begin(), c.notes.end(), [&note](const piano_note& p) { return p.start <= note.start; });
+  c.notes.insert(pos, note);
+  c.max_end = std::max(c.max_end, note.get_end());
+  c.max_length = std::max(c.max_length, note.length);
+
+  // A full chunk is split in two halves.
+  if (c.notes.size() > max_chunk_size) {
+    const std::size_t half = c.notes.size() / 2;
+    chunk second;
+    second.notes.reserve(max_chunk_size);
+    second.notes.assign(c.notes.begin() + static_cast<std::ptrdiff_t>(half), c.notes.end());
+    c.notes.resize(half);
+    update_chunk(c);
+    update_chunk(second);
+    l.chunks.insert(l.chunks.begin() + static_cast<std::ptrdiff_t>(ci + 1), std::move(second));
+    build_tree(l);
+  }
+  else {
+    update_tree(l, ci);
+  }
+
+  m_size++;
+}
+
+void note_index::erase_note(std::uint8_t pitch, const lane_position& position) {
+  lane& l = m_lanes[pitch];
+  chunk& c = l.chunks[position.chunk];
+  const piano_note note = c.notes[position.index];
+  c.notes.erase(c.notes.begin() + static_cast<std::ptrdiff_t>(position.index));
+
+  // An empty chunk is removed, a small one is merged with the next.
+  if (c.notes.empty()) {
+    l.chunks.erase(l.chunks.begin() + static_cast<std::ptrdiff_t>(position.chunk));
+    build_tree(l);
+  }
+  else if (position.chunk + 1 < l.chunks.size()
+      && c.notes.size() + l.chunks[position.chunk + 1].notes.size() <= max_chunk_size / 2) {
+    std::vector<piano_note>& next = l.chunks[position.chunk + 1].notes;
+    c.notes.insert(c.notes.end(), next.begin(), next.end());
+    l.chunks.erase(l.chunks.begin() + static_cast<std::ptrdiff_t>(position.chunk + 1));
+    update_chunk(l.chunks[position.chunk]);
+    build_tree(l);
+  }
+  else if (note.get_end() >= c.max_end || note.length >= c.max_length) {
+    // Only the chunk of the note is searched again.
+    update_chunk(c);
+    update_tree(l, position.chunk);
+  }
+
+  m_size--;
+}
+
+note_id note_index::insert(double start, double length, std::uint8_t pitch, std::uint8_t velocity) {
+  pitch = std::min<std::uint8_t>(pitch, pitch_count - 1);
+
+  note_id id;
+  if (m_free_ids.empty()) {
+    id = static_cast<note_id>(m_locations.size());
+    m_locations.push_back(location{ start, pitch, true });
+  }
+  else {
+    id = m_free_ids.back();
+    m_free_ids.pop_back();
+    m_locations[id] = location{ start, pitch, true };
+  }
+
+  insert_note(piano_note{ start, std::max(length, 0.0), id, pitch, velocity, false });
+  return id;
+}
+
+bool note_index::erase(note_id id) {
+  lane_position position;
+  if (!find_note(id, &position)) {
+    return false;
+  }
+
+  erase_note(m_locations[id].pitch, position);
+  m_locations[id].used = false;
+  m_free_ids.push_back(id);
+  return true;
+}
+
+bool note_index::move(note_id id, double start, std::uint8_t pitch) {
+  lane_position position;
+  const piano_note* n = find_note(id, &position);
+  if (!n) {
+    return false;
+  }
+
+  piano_note note = *n;
+  erase_note(note.pitch, position);
+
+  note.start = start;
+  note.pitch = std::min<std::uint8_t>(pitch, pitch_count - 1);
+  m_locations[id] = location{ note.start, note.pitch, true };
+  insert_note(note);
+  return true;
+}
+
+bool note_index::set_selected(note_id id, bool selected) {
+  piano_note* n = find_note(id);
+  if (!n) {
+    return false;
+  }
+
+  n->selected = selected;
+  return true;
+}
+
+//
+// MARK: - piano_roll_view -
+//
+
+piano_roll_view::piano_roll_view(view* parent, const nano::rect<int>& rect)
+    : view(parent, rect) {}
+
+void piano_roll_view::set_notes(std::shared_ptr<note_index> notes) {
+  m_notes = std::move(notes);
+  m_selection.clear();
+  m_drag_mode = drag_mode::none;
+  redraw();
+}
+
+void piano_roll_view::set_scale(double time_per_point, float key_height) {
+  m_time_per_point = std::max(time_per_point, std::numeric_limits<double>::min());
+  m_key_height = std::max(key_height, 1.0f);
+  redraw();
+}
+
+void piano_roll_view::set_colors(const nano::color& background, const nano::color& black_key,
+    const nano::color& note, const nano::color& selected_note, const nano::color& marquee) {
+  m_background = background;
+  m_black_key_color = black_key;
+  m_note_color = note;
+  m_selected_color = selected_note;
+  m_marquee_color = marquee;
+  redraw();
+}
+
+double piano_roll_view::get_time(float x) const noexcept { return static_cast<double>(x) * m_time_per_point; }
+
+float piano_roll_view::get_x(double time) const noexcept { return static_cast<float>(time / m_time_per_point); }
+
+int piano_roll_view::get_pitch(float y) const noexcept {
+  return note_index::pitch_count - 1 - static_cast<int>(std::floor(y / m_key_height));
+}
+
+float piano_roll_view::get_y(int pitch) const noexcept {
+  return static_cast<float>(note_index::pitch_count - 1 - pitch) * m_key_height;
+}
+
+nano::rect<float> piano_roll_view::get_note_rect(const piano_note& note) const noexcept {
+  const float x = get_x(note.start);
+  return nano::rect<float>(x, get_y(note.pitch), std::max(get_x(note.get_end()) - x, 1.0f), m_key_height);
+}
+
+note_id piano_roll_view::hit_test(const nano::point<float>& pos) const {
+  const int pitch = get_pitch(pos.y);
+  if (!m_notes || pitch < 0 || pitch >= note_index::pitch_count) {
+    return invalid_note_id;
+  }
+
+  // The last note found is the one drawn on top.
+  note_id result = invalid_note_id;
+  const double time = get_time(pos.x);
+  m_notes->query(time, time + m_time_per_point, pitch, pitch, [&](const piano_note& n) { result = n.id; });
+  return result;
+}
+
+nano::rect<int> piano_roll_view::get_redraw_rect(const note_bounds& bounds) const noexcept {
+  const float x = get_x(bounds.start);
+  const float y = get_y(bounds.high_pitch);
+  return to_int_rect(nano::rect<float>(
+      x, y, std::max(get_x(bounds.end) - x, 1.0f), get_y(bounds.low_pitch) + m_key_height - y));
+}
+
+piano_roll_view::note_bounds piano_roll_view::get_selection_bounds() const {
+  note_bounds b = { std::numeric_limits<double>::max(), std::numeric_limits<double>::lowest(),
+    note_index::pitch_count, -1 };
+
+  for (note_id id : m_selection) {
+    if (const piano_note* n = m_notes->find(id)) {
+      b.start = std::min(b.start, n->start);
+      b.end = std::max(b.end, n->get_end());
+      b.low_pitch = std::min<int>(b.low_pitch, n->pitch);
+      b.high_pitch = std::max<int>(b.high_pitch, n->pitch);
+    }
+  }
+
+  return b;
+}
+
+void piano_roll_view::clear_selection() {
+  if (!m_notes || m_selection.empty()) {
+    m_selection.clear();
+    return;
+  }
+
+  redraw(get_redraw_rect(get_selection_bounds()));
+
+  for (note_id id : m_selection) {
+    m_notes->set_selected(id, false);
+  }
+
+  m_selection.clear();
+}
+
+void piano_roll_view::select(const nano::rect<float>& rect) {
+  for (note_id id : m_selection) {
+    m_notes->set_selected(id, false);
+  }
+
+  m_selection.clear();
+
+  const int low_pitch = get_pitch(rect.y + rect.height);
+  const int high_pitch = get_pitch(rect.y);
+  m_notes->query(get_time(rect.x), get_time(rect.x + rect.width), low_pitch, high_pitch,
+      [this](const piano_note& n) { m_selection.push_back(n.id); });
+
+  for (note_id id : m_selection) {
+    m_notes->set_selected(id, true);
+  }
+}
+
+void piano_roll_view::begin_marquee(const nano::point<float>& pos) {
+  if (!m_notes) {
+    return;
+  }
+
+  clear_selection();
+  m_drag_mode = drag_mode::marquee;
+  m_drag_origin = pos;
+  m_marquee = nano::rect<float>(pos.x, pos.y, 0.0f, 0.0f);
+}
+
+void piano_roll_view::drag_marquee(const nano::point<float>& pos) {
+  if (m_drag_mode != drag_mode::marquee) {
+    return;
+  }
+
+  // The notes whose selection changes are within the old or the new marquee, but may extend past it.
+  if (!m_selection.empty()) {
+    redraw(get_redraw_rect(get_selection_bounds()));
+  }
+
+  redraw(to_int_rect(m_marquee));
+  m_marquee = make_rect(m_drag_origin, pos);
+  select(m_marquee);
+  redraw(to_int_rect(m_marquee));
+
+  if (!m_selection.empty()) {
+    redraw(get_redraw_rect(get_selection_bounds()));
+  }
+}
+
+void piano_roll_view::end_marquee() {
+  if (m_drag_mode != drag_mode::marquee) {
+    return;
+  }
+
+  m_drag_mode = drag_mode::none;
+  redraw(to_int_rect(m_marquee));
+}
+
+bool piano_roll_view::begin_move(const nano::point<float>& pos) {
+  const note_id id = hit_test(pos);
+  if (id == invalid_note_id) {
+    return false;
+  }
+
+  if (!m_notes->find(id)->selected) {
+    clear_selection();
+    m_notes->set_selected(id, true);
+    m_selection.push_back(id);
+    redraw(to_int_rect(get_note_rect(*m_notes->find(id))));
+  }
+
+  m_drag_mode = drag_mode::move;
+  m_drag_origin = pos;
+  m_selection_bounds = get_selection_bounds();
+  m_applied_time = 0;
+  m_applied_pitch = 0;
+  return true;
+}
+
+void piano_roll_view::drag_move(const nano::point<float>& pos) {
+  if (m_drag_mode != drag_mode::move) {
+    return;
+  }
+
+  // The offset is limited so that the whole selection stays in the grid.
+  const double time = std::max(get_time(pos.x) - get_time(m_drag_origin.x), -m_selection_bounds.start);
+  const int pitch = std::clamp(get_pitch(pos.y) - get_pitch(m_drag_origin.y), -m_selection_bounds.low_pitch,
+      note_index::pitch_count - 1 - m_selection_bounds.high_pitch);
+
+  if (time == m_applied_time && pitch == m_applied_pitch) {
+    return;
+  }
+
+  const auto get_moved_bounds = [this](double dt, int dp) {
+    const note_bounds& b = m_selection_bounds;
+    return note_bounds{ b.start + dt, b.end + dt, b.low_pitch + dp, b.high_pitch + dp };
+  };
+
+  const nano::rect<int> old_rect = get_redraw_rect(get_moved_bounds(m_applied_time, m_applied_pitch));
+  const double dt = time - m_applied_time;
+  const int dp = pitch - m_applied_pitch;
+
+  for (note_id id : m_selection) {
+    const piano_note* n = m_notes->find(id);
+    m_notes->move(id, n->start + dt, static_cast<std::uint8_t>(n->pitch + dp));
+  }
+
+  m_applied_time = time;
+  m_applied_pitch = pitch;
+
+  // A step of the drag mostly overlaps the previous one.
+  redraw(get_union(old_rect, get_redraw_rect(get_moved_bounds(m_applied_time, m_applied_pitch))));
+}
+
+void piano_roll_view::end_move() { m_drag_mode = drag_mode::none; }
+
+void piano_roll_view::on_mouse_down(const nano::event& evt) {
+  if (!begin_move(evt.get_position())) {
+    begin_marquee(evt.get_position());
+  }
+}
+
+void piano_roll_view::on_mouse_dragged(const nano::event& evt) {
+  if (m_drag_mode == drag_mode::move) {
+    drag_move(evt.get_position());
+  }
+  else {
+    drag_marquee(evt.get_position());
+  }
+}
+
+void piano_roll_view::on_mouse_up(const nano::event& evt) {
+  NANO_UNUSED(evt);
+  end_move();
+  end_marquee();
+}
+
+void piano_roll_view::on_draw(nano::graphic_context& gc, const nano::rect<float>& dirty_rect) {
+  gc.set_fill_color(m_background);
+  gc.fill_rect(dirty_rect);
+
+  // Only the visible part of the grid is drawn, the view is usually much larger.
+  const nano::rect<int> area = get_intersection(to_int_rect(dirty_rect), get_visible_rect());
+  if (is_empty(area)) {
+    return;
+  }
+
+  const int low_pitch = std::max(get_pitch(static_cast<float>(area.y + area.height) - 0.5f), 0);
+  const int high_pitch = std::min(get_pitch(static_cast<float>(area.y)), note_index::pitch_count - 1);
+  const float left = static_cast<float>(area.x);
+  const float width = static_cast<float>(area.width);
+
+  gc.set_fill_color(m_black_key_color);
+  for (int pitch = low_pitch; pitch <= high_pitch; pitch++) {
+    if (is_black_key(pitch)) {
+      gc.fill_rect(nano::rect<float>(left, get_y(pitch), width, m_key_height));
+    }
+  }
+
+  if (m_notes) {
+    bool selected = false;
+    gc.set_fill_color(m_note_color);
+
+    m_notes->query(get_time(left), get_time(left + width), low_pitch, high_pitch, [&](const piano_note& n) {
+      const nano::rect<float> r = get_note_rect(n);
+      if (!is_dirty_rect(to_int_rect(r))) {
+        return;
+      }
+
+      if (n.selected != selected) {
+        selected = n.selected;
+        gc.set_fill_color(selected ? m_selected_color : m_note_color);
+      }
+
+      gc.fill_rect(nano::rect<float>(r.x, r.y + 1.0f, std::max(r.width - 1.0f, 1.0f), r.height - 2.0f));
+    });
+  }
+
+  if (m_drag_mode == drag_mode::marquee) {
+    gc.set_fill_color(m_marquee_color);
+    gc.fill_rect(m_marquee);
+  }
+}
+} // namespace nano.
+
+NANO_CLANG_DIAGNOSTIC_POP()
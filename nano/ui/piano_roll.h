@@ -0,0 +1,257 @@
+/*
+ * Nano Library
+ *
+ * Copyright (C) 2022, Meta-Sonic
+ * All rights reserved.
+ *
+ * Proprietary and confidential.
+ * Any unauthorized copying, alteration, distribution, transmission, performance,
+ * display or other use of this material is strictly prohibited.
+ *
+ * Written by Alexandre Arsenault <alx.arsenault@gmail.com>
+ */
+
+#pragma once
+
+/*!
+ * @file      nano/ui/piano_roll.h
+ * @brief     nano ui piano roll
+ * @copyright Copyright (C) 2022, Meta-Sonic
+ * @author    Alexandre Arsenault alx.arsenault@gmail.com
+ * @date      Created 16/06/2022
+ */
+
+#include <nano/ui.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+NANO_CLANG_DIAGNOSTIC_PUSH()
+NANO_CLANG_DIAGNOSTIC(warning, "-Weverything")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wc++98-compat")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wpadded")
+
+namespace nano {
+
+using note_id = std::uint32_t;
+
+inline constexpr note_id invalid_note_id = std::numeric_limits<note_id>::max();
+
+struct piano_note {
+  double start;
+  double length;
+  note_id id;
+  std::uint8_t pitch;
+  std::uint8_t velocity;
+  bool selected;
+
+  inline double get_end() const noexcept { return start + length; }
+};
+
+/// midi notes indexed by time and pitch.
+///
+/// @details the notes of each pitch are sorted by start time in chunks of at
+///          most max_chunk_size notes, each chunk knows the latest end and the
+///          longest length of its notes. a max tree over the chunk ends finds
+///          the next chunk with a note ending after a time in O(log chunks), so
+///          a query over a time range only visits the chunks that have a note
+///          reaching it, and within them starts at their longest note before
+///          the range. a long note costs at most the scan of its own chunk.
+///          the notes are found by id through their start and pitch, an edit
+///          only shifts the notes of one chunk and updates the tree.
+class note_index {
+public:
+  static constexpr int pitch_count = 128;
+  static constexpr std::size_t max_chunk_size = 512;
+
+  note_index();
+
+  note_id insert(double start, double length, std::uint8_t pitch, std::uint8_t velocity = 100);
+
+  bool erase(note_id id);
+
+  /// moves a note to a new start time and pitch, its length is unchanged.
+  bool move(note_id id, double start, std::uint8_t pitch);
+
+  bool set_selected(note_id id, bool selected);
+
+  /// returns nullptr if there is no note with this id.
+  const piano_note* find(note_id id) const noexcept;
+
+  void clear();
+
+  inline std::size_t size() const noexcept { return m_size; }
+
+  /// calls fn(const piano_note&) for the notes overlapping [start_time, end_time)
+  /// with a pitch in [low_pitch, high_pitch].
+  template <class Fn>
+  void query(double start_time, double end_time, int low_pitch, int high_pitch, Fn&& fn) const;
+
+private:
+  struct chunk {
+    std::vector<piano_note> notes;
+    double max_end = 0;
+    double max_length = 0;
+  };
+
+  struct lane {
+    std::vector<chunk> chunks;
+    /// max tree of the chunk ends, the leaves start at max_ends.size() / 2.
+    std::vector<double> max_ends;
+  };
+
+  struct lane_position {
+    std::size_t chunk;
+    std::size_t index;
+  };
+
+  struct location {
+    double start;
+    std::uint8_t pitch;
+    bool used;
+  };
+
+  std::vector<lane> m_lanes;
+  std::vector<location> m_locations;
+  std::vector<note_id> m_free_ids;
+  std::size_t m_size = 0;
+
+  static lane_position lower_bound(const lane& l, double start) noexcept;
+
+  /// returns the first chunk from first with a note ending after time, or the chunk count.
+  static std::size_t find_chunk(const lane& l, std::size_t first, double time) noexcept;
+
+  static void update_chunk(chunk& c) noexcept;
+  static void update_tree(lane& l, std::size_t chunk_index) noexcept;
+  static void build_tree(lane& l);
+  piano_note* find_note(note_id id, lane_position* position = nullptr) noexcept;
+  void insert_note(const piano_note& note);
+  void erase_note(std::uint8_t pitch, const lane_position& position);
+};
+
+/// a grid of notes, time from left to right and pitch from bottom to top.
+///
+/// @details the view is meant to be the content of a scroll_view with the
+///          size of the whole clip: on_draw() only queries the notes of the
+///          part of the visible rect being drawn, and skips those outside of
+///          the dirty rects. marquee selection and moving the selection only
+///          visit the notes they change and redraw their bounds.
+class piano_roll_view : public view {
+public:
+  piano_roll_view(view* parent, const nano::rect<int>& rect);
+
+  ~piano_roll_view() override = default;
+
+  void set_notes(std::shared_ptr<note_index> notes);
+
+  inline const std::shared_ptr<note_index>& get_notes() const noexcept { return m_notes; }
+
+  /// sets the horizontal zoom and the height of a pitch row.
+  void set_scale(double time_per_point, float key_height);
+
+  void set_colors(const nano::color& background, const nano::color& black_key, const nano::color& note,
+      const nano::color& selected_note, const nano::color& marquee);
+
+  double get_time(float x) const noexcept;
+  float get_x(double time) const noexcept;
+  int get_pitch(float y) const noexcept;
+  float get_y(int pitch) const noexcept;
+
+  nano::rect<float> get_note_rect(const piano_note& note) const noexcept;
+
+  /// returns the note under a position, or invalid_note_id.
+  note_id hit_test(const nano::point<float>& pos) const;
+
+  inline const std::vector<note_id>& get_selection() const noexcept { return m_selection; }
+
+  void clear_selection();
+
+  /// selects the notes overlapping the rect between the position and the
+  /// origin of the marquee.
+  void begin_marquee(const nano::point<float>& pos);
+  void drag_marquee(const nano::point<float>& pos);
+  void end_marquee();
+
+  /// starts moving the selection from a note, it is selected first if needed.
+  /// @returns false if there is no note under the position.
+  bool begin_move(const nano::point<float>& pos);
+  void drag_move(const nano::point<float>& pos);
+  void end_move();
+
+protected:
+  void on_mouse_down(const nano::event& evt) override;
+  void on_mouse_dragged(const nano::event& evt) override;
+  void on_mouse_up(const nano::event& evt) override;
+
+  void on_draw(nano::graphic_context& gc, const nano::rect<float>& dirty_rect) override;
+
+private:
+  enum class drag_mode { none, marquee, move };
+
+  /// the bounds of notes in time and pitch.
+  struct note_bounds {
+    double start;
+    double end;
+    int low_pitch;
+    int high_pitch;
+  };
+
+  std::shared_ptr<note_index> m_notes;
+  std::vector<note_id> m_selection;
+  double m_time_per_point = 0.01;
+  float m_key_height = 8.0f;
+
+  drag_mode m_drag_mode = drag_mode::none;
+  nano::point<float> m_drag_origin;
+  nano::rect<float> m_marquee;
+  note_bounds m_selection_bounds;
+  double m_applied_time = 0;
+  int m_applied_pitch = 0;
+
+  nano::color m_background = nano::color(0x202226FF);
+  nano::color m_black_key_color = nano::color(0x1A1B1FFF);
+  nano::color m_note_color = nano::color(0x3FA9F5FF);
+  nano::color m_selected_color = nano::color(0xF5A93FFF);
+  nano::color m_marquee_color = nano::color(0xFFFFFF30);
+
+  void select(const nano::rect<float>& rect);
+  note_bounds get_selection_bounds() const;
+  nano::rect<int> get_redraw_rect(const note_bounds& bounds) const noexcept;
+};
+
+template <class Fn>
+void note_index::query(double start_time, double end_time, int low_pitch, int high_pitch, Fn&& fn) const {
+  low_pitch = std::max(low_pitch, 0);
+  high_pitch = std::min(high_pitch, pitch_count - 1);
+
+  for (int pitch = low_pitch; pitch <= high_pitch; pitch++) {
+    const lane& l = m_lanes[static_cast<std::size_t>(pitch)];
+
+    // Only the chunks with a note ending after the start of the range.
+    for (std::size_t c = find_chunk(l, 0, start_time); c < l.chunks.size(); c = find_chunk(l, c + 1, start_time)) {
+      const chunk& ch = l.chunks[c];
+
+      // No note of the chunk that starts before this can reach the range.
+      const double first_start = start_time - ch.max_length;
+      auto it = std::partition_point(
+          ch.notes.begin(), ch.notes.end(), [first_start](const piano_note& n) { return n.start < first_start; });
+
+      for (; it != ch.notes.end() && it->start < end_time; ++it) {
+        if (it->get_end() > start_time) {
+          fn(*it);
+        }
+      }
+
+      if (it != ch.notes.end()) {
+        break;
+      }
+    }
+  }
+}
+} // namespace nano.
+
+NANO_CLANG_DIAGNOSTIC_POP()
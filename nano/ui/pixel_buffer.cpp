@@ -0,0 +1,164 @@
+/*
+ * Nano Library
+ *
+ * Copyright (C) 2022, Meta-Sonic
+ * All rights reserved.
+ *
+ * Proprietary and confidential.
+ * Any unauthorized copying, alteration, distribution, transmission, performance,
+ * display or other use of this material is strictly prohibited.
+ *
+ * Written by Alexandre Arsenault <alx.arsenault@gmail.com>
+ */
+
+#include <nano/ui/pixel_buffer.h>
+#include <nano/ui/color_conversion.h>
+#include <nano/ui/region.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+NANO_CLANG_DIAGNOSTIC_PUSH()
+NANO_CLANG_DIAGNOSTIC(warning, "-Weverything")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wc++98-compat")
+
+namespace nano {
+
+std::uint32_t to_pixel(const nano::color& c) noexcept {
+  std::uint32_t pixel;
+  to_pixels(&c, &pixel, 1);
+  return pixel;
+}
+
+pixel_buffer::pixel_buffer(int width, int height) { resize(width, height); }
+
+void pixel_buffer::resize(int width, int height) {
+  m_width = std::max(width, 0);
+  m_height = std::max(height, 0);
+  m_stride = m_width;
+  m_data.assign(static_cast<std::size_t>(m_stride) * static_cast<std::size_t>(m_height), 0);
+}
+
+void pixel_buffer::assign(std::vector<pixel_type>&& storage, int width, int height, int stride) {
+  m_width = std::max(width, 0);
+  m_height = std::max(height, 0);
+  m_stride = std::max(stride, m_width);
+  m_data = std::move(storage);
+  NANO_ASSERT(m_data.size() >= static_cast<std::size_t>(m_stride) * static_cast<std::size_t>(m_height),
+      "storage is too small");
+}
+
+std::vector<pixel_buffer::pixel_type> pixel_buffer::release() noexcept {
+  m_width = 0;
+  m_height = 0;
+  m_stride = 0;
+
+  std::vector<pixel_type> data;
+  data.swap(m_data);
+  return data;
+}
+
+void pixel_buffer::clear(pixel_type value) { std::fill(m_data.begin(), m_data.end(), value); }
+
+void pixel_buffer::fill(const nano::rect<int>& rect, pixel_type value) {
+  const nano::rect<int> r = get_intersection(rect, get_bounds());
+
+  if (is_empty(r)) {
+    return;
+  }
+
+  for (int y = r.y; y < r.y + r.height; y++) {
+    std::fill_n(row(y) + r.x, r.width, value);
+  }
+}
+
+void pixel_buffer::copy_from(const pixel_buffer& src, const nano::rect<int>& src_rect, const nano::point<int>& dst) {
+  nano::rect<int> r = get_intersection(src_rect, src.get_bounds());
+  nano::point<int> d(dst.x + r.x - src_rect.x, dst.y + r.y - src_rect.y);
+
+  const nano::rect<int> clipped = get_intersection(nano::rect<int>(d, r.size), get_bounds());
+  if (is_empty(clipped)) {
+    return;
+  }
+
+  r = nano::rect<int>(r.x + clipped.x - d.x, r.y + clipped.y - d.y, clipped.width, clipped.height);
+  d = clipped.position;
+
+  const std::size_t row_size = static_cast<std::size_t>(r.width) * sizeof(pixel_type);
+
+  for (int y = 0; y < r.height; y++) {
+    std::memmove(row(d.y + y) + d.x, src.row(r.y + y) + r.x, row_size);
+  }
+}
+
+void pixel_buffer::scroll(const nano::rect<int>& area, const nano::point<int>& delta) {
+  const nano::rect<int> a = get_intersection(area, get_bounds());
+  const nano::rect<int> dst
+      = get_intersection(nano::rect<int>(a.x + delta.x, a.y + delta.y, a.width, a.height), a);
+
+  if (is_empty(dst) || (delta.x == 0 && delta.y == 0)) {
+    return;
+  }
+
+  const std::size_t row_size = static_cast<std::size_t>(dst.width) * sizeof(pixel_type);
+  const int src_x = dst.x - delta.x;
+
+  // Rows are copied in the opposite direction of the move so that no row is
+  // overwritten before being read.
+  if (delta.y > 0) {
+    for (int y = dst.y + dst.height - 1; y >= dst.y; y--) {
+      std::memmove(row(y) + dst.x, row(y - delta.y) + src_x, row_size);
+    }
+  }
+  else {
+    for (int y = dst.y; y < dst.y + dst.height; y++) {
+      std::memmove(row(y) + dst.x, row(y - delta.y) + src_x, row_size);
+    }
+  }
+}
+
+image_difference compare(const pixel_buffer& a, const pixel_buffer& b, int tolerance) {
+  image_difference diff;
+
+  if (a.get_size() != b.get_size()) {
+    diff.pixel_count
+        = static_cast<std::size_t>(std::max(a.get_width() * a.get_height(), b.get_width() * b.get_height()));
+    diff.different_pixel_count = diff.pixel_count;
+    diff.max_component_difference = 255;
+    diff.same_size = false;
+    return diff;
+  }
+
+  diff.pixel_count = static_cast<std::size_t>(a.get_width()) * static_cast<std::size_t>(a.get_height());
+
+  for (int y = 0; y < a.get_height(); y++) {
+    const pixel_buffer::pixel_type* a_row = a.row(y);
+    const pixel_buffer::pixel_type* b_row = b.row(y);
+
+    for (int x = 0; x < a.get_width(); x++) {
+      if (a_row[x] == b_row[x]) {
+        continue;
+      }
+
+      int max_diff = 0;
+      for (int shift = 0; shift < 32; shift += 8) {
+        const int ca = static_cast<int>((a_row[x] >> shift) & 0xFF);
+        const int cb = static_cast<int>((b_row[x] >> shift) & 0xFF);
+        max_diff = std::max(max_diff, std::abs(ca - cb));
+      }
+
+      diff.max_component_difference = std::max(diff.max_component_difference, max_diff);
+
+      if (max_diff > tolerance) {
+        diff.different_pixel_count++;
+      }
+    }
+  }
+
+  return diff;
+}
+} // namespace nano.
+
+NANO_CLANG_DIAGNOSTIC_POP()
@@ -0,0 +1,175 @@
+/*
+ * Nano Library
+ *
+ * Copyright (C) 2022, Meta-Sonic
+ * All rights reserved.
+ *
+ * Proprietary and confidential.
+ * Any unauthorized copying, alteration, distribution, transmission, performance,
+ * display or other use of this material is strictly prohibited.
+ *
+ * Written by Alexandre Arsenault <alx.arsenault@gmail.com>
+ */
+
+#pragma once
+
+/*!
+ * @file      nano/ui/pixel_buffer.h
+ * @brief     nano ui pixel buffer
+ * @copyright Copyright (C) 2022, Meta-Sonic
+ * @author    Alexandre Arsenault alx.arsenault@gmail.com
+ * @date      Created 16/06/2022
+ */
+
+#include <nano/graphics.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+NANO_CLANG_DIAGNOSTIC_PUSH()
+NANO_CLANG_DIAGNOSTIC(warning, "-Weverything")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wc++98-compat")
+
+namespace nano {
+
+/// packs premultiplied components into a pixel.
+/// pixels are stored as r, g, b, a bytes in memory.
+inline constexpr std::uint32_t make_pixel(std::uint8_t r, std::uint8_t g, std::uint8_t b, std::uint8_t a) noexcept {
+  return static_cast<std::uint32_t>(r) | (static_cast<std::uint32_t>(g) << 8) | (static_cast<std::uint32_t>(b) << 16)
+      | (static_cast<std::uint32_t>(a) << 24);
+}
+
+inline constexpr std::uint8_t get_pixel_red(std::uint32_t p) noexcept { return static_cast<std::uint8_t>(p); }
+inline constexpr std::uint8_t get_pixel_green(std::uint32_t p) noexcept { return static_cast<std::uint8_t>(p >> 8); }
+inline constexpr std::uint8_t get_pixel_blue(std::uint32_t p) noexcept { return static_cast<std::uint8_t>(p >> 16); }
+inline constexpr std::uint8_t get_pixel_alpha(std::uint32_t p) noexcept { return static_cast<std::uint8_t>(p >> 24); }
+
+/// blends a premultiplied pixel with the given coverage over another (source over).
+inline constexpr std::uint32_t blend_pixel(std::uint32_t dst, std::uint32_t src, std::uint32_t coverage) noexcept {
+  // Components are processed two at a time (r, b and g, a).
+  std::uint32_t s_rb = (src & 0x00FF00FFu) * coverage;
+  std::uint32_t s_ga = ((src >> 8) & 0x00FF00FFu) * coverage;
+  s_rb = ((s_rb + ((s_rb >> 8) & 0x00FF00FFu) + 0x00800080u) >> 8) & 0x00FF00FFu;
+  s_ga = ((s_ga + ((s_ga >> 8) & 0x00FF00FFu) + 0x00800080u) >> 8) & 0x00FF00FFu;
+
+  const std::uint32_t inv_alpha = 255u - (s_ga >> 16);
+  std::uint32_t d_rb = (dst & 0x00FF00FFu) * inv_alpha;
+  std::uint32_t d_ga = ((dst >> 8) & 0x00FF00FFu) * inv_alpha;
+  d_rb = ((d_rb + ((d_rb >> 8) & 0x00FF00FFu) + 0x00800080u) >> 8) & 0x00FF00FFu;
+  d_ga = ((d_ga + ((d_ga >> 8) & 0x00FF00FFu) + 0x00800080u) >> 8) & 0x00FF00FFu;
+
+  return (s_rb + d_rb) | ((s_ga + d_ga) << 8);
+}
+
+/// converts a color to a premultiplied pixel.
+std::uint32_t to_pixel(const nano::color& c) noexcept;
+
+/// cpu side image with premultiplied rgba8 pixels.
+///
+/// @details this is the render target of the headless backend and the back
+///          buffer of the compositor. rows are get_stride() pixels apart.
+class pixel_buffer {
+public:
+  using pixel_type = std::uint32_t;
+
+  pixel_buffer() = default;
+
+  pixel_buffer(int width, int height);
+
+  pixel_buffer(const pixel_buffer&) = default;
+  pixel_buffer(pixel_buffer&&) = default;
+
+  ~pixel_buffer() = default;
+
+  pixel_buffer& operator=(const pixel_buffer&) = default;
+  pixel_buffer& operator=(pixel_buffer&&) = default;
+
+  /// resizes the buffer, the content is cleared.
+  void resize(int width, int height);
+
+  /// takes ownership of existing storage, its content is kept.
+  /// @details storage must hold at least stride * height pixels, stride must be at least width.
+  void assign(std::vector<pixel_type>&& storage, int width, int height, int stride);
+
+  /// gives up the storage, the buffer becomes empty.
+  std::vector<pixel_type> release() noexcept;
+
+  void clear(pixel_type value = 0);
+
+  void fill(const nano::rect<int>& rect, pixel_type value);
+
+  /// copies a rect of src at the given position, the rects are clipped to both buffers.
+  void copy_from(const pixel_buffer& src, const nano::rect<int>& src_rect, const nano::point<int>& dst);
+
+  /// moves the pixels within the area by delta, pixels moved outside of the area are dropped.
+  /// @details the part of the area that nothing moves into keeps its previous content.
+  void scroll(const nano::rect<int>& area, const nano::point<int>& delta);
+
+  inline int get_width() const noexcept { return m_width; }
+
+  inline int get_height() const noexcept { return m_height; }
+
+  /// returns the number of pixels between two rows.
+  inline int get_stride() const noexcept { return m_stride; }
+
+  inline nano::size<int> get_size() const noexcept { return nano::size<int>(m_width, m_height); }
+
+  inline nano::rect<int> get_bounds() const noexcept { return nano::rect<int>(0, 0, m_width, m_height); }
+
+  inline bool empty() const noexcept { return m_width == 0 || m_height == 0; }
+
+  inline pixel_type* data() noexcept { return m_data.data(); }
+
+  inline const pixel_type* data() const noexcept { return m_data.data(); }
+
+  inline pixel_type* row(int y) noexcept { return m_data.data() + static_cast<std::size_t>(y * m_stride); }
+
+  inline const pixel_type* row(int y) const noexcept {
+    return m_data.data() + static_cast<std::size_t>(y * m_stride);
+  }
+
+  inline pixel_type get_pixel(int x, int y) const noexcept { return row(y)[x]; }
+
+  inline void set_pixel(int x, int y, pixel_type value) noexcept { row(y)[x] = value; }
+
+  inline std::size_t get_byte_size() const noexcept { return m_data.size() * sizeof(pixel_type); }
+
+private:
+  std::vector<pixel_type> m_data;
+  int m_width = 0;
+  int m_height = 0;
+  int m_stride = 0;
+};
+
+struct image_difference {
+  std::size_t pixel_count = 0;
+  /// number of pixels with at least one component differing by more than the tolerance.
+  std::size_t different_pixel_count = 0;
+  int max_component_difference = 0;
+  bool same_size = true;
+
+  /// returns the ratio of different pixels.
+  inline double get_different_ratio() const noexcept {
+    return pixel_count ? static_cast<double>(different_pixel_count) / static_cast<double>(pixel_count) : 0.0;
+  }
+};
+
+/// compares two images component by component.
+/// @details images of different sizes are entirely different.
+image_difference compare(const pixel_buffer& a, const pixel_buffer& b, int tolerance = 0);
+
+/// writes the buffer as a png file.
+bool write_png(const pixel_buffer& buffer, const std::string& path);
+
+/// reads a png file, the buffer is resized to the image size.
+bool read_png(pixel_buffer& buffer, const std::string& path);
+
+/// draws a rect of the image scaled into a rect of the context.
+/// @details the image is shared with the context until it is drawn, it must not be modified.
+void draw_image(nano::graphic_context& gc, std::shared_ptr<const pixel_buffer> image, const nano::rect<int>& src_rect,
+    const nano::rect<float>& dst_rect);
+} // namespace nano.
+
+NANO_CLANG_DIAGNOSTIC_POP()
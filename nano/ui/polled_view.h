@@ -0,0 +1,90 @@
+/*
+ * Nano Library
+ *
+ * Copyright (C) 2022, Meta-Sonic
+ * All rights reserved.
+ *
+ * Proprietary and confidential.
+ * Any unauthorized copying, alteration, distribution, transmission, performance,
+ * display or other use of this material is strictly prohibited.
+ *
+ * Written by Alexandre Arsenault <alx.arsenault@gmail.com>
+ */
+
+#pragma once
+
+/*!
+ * @file      nano/ui/polled_view.h
+ * @brief     nano ui view polling a published source
+ * @copyright Copyright (C) 2022, Meta-Sonic
+ * @author    Alexandre Arsenault alx.arsenault@gmail.com
+ * @date      Created 16/06/2022
+ */
+
+#include <nano/ui.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+
+NANO_CLANG_DIAGNOSTIC_PUSH()
+NANO_CLANG_DIAGNOSTIC(warning, "-Weverything")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wc++98-compat")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wpadded")
+
+namespace nano {
+
+/// a view drawing the frames that a worker publishes through a triple buffer.
+///
+/// @details a frame timer polls the source at its refresh rate and the view
+///          redraws only when a frame it hasn't drawn was published. the source
+///          can be shared by several views. Source has poll(), get_frame_index()
+///          and get_options().refresh_rate (e.g. spectrum_analyzer).
+template <class Source>
+class polled_view : public view, private timer {
+public:
+  polled_view(view* parent, const nano::rect<int>& rect)
+      : view(parent, rect) {}
+
+  ~polled_view() override { timer::stop(); }
+
+protected:
+  inline const std::shared_ptr<Source>& get_source() const noexcept { return m_source; }
+
+  void set_source(std::shared_ptr<Source> source) {
+    m_source = std::move(source);
+    m_drawn_index = 0;
+
+    if (m_source) {
+      timer::start(static_cast<std::uint32_t>(1000.0f / std::max(m_source->get_options().refresh_rate, 1.0f)));
+    }
+    else {
+      timer::stop();
+    }
+
+    redraw();
+  }
+
+  /// marks the frame taken by the last poll as drawn, from on_draw().
+  inline void set_drawn() noexcept { m_drawn_index = m_source ? m_source->get_frame_index() : 0; }
+
+private:
+  std::shared_ptr<Source> m_source;
+  std::uint64_t m_drawn_index = 0;
+
+  virtual void on_timer() override {
+    if (!m_source) {
+      return;
+    }
+
+    // A view sharing the source may have polled first.
+    m_source->poll();
+
+    if (m_source->get_frame_index() != m_drawn_index) {
+      redraw();
+    }
+  }
+};
+} // namespace nano.
+
+NANO_CLANG_DIAGNOSTIC_POP()
@@ -0,0 +1,75 @@
+/*
+ * Nano Library
+ *
+ * Copyright (C) 2022, Meta-Sonic
+ * All rights reserved.
+ *
+ * Proprietary and confidential.
+ * Any unauthorized copying, alteration, distribution, transmission, performance,
+ * display or other use of this material is strictly prohibited.
+ *
+ * Written by Alexandre Arsenault <alx.arsenault@gmail.com>
+ */
+
+#pragma once
+
+/*!
+ * @file      nano/ui/redraw_poster.h
+ * @brief     nano ui redraws posted from worker threads
+ * @copyright Copyright (C) 2022, Meta-Sonic
+ * @author    Alexandre Arsenault alx.arsenault@gmail.com
+ * @date      Created 16/06/2022
+ */
+
+#include <nano/ui.h>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+
+NANO_CLANG_DIAGNOSTIC_PUSH()
+NANO_CLANG_DIAGNOSTIC(warning, "-Weverything")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wc++98-compat")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wpadded")
+
+namespace nano {
+
+/// redraws a view from the main queue when a worker makes progress.
+///
+/// @details at most one redraw is posted at a time. a member of the view, the
+///          posted redraws are dropped once it is destroyed.
+class redraw_poster {
+public:
+  explicit redraw_poster(view* v)
+      : m_view(v) {}
+
+  redraw_poster(const redraw_poster&) = delete;
+  redraw_poster& operator=(const redraw_poster&) = delete;
+
+  /// returns the callback given to the worker, it can be called from any thread.
+  std::function<void()> get_callback() const {
+    std::weak_ptr<std::atomic<bool>> pending = m_pending;
+    view* v = m_view;
+
+    return [v, pending]() {
+      std::shared_ptr<std::atomic<bool>> p = pending.lock();
+      if (!p || p->exchange(true)) {
+        return;
+      }
+
+      post_message([v, pending]() {
+        if (std::shared_ptr<std::atomic<bool>> p = pending.lock()) {
+          p->store(false);
+          v->redraw();
+        }
+      });
+    };
+  }
+
+private:
+  view* m_view;
+  std::shared_ptr<std::atomic<bool>> m_pending = std::make_shared<std::atomic<bool>>(false);
+};
+} // namespace nano.
+
+NANO_CLANG_DIAGNOSTIC_POP()
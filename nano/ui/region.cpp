@@ -0,0 +1,122 @@
+/*
+ * Nano Library
+ *
+ * Copyright (C) 2022, Meta-Sonic
+ * All rights reserved.
+ *
+ * Proprietary and confidential.
+ * Any unauthorized copying, alteration, distribution, transmission, performance,
+ * display or other use of this material is strictly prohibited.
+ *
+ * Written by Alexandre Arsenault <alx.arsenault@gmail.com>
+ */
+
+#include <nano/ui/region.h>
+
+#include <cstdint>
+
+NANO_CLANG_DIAGNOSTIC_PUSH()
+NANO_CLANG_DIAGNOSTIC(warning, "-Weverything")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wc++98-compat")
+
+namespace nano {
+
+namespace {
+  inline std::int64_t get_area(const nano::rect<int>& r) noexcept {
+    return static_cast<std::int64_t>(r.width) * static_cast<std::int64_t>(r.height);
+  }
+
+  /// the union adds at most an eighth of the area of both rects.
+  inline bool should_merge(const nano::rect<int>& a, const nano::rect<int>& b) noexcept {
+    const std::int64_t area = get_area(a) + get_area(b);
+    return get_area(get_union(a, b)) <= area + area / 8;
+  }
+} // namespace.
+
+void region::add(const nano::rect<int>& r) {
+  if (is_empty(r)) {
+    return;
+  }
+
+  nano::rect<int> merged = r;
+
+  for (std::size_t i = 0; i < m_rects.size();) {
+    if (nano::contains(m_rects[i], merged)) {
+      return;
+    }
+
+    if (should_merge(m_rects[i], merged)) {
+      merged = get_union(m_rects[i], merged);
+      m_rects.erase(m_rects.begin() + static_cast<std::ptrdiff_t>(i));
+      i = 0;
+      continue;
+    }
+
+    i++;
+  }
+
+  m_rects.push_back(merged);
+
+  if (m_rects.size() > max_rect_count) {
+    const nano::rect<int> bounds = get_bounds();
+    m_rects.clear();
+    m_rects.push_back(bounds);
+  }
+}
+
+void region::add(const region& r) {
+  for (const nano::rect<int>& rect : r.m_rects) {
+    add(rect);
+  }
+}
+
+void region::clip(const nano::rect<int>& r) {
+  std::vector<nano::rect<int>> rects;
+  rects.reserve(m_rects.size());
+
+  for (const nano::rect<int>& rect : m_rects) {
+    const nano::rect<int> clipped = get_intersection(rect, r);
+
+    if (!is_empty(clipped)) {
+      rects.push_back(clipped);
+    }
+  }
+
+  m_rects = std::move(rects);
+}
+
+void region::offset(const nano::point<int>& delta) {
+  for (nano::rect<int>& rect : m_rects) {
+    rect.x += delta.x;
+    rect.y += delta.y;
+  }
+}
+
+nano::rect<int> region::get_bounds() const noexcept {
+  nano::rect<int> bounds(0, 0, 0, 0);
+
+  for (const nano::rect<int>& rect : m_rects) {
+    bounds = get_union(bounds, rect);
+  }
+
+  return bounds;
+}
+
+std::size_t region::get_area() const noexcept {
+  // Rects can still overlap after a collapse or a clip, this is an upper bound.
+  std::size_t area = 0;
+
+  for (const nano::rect<int>& rect : m_rects) {
+    area += static_cast<std::size_t>(rect.width) * static_cast<std::size_t>(rect.height);
+  }
+
+  return area;
+}
+
+bool region::intersects(const nano::rect<int>& r) const noexcept {
+  return std::any_of(
+      m_rects.begin(), m_rects.end(), [&r](const nano::rect<int>& rect) { return nano::intersects(rect, r); });
+}
+} // namespace nano.
+
+NANO_CLANG_DIAGNOSTIC_POP()
@@ -0,0 +1,118 @@
+/*
+ * Nano Library
+ *
+ * Copyright (C) 2022, Meta-Sonic
+ * All rights reserved.
+ *
+ * Proprietary and confidential.
+ * Any unauthorized copying, alteration, distribution, transmission, performance,
+ * display or other use of this material is strictly prohibited.
+ *
+ * Written by Alexandre Arsenault <alx.arsenault@gmail.com>
+ */
+
+#pragma once
+
+/*!
+ * @file      nano/ui/region.h
+ * @brief     nano ui region
+ * @copyright Copyright (C) 2022, Meta-Sonic
+ * @author    Alexandre Arsenault alx.arsenault@gmail.com
+ * @date      Created 16/06/2022
+ */
+
+#include <nano/graphics.h>
+
+#include <algorithm>
+#include <vector>
+
+NANO_CLANG_DIAGNOSTIC_PUSH()
+NANO_CLANG_DIAGNOSTIC(warning, "-Weverything")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wc++98-compat")
+
+namespace nano {
+
+inline bool is_empty(const nano::rect<int>& r) noexcept { return r.width <= 0 || r.height <= 0; }
+
+inline bool intersects(const nano::rect<int>& a, const nano::rect<int>& b) noexcept {
+  return a.x < b.x + b.width && b.x < a.x + a.width && a.y < b.y + b.height && b.y < a.y + a.height;
+}
+
+inline bool contains(const nano::rect<int>& a, const nano::rect<int>& b) noexcept {
+  return b.x >= a.x && b.y >= a.y && b.x + b.width <= a.x + a.width && b.y + b.height <= a.y + a.height;
+}
+
+/// returns the smallest rect containing both rects.
+inline nano::rect<int> get_union(const nano::rect<int>& a, const nano::rect<int>& b) noexcept {
+  if (is_empty(a)) {
+    return b;
+  }
+
+  if (is_empty(b)) {
+    return a;
+  }
+
+  const int left = std::min(a.x, b.x);
+  const int top = std::min(a.y, b.y);
+  const int right = std::max(a.x + a.width, b.x + b.width);
+  const int bottom = std::max(a.y + a.height, b.y + b.height);
+  return nano::rect<int>(left, top, right - left, bottom - top);
+}
+
+/// returns the overlapping area of both rects, or an empty rect.
+inline nano::rect<int> get_intersection(const nano::rect<int>& a, const nano::rect<int>& b) noexcept {
+  const int left = std::max(a.x, b.x);
+  const int top = std::max(a.y, b.y);
+  const int right = std::min(a.x + a.width, b.x + b.width);
+  const int bottom = std::min(a.y + a.height, b.y + b.height);
+
+  if (right <= left || bottom <= top) {
+    return nano::rect<int>(left, top, 0, 0);
+  }
+
+  return nano::rect<int>(left, top, right - left, bottom - top);
+}
+
+/// a set of rects used to accumulate damaged areas.
+///
+/// @details a rect is merged with another one when their union is not much
+///          larger than both of them (e.g. they overlap or share most of an
+///          edge), so that distant areas are not repainted together. the whole
+///          region collapses to its bounding box once it holds more than
+///          max_rect_count rects so that consumers never iterate a long list.
+class region {
+public:
+  static constexpr std::size_t max_rect_count = 16;
+
+  region() = default;
+
+  inline region(const nano::rect<int>& r) { add(r); }
+
+  void add(const nano::rect<int>& r);
+
+  void add(const region& r);
+
+  /// removes everything outside of the given rect.
+  void clip(const nano::rect<int>& r);
+
+  void offset(const nano::point<int>& delta);
+
+  inline void clear() noexcept { m_rects.clear(); }
+
+  inline bool empty() const noexcept { return m_rects.empty(); }
+
+  inline const std::vector<nano::rect<int>>& get_rects() const noexcept { return m_rects; }
+
+  nano::rect<int> get_bounds() const noexcept;
+
+  /// returns the total area covered by the region.
+  std::size_t get_area() const noexcept;
+
+  bool intersects(const nano::rect<int>& r) const noexcept;
+
+private:
+  std::vector<nano::rect<int>> m_rects;
+};
+} // namespace nano.
+
+NANO_CLANG_DIAGNOSTIC_POP()
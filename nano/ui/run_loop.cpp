@@ -0,0 +1,336 @@
+/*
+ * Nano Library
+ *
+ * Copyright (C) 2022, Meta-Sonic
+ * All rights reserved.
+ *
+ * Proprietary and confidential.
+ * Any unauthorized copying, alteration, distribution, transmission, performance,
+ * display or other use of this material is strictly prohibited.
+ *
+ * Written by Alexandre Arsenault <alx.arsenault@gmail.com>
+ */
+
+#include <nano/ui/run_loop.h>
+
+#if defined(__linux__)
+
+#include <algorithm>
+#include <cerrno>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+NANO_CLANG_DIAGNOSTIC_PUSH()
+NANO_CLANG_DIAGNOSTIC(warning, "-Weverything")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wc++98-compat")
+
+namespace nano {
+
+namespace {
+  constexpr int max_events = 64;
+
+  inline std::uint64_t make_key(int fd, std::uint32_t generation) noexcept {
+    return (static_cast<std::uint64_t>(generation) << 32) | static_cast<std::uint32_t>(fd);
+  }
+
+  template <class Fn>
+  class function_message : public message {
+  public:
+    function_message(Fn&& fn)
+        : m_fn(std::move(fn)) {}
+
+    virtual ~function_message() override = default;
+
+    virtual void call() override { m_fn(); }
+
+  private:
+    Fn m_fn;
+  };
+
+  template <class Fn>
+  inline std::shared_ptr<message> make_message(Fn&& fn) {
+    return std::make_shared<function_message<Fn>>(std::forward<Fn>(fn));
+  }
+} // namespace.
+
+run_loop::run_loop() {
+  m_epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  m_wake_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+
+  if (m_epoll_fd < 0 || m_wake_fd < 0) {
+    return;
+  }
+
+  // The counter is read before the queue is taken, a post made in between
+  // writes it again and is seen by the next wait.
+  add_source(m_wake_fd, EPOLLIN, [this](std::uint32_t) {
+    std::uint64_t value;
+    while (read(m_wake_fd, &value, sizeof(value)) < 0 && errno == EINTR) {
+    }
+  });
+}
+
+run_loop::~run_loop() {
+  for (const auto& s : m_sources) {
+    if (s.first != m_wake_fd) {
+      epoll_ctl(m_epoll_fd, EPOLL_CTL_DEL, s.first, nullptr);
+    }
+  }
+
+  if (m_wake_fd >= 0) {
+    close(m_wake_fd);
+  }
+
+  if (m_epoll_fd >= 0) {
+    close(m_epoll_fd);
+  }
+}
+
+run_loop& run_loop::get_main() {
+  NANO_CLANG_PUSH_WARNING("-Wexit-time-destructors")
+  static run_loop loop;
+  NANO_CLANG_POP_WARNING()
+  return loop;
+}
+
+void run_loop::post(std::shared_ptr<message> msg) {
+  bool was_empty;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    was_empty = m_messages.empty();
+    m_messages.push_back(std::move(msg));
+  }
+
+  // Only the first message of a batch wakes the loop.
+  if (was_empty) {
+    const std::uint64_t one = 1;
+    while (write(m_wake_fd, &one, sizeof(one)) < 0 && errno == EINTR) {
+    }
+  }
+}
+
+bool run_loop::add_source(int fd, std::uint32_t events, source_callback callback) {
+  if (fd < 0 || m_epoll_fd < 0 || m_sources.count(fd)) {
+    return false;
+  }
+
+  auto s = std::make_shared<source>(source{ std::move(callback), ++m_generation });
+
+  epoll_event evt = {};
+  evt.events = events;
+  evt.data.u64 = make_key(fd, s->generation);
+
+  if (epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, fd, &evt) != 0) {
+    return false;
+  }
+
+  m_sources.emplace(fd, std::move(s));
+  return true;
+}
+
+bool run_loop::remove_source(int fd) {
+  const auto it = m_sources.find(fd);
+  if (it == m_sources.end()) {
+    return false;
+  }
+
+  epoll_ctl(m_epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+  m_sources.erase(it);
+  return true;
+}
+
+int run_loop::add_timer(std::uint32_t interval_ms, std::function<void()> callback) {
+  const int fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+  if (fd < 0) {
+    return -1;
+  }
+
+  // A zero interval would disarm the timer.
+  const std::uint64_t ns = std::max<std::uint64_t>(interval_ms, 1) * 1000000;
+  itimerspec spec = {};
+  spec.it_interval.tv_sec = static_cast<time_t>(ns / 1000000000);
+  spec.it_interval.tv_nsec = static_cast<long>(ns % 1000000000);
+  spec.it_value = spec.it_interval;
+
+  const bool added = timerfd_settime(fd, 0, &spec, nullptr) == 0
+      && add_source(fd, EPOLLIN, [this, fd, callback = std::move(callback)](std::uint32_t) {
+           // Expirations missed while the loop was busy are called once.
+           std::uint64_t count = 0;
+           if (read(fd, &count, sizeof(count)) != sizeof(count) || !count) {
+             return;
+           }
+
+           m_stats.timer_expirations += count;
+           callback();
+         });
+
+  if (!added) {
+    close(fd);
+    return -1;
+  }
+
+  m_sources[fd]->timer = true;
+  return fd;
+}
+
+bool run_loop::remove_timer(int id) {
+  if (id == m_wake_fd || !remove_source(id)) {
+    return false;
+  }
+
+  close(id);
+  return true;
+}
+
+std::size_t run_loop::dispatch_messages() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_dispatched.swap(m_messages);
+  }
+
+  // Messages posted by these ones go to the next batch.
+  const std::size_t count = m_dispatched.size();
+  for (std::shared_ptr<message>& msg : m_dispatched) {
+    msg->call();
+  }
+
+  m_dispatched.clear();
+  m_stats.messages += count;
+  return count;
+}
+
+std::size_t run_loop::dispatch_sources(int timeout_ms, bool& woken) {
+  epoll_event events[max_events];
+  const int count = epoll_wait(m_epoll_fd, events, max_events, timeout_ms);
+  woken = false;
+  if (count <= 0) {
+    return 0;
+  }
+
+  m_stats.wakeups++;
+  std::size_t dispatched = 0;
+
+  for (int i = 0; i < count; i++) {
+    const int fd = static_cast<int>(static_cast<std::uint32_t>(events[i].data.u64));
+    const std::uint32_t generation = static_cast<std::uint32_t>(events[i].data.u64 >> 32);
+
+    // A source removed by a previous callback of this batch is skipped, even if its descriptor was reused.
+    const auto it = m_sources.find(fd);
+    if (it == m_sources.end() || it->second->generation != generation) {
+      continue;
+    }
+
+    // Kept alive in case the callback removes it.
+    std::shared_ptr<source> s = it->second;
+    s->callback(events[i].events);
+
+    if (fd == m_wake_fd) {
+      woken = true;
+    }
+    else {
+      dispatched++;
+    }
+  }
+
+  return dispatched;
+}
+
+std::size_t run_loop::run_once(int timeout_ms) {
+  bool woken = false;
+  std::size_t dispatched = dispatch_sources(timeout_ms, woken);
+
+  if (woken) {
+    dispatched += dispatch_messages();
+  }
+
+  return dispatched;
+}
+
+pump_result run_loop::pump(std::chrono::microseconds time_budget) {
+  const auto deadline = std::chrono::steady_clock::now() + time_budget;
+
+  // The ready sources are all dispatched, an edge-triggered one skipped here would not be reported again.
+  bool woken = false;
+  pump_result result;
+  result.dispatched = dispatch_sources(0, woken);
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_dispatched.swap(m_messages);
+  }
+
+  std::size_t count = 0;
+  for (; count < m_dispatched.size(); count++) {
+    if (count && std::chrono::steady_clock::now() >= deadline) {
+      break;
+    }
+
+    m_dispatched[count]->call();
+  }
+
+  // The messages not reached go back in front of the ones posted meanwhile.
+  bool was_empty = false;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    was_empty = m_messages.empty();
+    const auto first = m_dispatched.begin() + static_cast<std::ptrdiff_t>(count);
+    m_messages.insert(m_messages.begin(), first, m_dispatched.end());
+    result.pending_messages = m_messages.size();
+  }
+
+  // The wakeup of these was read above, run() would not see them otherwise.
+  if (was_empty && result.pending_messages) {
+    const std::uint64_t one = 1;
+    while (write(m_wake_fd, &one, sizeof(one)) < 0 && errno == EINTR) {
+    }
+  }
+
+  m_dispatched.clear();
+  m_stats.messages += count;
+  result.dispatched += count;
+  result.next_timer_ms = get_next_timer_ms();
+  return result;
+}
+
+int run_loop::get_next_timer_ms() const {
+  int next = -1;
+  for (const auto& s : m_sources) {
+    itimerspec spec = {};
+    if (!s.second->timer || timerfd_gettime(s.first, &spec) != 0) {
+      continue;
+    }
+
+    // Truncated, a timer due within a millisecond is reported as due.
+    const std::int64_t ns = static_cast<std::int64_t>(spec.it_value.tv_sec) * 1000000000 + spec.it_value.tv_nsec;
+    const int ms = static_cast<int>(ns / 1000000);
+    next = next < 0 ? ms : std::min(next, ms);
+  }
+
+  return next;
+}
+
+int run_loop::run() {
+  m_running = true;
+  m_quit = false;
+
+  while (!m_quit) {
+    run_once(-1);
+  }
+
+  m_running = false;
+  return m_exit_code;
+}
+
+void run_loop::quit(int exit_code) {
+  post(make_message([this, exit_code]() {
+    m_exit_code = exit_code;
+    m_quit = true;
+  }));
+}
+} // namespace nano.
+
+NANO_CLANG_DIAGNOSTIC_POP()
+
+#endif
@@ -0,0 +1,153 @@
+/*
+ * Nano Library
+ *
+ * Copyright (C) 2022, Meta-Sonic
+ * All rights reserved.
+ *
+ * Proprietary and confidential.
+ * Any unauthorized copying, alteration, distribution, transmission, performance,
+ * display or other use of this material is strictly prohibited.
+ *
+ * Written by Alexandre Arsenault <alx.arsenault@gmail.com>
+ */
+
+#pragma once
+
+/*!
+ * @file      nano/ui/run_loop.h
+ * @brief     nano ui run loop
+ * @copyright Copyright (C) 2022, Meta-Sonic
+ * @author    Alexandre Arsenault alx.arsenault@gmail.com
+ * @date      Created 16/06/2022
+ */
+
+#include <nano/ui.h>
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+NANO_CLANG_DIAGNOSTIC_PUSH()
+NANO_CLANG_DIAGNOSTIC(warning, "-Weverything")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wc++98-compat")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wpadded")
+
+#if defined(__linux__)
+
+namespace nano {
+
+/// the main loop on platforms without a native one, built on epoll.
+///
+/// @details posted messages are queued under a lock and wake the loop through
+///          an eventfd. it is only written when the queue was empty, so a burst
+///          of posts costs a single wakeup. each timer is a timerfd and every
+///          file descriptor is a source with its own callback, all of them are
+///          waited on by a single epoll_wait().
+///
+///          post() and quit() can be called from any thread, everything else
+///          from the thread running the loop.
+class run_loop {
+public:
+  /// called with the epoll events of a source.
+  using source_callback = std::function<void(std::uint32_t events)>;
+
+  struct stats {
+    /// the number of times epoll_wait() returned with events.
+    std::uint64_t wakeups = 0;
+    std::uint64_t messages = 0;
+    std::uint64_t timer_expirations = 0;
+  };
+
+  run_loop();
+
+  run_loop(const run_loop&) = delete;
+  run_loop(run_loop&&) = delete;
+
+  ~run_loop();
+
+  run_loop& operator=(const run_loop&) = delete;
+  run_loop& operator=(run_loop&&) = delete;
+
+  /// returns the loop of the main thread, used by application, post_message() and timer.
+  static run_loop& get_main();
+
+  /// queues a message, from any thread.
+  void post(std::shared_ptr<message> msg);
+
+  /// waits on a file descriptor.
+  /// @param events the epoll events (e.g. EPOLLIN | EPOLLET).
+  /// @returns false if the descriptor can't be waited on or already is.
+  bool add_source(int fd, std::uint32_t events, source_callback callback);
+
+  /// stops waiting on a file descriptor, it can be called from its callback.
+  bool remove_source(int fd);
+
+  /// starts a repeating timer.
+  /// @returns the id of the timer, or -1 on error.
+  int add_timer(std::uint32_t interval_ms, std::function<void()> callback);
+
+  bool remove_timer(int id);
+
+  /// dispatches the messages, timers and sources until quit() is called.
+  /// @returns the exit code given to quit().
+  int run();
+
+  /// waits at most timeout_ms for events (-1 to wait forever) and dispatches them.
+  /// @returns the number of messages and callbacks dispatched.
+  std::size_t run_once(int timeout_ms);
+
+  /// dispatches the ready sources and the posted messages within a time budget, without waiting.
+  /// @details see nano::pump(), the loop of a host (e.g. a plugin host) calls it instead of run().
+  pump_result pump(std::chrono::microseconds time_budget);
+
+  /// stops run() once the messages posted before are dispatched, from any thread.
+  void quit(int exit_code = 0);
+
+  inline bool is_running() const noexcept { return m_running; }
+
+  inline bool is_valid() const noexcept { return m_epoll_fd >= 0 && m_wake_fd >= 0; }
+
+  /// returns the epoll file descriptor, it is readable when the loop has work.
+  /// @details a host with its own loop can wait on it and call pump() when it is readable.
+  inline int get_file_descriptor() const noexcept { return m_epoll_fd; }
+
+  inline const stats& get_stats() const noexcept { return m_stats; }
+
+  inline void reset_stats() noexcept { m_stats = stats(); }
+
+private:
+  struct source {
+    source_callback callback;
+    std::uint32_t generation;
+    bool timer = false;
+  };
+
+  int m_epoll_fd = -1;
+  int m_wake_fd = -1;
+
+  /// the sources by file descriptor, the generation tells a removed source from a reused descriptor.
+  std::unordered_map<int, std::shared_ptr<source>> m_sources;
+  std::uint32_t m_generation = 0;
+
+  std::mutex m_mutex;
+  std::vector<std::shared_ptr<message>> m_messages;
+  std::vector<std::shared_ptr<message>> m_dispatched;
+
+  stats m_stats;
+  int m_exit_code = 0;
+  bool m_running = false;
+  bool m_quit = false;
+
+  std::size_t dispatch_messages();
+  std::size_t dispatch_sources(int timeout_ms, bool& woken);
+  int get_next_timer_ms() const;
+};
+} // namespace nano.
+
+#endif
+
+NANO_CLANG_DIAGNOSTIC_POP()
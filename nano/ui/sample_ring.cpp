@@ -0,0 +1,96 @@
+/*
+ * Nano Library
+ *
+ * Copyright (C) 2022, Meta-Sonic
+ * All rights reserved.
+ *
+ * Proprietary and confidential.
+ * Any unauthorized copying, alteration, distribution, transmission, performance,
+ * display or other use of this material is strictly prohibited.
+ *
+ * Written by Alexandre Arsenault <alx.arsenault@gmail.com>
+ */
+
+#include <nano/ui/sample_ring.h>
+
+#include <algorithm>
+#include <cstring>
+
+NANO_CLANG_DIAGNOSTIC_PUSH()
+NANO_CLANG_DIAGNOSTIC(warning, "-Weverything")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wc++98-compat")
+
+namespace nano {
+
+namespace {
+  inline std::size_t next_power_of_two(std::size_t value) noexcept {
+    std::size_t p = 1;
+    while (p < value) {
+      p <<= 1;
+    }
+
+    return p;
+  }
+} // namespace.
+
+sample_ring::sample_ring(std::size_t capacity, int channel_count)
+    : m_capacity(next_power_of_two(std::max<std::size_t>(capacity, 2)))
+    , m_mask(m_capacity - 1)
+    , m_channel_count(std::max(channel_count, 1)) {
+  m_samples.resize(m_capacity * static_cast<std::size_t>(m_channel_count), 0.0f);
+}
+
+std::size_t sample_ring::get_read_available() const noexcept {
+  return m_write_position.load(std::memory_order_acquire) - m_read_position.load(std::memory_order_acquire);
+}
+
+std::size_t sample_ring::get_write_available() const noexcept { return m_capacity - get_read_available(); }
+
+std::size_t sample_ring::write(const float* const* channels, std::size_t frame_count) noexcept {
+  const std::size_t position = m_write_position.load(std::memory_order_relaxed);
+  const std::size_t available = m_capacity - (position - m_read_position.load(std::memory_order_acquire));
+  const std::size_t count = std::min(frame_count, available);
+
+  if (count < frame_count) {
+    m_dropped.fetch_add(frame_count - count, std::memory_order_relaxed);
+  }
+
+  const std::size_t start = position & m_mask;
+  const std::size_t first = std::min(count, m_capacity - start);
+
+  for (int c = 0; c < m_channel_count; c++) {
+    float* samples = m_samples.data() + static_cast<std::size_t>(c) * m_capacity;
+    std::memcpy(samples + start, channels[c], first * sizeof(float));
+    std::memcpy(samples, channels[c] + first, (count - first) * sizeof(float));
+  }
+
+  m_write_position.store(position + count, std::memory_order_release);
+  return count;
+}
+
+std::size_t sample_ring::read(float* const* channels, std::size_t frame_count) noexcept {
+  const std::size_t position = m_read_position.load(std::memory_order_relaxed);
+  const std::size_t count = std::min(frame_count, m_write_position.load(std::memory_order_acquire) - position);
+
+  const std::size_t start = position & m_mask;
+  const std::size_t first = std::min(count, m_capacity - start);
+
+  for (int c = 0; c < m_channel_count; c++) {
+    const float* samples = m_samples.data() + static_cast<std::size_t>(c) * m_capacity;
+    std::memcpy(channels[c], samples + start, first * sizeof(float));
+    std::memcpy(channels[c] + first, samples, (count - first) * sizeof(float));
+  }
+
+  m_read_position.store(position + count, std::memory_order_release);
+  return count;
+}
+
+std::size_t sample_ring::skip(std::size_t frame_count) noexcept {
+  const std::size_t position = m_read_position.load(std::memory_order_relaxed);
+  const std::size_t count = std::min(frame_count, m_write_position.load(std::memory_order_acquire) - position);
+  m_read_position.store(position + count, std::memory_order_release);
+  return count;
+}
+} // namespace nano.
+
+NANO_CLANG_DIAGNOSTIC_POP()
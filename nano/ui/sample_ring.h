@@ -0,0 +1,144 @@
+/*
+ * Nano Library
+ *
+ * Copyright (C) 2022, Meta-Sonic
+ * All rights reserved.
+ *
+ * Proprietary and confidential.
+ * Any unauthorized copying, alteration, distribution, transmission, performance,
+ * display or other use of this material is strictly prohibited.
+ *
+ * Written by Alexandre Arsenault <alx.arsenault@gmail.com>
+ */
+
+#pragma once
+
+/*!
+ * @file      nano/ui/sample_ring.h
+ * @brief     nano ui lock-free sample ring and triple buffer
+ * @copyright Copyright (C) 2022, Meta-Sonic
+ * @author    Alexandre Arsenault alx.arsenault@gmail.com
+ * @date      Created 16/06/2022
+ */
+
+#include <nano/graphics.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+NANO_CLANG_DIAGNOSTIC_PUSH()
+NANO_CLANG_DIAGNOSTIC(warning, "-Weverything")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wc++98-compat")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wpadded")
+
+namespace nano {
+
+/// single producer, single consumer ring of planar float samples.
+///
+/// @details meant to carry samples from the audio thread to the ui: write()
+///          never blocks, allocates or waits for the reader. when the ring is
+///          full the new frames are dropped and counted, the reader is
+///          expected to drain it regularly.
+class sample_ring {
+public:
+  /// @param capacity the number of frames, rounded up to a power of two.
+  sample_ring(std::size_t capacity, int channel_count);
+
+  sample_ring(const sample_ring&) = delete;
+  sample_ring(sample_ring&&) = delete;
+
+  ~sample_ring() = default;
+
+  sample_ring& operator=(const sample_ring&) = delete;
+  sample_ring& operator=(sample_ring&&) = delete;
+
+  /// writes the frames that fit, from the producer thread.
+  /// @returns the number of frames written.
+  std::size_t write(const float* const* channels, std::size_t frame_count) noexcept;
+
+  /// reads up to frame_count frames, from the consumer thread.
+  /// @returns the number of frames read.
+  std::size_t read(float* const* channels, std::size_t frame_count) noexcept;
+
+  /// discards up to frame_count frames, from the consumer thread.
+  std::size_t skip(std::size_t frame_count) noexcept;
+
+  std::size_t get_read_available() const noexcept;
+
+  std::size_t get_write_available() const noexcept;
+
+  inline std::size_t get_capacity() const noexcept { return m_capacity; }
+
+  inline int get_channel_count() const noexcept { return m_channel_count; }
+
+  /// returns the number of frames dropped because the ring was full.
+  inline std::uint64_t get_dropped_count() const noexcept { return m_dropped.load(std::memory_order_relaxed); }
+
+private:
+  static constexpr std::size_t cache_line_size = 64;
+
+  std::vector<float> m_samples;
+  std::size_t m_capacity;
+  std::size_t m_mask;
+  int m_channel_count;
+
+  // The positions only grow, they are written by one thread each and kept on
+  // separate cache lines.
+  alignas(cache_line_size) std::atomic<std::size_t> m_write_position = 0;
+  alignas(cache_line_size) std::atomic<std::size_t> m_read_position = 0;
+  alignas(cache_line_size) std::atomic<std::uint64_t> m_dropped = 0;
+};
+
+/// hands the latest value from one writer thread to one reader thread.
+///
+/// @details the writer fills get_back() and publishes it, the reader takes the
+///          latest published value with update(). neither side ever waits,
+///          intermediate values are skipped when the reader is slower.
+template <class T>
+class triple_buffer {
+public:
+  triple_buffer() = default;
+
+  /// sets the three buffers, not thread safe.
+  inline void reset(const T& value) {
+    for (T& b : m_buffers) {
+      b = value;
+    }
+  }
+
+  /// returns the buffer being written, from the writer thread.
+  inline T& get_back() noexcept { return m_buffers[m_back]; }
+
+  /// makes the back buffer the latest value, from the writer thread.
+  inline void publish() noexcept {
+    m_back = m_middle.exchange(static_cast<std::uint8_t>(m_back | dirty_bit), std::memory_order_acq_rel) & index_mask;
+  }
+
+  /// takes the latest published value, from the reader thread.
+  /// @returns false if nothing was published since the last update.
+  inline bool update() noexcept {
+    if (!(m_middle.load(std::memory_order_relaxed) & dirty_bit)) {
+      return false;
+    }
+
+    m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & index_mask;
+    return true;
+  }
+
+  /// returns the latest value taken by update(), from the reader thread.
+  inline const T& get_front() const noexcept { return m_buffers[m_front]; }
+
+private:
+  static constexpr std::uint8_t dirty_bit = 4;
+  static constexpr std::uint8_t index_mask = 3;
+
+  T m_buffers[3];
+  std::atomic<std::uint8_t> m_middle = 1;
+  std::uint8_t m_back = 0;
+  std::uint8_t m_front = 2;
+};
+} // namespace nano.
+
+NANO_CLANG_DIAGNOSTIC_POP()
@@ -0,0 +1,111 @@
+/*
+ * Nano Library
+ *
+ * Copyright (C) 2022, Meta-Sonic
+ * All rights reserved.
+ *
+ * Proprietary and confidential.
+ * Any unauthorized copying, alteration, distribution, transmission, performance,
+ * display or other use of this material is strictly prohibited.
+ *
+ * Written by Alexandre Arsenault <alx.arsenault@gmail.com>
+ */
+
+#include <nano/ui/scroll_view.h>
+#include <nano/ui/region.h>
+
+#include <algorithm>
+#include <cmath>
+
+NANO_CLANG_DIAGNOSTIC_PUSH()
+NANO_CLANG_DIAGNOSTIC(warning, "-Weverything")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wc++98-compat")
+
+namespace nano {
+
+scroll_view::scroll_view(view* parent, const nano::rect<int>& rect)
+    : view(parent, rect) {}
+
+void scroll_view::set_content(view* content) {
+  m_content = content;
+  m_offset = nano::point<int>(0, 0);
+
+  if (m_content) {
+    m_content->set_frame_position(nano::point<int>(0, 0));
+  }
+
+  redraw();
+}
+
+void scroll_view::set_overlay(view* v, bool overlay) {
+  auto it = std::find(m_overlays.begin(), m_overlays.end(), v);
+
+  if (overlay && it == m_overlays.end()) {
+    m_overlays.push_back(v);
+  }
+  else if (!overlay && it != m_overlays.end()) {
+    m_overlays.erase(it);
+  }
+}
+
+bool scroll_view::is_overlay(const view* v) const {
+  return std::find(m_overlays.begin(), m_overlays.end(), v) != m_overlays.end();
+}
+
+nano::point<int> scroll_view::get_max_scroll_offset() const {
+  if (!m_content) {
+    return nano::point<int>(0, 0);
+  }
+
+  const nano::size<int> size = get_frame().size;
+  const nano::size<int> content_size = m_content->get_frame().size;
+  return nano::point<int>(
+      std::max(content_size.width - size.width, 0), std::max(content_size.height - size.height, 0));
+}
+
+void scroll_view::set_scroll_offset(const nano::point<int>& offset) {
+  const nano::point<int> max_offset = get_max_scroll_offset();
+  const nano::point<int> new_offset(std::clamp(offset.x, 0, max_offset.x), std::clamp(offset.y, 0, max_offset.y));
+
+  if (!m_content || new_offset == m_offset) {
+    return;
+  }
+
+  const nano::point<int> delta(m_offset.x - new_offset.x, m_offset.y - new_offset.y);
+  m_offset = new_offset;
+  m_content->set_frame_position(nano::point<int>(-m_offset.x, -m_offset.y));
+
+  const nano::size<int> size = get_frame().size;
+  const nano::rect<int> bounds(0, 0, size.width, size.height);
+  scroll_rect(bounds, delta);
+
+  // The overlays were moved along with the content, they are drawn again at
+  // their place and their moved copy is covered.
+  for (view* v : m_overlays) {
+    if (v->is_hidden()) {
+      continue;
+    }
+
+    const nano::rect<int> frame = v->get_frame();
+    v->redraw();
+
+    const nano::rect<int> moved
+        = get_intersection(nano::rect<int>(frame.x + delta.x, frame.y + delta.y, frame.width, frame.height), bounds);
+    if (!is_empty(moved)) {
+      redraw(moved);
+    }
+  }
+}
+
+void scroll_view::scroll_by(const nano::point<int>& delta) {
+  set_scroll_offset(nano::point<int>(m_offset.x + delta.x, m_offset.y + delta.y));
+}
+
+void scroll_view::on_scroll_wheel(const nano::event& evt) {
+  const nano::point<float>& delta = evt.get_wheel_delta();
+  scroll_by(nano::point<int>(
+      -static_cast<int>(std::lround(delta.x)), -static_cast<int>(std::lround(delta.y))));
+}
+} // namespace nano.
+
+NANO_CLANG_DIAGNOSTIC_POP()
@@ -0,0 +1,77 @@
+/*
+ * Nano Library
+ *
+ * Copyright (C) 2022, Meta-Sonic
+ * All rights reserved.
+ *
+ * Proprietary and confidential.
+ * Any unauthorized copying, alteration, distribution, transmission, performance,
+ * display or other use of this material is strictly prohibited.
+ *
+ * Written by Alexandre Arsenault <alx.arsenault@gmail.com>
+ */
+
+#pragma once
+
+/*!
+ * @file      nano/ui/scroll_view.h
+ * @brief     nano ui scroll view
+ * @copyright Copyright (C) 2022, Meta-Sonic
+ * @author    Alexandre Arsenault alx.arsenault@gmail.com
+ * @date      Created 16/06/2022
+ */
+
+#include <nano/ui.h>
+
+#include <vector>
+
+NANO_CLANG_DIAGNOSTIC_PUSH()
+NANO_CLANG_DIAGNOSTIC(warning, "-Weverything")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wc++98-compat")
+
+namespace nano {
+
+/// view showing a part of a larger content view (e.g. a long list or a timeline).
+///
+/// @details scrolling moves the pixels already drawn with scroll_rect(), so
+///          only the strip that becomes visible is drawn again. overlays are
+///          subviews that stay in place (e.g. headers or a playhead), they are
+///          redrawn after each scroll step. the scroll view's own on_draw()
+///          must not depend on the scroll offset.
+class scroll_view : public view {
+public:
+  scroll_view(view* parent, const nano::rect<int>& rect);
+
+  ~scroll_view() override = default;
+
+  /// sets the scrolled view, it must be a subview of the scroll view.
+  void set_content(view* content);
+
+  inline view* get_content() const noexcept { return m_content; }
+
+  /// marks a subview as an overlay that does not scroll.
+  void set_overlay(view* v, bool overlay = true);
+
+  bool is_overlay(const view* v) const;
+
+  /// scrolls so that the given point of the content is at the top-left of the scroll view.
+  /// @details the offset is clamped between zero and get_max_scroll_offset().
+  void set_scroll_offset(const nano::point<int>& offset);
+
+  void scroll_by(const nano::point<int>& delta);
+
+  inline nano::point<int> get_scroll_offset() const noexcept { return m_offset; }
+
+  nano::point<int> get_max_scroll_offset() const;
+
+protected:
+  void on_scroll_wheel(const nano::event& evt) override;
+
+private:
+  view* m_content = nullptr;
+  std::vector<view*> m_overlays;
+  nano::point<int> m_offset = { 0, 0 };
+};
+} // namespace nano.
+
+NANO_CLANG_DIAGNOSTIC_POP()
@@ -0,0 +1,831 @@
+/*
+ * Nano Library
+ *
+ * Copyright (C) 2022, Meta-Sonic
+ * All rights reserved.
+ *
+ * Proprietary and confidential.
+ * Any unauthorized copying, alteration, distribution, transmission, performance,
+ * display or other use of this material is strictly prohibited.
+ *
+ * Written by Alexandre Arsenault <alx.arsenault@gmail.com>
+ */
+
+#include <nano/ui/spectrogram.h>
+#include <nano/ui/color_conversion.h>
+#include <nano/ui/fft.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+NANO_CLANG_DIAGNOSTIC_PUSH()
+NANO_CLANG_DIAGNOSTIC(warning, "-Weverything")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wc++98-compat")
+
+namespace nano {
+
+namespace {
+  constexpr char pyramid_magic[8] = { 'N', 'S', 'P', 'G', 'R', 'A', 'M', '1' };
+  constexpr std::uint32_t pyramid_version = 1;
+
+  /// the levels start on the page after the header.
+  constexpr std::size_t header_size = 4096;
+
+  /// the number of tiles after the priority one that are computed first.
+  constexpr std::uint64_t priority_tile_count = 8;
+
+  struct pyramid_header {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t fft_size;
+    std::uint32_t hop_size;
+    std::uint32_t row_count;
+    float min_frequency;
+    float max_frequency;
+    float min_db;
+    float max_db;
+    std::uint32_t complete;
+    std::uint32_t reserved;
+    std::uint64_t source_size;
+    std::int64_t source_time;
+    std::uint64_t frame_count;
+  };
+
+  inline std::size_t get_page_size() noexcept { return static_cast<std::size_t>(::sysconf(_SC_PAGESIZE)); }
+
+  inline std::size_t align_up(std::size_t value, std::size_t alignment) noexcept {
+    return (value + alignment - 1) / alignment * alignment;
+  }
+
+  std::string get_temp_directory() {
+    const char* dir = std::getenv("TMPDIR");
+    return dir && *dir ? std::string(dir) : std::string("/tmp");
+  }
+} // namespace.
+
+//
+// MARK: - spectrogram_data -
+//
+
+struct spectrogram_data::worker_state {
+  real_fft fft;
+  std::vector<float> mix;
+  std::vector<float> channel;
+  std::vector<float> windowed;
+  std::vector<float> real;
+  std::vector<float> imag;
+  std::vector<float> power;
+
+  worker_state(std::size_t fft_size)
+      : fft(fft_size)
+      , mix(fft_size)
+      , channel(fft_size)
+      , windowed(fft_size)
+      , real(fft.get_bin_count())
+      , imag(fft.get_bin_count())
+      , power(fft.get_bin_count()) {}
+};
+
+spectrogram_data::spectrogram_data(std::shared_ptr<const mapped_audio_file> file, const options& opts)
+    : m_file(std::move(file))
+    , m_options(opts) {
+  m_options.hop_size = std::max<std::size_t>(m_options.hop_size, 1);
+  m_options.row_count = std::max<std::size_t>(m_options.row_count, 1);
+  m_options.max_db = std::max(m_options.max_db, m_options.min_db + 1.0f);
+
+  const std::size_t fft_size = m_options.fft_size;
+  m_window = make_hann_window(fft_size);
+
+  // A full scale sine reads 0 dB, as with the spectrum analyzer.
+  double window_sum = 0;
+  for (float w : m_window) {
+    window_sum += static_cast<double>(w);
+  }
+  m_power_scale = static_cast<float>(4.0 / (window_sum * window_sum));
+
+  // Each row takes the largest power of the fft bins it covers, at least one.
+  const std::size_t fft_bin_count = fft_size / 2 + 1;
+  const double ratio = static_cast<double>(m_options.max_frequency) / static_cast<double>(m_options.min_frequency);
+  const double hz_per_bin = static_cast<double>(m_file->get_format().sample_rate) / static_cast<double>(fft_size);
+  const double n = static_cast<double>(m_options.row_count);
+  m_bin_ranges.resize(m_options.row_count);
+
+  for (std::size_t i = 0; i < m_options.row_count; i++) {
+    const double lo = m_options.min_frequency * std::pow(ratio, static_cast<double>(i) / n) / hz_per_bin;
+    const double hi = m_options.min_frequency * std::pow(ratio, static_cast<double>(i + 1) / n) / hz_per_bin;
+
+    const std::size_t first = std::clamp<std::size_t>(static_cast<std::size_t>(std::lround(lo)), 1, fft_bin_count - 1);
+    const std::size_t last
+        = std::clamp<std::size_t>(static_cast<std::size_t>(std::lround(hi)), first + 1, fft_bin_count);
+    m_bin_ranges[i] = { static_cast<std::uint32_t>(first), static_cast<std::uint32_t>(last) };
+  }
+
+  const std::uint64_t frame_count = m_file->get_frame_count();
+  if (frame_count == 0) {
+    return;
+  }
+
+  // Levels are added until one fits in a tile.
+  std::uint64_t column_count = (frame_count + m_options.hop_size - 1) / m_options.hop_size;
+
+  while (true) {
+    pyramid_level l;
+    l.column_count = column_count;
+    l.tile_count = (column_count + tile_size - 1) / tile_size;
+    l.data = nullptr;
+    l.ready = std::make_unique<std::atomic<std::uint8_t>[]>(static_cast<std::size_t>(l.tile_count));
+    l.state = std::make_unique<std::atomic<std::uint8_t>[]>(static_cast<std::size_t>(l.tile_count));
+
+    for (std::uint64_t t = 0; t < l.tile_count; t++) {
+      l.ready[t].store(0, std::memory_order_relaxed);
+      l.state[t].store(0, std::memory_order_relaxed);
+    }
+
+    m_total_tile_count += l.tile_count;
+    m_levels.push_back(std::move(l));
+
+    if (column_count <= tile_size) {
+      break;
+    }
+
+    column_count = (column_count + 1) / 2;
+  }
+}
+
+spectrogram_data::~spectrogram_data() {
+  m_cancel = true;
+  wait();
+  unmap();
+}
+
+std::uint64_t spectrogram_data::get_column_count(std::size_t level) const noexcept {
+  return level < m_levels.size() ? m_levels[level].column_count : 0;
+}
+
+std::uint64_t spectrogram_data::get_tile_count(std::size_t level) const noexcept {
+  return level < m_levels.size() ? m_levels[level].tile_count : 0;
+}
+
+bool spectrogram_data::is_tile_ready(std::size_t level, std::uint64_t tile) const noexcept {
+  return level < m_levels.size() && tile < m_levels[level].tile_count
+      && m_levels[level].ready[tile].load(std::memory_order_acquire);
+}
+
+const std::uint8_t* spectrogram_data::get_column(std::size_t level, std::uint64_t column) const noexcept {
+  if (level >= m_levels.size() || column >= m_levels[level].column_count
+      || !m_levels[level].ready[column / tile_size].load(std::memory_order_acquire)) {
+    return nullptr;
+  }
+
+  return m_levels[level].data + column * m_options.row_count;
+}
+
+float spectrogram_data::get_progress() const noexcept {
+  if (m_total_tile_count == 0) {
+    return 1.0f;
+  }
+
+  return static_cast<float>(m_built_tile_count.load(std::memory_order_relaxed))
+      / static_cast<float>(m_total_tile_count);
+}
+
+bool spectrogram_data::build(const std::string& path, std::function<void()> on_progress) {
+  if (!m_threads.empty() || is_ready()) {
+    return true;
+  }
+
+  if (m_levels.empty()) {
+    m_ready = true;
+    return true;
+  }
+
+  if (!map(path)) {
+    return false;
+  }
+
+  m_on_progress = std::move(on_progress);
+
+  if (is_ready()) {
+    if (m_on_progress) {
+      m_on_progress();
+    }
+
+    return true;
+  }
+
+  const int thread_count = m_options.thread_count > 0
+      ? m_options.thread_count
+      : static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u));
+
+  for (int i = 0; i < thread_count; i++) {
+    m_threads.emplace_back(&spectrogram_data::run, this);
+  }
+
+  return true;
+}
+
+void spectrogram_data::wait() {
+  for (std::thread& t : m_threads) {
+    if (t.joinable()) {
+      t.join();
+    }
+  }
+}
+
+bool spectrogram_data::map(const std::string& path) {
+  const std::size_t row_count = m_options.row_count;
+  const std::size_t page_size = get_page_size();
+
+  std::size_t size = header_size;
+  for (const pyramid_level& l : m_levels) {
+    size = align_up(size + static_cast<std::size_t>(l.column_count) * row_count, page_size);
+  }
+
+  int fd = -1;
+  if (path.empty()) {
+    // The temporary file is removed once unmapped.
+    std::string temp_path = get_temp_directory() + "/nano_spectrogram_XXXXXX";
+    fd = ::mkstemp(temp_path.data());
+    if (fd >= 0) {
+      ::unlink(temp_path.c_str());
+    }
+  }
+  else {
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+  }
+
+  if (fd < 0) {
+    return false;
+  }
+
+  struct stat st;
+  const bool same_size = ::fstat(fd, &st) == 0 && static_cast<std::size_t>(st.st_size) == size;
+
+  // The levels of a file of another size can't be reused, it starts again from zeros.
+  if (!same_size && (::ftruncate(fd, 0) != 0 || ::ftruncate(fd, static_cast<off_t>(size)) != 0)) {
+    ::close(fd);
+    return false;
+  }
+
+  void* mapping = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+  // The mapping keeps its own reference to the file.
+  ::close(fd);
+
+  if (mapping == MAP_FAILED) {
+    return false;
+  }
+
+  m_mapping = mapping;
+  m_mapping_size = size;
+
+  std::uint8_t* data = static_cast<std::uint8_t*>(mapping);
+  std::size_t offset = header_size;
+  for (pyramid_level& l : m_levels) {
+    l.data = data + offset;
+    offset = align_up(offset + static_cast<std::size_t>(l.column_count) * row_count, page_size);
+  }
+
+  pyramid_header header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, pyramid_magic, sizeof(pyramid_magic));
+  header.version = pyramid_version;
+  header.fft_size = static_cast<std::uint32_t>(m_options.fft_size);
+  header.hop_size = static_cast<std::uint32_t>(m_options.hop_size);
+  header.row_count = static_cast<std::uint32_t>(row_count);
+  header.min_frequency = m_options.min_frequency;
+  header.max_frequency = m_options.max_frequency;
+  header.min_db = m_options.min_db;
+  header.max_db = m_options.max_db;
+  header.source_size = m_file->get_file_size();
+  header.source_time = m_file->get_modification_time();
+  header.frame_count = m_file->get_frame_count();
+
+  // A complete pyramid of the same file and options is used as is.
+  pyramid_header existing;
+  std::memcpy(&existing, data, sizeof(existing));
+  header.complete = 1;
+
+  if (same_size && std::memcmp(&existing, &header, sizeof(header)) == 0) {
+    for (pyramid_level& l : m_levels) {
+      for (std::uint64_t t = 0; t < l.tile_count; t++) {
+        l.ready[t].store(1, std::memory_order_relaxed);
+      }
+    }
+
+    m_built_tile_count = m_total_tile_count;
+    m_ready.store(true, std::memory_order_release);
+    return true;
+  }
+
+  header.complete = 0;
+  std::memcpy(data, &header, sizeof(header));
+  return true;
+}
+
+void spectrogram_data::unmap() {
+  if (m_mapping) {
+    ::munmap(m_mapping, m_mapping_size);
+    m_mapping = nullptr;
+    m_mapping_size = 0;
+  }
+}
+
+void spectrogram_data::run() {
+  worker_state ws(m_options.fft_size);
+  std::uint64_t tile = 0;
+
+  while (!m_cancel.load(std::memory_order_relaxed) && claim_tile(tile)) {
+    compute_tile(ws, tile);
+    complete_tile(0, tile);
+
+    if (m_on_progress) {
+      m_on_progress();
+    }
+  }
+}
+
+bool spectrogram_data::claim_tile(std::uint64_t& tile) noexcept {
+  const pyramid_level& l = m_levels.front();
+
+  // The tiles around the priority first, then in order.
+  const std::uint64_t priority = m_priority_tile.load(std::memory_order_relaxed);
+  for (std::uint64_t t = priority; t < std::min(priority + priority_tile_count, l.tile_count); t++) {
+    if (!l.state[t].load(std::memory_order_relaxed) && !l.state[t].exchange(1)) {
+      tile = t;
+      return true;
+    }
+  }
+
+  while (true) {
+    const std::uint64_t t = m_next_tile.fetch_add(1);
+    if (t >= l.tile_count) {
+      return false;
+    }
+
+    if (!l.state[t].exchange(1)) {
+      tile = t;
+      return true;
+    }
+  }
+}
+
+void spectrogram_data::compute_tile(worker_state& ws, std::uint64_t tile) {
+  const pyramid_level& l = m_levels.front();
+  const std::size_t fft_size = m_options.fft_size;
+  const std::size_t row_count = m_options.row_count;
+  const std::int64_t frame_count = static_cast<std::int64_t>(m_file->get_frame_count());
+  const int channel_count = m_file->get_format().channel_count;
+  const float gain = 1.0f / static_cast<float>(channel_count);
+  const float db_scale = 255.0f / (m_options.max_db - m_options.min_db);
+
+  const std::uint64_t first = tile * tile_size;
+  const std::uint64_t last = std::min(first + tile_size, l.column_count);
+
+  for (std::uint64_t c = first; c < last; c++) {
+    // The window is centered on the column, the frames outside of the file are silent.
+    const std::int64_t start
+        = static_cast<std::int64_t>(c * m_options.hop_size) - static_cast<std::int64_t>(fft_size / 2);
+    const std::int64_t begin = std::max<std::int64_t>(start, 0);
+    const std::int64_t end = std::min<std::int64_t>(start + static_cast<std::int64_t>(fft_size), frame_count);
+
+    std::fill(ws.mix.begin(), ws.mix.end(), 0.0f);
+
+    if (end > begin) {
+      const std::size_t offset = static_cast<std::size_t>(begin - start);
+      const std::size_t count = static_cast<std::size_t>(end - begin);
+
+      for (int ch = 0; ch < channel_count; ch++) {
+        m_file->read_channel(static_cast<std::uint64_t>(begin), count, ch, ws.channel.data());
+        for (std::size_t i = 0; i < count; i++) {
+          ws.mix[offset + i] += ws.channel[i] * gain;
+        }
+      }
+    }
+
+    apply_window(ws.mix.data(), m_window.data(), ws.windowed.data(), fft_size);
+    ws.fft.forward(ws.windowed.data(), ws.real.data(), ws.imag.data());
+    get_power(ws.real.data(), ws.imag.data(), ws.power.data(), ws.power.size(), m_power_scale);
+
+    std::uint8_t* column = l.data + c * row_count;
+
+    for (std::size_t r = 0; r < row_count; r++) {
+      const bin_range& range = m_bin_ranges[r];
+      const float power = get_max(ws.power.data() + range.first, range.last - range.first);
+      const float db = 10.0f * std::log10(std::max(power, 1e-30f));
+      column[r] = static_cast<std::uint8_t>(std::clamp((db - m_options.min_db) * db_scale + 0.5f, 0.0f, 255.0f));
+    }
+  }
+}
+
+void spectrogram_data::complete_tile(std::size_t level_index, std::uint64_t tile) {
+  const pyramid_level& l = m_levels[level_index];
+  l.ready[tile].store(1, std::memory_order_release);
+
+  // The top tile is the last one.
+  if (m_built_tile_count.fetch_add(1, std::memory_order_acq_rel) + 1 == m_total_tile_count) {
+    finish();
+    return;
+  }
+
+  if (level_index + 1 >= m_levels.size()) {
+    return;
+  }
+
+  // The worker that completes the last tile below reduces the one above.
+  const std::uint64_t parent = tile / 2;
+  const std::uint64_t below_count = std::min<std::uint64_t>(2, l.tile_count - parent * 2);
+
+  if (m_levels[level_index + 1].state[parent].fetch_add(1, std::memory_order_acq_rel) + 1u == below_count) {
+    reduce_tile(level_index + 1, parent);
+
+    // The tiles below are only read again to be rendered.
+    release(level_index, parent * 2, below_count);
+    complete_tile(level_index + 1, parent);
+  }
+}
+
+void spectrogram_data::reduce_tile(std::size_t level_index, std::uint64_t tile) noexcept {
+  const pyramid_level& l = m_levels[level_index];
+  const pyramid_level& below = m_levels[level_index - 1];
+  const std::size_t row_count = m_options.row_count;
+
+  const std::uint64_t first = tile * tile_size;
+  const std::uint64_t last = std::min(first + tile_size, l.column_count);
+
+  for (std::uint64_t c = first; c < last; c++) {
+    std::uint8_t* dst = l.data + c * row_count;
+    const std::uint8_t* a = below.data + c * 2 * row_count;
+
+    if (c * 2 + 1 < below.column_count) {
+      const std::uint8_t* b = a + row_count;
+      for (std::size_t r = 0; r < row_count; r++) {
+        dst[r] = std::max(a[r], b[r]);
+      }
+    }
+    else {
+      std::memcpy(dst, a, row_count);
+    }
+  }
+}
+
+void spectrogram_data::finish() {
+  pyramid_header header;
+  std::memcpy(&header, m_mapping, sizeof(header));
+  header.complete = 1;
+  std::memcpy(m_mapping, &header, sizeof(header));
+  ::msync(m_mapping, m_mapping_size, MS_ASYNC);
+
+  m_ready.store(true, std::memory_order_release);
+}
+
+void spectrogram_data::prefetch(std::size_t level, std::uint64_t first_tile, std::uint64_t count) const noexcept {
+  if (!m_mapping || level >= m_levels.size() || first_tile >= m_levels[level].tile_count) {
+    return;
+  }
+
+  const pyramid_level& l = m_levels[level];
+  const std::size_t row_count = m_options.row_count;
+  const std::size_t page_size = get_page_size();
+  const std::uint64_t last = std::min<std::uint64_t>((first_tile + count) * tile_size, l.column_count);
+
+  const std::uintptr_t begin = reinterpret_cast<std::uintptr_t>(l.data + first_tile * tile_size * row_count);
+  const std::uintptr_t end = reinterpret_cast<std::uintptr_t>(l.data + last * row_count);
+  const std::uintptr_t page_begin = begin / page_size * page_size;
+
+  ::madvise(reinterpret_cast<void*>(page_begin), end - page_begin, MADV_WILLNEED);
+}
+
+void spectrogram_data::release(std::size_t level, std::uint64_t first_tile, std::uint64_t count) const noexcept {
+  if (!m_mapping || level >= m_levels.size() || first_tile >= m_levels[level].tile_count) {
+    return;
+  }
+
+  const pyramid_level& l = m_levels[level];
+  const std::size_t row_count = m_options.row_count;
+  const std::size_t page_size = get_page_size();
+  const std::uint64_t last = std::min<std::uint64_t>((first_tile + count) * tile_size, l.column_count);
+
+  // Only the pages entirely within the tiles, the mapping is shared with the file so nothing is lost.
+  const std::uintptr_t begin = reinterpret_cast<std::uintptr_t>(l.data + first_tile * tile_size * row_count);
+  const std::uintptr_t end = reinterpret_cast<std::uintptr_t>(l.data + last * row_count);
+  const std::uintptr_t page_begin = align_up(begin, page_size);
+  const std::uintptr_t page_end = end / page_size * page_size;
+
+  if (page_end > page_begin) {
+    ::madvise(reinterpret_cast<void*>(page_begin), page_end - page_begin, MADV_DONTNEED);
+  }
+}
+
+//
+// MARK: - spectrogram_tile_cache -
+//
+
+spectrogram_tile_cache::spectrogram_tile_cache(std::size_t capacity)
+    : m_colormap({ nano::color(0x000000FF), nano::color(0x3B0F70FF), nano::color(0x8C2981FF),
+        nano::color(0xDE4968FF), nano::color(0xFE9F6DFF), nano::color(0xFCFDBFFF) })
+    , m_capacity(capacity) {}
+
+void spectrogram_tile_cache::set_data(std::shared_ptr<const spectrogram_data> data) {
+  m_data = std::move(data);
+  update_lookup();
+  clear();
+}
+
+void spectrogram_tile_cache::set_colormap(const std::vector<nano::color>& colors) {
+  m_colormap = colors;
+  update_lookup();
+  clear();
+}
+
+void spectrogram_tile_cache::set_gain(float db) {
+  if (db == m_gain) {
+    return;
+  }
+
+  m_gain = db;
+  update_lookup();
+  clear();
+}
+
+void spectrogram_tile_cache::set_range(float min_db, float max_db) {
+  max_db = std::max(max_db, min_db + 1e-3f);
+  if (min_db == m_min_db && max_db == m_max_db) {
+    return;
+  }
+
+  m_min_db = min_db;
+  m_max_db = max_db;
+  update_lookup();
+  clear();
+}
+
+void spectrogram_tile_cache::update_lookup() {
+  m_lookup.assign(256, 0);
+
+  if (!m_data || m_colormap.empty()) {
+    return;
+  }
+
+  std::vector<std::uint32_t> stops(m_colormap.size());
+  to_pixels(m_colormap.data(), stops.data(), stops.size());
+
+  const float last_stop = static_cast<float>(stops.size() - 1);
+
+  // Every value of a column is one of 256 levels, each gets its color once.
+  for (std::size_t i = 0; i < 256; i++) {
+    const float db = m_data->get_db(static_cast<std::uint8_t>(i)) + m_gain;
+    const float position = std::clamp((db - m_min_db) / (m_max_db - m_min_db), 0.0f, 1.0f) * last_stop;
+    const std::size_t index = std::min(static_cast<std::size_t>(position), stops.size() - 1);
+    const std::size_t next = std::min(index + 1, stops.size() - 1);
+    const std::uint32_t coverage = static_cast<std::uint32_t>((position - static_cast<float>(index)) * 255.0f + 0.5f);
+
+    m_lookup[i] = blend_pixel(stops[index], stops[next], coverage);
+  }
+}
+
+std::shared_ptr<const pixel_buffer> spectrogram_tile_cache::get(std::size_t level, std::uint64_t tile) {
+  if (!m_data || !m_data->is_tile_ready(level, tile)) {
+    return nullptr;
+  }
+
+  const std::uint64_t key = (static_cast<std::uint64_t>(level) << 48) | tile;
+
+  if (auto it = m_index.find(key); it != m_index.end()) {
+    m_stats.hits++;
+    m_entries.splice(m_entries.begin(), m_entries, it->second);
+    return it->second->tile;
+  }
+
+  m_stats.misses++;
+
+  std::shared_ptr<const pixel_buffer> image = render(level, tile);
+  const std::size_t byte_size = image->get_byte_size();
+
+  if (byte_size > m_capacity) {
+    return image;
+  }
+
+  evict(m_capacity - byte_size);
+
+  m_entries.push_front(entry{ key, image });
+  m_index.emplace(key, m_entries.begin());
+  m_byte_size += byte_size;
+  return image;
+}
+
+std::shared_ptr<const pixel_buffer> spectrogram_tile_cache::render(std::size_t level, std::uint64_t tile) {
+  const std::uint64_t first = tile * spectrogram_data::tile_size;
+  const std::uint64_t last
+      = std::min<std::uint64_t>(first + spectrogram_data::tile_size, m_data->get_column_count(level));
+  const int width = static_cast<int>(last - first);
+  const int height = static_cast<int>(m_data->get_options().row_count);
+
+  auto image = std::make_shared<pixel_buffer>(width, height);
+
+  for (int x = 0; x < width; x++) {
+    const std::uint8_t* column = m_data->get_column(level, first + static_cast<std::uint64_t>(x));
+
+    // The lowest frequency is at the bottom.
+    for (int y = 0; y < height; y++) {
+      image->set_pixel(x, height - 1 - y, m_lookup[column[y]]);
+    }
+  }
+
+  // The values are read again only if the colors change.
+  m_data->release(level, tile, 1);
+  m_stats.renders++;
+  return image;
+}
+
+void spectrogram_tile_cache::prefetch(std::size_t level, std::uint64_t first_tile, std::uint64_t count, int direction) {
+  if (!m_data || count == 0) {
+    return;
+  }
+
+  const std::uint64_t tile_count = m_data->get_tile_count(level);
+  const std::int64_t step = direction < 0 ? -1 : 1;
+  std::int64_t tile = static_cast<std::int64_t>(first_tile);
+
+  for (std::uint64_t i = 0; i < count && tile >= 0 && static_cast<std::uint64_t>(tile) < tile_count; i++) {
+    get(level, static_cast<std::uint64_t>(tile));
+    tile += step;
+  }
+
+  // The values of the tiles after are loaded by the system in the meantime.
+  const std::int64_t next = direction < 0 ? tile - static_cast<std::int64_t>(count) + 1 : tile;
+  const std::int64_t first = std::max<std::int64_t>(next, 0);
+  const std::int64_t end = direction < 0 ? tile + 1 : tile + static_cast<std::int64_t>(count);
+
+  if (end > first) {
+    m_data->prefetch(level, static_cast<std::uint64_t>(first), static_cast<std::uint64_t>(end - first));
+  }
+}
+
+void spectrogram_tile_cache::set_capacity(std::size_t capacity) {
+  m_capacity = capacity;
+  evict(capacity);
+}
+
+void spectrogram_tile_cache::clear() {
+  m_entries.clear();
+  m_index.clear();
+  m_byte_size = 0;
+}
+
+spectrogram_tile_cache::stats spectrogram_tile_cache::get_stats() const noexcept {
+  stats s = m_stats;
+  s.entry_count = m_entries.size();
+  s.byte_size = m_byte_size;
+  return s;
+}
+
+void spectrogram_tile_cache::reset_stats() noexcept { m_stats = stats(); }
+
+void spectrogram_tile_cache::evict(std::size_t capacity) {
+  while (m_byte_size > capacity && !m_entries.empty()) {
+    const entry& last = m_entries.back();
+    m_index.erase(last.key);
+    m_byte_size -= last.tile->get_byte_size();
+    m_entries.pop_back();
+    m_stats.evictions++;
+  }
+}
+
+//
+// MARK: - spectrogram_view -
+//
+
+spectrogram_view::spectrogram_view(view* parent, const nano::rect<int>& rect)
+    : view(parent, rect)
+    , m_redraw(this) {}
+
+spectrogram_view::~spectrogram_view() = default;
+
+bool spectrogram_view::open_wav(
+    const std::string& path, const std::string& pyramid_path, const spectrogram_data::options& opts) {
+  auto file = std::make_shared<mapped_audio_file>();
+  if (!file->open_wav(path)) {
+    return false;
+  }
+
+  auto data = std::make_shared<spectrogram_data>(std::move(file), opts);
+  if (!data->build(pyramid_path, m_redraw.get_callback())) {
+    return false;
+  }
+
+  m_data = std::move(data);
+  m_tiles.set_data(m_data);
+  redraw();
+  return true;
+}
+
+void spectrogram_view::set_data(std::shared_ptr<spectrogram_data> data) {
+  m_data = std::move(data);
+  m_tiles.set_data(m_data);
+  redraw();
+}
+
+void spectrogram_view::set_visible_range(double start_frame, double frames_per_point) {
+  frames_per_point = std::max(frames_per_point, 1.0 / 64.0);
+
+  // The scroll direction decides which tiles are prefetched.
+  if (frames_per_point == m_frames_per_point && start_frame != m_start_frame) {
+    m_scroll_direction = start_frame < m_start_frame ? -1 : 1;
+  }
+
+  m_start_frame = start_frame;
+  m_frames_per_point = frames_per_point;
+  redraw();
+}
+
+std::size_t spectrogram_view::get_level() const noexcept {
+  if (!m_data || m_data->get_level_count() == 0) {
+    return 0;
+  }
+
+  // The coarsest level with at least one column per point.
+  const double columns_per_point = m_frames_per_point / static_cast<double>(m_data->get_options().hop_size);
+  const double level = columns_per_point > 1.0 ? std::floor(std::log2(columns_per_point)) : 0.0;
+  return std::min(static_cast<std::size_t>(level), m_data->get_level_count() - 1);
+}
+
+void spectrogram_view::set_colormap(const std::vector<nano::color>& colors) {
+  m_tiles.set_colormap(colors);
+  redraw();
+}
+
+void spectrogram_view::set_gain(float db) {
+  if (db == m_tiles.get_gain()) {
+    return;
+  }
+
+  m_tiles.set_gain(db);
+  redraw();
+}
+
+void spectrogram_view::set_range(float min_db, float max_db) {
+  m_tiles.set_range(min_db, max_db);
+  redraw();
+}
+
+void spectrogram_view::on_draw(nano::graphic_context& gc, const nano::rect<float>& dirty_rect) {
+  gc.set_fill_color(m_background);
+  gc.fill_rect(dirty_rect);
+
+  if (!m_data || m_data->get_level_count() == 0) {
+    return;
+  }
+
+  const std::size_t level = get_level();
+  const std::uint64_t tile_count = m_data->get_tile_count(level);
+  const double tile_frames
+      = static_cast<double>(m_data->get_column_frame_count(level)) * static_cast<double>(spectrogram_data::tile_size);
+  const float height = static_cast<float>(get_frame().height);
+
+  // The tiles under the dirty rect.
+  const double first_frame = m_start_frame + static_cast<double>(dirty_rect.x) * m_frames_per_point;
+  const double last_frame = m_start_frame + static_cast<double>(dirty_rect.x + dirty_rect.width) * m_frames_per_point;
+  const std::int64_t first
+      = std::max<std::int64_t>(static_cast<std::int64_t>(std::floor(first_frame / tile_frames)), 0);
+  const std::int64_t last = std::min<std::int64_t>(
+      static_cast<std::int64_t>(std::ceil(last_frame / tile_frames)), static_cast<std::int64_t>(tile_count));
+
+  if (first >= last) {
+    return;
+  }
+
+  m_data->set_priority(static_cast<std::uint64_t>(first) * spectrogram_data::tile_size << level);
+
+  for (std::int64_t t = first; t < last; t++) {
+    std::shared_ptr<const pixel_buffer> tile = m_tiles.get(level, static_cast<std::uint64_t>(t));
+    if (!tile) {
+      continue;
+    }
+
+    const float x = static_cast<float>((static_cast<double>(t) * tile_frames - m_start_frame) / m_frames_per_point);
+    const float width = static_cast<float>(static_cast<double>(tile->get_width())
+        * static_cast<double>(m_data->get_column_frame_count(level)) / m_frames_per_point);
+    draw_image(gc, tile, tile->get_bounds(), nano::rect<float>(x, 0.0f, width, height));
+  }
+
+  // The next tiles in the scroll direction are rendered now, as part of this draw, so that
+  // the next scroll frame only renders the tiles it uncovers.
+  if (m_scroll_direction < 0) {
+    m_tiles.prefetch(level, static_cast<std::uint64_t>(std::max<std::int64_t>(first - 1, 0)),
+        first > 0 ? m_prefetch_count : 0, -1);
+  }
+  else {
+    m_tiles.prefetch(level, static_cast<std::uint64_t>(last), m_prefetch_count, 1);
+  }
+}
+} // namespace nano.
+
+NANO_CLANG_DIAGNOSTIC_POP()
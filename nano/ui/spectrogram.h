@@ -0,0 +1,348 @@
+/*
+ * Nano Library
+ *
+ * Copyright (C) 2022, Meta-Sonic
+ * All rights reserved.
+ *
+ * Proprietary and confidential.
+ * Any unauthorized copying, alteration, distribution, transmission, performance,
+ * display or other use of this material is strictly prohibited.
+ *
+ * Written by Alexandre Arsenault <alx.arsenault@gmail.com>
+ */
+
+#pragma once
+
+/*!
+ * @file      nano/ui/spectrogram.h
+ * @brief     nano ui spectrogram
+ * @copyright Copyright (C) 2022, Meta-Sonic
+ * @author    Alexandre Arsenault alx.arsenault@gmail.com
+ * @date      Created 16/06/2022
+ */
+
+#include <nano/ui.h>
+#include <nano/ui/audio_file.h>
+#include <nano/ui/pixel_buffer.h>
+#include <nano/ui/redraw_poster.h>
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+NANO_CLANG_DIAGNOSTIC_PUSH()
+NANO_CLANG_DIAGNOSTIC(warning, "-Weverything")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wc++98-compat")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wpadded")
+
+namespace nano {
+
+/// short time fourier transform of an audio file, as a pyramid of levels in a memory mapped file.
+///
+/// @details a column of level 0 holds the power of hop_size frames around its
+///          position, reduced to row_count log spaced rows and quantized to 8
+///          bits from min_db to max_db. the channels are mixed. each level
+///          above keeps the largest value of two columns of the level below,
+///          until a level fits in one tile.
+///
+///          the levels are stored in tiles of tile_size columns. the tiles of
+///          level 0 are computed by worker threads, and a tile of the levels
+///          above as soon as its two tiles below are done. the levels can be
+///          read while they are being built: a tile not computed yet reads as
+///          nullptr. once built, the pages of a tile are only read back when
+///          it is rendered, a file of hours only uses address space.
+///
+///          the pyramid file can be kept next to the audio file and is then
+///          reused instead of being computed again, as long as the audio file
+///          and the options are unchanged.
+class spectrogram_data {
+public:
+  static constexpr std::uint32_t tile_size = 256;
+
+  struct options {
+    /// a power of two, at least 8.
+    std::size_t fft_size = 2048;
+    std::size_t hop_size = 256;
+    std::size_t row_count = 256;
+    float min_frequency = 20.0f;
+    float max_frequency = 20000.0f;
+    /// the levels quantized to 0 and 255.
+    float min_db = -120.0f;
+    float max_db = 0.0f;
+    /// the number of worker threads, 0 for one per core.
+    int thread_count = 0;
+  };
+
+  spectrogram_data(std::shared_ptr<const mapped_audio_file> file, const options& opts);
+
+  spectrogram_data(const spectrogram_data&) = delete;
+  spectrogram_data(spectrogram_data&&) = delete;
+
+  /// stops the workers and unmaps the levels.
+  ~spectrogram_data();
+
+  spectrogram_data& operator=(const spectrogram_data&) = delete;
+  spectrogram_data& operator=(spectrogram_data&&) = delete;
+
+  /// maps the pyramid file and starts the workers, unless the file is complete.
+  ///
+  /// @param path the pyramid file, a temporary file is used when empty.
+  /// @param on_progress called on the worker threads after each tile of level 0 and once done.
+  bool build(const std::string& path = std::string(), std::function<void()> on_progress = nullptr);
+
+  /// blocks until the build is done.
+  void wait();
+
+  inline bool is_ready() const noexcept { return m_ready.load(std::memory_order_acquire); }
+
+  /// returns the ratio of computed tiles.
+  float get_progress() const noexcept;
+
+  /// computes the tiles around a column of level 0 first.
+  inline void set_priority(std::uint64_t column) noexcept {
+    m_priority_tile.store(column / tile_size, std::memory_order_relaxed);
+  }
+
+  inline const options& get_options() const noexcept { return m_options; }
+
+  inline const mapped_audio_file& get_file() const noexcept { return *m_file; }
+
+  inline std::size_t get_level_count() const noexcept { return m_levels.size(); }
+
+  std::uint64_t get_column_count(std::size_t level) const noexcept;
+
+  std::uint64_t get_tile_count(std::size_t level) const noexcept;
+
+  /// returns the number of frames of a column of the level.
+  inline std::uint64_t get_column_frame_count(std::size_t level) const noexcept {
+    return static_cast<std::uint64_t>(m_options.hop_size) << level;
+  }
+
+  bool is_tile_ready(std::size_t level, std::uint64_t tile) const noexcept;
+
+  /// returns the row_count values of a column, from the lowest frequency, or nullptr if not computed yet.
+  const std::uint8_t* get_column(std::size_t level, std::uint64_t column) const noexcept;
+
+  /// returns the level of a value of a column in decibels.
+  inline float get_db(std::uint8_t value) const noexcept {
+    return m_options.min_db + static_cast<float>(value) * (m_options.max_db - m_options.min_db) / 255.0f;
+  }
+
+  /// asks the system to load the pages of computed tiles ahead of their use.
+  void prefetch(std::size_t level, std::uint64_t first_tile, std::uint64_t count) const noexcept;
+
+  /// tells the system that the pages of tiles are not needed anymore, they are read again from the file if needed.
+  void release(std::size_t level, std::uint64_t first_tile, std::uint64_t count) const noexcept;
+
+  /// returns the size of the pyramid file.
+  inline std::size_t get_mapped_size() const noexcept { return m_mapping_size; }
+
+private:
+  struct pyramid_level {
+    std::uint64_t column_count;
+    std::uint64_t tile_count;
+    std::uint8_t* data;
+    /// a tile is computed, with release and acquire semantics.
+    std::unique_ptr<std::atomic<std::uint8_t>[]> ready;
+    /// level 0: a worker took the tile, above: the number of tiles below that are done.
+    std::unique_ptr<std::atomic<std::uint8_t>[]> state;
+  };
+
+  struct bin_range {
+    std::uint32_t first;
+    std::uint32_t last;
+  };
+
+  struct worker_state;
+
+  std::shared_ptr<const mapped_audio_file> m_file;
+  options m_options;
+  std::vector<pyramid_level> m_levels;
+  std::vector<bin_range> m_bin_ranges;
+  std::vector<float> m_window;
+  float m_power_scale = 1.0f;
+
+  void* m_mapping = nullptr;
+  std::size_t m_mapping_size = 0;
+  std::uint64_t m_total_tile_count = 0;
+  std::atomic<std::uint64_t> m_built_tile_count = 0;
+  std::atomic<std::uint64_t> m_next_tile = 0;
+  std::atomic<std::uint64_t> m_priority_tile = 0;
+  std::atomic<bool> m_ready = false;
+  std::atomic<bool> m_cancel = false;
+  std::function<void()> m_on_progress;
+  std::vector<std::thread> m_threads;
+
+  bool map(const std::string& path);
+  void unmap();
+  void run();
+  bool claim_tile(std::uint64_t& tile) noexcept;
+  void compute_tile(worker_state& ws, std::uint64_t tile);
+  void complete_tile(std::size_t level_index, std::uint64_t tile);
+  void reduce_tile(std::size_t level_index, std::uint64_t tile) noexcept;
+  void finish();
+};
+
+/// colormapped tiles of a spectrogram, rendered on demand in a bounded cache.
+///
+/// @details a tile is rendered once from the values of its columns and kept
+///          until it is evicted, or until the colormap, the gain or the range
+///          changes. the pages of the values are released once rendered, the
+///          resident memory depends on the capacity rather than the length of
+///          the file.
+class spectrogram_tile_cache {
+public:
+  struct stats {
+    std::uint64_t hits = 0;
+    std::uint64_t misses = 0;
+    std::uint64_t renders = 0;
+    std::uint64_t evictions = 0;
+    std::size_t entry_count = 0;
+    std::size_t byte_size = 0;
+  };
+
+  static constexpr std::size_t default_capacity = 64 * 1024 * 1024;
+
+  /// @param capacity the maximum size of the rendered tiles in bytes.
+  spectrogram_tile_cache(std::size_t capacity = default_capacity);
+
+  spectrogram_tile_cache(const spectrogram_tile_cache&) = delete;
+  spectrogram_tile_cache(spectrogram_tile_cache&&) = delete;
+
+  ~spectrogram_tile_cache() = default;
+
+  spectrogram_tile_cache& operator=(const spectrogram_tile_cache&) = delete;
+  spectrogram_tile_cache& operator=(spectrogram_tile_cache&&) = delete;
+
+  void set_data(std::shared_ptr<const spectrogram_data> data);
+
+  inline const std::shared_ptr<const spectrogram_data>& get_data() const noexcept { return m_data; }
+
+  /// sets the colors from the bottom to the top of the range, interpolated in between.
+  void set_colormap(const std::vector<nano::color>& colors);
+
+  /// sets the gain in decibels added to the levels.
+  void set_gain(float db);
+
+  inline float get_gain() const noexcept { return m_gain; }
+
+  /// sets the levels mapped to the first and last colors.
+  void set_range(float min_db, float max_db);
+
+  /// returns a tile of tile_size pixels per column by row_count, the highest
+  /// frequency on top, or nullptr if it is not computed yet.
+  /// @details the last tile of a level is narrower. a returned tile stays valid after being evicted.
+  std::shared_ptr<const pixel_buffer> get(std::size_t level, std::uint64_t tile);
+
+  /// renders count tiles ahead of their use and asks the system to load the values of the next count.
+  /// @param direction the order of the tiles from first_tile, 1 or -1.
+  void prefetch(std::size_t level, std::uint64_t first_tile, std::uint64_t count, int direction);
+
+  void set_capacity(std::size_t capacity);
+
+  inline std::size_t get_capacity() const noexcept { return m_capacity; }
+
+  void clear();
+
+  stats get_stats() const noexcept;
+
+  void reset_stats() noexcept;
+
+private:
+  struct entry {
+    std::uint64_t key;
+    std::shared_ptr<const pixel_buffer> tile;
+  };
+
+  using entry_list = std::list<entry>;
+
+  std::shared_ptr<const spectrogram_data> m_data;
+  std::vector<nano::color> m_colormap;
+  std::vector<std::uint32_t> m_lookup;
+  float m_gain = 0.0f;
+  float m_min_db = -100.0f;
+  float m_max_db = 0.0f;
+
+  // Most recently used first.
+  entry_list m_entries;
+  std::unordered_map<std::uint64_t, entry_list::iterator> m_index;
+  std::size_t m_capacity;
+  std::size_t m_byte_size = 0;
+  stats m_stats;
+
+  void update_lookup();
+  std::shared_ptr<const pixel_buffer> render(std::size_t level, std::uint64_t tile);
+  void evict(std::size_t capacity);
+};
+
+/// draws the spectrogram of an audio file, time from left to right and frequency from bottom to top.
+///
+/// @details each frame draws the visible tiles of the level closest to one
+///          column per point from the tile cache, then renders the next tiles
+///          in the scroll direction. a scroll frame only renders the tiles
+///          that come into view, which were most likely prefetched. the view
+///          redraws itself as the tiles are computed.
+class spectrogram_view : public view {
+public:
+  spectrogram_view(view* parent, const nano::rect<int>& rect);
+
+  ~spectrogram_view() override;
+
+  /// maps a wav file and starts computing its spectrogram.
+  /// @param pyramid_path where the levels are kept, a temporary file is used when empty.
+  bool open_wav(const std::string& path, const std::string& pyramid_path = std::string(),
+      const spectrogram_data::options& opts = spectrogram_data::options());
+
+  /// shares the data of another view, it must be built.
+  void set_data(std::shared_ptr<spectrogram_data> data);
+
+  inline const std::shared_ptr<spectrogram_data>& get_data() const noexcept { return m_data; }
+
+  inline spectrogram_tile_cache& get_tile_cache() noexcept { return m_tiles; }
+
+  /// sets the first visible frame and the zoom.
+  void set_visible_range(double start_frame, double frames_per_point);
+
+  /// moves the visible range by a number of points.
+  inline void scroll(float dx) {
+    set_visible_range(m_start_frame + static_cast<double>(dx) * m_frames_per_point, m_frames_per_point);
+  }
+
+  inline double get_start_frame() const noexcept { return m_start_frame; }
+
+  inline double get_frames_per_point() const noexcept { return m_frames_per_point; }
+
+  /// returns the level drawn at the current zoom.
+  std::size_t get_level() const noexcept;
+
+  /// the colormap, gain and range only re-render the tiles when they change.
+  void set_colormap(const std::vector<nano::color>& colors);
+  void set_gain(float db);
+  void set_range(float min_db, float max_db);
+
+  /// sets the number of tiles rendered ahead in the scroll direction.
+  inline void set_prefetch_count(std::uint64_t count) noexcept { m_prefetch_count = count; }
+
+protected:
+  void on_draw(nano::graphic_context& gc, const nano::rect<float>& dirty_rect) override;
+
+private:
+  std::shared_ptr<spectrogram_data> m_data;
+  spectrogram_tile_cache m_tiles;
+  /// redraws as the workers compute the tiles.
+  redraw_poster m_redraw;
+  double m_start_frame = 0;
+  double m_frames_per_point = 256;
+  int m_scroll_direction = 1;
+  std::uint64_t m_prefetch_count = 2;
+  nano::color m_background = nano::color(0x000000FF);
+};
+} // namespace nano.
+
+NANO_CLANG_DIAGNOSTIC_POP()
@@ -0,0 +1,202 @@
+/*
+ * Nano Library
+ *
+ * Copyright (C) 2022, Meta-Sonic
+ * All rights reserved.
+ *
+ * Proprietary and confidential.
+ * Any unauthorized copying, alteration, distribution, transmission, performance,
+ * display or other use of this material is strictly prohibited.
+ *
+ * Written by Alexandre Arsenault <alx.arsenault@gmail.com>
+ */
+
+#include <nano/ui/spectrum.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+NANO_CLANG_DIAGNOSTIC_PUSH()
+NANO_CLANG_DIAGNOSTIC(warning, "-Weverything")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wc++98-compat")
+
+namespace nano {
+
+//
+// MARK: - spectrum_analyzer -
+//
+
+spectrum_analyzer::spectrum_analyzer(const options& opts)
+    : m_options(opts)
+    , m_ring(opts.fft_size * 4, opts.channel_count)
+    , m_fft(opts.fft_size)
+    , m_window(make_hann_window(opts.fft_size)) {
+  const std::size_t fft_size = m_options.fft_size;
+  const std::size_t fft_bin_count = m_fft.get_bin_count();
+  const std::size_t channel_count = static_cast<std::size_t>(m_options.channel_count);
+
+  // A full scale sine reads 0 dB: its amplitude is scaled by the sum of the window over two.
+  double window_sum = 0;
+  for (float w : m_window) {
+    window_sum += static_cast<double>(w);
+  }
+  m_power_scale = static_cast<float>(4.0 / (window_sum * window_sum));
+
+  // Each bin takes the largest power of the fft bins it covers, at least one.
+  const double ratio = static_cast<double>(m_options.max_frequency) / static_cast<double>(m_options.min_frequency);
+  const double hz_per_bin = static_cast<double>(m_options.sample_rate) / static_cast<double>(fft_size);
+  m_bin_ranges.resize(m_options.bin_count);
+
+  for (std::size_t i = 0; i < m_options.bin_count; i++) {
+    const double n = static_cast<double>(m_options.bin_count);
+    const double lo = m_options.min_frequency * std::pow(ratio, static_cast<double>(i) / n) / hz_per_bin;
+    const double hi = m_options.min_frequency * std::pow(ratio, static_cast<double>(i + 1) / n) / hz_per_bin;
+
+    const std::size_t first = std::clamp<std::size_t>(static_cast<std::size_t>(std::lround(lo)), 1, fft_bin_count - 1);
+    const std::size_t last
+        = std::clamp<std::size_t>(static_cast<std::size_t>(std::lround(hi)), first + 1, fft_bin_count);
+    m_bin_ranges[i] = { static_cast<std::uint32_t>(first), static_cast<std::uint32_t>(last) };
+  }
+
+  m_history.resize(fft_size * channel_count, 0.0f);
+  m_windowed.resize(fft_size);
+  m_real.resize(fft_bin_count);
+  m_imag.resize(fft_bin_count);
+  m_power.resize(fft_bin_count);
+  m_levels.resize(m_options.bin_count * channel_count, m_options.floor_db);
+  m_read_pointers.resize(channel_count);
+  m_published.reset(m_levels);
+}
+
+spectrum_analyzer::~spectrum_analyzer() { stop(); }
+
+void spectrum_analyzer::start() { m_worker.start(m_options.refresh_rate, [this]() { update(); }); }
+
+void spectrum_analyzer::stop() { m_worker.stop(); }
+
+bool spectrum_analyzer::update() {
+  const std::size_t fft_size = m_options.fft_size;
+  const std::size_t channel_count = static_cast<std::size_t>(m_options.channel_count);
+
+  std::size_t available = m_ring.get_read_available();
+  if (available == 0) {
+    return false;
+  }
+
+  const std::size_t new_frames = available;
+
+  // Only the last fft_size frames are analyzed.
+  if (available > fft_size) {
+    m_ring.skip(available - fft_size);
+    available = fft_size;
+  }
+
+  // The history slides by the number of new frames, which are read at its end.
+  for (std::size_t c = 0; c < channel_count; c++) {
+    float* history = m_history.data() + c * fft_size;
+    std::memmove(history, history + available, (fft_size - available) * sizeof(float));
+    m_read_pointers[c] = history + fft_size - available;
+  }
+
+  m_ring.read(m_read_pointers.data(), available);
+
+  const float fall = m_options.falloff * static_cast<float>(new_frames) / m_options.sample_rate;
+  std::vector<float>& published = m_published.get_back();
+
+  for (std::size_t c = 0; c < channel_count; c++) {
+    apply_window(m_history.data() + c * fft_size, m_window.data(), m_windowed.data(), fft_size);
+    m_fft.forward(m_windowed.data(), m_real.data(), m_imag.data());
+    get_power(m_real.data(), m_imag.data(), m_power.data(), m_power.size(), m_power_scale);
+
+    float* levels = m_levels.data() + c * m_options.bin_count;
+
+    for (std::size_t i = 0; i < m_options.bin_count; i++) {
+      const bin_range& r = m_bin_ranges[i];
+      const float power = get_max(m_power.data() + r.first, r.last - r.first);
+      const float db = power > 0.0f ? std::max(10.0f * std::log10(power), m_options.floor_db) : m_options.floor_db;
+      levels[i] = std::max(db, levels[i] - fall);
+    }
+  }
+
+  published.assign(m_levels.begin(), m_levels.end());
+  m_published.publish();
+  return true;
+}
+
+bool spectrum_analyzer::poll() noexcept {
+  if (!m_published.update()) {
+    return false;
+  }
+
+  m_frame_index++;
+  return true;
+}
+
+float spectrum_analyzer::get_bin_frequency(std::size_t bin) const noexcept {
+  const double ratio = static_cast<double>(m_options.max_frequency) / static_cast<double>(m_options.min_frequency);
+  const double t = (static_cast<double>(bin) + 0.5) / static_cast<double>(m_options.bin_count);
+  return static_cast<float>(m_options.min_frequency * std::pow(ratio, t));
+}
+
+//
+// MARK: - spectrum_view -
+//
+
+spectrum_view::spectrum_view(view* parent, const nano::rect<int>& rect)
+    : polled_view(parent, rect) {}
+
+void spectrum_view::set_range(float min_db, float max_db) {
+  m_min_db = min_db;
+  m_max_db = std::max(max_db, min_db + 1.0f);
+  redraw();
+}
+
+void spectrum_view::set_colors(const nano::color& background, const std::vector<nano::color>& channel_colors) {
+  m_background = background;
+  m_channel_colors = channel_colors;
+  redraw();
+}
+
+void spectrum_view::on_draw(nano::graphic_context& gc, const nano::rect<float>& dirty_rect) {
+  gc.set_fill_color(m_background);
+  gc.fill_rect(dirty_rect);
+
+  const std::shared_ptr<spectrum_analyzer>& analyzer = get_source();
+  if (!analyzer || m_channel_colors.empty()) {
+    return;
+  }
+
+  set_drawn();
+
+  const spectrum_analyzer::options& opts = analyzer->get_options();
+  const nano::size<int> size = get_frame().size;
+  const float width = static_cast<float>(size.width);
+  const float height = static_cast<float>(size.height);
+  const float bin_width = width / static_cast<float>(opts.bin_count);
+  const float db_scale = height / (m_max_db - m_min_db);
+
+  for (int c = 0; c < opts.channel_count; c++) {
+    const float* bins = analyzer->get_bins(c);
+    gc.set_fill_color(m_channel_colors[static_cast<std::size_t>(c) % m_channel_colors.size()]);
+
+    for (std::size_t i = 0; i < opts.bin_count; i++) {
+      const float x = static_cast<float>(i) * bin_width;
+      if (x + bin_width < dirty_rect.x || x > dirty_rect.x + dirty_rect.width) {
+        continue;
+      }
+
+      const float top = std::clamp((m_max_db - bins[i]) * db_scale, 0.0f, height);
+
+      if (c == 0) {
+        gc.fill_rect(nano::rect<float>(x, top, bin_width, height - top));
+      }
+      else if (top < height) {
+        gc.fill_rect(nano::rect<float>(x, top, bin_width, std::min(2.0f, height - top)));
+      }
+    }
+  }
+}
+} // namespace nano.
+
+NANO_CLANG_DIAGNOSTIC_POP()
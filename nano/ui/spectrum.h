@@ -0,0 +1,168 @@
+/*
+ * Nano Library
+ *
+ * Copyright (C) 2022, Meta-Sonic
+ * All rights reserved.
+ *
+ * Proprietary and confidential.
+ * Any unauthorized copying, alteration, distribution, transmission, performance,
+ * display or other use of this material is strictly prohibited.
+ *
+ * Written by Alexandre Arsenault <alx.arsenault@gmail.com>
+ */
+
+#pragma once
+
+/*!
+ * @file      nano/ui/spectrum.h
+ * @brief     nano ui spectrum analyzer and view
+ * @copyright Copyright (C) 2022, Meta-Sonic
+ * @author    Alexandre Arsenault alx.arsenault@gmail.com
+ * @date      Created 16/06/2022
+ */
+
+#include <nano/ui.h>
+#include <nano/ui/fft.h>
+#include <nano/ui/periodic_worker.h>
+#include <nano/ui/polled_view.h>
+#include <nano/ui/sample_ring.h>
+
+#include <memory>
+#include <vector>
+
+NANO_CLANG_DIAGNOSTIC_PUSH()
+NANO_CLANG_DIAGNOSTIC(warning, "-Weverything")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wc++98-compat")
+
+namespace nano {
+
+/// computes the spectrum of the samples pushed by the audio thread.
+///
+/// @details push() copies the samples into a lock-free ring and returns. a
+///          worker thread drains the ring at the refresh rate, windows the last
+///          fft_size samples of each channel, transforms them and reduces the
+///          power to bin_count log spaced bins in decibels. the bins are
+///          published with a triple buffer, the view only draws them.
+class spectrum_analyzer {
+public:
+  struct options {
+    std::size_t fft_size = 4096;
+    std::size_t bin_count = 256;
+    int channel_count = 2;
+    float sample_rate = 48000.0f;
+    float min_frequency = 20.0f;
+    float max_frequency = 20000.0f;
+    /// updates per second of the worker.
+    float refresh_rate = 60.0f;
+    /// how fast a bin falls, in decibels per second.
+    float falloff = 48.0f;
+    /// the level of empty bins.
+    float floor_db = -120.0f;
+  };
+
+  spectrum_analyzer(const options& opts);
+
+  spectrum_analyzer(const spectrum_analyzer&) = delete;
+  spectrum_analyzer(spectrum_analyzer&&) = delete;
+
+  /// stops the worker.
+  ~spectrum_analyzer();
+
+  spectrum_analyzer& operator=(const spectrum_analyzer&) = delete;
+  spectrum_analyzer& operator=(spectrum_analyzer&&) = delete;
+
+  inline const options& get_options() const noexcept { return m_options; }
+
+  /// copies samples from the audio thread, never blocks.
+  inline void push(const float* const* channels, std::size_t frame_count) noexcept {
+    m_ring.write(channels, frame_count);
+  }
+
+  /// starts the worker thread.
+  void start();
+
+  void stop();
+
+  inline bool is_running() const noexcept { return m_worker.is_running(); }
+
+  /// drains the ring and publishes new bins if samples were pushed.
+  ///
+  /// @details this is called by the worker but can also be called manually
+  ///          (e.g. for testing) while it is not running.
+  /// @returns true if new bins were published.
+  bool update();
+
+  /// takes the latest published bins, from the ui thread.
+  /// @returns true if they changed since the last call.
+  bool poll() noexcept;
+
+  /// returns the bins of a channel taken by the last poll(), in decibels.
+  inline const float* get_bins(int channel) const noexcept {
+    return m_published.get_front().data() + static_cast<std::size_t>(channel) * m_options.bin_count;
+  }
+
+  /// returns the number of bins published, the bins taken by poll() are from this update.
+  inline std::uint64_t get_frame_index() const noexcept { return m_frame_index; }
+
+  /// returns the center frequency of a bin.
+  float get_bin_frequency(std::size_t bin) const noexcept;
+
+private:
+  struct bin_range {
+    std::uint32_t first;
+    std::uint32_t last;
+  };
+
+  options m_options;
+  sample_ring m_ring;
+  real_fft m_fft;
+  std::vector<float> m_window;
+  std::vector<bin_range> m_bin_ranges;
+  float m_power_scale;
+
+  // Worker state.
+  std::vector<float> m_history;
+  std::vector<float> m_windowed;
+  std::vector<float> m_real;
+  std::vector<float> m_imag;
+  std::vector<float> m_power;
+  std::vector<float> m_levels;
+  std::vector<float*> m_read_pointers;
+
+  triple_buffer<std::vector<float>> m_published;
+  std::uint64_t m_frame_index = 0;
+
+  periodic_worker m_worker;
+};
+
+/// draws the bins of a spectrum analyzer on a log frequency axis.
+///
+/// @details a frame timer polls the analyzer and the view redraws only when new
+///          bins were published. the first channel is filled, the others are
+///          drawn as outlines over it.
+class spectrum_view : public polled_view<spectrum_analyzer> {
+public:
+  spectrum_view(view* parent, const nano::rect<int>& rect);
+
+  /// the analyzer can be shared by several views.
+  inline void set_analyzer(std::shared_ptr<spectrum_analyzer> analyzer) { set_source(std::move(analyzer)); }
+
+  inline const std::shared_ptr<spectrum_analyzer>& get_analyzer() const noexcept { return get_source(); }
+
+  /// sets the levels at the bottom and top of the view.
+  void set_range(float min_db, float max_db);
+
+  void set_colors(const nano::color& background, const std::vector<nano::color>& channel_colors);
+
+protected:
+  void on_draw(nano::graphic_context& gc, const nano::rect<float>& dirty_rect) override;
+
+private:
+  float m_min_db = -90.0f;
+  float m_max_db = 0.0f;
+  nano::color m_background = nano::color(0x18191BFF);
+  std::vector<nano::color> m_channel_colors = { nano::color(0x3FA9F5FF), nano::color(0xF5A93FFF) };
+};
+} // namespace nano.
+
+NANO_CLANG_DIAGNOSTIC_POP()
@@ -0,0 +1,252 @@
+/*
+ * Nano Library
+ *
+ * Copyright (C) 2022, Meta-Sonic
+ * All rights reserved.
+ *
+ * Proprietary and confidential.
+ * Any unauthorized copying, alteration, distribution, transmission, performance,
+ * display or other use of this material is strictly prohibited.
+ *
+ * Written by Alexandre Arsenault <alx.arsenault@gmail.com>
+ */
+
+#include <nano/ui/strip_chart.h>
+
+#include <algorithm>
+#include <cmath>
+
+NANO_CLANG_DIAGNOSTIC_PUSH()
+NANO_CLANG_DIAGNOSTIC(warning, "-Weverything")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wc++98-compat")
+
+namespace nano {
+
+//
+// MARK: - strip_chart_history -
+//
+
+strip_chart_history::strip_chart_history(int series_count, std::size_t capacity)
+    : m_capacity(std::max<std::size_t>(capacity, 1))
+    , m_series_count(std::max(series_count, 1)) {
+  m_columns.resize(static_cast<std::size_t>(m_series_count) * m_capacity);
+  m_current.resize(static_cast<std::size_t>(m_series_count));
+}
+
+void strip_chart_history::set_frames_per_column(double frames) {
+  m_frames_per_column = std::max(frames, 1.0);
+  clear();
+}
+
+void strip_chart_history::clear() noexcept {
+  m_column_count = 0;
+  m_frame_position = 0;
+  m_column_end = static_cast<std::uint64_t>(m_frames_per_column);
+  m_current_empty = true;
+}
+
+std::size_t strip_chart_history::append(const float* const* series, std::size_t frame_count) noexcept {
+  std::size_t completed = 0;
+  std::size_t offset = 0;
+
+  while (offset < frame_count) {
+    const std::size_t count
+        = static_cast<std::size_t>(std::min<std::uint64_t>(frame_count - offset, m_column_end - m_frame_position));
+
+    // One pass per series over the frames of the column, the input is planar.
+    for (std::size_t s = 0; s < m_current.size(); s++) {
+      const float* values = series[s] + offset;
+      column& c = m_current[s];
+      float lo = m_current_empty ? values[0] : c.min;
+      float hi = m_current_empty ? values[0] : c.max;
+
+      for (std::size_t i = 0; i < count; i++) {
+        lo = std::min(lo, values[i]);
+        hi = std::max(hi, values[i]);
+      }
+
+      c.min = lo;
+      c.max = hi;
+      c.last = values[count - 1];
+    }
+
+    m_current_empty = false;
+    m_frame_position += count;
+    offset += count;
+
+    if (m_frame_position < m_column_end) {
+      break;
+    }
+
+    const std::size_t index = static_cast<std::size_t>(m_column_count % m_capacity);
+    for (std::size_t s = 0; s < m_current.size(); s++) {
+      m_columns[s * m_capacity + index] = m_current[s];
+    }
+
+    m_column_count++;
+    m_current_empty = true;
+    m_column_end = static_cast<std::uint64_t>(static_cast<double>(m_column_count + 1) * m_frames_per_column);
+    completed++;
+  }
+
+  return completed;
+}
+
+//
+// MARK: - strip_chart_view -
+//
+
+strip_chart_view::strip_chart_view(view* parent, const nano::rect<int>& rect, std::size_t capacity)
+    : view(parent, rect)
+    , m_history(1, capacity) {
+  update_frames_per_column();
+}
+
+strip_chart_view::~strip_chart_view() { timer::stop(); }
+
+void strip_chart_view::set_source(std::shared_ptr<sample_ring> ring, float sample_rate) {
+  m_ring = std::move(ring);
+  m_sample_rate = std::max(sample_rate, 1.0f);
+
+  const int series_count = m_ring ? m_ring->get_channel_count() : 1;
+  m_history = strip_chart_history(series_count, m_history.get_capacity());
+  m_read_buffer.resize(static_cast<std::size_t>(series_count) * read_block_size);
+  m_read_pointers.resize(static_cast<std::size_t>(series_count));
+  for (std::size_t s = 0; s < m_read_pointers.size(); s++) {
+    m_read_pointers[s] = m_read_buffer.data() + s * read_block_size;
+  }
+
+  update_frames_per_column();
+
+  if (m_ring) {
+    timer::start(m_frame_interval);
+  }
+  else {
+    timer::stop();
+  }
+
+  redraw();
+}
+
+void strip_chart_view::set_time_span(float seconds) {
+  m_time_span = std::max(seconds, 1e-3f);
+  update_frames_per_column();
+}
+
+void strip_chart_view::set_range(float min_value, float max_value) {
+  m_min_value = min_value;
+  m_max_value = std::max(max_value, min_value + 1e-6f);
+  redraw();
+}
+
+void strip_chart_view::set_colors(const nano::color& background, const std::vector<nano::color>& series_colors) {
+  m_background = background;
+  m_series_colors = series_colors;
+  redraw();
+}
+
+void strip_chart_view::set_frame_interval(std::uint32_t interval_ms) {
+  m_frame_interval = interval_ms;
+
+  if (m_ring) {
+    timer::start(m_frame_interval);
+  }
+}
+
+void strip_chart_view::update_frames_per_column() {
+  const int width = std::max(get_frame().size.width, 1);
+  const double frames = std::max(static_cast<double>(m_sample_rate) * m_time_span / width, 1.0);
+
+  if (frames != m_history.get_frames_per_column()) {
+    m_history.set_frames_per_column(frames);
+    redraw();
+  }
+}
+
+std::size_t strip_chart_view::update() {
+  if (!m_ring) {
+    return 0;
+  }
+
+  // Only what was available on entry is read, a fast producer can't keep the ui here.
+  std::size_t available = m_ring->get_read_available();
+  std::size_t column_count = 0;
+
+  while (available) {
+    const std::size_t count = m_ring->read(m_read_pointers.data(), std::min(available, read_block_size));
+    if (!count) {
+      break;
+    }
+
+    column_count += m_history.append(m_read_pointers.data(), count);
+    available -= count;
+  }
+
+  if (!column_count) {
+    return 0;
+  }
+
+  // The columns already drawn move left, only the new ones on the right are exposed.
+  const nano::size<int> size = get_frame().size;
+  if (column_count >= static_cast<std::size_t>(size.width)) {
+    redraw();
+  }
+  else {
+    scroll_rect(nano::rect<int>(0, 0, size.width, size.height), nano::point<int>(-static_cast<int>(column_count), 0));
+  }
+
+  return column_count;
+}
+
+void strip_chart_view::on_timer() { update(); }
+
+void strip_chart_view::on_frame_changed() { update_frames_per_column(); }
+
+void strip_chart_view::on_draw(nano::graphic_context& gc, const nano::rect<float>& dirty_rect) {
+  gc.set_fill_color(m_background);
+  gc.fill_rect(dirty_rect);
+
+  if (m_series_colors.empty() || !m_history.get_column_count()) {
+    return;
+  }
+
+  const nano::size<int> size = get_frame().size;
+  const float height = static_cast<float>(size.height);
+  const float scale = height / (m_max_value - m_min_value);
+  const auto get_y = [&](float value) { return std::clamp((m_max_value - value) * scale, 0.0f, height); };
+
+  // The newest column is at the right edge.
+  const int first_x = std::max(static_cast<int>(std::floor(dirty_rect.x)), 0);
+  const int last_x = std::min(static_cast<int>(std::ceil(dirty_rect.x + dirty_rect.width)), size.width);
+  const std::int64_t origin
+      = static_cast<std::int64_t>(m_history.get_column_count()) - static_cast<std::int64_t>(size.width);
+
+  for (int s = 0; s < m_history.get_series_count(); s++) {
+    gc.set_fill_color(m_series_colors[static_cast<std::size_t>(s) % m_series_colors.size()]);
+
+    for (int x = first_x; x < last_x; x++) {
+      const std::int64_t index = origin + x;
+      if (index < 0 || !m_history.contains(static_cast<std::uint64_t>(index))) {
+        continue;
+      }
+
+      const strip_chart_history::column& c = m_history.get_column(s, static_cast<std::uint64_t>(index));
+      float lo = c.min;
+      float hi = c.max;
+
+      // Joined to the column before, so that steps are drawn as lines.
+      if (index > 0 && m_history.contains(static_cast<std::uint64_t>(index - 1))) {
+        const float previous = m_history.get_column(s, static_cast<std::uint64_t>(index - 1)).last;
+        lo = std::min(lo, previous);
+        hi = std::max(hi, previous);
+      }
+
+      const float top = get_y(hi) - 0.5f;
+      const float bottom = get_y(lo) + 0.5f;
+      gc.fill_rect(nano::rect<float>(static_cast<float>(x), top, 1.0f, bottom - top));
+    }
+  }
+}
+} // namespace nano.
+
+NANO_CLANG_DIAGNOSTIC_POP()
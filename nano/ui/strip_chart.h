@@ -0,0 +1,169 @@
+/*
+ * Nano Library
+ *
+ * Copyright (C) 2022, Meta-Sonic
+ * All rights reserved.
+ *
+ * Proprietary and confidential.
+ * Any unauthorized copying, alteration, distribution, transmission, performance,
+ * display or other use of this material is strictly prohibited.
+ *
+ * Written by Alexandre Arsenault <alx.arsenault@gmail.com>
+ */
+
+#pragma once
+
+/*!
+ * @file      nano/ui/strip_chart.h
+ * @brief     nano ui strip chart
+ * @copyright Copyright (C) 2022, Meta-Sonic
+ * @author    Alexandre Arsenault alx.arsenault@gmail.com
+ * @date      Created 16/06/2022
+ */
+
+#include <nano/ui.h>
+#include <nano/ui/sample_ring.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+NANO_CLANG_DIAGNOSTIC_PUSH()
+NANO_CLANG_DIAGNOSTIC(warning, "-Weverything")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wc++98-compat")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wpadded")
+
+namespace nano {
+
+/// the last columns of a strip chart, a fixed-size ring of decimated values.
+///
+/// @details every column holds the min, max and last value of each series over
+///          frames_per_column frames. the values are decimated as they are
+///          appended, the ring never grows and the oldest columns are
+///          overwritten.
+class strip_chart_history {
+public:
+  struct column {
+    float min = 0.0f;
+    float max = 0.0f;
+    float last = 0.0f;
+  };
+
+  strip_chart_history(int series_count, std::size_t capacity);
+
+  inline int get_series_count() const noexcept { return m_series_count; }
+
+  inline std::size_t get_capacity() const noexcept { return m_capacity; }
+
+  /// sets the number of frames decimated into a column, it can be fractional.
+  /// @details the columns are cleared.
+  void set_frames_per_column(double frames);
+
+  inline double get_frames_per_column() const noexcept { return m_frames_per_column; }
+
+  /// decimates planar frames, one array per series.
+  /// @returns the number of columns completed.
+  std::size_t append(const float* const* series, std::size_t frame_count) noexcept;
+
+  /// returns the number of columns completed since the last clear, including the overwritten ones.
+  inline std::uint64_t get_column_count() const noexcept { return m_column_count; }
+
+  /// returns true if a column is still in the ring.
+  inline bool contains(std::uint64_t index) const noexcept {
+    return index < m_column_count && m_column_count - index <= m_capacity;
+  }
+
+  /// returns a column of a series, it must be in the ring.
+  inline const column& get_column(int series, std::uint64_t index) const noexcept {
+    return m_columns[static_cast<std::size_t>(series) * m_capacity + static_cast<std::size_t>(index % m_capacity)];
+  }
+
+  void clear() noexcept;
+
+private:
+  std::vector<column> m_columns;
+  /// the column being decimated, one per series.
+  std::vector<column> m_current;
+  std::size_t m_capacity;
+  int m_series_count;
+  double m_frames_per_column = 1.0;
+  std::uint64_t m_column_count = 0;
+  /// the frames decimated since the last clear.
+  std::uint64_t m_frame_position = 0;
+  /// the frame where the current column ends.
+  std::uint64_t m_column_end = 1;
+  bool m_current_empty = true;
+};
+
+/// plots series of values that scroll from right to left, one column per point.
+///
+/// @details the values are pushed in a sample_ring, from any single thread. a
+///          frame timer drains it into the history and the pixels already
+///          drawn are moved left by the number of new columns with
+///          scroll_rect(), only the newest columns are drawn. each column of a
+///          series is a vertical span from its min to its max, joined to the
+///          last value of the column before.
+class strip_chart_view : public view, private timer {
+public:
+  static constexpr std::size_t default_capacity = 4096;
+
+  strip_chart_view(view* parent, const nano::rect<int>& rect, std::size_t capacity = default_capacity);
+
+  ~strip_chart_view() override;
+
+  /// sets the ring the values are read from, it has one channel per series.
+  void set_source(std::shared_ptr<sample_ring> ring, float sample_rate);
+
+  inline const std::shared_ptr<sample_ring>& get_source() const noexcept { return m_ring; }
+
+  /// sets the time shown across the width of the view, in seconds.
+  /// @details the history is cleared when the columns change.
+  void set_time_span(float seconds);
+
+  inline float get_time_span() const noexcept { return m_time_span; }
+
+  /// sets the values at the bottom and top of the view.
+  void set_range(float min_value, float max_value);
+
+  void set_colors(const nano::color& background, const std::vector<nano::color>& series_colors);
+
+  /// sets the interval of the frame timer in milliseconds (16 by default).
+  void set_frame_interval(std::uint32_t interval_ms);
+
+  /// drains the ring and scrolls by the columns completed.
+  ///
+  /// @details this is called by the frame timer but can also be called
+  ///          manually (e.g. for testing).
+  /// @returns the number of new columns.
+  std::size_t update();
+
+  inline const strip_chart_history& get_history() const noexcept { return m_history; }
+
+protected:
+  void on_draw(nano::graphic_context& gc, const nano::rect<float>& dirty_rect) override;
+
+  void on_frame_changed() override;
+
+private:
+  static constexpr std::size_t read_block_size = 1024;
+
+  strip_chart_history m_history;
+  std::shared_ptr<sample_ring> m_ring;
+  std::vector<float> m_read_buffer;
+  std::vector<float*> m_read_pointers;
+  float m_sample_rate = 1000.0f;
+  float m_time_span = 10.0f;
+  float m_min_value = 0.0f;
+  float m_max_value = 1.0f;
+  std::uint32_t m_frame_interval = 16;
+  nano::color m_background = nano::color(0x18191BFF);
+  std::vector<nano::color> m_series_colors
+      = { nano::color(0x3FBF5FFF), nano::color(0x3FA9F5FF), nano::color(0xF5A93FFF), nano::color(0xE5484DFF) };
+
+  void update_frames_per_column();
+
+  virtual void on_timer() override;
+};
+} // namespace nano.
+
+NANO_CLANG_DIAGNOSTIC_POP()
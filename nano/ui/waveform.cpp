@@ -0,0 +1,689 @@
+/*
+ * Nano Library
+ *
+ * Copyright (C) 2022, Meta-Sonic
+ * All rights reserved.
+ *
+ * Proprietary and confidential.
+ * Any unauthorized copying, alteration, distribution, transmission, performance,
+ * display or other use of this material is strictly prohibited.
+ *
+ * Written by Alexandre Arsenault <alx.arsenault@gmail.com>
+ */
+
+#include <nano/ui/waveform.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+NANO_CLANG_DIAGNOSTIC_PUSH()
+NANO_CLANG_DIAGNOSTIC(warning, "-Weverything")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wc++98-compat")
+
+namespace nano {
+
+namespace {
+  struct reduction {
+    float min;
+    float max;
+    float sum_of_squares;
+  };
+
+  /// min, max and sum of squares of count samples.
+  reduction reduce(const float* samples, std::size_t count) noexcept {
+    if (count == 0) {
+      return { 0.0f, 0.0f, 0.0f };
+    }
+
+    reduction r = { samples[0], samples[0], 0.0f };
+    std::size_t i = 0;
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+    if (count >= 8) {
+      float32x4_t min0 = vld1q_f32(samples);
+      float32x4_t max0 = min0;
+      float32x4_t min1 = min0;
+      float32x4_t max1 = min0;
+      float32x4_t sum0 = vdupq_n_f32(0.0f);
+      float32x4_t sum1 = sum0;
+
+      for (; i + 8 <= count; i += 8) {
+        const float32x4_t a = vld1q_f32(samples + i);
+        const float32x4_t b = vld1q_f32(samples + i + 4);
+        min0 = vminq_f32(min0, a);
+        max0 = vmaxq_f32(max0, a);
+        min1 = vminq_f32(min1, b);
+        max1 = vmaxq_f32(max1, b);
+        sum0 = vmlaq_f32(sum0, a, a);
+        sum1 = vmlaq_f32(sum1, b, b);
+      }
+
+      float mins[4];
+      float maxs[4];
+      float sums[4];
+      vst1q_f32(mins, vminq_f32(min0, min1));
+      vst1q_f32(maxs, vmaxq_f32(max0, max1));
+      vst1q_f32(sums, vaddq_f32(sum0, sum1));
+
+      for (int k = 0; k < 4; k++) {
+        r.min = std::min(r.min, mins[k]);
+        r.max = std::max(r.max, maxs[k]);
+        r.sum_of_squares += sums[k];
+      }
+    }
+#elif defined(__SSE2__) || defined(_M_X64)
+    if (count >= 8) {
+      // Two sets of accumulators to hide the latency of the additions.
+      __m128 min0 = _mm_loadu_ps(samples);
+      __m128 max0 = min0;
+      __m128 min1 = min0;
+      __m128 max1 = min0;
+      __m128 sum0 = _mm_setzero_ps();
+      __m128 sum1 = sum0;
+
+      for (; i + 8 <= count; i += 8) {
+        const __m128 a = _mm_loadu_ps(samples + i);
+        const __m128 b = _mm_loadu_ps(samples + i + 4);
+        min0 = _mm_min_ps(min0, a);
+        max0 = _mm_max_ps(max0, a);
+        min1 = _mm_min_ps(min1, b);
+        max1 = _mm_max_ps(max1, b);
+        sum0 = _mm_add_ps(sum0, _mm_mul_ps(a, a));
+        sum1 = _mm_add_ps(sum1, _mm_mul_ps(b, b));
+      }
+
+      float mins[4];
+      float maxs[4];
+      float sums[4];
+      _mm_storeu_ps(mins, _mm_min_ps(min0, min1));
+      _mm_storeu_ps(maxs, _mm_max_ps(max0, max1));
+      _mm_storeu_ps(sums, _mm_add_ps(sum0, sum1));
+
+      for (int k = 0; k < 4; k++) {
+        r.min = std::min(r.min, mins[k]);
+        r.max = std::max(r.max, maxs[k]);
+        r.sum_of_squares += sums[k];
+      }
+    }
+#endif
+
+    for (; i < count; i++) {
+      r.min = std::min(r.min, samples[i]);
+      r.max = std::max(r.max, samples[i]);
+      r.sum_of_squares += samples[i] * samples[i];
+    }
+
+    return r;
+  }
+
+  /// base blocks summarized between two updates of the levels.
+  constexpr std::uint64_t chunk_block_count = 1024;
+
+  /// chunks summarized between two progress callbacks, 4M frames.
+  constexpr std::uint64_t progress_chunk_count = 16;
+
+  constexpr std::uint32_t sidecar_magic = 0x5346574E; // NWFS.
+  constexpr std::uint32_t sidecar_version = 1;
+
+  struct sidecar_header {
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint64_t file_size;
+    std::int64_t modification_time;
+    std::uint64_t frame_count;
+    std::uint32_t channel_count;
+    std::uint32_t sample_format;
+    std::uint32_t base_block_size;
+    std::uint32_t level_factor;
+    std::uint64_t level_count;
+  };
+
+  sidecar_header make_sidecar_header(const mapped_audio_file& file, std::size_t level_count) noexcept {
+    sidecar_header header;
+    std::memset(&header, 0, sizeof(header));
+    header.magic = sidecar_magic;
+    header.version = sidecar_version;
+    header.file_size = file.get_file_size();
+    header.modification_time = file.get_modification_time();
+    header.frame_count = file.get_frame_count();
+    header.channel_count = static_cast<std::uint32_t>(file.get_format().channel_count);
+    header.sample_format = static_cast<std::uint32_t>(file.get_format().format);
+    header.base_block_size = waveform_summary::base_block_size;
+    header.level_factor = waveform_summary::level_factor;
+    header.level_count = level_count;
+    return header;
+  }
+} // namespace.
+
+//
+// MARK: - waveform_summary -
+//
+
+waveform_summary::waveform_summary(std::shared_ptr<const mapped_audio_file> file)
+    : m_file(std::move(file)) {
+  const std::uint64_t frame_count = m_file->get_frame_count();
+  const std::size_t channel_count = static_cast<std::size_t>(m_file->get_format().channel_count);
+
+  if (frame_count == 0) {
+    return;
+  }
+
+  // Levels are added until one block covers the whole file.
+  std::uint64_t block_size = base_block_size;
+  std::uint64_t block_count = 0;
+
+  do {
+    block_count = (frame_count + block_size - 1) / block_size;
+
+    std::unique_ptr<level> l = std::make_unique<level>();
+    l->peaks.resize(static_cast<std::size_t>(block_count) * channel_count);
+    l->block_count = block_count;
+    l->built_count = 0;
+    m_levels.push_back(std::move(l));
+
+    block_size *= level_factor;
+  } while (block_count > 1);
+}
+
+waveform_summary::~waveform_summary() {
+  m_cancel = true;
+
+  if (m_thread.joinable()) {
+    m_thread.join();
+  }
+}
+
+void waveform_summary::build(const std::string& sidecar_path, std::function<void()> on_progress) {
+  if (m_thread.joinable() || is_ready()) {
+    return;
+  }
+
+  m_thread = std::thread(&waveform_summary::run, this, sidecar_path, std::move(on_progress));
+}
+
+void waveform_summary::wait() {
+  if (m_thread.joinable()) {
+    m_thread.join();
+  }
+}
+
+float waveform_summary::get_progress() const noexcept {
+  if (m_levels.empty()) {
+    return is_ready() ? 1.0f : 0.0f;
+  }
+
+  const level& base = *m_levels.front();
+  return static_cast<float>(static_cast<double>(base.built_count.load(std::memory_order_relaxed))
+      / static_cast<double>(base.block_count));
+}
+
+std::uint64_t waveform_summary::get_block_size(std::size_t level) const noexcept {
+  std::uint64_t block_size = base_block_size;
+  for (std::size_t i = 0; i < level; i++) {
+    block_size *= level_factor;
+  }
+
+  return block_size;
+}
+
+void waveform_summary::run(std::string sidecar_path, std::function<void()> on_progress) {
+  if (!sidecar_path.empty() && load(sidecar_path)) {
+    if (on_progress) {
+      on_progress();
+    }
+    return;
+  }
+
+  if (!m_levels.empty()) {
+    m_file->advise_sequential();
+
+    const std::uint64_t block_count = m_levels.front()->block_count;
+    std::vector<float> buffer(chunk_block_count * base_block_size);
+    std::uint64_t chunk_count = 0;
+
+    for (std::uint64_t first = 0; first < block_count; first += chunk_block_count) {
+      if (m_cancel.load(std::memory_order_relaxed)) {
+        return;
+      }
+
+      summarize_base_blocks(first, std::min(chunk_block_count, block_count - first), buffer);
+
+      for (std::size_t i = 1; i < m_levels.size(); i++) {
+        summarize_level(i, m_levels[i - 1]->built_count.load(std::memory_order_relaxed));
+      }
+
+      if (on_progress && ++chunk_count % progress_chunk_count == 0) {
+        on_progress();
+      }
+    }
+  }
+
+  m_ready.store(true, std::memory_order_release);
+
+  if (!sidecar_path.empty()) {
+    save(sidecar_path);
+  }
+
+  if (on_progress) {
+    on_progress();
+  }
+}
+
+void waveform_summary::summarize_base_blocks(
+    std::uint64_t first_block, std::uint64_t block_count, std::vector<float>& buffer) {
+  level& base = *m_levels.front();
+  const audio_format& format = m_file->get_format();
+  const std::size_t channel_count = static_cast<std::size_t>(format.channel_count);
+  const std::uint64_t first_frame = first_block * base_block_size;
+  const std::size_t frame_count
+      = static_cast<std::size_t>(std::min(block_count * base_block_size, m_file->get_frame_count() - first_frame));
+
+  // Mono float samples are reduced straight from the mapping.
+  const bool is_direct = format.format == sample_format::float32 && channel_count == 1
+      && reinterpret_cast<std::uintptr_t>(m_file->get_frame(first_frame)) % alignof(float) == 0;
+
+  for (std::size_t c = 0; c < channel_count; c++) {
+    const float* samples = nullptr;
+
+    if (is_direct) {
+      samples = reinterpret_cast<const float*>(m_file->get_frame(first_frame));
+    }
+    else {
+      m_file->read_channel(first_frame, frame_count, static_cast<int>(c), buffer.data());
+      samples = buffer.data();
+    }
+
+    for (std::size_t b = 0, offset = 0; offset < frame_count; b++, offset += base_block_size) {
+      const std::size_t n = std::min<std::size_t>(base_block_size, frame_count - offset);
+      const reduction r = reduce(samples + offset, n);
+      base.peaks[static_cast<std::size_t>(first_block + b) * channel_count + c]
+          = { r.min, r.max, r.sum_of_squares / static_cast<float>(n) };
+    }
+  }
+
+  base.built_count.store(first_block + block_count, std::memory_order_release);
+}
+
+void waveform_summary::summarize_level(std::size_t index, std::uint64_t block_count) {
+  level& l = *m_levels[index];
+  const level& child = *m_levels[index - 1];
+  const std::size_t channel_count = static_cast<std::size_t>(m_file->get_format().channel_count);
+
+  std::uint64_t block = l.built_count.load(std::memory_order_relaxed);
+
+  // A block is summarized once all of its children are.
+  for (; block < l.block_count; block++) {
+    const std::uint64_t first = block * level_factor;
+    const std::uint64_t last = std::min<std::uint64_t>(first + level_factor, child.block_count);
+
+    if (last > block_count) {
+      break;
+    }
+
+    for (std::size_t c = 0; c < channel_count; c++) {
+      l.peaks[static_cast<std::size_t>(block) * channel_count + c]
+          = combine(index - 1, static_cast<int>(c), first, last);
+    }
+  }
+
+  l.built_count.store(block, std::memory_order_release);
+}
+
+std::uint64_t waveform_summary::get_block_frame_count(std::size_t level_index, std::uint64_t block) const noexcept {
+  const std::uint64_t block_size = get_block_size(level_index);
+  return std::min(block_size, m_file->get_frame_count() - block * block_size);
+}
+
+waveform_peak waveform_summary::combine(
+    std::size_t level_index, int channel, std::uint64_t first, std::uint64_t last) const {
+  if (first >= last) {
+    return waveform_peak();
+  }
+
+  const level& l = *m_levels[level_index];
+  const std::size_t channel_count = static_cast<std::size_t>(m_file->get_format().channel_count);
+  const waveform_peak* peaks = l.peaks.data() + static_cast<std::size_t>(channel);
+
+  waveform_peak result = peaks[static_cast<std::size_t>(first) * channel_count];
+  double sum_of_squares = 0;
+  std::uint64_t frame_count = 0;
+
+  // The mean squares are weighted by the frame count of each block, only the last block of the file can be shorter.
+  for (std::uint64_t b = first; b < last; b++) {
+    const waveform_peak& p = peaks[static_cast<std::size_t>(b) * channel_count];
+    const std::uint64_t n = get_block_frame_count(level_index, b);
+    result.min = std::min(result.min, p.min);
+    result.max = std::max(result.max, p.max);
+    sum_of_squares += static_cast<double>(p.mean_square) * static_cast<double>(n);
+    frame_count += n;
+  }
+
+  result.mean_square = static_cast<float>(sum_of_squares / static_cast<double>(frame_count));
+  return result;
+}
+
+void waveform_summary::get_columns(
+    int channel, double start_frame, double frames_per_column, std::size_t count, waveform_peak* columns) const {
+  const std::uint64_t frame_count = m_file->get_frame_count();
+  const double end_frame = static_cast<double>(frame_count);
+
+  for (std::size_t i = 0; i < count; i++) {
+    const double a = std::floor(start_frame + static_cast<double>(i) * frames_per_column);
+    const double b = std::floor(start_frame + static_cast<double>(i + 1) * frames_per_column);
+
+    std::uint64_t first = static_cast<std::uint64_t>(std::clamp(a, 0.0, end_frame));
+    std::uint64_t last = std::max(static_cast<std::uint64_t>(std::clamp(b, 0.0, end_frame)), first + 1);
+
+    if (first >= frame_count) {
+      columns[i] = waveform_peak();
+      continue;
+    }
+
+    last = std::min(last, frame_count);
+    const std::uint64_t span = last - first;
+
+    if (span < base_block_size || m_levels.empty()) {
+      columns[i] = get_peak(channel, first, span);
+      continue;
+    }
+
+    // The coarsest level with blocks not larger than the column, at most level_factor whole blocks per column.
+    std::size_t index = 0;
+    while (index + 1 < m_levels.size() && get_block_size(index + 1) <= span) {
+      index++;
+    }
+
+    std::uint64_t summarized = 0;
+    columns[i] = get_range(index, channel, first, last, summarized);
+  }
+}
+
+waveform_peak waveform_summary::get_range(
+    std::size_t level_index, int channel, std::uint64_t first, std::uint64_t last, std::uint64_t& summarized) const {
+  summarized = 0;
+  const std::uint64_t block_size = get_block_size(level_index);
+  const std::uint64_t built_count = m_levels[level_index]->built_count.load(std::memory_order_acquire);
+
+  // Falls back to finer levels while the build has not reached the range, what level 0
+  // has not reached is not summarized.
+  if (level_index > 0 && last > built_count * block_size) {
+    return get_range(level_index - 1, channel, first, last, summarized);
+  }
+
+  if (level_index == 0) {
+    last = std::min(last, built_count * block_size);
+  }
+
+  if (first >= last) {
+    return waveform_peak();
+  }
+
+  // The whole blocks of the level within the range.
+  const std::uint64_t first_block = (first + block_size - 1) / block_size;
+  const std::uint64_t last_block = std::max(last / block_size, first_block);
+  const std::uint64_t inner_first = first_block * block_size;
+  const std::uint64_t inner_last = std::max(last_block * block_size, inner_first);
+
+  waveform_peak result = combine(level_index, channel, first_block, last_block);
+  summarized = inner_last - inner_first;
+
+  // The partial blocks at the edges are read from the finer levels, down to the samples,
+  // so that a peak is only drawn in the column it belongs to.
+  const auto add = [&](std::uint64_t a, std::uint64_t b) {
+    if (a >= b) {
+      return;
+    }
+
+    std::uint64_t n = b - a;
+    const waveform_peak p = level_index == 0 ? get_peak(channel, a, n) : get_range(level_index - 1, channel, a, b, n);
+
+    if (n == 0) {
+      return;
+    }
+
+    if (summarized == 0) {
+      result = p;
+    }
+    else {
+      const double sum_of_squares = static_cast<double>(result.mean_square) * static_cast<double>(summarized)
+          + static_cast<double>(p.mean_square) * static_cast<double>(n);
+      result.min = std::min(result.min, p.min);
+      result.max = std::max(result.max, p.max);
+      result.mean_square = static_cast<float>(sum_of_squares / static_cast<double>(summarized + n));
+    }
+
+    summarized += n;
+  };
+
+  add(first, std::min(inner_first, last));
+  add(inner_last, last);
+  return result;
+}
+
+waveform_peak waveform_summary::get_peak(int channel, std::uint64_t first_frame, std::uint64_t frame_count) const {
+  constexpr std::size_t buffer_size = 1024;
+  float buffer[buffer_size];
+
+  const std::uint64_t file_frame_count = m_file->get_frame_count();
+  if (first_frame >= file_frame_count || frame_count == 0) {
+    return waveform_peak();
+  }
+
+  frame_count = std::min(frame_count, file_frame_count - first_frame);
+
+  waveform_peak result;
+  result.min = std::numeric_limits<float>::max();
+  result.max = std::numeric_limits<float>::lowest();
+  double sum_of_squares = 0;
+
+  for (std::uint64_t offset = 0; offset < frame_count; offset += buffer_size) {
+    const std::size_t n = static_cast<std::size_t>(std::min<std::uint64_t>(buffer_size, frame_count - offset));
+    m_file->read_channel(first_frame + offset, n, channel, buffer);
+
+    const reduction r = reduce(buffer, n);
+    result.min = std::min(result.min, r.min);
+    result.max = std::max(result.max, r.max);
+    sum_of_squares += static_cast<double>(r.sum_of_squares);
+  }
+
+  result.mean_square = static_cast<float>(sum_of_squares / static_cast<double>(frame_count));
+  return result;
+}
+
+bool waveform_summary::save(const std::string& path) const {
+  if (!is_ready()) {
+    return false;
+  }
+
+  // Written next to the destination and renamed, a reader never sees a partial file.
+  const std::string tmp_path = path + ".tmp";
+  std::FILE* file = std::fopen(tmp_path.c_str(), "wb");
+  if (!file) {
+    return false;
+  }
+
+  const sidecar_header header = make_sidecar_header(*m_file, m_levels.size());
+  bool success = std::fwrite(&header, sizeof(header), 1, file) == 1;
+
+  for (const std::unique_ptr<level>& l : m_levels) {
+    if (!success) {
+      break;
+    }
+
+    success = std::fwrite(&l->block_count, sizeof(l->block_count), 1, file) == 1
+        && std::fwrite(l->peaks.data(), sizeof(waveform_peak), l->peaks.size(), file) == l->peaks.size();
+  }
+
+  success = std::fclose(file) == 0 && success;
+
+  if (!success || std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+    std::remove(tmp_path.c_str());
+    return false;
+  }
+
+  return true;
+}
+
+bool waveform_summary::load(const std::string& path) {
+  if (is_ready()) {
+    return false;
+  }
+
+  std::FILE* file = std::fopen(path.c_str(), "rb");
+  if (!file) {
+    return false;
+  }
+
+  const sidecar_header expected = make_sidecar_header(*m_file, m_levels.size());
+  sidecar_header header;
+
+  bool success
+      = std::fread(&header, sizeof(header), 1, file) == 1 && std::memcmp(&header, &expected, sizeof(header)) == 0;
+
+  for (std::size_t i = 0; success && i < m_levels.size(); i++) {
+    level& l = *m_levels[i];
+    std::uint64_t block_count = 0;
+
+    success = std::fread(&block_count, sizeof(block_count), 1, file) == 1 && block_count == l.block_count
+        && std::fread(l.peaks.data(), sizeof(waveform_peak), l.peaks.size(), file) == l.peaks.size();
+  }
+
+  std::fclose(file);
+
+  if (!success) {
+    return false;
+  }
+
+  for (const std::unique_ptr<level>& l : m_levels) {
+    l->built_count.store(l->block_count, std::memory_order_release);
+  }
+
+  m_ready.store(true, std::memory_order_release);
+  return true;
+}
+
+//
+// MARK: - waveform_view -
+//
+
+waveform_view::waveform_view(view* parent, const nano::rect<int>& rect)
+    : view(parent, rect)
+    , m_redraw(this) {}
+
+waveform_view::~waveform_view() = default;
+
+bool waveform_view::open_wav(const std::string& path, const std::string& sidecar_path) {
+  std::shared_ptr<mapped_audio_file> file = std::make_shared<mapped_audio_file>();
+  return file->open_wav(path) && open(std::move(file), sidecar_path);
+}
+
+bool waveform_view::open_raw(const std::string& path, const audio_format& format, const std::string& sidecar_path) {
+  std::shared_ptr<mapped_audio_file> file = std::make_shared<mapped_audio_file>();
+  return file->open_raw(path, format) && open(std::move(file), sidecar_path);
+}
+
+bool waveform_view::open(std::shared_ptr<mapped_audio_file> file, const std::string& sidecar_path) {
+  m_summary = std::make_shared<waveform_summary>(std::move(file));
+  m_summary->build(sidecar_path, m_redraw.get_callback());
+  zoom_to_fit();
+  return true;
+}
+
+void waveform_view::set_summary(std::shared_ptr<waveform_summary> summary) {
+  m_summary = std::move(summary);
+  zoom_to_fit();
+}
+
+void waveform_view::set_visible_range(double start_frame, double frames_per_point) {
+  m_start_frame = start_frame;
+  m_frames_per_point = std::max(frames_per_point, 1.0 / 64.0);
+  redraw();
+}
+
+void waveform_view::zoom(double factor, float x) {
+  if (factor <= 0) {
+    return;
+  }
+
+  // The frame under x stays in place.
+  const double frame = m_start_frame + static_cast<double>(x) * m_frames_per_point;
+  const double frames_per_point = std::max(m_frames_per_point / factor, 1.0 / 64.0);
+  set_visible_range(frame - static_cast<double>(x) * frames_per_point, frames_per_point);
+}
+
+void waveform_view::zoom_to_fit() {
+  const double frame_count = m_summary ? static_cast<double>(m_summary->get_file().get_frame_count()) : 0.0;
+  set_visible_range(0, std::max(frame_count / std::max(get_frame().size.width, 1), 1.0 / 64.0));
+}
+
+void waveform_view::set_colors(const nano::color& background, const nano::color& peak, const nano::color& rms) {
+  m_background = background;
+  m_peak_color = peak;
+  m_rms_color = rms;
+  redraw();
+}
+
+void waveform_view::on_draw(nano::graphic_context& gc, const nano::rect<float>& dirty_rect) {
+  gc.set_fill_color(m_background);
+  gc.fill_rect(dirty_rect);
+
+  if (!m_summary) {
+    return;
+  }
+
+  const nano::size<int> size = get_frame().size;
+  const int channel_count = m_summary->get_file().get_format().channel_count;
+
+  const int x0 = std::max(static_cast<int>(std::floor(dirty_rect.x)), 0);
+  const int x1 = std::min(static_cast<int>(std::ceil(dirty_rect.x + dirty_rect.width)), size.width);
+  if (x1 <= x0 || channel_count <= 0) {
+    return;
+  }
+
+  const std::size_t count = static_cast<std::size_t>(x1 - x0);
+  m_columns.resize(count);
+
+  const float lane_height = static_cast<float>(size.height) / static_cast<float>(channel_count);
+  const float half_height = lane_height * 0.5f;
+
+  // The rms is skipped during a live resize to keep the frames cheap.
+  const bool draw_rms = !is_in_live_resize();
+
+  for (int c = 0; c < channel_count; c++) {
+    m_summary->get_columns(
+        c, m_start_frame + static_cast<double>(x0) * m_frames_per_point, m_frames_per_point, count, m_columns.data());
+
+    const float center = lane_height * static_cast<float>(c) + half_height;
+
+    gc.set_fill_color(m_peak_color);
+    for (std::size_t i = 0; i < count; i++) {
+      const float top = center - std::clamp(m_columns[i].max, -1.0f, 1.0f) * half_height;
+      const float bottom = center - std::clamp(m_columns[i].min, -1.0f, 1.0f) * half_height;
+      const float x = static_cast<float>(x0) + static_cast<float>(i);
+      gc.fill_rect(nano::rect<float>(x, top, 1.0f, std::max(bottom - top, 1.0f)));
+    }
+
+    if (!draw_rms) {
+      continue;
+    }
+
+    gc.set_fill_color(m_rms_color);
+    for (std::size_t i = 0; i < count; i++) {
+      const float rms = std::min(m_columns[i].get_rms(), 1.0f) * half_height;
+      if (rms >= 0.5f) {
+        gc.fill_rect(nano::rect<float>(static_cast<float>(x0) + static_cast<float>(i), center - rms, 1.0f, rms * 2.0f));
+      }
+    }
+  }
+}
+} // namespace nano.
+
+NANO_CLANG_DIAGNOSTIC_POP()
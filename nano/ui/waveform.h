@@ -0,0 +1,201 @@
+/*
+ * Nano Library
+ *
+ * Copyright (C) 2022, Meta-Sonic
+ * All rights reserved.
+ *
+ * Proprietary and confidential.
+ * Any unauthorized copying, alteration, distribution, transmission, performance,
+ * display or other use of this material is strictly prohibited.
+ *
+ * Written by Alexandre Arsenault <alx.arsenault@gmail.com>
+ */
+
+#pragma once
+
+/*!
+ * @file      nano/ui/waveform.h
+ * @brief     nano ui waveform summary and view
+ * @copyright Copyright (C) 2022, Meta-Sonic
+ * @author    Alexandre Arsenault alx.arsenault@gmail.com
+ * @date      Created 16/06/2022
+ */
+
+#include <nano/ui.h>
+#include <nano/ui/audio_file.h>
+#include <nano/ui/redraw_poster.h>
+
+#include <atomic>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+NANO_CLANG_DIAGNOSTIC_PUSH()
+NANO_CLANG_DIAGNOSTIC(warning, "-Weverything")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wc++98-compat")
+
+namespace nano {
+
+/// summary of a range of samples.
+struct waveform_peak {
+  float min = 0.0f;
+  float max = 0.0f;
+  float mean_square = 0.0f;
+
+  inline float get_rms() const noexcept;
+};
+
+/// multi-level min, max and rms summary of an audio file.
+///
+/// @details level 0 summarizes blocks of base_block_size frames and every
+///          level summarizes level_factor blocks of the previous one. the
+///          levels are built on a background thread, in a single pass over
+///          the mapped samples, and can be read while they are being built:
+///          what is not summarized yet reads as silence.
+///
+///          the summary can be saved next to the audio file and is then loaded
+///          instead of being built again, as long as the file is unchanged.
+class waveform_summary {
+public:
+  static constexpr std::uint32_t base_block_size = 256;
+  static constexpr std::uint32_t level_factor = 4;
+
+  waveform_summary(std::shared_ptr<const mapped_audio_file> file);
+
+  waveform_summary(const waveform_summary&) = delete;
+  waveform_summary(waveform_summary&&) = delete;
+
+  /// stops the build.
+  ~waveform_summary();
+
+  waveform_summary& operator=(const waveform_summary&) = delete;
+  waveform_summary& operator=(waveform_summary&&) = delete;
+
+  /// loads the sidecar file if it matches the audio file, otherwise starts the build.
+  ///
+  /// @param sidecar_path where the summary is loaded from and saved to once built, can be empty.
+  /// @param on_progress called on the build thread every few megabytes and once done.
+  void build(const std::string& sidecar_path = std::string(), std::function<void()> on_progress = nullptr);
+
+  /// blocks until the build is done.
+  void wait();
+
+  inline bool is_ready() const noexcept { return m_ready.load(std::memory_order_acquire); }
+
+  /// returns the ratio of summarized frames.
+  float get_progress() const noexcept;
+
+  inline const mapped_audio_file& get_file() const noexcept { return *m_file; }
+
+  inline std::size_t get_level_count() const noexcept { return m_levels.size(); }
+
+  /// returns the number of frames summarized by a block of the level.
+  std::uint64_t get_block_size(std::size_t level) const noexcept;
+
+  /// summarizes count columns of frames_per_column frames, starting at start_frame.
+  ///
+  /// @details each column is read from the coarsest level whose blocks are not
+  ///          larger than a column, or from the samples when zoomed in further.
+  ///          the blocks that straddle the column edges are read from the finer
+  ///          levels and the samples, so every column covers exactly its frames.
+  ///          columns outside of the file or not summarized yet are empty.
+  void get_columns(int channel, double start_frame, double frames_per_column, std::size_t count,
+      waveform_peak* columns) const;
+
+  /// summarizes a range of frames from the samples, without the levels.
+  waveform_peak get_peak(int channel, std::uint64_t first_frame, std::uint64_t frame_count) const;
+
+  bool save(const std::string& path) const;
+
+  /// @returns false if the file is not a summary of the same audio file.
+  bool load(const std::string& path);
+
+private:
+  struct level {
+    /// block * channel_count + channel.
+    std::vector<waveform_peak> peaks;
+    std::uint64_t block_count;
+    std::atomic<std::uint64_t> built_count;
+  };
+
+  std::shared_ptr<const mapped_audio_file> m_file;
+  std::vector<std::unique_ptr<level>> m_levels;
+  std::atomic<bool> m_ready = false;
+  std::atomic<bool> m_cancel = false;
+  std::thread m_thread;
+
+  void run(std::string sidecar_path, std::function<void()> on_progress);
+  void summarize_base_blocks(std::uint64_t first_block, std::uint64_t block_count, std::vector<float>& buffer);
+  void summarize_level(std::size_t index, std::uint64_t block_count);
+  waveform_peak combine(std::size_t level_index, int channel, std::uint64_t first, std::uint64_t last) const;
+
+  /// summarizes the frames [first, last) with the whole blocks of the level and the finer levels at the edges.
+  /// @param summarized the number of frames the build has reached.
+  waveform_peak get_range(
+      std::size_t level_index, int channel, std::uint64_t first, std::uint64_t last, std::uint64_t& summarized) const;
+  std::uint64_t get_block_frame_count(std::size_t level_index, std::uint64_t block) const noexcept;
+};
+
+/// draws the waveform of an audio file, one lane per channel.
+///
+/// @details the file is memory mapped and summarized on a background thread,
+///          the view redraws itself as the summary progresses. drawing reads
+///          one column per point from the summary, its cost does not depend on
+///          the file size or the zoom.
+class waveform_view : public view {
+public:
+  waveform_view(view* parent, const nano::rect<int>& rect);
+
+  ~waveform_view() override;
+
+  /// maps a wav file and starts summarizing it.
+  /// @param sidecar_path where the summary is cached, can be empty.
+  bool open_wav(const std::string& path, const std::string& sidecar_path = std::string());
+
+  /// maps a file of raw samples and starts summarizing it.
+  bool open_raw(const std::string& path, const audio_format& format, const std::string& sidecar_path = std::string());
+
+  /// shares the summary of another view.
+  void set_summary(std::shared_ptr<waveform_summary> summary);
+
+  inline const std::shared_ptr<waveform_summary>& get_summary() const noexcept { return m_summary; }
+
+  /// sets the first visible frame and the zoom.
+  void set_visible_range(double start_frame, double frames_per_point);
+
+  inline double get_start_frame() const noexcept { return m_start_frame; }
+
+  inline double get_frames_per_point() const noexcept { return m_frames_per_point; }
+
+  /// zooms around a position of the view, a factor greater than one zooms in.
+  void zoom(double factor, float x);
+
+  /// zooms out to show the whole file.
+  void zoom_to_fit();
+
+  void set_colors(const nano::color& background, const nano::color& peak, const nano::color& rms);
+
+protected:
+  void on_draw(nano::graphic_context& gc, const nano::rect<float>& dirty_rect) override;
+
+private:
+  std::shared_ptr<waveform_summary> m_summary;
+  std::vector<waveform_peak> m_columns;
+  /// redraws as the build thread makes progress.
+  redraw_poster m_redraw;
+  double m_start_frame = 0;
+  double m_frames_per_point = 1;
+  nano::color m_background = nano::color(0x18191BFF);
+  nano::color m_peak_color = nano::color(0x3FA9F5FF);
+  nano::color m_rms_color = nano::color(0x8FD0FFFF);
+
+  bool open(std::shared_ptr<mapped_audio_file> file, const std::string& sidecar_path);
+};
+
+inline float waveform_peak::get_rms() const noexcept { return std::sqrt(mean_square); }
+} // namespace nano.
+
+NANO_CLANG_DIAGNOSTIC_POP()
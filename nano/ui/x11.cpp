@@ -0,0 +1,424 @@
+/*
+ * Nano Library
+ *
+ * Copyright (C) 2022, Meta-Sonic
+ * All rights reserved.
+ *
+ * Proprietary and confidential.
+ * Any unauthorized copying, alteration, distribution, transmission, performance,
+ * display or other use of this material is strictly prohibited.
+ *
+ * Written by Alexandre Arsenault <alx.arsenault@gmail.com>
+ */
+
+#include <nano/ui/x11.h>
+
+#if defined(__linux__)
+
+#include <nano/ui/color_conversion.h>
+#include <nano/ui/region.h>
+
+#include <chrono>
+#include <cstring>
+#include <sys/epoll.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#include <vector>
+
+#include <X11/Xlib.h>
+#include <X11/Xutil.h>
+#include <X11/extensions/XShm.h>
+
+NANO_CLANG_DIAGNOSTIC_PUSH()
+NANO_CLANG_DIAGNOSTIC(warning, "-Weverything")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wc++98-compat")
+
+namespace nano {
+
+namespace {
+  /// set by trap_errors() while a request that may fail is checked.
+  bool s_error = false;
+
+  int trap_error_handler(Display*, XErrorEvent*) {
+    s_error = true;
+    return 0;
+  }
+
+  /// syncs and returns true if a request made since the handler was set failed.
+  /// @details used on the thread opening the connection, before any window exists.
+  template <class Fct>
+  inline bool trap_errors(Display* display, Fct&& fct) {
+    XSync(display, False);
+    s_error = false;
+    XErrorHandler previous = XSetErrorHandler(trap_error_handler);
+    fct();
+    XSync(display, False);
+    XSetErrorHandler(previous);
+    return s_error;
+  }
+
+  /// attaching a segment fails when the server doesn't share memory with this process (e.g. a remote display).
+  bool probe_shm(Display* display) {
+    if (!XShmQueryExtension(display)) {
+      return false;
+    }
+
+    XShmSegmentInfo info = {};
+    info.shmid = shmget(IPC_PRIVATE, 4096, IPC_CREAT | 0600);
+    if (info.shmid < 0) {
+      return false;
+    }
+
+    info.shmaddr = static_cast<char*>(shmat(info.shmid, nullptr, 0));
+    shmctl(info.shmid, IPC_RMID, nullptr);
+
+    if (info.shmaddr == reinterpret_cast<char*>(-1)) {
+      return false;
+    }
+
+    info.readOnly = False;
+    const bool failed = trap_errors(display, [&]() { XShmAttach(display, &info); });
+
+    if (!failed) {
+      XShmDetach(display, &info);
+      XSync(display, False);
+    }
+
+    shmdt(info.shmaddr);
+    return !failed;
+  }
+
+  class dispatch_message : public message {
+  public:
+    dispatch_message(x11_connection* connection, std::weak_ptr<bool> alive)
+        : m_connection(connection)
+        , m_alive(std::move(alive)) {}
+
+    virtual ~dispatch_message() override = default;
+
+    virtual void call() override {
+      if (!m_alive.expired()) {
+        m_connection->dispatch_events();
+      }
+    }
+
+  private:
+    x11_connection* m_connection;
+    std::weak_ptr<bool> m_alive;
+  };
+
+  inline double get_elapsed_ms(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  }
+} // namespace.
+
+//
+// MARK: - x11_connection -
+//
+
+x11_connection::x11_connection(run_loop& loop, const char* display_name)
+    : m_loop(loop) {
+  // Must be the first Xlib call, the presenter talks to the server from the compositor thread.
+  XInitThreads();
+
+  m_display = XOpenDisplay(display_name);
+  if (!m_display) {
+    return;
+  }
+
+  m_shm = probe_shm(m_display);
+  m_loop.add_source(ConnectionNumber(m_display), EPOLLIN, [this](std::uint32_t) { dispatch_events(); });
+}
+
+x11_connection::~x11_connection() {
+  if (!m_display) {
+    return;
+  }
+
+  m_alive.reset();
+  m_loop.remove_source(ConnectionNumber(m_display));
+  XCloseDisplay(m_display);
+}
+
+x11_connection& x11_connection::get_main() {
+  NANO_CLANG_PUSH_WARNING("-Wexit-time-destructors")
+  static x11_connection connection(run_loop::get_main());
+  NANO_CLANG_POP_WARNING()
+  return connection;
+}
+
+x11_window_id x11_connection::get_root_window() const { return DefaultRootWindow(m_display); }
+
+int x11_connection::get_depth() const { return DefaultDepth(m_display, DefaultScreen(m_display)); }
+
+unsigned long x11_connection::get_atom(const char* name) const { return XInternAtom(m_display, name, False); }
+
+void x11_connection::add_window(x11_window_id window, event_handler handler) {
+  m_handlers[window] = std::make_shared<event_handler>(std::move(handler));
+}
+
+void x11_connection::remove_window(x11_window_id window) { m_handlers.erase(window); }
+
+std::size_t x11_connection::dispatch_events() {
+  m_dispatch_posted = false;
+
+  if (!m_display) {
+    return 0;
+  }
+
+  // XPending() also reads what the socket has and flushes the requests.
+  std::size_t count = 0;
+  while (XPending(m_display) > 0) {
+    XEvent evt;
+    XNextEvent(m_display, &evt);
+    count++;
+
+    const auto it = m_handlers.find(evt.xany.window);
+    if (it == m_handlers.end()) {
+      m_stats.dropped_events++;
+      continue;
+    }
+
+    // Kept alive in case the handler removes its window.
+    std::shared_ptr<event_handler> handler = it->second;
+    (*handler)(evt);
+  }
+
+  m_stats.events += count;
+  return count;
+}
+
+void x11_connection::post_dispatch_events() {
+  if (!m_dispatch_posted.exchange(true)) {
+    m_loop.post(std::make_shared<dispatch_message>(this, m_alive));
+  }
+}
+
+void x11_connection::flush() {
+  if (m_display) {
+    XFlush(m_display);
+  }
+}
+
+void x11_connection::sync() {
+  if (m_display) {
+    XSync(m_display, False);
+  }
+}
+
+//
+// MARK: - x11_presenter -
+//
+
+/// the frame, as the server reads it.
+class x11_presenter::image {
+public:
+  image(Display* display, const nano::size<int>& size, bool shm)
+      : m_display(display)
+      , m_size(size) {
+    const int screen = DefaultScreen(display);
+    Visual* visual = DefaultVisual(display, screen);
+    const unsigned int depth = static_cast<unsigned int>(DefaultDepth(display, screen));
+    const unsigned int width = static_cast<unsigned int>(size.width);
+    const unsigned int height = static_cast<unsigned int>(size.height);
+
+    // Pixels are stored as r, g, b, a bytes, the usual 24 bit visuals read b, g, r, x.
+    if ((depth != 24 && depth != 32) || (visual->red_mask != 0xFF0000 && visual->red_mask != 0xFF)) {
+      return;
+    }
+
+    m_swap_red_blue = visual->red_mask == 0xFF0000;
+
+    if (shm && create_shm(visual, depth, width, height)) {
+      return;
+    }
+
+    m_storage.resize(static_cast<std::size_t>(size.width) * static_cast<std::size_t>(size.height));
+    m_image = XCreateImage(display, visual, depth, ZPixmap, 0, reinterpret_cast<char*>(m_storage.data()), width,
+        height, 32, size.width * 4);
+  }
+
+  ~image() {
+    if (!m_image) {
+      return;
+    }
+
+    if (m_shm) {
+      XShmDetach(m_display, &m_info);
+      XSync(m_display, False);
+      shmdt(m_info.shmaddr);
+    }
+
+    // The data isn't owned by the image.
+    m_image->data = nullptr;
+    XDestroyImage(m_image);
+  }
+
+  image(const image&) = delete;
+  image& operator=(const image&) = delete;
+
+  inline bool is_valid() const noexcept { return m_image && m_image->bits_per_pixel == 32; }
+
+  inline bool is_shm() const noexcept { return m_shm; }
+
+  inline const nano::size<int>& get_size() const noexcept { return m_size; }
+
+  void write(const pixel_buffer& frame, const nano::rect<int>& r) {
+    for (int y = r.y; y < r.y + r.height; y++) {
+      const std::uint32_t* src = frame.row(y) + r.x;
+      std::uint32_t* dst = reinterpret_cast<std::uint32_t*>(m_image->data + y * m_image->bytes_per_line) + r.x;
+
+      if (m_swap_red_blue) {
+        swap_red_blue(src, dst, static_cast<std::size_t>(r.width));
+      }
+      else {
+        std::memcpy(dst, src, static_cast<std::size_t>(r.width) * sizeof(std::uint32_t));
+      }
+    }
+  }
+
+  void put(x11_window_id window, GC gc, const nano::rect<int>& r) {
+    const unsigned int width = static_cast<unsigned int>(r.width);
+    const unsigned int height = static_cast<unsigned int>(r.height);
+
+    if (m_shm) {
+      XShmPutImage(m_display, window, gc, m_image, r.x, r.y, r.x, r.y, width, height, False);
+    }
+    else {
+      XPutImage(m_display, window, gc, m_image, r.x, r.y, r.x, r.y, width, height);
+    }
+  }
+
+private:
+  Display* m_display;
+  nano::size<int> m_size;
+  XImage* m_image = nullptr;
+  XShmSegmentInfo m_info = {};
+  std::vector<std::uint32_t> m_storage;
+  bool m_shm = false;
+  bool m_swap_red_blue = false;
+
+  bool create_shm(Visual* visual, unsigned int depth, unsigned int width, unsigned int height) {
+    m_image = XShmCreateImage(m_display, visual, depth, ZPixmap, nullptr, &m_info, width, height);
+    if (!m_image) {
+      return false;
+    }
+
+    const std::size_t bytes = static_cast<std::size_t>(m_image->bytes_per_line) * height;
+    m_info.shmid = shmget(IPC_PRIVATE, bytes, IPC_CREAT | 0600);
+    m_info.shmaddr = reinterpret_cast<char*>(-1);
+
+    // The segment is freed once both sides detach from it.
+    if (m_info.shmid >= 0) {
+      m_info.shmaddr = static_cast<char*>(shmat(m_info.shmid, nullptr, 0));
+      shmctl(m_info.shmid, IPC_RMID, nullptr);
+    }
+
+    if (m_info.shmaddr == reinterpret_cast<char*>(-1)) {
+      XDestroyImage(m_image);
+      m_image = nullptr;
+      return false;
+    }
+
+    m_image->data = m_info.shmaddr;
+    m_info.readOnly = False;
+    XShmAttach(m_display, &m_info);
+    m_shm = true;
+    return true;
+  }
+};
+
+x11_presenter::x11_presenter(x11_connection& connection, x11_window_id window)
+    : m_connection(connection)
+    , m_window(window) {
+  if (m_connection.is_valid() && m_window) {
+    m_gc = XCreateGC(m_connection.get_display(), m_window, 0, nullptr);
+  }
+}
+
+x11_presenter::~x11_presenter() {
+  std::scoped_lock<std::mutex> lock(m_mutex);
+  m_image.reset();
+
+  if (m_gc) {
+    XFreeGC(m_connection.get_display(), m_gc);
+  }
+}
+
+void x11_presenter::present(const pixel_buffer& frame, const region& damage) {
+  if (!m_gc || frame.empty()) {
+    return;
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  Display* display = m_connection.get_display();
+  std::scoped_lock<std::mutex> lock(m_mutex);
+
+  // Everything is uploaded to a new image.
+  region area = damage;
+  if (!m_image || m_image->get_size() != frame.get_size()) {
+    m_image.reset();
+    m_image = std::make_unique<image>(display, frame.get_size(), m_connection.has_shm());
+    m_stats.allocations++;
+    area = region(frame.get_bounds());
+  }
+
+  if (!m_image->is_valid()) {
+    return;
+  }
+
+  area.clip(frame.get_bounds());
+
+  for (const nano::rect<int>& r : area.get_rects()) {
+    m_image->write(frame, r);
+    m_image->put(m_window, m_gc, r);
+  }
+
+  // The shared image can only be written again once the server has read it.
+  if (m_image->is_shm()) {
+    XSync(display, False);
+  }
+  else {
+    XFlush(display);
+  }
+
+  m_stats.frames++;
+  m_stats.uploaded_pixels += area.get_area();
+  m_stats.last_present_ms = get_elapsed_ms(start);
+
+  // Events read while waiting are left in the Xlib queue.
+  if (XEventsQueued(display, QueuedAlready) > 0) {
+    m_connection.post_dispatch_events();
+  }
+}
+
+void x11_presenter::expose(const nano::rect<int>& rect) {
+  std::scoped_lock<std::mutex> lock(m_mutex);
+
+  if (!m_image || !m_image->is_valid()) {
+    return;
+  }
+
+  const nano::size<int> size = m_image->get_size();
+  const nano::rect<int> r = get_intersection(rect, nano::rect<int>(0, 0, size.width, size.height));
+
+  if (!is_empty(r)) {
+    m_image->put(m_window, m_gc, r);
+    XFlush(m_connection.get_display());
+  }
+}
+
+bool x11_presenter::is_using_shm() const {
+  std::scoped_lock<std::mutex> lock(m_mutex);
+  return m_image ? m_image->is_shm() : m_connection.has_shm();
+}
+
+x11_presenter::stats x11_presenter::get_stats() const {
+  std::scoped_lock<std::mutex> lock(m_mutex);
+  return m_stats;
+}
+} // namespace nano.
+
+NANO_CLANG_DIAGNOSTIC_POP()
+
+#endif
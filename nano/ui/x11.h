@@ -0,0 +1,182 @@
+/*
+ * Nano Library
+ *
+ * Copyright (C) 2022, Meta-Sonic
+ * All rights reserved.
+ *
+ * Proprietary and confidential.
+ * Any unauthorized copying, alteration, distribution, transmission, performance,
+ * display or other use of this material is strictly prohibited.
+ *
+ * Written by Alexandre Arsenault <alx.arsenault@gmail.com>
+ */
+
+#pragma once
+
+/*!
+ * @file      nano/ui/x11.h
+ * @brief     nano ui x11 backend
+ * @copyright Copyright (C) 2022, Meta-Sonic
+ * @author    Alexandre Arsenault alx.arsenault@gmail.com
+ * @date      Created 16/06/2022
+ */
+
+#include <nano/ui.h>
+#include <nano/ui/compositor.h>
+#include <nano/ui/run_loop.h>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+NANO_CLANG_DIAGNOSTIC_PUSH()
+NANO_CLANG_DIAGNOSTIC(warning, "-Weverything")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wc++98-compat")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wpadded")
+
+#if defined(__linux__)
+
+// Xlib types, the header is only included by the implementation (it defines None, Bool, Status...).
+struct _XDisplay;
+struct _XGC;
+union _XEvent;
+
+namespace nano {
+
+/// an x window id.
+using x11_window_id = unsigned long;
+
+/// connection to the x server, its events are read from a run loop.
+///
+/// @details the connection file descriptor is a source of the run loop, the
+///          events are dispatched to the handler of their window on the
+///          thread running the loop. Xlib is initialized for threads so that
+///          x11_presenter can present from the compositor thread.
+class x11_connection {
+public:
+  /// called with every event of a window.
+  using event_handler = std::function<void(_XEvent& evt)>;
+
+  struct stats {
+    std::uint64_t events = 0;
+    /// events received without a handler (e.g. for a destroyed window).
+    std::uint64_t dropped_events = 0;
+  };
+
+  /// connects to the display (e.g. ":99"), the DISPLAY environment variable is used when null.
+  x11_connection(run_loop& loop, const char* display_name = nullptr);
+
+  x11_connection(const x11_connection&) = delete;
+  x11_connection(x11_connection&&) = delete;
+
+  ~x11_connection();
+
+  x11_connection& operator=(const x11_connection&) = delete;
+  x11_connection& operator=(x11_connection&&) = delete;
+
+  /// returns the connection used by windows, opened on the main run loop on first use.
+  static x11_connection& get_main();
+
+  /// returns false when the display could not be opened (e.g. no DISPLAY).
+  inline bool is_valid() const noexcept { return m_display != nullptr; }
+
+  /// returns true when the server supports MIT-SHM and shares memory with this process.
+  inline bool has_shm() const noexcept { return m_shm; }
+
+  inline _XDisplay* get_display() const noexcept { return m_display; }
+
+  inline run_loop& get_run_loop() const noexcept { return m_loop; }
+
+  x11_window_id get_root_window() const;
+
+  int get_depth() const;
+
+  /// returns an atom, created if needed.
+  unsigned long get_atom(const char* name) const;
+
+  void add_window(x11_window_id window, event_handler handler);
+
+  void remove_window(x11_window_id window);
+
+  /// reads and dispatches the events that are ready, without blocking.
+  /// @returns the number of events dispatched.
+  std::size_t dispatch_events();
+
+  /// dispatches the events on the run loop, from any thread.
+  /// @details Xlib may read events from the socket on another thread (e.g.
+  ///          while the presenter waits for the server), the file descriptor
+  ///          is then no longer readable and the loop has to be asked.
+  void post_dispatch_events();
+
+  /// sends the buffered requests.
+  void flush();
+
+  /// sends the buffered requests and waits until the server has processed them.
+  void sync();
+
+  inline const stats& get_stats() const noexcept { return m_stats; }
+
+private:
+  run_loop& m_loop;
+  _XDisplay* m_display = nullptr;
+  bool m_shm = false;
+  std::unordered_map<x11_window_id, std::shared_ptr<event_handler>> m_handlers;
+  stats m_stats;
+  std::atomic<bool> m_dispatch_posted = false;
+  std::shared_ptr<bool> m_alive = std::make_shared<bool>(true);
+};
+
+/// compositor presenter drawing the frames into an x window through MIT-SHM.
+///
+/// @details the frame is kept in a shared memory image that the server reads
+///          from directly. only the damaged rects are converted into it and
+///          put, then the presenter waits for the server before the image
+///          can be written again. when MIT-SHM is unavailable (e.g. a remote
+///          display) the damaged rects are sent with XPutImage instead.
+///
+///          present() is called on the compositor thread, expose() on the
+///          thread of the connection's run loop.
+class x11_presenter : public compositor::presenter {
+public:
+  struct stats {
+    std::uint64_t frames = 0;
+    /// number of pixels converted and sent to the server.
+    std::uint64_t uploaded_pixels = 0;
+    /// number of image (re)allocations, on the first frame and on resize.
+    std::uint64_t allocations = 0;
+    /// time between the start of present() and the server having read the frame.
+    double last_present_ms = 0;
+  };
+
+  x11_presenter(x11_connection& connection, x11_window_id window);
+
+  ~x11_presenter() override;
+
+  void present(const pixel_buffer& frame, const region& damage) override;
+
+  /// puts the area from the last presented frame again, for expose events.
+  void expose(const nano::rect<int>& rect);
+
+  /// returns true when the frames are presented through shared memory.
+  bool is_using_shm() const;
+
+  stats get_stats() const;
+
+private:
+  class image;
+
+  x11_connection& m_connection;
+  x11_window_id m_window;
+  _XGC* m_gc = nullptr;
+
+  mutable std::mutex m_mutex;
+  std::unique_ptr<image> m_image;
+  stats m_stats;
+};
+} // namespace nano.
+
+#endif
+
+NANO_CLANG_DIAGNOSTIC_POP()
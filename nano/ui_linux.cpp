@@ -0,0 +1,207 @@
+/*
+ * Nano Library
+ *
+ * Copyright (C) 2022, Meta-Sonic
+ * All rights reserved.
+ *
+ * Proprietary and confidential.
+ * Any unauthorized copying, alteration, distribution, transmission, performance,
+ * display or other use of this material is strictly prohibited.
+ *
+ * Written by Alexandre Arsenault <alx.arsenault@gmail.com>
+ */
+
+#include <nano/ui.h>
+
+#if defined(__linux__)
+
+#include <nano/ui/run_loop.h>
+
+#include <csignal>
+#include <pthread.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <unistd.h>
+
+NANO_CLANG_DIAGNOSTIC_PUSH()
+NANO_CLANG_DIAGNOSTIC(warning, "-Weverything")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wc++98-compat")
+
+namespace nano {
+
+//
+// MARK: - application -
+//
+
+class application::native {
+public:
+  native(application* app)
+      : m_app(app) {}
+
+  application* m_app;
+  std::vector<std::string> m_args;
+};
+
+application::application() { m_native = std::unique_ptr<native>(new native(this)); }
+
+application::~application() {}
+
+void application::quit() { run_loop::get_main().quit(); }
+
+bool application::watch_fd(int fd, fd_events events, fd_callback callback) {
+  std::uint32_t epoll_events = EPOLLET | EPOLLRDHUP;
+  if ((events & fd_events::readable) != 0) {
+    epoll_events |= EPOLLIN;
+  }
+
+  if ((events & fd_events::writable) != 0) {
+    epoll_events |= EPOLLOUT;
+  }
+
+  return run_loop::get_main().add_source(fd, epoll_events, [fd, callback = std::move(callback)](std::uint32_t ready) {
+    fd_events result = fd_events::none;
+    if (ready & EPOLLIN) {
+      result = result | fd_events::readable;
+    }
+
+    if (ready & EPOLLOUT) {
+      result = result | fd_events::writable;
+    }
+
+    if (ready & (EPOLLHUP | EPOLLRDHUP)) {
+      result = result | fd_events::hang_up;
+    }
+
+    if (ready & EPOLLERR) {
+      result = result | fd_events::error;
+    }
+
+    callback(fd, result);
+  });
+}
+
+bool application::unwatch_fd(int fd) { return run_loop::get_main().remove_source(fd); }
+
+std::string application::get_command_line_arguments() const {
+  const std::vector<std::string>& args = m_native->m_args;
+
+  std::string str;
+  str.reserve(args.size() * 8);
+
+  for (std::size_t i = 0; i < args.size(); i++) {
+    str.append(args[i]);
+    str.push_back(' ');
+  }
+
+  if (!str.empty()) {
+    str.pop_back();
+  }
+
+  return str;
+}
+
+std::vector<std::string> application::get_command_line_arguments_array() const { return m_native->m_args; }
+
+void application::initialize_application(application* app, int argc, const char* argv[]) {
+  std::vector<std::string> args;
+  args.resize(static_cast<std::size_t>(argc));
+
+  for (std::size_t i = 0; i < args.size(); i++) {
+    args[i] = argv[i];
+  }
+
+  app->m_native->m_args = std::move(args);
+  app->prepare();
+}
+
+int application::run() {
+  run_loop& loop = run_loop::get_main();
+
+  // SIGINT and SIGTERM are what the system sends to close the application,
+  // they are read from the loop and go through should_terminate(). They are
+  // only blocked on this thread, threads started before may still take them.
+  sigset_t mask;
+  sigset_t previous_mask;
+  sigemptyset(&mask);
+  sigaddset(&mask, SIGINT);
+  sigaddset(&mask, SIGTERM);
+  pthread_sigmask(SIG_BLOCK, &mask, &previous_mask);
+
+  const int signal_fd = signalfd(-1, &mask, SFD_CLOEXEC | SFD_NONBLOCK);
+  loop.add_source(signal_fd, EPOLLIN, [this, signal_fd](std::uint32_t) {
+    signalfd_siginfo info;
+    while (read(signal_fd, &info, sizeof(info)) == sizeof(info)) {
+      if (should_terminate()) {
+        quit();
+      }
+    }
+  });
+
+  initialise();
+  const int exit_code = loop.run();
+  shutdown();
+
+  if (signal_fd >= 0) {
+    loop.remove_source(signal_fd);
+    close(signal_fd);
+  }
+
+  pthread_sigmask(SIG_SETMASK, &previous_mask, nullptr);
+  return exit_code;
+}
+
+//
+// MARK: - message -
+//
+
+message::~message() {}
+
+void post_message(std::shared_ptr<message> msg) { run_loop::get_main().post(std::move(msg)); }
+
+pump_result pump(std::chrono::microseconds time_budget) { return run_loop::get_main().pump(time_budget); }
+
+//
+// MARK: - timer -
+//
+
+class timer::native {
+public:
+  native(timer* t)
+      : m_timer(t) {}
+
+  ~native() { stop(); }
+
+  void start(std::uint32_t interval_ms) {
+    stop();
+
+    timer* t = m_timer;
+    m_id = run_loop::get_main().add_timer(interval_ms, [t]() { t->on_timer(); });
+  }
+
+  void stop() {
+    if (m_id >= 0) {
+      run_loop::get_main().remove_timer(m_id);
+      m_id = -1;
+    }
+  }
+
+  bool is_running() const { return m_id >= 0; }
+
+  timer* m_timer;
+  int m_id = -1;
+};
+
+timer::timer() { m_native = std::unique_ptr<native>(new native(this)); }
+
+timer::~timer() {}
+
+void timer::start(std::uint32_t interval_ms) { m_native->start(interval_ms); }
+
+void timer::stop() { m_native->stop(); }
+
+bool timer::is_running() const { return m_native->is_running(); }
+} // namespace nano.
+
+NANO_CLANG_DIAGNOSTIC_POP()
+
+#endif
@@ -0,0 +1,1349 @@
+/*
+ * Nano Library
+ *
+ * Copyright (C) 2022, Meta-Sonic
+ * All rights reserved.
+ *
+ * Proprietary and confidential.
+ * Any unauthorized copying, alteration, distribution, transmission, performance,
+ * display or other use of this material is strictly prohibited.
+ *
+ * Written by Alexandre Arsenault <alx.arsenault@gmail.com>
+ */
+
+#include <nano/ui.h>
+
+#if defined(__linux__)
+
+#include <nano/ui/blur.h>
+#include <nano/ui/color_conversion.h>
+#include <nano/ui/compositor.h>
+#include <nano/ui/filmstrip.h>
+#include <nano/ui/headless.h>
+#include <nano/ui/path_cache.h>
+#include <nano/ui/region.h>
+#include <nano/ui/x11.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <X11/Xatom.h>
+#include <X11/Xlib.h>
+#include <X11/Xutil.h>
+#include <png.h>
+
+NANO_CLANG_DIAGNOSTIC_PUSH()
+NANO_CLANG_DIAGNOSTIC(warning, "-Weverything")
+NANO_CLANG_DIAGNOSTIC(ignored, "-Wc++98-compat")
+
+namespace nano {
+
+namespace {
+  constexpr long window_event_mask = ExposureMask | KeyPressMask | KeyReleaseMask | ButtonPressMask
+      | ButtonReleaseMask | PointerMotionMask | EnterWindowMask | LeaveWindowMask | StructureNotifyMask
+      | FocusChangeMask;
+
+  /// maximum time and distance between two clicks of a multiple click.
+  constexpr Time multiple_click_interval = 500;
+  constexpr int multiple_click_distance = 4;
+
+  inline const XEvent& get_xevent(native_event_handle handle) noexcept {
+    return *reinterpret_cast<const XEvent*>(handle);
+  }
+
+  inline native_event_handle to_native_event(XEvent& evt) noexcept {
+    return reinterpret_cast<native_event_handle>(&evt);
+  }
+
+  template <class Handle>
+  inline Handle to_handle(x11_window_id window) noexcept {
+    return reinterpret_cast<Handle>(static_cast<std::uintptr_t>(window));
+  }
+
+  template <class Handle>
+  inline x11_window_id to_window_id(Handle handle) noexcept {
+    return static_cast<x11_window_id>(reinterpret_cast<std::uintptr_t>(handle));
+  }
+
+  inline bool is_wheel_button(unsigned int button) noexcept { return button >= Button4 && button <= 7; }
+
+  inline bool is_modifier_key(const XKeyEvent& evt) noexcept {
+    XKeyEvent key = evt;
+    const KeySym sym = XLookupKeysym(&key, 0);
+    return IsModifierKey(sym);
+  }
+
+  event_type get_event_type_from_xevent(const XEvent& evt) noexcept {
+    switch (evt.type) {
+    case ButtonPress:
+      switch (evt.xbutton.button) {
+      case Button1:
+        return event_type::left_mouse_down;
+      case Button3:
+        return event_type::right_mouse_down;
+      default:
+        return is_wheel_button(evt.xbutton.button) ? event_type::scroll_wheel : event_type::other_mouse_down;
+      }
+
+    case ButtonRelease:
+      switch (evt.xbutton.button) {
+      case Button1:
+        return event_type::left_mouse_up;
+      case Button3:
+        return event_type::right_mouse_up;
+      default:
+        return is_wheel_button(evt.xbutton.button) ? event_type::none : event_type::other_mouse_up;
+      }
+
+    case MotionNotify:
+      if (evt.xmotion.state & Button1Mask) {
+        return event_type::left_mouse_dragged;
+      }
+
+      if (evt.xmotion.state & Button3Mask) {
+        return event_type::right_mouse_dragged;
+      }
+
+      return (evt.xmotion.state & Button2Mask) ? event_type::other_mouse_dragged : event_type::mouse_moved;
+
+    case EnterNotify:
+      return event_type::mouse_entered;
+
+    case LeaveNotify:
+      return event_type::mouse_exited;
+
+    case KeyPress:
+      return is_modifier_key(evt.xkey) ? event_type::key_flags_changed : event_type::key_down;
+
+    case KeyRelease:
+      return is_modifier_key(evt.xkey) ? event_type::key_flags_changed : event_type::key_up;
+
+    default:
+      return event_type::none;
+    }
+  }
+
+  event_modifiers get_event_modifiers(unsigned int state) noexcept {
+    std::uint64_t mods = 0;
+    mods |= (state & Button1Mask) ? static_cast<std::uint64_t>(event_modifiers::left_mouse_down) : 0;
+    mods |= (state & Button2Mask) ? static_cast<std::uint64_t>(event_modifiers::middle_mouse_down) : 0;
+    mods |= (state & Button3Mask) ? static_cast<std::uint64_t>(event_modifiers::right_mouse_down) : 0;
+    mods |= (state & Mod4Mask) ? static_cast<std::uint64_t>(event_modifiers::command) : 0;
+    mods |= (state & ShiftMask) ? static_cast<std::uint64_t>(event_modifiers::shift) : 0;
+    mods |= (state & ControlMask) ? static_cast<std::uint64_t>(event_modifiers::control) : 0;
+    mods |= (state & Mod1Mask) ? static_cast<std::uint64_t>(event_modifiers::alt) : 0;
+    return static_cast<event_modifiers>(mods);
+  }
+
+  /// the state, position (relative to the x window) and time of pointer and key events.
+  struct input_info {
+    unsigned int state = 0;
+    nano::point<int> position = { 0, 0 };
+    nano::point<int> root_position = { 0, 0 };
+    Time time = 0;
+  };
+
+  input_info get_input_info(const XEvent& evt) noexcept {
+    switch (evt.type) {
+    case ButtonPress:
+    case ButtonRelease:
+      return { evt.xbutton.state, { evt.xbutton.x, evt.xbutton.y }, { evt.xbutton.x_root, evt.xbutton.y_root },
+        evt.xbutton.time };
+
+    case MotionNotify:
+      return { evt.xmotion.state, { evt.xmotion.x, evt.xmotion.y }, { evt.xmotion.x_root, evt.xmotion.y_root },
+        evt.xmotion.time };
+
+    case EnterNotify:
+    case LeaveNotify:
+      return { evt.xcrossing.state, { evt.xcrossing.x, evt.xcrossing.y },
+        { evt.xcrossing.x_root, evt.xcrossing.y_root }, evt.xcrossing.time };
+
+    case KeyPress:
+    case KeyRelease:
+      return { evt.xkey.state, { evt.xkey.x, evt.xkey.y }, { evt.xkey.x_root, evt.xkey.y_root }, evt.xkey.time };
+
+    default:
+      return {};
+    }
+  }
+
+  /// a crossing event at the position of a motion event, for the views entered and exited within a window.
+  XEvent make_crossing_event(const XEvent& motion, int type) noexcept {
+    XEvent evt = {};
+    evt.xcrossing.type = type;
+    evt.xcrossing.serial = motion.xmotion.serial;
+    evt.xcrossing.send_event = motion.xmotion.send_event;
+    evt.xcrossing.display = motion.xmotion.display;
+    evt.xcrossing.window = motion.xmotion.window;
+    evt.xcrossing.root = motion.xmotion.root;
+    evt.xcrossing.time = motion.xmotion.time;
+    evt.xcrossing.x = motion.xmotion.x;
+    evt.xcrossing.y = motion.xmotion.y;
+    evt.xcrossing.x_root = motion.xmotion.x_root;
+    evt.xcrossing.y_root = motion.xmotion.y_root;
+    evt.xcrossing.mode = NotifyNormal;
+    evt.xcrossing.detail = NotifyAncestor;
+    evt.xcrossing.same_screen = motion.xmotion.same_screen;
+    evt.xcrossing.state = motion.xmotion.state;
+    return evt;
+  }
+} // namespace.
+
+//
+// MARK: - event -
+//
+
+static nano::point<float> s_click_position = { 0.0f, 0.0f };
+static nano::point<int> s_last_click_position = { 0, 0 };
+static unsigned int s_last_click_button = 0;
+static Time s_last_click_time = 0;
+static std::int64_t s_click_count = 0;
+
+event::event(native_event_handle handle, nano::view* view)
+    : event() {
+  m_native_handle = handle;
+  m_view = view;
+
+  const XEvent& evt = get_xevent(handle);
+  const input_info info = get_input_info(evt);
+  m_type = get_event_type_from_xevent(evt);
+
+  if (evt.type == ButtonPress || evt.type == ButtonRelease || evt.type == MotionNotify || evt.type == EnterNotify
+      || evt.type == LeaveNotify) {
+    m_position = nano::point<float>(info.position - view->get_position_in_window());
+
+    if (m_type == event_type::left_mouse_down || m_type == event_type::right_mouse_down
+        || m_type == event_type::other_mouse_down) {
+      m_click_position = m_position;
+      s_click_position = m_position;
+    }
+    else {
+      m_click_position = s_click_position;
+    }
+  }
+
+  // Wheels are buttons 4 (up), 5 (down), 6 (left) and 7 (right), one step per event.
+  if (m_type == event_type::scroll_wheel) {
+    switch (evt.xbutton.button) {
+    case Button4:
+      m_wheel_delta = { 0.0f, 1.0f };
+      break;
+    case Button5:
+      m_wheel_delta = { 0.0f, -1.0f };
+      break;
+    case 6:
+      m_wheel_delta = { 1.0f, 0.0f };
+      break;
+    default:
+      m_wheel_delta = { -1.0f, 0.0f };
+      break;
+    }
+  }
+
+  // X has no click count, presses of the same button close in time and space are counted here.
+  if (nano::is_click_event(m_type)) {
+    if (evt.type == ButtonPress) {
+      const nano::point<int> delta = info.position - s_last_click_position;
+      const bool is_multiple = evt.xbutton.button == s_last_click_button
+          && info.time - s_last_click_time <= multiple_click_interval && std::abs(delta.x) <= multiple_click_distance
+          && std::abs(delta.y) <= multiple_click_distance;
+
+      s_click_count = is_multiple ? s_click_count + 1 : 1;
+      s_last_click_button = evt.xbutton.button;
+      s_last_click_time = info.time;
+      s_last_click_position = info.position;
+    }
+
+    m_click_count = s_click_count;
+  }
+
+  m_event_modifiers = get_event_modifiers(info.state);
+
+  // The server time is in milliseconds.
+  m_timestamp = static_cast<std::uint64_t>(info.time) * 1000000;
+}
+
+nano::point<float> event::get_screen_position() const noexcept {
+  return nano::point<float>(get_input_info(get_xevent(m_native_handle)).root_position);
+}
+
+const nano::point<float> event::get_window_position() const noexcept {
+  return nano::point<float>(get_input_info(get_xevent(m_native_handle)).position);
+}
+
+native_window_handle event::get_native_window() const noexcept {
+  return to_handle<native_window_handle>(get_xevent(m_native_handle).xany.window);
+}
+
+const nano::point<float> event::get_bounds_position() const noexcept {
+  return m_position - m_view->get_bounds().position;
+}
+
+std::u16string event::get_key() const noexcept {
+  const XEvent& evt = get_xevent(m_native_handle);
+  if (evt.type != KeyPress && evt.type != KeyRelease) {
+    return std::u16string();
+  }
+
+  // XLookupString() gives latin-1 characters.
+  XKeyEvent key = evt.xkey;
+  char buffer[32];
+  const int length = XLookupString(&key, buffer, sizeof(buffer), nullptr, nullptr);
+
+  std::u16string str;
+  for (int i = 0; i < length; i++) {
+    str.push_back(static_cast<char16_t>(static_cast<unsigned char>(buffer[i])));
+  }
+
+  return str;
+}
+
+//
+// MARK: - window -
+//
+
+/// an x window, either top level or embedded in a native window, with a
+/// compositor presenting its view tree.
+class window_object {
+public:
+  window_object(nano::view* view)
+      : m_view(view)
+      , m_connection(x11_connection::get_main()) {}
+
+  ~window_object() {
+    if (!m_window) {
+      return;
+    }
+
+    // The presenter draws into the window until the compositor is gone.
+    m_compositor.reset();
+    m_connection.remove_window(m_window);
+    XDestroyWindow(get_display(), m_window);
+    m_connection.flush();
+  }
+
+  window_object(const window_object&) = delete;
+  window_object& operator=(const window_object&) = delete;
+
+  /// creates the x window, the view must already refer to this object.
+  void create(x11_window_id parent, const nano::rect<int>& frame, bool top_level, window_flags flags) {
+    if (!m_connection.is_valid()) {
+      return;
+    }
+
+    Display* display = get_display();
+    m_top_level = top_level;
+
+    // The server never clears the window, everything is presented from the compositor's frame.
+    XSetWindowAttributes attributes = {};
+    attributes.event_mask = window_event_mask;
+    attributes.background_pixmap = None;
+    attributes.bit_gravity = NorthWestGravity;
+
+    m_window = XCreateWindow(display, parent, frame.x, frame.y, static_cast<unsigned int>(std::max(frame.width, 1)),
+        static_cast<unsigned int>(std::max(frame.height, 1)), 0, CopyFromParent, InputOutput, CopyFromParent,
+        CWEventMask | CWBackPixmap | CWBitGravity, &attributes);
+
+    m_connection.add_window(m_window, [this](XEvent& evt) { handle_event(evt); });
+
+    if (m_top_level) {
+      Atom delete_window = static_cast<Atom>(m_connection.get_atom("WM_DELETE_WINDOW"));
+      XSetWMProtocols(display, m_window, &delete_window, 1);
+      set_flags(flags);
+    }
+
+    // Without a drawing backend nothing is ever presented in the window.
+    if (compositor::can_draw()) {
+      m_compositor = std::make_unique<compositor>(m_view);
+    }
+
+    XMapWindow(display, m_window);
+
+    if (m_top_level) {
+      center();
+    }
+
+    m_connection.flush();
+  }
+
+  inline x11_window_id get_window() const noexcept { return m_window; }
+
+  inline bool is_top_level() const noexcept { return m_top_level; }
+
+  inline compositor* get_compositor() const noexcept { return m_compositor.get(); }
+
+  inline void set_presenter(x11_presenter* p) noexcept { m_presenter = p; }
+
+  native_window_handle get_native_handle() const { return to_handle<native_window_handle>(m_window); }
+
+  void close() {
+    if (!m_window) {
+      return;
+    }
+
+    if (m_delegate) {
+      m_delegate->window_will_close(m_view);
+    }
+
+    XUnmapWindow(get_display(), m_window);
+    m_connection.flush();
+  }
+
+  // Shadows are drawn by the compositing window manager.
+  void set_shadow(bool) {}
+
+  // X has no document edited state.
+  void set_document_edited(bool) {}
+
+  void set_title(std::string_view title) {
+    if (!m_window) {
+      return;
+    }
+
+    const std::string str(title);
+    XStoreName(get_display(), m_window, str.c_str());
+    XChangeProperty(get_display(), m_window, static_cast<Atom>(m_connection.get_atom("_NET_WM_NAME")),
+        static_cast<Atom>(m_connection.get_atom("UTF8_STRING")), 8, PropModeReplace,
+        reinterpret_cast<const unsigned char*>(str.data()), static_cast<int>(str.size()));
+    m_connection.flush();
+  }
+
+  void set_frame(const nano::rect<int>& rect) {
+    if (m_window) {
+      XMoveResizeWindow(get_display(), m_window, rect.x, rect.y, static_cast<unsigned int>(std::max(rect.width, 1)),
+          static_cast<unsigned int>(std::max(rect.height, 1)));
+      m_connection.flush();
+    }
+  }
+
+  /// the frame in screen coordinates.
+  nano::rect<int> get_frame() const {
+    if (!m_window) {
+      return nano::rect<int>(0, 0, 0, 0);
+    }
+
+    XWindowAttributes attributes;
+    XGetWindowAttributes(get_display(), m_window, &attributes);
+
+    int x = 0;
+    int y = 0;
+    Window child;
+    XTranslateCoordinates(get_display(), m_window, m_connection.get_root_window(), 0, 0, &x, &y, &child);
+    return nano::rect<int>(x, y, attributes.width, attributes.height);
+  }
+
+  void center() {
+    if (!m_window) {
+      return;
+    }
+
+    Display* display = get_display();
+    const int screen = DefaultScreen(display);
+    const nano::rect<int> frame = get_frame();
+    XMoveWindow(display, m_window, (DisplayWidth(display, screen) - frame.width) / 2,
+        (DisplayHeight(display, screen) - frame.height) / 2);
+    m_connection.flush();
+  }
+
+  void set_flags(window_flags flags) {
+    if (!m_window || !m_top_level) {
+      return;
+    }
+
+    Display* display = get_display();
+
+    // _MOTIF_WM_HINTS: flags, functions, decorations, input mode, status.
+    constexpr long motif_hints_decorations = 1 << 1;
+    const long hints[5] = { motif_hints_decorations, 0, has_flag(window_flags::titled, flags) ? 1 : 0, 0, 0 };
+    const Atom motif_hints = static_cast<Atom>(m_connection.get_atom("_MOTIF_WM_HINTS"));
+    XChangeProperty(display, m_window, motif_hints, motif_hints, 32, PropModeReplace,
+        reinterpret_cast<const unsigned char*>(hints), 5);
+
+    // A fixed size is a minimum equal to the maximum.
+    XSizeHints* size_hints = XAllocSizeHints();
+    if (!has_flag(window_flags::resizable, flags)) {
+      const nano::size<int> size = m_view->get_frame().size;
+      size_hints->flags = PMinSize | PMaxSize;
+      size_hints->min_width = size_hints->max_width = size.width;
+      size_hints->min_height = size_hints->max_height = size.height;
+    }
+
+    XSetWMNormalHints(display, m_window, size_hints);
+    XFree(size_hints);
+
+    const Atom type = static_cast<Atom>(m_connection.get_atom(
+        has_flag(window_flags::panel, flags) ? "_NET_WM_WINDOW_TYPE_UTILITY" : "_NET_WM_WINDOW_TYPE_NORMAL"));
+    XChangeProperty(display, m_window, static_cast<Atom>(m_connection.get_atom("_NET_WM_WINDOW_TYPE")), XA_ATOM, 32,
+        PropModeReplace, reinterpret_cast<const unsigned char*>(&type), 1);
+
+    m_connection.flush();
+  }
+
+  inline void set_delegate(window_proxy::delegate* d) noexcept { m_delegate = d; }
+
+  /// clears the references to a view that is being destroyed.
+  void forget(view* v) noexcept {
+    m_hovered = m_hovered == v ? nullptr : m_hovered;
+    m_captured = m_captured == v ? nullptr : m_captured;
+  }
+
+private:
+  view* m_view;
+  x11_connection& m_connection;
+  x11_window_id m_window = 0;
+  bool m_top_level = false;
+  std::unique_ptr<compositor> m_compositor;
+  x11_presenter* m_presenter = nullptr;
+  window_proxy::delegate* m_delegate = nullptr;
+
+  /// the view under the pointer, and the one receiving the events while a button is down.
+  view* m_hovered = nullptr;
+  view* m_captured = nullptr;
+
+  inline Display* get_display() const noexcept { return m_connection.get_display(); }
+
+  void handle_event(XEvent& evt);
+  void handle_motion(XEvent& evt);
+};
+
+//
+// MARK: - view -
+//
+
+/// views are not x windows, the tree is drawn by the compositor of the window at its root.
+class view::pimpl {
+public:
+  pimpl(view* v, const nano::rect<int>& rect)
+      : m_view(v)
+      , m_frame(rect) {}
+
+  void init(view* parent) {
+    m_parent = parent;
+    parent->m_pimpl->m_children.push_back(m_view);
+    parent->on_did_add_subview(m_view);
+  }
+
+  void init(window_flags flags) {
+    m_win = std::make_unique<window_object>(m_view);
+    m_win->create(x11_connection::get_main().get_root_window(), m_frame, true, flags);
+  }
+
+  void init(native_view_handle parent) {
+    m_win = std::make_unique<window_object>(m_view);
+    m_win->create(to_window_id(parent), m_frame, false, window_flags::border_less);
+  }
+
+  void initialize() {}
+
+  native_view_handle get_native_handle() const {
+    return m_win ? to_handle<native_view_handle>(m_win->get_window()) : nullptr;
+  }
+
+  void set_hidden(bool hidden) {
+    if (hidden == m_hidden) {
+      return;
+    }
+
+    m_hidden = hidden;
+    redraw_area();
+
+    if (hidden) {
+      m_view->on_hide();
+    }
+    else {
+      m_view->on_show();
+    }
+  }
+
+  void set_opacity(float opacity) {
+    m_opacity = std::clamp(opacity, 0.0f, 1.0f);
+    redraw_area();
+  }
+
+  void set_frame(const nano::rect<int>& rect) {
+    if (rect == m_frame) {
+      return;
+    }
+
+    m_frame = rect;
+
+    // Embedded views follow their frame, top level windows move on their own.
+    if (m_win && !m_win->is_top_level()) {
+      m_win->set_frame(rect);
+    }
+
+    if (compositor* c = find_compositor(); c && c->defer_layout(m_view)) {
+      return;
+    }
+
+    m_view->on_frame_changed();
+  }
+
+  /// the position of the view in the x window at the root of its tree.
+  nano::point<int> get_window_position() const {
+    nano::point<int> pos(0, 0);
+    for (const pimpl* p = this; p->m_parent; p = p->m_parent->m_pimpl.get()) {
+      pos = pos + p->m_frame.position;
+    }
+
+    return pos;
+  }
+
+  nano::point<int> get_screen_position() const {
+    const pimpl& root = get_root();
+    const nano::point<int> pos = get_window_position();
+
+    if (!root.m_win || !root.m_win->get_window()) {
+      return pos;
+    }
+
+    return pos + root.m_win->get_frame().position;
+  }
+
+  nano::rect<int> get_bounds() const { return nano::rect<int>(0, 0, m_frame.width, m_frame.height); }
+
+  /// the bounds clipped by the ancestors.
+  nano::rect<int> get_visible_rect() const {
+    nano::rect<int> visible = get_bounds();
+    nano::point<int> offset(0, 0);
+
+    for (const pimpl* p = this; p->m_parent; p = p->m_parent->m_pimpl.get()) {
+      offset = offset + p->m_frame.position;
+      const nano::size<int> size = p->m_parent->get_frame().size;
+      visible = get_intersection(visible, nano::rect<int>(-offset.x, -offset.y, size.width, size.height));
+    }
+
+    return visible;
+  }
+
+  nano::point<int> convert_from_view(const nano::point<int>& point, nano::view* v) const {
+    const nano::point<int> from = v ? v->m_pimpl->get_window_position() : nano::point<int>(0, 0);
+    return point + from - get_window_position();
+  }
+
+  nano::point<int> convert_to_view(const nano::point<int>& point, nano::view* v) const {
+    const nano::point<int> to = v ? v->m_pimpl->get_window_position() : nano::point<int>(0, 0);
+    return point + get_window_position() - to;
+  }
+
+  void focus() {
+    pimpl& root = get_root();
+    if (root.m_focused == m_view) {
+      return;
+    }
+
+    view* previous = root.m_focused;
+    root.m_focused = m_view;
+
+    if (previous) {
+      previous->on_unfocus();
+    }
+
+    m_view->on_focus();
+  }
+
+  void unfocus() {
+    pimpl& root = get_root();
+    if (root.m_focused == m_view) {
+      root.m_focused = nullptr;
+      m_view->on_unfocus();
+    }
+  }
+
+  bool is_focused() const { return get_root().m_focused == m_view; }
+
+  bool is_in_live_resize() const {
+    const compositor* c = find_compositor();
+    return c && c->is_in_live_resize();
+  }
+
+  /// returns the compositor attached to the root of this view, if any.
+  compositor* find_compositor() const { return get_root().m_compositor; }
+
+  const pimpl& get_root() const {
+    const pimpl* p = this;
+    while (p->m_parent) {
+      p = p->m_parent->m_pimpl.get();
+    }
+
+    return *p;
+  }
+
+  pimpl& get_root() { return const_cast<pimpl&>(static_cast<const pimpl*>(this)->get_root()); }
+
+  /// returns the focused view of the tree, or its root.
+  static view* get_key_view(view* root) {
+    view* focused = root->m_pimpl->m_focused;
+    return focused ? focused : root;
+  }
+
+  /// returns the deepest visible view containing the point (in the view's coordinates).
+  static view* hit_test(view* v, const nano::point<int>& point) {
+    const std::vector<view*>& children = v->m_pimpl->m_children;
+
+    // The last subview is drawn on top.
+    for (auto it = children.rbegin(); it != children.rend(); ++it) {
+      const pimpl& child = *(*it)->m_pimpl;
+      const nano::rect<int>& f = child.m_frame;
+
+      if (!child.m_hidden && point.x >= f.x && point.y >= f.y && point.x < f.x + f.width
+          && point.y < f.y + f.height) {
+        return hit_test(*it, point - f.position);
+      }
+    }
+
+    return v;
+  }
+
+  /// calls the handler of the event type.
+  static void send_event(view* v, XEvent& evt) {
+    const event e(to_native_event(evt), v);
+
+    NANO_CLANG_PUSH_WARNING("-Wswitch-enum")
+    switch (e.get_event_type()) {
+    case event_type::left_mouse_down:
+      v->on_mouse_down(e);
+      break;
+    case event_type::left_mouse_up:
+      v->on_mouse_up(e);
+      break;
+    case event_type::left_mouse_dragged:
+      v->on_mouse_dragged(e);
+      break;
+    case event_type::right_mouse_down:
+      v->on_right_mouse_down(e);
+      break;
+    case event_type::right_mouse_up:
+      v->on_right_mouse_up(e);
+      break;
+    case event_type::right_mouse_dragged:
+      v->on_right_mouse_dragged(e);
+      break;
+    case event_type::other_mouse_down:
+      v->on_other_mouse_down(e);
+      break;
+    case event_type::other_mouse_up:
+      v->on_other_mouse_up(e);
+      break;
+    case event_type::other_mouse_dragged:
+      v->on_other_mouse_dragged(e);
+      break;
+    case event_type::mouse_moved:
+      v->on_mouse_moved(e);
+      break;
+    case event_type::mouse_entered:
+      v->on_mouse_entered(e);
+      break;
+    case event_type::mouse_exited:
+      v->on_mouse_exited(e);
+      break;
+    case event_type::scroll_wheel:
+      v->on_scroll_wheel(e);
+      break;
+    case event_type::key_down:
+      v->on_key_down(e);
+      break;
+    case event_type::key_up:
+      v->on_key_up(e);
+      break;
+    case event_type::key_flags_changed:
+      v->on_key_flags_changed(e);
+      break;
+    default:
+      break;
+    }
+    NANO_CLANG_POP_WARNING()
+  }
+
+  //
+  view* m_view;
+  view* m_parent = nullptr;
+  std::vector<view*> m_children;
+  nano::rect<int> m_frame;
+  float m_opacity = 1.0f;
+  bool m_hidden = false;
+  compositor* m_compositor = nullptr;
+  std::optional<nano::shadow> m_shadow;
+  float m_shadow_corner_radius = 0.0f;
+
+  /// the view receiving the key events, only set on the root.
+  view* m_focused = nullptr;
+
+  /// last, the window's compositor still refers to the members above while it is destroyed.
+  std::unique_ptr<window_object> m_win;
+
+private:
+  /// the area of the view changed without its content (e.g. hidden or transparent).
+  void redraw_area() {
+    compositor* c = find_compositor();
+    if (!c) {
+      return;
+    }
+
+    if (m_parent) {
+      c->invalidate(m_parent, m_frame);
+    }
+    else {
+      c->invalidate(m_view);
+    }
+  }
+};
+
+view::view(window_flags flags) {
+  m_pimpl = std::unique_ptr<pimpl>(new pimpl(this, { 0, 0, 300, 300 }));
+  m_pimpl->init(flags);
+}
+
+view::view(view* parent, const nano::rect<int>& rect) {
+  m_pimpl = std::unique_ptr<pimpl>(new pimpl(this, rect));
+  m_pimpl->init(parent);
+}
+
+view::view(native_view_handle parent, const nano::rect<int>& rect, view_flags flags) {
+  m_pimpl = std::unique_ptr<pimpl>(new pimpl(this, rect));
+  m_pimpl->init(parent);
+  NANO_UNUSED(flags);
+}
+
+view::view(const nano::rect<int>& rect) { m_pimpl = std::unique_ptr<pimpl>(new pimpl(this, rect)); }
+
+view::~view() {
+  // The window and its compositor go first, while the tree is intact.
+  m_pimpl->m_win.reset();
+
+  if (compositor* c = m_pimpl->find_compositor(); c && m_pimpl->m_parent) {
+    c->m_dirty_views.erase(this);
+    c->m_deferred_layouts.erase(this);
+    c->invalidate(m_pimpl->m_parent, get_frame());
+  }
+
+  pimpl& root = m_pimpl->get_root();
+  if (root.m_focused == this) {
+    root.m_focused = nullptr;
+  }
+
+  if (root.m_win) {
+    root.m_win->forget(this);
+  }
+
+  if (!m_pimpl->m_children.empty()) {
+    NANO_ERROR("WRONG");
+  }
+
+  if (m_pimpl->m_parent) {
+    auto& vec = m_pimpl->m_parent->m_pimpl->m_children;
+
+    auto it = std::find(vec.begin(), vec.end(), this);
+    if (it == vec.end()) {
+      NANO_ERROR("WRONG");
+    }
+    else {
+      vec.erase(it);
+    }
+
+    m_pimpl->m_parent->on_did_remove_subview(this);
+  }
+}
+
+void view::initialize() { m_pimpl->initialize(); }
+
+// Embedded views follow their frame, child views have nothing to resize.
+void view::set_auto_resize() {}
+
+native_view_handle view::get_native_handle() const { return m_pimpl->get_native_handle(); }
+
+bool view::is_window() const { return m_pimpl->m_win != nullptr && m_pimpl->m_win->is_top_level(); }
+
+void window_proxy::set_window_frame(const nano::rect<int>& rect) {
+  NANO_ASSERT(m_view.is_window(), "Not a window");
+
+  if (m_view.is_window()) {
+    m_view.m_pimpl->m_win->set_frame(rect);
+  }
+}
+
+native_window_handle window_proxy::get_native_handle() const {
+  return m_view.is_window() ? m_view.m_pimpl->m_win->get_native_handle() : nullptr;
+}
+
+void window_proxy::set_title(std::string_view title) {
+  NANO_ASSERT(m_view.is_window(), "Not a window");
+  if (m_view.is_window()) {
+    m_view.m_pimpl->m_win->set_title(title);
+  }
+}
+
+nano::rect<int> window_proxy::get_frame() const {
+  NANO_ASSERT(m_view.is_window(), "Not a window");
+  return m_view.is_window() ? m_view.m_pimpl->m_win->get_frame() : nano::rect<int>(0, 0, 0, 0);
+}
+
+void window_proxy::set_flags(window_flags flags) {
+  NANO_ASSERT(m_view.is_window(), "Not a window");
+  if (m_view.is_window()) {
+    m_view.m_pimpl->m_win->set_flags(flags);
+  }
+}
+
+void window_proxy::set_document_edited(bool dirty) {
+  NANO_ASSERT(m_view.is_window(), "Not a window");
+  if (m_view.is_window()) {
+    m_view.m_pimpl->m_win->set_document_edited(dirty);
+  }
+}
+
+void window_proxy::close() {
+  NANO_ASSERT(m_view.is_window(), "Not a window");
+  if (m_view.is_window()) {
+    m_view.m_pimpl->m_win->close();
+  }
+}
+
+void window_proxy::center() {
+  NANO_ASSERT(m_view.is_window(), "Not a window");
+  if (m_view.is_window()) {
+    m_view.m_pimpl->m_win->center();
+  }
+}
+
+void window_proxy::set_shadow(bool visible) {
+  NANO_ASSERT(m_view.is_window(), "Not a window");
+  if (m_view.is_window()) {
+    m_view.m_pimpl->m_win->set_shadow(visible);
+  }
+}
+
+void window_proxy::set_window_delegate(delegate* d) {
+  NANO_ASSERT(m_view.is_window(), "Not a window");
+  if (m_view.is_window()) {
+    m_view.m_pimpl->m_win->set_delegate(d);
+  }
+}
+
+nano::rect<int> view::get_frame() const { return m_pimpl->m_frame; }
+
+nano::point<int> view::get_position_in_window() const { return m_pimpl->get_window_position(); }
+
+nano::point<int> view::get_position_in_screen() const { return m_pimpl->get_screen_position(); }
+
+void view::set_frame(const nano::rect<int>& rect) { m_pimpl->set_frame(rect); }
+
+void view::set_frame_position(const nano::point<int>& pos) {
+  m_pimpl->set_frame(nano::rect<int>(pos, m_pimpl->m_frame.size));
+}
+
+void view::set_frame_size(const nano::size<int>& size) {
+  m_pimpl->set_frame(nano::rect<int>(m_pimpl->m_frame.position, size));
+}
+
+nano::rect<int> view::get_bounds() const { return m_pimpl->get_bounds(); }
+
+nano::rect<int> view::get_visible_rect() const { return m_pimpl->get_visible_rect(); }
+
+nano::point<int> view::convert_from_view(const nano::point<int>& point, nano::view* view) const {
+  return m_pimpl->convert_from_view(point, view);
+}
+
+nano::point<int> view::convert_to_view(const nano::point<int>& point, nano::view* view) const {
+  return m_pimpl->convert_to_view(point, view);
+}
+
+void view::set_hidden(bool hidden) { m_pimpl->set_hidden(hidden); }
+
+bool view::is_hidden() const { return m_pimpl->m_hidden; }
+
+void view::set_opacity(float opacity) { m_pimpl->set_opacity(opacity); }
+
+float view::get_opacity() const { return m_pimpl->m_opacity; }
+
+void view::set_shadow(const nano::shadow& s, float corner_radius) {
+  m_pimpl->m_shadow = s;
+  m_pimpl->m_shadow_corner_radius = corner_radius;
+
+  if (view* parent = get_parent()) {
+    parent->redraw();
+  }
+}
+
+void view::remove_shadow() {
+  m_pimpl->m_shadow.reset();
+
+  if (view* parent = get_parent()) {
+    parent->redraw();
+  }
+}
+
+bool view::has_shadow() const { return m_pimpl->m_shadow.has_value(); }
+
+void view::focus() { m_pimpl->focus(); }
+
+void view::unfocus() { m_pimpl->unfocus(); }
+
+bool view::is_focused() const { return m_pimpl->is_focused(); }
+
+// The compositor records the whole view.
+bool view::is_dirty_rect(const nano::rect<int>& rect) const {
+  NANO_UNUSED(rect);
+  return true;
+}
+
+// Without a compositor there is nothing to draw into.
+void view::redraw() {
+  if (compositor* c = m_pimpl->find_compositor()) {
+    c->invalidate(this);
+  }
+}
+
+void view::redraw(const nano::rect<int>& rect) {
+  if (compositor* c = m_pimpl->find_compositor()) {
+    c->invalidate(this, rect);
+  }
+}
+
+void view::scroll_rect(const nano::rect<int>& rect, const nano::point<int>& delta) {
+  if (compositor* c = m_pimpl->find_compositor()) {
+    c->scroll(this, rect, delta);
+  }
+}
+
+bool view::is_in_live_resize() const { return m_pimpl->is_in_live_resize(); }
+
+view* view::get_parent() const { return m_pimpl->m_parent; }
+
+const std::vector<view*>& view::get_children() const { return m_pimpl->m_children; }
+
+nano::rect<int> get_native_view_bounds(nano::native_view_handle native_view) {
+  x11_connection& connection = x11_connection::get_main();
+  if (!connection.is_valid() || !native_view) {
+    return nano::rect<int>(0, 0, 0, 0);
+  }
+
+  Window root;
+  int x = 0;
+  int y = 0;
+  unsigned int width = 0;
+  unsigned int height = 0;
+  unsigned int border = 0;
+  unsigned int depth = 0;
+  XGetGeometry(connection.get_display(), to_window_id(native_view), &root, &x, &y, &width, &height, &border, &depth);
+  return nano::rect<int>(0, 0, static_cast<int>(width), static_cast<int>(height));
+}
+
+//
+//
+//
+//
+//
+
+window::window(window_flags flags)
+    : view(flags)
+    , window_proxy(get_window_proxy()) {}
+
+window::~window() {}
+
+//
+// MARK: - window events -
+//
+
+void window_object::handle_event(XEvent& evt) {
+  switch (evt.type) {
+  case Expose:
+    // The last frame is still in the presenter's image.
+    if (m_presenter) {
+      m_presenter->expose(
+          nano::rect<int>(evt.xexpose.x, evt.xexpose.y, evt.xexpose.width, evt.xexpose.height));
+    }
+    break;
+
+  case ConfigureNotify:
+    // Also sent when the window only moves.
+    if (const nano::size<int> size(evt.xconfigure.width, evt.xconfigure.height);
+        m_top_level && size != m_view->get_frame().size) {
+      m_view->set_frame_size(size);
+      m_view->redraw();
+    }
+    break;
+
+  case ClientMessage:
+    if (static_cast<unsigned long>(evt.xclient.data.l[0]) == m_connection.get_atom("WM_DELETE_WINDOW")) {
+      if (!m_delegate || m_delegate->window_should_close(m_view)) {
+        close();
+      }
+    }
+    break;
+
+  case FocusIn:
+    if (m_delegate) {
+      m_delegate->window_did_become_key(m_view);
+    }
+    break;
+
+  case FocusOut:
+    if (m_delegate) {
+      m_delegate->window_did_resign_key(m_view);
+    }
+    break;
+
+  case ButtonPress: {
+    view* target = m_captured ? m_captured : view::pimpl::hit_test(m_view, { evt.xbutton.x, evt.xbutton.y });
+
+    // Wheel buttons don't capture the pointer.
+    if (!is_wheel_button(evt.xbutton.button)) {
+      m_captured = target;
+    }
+
+    view::pimpl::send_event(target, evt);
+    break;
+  }
+
+  case ButtonRelease: {
+    if (is_wheel_button(evt.xbutton.button)) {
+      break;
+    }
+
+    view* target = m_captured ? m_captured : view::pimpl::hit_test(m_view, { evt.xbutton.x, evt.xbutton.y });
+
+    // The state is the one before the release.
+    const unsigned int buttons = evt.xbutton.state & (Button1Mask | Button2Mask | Button3Mask);
+    const unsigned int released = Button1Mask << (evt.xbutton.button - Button1);
+    if ((buttons & ~released) == 0) {
+      m_captured = nullptr;
+    }
+
+    view::pimpl::send_event(target, evt);
+    break;
+  }
+
+  case MotionNotify:
+    handle_motion(evt);
+    break;
+
+  case EnterNotify:
+    handle_motion(evt);
+    break;
+
+  case LeaveNotify:
+    if (m_hovered && !m_captured) {
+      view* hovered = m_hovered;
+      m_hovered = nullptr;
+      view::pimpl::send_event(hovered, evt);
+    }
+    break;
+
+  case KeyPress:
+  case KeyRelease: {
+    view::pimpl::send_event(view::pimpl::get_key_view(m_view), evt);
+    break;
+  }
+
+  default:
+    break;
+  }
+}
+
+void window_object::handle_motion(XEvent& evt) {
+  // Only the last of the queued motions is dispatched.
+  if (evt.type == MotionNotify) {
+    while (XCheckTypedWindowEvent(get_display(), m_window, MotionNotify, &evt)) {
+    }
+  }
+
+  const nano::point<int> pos = evt.type == MotionNotify ? nano::point<int>(evt.xmotion.x, evt.xmotion.y)
+                                                        : nano::point<int>(evt.xcrossing.x, evt.xcrossing.y);
+
+  if (m_captured) {
+    if (evt.type == MotionNotify) {
+      view::pimpl::send_event(m_captured, evt);
+    }
+    return;
+  }
+
+  XEvent motion = evt;
+  if (evt.type == EnterNotify) {
+    motion = {};
+    motion.xmotion.type = MotionNotify;
+    motion.xmotion.display = evt.xcrossing.display;
+    motion.xmotion.window = evt.xcrossing.window;
+    motion.xmotion.root = evt.xcrossing.root;
+    motion.xmotion.time = evt.xcrossing.time;
+    motion.xmotion.x = evt.xcrossing.x;
+    motion.xmotion.y = evt.xcrossing.y;
+    motion.xmotion.x_root = evt.xcrossing.x_root;
+    motion.xmotion.y_root = evt.xcrossing.y_root;
+    motion.xmotion.state = evt.xcrossing.state;
+    motion.xmotion.same_screen = evt.xcrossing.same_screen;
+  }
+
+  view* target = view::pimpl::hit_test(m_view, pos);
+
+  if (target != m_hovered) {
+    if (view* previous = m_hovered) {
+      XEvent exited = make_crossing_event(motion, LeaveNotify);
+      view::pimpl::send_event(previous, exited);
+    }
+
+    m_hovered = target;
+    XEvent entered = make_crossing_event(motion, EnterNotify);
+    view::pimpl::send_event(target, entered);
+  }
+
+  view::pimpl::send_event(target, motion);
+}
+
+//
+// MARK: - compositor -
+//
+
+// Views draw through CoreGraphics, which has no linux backend yet. Recording
+// or rasterizing a view aborts instead of producing blank frames, and windows
+// don't create a compositor.
+
+namespace {
+  [[noreturn]] void abort_without_drawing(const char* name) {
+    std::cerr << "nano-ui: " << name << " needs a drawing backend, views are only drawn on macOS." << std::endl;
+    std::abort();
+  }
+} // namespace.
+
+/// never created on linux.
+class display_list::native {};
+
+display_list::display_list(std::unique_ptr<native> n, const nano::size<int>& size)
+    : m_native(std::move(n))
+    , m_size(size) {}
+
+display_list::~display_list() {}
+
+std::size_t display_list::get_byte_size() const noexcept { return 0; }
+
+bool compositor::can_draw() noexcept { return false; }
+
+void compositor::attach(view* root, compositor* c) { root->m_pimpl->m_compositor = c; }
+
+std::shared_ptr<const display_list> compositor::record(view* v, float scale) {
+  NANO_UNUSED(v);
+  NANO_UNUSED(scale);
+  abort_without_drawing("compositor::record");
+}
+
+void compositor::draw(const display_list& list, pixel_buffer& buffer, const nano::rect<int>& frame,
+    const nano::rect<int>& clip, float opacity, float scale) {
+  NANO_UNUSED(list);
+  NANO_UNUSED(buffer);
+  NANO_UNUSED(frame);
+  NANO_UNUSED(clip);
+  NANO_UNUSED(opacity);
+  NANO_UNUSED(scale);
+  abort_without_drawing("compositor::draw");
+}
+
+std::unique_ptr<compositor::presenter> compositor::create_native_presenter(view* root, float scale) {
+  NANO_UNUSED(scale);
+  window_object* win = root->m_pimpl->m_win.get();
+  auto p = std::make_unique<x11_presenter>(x11_connection::get_main(), win ? win->get_window() : 0);
+
+  if (win) {
+    win->set_presenter(p.get());
+  }
+
+  return p;
+}
+
+//
+// MARK: - graphics -
+//
+
+void headless_surface::render_tree(view* root, pixel_buffer& buffer, const nano::rect<int>& dirty_rect, float scale,
+    std::unordered_map<const view*, view_draw_stats>* stats) {
+  NANO_UNUSED(root);
+  NANO_UNUSED(buffer);
+  NANO_UNUSED(dirty_rect);
+  NANO_UNUSED(scale);
+  NANO_UNUSED(stats);
+  abort_without_drawing("headless_surface::render");
+}
+
+// Png pixels have straight alpha.
+bool write_png(const pixel_buffer& buffer, const std::string& path) {
+  if (buffer.empty()) {
+    return false;
+  }
+
+  std::vector<std::uint32_t> pixels(static_cast<std::size_t>(buffer.get_width() * buffer.get_height()));
+  export_pixels(buffer, pixels.data(), static_cast<std::size_t>(buffer.get_width()) * 4, pixel_format::rgba);
+
+  png_image image = {};
+  image.version = PNG_IMAGE_VERSION;
+  image.width = static_cast<png_uint_32>(buffer.get_width());
+  image.height = static_cast<png_uint_32>(buffer.get_height());
+  image.format = PNG_FORMAT_RGBA;
+  return png_image_write_to_file(&image, path.c_str(), 0, pixels.data(), 0, nullptr) != 0;
+}
+
+bool read_png(pixel_buffer& buffer, const std::string& path) {
+  png_image image = {};
+  image.version = PNG_IMAGE_VERSION;
+
+  if (!png_image_begin_read_from_file(&image, path.c_str())) {
+    return false;
+  }
+
+  // Any png is converted to 8 bit rgba.
+  image.format = PNG_FORMAT_RGBA;
+  std::vector<std::uint32_t> pixels(static_cast<std::size_t>(image.width) * image.height);
+
+  if (!png_image_finish_read(&image, nullptr, pixels.data(), 0, nullptr)) {
+    png_image_free(&image);
+    return false;
+  }
+
+  import_pixels(buffer, pixels.data(), static_cast<int>(image.width), static_cast<int>(image.height),
+      static_cast<std::size_t>(image.width) * 4, pixel_format::rgba);
+  return true;
+}
+
+void draw_image(nano::graphic_context& gc, std::shared_ptr<const pixel_buffer> image, const nano::rect<int>& src_rect,
+    const nano::rect<float>& dst_rect) {
+  NANO_UNUSED(gc);
+  NANO_UNUSED(image);
+  NANO_UNUSED(src_rect);
+  NANO_UNUSED(dst_rect);
+  abort_without_drawing("draw_image");
+}
+
+void draw_shadow(
+    nano::graphic_context& gc, const nano::rect<float>& rect, float corner_radius, const nano::shadow& s) {
+  NANO_UNUSED(gc);
+  NANO_UNUSED(rect);
+  NANO_UNUSED(corner_radius);
+  NANO_UNUSED(s);
+  abort_without_drawing("draw_shadow");
+}
+
+void fill_path(nano::graphic_context& gc, const path_geometry& path, const nano::point<float>& offset,
+    const nano::color& c) {
+  NANO_UNUSED(gc);
+  NANO_UNUSED(path);
+  NANO_UNUSED(offset);
+  NANO_UNUSED(c);
+  abort_without_drawing("fill_path");
+}
+
+void draw_sprite(nano::graphic_context& gc, const sprite_asset& asset, int frame, const nano::rect<float>& rect) {
+  NANO_UNUSED(gc);
+  NANO_UNUSED(asset);
+  NANO_UNUSED(frame);
+  NANO_UNUSED(rect);
+  abort_without_drawing("draw_sprite");
+}
+} // namespace nano.
+
+NANO_CLANG_DIAGNOSTIC_POP()
+
+#endif
@@ -0,0 +1,168 @@
+#include "nano/test.h"
+#include <nano/ui/animation.h>
+
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+namespace {
+constexpr double frame_time = 1.0 / 60.0;
+
+/// runs the animator until it is done or frame_count frames.
+int run(nano::animator& anim, int frame_count) {
+  for (int i = 0; i < frame_count; i++) {
+    if (!anim.update(frame_time)) {
+      return i + 1;
+    }
+  }
+
+  return frame_count;
+}
+
+/// starts animations on float properties from on_frame_changed(), enough to
+/// grow the lanes of the animator while it applies the frame.
+class chained_view : public nano::view {
+public:
+  chained_view(nano::animator& anim, const nano::rect<int>& rect)
+      : nano::view(rect)
+      , m_anim(anim) {}
+
+  std::vector<float> values = std::vector<float>(200, 0.0f);
+  int frame_changed_count = 0;
+
+protected:
+  void on_frame_changed() override {
+    if (frame_changed_count++ == 0) {
+      for (float& value : values) {
+        m_anim.animate_float(&value, 1.0f, 0.05);
+      }
+    }
+  }
+
+private:
+  nano::animator& m_anim;
+};
+} // namespace.
+
+TEST_CASE("nano.ui", animation_easing) {
+  const nano::easing easings[] = { nano::easing::linear, nano::easing::ease_in, nano::easing::ease_out,
+    nano::easing::ease_in_out, nano::easing::ease_in_cubic, nano::easing::ease_out_cubic,
+    nano::easing::ease_out_back };
+
+  nano::animator anim;
+  std::vector<float> values(std::size(easings), 2.0f);
+  for (std::size_t i = 0; i < std::size(easings); i++) {
+    anim.animate_float(&values[i], 10.0f, 0.5, easings[i]);
+  }
+
+  // Half way, every curve is between its ends except the one that overshoots.
+  run(anim, 15);
+  EXPECT_NEAR(values[0], 6.0f, 1e-3f);
+  EXPECT_NEAR(values[3], 6.0f, 1e-3f);
+  EXPECT_LT(values[1], values[0]);
+  EXPECT_GT(values[2], values[0]);
+
+  // Every curve ends exactly on its target.
+  EXPECT_LE(run(anim, 100), 17);
+  for (float value : values) {
+    EXPECT_EQ(value, 10.0f);
+  }
+
+  EXPECT_EQ(anim.size(), 0u);
+  EXPECT_EQ(anim.get_lane_count(), 0u);
+}
+
+TEST_CASE("nano.ui", animation_spring) {
+  nano::spring s;
+  s.damping = 10.0f;
+
+  nano::animator anim;
+  float value = 0.0f;
+  const nano::animator::id_type id = anim.animate_float(&value, 100.0f, s);
+
+  // Under damped, it overshoots.
+  float max_value = 0.0f;
+  for (int i = 0; i < 30; i++) {
+    anim.update(frame_time);
+    max_value = std::max(max_value, value);
+  }
+
+  EXPECT_GT(max_value, 100.0f);
+  EXPECT_TRUE(anim.is_running(id));
+
+  // Then settles on the target.
+  EXPECT_LT(run(anim, 600), 600);
+  EXPECT_FALSE(anim.is_running(id));
+  EXPECT_EQ(value, 100.0f);
+}
+
+TEST_CASE("nano.ui", animation_cancel) {
+  nano::animator anim;
+  nano::view v(nano::rect<int>(0, 0, 10, 10));
+  float a = 0.0f;
+  float b = 0.0f;
+  float c = 0.0f;
+
+  const nano::animator::id_type id_a = anim.animate_float(&a, 10.0f, 1.0);
+  const nano::animator::id_type id_b = anim.animate_float(&b, 10.0f, 1.0);
+  anim.animate_frame(&v, nano::rect<int>(100, 0, 10, 10), 1.0, nano::easing::linear);
+  anim.animate_float(&c, 10.0f, 1.0);
+  EXPECT_EQ(anim.size(), 4u);
+  EXPECT_EQ(anim.get_lane_count(), 7u);
+
+  // The lanes are compacted on the next update, the others keep their values.
+  run(anim, 15);
+  anim.cancel(id_b);
+  anim.cancel(&v);
+  EXPECT_FALSE(anim.is_running(id_b));
+  EXPECT_TRUE(anim.is_running(id_a));
+
+  const float b_value = b;
+  run(anim, 15);
+  EXPECT_EQ(anim.size(), 2u);
+  EXPECT_EQ(anim.get_lane_count(), 2u);
+  EXPECT_NEAR(a, 5.0f, 1e-3f);
+  EXPECT_NEAR(c, 5.0f, 1e-3f);
+  EXPECT_EQ(b, b_value);
+  EXPECT_EQ(v.get_frame().x, 25);
+
+  // Retargeting keeps a single animation per property, from its current value.
+  const nano::animator::id_type id_a2 = anim.animate_float(&a, 0.0f, 1.0);
+  EXPECT_FALSE(anim.is_running(id_a));
+  anim.update(0.0);
+  EXPECT_EQ(anim.size(), 2u);
+  EXPECT_NEAR(a, 5.0f, 1e-3f);
+
+  run(anim, 30);
+  EXPECT_NEAR(a, 2.5f, 1e-3f);
+  EXPECT_TRUE(anim.is_running(id_a2));
+
+  anim.cancel_all();
+  EXPECT_EQ(anim.size(), 0u);
+  EXPECT_FALSE(anim.update(frame_time));
+}
+
+TEST_CASE("nano.ui", animation_reentrant_start) {
+  nano::animator anim;
+  auto v = std::make_unique<chained_view>(anim, nano::rect<int>(0, 0, 10, 10));
+
+  // The first frame starts 200 animations from on_frame_changed().
+  anim.animate_frame(v.get(), nano::rect<int>(0, 0, 40, 10), 0.1, nano::easing::linear);
+  anim.update(frame_time);
+  EXPECT_EQ(v->frame_changed_count, 1);
+  EXPECT_EQ(anim.size(), 201u);
+
+  // Started during the pass, they only move from the next one.
+  EXPECT_EQ(v->values[0], 0.0f);
+
+  run(anim, 100);
+  EXPECT_EQ(v->get_frame(), nano::rect<int>(0, 0, 40, 10));
+  EXPECT_GT(v->frame_changed_count, 1);
+
+  for (float value : v->values) {
+    EXPECT_EQ(value, 1.0f);
+  }
+
+  EXPECT_EQ(anim.size(), 0u);
+}
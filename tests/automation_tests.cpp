@@ -0,0 +1,251 @@
+#include "nano/test.h"
+#include <nano/ui/automation.h>
+#include <nano/ui/compositor.h>
+#include <nano/ui/headless.h>
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+std::vector<nano::automation_point> make_points(std::size_t count, unsigned seed) {
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<float> value(0.0f, 1.0f);
+
+  std::vector<nano::automation_point> points(count);
+  for (std::size_t i = 0; i < count; i++) {
+    points[i] = { static_cast<double>(i) * 0.5, value(rng) };
+  }
+
+  return points;
+}
+
+/// the range of a line through the points over [a, b], by visiting every point.
+nano::automation_column get_brute_range(const nano::automation_curve& curve, double a, double b) {
+  nano::automation_column r = { curve.get_value(a), curve.get_value(a) };
+  const float vb = curve.get_value(b);
+  r.min = std::min(r.min, vb);
+  r.max = std::max(r.max, vb);
+
+  for (auto p = curve.begin(); p != curve.end(); p = curve.next(p)) {
+    const nano::automation_point& pt = curve.get_point(p);
+    if (pt.time >= a && pt.time <= b) {
+      r.min = std::min(r.min, pt.value);
+      r.max = std::max(r.max, pt.value);
+    }
+  }
+
+  return r;
+}
+} // namespace.
+
+TEST_CASE("nano.ui", automation_curve) {
+  nano::automation_curve curve(0.25f);
+  EXPECT_EQ(curve.get_value(10.0), 0.25f);
+
+  curve.insert({ 2.0, 1.0f });
+  curve.insert({ 0.0, 0.0f });
+  curve.insert({ 4.0, 0.5f });
+  EXPECT_EQ(curve.size(), 3u);
+
+  // Linear between the points, flat outside.
+  EXPECT_NEAR(curve.get_value(-1.0), 0.0f, 1e-6f);
+  EXPECT_NEAR(curve.get_value(1.0), 0.5f, 1e-6f);
+  EXPECT_NEAR(curve.get_value(3.0), 0.75f, 1e-6f);
+  EXPECT_NEAR(curve.get_value(8.0), 0.5f, 1e-6f);
+
+  // A point at the same time makes a step, the later one wins.
+  const auto step = curve.insert({ 2.0, 0.0f });
+  EXPECT_EQ(curve.get_point(step).value, 0.0f);
+  EXPECT_NEAR(curve.get_value(2.0), 0.0f, 1e-6f);
+  EXPECT_NEAR(curve.get_value(1.0), 0.5f, 1e-6f);
+
+  curve.erase(step);
+  EXPECT_NEAR(curve.get_value(2.0), 1.0f, 1e-6f);
+
+  EXPECT_EQ(curve.erase(1.0, 4.0), 1u);
+  EXPECT_EQ(curve.size(), 2u);
+  EXPECT_NEAR(curve.get_value(2.0), 0.25f, 1e-6f);
+}
+
+TEST_CASE("nano.ui", automation_curve_empty) {
+  nano::automation_curve curve(0.25f);
+  const auto first = curve.insert({ 1.0, 0.75f });
+  EXPECT_EQ(curve.size(), 1u);
+  EXPECT_EQ(curve.get_chunk_count(), 1u);
+  EXPECT_EQ(curve.get_point(first).value, 0.75f);
+  EXPECT_NEAR(curve.get_value(0.0), 0.75f, 1e-6f);
+
+  // Erasing every point removes the chunks, the next insert starts over.
+  for (int i = 0; i < 3000; i++) {
+    curve.insert({ static_cast<double>(i), 0.5f });
+  }
+
+  EXPECT_EQ(curve.erase(-1.0, 4000.0), 3001u);
+  EXPECT_TRUE(curve.empty());
+  EXPECT_EQ(curve.get_chunk_count(), 0u);
+  EXPECT_EQ(curve.get_value(10.0), 0.25f);
+
+  const auto again = curve.insert({ 2.0, 1.0f });
+  EXPECT_EQ(curve.size(), 1u);
+  EXPECT_EQ(curve.get_point(again).time, 2.0);
+  EXPECT_NEAR(curve.get_value(10.0), 1.0f, 1e-6f);
+
+  curve.erase(again);
+  EXPECT_TRUE(curve.empty());
+  curve.insert({ 3.0, 0.0f });
+  EXPECT_EQ(curve.size(), 1u);
+  EXPECT_NEAR(curve.get_value(0.0), 0.0f, 1e-6f);
+}
+
+TEST_CASE("nano.ui", automation_curve_edits) {
+  nano::automation_curve curve;
+  std::vector<nano::automation_point> points = make_points(20000, 1);
+  curve.assign(points);
+  EXPECT_EQ(curve.size(), points.size());
+
+  // Random insertions and removals split and merge the chunks.
+  std::mt19937 rng(2);
+  std::uniform_real_distribution<double> time(0.0, 10000.0);
+  std::uniform_real_distribution<float> value(0.0f, 1.0f);
+
+  for (int i = 0; i < 5000; i++) {
+    const nano::automation_point p = { time(rng), value(rng) };
+    const auto pos = curve.insert(p);
+    EXPECT_EQ(curve.get_point(pos).time, p.time);
+  }
+
+  for (int i = 0; i < 3000; i++) {
+    const auto pos = curve.lower_bound(time(rng));
+    curve.erase(pos == curve.end() ? curve.begin() : pos);
+  }
+
+  EXPECT_EQ(curve.size(), 22000u);
+  const std::size_t removed = curve.count(curve.lower_bound(2000.0), curve.lower_bound(6000.0));
+  EXPECT_EQ(curve.erase(2000.0, 6000.0), removed);
+  EXPECT_EQ(curve.size(), 22000u - removed);
+
+  // The points stay sorted and the chunks within bounds.
+  double last_time = -1.0;
+  std::size_t n = 0;
+  for (auto p = curve.begin(); p != curve.end(); p = curve.next(p)) {
+    EXPECT_GE(curve.get_point(p).time, last_time);
+    last_time = curve.get_point(p).time;
+    n++;
+  }
+
+  EXPECT_EQ(n, curve.size());
+  EXPECT_EQ(curve.lower_bound(2000.0), curve.lower_bound(6000.0));
+  EXPECT_LE(curve.size(), curve.get_chunk_count() * nano::automation_curve::max_chunk_size);
+
+  // The indexed ranges match the brute force ones at any zoom.
+  for (double width : { 0.1, 3.0, 70.0, 2500.0 }) {
+    std::vector<nano::automation_column> columns(4);
+    curve.get_columns(1900.0, width, columns.size(), columns.data());
+
+    for (std::size_t i = 0; i < columns.size(); i++) {
+      const double a = 1900.0 + static_cast<double>(i) * width;
+      const nano::automation_column expected = get_brute_range(curve, a, a + width);
+      EXPECT_NEAR(columns[i].min, expected.min, 1e-5f);
+      EXPECT_NEAR(columns[i].max, expected.max, 1e-5f);
+    }
+  }
+}
+
+TEST_CASE("nano.ui", automation_curve_ranges) {
+  nano::automation_curve curve;
+  curve.assign(make_points(8000, 3));
+
+  std::mt19937 rng(4);
+  std::uniform_real_distribution<double> time(0.0, 4000.0);
+  std::uniform_real_distribution<float> value(0.0f, 1.0f);
+
+  // The tree over the chunks follows every kind of edit.
+  for (int i = 0; i < 400; i++) {
+    switch (i % 4) {
+    case 0:
+    case 1:
+      curve.insert({ time(rng), value(rng) });
+      break;
+
+    case 2: {
+      const auto pos = curve.lower_bound(time(rng));
+      curve.erase(pos == curve.end() ? curve.begin() : pos);
+      break;
+    }
+
+    default: {
+      const double a = time(rng);
+      curve.erase(a, a + 40.0);
+      break;
+    }
+    }
+
+    const double a = time(rng);
+    const double b = a + std::uniform_real_distribution<double>(0.0, 3000.0)(rng);
+    const nano::automation_column r = curve.get_range(a, b);
+    const nano::automation_column expected = get_brute_range(curve, a, b);
+    EXPECT_NEAR(r.min, expected.min, 1e-5f);
+    EXPECT_NEAR(r.max, expected.max, 1e-5f);
+  }
+}
+
+TEST_CASE("nano.ui", automation_curve_hit_test) {
+  nano::automation_curve curve;
+  curve.assign({ { 0.0, 0.1f }, { 1.0, 0.9f }, { 2.0, 0.5f }, { 2.1, 0.52f } });
+
+  nano::automation_curve::position p;
+  EXPECT_TRUE(curve.hit_test(1.05, 0.88f, 0.2, 0.05f, p));
+  EXPECT_EQ(curve.get_point(p).time, 1.0);
+
+  // The closest of two points in range.
+  EXPECT_TRUE(curve.hit_test(2.08, 0.515f, 0.2, 0.05f, p));
+  EXPECT_EQ(curve.get_point(p).time, 2.1);
+
+  EXPECT_FALSE(curve.hit_test(1.0, 0.5f, 0.2, 0.05f, p));
+  EXPECT_FALSE(curve.hit_test(5.0, 0.5f, 0.2, 0.05f, p));
+}
+
+TEST_CASE("nano.ui", automation_lane_view) {
+  if (!nano::compositor::can_draw()) {
+    return;
+  }
+
+  auto root = std::make_unique<nano::view>(nano::rect<int>(0, 0, 200, 100));
+  auto lane = std::make_unique<nano::automation_lane_view>(root.get(), nano::rect<int>(0, 0, 200, 100));
+  auto curve = std::make_shared<nano::automation_curve>();
+  curve->assign({ { 0.0, 0.5f }, { 50.0, 0.5f }, { 100.0, 0.5f }, { 150.0, 0.5f } });
+  lane->set_curve(curve);
+  lane->set_visible_range(0.0, 1.0);
+
+  nano::headless_presenter presenter;
+  auto comp = std::make_unique<nano::compositor>(root.get(), &presenter);
+  comp->commit();
+  comp->flush();
+
+  // Dragging a point only redraws the lines to its neighbours.
+  lane->begin_drag(nano::point<float>(101.0f, 51.0f));
+  EXPECT_TRUE(lane->is_dragging());
+  EXPECT_EQ(curve->size(), 4u);
+
+  lane->drag(nano::point<float>(100.0f, 25.0f));
+  lane->end_drag();
+  comp->commit();
+  comp->flush();
+
+  EXPECT_NEAR(curve->get_value(100.0), 0.75f, 1e-6f);
+  EXPECT_TRUE(presenter.get_last_damage().get_bounds() == nano::rect<int>(45, 0, 110, 100));
+
+  // A click away from the points adds one, which can then be removed.
+  lane->begin_drag(nano::point<float>(75.0f, 10.0f));
+  lane->end_drag();
+  EXPECT_EQ(curve->size(), 5u);
+  EXPECT_TRUE(lane->remove_point(nano::point<float>(76.0f, 11.0f)));
+  EXPECT_FALSE(lane->remove_point(nano::point<float>(76.0f, 11.0f)));
+  EXPECT_EQ(curve->size(), 4u);
+
+  comp.reset();
+  lane.reset();
+  root.reset();
+}
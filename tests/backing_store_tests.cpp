@@ -0,0 +1,83 @@
+#include "nano/test.h"
+#include <nano/ui/backing_store.h>
+
+TEST_CASE("nano.ui", backing_store_pool) {
+  nano::backing_store_pool pool(1024 * 1024);
+
+  nano::backing_store_pool::storage_type a = pool.acquire(1000);
+  EXPECT_GE(a.size(), 1000u);
+  pool.release(std::move(a));
+
+  // Smaller requests reuse the storage, unless it is more than twice as large.
+  EXPECT_GE(pool.acquire(800).size(), 1000u);
+  EXPECT_EQ(pool.get_stats().reuses, 1u);
+  EXPECT_EQ(pool.get_stats().pooled_count, 0u);
+
+  pool.release(nano::backing_store_pool::storage_type(1000));
+  EXPECT_EQ(pool.acquire(400).size(), 400u);
+  EXPECT_EQ(pool.get_stats().allocations, 2u);
+  EXPECT_EQ(pool.get_stats().pooled_count, 1u);
+
+  // The oldest storage is freed first.
+  pool.release(nano::backing_store_pool::storage_type(200 * 1024));
+  pool.set_capacity(200 * 1024 * sizeof(std::uint32_t));
+  EXPECT_EQ(pool.get_stats().pooled_count, 1u);
+  EXPECT_EQ(pool.get_stats().pooled_bytes, 200u * 1024u * sizeof(std::uint32_t));
+
+  pool.clear();
+  EXPECT_EQ(pool.get_stats().pooled_bytes, 0u);
+}
+
+TEST_CASE("nano.ui", backing_store) {
+  using clock = nano::backing_store::clock;
+  nano::backing_store_pool pool;
+  const clock::time_point start = clock::now();
+
+  {
+    nano::backing_store store(pool);
+
+    // Allocated at device scale.
+    EXPECT_TRUE(store.resize({ 400, 300 }, 2.0f, start));
+    EXPECT_EQ(store.get_buffer().get_size(), nano::size<int>(800, 600));
+    EXPECT_FALSE(store.resize({ 400, 300 }, 2.0f, start));
+    EXPECT_FALSE(store.needs_trim());
+    EXPECT_EQ(pool.get_stats().allocations, 1u);
+
+    // A live resize sweep only reallocates when growing past the capacity, geometrically.
+    clock::time_point t = start;
+    for (int i = 1; i <= 100; i++) {
+      t += std::chrono::milliseconds(16);
+      store.resize({ 400 + i * 4, 300 + i * 3 }, 2.0f, t);
+      EXPECT_EQ(store.get_buffer().get_size(), nano::size<int>(800 + i * 8, 600 + i * 6));
+      EXPECT_GE(store.get_buffer().get_stride(), store.get_buffer().get_width());
+    }
+
+    EXPECT_LE(pool.get_stats().allocations, 4u);
+
+    // Shrinking reuses the storage with a larger stride.
+    const std::uint64_t allocations = pool.get_stats().allocations;
+    t += std::chrono::milliseconds(16);
+    EXPECT_TRUE(store.resize({ 300, 200 }, 2.0f, t));
+    EXPECT_EQ(pool.get_stats().allocations, allocations);
+    EXPECT_GT(store.get_buffer().get_stride(), 600);
+    EXPECT_TRUE(store.needs_trim());
+
+    // The storage is trimmed once the size settles, the content is kept.
+    store.get_buffer().clear();
+    store.get_buffer().set_pixel(599, 399, 0xFF00FF00u);
+    EXPECT_FALSE(store.trim(t + std::chrono::milliseconds(10)));
+    EXPECT_TRUE(store.trim(t + nano::backing_store::settle_delay));
+    EXPECT_FALSE(store.needs_trim());
+    EXPECT_EQ(store.get_buffer().get_stride(), 608);
+    EXPECT_EQ(store.get_buffer().get_pixel(599, 399), 0xFF00FF00u);
+    EXPECT_EQ(store.get_buffer().get_pixel(0, 0), 0u);
+  }
+
+  // The storage of a destroyed store is reused by the next window.
+  EXPECT_GT(pool.get_stats().pooled_count, 0u);
+  const std::uint64_t allocations = pool.get_stats().allocations;
+
+  nano::backing_store store(pool);
+  store.resize({ 300, 200 }, 2.0f, start);
+  EXPECT_EQ(pool.get_stats().allocations, allocations);
+}
@@ -0,0 +1,82 @@
+#include "nano/test.h"
+#include <nano/ui/blur.h>
+
+#include <cstdlib>
+
+TEST_CASE("nano.ui", box_blur_sizes) {
+  for (float sigma : { 1.0f, 2.5f, 8.0f, 20.0f }) {
+    // The variance of a box of size n is (n^2 - 1) / 12.
+    double variance = 0;
+    for (int size : nano::get_box_blur_sizes(sigma)) {
+      EXPECT_EQ(size % 2, 1);
+      variance += (size * size - 1) / 12.0;
+    }
+
+    EXPECT_NEAR(variance, static_cast<double>(sigma * sigma), static_cast<double>(sigma) + 0.5);
+  }
+}
+
+TEST_CASE("nano.ui", box_blur) {
+  nano::alpha_mask mask(100, 100);
+  for (int y = 40; y < 60; y++) {
+    for (int x = 40; x < 60; x++) {
+      mask.row(y)[x] = 255;
+    }
+  }
+
+  nano::box_blur(mask, 4.0f);
+
+  // The blur spreads the coverage without changing its total.
+  long total = 0;
+  for (std::size_t i = 0; i < mask.get_byte_size(); i++) {
+    total += mask.data()[i];
+  }
+
+  EXPECT_NEAR(total, 400L * 255L, 400L * 255L / 50L);
+  EXPECT_EQ(mask.row(5)[5], 0);
+  EXPECT_GT(mask.row(50)[50], 200);
+  EXPECT_GT(mask.row(50)[36], 0);
+
+  // Pixel buffers are blurred per component.
+  nano::pixel_buffer buffer(64, 64);
+  const std::uint32_t blue = nano::make_pixel(0, 0, 255, 255);
+  buffer.clear(blue);
+  nano::box_blur(buffer, nano::rect<int>(0, 0, 64, 64), 3.0f);
+
+  const std::uint32_t center = buffer.get_pixel(32, 32);
+  EXPECT_EQ(nano::get_pixel_red(center), 0);
+  EXPECT_GE(nano::get_pixel_blue(center), 254);
+  EXPECT_GE(nano::get_pixel_alpha(center), 254);
+
+  // Outside of the area is transparent.
+  EXPECT_LT(nano::get_pixel_alpha(buffer.get_pixel(0, 0)), 255);
+}
+
+TEST_CASE("nano.ui", shadow_cache) {
+  nano::shadow_cache cache;
+
+  const auto a = cache.get_rounded_rect(nano::size<float>(40.0f, 20.0f), 4.0f, 6.0f, 1.0f);
+  const auto b = cache.get_rounded_rect(nano::size<float>(40.0f, 20.0f), 4.0f, 6.0f, 1.0f);
+  const auto c = cache.get_rounded_rect(nano::size<float>(40.0f, 20.0f), 4.0f, 6.0f, 2.0f);
+
+  EXPECT_EQ(a, b);
+  EXPECT_NE(a, c);
+  EXPECT_EQ(a->offset.x, -18);
+  EXPECT_EQ(a->mask.get_width(), 40 + 36);
+  EXPECT_EQ(c->mask.get_width(), 80 + 72);
+
+  const nano::shadow_cache::stats stats = cache.get_stats();
+  EXPECT_EQ(stats.hits, 1);
+  EXPECT_EQ(stats.misses, 2);
+  EXPECT_EQ(stats.byte_size, a->mask.get_byte_size() + c->mask.get_byte_size());
+
+  cache.set_capacity(c->mask.get_byte_size());
+  EXPECT_EQ(cache.get_stats().evictions, 1);
+  EXPECT_EQ(cache.get_stats().entry_count, 1);
+
+  // The shadow is darkest under the shape.
+  nano::pixel_buffer buffer(100, 100);
+  nano::draw_shadow(buffer, nano::rect<float>(30.0f, 40.0f, 40.0f, 20.0f), 4.0f, nano::shadow{});
+  EXPECT_GT(nano::get_pixel_alpha(buffer.get_pixel(50, 52)), nano::get_pixel_alpha(buffer.get_pixel(50, 30)));
+  EXPECT_EQ(buffer.get_pixel(2, 2), 0);
+}
@@ -0,0 +1,126 @@
+#include "nano/test.h"
+#include <nano/ui/color_conversion.h>
+
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+/// every alpha with a few components, 37 is not a multiple of the vector sizes.
+std::vector<std::uint32_t> make_test_pixels() {
+  std::vector<std::uint32_t> pixels;
+  for (int a = 0; a < 256; a++) {
+    for (int i = 0; i < 37; i++) {
+      const auto c = [&](int k) { return static_cast<std::uint8_t>((i * 7 + k * 61 + a) & 0xFF); };
+      pixels.push_back(nano::make_pixel(c(0), c(1), c(2), static_cast<std::uint8_t>(a)));
+    }
+  }
+  return pixels;
+}
+
+int component(std::uint32_t p, int index) { return static_cast<int>((p >> (index * 8)) & 0xFF); }
+} // namespace.
+
+TEST_CASE("nano.ui", swap_red_blue) {
+  const std::vector<std::uint32_t> src = make_test_pixels();
+  std::vector<std::uint32_t> dst(src.size());
+  nano::swap_red_blue(src.data(), dst.data(), src.size());
+
+  bool same = true;
+  for (std::size_t i = 0; i < src.size(); i++) {
+    same = same && component(dst[i], 0) == component(src[i], 2) && component(dst[i], 1) == component(src[i], 1)
+        && component(dst[i], 2) == component(src[i], 0) && component(dst[i], 3) == component(src[i], 3);
+  }
+  EXPECT_TRUE(same);
+
+  // In place, twice is the identity.
+  nano::swap_red_blue(dst.data(), dst.data(), dst.size());
+  EXPECT_TRUE(dst == src);
+}
+
+TEST_CASE("nano.ui", premultiply) {
+  const std::vector<std::uint32_t> src = make_test_pixels();
+  std::vector<std::uint32_t> dst(src.size());
+  nano::premultiply(src.data(), dst.data(), src.size());
+
+  bool exact = true;
+  for (std::size_t i = 0; i < src.size(); i++) {
+    const int a = component(src[i], 3);
+    for (int k = 0; k < 3; k++) {
+      const int expected = static_cast<int>(std::lround(component(src[i], k) * a / 255.0));
+      exact = exact && component(dst[i], k) == expected;
+    }
+    exact = exact && component(dst[i], 3) == a;
+  }
+  EXPECT_TRUE(exact);
+
+  // Back to straight alpha, within the precision left by the alpha.
+  std::vector<std::uint32_t> straight(src.size());
+  nano::unpremultiply(dst.data(), straight.data(), dst.size());
+
+  bool close = true;
+  for (std::size_t i = 0; i < src.size(); i++) {
+    const int a = component(src[i], 3);
+    for (int k = 0; k < 3; k++) {
+      const int expected = a ? component(src[i], k) : 0;
+      close = close && std::abs(component(straight[i], k) - expected) <= (a ? 128 / a + 1 : 0);
+    }
+    close = close && component(straight[i], 3) == a;
+  }
+  EXPECT_TRUE(close);
+
+  EXPECT_EQ(nano::to_pixel(nano::color(0xFF000080)), nano::make_pixel(128, 0, 0, 128));
+}
+
+TEST_CASE("nano.ui", convert_pixels) {
+  const std::vector<std::uint32_t> src = make_test_pixels();
+  std::vector<std::uint32_t> bgra(src.size());
+  std::vector<std::uint32_t> back(src.size());
+
+  nano::convert_pixels(src.data(), nano::pixel_format::rgba, bgra.data(), nano::pixel_format::bgra_premultiplied,
+      src.size());
+  nano::convert_pixels(bgra.data(), nano::pixel_format::bgra_premultiplied, back.data(),
+      nano::pixel_format::rgba_premultiplied, bgra.size());
+
+  std::vector<std::uint32_t> expected(src.size());
+  nano::premultiply(src.data(), expected.data(), src.size());
+  EXPECT_TRUE(back == expected);
+
+  // Import and export with padded rows.
+  const int width = 13;
+  const int height = 5;
+  const std::size_t bytes_per_row = 16 * sizeof(std::uint32_t);
+  std::vector<std::uint32_t> image(16 * height, nano::make_pixel(255, 0, 0, 255));
+
+  nano::pixel_buffer buffer;
+  nano::import_pixels(buffer, image.data(), width, height, bytes_per_row, nano::pixel_format::bgra);
+  EXPECT_EQ(buffer.get_width(), width);
+  EXPECT_EQ(buffer.get_pixel(12, 4), nano::make_pixel(0, 0, 255, 255));
+
+  std::vector<std::uint32_t> output(16 * height, 0);
+  nano::export_pixels(buffer, output.data(), bytes_per_row, nano::pixel_format::bgra_premultiplied);
+  EXPECT_EQ(output[16 * 4 + 12], nano::make_pixel(255, 0, 0, 255));
+  EXPECT_EQ(output[16 * 4 + 13], 0u);
+}
+
+TEST_CASE("nano.ui", srgb_linear) {
+  EXPECT_EQ(nano::srgb_to_linear(std::uint8_t(0)), 0.0f);
+  EXPECT_EQ(nano::srgb_to_linear(std::uint8_t(255)), 1.0f);
+  EXPECT_NEAR(nano::srgb_to_linear(std::uint8_t(188)), 0.5f, 0.005f);
+  EXPECT_EQ(nano::linear_to_srgb(0.5f), 188);
+  EXPECT_EQ(nano::linear_to_srgb(-1.0f), 0);
+  EXPECT_EQ(nano::linear_to_srgb(std::nanf("")), 0);
+
+  // Every srgb value survives a round trip.
+  std::vector<std::uint32_t> src(256);
+  for (std::size_t i = 0; i < src.size(); i++) {
+    const std::uint8_t v = static_cast<std::uint8_t>(i);
+    src[i] = nano::make_pixel(v, static_cast<std::uint8_t>(255 - v), v, v);
+  }
+
+  std::vector<float> linear(src.size() * 4);
+  std::vector<std::uint32_t> back(src.size());
+  nano::srgb_to_linear(src.data(), linear.data(), src.size());
+  nano::linear_to_srgb(linear.data(), back.data(), src.size());
+  EXPECT_TRUE(back == src);
+}
@@ -0,0 +1,380 @@
+#include "nano/test.h"
+#include <nano/ui/compositor.h>
+#include <nano/ui/headless.h>
+#include <nano/ui/scroll_view.h>
+
+#include <cstdlib>
+#include <memory>
+
+namespace {
+class solid_view : public nano::view {
+public:
+  solid_view(nano::view* parent, const nano::rect<int>& rect, const nano::color& c)
+      : nano::view(parent, rect)
+      , m_color(c) {}
+
+  solid_view(const nano::rect<int>& rect, const nano::color& c)
+      : nano::view(rect)
+      , m_color(c) {}
+
+  int draw_count = 0;
+
+protected:
+  void on_draw(nano::graphic_context& gc, const nano::rect<float>& dirty_rect) override {
+    NANO_UNUSED(dirty_rect);
+    draw_count++;
+    gc.set_fill_color(m_color);
+    gc.fill_rect(nano::rect<float>(0.0f, 0.0f, static_cast<float>(get_frame().width),
+        static_cast<float>(get_frame().height)));
+  }
+
+private:
+  nano::color m_color;
+};
+
+/// counts the layouts and draws with the cheaper path during live resizes.
+class resizable_view : public solid_view {
+public:
+  using solid_view::solid_view;
+
+  int layout_count = 0;
+  int live_draw_count = 0;
+  int live_resize_count = 0;
+
+protected:
+  void on_frame_changed() override { layout_count++; }
+
+  void on_will_start_live_resize() override { live_resize_count++; }
+
+  void on_did_end_live_resize() override { live_resize_count--; }
+
+  void on_draw(nano::graphic_context& gc, const nano::rect<float>& dirty_rect) override {
+    if (is_in_live_resize()) {
+      live_draw_count++;
+    }
+
+    solid_view::on_draw(gc, dirty_rect);
+  }
+};
+
+/// resizes its children to its bounds when laid out.
+class filling_view : public resizable_view {
+public:
+  using resizable_view::resizable_view;
+
+protected:
+  void on_frame_changed() override {
+    resizable_view::on_frame_changed();
+
+    for (nano::view* child : get_children()) {
+      child->set_frame(get_bounds());
+    }
+  }
+};
+
+inline bool is_near(std::uint32_t pixel, std::uint32_t expected) {
+  const auto near = [](int a, int b) { return std::abs(a - b) <= 2; };
+  return near(nano::get_pixel_red(pixel), nano::get_pixel_red(expected))
+      && near(nano::get_pixel_green(pixel), nano::get_pixel_green(expected))
+      && near(nano::get_pixel_blue(pixel), nano::get_pixel_blue(expected))
+      && near(nano::get_pixel_alpha(pixel), nano::get_pixel_alpha(expected));
+}
+} // namespace.
+
+TEST_CASE("nano.ui", compositor) {
+  if (!nano::compositor::can_draw()) {
+    return;
+  }
+
+  const std::uint32_t red = nano::make_pixel(255, 0, 0, 255);
+  const std::uint32_t blue = nano::make_pixel(0, 0, 255, 255);
+
+  auto root = std::make_unique<solid_view>(nano::rect<int>(0, 0, 64, 64), nano::color(0xFF0000FF));
+  auto child = std::make_unique<solid_view>(root.get(), nano::rect<int>(8, 8, 16, 16), nano::color(0x0000FFFF));
+
+  nano::headless_presenter presenter;
+  auto comp = std::make_unique<nano::compositor>(root.get(), &presenter);
+
+  comp->commit();
+  comp->flush();
+
+  nano::pixel_buffer frame = presenter.get_frame();
+  EXPECT_EQ(frame.get_width(), 64);
+  EXPECT_EQ(frame.get_height(), 64);
+  EXPECT_TRUE(is_near(frame.get_pixel(2, 2), red));
+  EXPECT_TRUE(is_near(frame.get_pixel(12, 12), blue));
+  EXPECT_TRUE(is_near(frame.get_pixel(40, 40), red));
+  EXPECT_EQ(comp->get_stats().recorded_views, 2);
+
+  // Only the child is recorded again and only its area is damaged.
+  child->redraw();
+  comp->commit();
+  comp->flush();
+
+  EXPECT_EQ(comp->get_stats().recorded_views, 3);
+  EXPECT_EQ(root->draw_count, 1);
+  EXPECT_EQ(child->draw_count, 2);
+  EXPECT_TRUE(presenter.get_last_damage().get_bounds() == nano::rect<int>(8, 8, 16, 16));
+
+  // The same tree rendered synchronously.
+  nano::headless_surface surface(root.get());
+  surface.render();
+  EXPECT_TRUE(is_near(surface.get_buffer().get_pixel(12, 12), blue));
+  EXPECT_TRUE(is_near(surface.get_buffer().get_pixel(40, 40), red));
+
+  comp.reset();
+  child.reset();
+  root.reset();
+}
+
+TEST_CASE("nano.ui", live_resize) {
+  if (!nano::compositor::can_draw()) {
+    return;
+  }
+
+  const std::uint32_t background = nano::make_pixel(10, 20, 30, 255);
+
+  auto root = std::make_unique<resizable_view>(nano::rect<int>(0, 0, 40, 30), nano::color(0xFF0000FF));
+  auto child = std::make_unique<resizable_view>(root.get(), nano::rect<int>(0, 0, 20, 10), nano::color(0x0000FFFF));
+
+  nano::headless_presenter presenter;
+  auto comp = std::make_unique<nano::compositor>(root.get(), &presenter);
+  comp->commit();
+  comp->flush();
+
+  const nano::pixel_buffer before = presenter.get_frame();
+
+  nano::compositor::live_resize_options options;
+  options.layout_interval = 60000;
+  options.background = background;
+  comp->set_live_resize_options(options);
+
+  comp->begin_live_resize();
+  EXPECT_TRUE(root->is_in_live_resize());
+  EXPECT_TRUE(child->is_in_live_resize());
+  EXPECT_EQ(child->live_resize_count, 1);
+
+  // The layout is deferred and the last frame is cropped at the new size.
+  root->set_frame(nano::rect<int>(0, 0, 60, 40));
+  EXPECT_TRUE(comp->defer_layout(root.get()));
+  comp->commit();
+  comp->flush();
+
+  nano::pixel_buffer frame = presenter.get_frame();
+  EXPECT_EQ(frame.get_size(), nano::size<int>(60, 40));
+  EXPECT_EQ(frame.get_pixel(5, 5), before.get_pixel(5, 5));
+  EXPECT_EQ(frame.get_pixel(39, 29), before.get_pixel(39, 29));
+  EXPECT_EQ(frame.get_pixel(50, 5), background);
+  EXPECT_EQ(frame.get_pixel(5, 35), background);
+  EXPECT_EQ(root->layout_count, 0);
+  EXPECT_EQ(comp->get_stats().snapshot_frames, 1u);
+
+  // Stretched, the corners stay in the corners.
+  options.mode = nano::compositor::live_resize_mode::stretch;
+  comp->set_live_resize_options(options);
+  root->set_frame(nano::rect<int>(0, 0, 80, 60));
+  comp->defer_layout(root.get());
+  comp->commit();
+  comp->flush();
+
+  frame = presenter.get_frame();
+  EXPECT_EQ(frame.get_size(), nano::size<int>(80, 60));
+  EXPECT_EQ(frame.get_pixel(79, 59), before.get_pixel(39, 29));
+  EXPECT_EQ(frame.get_pixel(30, 10), before.get_pixel(15, 5));
+  EXPECT_EQ(root->layout_count, 0);
+
+  // Once the interval elapsed, the views are laid out and drawn with their live resize path.
+  options.layout_interval = 0;
+  comp->set_live_resize_options(options);
+  root->set_frame(nano::rect<int>(0, 0, 90, 70));
+  comp->defer_layout(root.get());
+  root->redraw();
+  comp->commit();
+  comp->flush();
+
+  EXPECT_EQ(root->layout_count, 1);
+  EXPECT_EQ(root->live_draw_count, 1);
+  EXPECT_EQ(presenter.get_frame().get_size(), nano::size<int>(90, 70));
+  EXPECT_EQ(comp->get_stats().snapshot_frames, 2u);
+
+  // Everything is redrawn at full quality when the resize ends.
+  options.layout_interval = 60000;
+  comp->set_live_resize_options(options);
+  root->set_frame(nano::rect<int>(0, 0, 100, 80));
+  comp->defer_layout(root.get());
+  comp->end_live_resize();
+  comp->flush();
+
+  EXPECT_FALSE(root->is_in_live_resize());
+  EXPECT_FALSE(comp->defer_layout(root.get()));
+  EXPECT_EQ(root->layout_count, 2);
+  EXPECT_EQ(child->live_resize_count, 0);
+  EXPECT_EQ(root->draw_count, root->live_draw_count + 2);
+  EXPECT_EQ(child->draw_count, 2);
+  EXPECT_EQ(presenter.get_frame().get_size(), nano::size<int>(100, 80));
+  EXPECT_EQ(comp->get_stats().snapshot_frames, 2u);
+
+  comp.reset();
+  child.reset();
+  root.reset();
+}
+
+TEST_CASE("nano.ui", live_resize_nested) {
+  if (!nano::compositor::can_draw()) {
+    return;
+  }
+
+  auto root = std::make_unique<filling_view>(nano::rect<int>(0, 0, 40, 30), nano::color(0xFF0000FF));
+  auto child = std::make_unique<filling_view>(root.get(), nano::rect<int>(0, 0, 40, 30), nano::color(0x00FF00FF));
+  auto leaf = std::make_unique<filling_view>(child.get(), nano::rect<int>(0, 0, 40, 30), nano::color(0x0000FFFF));
+
+  nano::headless_presenter presenter;
+  auto comp = std::make_unique<nano::compositor>(root.get(), &presenter);
+  comp->commit();
+  comp->flush();
+
+  nano::compositor::live_resize_options options;
+  options.layout_interval = 0;
+  comp->set_live_resize_options(options);
+  comp->begin_live_resize();
+
+  // The frames set by each level's layout are laid out in the same pass.
+  root->set_frame(nano::rect<int>(0, 0, 60, 40));
+  comp->defer_layout(root.get());
+  comp->commit();
+  comp->flush();
+
+  EXPECT_EQ(root->layout_count, 1);
+  EXPECT_EQ(child->layout_count, 1);
+  EXPECT_EQ(leaf->layout_count, 1);
+  EXPECT_EQ(leaf->get_frame().size, nano::size<int>(60, 40));
+  EXPECT_EQ(presenter.get_frame().get_size(), nano::size<int>(60, 40));
+
+  comp->end_live_resize();
+  comp->flush();
+
+  comp.reset();
+  leaf.reset();
+  child.reset();
+  root.reset();
+}
+
+TEST_CASE("nano.ui", scroll_view) {
+  if (!nano::compositor::can_draw()) {
+    return;
+  }
+
+  const std::uint32_t red = nano::make_pixel(255, 0, 0, 255);
+  const std::uint32_t blue = nano::make_pixel(0, 0, 255, 255);
+
+  auto root = std::make_unique<solid_view>(nano::rect<int>(0, 0, 64, 64), nano::color(0x000000FF));
+  auto scroller = std::make_unique<nano::scroll_view>(root.get(), nano::rect<int>(0, 0, 64, 64));
+  auto content = std::make_unique<solid_view>(scroller.get(), nano::rect<int>(0, 0, 64, 256), nano::color(0xFF0000FF));
+
+  // Blue rows every 32 points.
+  std::vector<std::unique_ptr<solid_view>> rows;
+  for (int y = 0; y < 256; y += 32) {
+    rows.push_back(std::make_unique<solid_view>(content.get(), nano::rect<int>(0, y, 64, 16), nano::color(0x0000FFFF)));
+  }
+
+  scroller->set_content(content.get());
+
+  nano::headless_presenter presenter;
+  auto comp = std::make_unique<nano::compositor>(root.get(), &presenter);
+  comp->commit();
+  comp->flush();
+
+  EXPECT_TRUE(is_near(presenter.get_frame().get_pixel(4, 4), blue));
+  EXPECT_TRUE(is_near(presenter.get_frame().get_pixel(4, 20), red));
+
+  const std::uint64_t painted = comp->get_stats().painted_pixels;
+  const std::uint64_t recorded = comp->get_stats().recorded_views;
+
+  // Only the exposed strip is painted, only the row scrolled into view is recorded.
+  scroller->scroll_by(nano::point<int>(0, 8));
+  comp->commit();
+  comp->flush();
+
+  EXPECT_EQ(scroller->get_scroll_offset().y, 8);
+  EXPECT_EQ(comp->get_stats().painted_pixels - painted, 64u * 8u);
+  EXPECT_EQ(comp->get_stats().recorded_views, recorded + 1);
+
+  nano::pixel_buffer frame = presenter.get_frame();
+  EXPECT_TRUE(is_near(frame.get_pixel(4, 4), blue));
+  EXPECT_TRUE(is_near(frame.get_pixel(4, 10), red));
+  EXPECT_TRUE(is_near(frame.get_pixel(4, 26), blue));
+  EXPECT_TRUE(is_near(frame.get_pixel(4, 60), blue));
+
+  // The offset is clamped to the content.
+  scroller->set_scroll_offset(nano::point<int>(0, 1000));
+  EXPECT_EQ(scroller->get_scroll_offset().y, 256 - 64);
+
+  comp.reset();
+  rows.clear();
+  content.reset();
+  scroller.reset();
+  root.reset();
+}
+
+TEST_CASE("nano.ui", scroll_clipped) {
+  if (!nano::compositor::can_draw()) {
+    return;
+  }
+
+  const std::uint32_t blue = nano::make_pixel(0, 0, 255, 255);
+
+  // The child overflows its parent, over the sibling below.
+  auto root = std::make_unique<solid_view>(nano::rect<int>(0, 0, 64, 64), nano::color(0x000000FF));
+  auto parent = std::make_unique<solid_view>(root.get(), nano::rect<int>(0, 0, 64, 32), nano::color(0x000000FF));
+  auto child = std::make_unique<solid_view>(parent.get(), nano::rect<int>(0, 0, 64, 64), nano::color(0xFF0000FF));
+  auto sibling = std::make_unique<solid_view>(root.get(), nano::rect<int>(0, 32, 64, 32), nano::color(0x0000FFFF));
+
+  nano::headless_presenter presenter;
+  auto comp = std::make_unique<nano::compositor>(root.get(), &presenter);
+  comp->commit();
+  comp->flush();
+
+  // Only the pixels within the parent move.
+  child->scroll_rect(child->get_bounds(), nano::point<int>(0, 8));
+  comp->commit();
+  comp->flush();
+
+  EXPECT_TRUE(presenter.get_last_damage().get_bounds() == nano::rect<int>(0, 0, 64, 8));
+  EXPECT_TRUE(is_near(presenter.get_frame().get_pixel(4, 36), blue));
+
+  // Nothing is moved within a hidden view.
+  parent->set_hidden(true);
+  comp->commit();
+  comp->flush();
+  const std::uint64_t frames = presenter.get_frame_count();
+  child->scroll_rect(child->get_bounds(), nano::point<int>(0, 8));
+  comp->commit();
+  comp->flush();
+  EXPECT_EQ(presenter.get_frame_count(), frames);
+
+  comp.reset();
+  sibling.reset();
+  child.reset();
+  parent.reset();
+  root.reset();
+}
+
+TEST_CASE("nano.ui", pixel_buffer_scroll) {
+  nano::pixel_buffer buffer(8, 8);
+  for (int y = 0; y < 8; y++) {
+    for (int x = 0; x < 8; x++) {
+      buffer.set_pixel(x, y, static_cast<std::uint32_t>(y * 8 + x));
+    }
+  }
+
+  // Down and left within a sub area, the rest of the buffer is untouched.
+  buffer.scroll(nano::rect<int>(1, 1, 6, 6), nano::point<int>(-2, 3));
+  EXPECT_EQ(buffer.get_pixel(1, 4), static_cast<std::uint32_t>(1 * 8 + 3));
+  EXPECT_EQ(buffer.get_pixel(4, 6), static_cast<std::uint32_t>(3 * 8 + 6));
+  EXPECT_EQ(buffer.get_pixel(0, 4), static_cast<std::uint32_t>(4 * 8));
+  EXPECT_EQ(buffer.get_pixel(1, 7), static_cast<std::uint32_t>(7 * 8 + 1));
+
+  // Up, rows are read before being overwritten.
+  buffer.scroll(buffer.get_bounds(), nano::point<int>(0, -1));
+  EXPECT_EQ(buffer.get_pixel(0, 3), static_cast<std::uint32_t>(4 * 8));
+}
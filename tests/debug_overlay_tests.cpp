@@ -0,0 +1,139 @@
+#include "nano/test.h"
+#include <nano/ui/compositor.h>
+#include <nano/ui/debug_overlay.h>
+#include <nano/ui/headless.h>
+
+#include <memory>
+#include <thread>
+
+TEST_CASE("nano.ui", debug_overlay) {
+  nano::debug_overlay overlay;
+
+  // A full repaint with two nested views and a small one on top.
+  overlay.begin_frame(nano::size<int>(40, 30));
+  overlay.add_repaint(nano::rect<int>(0, 0, 40, 30));
+  overlay.add_draw(nano::rect<int>(0, 0, 40, 30));
+  overlay.add_draw(nano::rect<int>(10, 10, 20, 10));
+  overlay.add_draw(nano::rect<int>(12, 12, 4, 4));
+  overlay.add_draw_time(nullptr, nano::rect<int>(10, 10, 20, 10), 3.0);
+  overlay.add_draw_time(nullptr, nano::rect<int>(12, 12, 4, 4), 9.0);
+  overlay.end_frame();
+
+  EXPECT_EQ(overlay.get_frame_count(), 1u);
+  EXPECT_EQ(overlay.get_overdraw(1, 1), 1);
+  EXPECT_EQ(overlay.get_overdraw(11, 11), 2);
+  EXPECT_EQ(overlay.get_overdraw(13, 13), 3);
+  EXPECT_EQ(overlay.get_overdraw_area(2), 200u);
+  EXPECT_EQ(overlay.get_overdraw_area(3), 16u);
+
+  const std::vector<nano::debug_overlay::view_time> slowest = overlay.get_slowest_views();
+  EXPECT_EQ(slowest.size(), 2u);
+  EXPECT_EQ(slowest[0].ms, 9.0);
+
+  // Overdraw tint only.
+  nano::pixel_buffer frame(80, 60);
+  frame.clear(nano::make_pixel(0, 0, 0, 255));
+  overlay.set_layers(nano::debug_overlay::layers::overdraw);
+  overlay.compose(frame, 2.0f);
+
+  EXPECT_EQ(frame.get_pixel(2, 2), nano::make_pixel(0, 0, 0, 255));
+  EXPECT_GT(nano::get_pixel_blue(frame.get_pixel(22, 22)), 50);
+  EXPECT_GT(nano::get_pixel_green(frame.get_pixel(26, 26)), 50);
+
+  // The repaint flash fades out with time, without other frames.
+  overlay.set_layers(nano::debug_overlay::layers::repaint);
+  const auto now = nano::debug_overlay::clock_type::now();
+  nano::pixel_buffer flashed(80, 60);
+  overlay.compose(flashed, 2.0f, now);
+  const std::uint8_t first_alpha = nano::get_pixel_alpha(flashed.get_pixel(2, 2));
+  EXPECT_GT(first_alpha, 0);
+  EXPECT_TRUE(overlay.is_animating(now));
+
+  flashed.clear();
+  overlay.compose(flashed, 2.0f, now + nano::debug_overlay::flash_duration / 2);
+  EXPECT_GT(nano::get_pixel_alpha(flashed.get_pixel(2, 2)), 0);
+  EXPECT_LT(nano::get_pixel_alpha(flashed.get_pixel(2, 2)), first_alpha);
+
+  flashed.clear();
+  overlay.compose(flashed, 2.0f, now + nano::debug_overlay::flash_duration);
+  EXPECT_EQ(nano::get_pixel_alpha(flashed.get_pixel(2, 2)), 0);
+  EXPECT_FALSE(overlay.is_animating(now + nano::debug_overlay::flash_duration));
+}
+
+namespace {
+class filled_view : public nano::view {
+public:
+  using nano::view::view;
+
+protected:
+  void on_draw(nano::graphic_context& gc, const nano::rect<float>& dirty_rect) override {
+    NANO_UNUSED(dirty_rect);
+    gc.set_fill_color(nano::color(0x808080FF));
+    gc.fill_rect(nano::rect<float>(
+        0.0f, 0.0f, static_cast<float>(get_frame().width), static_cast<float>(get_frame().height)));
+  }
+};
+} // namespace.
+
+TEST_CASE("nano.ui", debug_overlay_backends) {
+  if (!nano::compositor::can_draw()) {
+    return;
+  }
+
+  auto root = std::make_unique<filled_view>(nano::rect<int>(0, 0, 64, 64));
+  auto child = std::make_unique<filled_view>(root.get(), nano::rect<int>(8, 8, 16, 16));
+  nano::debug_overlay overlay;
+
+  {
+    nano::headless_surface surface(root.get());
+    surface.set_debug_overlay(&overlay);
+    surface.render();
+
+    EXPECT_EQ(overlay.get_overdraw(4, 4), 1);
+    EXPECT_EQ(overlay.get_overdraw(12, 12), 2);
+    EXPECT_EQ(overlay.get_slowest_views().size(), 2u);
+  }
+
+  {
+    nano::headless_presenter presenter;
+    nano::compositor comp(root.get(), &presenter);
+    comp.set_debug_overlay(&overlay);
+    comp.commit();
+    comp.flush();
+
+    EXPECT_EQ(overlay.get_overdraw(12, 12), 2);
+
+    // Only the child repaints.
+    child->redraw();
+    comp.commit();
+    comp.flush();
+
+    EXPECT_TRUE(overlay.get_repaint().get_bounds() == nano::rect<int>(8, 8, 16, 16));
+    EXPECT_EQ(overlay.get_overdraw(4, 4), 0);
+    EXPECT_EQ(overlay.get_slowest_views().size(), 1u);
+    EXPECT_TRUE(overlay.get_slowest_views()[0].v == child.get());
+
+    // Without new frames, the flash keeps fading out and is cleared.
+    overlay.set_layers(nano::debug_overlay::layers::repaint);
+    child->redraw();
+    comp.commit();
+    comp.flush();
+
+    const std::uint64_t commits = comp.get_stats().commits;
+    const std::uint64_t presented = presenter.get_frame_count();
+    EXPECT_NE(presenter.get_frame().get_pixel(12, 12), presenter.get_frame().get_pixel(40, 40));
+    std::this_thread::sleep_for(nano::debug_overlay::flash_duration * 2);
+
+    EXPECT_GT(presenter.get_frame_count(), presented + 2);
+    EXPECT_EQ(comp.get_stats().commits, commits);
+    EXPECT_EQ(presenter.get_frame().get_pixel(12, 12), presenter.get_frame().get_pixel(40, 40));
+
+    // And stops once cleared.
+    const std::uint64_t cleared = presenter.get_frame_count();
+    std::this_thread::sleep_for(nano::debug_overlay::flash_duration);
+    EXPECT_EQ(presenter.get_frame_count(), cleared);
+  }
+
+  child.reset();
+  root.reset();
+}
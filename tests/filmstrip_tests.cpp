@@ -0,0 +1,206 @@
+#include "nano/test.h"
+#include <nano/ui/compositor.h>
+#include <nano/ui/filmstrip.h>
+#include <nano/ui/headless.h>
+
+#include <cstdio>
+#include <memory>
+#include <string>
+
+namespace {
+/// a filmstrip of solid frames, the frame i has the red component i * 10.
+nano::pixel_buffer make_filmstrip(int frame_width, int frame_height, int frame_count, bool vertical) {
+  nano::pixel_buffer image(vertical ? frame_width : frame_width * frame_count,
+      vertical ? frame_height * frame_count : frame_height);
+
+  for (int i = 0; i < frame_count; i++) {
+    const nano::rect<int> r = vertical ? nano::rect<int>(0, i * frame_height, frame_width, frame_height)
+                                       : nano::rect<int>(i * frame_width, 0, frame_width, frame_height);
+    image.fill(r, nano::make_pixel(static_cast<std::uint8_t>(i * 10), 0, 0, 255));
+  }
+
+  return image;
+}
+} // namespace.
+
+TEST_CASE("nano.ui", filmstrip_sheet) {
+  nano::sprite_asset asset;
+  asset.frame_count = 4;
+  asset.scale = 2.0f;
+
+  // An @2x filmstrip of 8x8 pixel frames is 4x4 points.
+  const nano::pixel_buffer image = make_filmstrip(8, 8, 4, true);
+  nano::sprite_sheet sheet = nano::make_sprite_sheet(image, asset, 2.0f);
+  EXPECT_EQ(sheet.frames.size(), 4u);
+  EXPECT_EQ(sheet.frame_size.width, 4.0f);
+  EXPECT_EQ(sheet.frames[3].get_width(), 8);
+  EXPECT_EQ(sheet.frames[3].get_pixel(7, 7), nano::make_pixel(30, 0, 0, 255));
+
+  // Resampled to 1x, a solid frame stays solid.
+  sheet = nano::make_sprite_sheet(image, asset, 1.0f);
+  EXPECT_EQ(sheet.frames[2].get_width(), 4);
+  EXPECT_EQ(sheet.frames[2].get_height(), 4);
+  EXPECT_EQ(sheet.frames[2].get_pixel(0, 0), nano::make_pixel(20, 0, 0, 255));
+  EXPECT_EQ(sheet.frames[2].get_pixel(3, 3), nano::make_pixel(20, 0, 0, 255));
+
+  sheet = nano::make_sprite_sheet(image, asset, 3.0f);
+  EXPECT_EQ(sheet.frames[1].get_width(), 12);
+  EXPECT_EQ(sheet.frames[1].get_pixel(11, 0), nano::make_pixel(10, 0, 0, 255));
+
+  // Like switch_metal.png, two frames side by side.
+  asset.frame_count = 2;
+  asset.orientation = nano::filmstrip_orientation::horizontal;
+  sheet = nano::make_sprite_sheet(make_filmstrip(64, 64, 2, false), asset, 2.0f);
+  EXPECT_EQ(sheet.frames.size(), 2u);
+  EXPECT_EQ(sheet.frames[1].get_size(), nano::size<int>(64, 64));
+  EXPECT_EQ(sheet.frames[1].get_pixel(0, 0), nano::make_pixel(10, 0, 0, 255));
+}
+
+TEST_CASE("nano.ui", filmstrip_cache) {
+  nano::sprite_cache cache;
+  cache.add_image("knob.png", make_filmstrip(16, 16, 8, true));
+
+  nano::sprite_asset asset;
+  asset.path = "knob.png";
+  asset.frame_count = 8;
+
+  // Every control of the same asset and scale shares the sheet.
+  std::shared_ptr<const nano::sprite_sheet> a = cache.get(asset, 1.0f);
+  std::shared_ptr<const nano::sprite_sheet> b = cache.get(asset, 1.0f);
+  std::shared_ptr<const nano::sprite_sheet> c = cache.get(asset, 2.0f);
+  EXPECT_TRUE(a == b);
+  EXPECT_TRUE(a != c);
+  EXPECT_EQ(c->frames[0].get_width(), 32);
+  EXPECT_EQ(cache.get_stats().hits, 1u);
+  EXPECT_EQ(cache.get_stats().misses, 2u);
+  EXPECT_EQ(cache.get_stats().entry_count, 2u);
+  EXPECT_EQ(cache.get_stats().byte_size, a->get_byte_size() + c->get_byte_size());
+
+  // The least recently used sheet is evicted first, it stays valid.
+  cache.get(asset, 1.0f);
+  cache.set_capacity(a->get_byte_size());
+  EXPECT_EQ(cache.get_stats().evictions, 1u);
+  EXPECT_TRUE(cache.get(asset, 1.0f) == a);
+  EXPECT_EQ(c->frames.size(), 8u);
+
+  // Replacing the image removes its sheets.
+  cache.add_image("knob.png", make_filmstrip(16, 16, 8, true));
+  EXPECT_EQ(cache.get_stats().entry_count, 0u);
+  EXPECT_TRUE(cache.get(asset, 1.0f) != a);
+
+  // A missing image gives an empty sheet.
+  asset.path = "missing.png";
+  EXPECT_TRUE(cache.get(asset, 1.0f)->empty());
+}
+
+TEST_CASE("nano.ui", filmstrip_file) {
+  const std::string path = "/tmp/nano_ui_filmstrip.png";
+  nano::pixel_buffer image = make_filmstrip(4, 4, 3, true);
+  image.fill(nano::rect<int>(0, 0, 2, 2), nano::make_pixel(0, 0, 64, 128));
+  EXPECT_TRUE(nano::write_png(image, path));
+
+  // Png pixels have straight alpha, the premultiplied ones survive the round trip.
+  nano::pixel_buffer loaded;
+  EXPECT_TRUE(nano::read_png(loaded, path));
+  EXPECT_EQ(loaded.get_size(), image.get_size());
+  EXPECT_EQ(loaded.get_pixel(1, 1), nano::make_pixel(0, 0, 64, 128));
+  EXPECT_EQ(loaded.get_pixel(3, 11), nano::make_pixel(20, 0, 0, 255));
+
+  // The cache loads the images it wasn't given.
+  nano::sprite_cache cache;
+  nano::sprite_asset asset;
+  asset.path = path;
+  asset.frame_count = 3;
+  std::shared_ptr<const nano::sprite_sheet> sheet = cache.get(asset, 1.0f);
+  EXPECT_EQ(sheet->frames.size(), 3u);
+  EXPECT_EQ(sheet->frames[1].get_pixel(0, 0), nano::make_pixel(10, 0, 0, 255));
+
+  EXPECT_FALSE(nano::read_png(loaded, "/tmp/nano_ui_missing.png"));
+  std::remove(path.c_str());
+}
+
+TEST_CASE("nano.ui", filmstrip_draw) {
+  nano::sprite_asset asset;
+  asset.frame_count = 2;
+
+  nano::pixel_buffer image = make_filmstrip(4, 4, 2, true);
+  image.fill(nano::rect<int>(0, 4, 2, 4), 0);
+  image.fill(nano::rect<int>(2, 4, 2, 4), nano::make_pixel(0, 0, 0, 128));
+  const nano::sprite_sheet sheet = nano::make_sprite_sheet(image, asset, 1.0f);
+
+  nano::pixel_buffer buffer(6, 6);
+  buffer.clear(nano::make_pixel(0, 255, 0, 255));
+
+  // Clipped at the bottom right, transparent pixels are skipped and the others blended.
+  nano::draw_sprite(buffer, sheet, 1, nano::point<int>(3, 3));
+  EXPECT_EQ(buffer.get_pixel(3, 3), nano::make_pixel(0, 255, 0, 255));
+  EXPECT_EQ(buffer.get_pixel(5, 5), nano::make_pixel(0, 127, 0, 255));
+  EXPECT_EQ(buffer.get_pixel(2, 2), nano::make_pixel(0, 255, 0, 255));
+
+  nano::draw_sprite(buffer, sheet, 0, nano::point<int>(-2, -2));
+  EXPECT_EQ(buffer.get_pixel(1, 1), nano::make_pixel(0, 0, 0, 255));
+  EXPECT_EQ(buffer.get_pixel(2, 2), nano::make_pixel(0, 255, 0, 255));
+
+  // Out of range frames are ignored.
+  nano::draw_sprite(buffer, sheet, 2, nano::point<int>(0, 0));
+  EXPECT_EQ(buffer.get_pixel(0, 0), nano::make_pixel(0, 0, 0, 255));
+}
+
+TEST_CASE("nano.ui", filmstrip_controls) {
+  if (!nano::compositor::can_draw()) {
+    return;
+  }
+
+  nano::sprite_cache::get_main().add_image("tests/knob.png", make_filmstrip(8, 8, 65, true));
+
+  nano::sprite_asset asset;
+  asset.path = "tests/knob.png";
+  asset.frame_count = 65;
+
+  auto root = std::make_unique<nano::view>(nano::rect<int>(0, 0, 200, 100));
+  auto knob = std::make_unique<nano::filmstrip_knob>(root.get(), nano::rect<int>(50, 20, 32, 32), asset);
+  float changed = -1.0f;
+  knob->set_callback([&](float value) { changed = value; });
+
+  nano::headless_presenter presenter;
+  auto comp = std::make_unique<nano::compositor>(root.get(), &presenter);
+  comp->commit();
+  comp->flush();
+  const std::uint64_t frames = presenter.get_frame_count();
+
+  // A value within the same frame doesn't redraw.
+  EXPECT_FALSE(knob->set_value(0.005f));
+  comp->commit();
+  comp->flush();
+  EXPECT_EQ(presenter.get_frame_count(), frames);
+
+  // Only the rect of the knob is redrawn.
+  EXPECT_TRUE(knob->set_value(0.5f));
+  EXPECT_EQ(knob->get_frame_index(), 32);
+  comp->commit();
+  comp->flush();
+  EXPECT_TRUE(presenter.get_last_damage().get_bounds() == nano::rect<int>(50, 20, 32, 32));
+  EXPECT_EQ(changed, -1.0f);
+
+  // Dragging up by half the sensitivity goes from the middle to the top.
+  knob->begin_drag(nano::point<float>(10.0f, 10.0f));
+  knob->drag(nano::point<float>(10.0f, -90.0f));
+  EXPECT_EQ(knob->get_value(), 1.0f);
+  EXPECT_EQ(knob->get_frame_index(), 64);
+  EXPECT_EQ(changed, 1.0f);
+
+  auto slider = std::make_unique<nano::filmstrip_slider>(root.get(), nano::rect<int>(100, 0, 20, 100), asset);
+  slider->drag(nano::point<float>(10.0f, 25.0f));
+  EXPECT_NEAR(slider->get_value(), 0.75f, 1e-6f);
+  EXPECT_EQ(slider->get_value_at(nano::point<float>(10.0f, 200.0f)), 0.0f);
+
+  asset.frame_count = 2;
+  auto toggle = std::make_unique<nano::filmstrip_switch>(root.get(), nano::rect<int>(150, 0, 32, 32), asset);
+  toggle->toggle();
+  EXPECT_TRUE(toggle->is_on());
+  EXPECT_EQ(toggle->get_frame_index(), 1);
+  toggle->set_on(false);
+  EXPECT_EQ(toggle->get_frame_index(), 0);
+
+  comp.reset();
+}
@@ -0,0 +1,93 @@
+#include "nano/test.h"
+#include <nano/ui/compositor.h>
+#include <nano/ui/headless.h>
+#include <nano/ui/level_meter.h>
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+TEST_CASE("nano.ui", level_meter_source) {
+  nano::level_meter_source source(2, 48000.0f, 0.3f);
+
+  std::vector<float> left(480);
+  std::vector<float> right(480, 0.0f);
+  for (std::size_t i = 0; i < left.size(); i++) {
+    left[i] = 0.5f * std::sin(static_cast<float>(i) * 0.2f);
+  }
+
+  const float* channels[2] = { left.data(), right.data() };
+
+  // The peak is kept until the ui takes it.
+  source.process(channels, left.size());
+  source.process(channels, 10);
+  EXPECT_NEAR(source.take_peak(0), 0.5f, 1e-3f);
+  EXPECT_EQ(source.take_peak(0), 0.0f);
+  EXPECT_EQ(source.take_peak(1), 0.0f);
+
+  // The rms converges after a few windows.
+  for (int i = 0; i < 200; i++) {
+    source.process(channels, left.size());
+  }
+
+  EXPECT_NEAR(source.get_rms(0), 0.5f / std::sqrt(2.0f), 0.01f);
+  EXPECT_EQ(source.get_rms(1), 0.0f);
+}
+
+TEST_CASE("nano.ui", level_meter_view) {
+  if (!nano::compositor::can_draw()) {
+    return;
+  }
+
+  auto root = std::make_unique<nano::view>(nano::rect<int>(0, 0, 40, 66));
+  auto source = std::make_shared<nano::level_meter_source>(2, 48000.0f);
+
+  // One point per decibel, from -60 to +6.
+  nano::level_meter_group group;
+  auto meter = std::make_unique<nano::level_meter_view>(root.get(), nano::rect<int>(0, 0, 20, 66), source, group);
+  EXPECT_EQ(group.size(), 1u);
+
+  nano::headless_presenter presenter;
+  auto comp = std::make_unique<nano::compositor>(root.get(), &presenter);
+  comp->commit();
+  comp->flush();
+
+  // Only the rows of the first channel between the bottom and the new level are redrawn.
+  source->set_levels(0, 1.0f, 0.5f);
+  group.update(0.016);
+  comp->commit();
+  comp->flush();
+
+  EXPECT_NEAR(meter->get_level_db(0), 0.0f, 1e-4f);
+  EXPECT_TRUE(presenter.get_last_damage().get_bounds() == nano::rect<int>(0, 6, 9, 60));
+
+  // The bar decays while the hold line stays.
+  group.update(0.1);
+  comp->commit();
+  comp->flush();
+
+  EXPECT_NEAR(meter->get_level_db(0), -2.4f, 1e-4f);
+  EXPECT_NEAR(meter->get_hold_db(0), 0.0f, 1e-4f);
+  EXPECT_TRUE(presenter.get_last_damage().get_bounds() == nano::rect<int>(0, 6, 9, 2));
+
+  // Nothing changes, nothing is redrawn.
+  const std::uint64_t frames = presenter.get_frame_count();
+  source->set_levels(0, 0.0f, 0.5f);
+  meter->update(0.0);
+  comp->commit();
+  comp->flush();
+  EXPECT_EQ(presenter.get_frame_count(), frames);
+
+  // The hold line falls once the hold time has elapsed.
+  for (int i = 0; i < 20; i++) {
+    group.update(0.1);
+  }
+
+  EXPECT_LT(meter->get_hold_db(0), 0.0f);
+  EXPECT_GE(meter->get_hold_db(0), meter->get_level_db(0));
+
+  comp.reset();
+  meter.reset();
+  EXPECT_EQ(group.size(), 0u);
+  root.reset();
+}
@@ -0,0 +1,152 @@
+#include "nano/test.h"
+#include <nano/ui/headless.h>
+#include <nano/ui/menu.h>
+
+#if defined(__linux__)
+#include <nano/ui/run_loop.h>
+#endif
+
+#include <vector>
+
+namespace {
+std::vector<nano::menu_item> make_items() {
+  nano::menu_item play;
+  play.title = "Play";
+  play.command = nano::first_user_command;
+  play.key_equivalent = " ";
+
+  nano::menu_item loop;
+  loop.title = "Loop";
+  loop.command = nano::first_user_command + 1;
+
+  nano::menu_item transport;
+  transport.title = "Transport";
+  transport.items = { play, nano::menu_item::make_separator(), loop };
+
+  std::vector<nano::menu_item> items = nano::menu_model::get_default_items();
+  items.push_back(transport);
+  return items;
+}
+} // namespace.
+
+TEST_CASE("nano.ui", menu_diff) {
+  const std::vector<nano::menu_item> items = make_items();
+  EXPECT_TRUE(nano::diff_menus(items, items).empty());
+
+  // A state change is listed by its index path.
+  std::vector<nano::menu_item> changed = items;
+  changed[2].items[2].checked = true;
+  nano::menu_diff diff = nano::diff_menus(items, changed);
+  EXPECT_FALSE(diff.structure);
+  EXPECT_EQ(diff.changed_items.size(), 1u);
+  EXPECT_TRUE((diff.changed_items[0] == std::vector<std::size_t>{ 2, 2 }));
+  EXPECT_EQ(nano::find_menu_item(changed, diff.changed_items[0])->title, "Loop");
+
+  // Anything else is a change of structure.
+  changed.back().items.pop_back();
+  diff = nano::diff_menus(items, changed);
+  EXPECT_TRUE(diff.structure);
+  EXPECT_TRUE(diff.changed_items.empty());
+
+  changed = items;
+  changed[2].items[0].command = nano::first_user_command + 2;
+  EXPECT_TRUE(nano::diff_menus(items, changed).structure);
+
+  EXPECT_EQ(nano::find_menu_item(items, { 3 }), nullptr);
+}
+
+TEST_CASE("nano.ui", menu_model) {
+  nano::menu_model model;
+  int builds = 0;
+  model.set_builder([&]() {
+    builds++;
+    return make_items();
+  });
+
+  // Built lazily, once.
+  EXPECT_EQ(builds, 0);
+  EXPECT_EQ(model.get_items().size(), 3u);
+  EXPECT_EQ(model.get_items().size(), 3u);
+  EXPECT_EQ(builds, 1);
+  const std::uint64_t version = model.get_version();
+
+  // Built again after an invalidation, the same items are not a change.
+  model.invalidate();
+  EXPECT_EQ(model.get_items().size(), 3u);
+  EXPECT_EQ(builds, 2);
+  EXPECT_EQ(model.get_version(), version);
+
+  // Dispatched by command id.
+  int plays = 0;
+  model.set_action(nano::first_user_command, [&]() { plays++; });
+  EXPECT_TRUE(model.dispatch(nano::first_user_command));
+  EXPECT_FALSE(model.dispatch(nano::first_user_command + 1));
+  EXPECT_EQ(plays, 1);
+
+  EXPECT_TRUE(model.set_enabled(nano::first_user_command, false));
+  EXPECT_FALSE(model.dispatch(nano::first_user_command));
+  EXPECT_EQ(plays, 1);
+  EXPECT_EQ(model.get_version(), version + 1);
+
+  EXPECT_TRUE(model.set_checked(nano::first_user_command + 1, true));
+  EXPECT_TRUE(model.find_item(nano::first_user_command + 1)->checked);
+  EXPECT_FALSE(model.set_checked(nano::first_user_command + 10, true));
+
+  // Commands without an item are always enabled.
+  model.set_action(nano::first_user_command + 10, [&]() { plays++; });
+  EXPECT_TRUE(model.dispatch(nano::first_user_command + 10));
+  EXPECT_EQ(plays, 2);
+  EXPECT_EQ(model.get_stats().dispatched, 2u);
+
+  model.set_action(nano::first_user_command + 10, nullptr);
+  EXPECT_FALSE(model.dispatch(nano::first_user_command + 10));
+}
+
+TEST_CASE("nano.ui", menu_translation) {
+  nano::menu_model model;
+  nano::headless_menu translator;
+  model.set_translator(&translator);
+
+  // Every window asks, the menu is built and translated once.
+  for (int i = 0; i < 50; i++) {
+    model.update_native();
+  }
+
+  EXPECT_EQ(model.get_stats().builds, 1u);
+  EXPECT_EQ(model.get_stats().translations, 1u);
+  EXPECT_EQ(translator.get_rebuild_count(), 1u);
+  EXPECT_EQ(translator.get_items().size(), 2u);
+
+  // A state change updates the item in place.
+  EXPECT_TRUE(model.set_title(nano::new_command, "New Project"));
+  EXPECT_TRUE(model.set_enabled(nano::about_command, false));
+
+#if defined(__linux__)
+  // Posted to the main queue.
+  while (nano::run_loop::get_main().run_once(0)) {
+  }
+#else
+  model.update_native();
+#endif
+
+  EXPECT_EQ(model.get_stats().translations, 2u);
+  EXPECT_EQ(translator.get_rebuild_count(), 1u);
+  EXPECT_EQ(translator.get_updated_item_count(), 2u);
+  EXPECT_EQ(nano::find_menu_item(translator.get_items(), { 1, 0 })->title, "New Project");
+  EXPECT_FALSE(nano::find_menu_item(translator.get_items(), { 0, 0 })->enabled);
+
+  // A new structure rebuilds it.
+  model.set_items(make_items());
+  model.update_native();
+  EXPECT_EQ(translator.get_rebuild_count(), 2u);
+  EXPECT_EQ(translator.get_items().size(), 3u);
+
+  // Setting the same items is not a change.
+  model.set_items(make_items());
+  model.update_native();
+  EXPECT_EQ(model.get_stats().translations, 3u);
+
+#if defined(__linux__)
+  nano::run_loop::get_main().run_once(0);
+#endif
+}
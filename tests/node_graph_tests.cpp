@@ -0,0 +1,142 @@
+#include "nano/test.h"
+#include <nano/ui/compositor.h>
+#include <nano/ui/headless.h>
+#include <nano/ui/node_graph.h>
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+TEST_CASE("nano.ui", spatial_hash) {
+  nano::spatial_hash hash(10.0f);
+  hash.insert(1, nano::rect<float>(2.0f, 2.0f, 4.0f, 4.0f));
+  hash.insert(2, nano::rect<float>(5.0f, 5.0f, 30.0f, 12.0f));
+  hash.insert(3, nano::rect<float>(-15.0f, 40.0f, 4.0f, 4.0f));
+  EXPECT_EQ(hash.get_cell_count(), 9u);
+
+  // An item in many cells is reported once.
+  std::vector<std::uint32_t> ids;
+  hash.query(nano::rect<float>(0.0f, 0.0f, 50.0f, 50.0f), [&](std::uint32_t id, const nano::rect<float>&) {
+    ids.push_back(id);
+  });
+  EXPECT_EQ(ids.size(), 2u);
+
+  ids.clear();
+  hash.query(nano::rect<float>(20.0f, 12.0f, 2.0f, 2.0f), [&](std::uint32_t id, const nano::rect<float>&) {
+    ids.push_back(id);
+  });
+  EXPECT_EQ(ids.size(), 1u);
+  EXPECT_EQ(ids[0], 2u);
+
+  ids.clear();
+  hash.erase(2, nano::rect<float>(5.0f, 5.0f, 30.0f, 12.0f));
+  hash.query(nano::rect<float>(-20.0f, 0.0f, 50.0f, 50.0f), [&](std::uint32_t id, const nano::rect<float>&) {
+    ids.push_back(id);
+  });
+  EXPECT_EQ(ids.size(), 2u);
+  EXPECT_EQ(hash.get_cell_count(), 2u);
+}
+
+TEST_CASE("nano.ui", node_graph) {
+  nano::node_graph graph(64.0f);
+  const nano::node_id a = graph.add_node(nano::rect<float>(0.0f, 0.0f, 100.0f, 60.0f), 1, 2);
+  const nano::node_id b = graph.add_node(nano::rect<float>(300.0f, 200.0f, 100.0f, 60.0f), 2, 1);
+  EXPECT_EQ(graph.get_node_count(), 2u);
+
+  EXPECT_EQ(graph.connect(a, 2, b, 0), nano::invalid_wire_id);
+  const nano::wire_id w = graph.connect(a, 1, b, 1);
+  EXPECT_EQ(graph.get_wire_count(), 1u);
+
+  // The bounds of the s-shaped curve are the ones of its ends.
+  const nano::graph_wire* wire = graph.find_wire(w);
+  EXPECT_EQ(wire->points[0].x, 100.0f);
+  EXPECT_EQ(wire->points[0].y, 32.0f);
+  EXPECT_EQ(wire->points[3].y, 232.0f);
+  EXPECT_NEAR(wire->bounds.x, 100.0f, 1e-3f);
+  EXPECT_NEAR(wire->bounds.width, 200.0f, 1e-3f);
+  EXPECT_NEAR(wire->bounds.height, 200.0f, 1e-3f);
+
+  // Backwards, the curve goes beyond its ends.
+  graph.move_node(b, nano::point<float>(-200.0f, 200.0f));
+  EXPECT_LT(wire->bounds.x, -200.0f);
+  EXPECT_GT(wire->bounds.x + wire->bounds.width, 100.0f);
+  graph.move_node(b, nano::point<float>(300.0f, 200.0f));
+
+  EXPECT_EQ(graph.hit_test_node(nano::point<float>(50.0f, 30.0f)), a);
+  EXPECT_EQ(graph.hit_test_node(nano::point<float>(150.0f, 30.0f)), nano::invalid_node_id);
+  EXPECT_EQ(graph.hit_test_wire(nano::point<float>(200.0f, 133.0f), 4.0f), w);
+  EXPECT_EQ(graph.hit_test_wire(nano::point<float>(200.0f, 60.0f), 4.0f), nano::invalid_wire_id);
+  EXPECT_NEAR(nano::get_distance(*wire, nano::point<float>(100.0f, 22.0f)), 10.0f, 1e-3f);
+
+  // The node on top is the last one added.
+  const nano::node_id c = graph.add_node(nano::rect<float>(50.0f, 20.0f, 40.0f, 40.0f), 1, 1);
+  EXPECT_EQ(graph.hit_test_node(nano::point<float>(60.0f, 30.0f)), c);
+
+  // Removing a node removes its wires, the ids are reused.
+  EXPECT_TRUE(graph.remove_node(b));
+  EXPECT_EQ(graph.get_wire_count(), 0u);
+  EXPECT_TRUE(graph.get_node_wires(a).empty());
+  EXPECT_EQ(graph.hit_test_wire(nano::point<float>(200.0f, 133.0f), 4.0f), nano::invalid_wire_id);
+  EXPECT_EQ(graph.add_node(nano::rect<float>(0.0f, 0.0f, 10.0f, 10.0f), 1, 1), b);
+}
+
+TEST_CASE("nano.ui", node_graph_view) {
+  if (!nano::compositor::can_draw()) {
+    return;
+  }
+
+  auto graph = std::make_shared<nano::node_graph>();
+  const nano::node_id a = graph->add_node(nano::rect<float>(20.0f, 20.0f, 60.0f, 40.0f), 1, 1);
+  const nano::node_id b = graph->add_node(nano::rect<float>(300.0f, 100.0f, 60.0f, 40.0f), 1, 1);
+  const nano::node_id c = graph->add_node(nano::rect<float>(20.0f, 300.0f, 60.0f, 40.0f), 1, 1);
+  const nano::node_id d = graph->add_node(nano::rect<float>(300.0f, 340.0f, 60.0f, 40.0f), 1, 1);
+  const nano::wire_id w = graph->connect(a, 0, b, 0);
+  graph->connect(c, 0, d, 0);
+
+  auto root = std::make_unique<nano::view>(nano::rect<int>(0, 0, 400, 400));
+  auto view = std::make_unique<nano::node_graph_view>(root.get(), nano::rect<int>(0, 0, 400, 400));
+  view->set_graph(graph);
+
+  nano::headless_presenter presenter;
+  auto comp = std::make_unique<nano::compositor>(root.get(), &presenter);
+  comp->commit();
+  comp->flush();
+
+  // Hovering a cable only redraws its bounds.
+  const nano::graph_wire* wire = graph->find_wire(w);
+  const nano::point<float> middle(190.0f, 76.0f);
+  EXPECT_LT(nano::get_distance(*wire, middle), 4.0f);
+  view->hover(middle);
+  EXPECT_EQ(view->get_hovered_wire(), w);
+  comp->commit();
+  comp->flush();
+  EXPECT_TRUE(presenter.get_last_damage().get_bounds() == nano::rect<int>(78, 34, 224, 84));
+
+  view->hover(nano::point<float>(50.0f, 40.0f));
+  EXPECT_EQ(view->get_hovered_wire(), nano::invalid_wire_id);
+
+  // Dragging a node redraws its rects and its wire, not the other nodes.
+  comp->commit();
+  comp->flush();
+  EXPECT_TRUE(view->begin_drag(nano::point<float>(310.0f, 110.0f)));
+  EXPECT_EQ(view->get_dragged_node(), b);
+  view->drag(nano::point<float>(310.0f, 130.0f));
+  view->end_drag();
+  comp->commit();
+  comp->flush();
+
+  EXPECT_EQ(graph->find_node(b)->rect.y, 120.0f);
+  const nano::rect<int> damage = presenter.get_last_damage().get_bounds();
+  EXPECT_EQ(damage.x, 78);
+  EXPECT_EQ(damage.y, 34);
+  EXPECT_EQ(damage.x + damage.width, 365);
+  EXPECT_EQ(damage.y + damage.height, 165);
+
+  // The node and the wire are not repainted as one box.
+  EXPECT_GT(presenter.get_last_damage().get_rects().size(), 1u);
+  EXPECT_LT(presenter.get_last_damage().get_area(), static_cast<std::size_t>(damage.width * damage.height));
+
+  EXPECT_FALSE(view->begin_drag(nano::point<float>(200.0f, 250.0f)));
+
+  comp.reset();
+}
@@ -0,0 +1,79 @@
+#include "nano/test.h"
+#include <nano/ui/oscilloscope_capture.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace {
+constexpr double pi = 3.14159265358979323846;
+
+/// a sine with a period of 100 frames, crossing zero upward between the frames 99 and 100.
+std::vector<float> make_sine(std::size_t count, float amplitude) {
+  std::vector<float> samples(count);
+  for (std::size_t i = 0; i < count; i++) {
+    samples[i] = amplitude * static_cast<float>(std::sin(2.0 * pi * (static_cast<double>(i) + 0.5) / 100.0));
+  }
+
+  return samples;
+}
+} // namespace.
+
+TEST_CASE("nano.ui", oscilloscope_trigger) {
+  const std::vector<float> sine = make_sine(4000, 1.0f);
+  const std::vector<float> inverted = make_sine(4000, -1.0f);
+  const float* channels[2] = { sine.data(), inverted.data() };
+
+  // The rising edge of the sine and the falling edge of its inverse are at the same frames.
+  for (int channel = 0; channel < 2; channel++) {
+    nano::oscilloscope_capture::options opts;
+    opts.window_size = 256;
+    opts.point_count = 64;
+    opts.channel_count = 2;
+    opts.trigger_channel = channel;
+    opts.edge = channel == 0 ? nano::oscilloscope_capture::trigger_edge::rising
+                             : nano::oscilloscope_capture::trigger_edge::falling;
+    nano::oscilloscope_capture capture(opts);
+
+    EXPECT_FALSE(capture.update());
+    capture.push(channels, 1000);
+    EXPECT_TRUE(capture.update());
+    EXPECT_TRUE(capture.poll());
+    EXPECT_FALSE(capture.poll());
+
+    // At the frames 100, 300, 500, 700 and 900: the edges within a window are ignored.
+    EXPECT_EQ(capture.get_trigger_count(), 5u);
+
+    // The trigger is a quarter of the window in: the points before it are below zero.
+    const nano::oscilloscope_capture::frame& f = capture.get_frame();
+    EXPECT_TRUE(f.triggered);
+    EXPECT_LT(f.max[15], 0.0f);
+    EXPECT_LT(f.min[16], 0.0f);
+    EXPECT_GT(f.max[16], 0.0f);
+    EXPECT_NEAR(f.min[64 + 16], -f.max[16], 1e-6f);
+
+    // The decimated points keep the peaks.
+    EXPECT_NEAR(*std::max_element(f.max.begin(), f.max.begin() + 64), 1.0f, 1e-3f);
+  }
+}
+
+TEST_CASE("nano.ui", oscilloscope_auto) {
+  nano::oscilloscope_capture::options opts;
+  opts.window_size = 256;
+  opts.point_count = 64;
+  opts.auto_time = 0.05f;
+  nano::oscilloscope_capture capture(opts);
+
+  // Silence never triggers, the window is shown untriggered after the auto time.
+  const std::vector<float> silence(1000, 0.0f);
+  const float* channels[1] = { silence.data() };
+  capture.push(channels, silence.size());
+  EXPECT_FALSE(capture.update());
+
+  capture.push(channels, silence.size());
+  capture.push(channels, silence.size());
+  EXPECT_TRUE(capture.update());
+  EXPECT_TRUE(capture.poll());
+  EXPECT_FALSE(capture.get_frame().triggered);
+  EXPECT_EQ(capture.get_trigger_count(), 0u);
+}
@@ -0,0 +1,78 @@
+#include "nano/test.h"
+#include <nano/ui/path_cache.h>
+
+#include <cmath>
+
+namespace {
+constexpr double pi = 3.14159265358979323846;
+
+double get_coverage_area(const nano::flattened_path& path) {
+  double area = 0;
+  for (const nano::coverage_span& span : path.spans) {
+    area += span.length * span.coverage / 255.0;
+  }
+  return area;
+}
+} // namespace.
+
+TEST_CASE("nano.ui", path_flatten) {
+  nano::path_geometry rect;
+  rect.add_rect(nano::rect<float>(2.5f, 2.0f, 10.0f, 4.0f));
+
+  const nano::flattened_path flat_rect = nano::flatten(rect, 1.0f);
+  EXPECT_EQ(flat_rect.contours.size(), 1);
+  EXPECT_NEAR(get_coverage_area(flat_rect), 40.0, 0.5);
+
+  nano::path_geometry circle;
+  circle.add_ellipse(nano::rect<float>(0.0f, 0.0f, 20.0f, 20.0f));
+
+  // The polylines are inscribed in the curves, at most 0.25 pixel inside.
+  const double area = get_coverage_area(nano::flatten(circle, 1.0f));
+  EXPECT_LE(area, 100.0 * pi);
+  EXPECT_GE(area, 100.0 * pi - 20.0 * pi * 0.25);
+
+  const double scaled_area = get_coverage_area(nano::flatten(circle, 2.0f));
+  EXPECT_LE(scaled_area, 400.0 * pi);
+  EXPECT_GE(scaled_area, 400.0 * pi - 40.0 * pi * 0.25);
+
+  nano::pixel_buffer buffer(32, 32);
+  nano::fill(buffer, nano::flatten(circle, 1.0f), nano::point<int>(6, 6), nano::make_pixel(255, 0, 0, 255));
+  EXPECT_EQ(buffer.get_pixel(16, 16), nano::make_pixel(255, 0, 0, 255));
+  EXPECT_EQ(buffer.get_pixel(6, 6), 0);
+}
+
+TEST_CASE("nano.ui", path_cache) {
+  nano::path_cache cache;
+
+  nano::path_geometry arc;
+  arc.add_arc_stroke(nano::point<float>(20.0f, 20.0f), 16.0f, 2.4f, 5.5f, 3.0f);
+
+  nano::path_geometry same_arc;
+  same_arc.add_arc_stroke(nano::point<float>(20.0f, 20.0f), 16.0f, 2.4f, 5.5f, 3.0f);
+  EXPECT_TRUE(arc == same_arc);
+  EXPECT_EQ(arc.get_hash(), same_arc.get_hash());
+
+  const auto a = cache.get(arc, 1.0f);
+  const auto b = cache.get(same_arc, 1.0f);
+  const auto c = cache.get(arc, 2.0f);
+  EXPECT_EQ(a, b);
+  EXPECT_NE(a, c);
+
+  nano::path_cache::stats stats = cache.get_stats();
+  EXPECT_EQ(stats.hits, 1);
+  EXPECT_EQ(stats.misses, 2);
+  EXPECT_EQ(stats.entry_count, 2);
+  EXPECT_EQ(stats.byte_size, a->get_byte_size() + c->get_byte_size());
+
+  // Touching the first entry makes the second one the least recently used.
+  cache.get(arc, 1.0f);
+  cache.set_capacity(a->get_byte_size());
+
+  stats = cache.get_stats();
+  EXPECT_EQ(stats.evictions, 1);
+  EXPECT_EQ(stats.entry_count, 1);
+  EXPECT_EQ(cache.get(arc, 1.0f), a);
+
+  cache.clear();
+  EXPECT_EQ(cache.get_stats().byte_size, 0);
+}
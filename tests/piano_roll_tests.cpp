@@ -0,0 +1,222 @@
+#include "nano/test.h"
+#include <nano/ui/compositor.h>
+#include <nano/ui/headless.h>
+#include <nano/ui/piano_roll.h>
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+
+TEST_CASE("nano.ui", note_index) {
+  nano::note_index notes;
+  std::vector<nano::note_id> ids;
+
+  // Many notes on a few pitches, with one long note per pitch.
+  std::mt19937 rng(1);
+  std::uniform_real_distribution<double> start(0.0, 1000.0);
+  std::uniform_int_distribution<int> pitch(60, 63);
+
+  for (int i = 0; i < 5000; i++) {
+    ids.push_back(notes.insert(start(rng), 0.5, static_cast<std::uint8_t>(pitch(rng))));
+  }
+
+  for (int p = 60; p < 64; p++) {
+    ids.push_back(notes.insert(10.0 * p, 100.0, static_cast<std::uint8_t>(p)));
+  }
+
+  EXPECT_EQ(notes.size(), 5004u);
+
+  // Moves and removals keep the notes reachable by id.
+  for (std::size_t i = 0; i < 1000; i++) {
+    EXPECT_TRUE(notes.move(ids[i], start(rng), static_cast<std::uint8_t>(pitch(rng))));
+  }
+
+  for (std::size_t i = 1000; i < 2000; i++) {
+    EXPECT_TRUE(notes.erase(ids[i]));
+  }
+
+  EXPECT_FALSE(notes.erase(ids[1000]));
+  EXPECT_TRUE(notes.find(ids[1000]) == nullptr);
+  EXPECT_EQ(notes.size(), 4004u);
+
+  std::size_t found = 0;
+  for (std::size_t i = 0; i < ids.size(); i++) {
+    const nano::piano_note* n = notes.find(ids[i]);
+    found += n && n->id == ids[i] ? 1 : 0;
+  }
+
+  EXPECT_EQ(found, 4004u);
+
+  // A query returns the same notes as a scan, including the long notes starting before it.
+  std::vector<nano::note_id> expected;
+  for (nano::note_id id : ids) {
+    const nano::piano_note* n = notes.find(id);
+    if (n && n->pitch >= 61 && n->pitch <= 62 && n->start < 660.0 && n->get_end() > 650.0) {
+      expected.push_back(id);
+    }
+  }
+
+  std::vector<nano::note_id> result;
+  notes.query(650.0, 660.0, 61, 62, [&](const nano::piano_note& n) { result.push_back(n.id); });
+
+  std::sort(expected.begin(), expected.end());
+  std::sort(result.begin(), result.end());
+  EXPECT_TRUE(result == expected);
+  EXPECT_TRUE(std::find(result.begin(), result.end(), ids[5001]) != result.end());
+
+  // Removing the long notes shortens the search of their pitch.
+  for (std::size_t i = 5000; i < 5004; i++) {
+    EXPECT_TRUE(notes.erase(ids[i]));
+  }
+
+  result.clear();
+  notes.query(650.0, 660.0, 61, 62, [&](const nano::piano_note& n) { result.push_back(n.id); });
+  EXPECT_EQ(result.size(), expected.size() - 2);
+}
+
+TEST_CASE("nano.ui", note_index_fresh_lane) {
+  nano::note_index notes;
+
+  // The first note of a pitch creates its lane.
+  const nano::note_id a = notes.insert(4.0, 1.0, 70);
+  EXPECT_EQ(notes.size(), 1u);
+  EXPECT_TRUE(notes.find(a) != nullptr);
+
+  // A lane emptied by erasing or moving its notes takes new ones.
+  EXPECT_TRUE(notes.erase(a));
+  const nano::note_id b = notes.insert(2.0, 1.0, 70);
+  EXPECT_TRUE(notes.move(b, 3.0, 71));
+  const nano::note_id c = notes.insert(1.0, 0.5, 70);
+  EXPECT_EQ(notes.size(), 2u);
+
+  std::vector<nano::note_id> result;
+  notes.query(0.0, 10.0, 70, 71, [&](const nano::piano_note& n) { result.push_back(n.id); });
+  std::sort(result.begin(), result.end());
+  std::vector<nano::note_id> expected = { b, c };
+  std::sort(expected.begin(), expected.end());
+  EXPECT_TRUE(result == expected);
+}
+
+TEST_CASE("nano.ui", note_index_long_notes) {
+  nano::note_index notes;
+  std::vector<nano::note_id> ids;
+
+  // Enough notes on one pitch for many chunks, a few of them long.
+  std::mt19937 rng(2);
+  std::uniform_real_distribution<double> start(0.0, 10000.0);
+
+  for (int i = 0; i < 20000; i++) {
+    const double length = i % 2000 == 0 ? 500.0 + static_cast<double>(i) / 10.0 : 0.5;
+    ids.push_back(notes.insert(start(rng), length, 60));
+  }
+
+  const auto check = [&]() {
+    for (int i = 0; i < 50; i++) {
+      const double from = start(rng);
+      const double to = from + 20.0;
+
+      std::vector<nano::note_id> expected;
+      for (nano::note_id id : ids) {
+        const nano::piano_note* n = notes.find(id);
+        if (n && n->start < to && n->get_end() > from) {
+          expected.push_back(id);
+        }
+      }
+
+      // The ids of erased notes are reused.
+      std::sort(expected.begin(), expected.end());
+      expected.erase(std::unique(expected.begin(), expected.end()), expected.end());
+
+      std::vector<nano::note_id> result;
+      notes.query(from, to, 60, 60, [&](const nano::piano_note& n) { result.push_back(n.id); });
+
+      std::sort(result.begin(), result.end());
+      EXPECT_TRUE(result == expected);
+    }
+  };
+
+  check();
+
+  // The long notes moved, then erased with most of the others so that chunks merge.
+  for (std::size_t i = 0; i < ids.size(); i += 2000) {
+    EXPECT_TRUE(notes.move(ids[i], start(rng), 60));
+  }
+
+  check();
+
+  for (std::size_t i = 0; i < ids.size(); i++) {
+    if (i % 2000 == 0 || i % 3 != 0) {
+      EXPECT_TRUE(notes.erase(ids[i]));
+    }
+  }
+
+  check();
+
+  for (int i = 0; i < 5000; i++) {
+    ids.push_back(notes.insert(start(rng), 0.5, 60));
+  }
+
+  check();
+}
+
+TEST_CASE("nano.ui", piano_roll_view) {
+  if (!nano::compositor::can_draw()) {
+    return;
+  }
+
+  auto root = std::make_unique<nano::view>(nano::rect<int>(0, 0, 400, 1280));
+  auto roll = std::make_unique<nano::piano_roll_view>(root.get(), nano::rect<int>(0, 0, 400, 1280));
+  auto notes = std::make_shared<nano::note_index>();
+
+  // One point per time unit, 10 points per pitch: the pitch 60 is drawn from y 670 to 680.
+  const nano::note_id a = notes->insert(10.0, 20.0, 60);
+  const nano::note_id b = notes->insert(40.0, 20.0, 62);
+  const nano::note_id c = notes->insert(200.0, 20.0, 60);
+  roll->set_notes(notes);
+  roll->set_scale(1.0, 10.0f);
+
+  nano::headless_presenter presenter;
+  auto comp = std::make_unique<nano::compositor>(root.get(), &presenter);
+  comp->commit();
+  comp->flush();
+
+  EXPECT_EQ(roll->hit_test(nano::point<float>(15.0f, 675.0f)), a);
+  EXPECT_EQ(roll->hit_test(nano::point<float>(35.0f, 675.0f)), nano::invalid_note_id);
+
+  // The marquee selects the notes it overlaps.
+  roll->begin_marquee(nano::point<float>(5.0f, 650.0f));
+  roll->drag_marquee(nano::point<float>(100.0f, 679.0f));
+  roll->end_marquee();
+
+  EXPECT_EQ(roll->get_selection().size(), 2u);
+  EXPECT_TRUE(notes->find(a)->selected);
+  EXPECT_TRUE(notes->find(b)->selected);
+  EXPECT_FALSE(notes->find(c)->selected);
+
+  comp->commit();
+  comp->flush();
+
+  // Moving the selection redraws its old and new bounds only.
+  EXPECT_TRUE(roll->begin_move(nano::point<float>(45.0f, 655.0f)));
+  roll->drag_move(nano::point<float>(55.0f, 645.0f));
+  roll->end_move();
+  comp->commit();
+  comp->flush();
+
+  EXPECT_NEAR(notes->find(a)->start, 20.0, 1e-9);
+  EXPECT_EQ(notes->find(a)->pitch, 61);
+  EXPECT_EQ(notes->find(b)->pitch, 63);
+  EXPECT_EQ(notes->find(c)->pitch, 60);
+  EXPECT_TRUE(presenter.get_last_damage().get_bounds() == nano::rect<int>(10, 640, 60, 40));
+
+  // Clicking an unselected note selects only it.
+  EXPECT_TRUE(roll->begin_move(nano::point<float>(205.0f, 675.0f)));
+  roll->end_move();
+  EXPECT_EQ(roll->get_selection().size(), 1u);
+  EXPECT_FALSE(notes->find(a)->selected);
+
+  comp.reset();
+  roll.reset();
+  root.reset();
+}
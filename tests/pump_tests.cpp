@@ -0,0 +1,171 @@
+#include "nano/test.h"
+#include <nano/ui/compositor.h>
+#include <nano/ui/headless.h>
+#include <nano/ui/run_loop.h>
+
+#if defined(__linux__)
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <poll.h>
+#include <vector>
+
+namespace {
+/// plays a plugin host: it has its own loop and only gives the ui time from
+/// its idle callback, waiting on the main loop's file descriptor in between.
+class fake_host {
+public:
+  fake_host(std::chrono::microseconds budget)
+      : m_budget(budget) {}
+
+  /// one idle callback of the host.
+  nano::pump_result idle() { return nano::pump(m_budget); }
+
+  /// runs the host's loop until there is nothing left to do or the timeout.
+  void run(int timeout_ms) {
+    const auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+
+    while (std::chrono::steady_clock::now() < end) {
+      const nano::pump_result result = idle();
+      if (result.has_pending_work()) {
+        continue;
+      }
+
+      // Sleeps until the loop has work or the next timer, like a host timer would.
+      const int remaining = static_cast<int>(
+          std::chrono::duration_cast<std::chrono::milliseconds>(end - std::chrono::steady_clock::now()).count());
+      const int wait_ms = result.next_timer_ms < 0 ? remaining : std::min(result.next_timer_ms, remaining);
+
+      pollfd fd = { nano::run_loop::get_main().get_file_descriptor(), POLLIN, 0 };
+      if (poll(&fd, 1, std::max(wait_ms, 0)) == 0 && result.next_timer_ms < 0) {
+        return;
+      }
+    }
+  }
+
+private:
+  std::chrono::microseconds m_budget;
+};
+
+/// dispatches what the previous tests left in the main queue.
+void drain_main_queue() {
+  while (nano::pump(std::chrono::milliseconds(100)).pending_messages) {
+  }
+}
+
+class ticking_timer : public nano::timer {
+public:
+  int count = 0;
+
+protected:
+  virtual void on_timer() override { count++; }
+};
+} // namespace.
+
+TEST_CASE("nano.ui", pump_messages) {
+  drain_main_queue();
+  fake_host host(std::chrono::microseconds(0));
+
+  // Nothing to do.
+  nano::pump_result result = host.idle();
+  EXPECT_EQ(result.dispatched, 0u);
+  EXPECT_FALSE(result.has_pending_work());
+
+  // Without budget, one message per pump and the rest is reported.
+  std::vector<int> order;
+  for (int i = 0; i < 3; i++) {
+    nano::post_message([&order, i]() { order.push_back(i); });
+  }
+
+  result = host.idle();
+  EXPECT_EQ(result.dispatched, 1u);
+  EXPECT_EQ(result.pending_messages, 2u);
+  EXPECT_TRUE(result.has_pending_work());
+
+  // Posted during a pump, left for the next one after the ones already queued.
+  nano::post_message([&order]() {
+    order.push_back(3);
+    nano::post_message([&order]() { order.push_back(4); });
+  });
+
+  fake_host patient(std::chrono::milliseconds(100));
+  result = patient.idle();
+  EXPECT_EQ(result.dispatched, 3u);
+  EXPECT_EQ(result.pending_messages, 1u);
+
+  result = patient.idle();
+  EXPECT_EQ(result.dispatched, 1u);
+  EXPECT_EQ(result.pending_messages, 0u);
+  EXPECT_TRUE((order == std::vector<int>{ 0, 1, 2, 3, 4 }));
+
+  // The messages left by a pump still wake the loop.
+  nano::post_message([]() {});
+  nano::post_message([]() {});
+  EXPECT_EQ(host.idle().pending_messages, 1u);
+  EXPECT_EQ(nano::run_loop::get_main().run_once(1000), 1u);
+}
+
+TEST_CASE("nano.ui", pump_timers) {
+  fake_host host(std::chrono::milliseconds(1));
+
+  ticking_timer t;
+  t.start(5);
+
+  const nano::pump_result result = host.idle();
+  EXPECT_GE(result.next_timer_ms, 0);
+  EXPECT_LE(result.next_timer_ms, 5);
+
+  // The host sleeps until the timer is due.
+  const auto start = std::chrono::steady_clock::now();
+  while (t.count < 3) {
+    host.run(100);
+  }
+
+  EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(10));
+  t.stop();
+  EXPECT_EQ(host.idle().next_timer_ms, -1);
+}
+
+TEST_CASE("nano.ui", pump_frames) {
+  if (!nano::compositor::can_draw()) {
+    return;
+  }
+
+  drain_main_queue();
+  fake_host host(std::chrono::milliseconds(5));
+
+  nano::view root(nano::rect<int>(0, 0, 32, 32));
+  nano::view child(&root, nano::rect<int>(4, 4, 8, 8));
+
+  nano::headless_presenter presenter;
+  auto comp = std::make_unique<nano::compositor>(&root, &presenter);
+  comp->commit();
+  comp->flush();
+
+  // The commit posted by the attachment.
+  host.idle();
+  const std::uint64_t commits = comp->get_stats().commits;
+
+  // Invalidations coalesce into one commit.
+  child.redraw();
+  root.redraw();
+  child.redraw();
+  EXPECT_EQ(host.idle().dispatched, 1u);
+  EXPECT_EQ(comp->get_stats().commits, commits + 1);
+
+  // A redraw from a message of the pump is the next frame.
+  nano::post_message([&child]() { child.redraw(); });
+  nano::pump_result result = host.idle();
+  EXPECT_EQ(comp->get_stats().commits, commits + 1);
+  EXPECT_EQ(result.pending_messages, 1u);
+
+  result = host.idle();
+  EXPECT_EQ(comp->get_stats().commits, commits + 2);
+  EXPECT_FALSE(result.has_pending_work());
+
+  comp->flush();
+  comp.reset();
+}
+
+#endif
@@ -0,0 +1,107 @@
+#include "nano/test.h"
+#include "realtime_checks.h"
+#include <nano/ui/oscilloscope_capture.h>
+
+#if defined(__linux__)
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+constexpr double pi = 3.14159265358979323846;
+
+/// a sine with a period of 100 frames.
+std::vector<float> make_sine(std::size_t count, float amplitude) {
+  std::vector<float> samples(count);
+  for (std::size_t i = 0; i < count; i++) {
+    samples[i] = amplitude * static_cast<float>(std::sin(2.0 * pi * (static_cast<double>(i) + 0.5) / 100.0));
+  }
+
+  return samples;
+}
+} // namespace.
+
+TEST_CASE("nano.ui", realtime_checks) {
+  // The checks see what they are meant to catch.
+  std::mutex m;
+  {
+    realtime::scope scope;
+    auto p = std::make_unique<double>(1.0);
+    auto aligned = std::make_unique<std::max_align_t[]>(4);
+    std::scoped_lock<std::mutex> lock(m);
+    std::this_thread::sleep_for(std::chrono::microseconds(10));
+  }
+
+  EXPECT_EQ(realtime::allocations.load(), 2);
+  EXPECT_EQ(realtime::blocking_calls.load(), 2);
+
+  struct alignas(64) cache_line {
+    float values[16];
+  };
+
+  {
+    realtime::scope scope;
+    auto line = std::make_unique<cache_line>();
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(line.get()) % 64, 0u);
+  }
+
+  EXPECT_EQ(realtime::allocations.load(), 3);
+
+  // Outside of a scope nothing is counted.
+  std::scoped_lock<std::mutex> lock(m);
+  std::vector<int> v(10);
+  EXPECT_EQ(realtime::allocations.load(), 3);
+  EXPECT_EQ(realtime::blocking_calls.load(), 2);
+}
+
+TEST_CASE("nano.ui", oscilloscope_realtime) {
+  nano::oscilloscope_capture::options opts;
+  opts.window_size = 1024;
+  opts.point_count = 256;
+  auto capture = std::make_unique<nano::oscilloscope_capture>(opts);
+  capture->start();
+
+  const std::vector<float> sine = make_sine(64 * 100, 0.5f);
+  const int allocations = realtime::allocations.load();
+  const int blocking_calls = realtime::blocking_calls.load();
+
+  // An audio thread pushing blocks of 64 frames while the worker runs, the sleeps are the time between callbacks.
+  std::thread audio([&] {
+    for (int i = 0; i < 2000; i++) {
+      const float* channels[1] = { sine.data() + static_cast<std::size_t>(i % 100) * 64 };
+
+      {
+        realtime::scope scope;
+        capture->push(channels, 64);
+      }
+
+      if (i % 16 == 0) {
+        std::this_thread::sleep_for(std::chrono::microseconds(500));
+      }
+    }
+
+    // The ring is full while the worker is late: push drops the frames and returns.
+    realtime::scope scope;
+    const float* channels[1] = { sine.data() };
+    for (int i = 0; i < 1000; i++) {
+      capture->push(channels, sine.size());
+    }
+  });
+
+  audio.join();
+  capture->stop();
+
+  EXPECT_EQ(realtime::allocations.load(), allocations);
+  EXPECT_EQ(realtime::blocking_calls.load(), blocking_calls);
+  EXPECT_GT(capture->get_dropped_count(), 0u);
+  EXPECT_GT(capture->get_trigger_count(), 0u);
+  EXPECT_TRUE(capture->poll());
+  EXPECT_TRUE(capture->get_frame().triggered);
+}
+
+#endif // __linux__.
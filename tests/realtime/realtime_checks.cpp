@@ -0,0 +1,149 @@
+#include "realtime_checks.h"
+
+#if defined(__linux__)
+
+#include <cstddef>
+#include <cstdlib>
+#include <dlfcn.h>
+#include <new>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace realtime {
+std::atomic<int> allocations = 0;
+std::atomic<int> blocking_calls = 0;
+} // namespace realtime.
+
+namespace {
+thread_local bool is_realtime = false;
+
+void* allocate(std::size_t size, std::size_t alignment) noexcept {
+  if (is_realtime) {
+    realtime::allocations++;
+  }
+
+  size = size ? size : 1;
+  if (alignment <= alignof(std::max_align_t)) {
+    return std::malloc(size);
+  }
+
+  void* p = nullptr;
+  return posix_memalign(&p, alignment, size) == 0 ? p : nullptr;
+}
+
+void* allocate_or_throw(std::size_t size, std::size_t alignment) {
+  if (void* p = allocate(size, alignment)) {
+    return p;
+  }
+
+  throw std::bad_alloc();
+}
+
+/// the libc function replaced by the one of the same name below.
+template <class Fn>
+Fn get_next(const char* name) noexcept {
+  return reinterpret_cast<Fn>(dlsym(RTLD_NEXT, name));
+}
+
+void count_blocking_call() noexcept {
+  if (is_realtime) {
+    realtime::blocking_calls++;
+  }
+}
+} // namespace.
+
+realtime::scope::scope() noexcept { is_realtime = true; }
+
+realtime::scope::~scope() noexcept { is_realtime = false; }
+
+void* operator new(std::size_t size) { return allocate_or_throw(size, 0); }
+
+void* operator new[](std::size_t size) { return allocate_or_throw(size, 0); }
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return allocate(size, 0); }
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return allocate(size, 0); }
+
+void* operator new(std::size_t size, std::align_val_t al) {
+  return allocate_or_throw(size, static_cast<std::size_t>(al));
+}
+
+void* operator new[](std::size_t size, std::align_val_t al) {
+  return allocate_or_throw(size, static_cast<std::size_t>(al));
+}
+
+void* operator new(std::size_t size, std::align_val_t al, const std::nothrow_t&) noexcept {
+  return allocate(size, static_cast<std::size_t>(al));
+}
+
+void* operator new[](std::size_t size, std::align_val_t al, const std::nothrow_t&) noexcept {
+  return allocate(size, static_cast<std::size_t>(al));
+}
+
+// posix_memalign() memory is also released by free().
+void operator delete(void* p) noexcept { std::free(p); }
+
+void operator delete[](void* p) noexcept { std::free(p); }
+
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { std::free(p); }
+
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { std::free(p); }
+
+// The calls that can wait on another thread or sleep. The condition variables
+// wait on a mutex, which is locked first.
+extern "C" {
+int pthread_mutex_lock(pthread_mutex_t* m) {
+  count_blocking_call();
+  static const auto next = get_next<int (*)(pthread_mutex_t*)>("pthread_mutex_lock");
+  return next(m);
+}
+
+int pthread_rwlock_rdlock(pthread_rwlock_t* l) {
+  count_blocking_call();
+  static const auto next = get_next<int (*)(pthread_rwlock_t*)>("pthread_rwlock_rdlock");
+  return next(l);
+}
+
+int pthread_rwlock_wrlock(pthread_rwlock_t* l) {
+  count_blocking_call();
+  static const auto next = get_next<int (*)(pthread_rwlock_t*)>("pthread_rwlock_wrlock");
+  return next(l);
+}
+
+int nanosleep(const timespec* duration, timespec* remaining) {
+  count_blocking_call();
+  static const auto next = get_next<int (*)(const timespec*, timespec*)>("nanosleep");
+  return next(duration, remaining);
+}
+
+int clock_nanosleep(clockid_t clock, int flags, const timespec* duration, timespec* remaining) {
+  count_blocking_call();
+  static const auto next = get_next<int (*)(clockid_t, int, const timespec*, timespec*)>("clock_nanosleep");
+  return next(clock, flags, duration, remaining);
+}
+
+int usleep(useconds_t usec) {
+  count_blocking_call();
+  static const auto next = get_next<int (*)(useconds_t)>("usleep");
+  return next(usec);
+}
+} // extern "C".
+
+#endif // __linux__.
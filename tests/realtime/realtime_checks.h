@@ -0,0 +1,26 @@
+#pragma once
+
+#include <atomic>
+
+// Counts the allocations and the blocking calls made in a realtime scope, by
+// replacing the global operator new and the pthread functions that can wait.
+// They are replaced for the whole executable, which is why these tests are
+// their own target.
+#if defined(__linux__)
+
+namespace realtime {
+extern std::atomic<int> allocations;
+extern std::atomic<int> blocking_calls;
+
+/// marks the calls of a thread that must never allocate or block.
+class scope {
+public:
+  scope() noexcept;
+  ~scope() noexcept;
+
+  scope(const scope&) = delete;
+  scope& operator=(const scope&) = delete;
+};
+} // namespace realtime.
+
+#endif // __linux__.
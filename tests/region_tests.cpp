@@ -0,0 +1,41 @@
+#include "nano/test.h"
+#include <nano/ui/region.h>
+
+TEST_CASE("nano.ui", region_merge) {
+  nano::region r;
+  r.add(nano::rect<int>(0, 0, 10, 10));
+
+  // Inside, nothing changes.
+  r.add(nano::rect<int>(2, 2, 4, 4));
+  EXPECT_EQ(r.get_rects().size(), 1u);
+
+  // Side by side or overlapping along an edge, merged.
+  r.add(nano::rect<int>(10, 0, 10, 10));
+  r.add(nano::rect<int>(0, 8, 20, 4));
+  EXPECT_EQ(r.get_rects().size(), 1u);
+  EXPECT_TRUE(r.get_bounds() == nano::rect<int>(0, 0, 20, 12));
+
+  // Touching at a corner or far apart, they stay separate.
+  r.add(nano::rect<int>(20, 12, 10, 10));
+  r.add(nano::rect<int>(100, 100, 4, 4));
+  EXPECT_EQ(r.get_rects().size(), 3u);
+  EXPECT_EQ(r.get_area(), 240u + 100u + 16u);
+
+  // A rect covering others replaces them.
+  r.add(nano::rect<int>(0, 0, 30, 22));
+  EXPECT_EQ(r.get_rects().size(), 2u);
+  EXPECT_EQ(r.get_area(), 660u + 16u);
+}
+
+TEST_CASE("nano.ui", region_collapse) {
+  nano::region r;
+  for (int i = 0; i <= static_cast<int>(nano::region::max_rect_count); i++) {
+    r.add(nano::rect<int>(i * 20, 0, 4, 4));
+  }
+
+  EXPECT_EQ(r.get_rects().size(), 1u);
+  EXPECT_TRUE(r.get_rects()[0] == nano::rect<int>(0, 0, 16 * 20 + 4, 4));
+
+  r.clip(nano::rect<int>(0, 0, 10, 10));
+  EXPECT_TRUE(r.get_bounds() == nano::rect<int>(0, 0, 10, 4));
+}
@@ -0,0 +1,3 @@
+#include "nano/test.h"
+
+NANO_TEST_MAIN()
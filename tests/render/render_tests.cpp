@@ -0,0 +1,165 @@
+#include "nano/test.h"
+#include <nano/ui/headless.h>
+
+#include "main_view.h"
+#include "main_window.h"
+#include "toolbar.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+
+// Renders view trees with the headless backend and compares them against the
+// png files in NANO_UI_GOLDEN_DIRECTORY.
+//
+// A missing golden image is a failure, set the NANO_UI_UPDATE_GOLDENS
+// environment variable to record them all from the current output.
+// On mismatch, the output is written in NANO_UI_RENDER_OUTPUT_DIRECTORY.
+
+namespace {
+// Antialiasing can change slightly between CoreGraphics versions.
+constexpr int golden_tolerance = 3;
+constexpr double golden_max_different_ratio = 0.001;
+
+bool match_golden(const std::string& name, const nano::pixel_buffer& image) {
+  const std::string path = std::string(NANO_UI_GOLDEN_DIRECTORY) + "/" + name + ".png";
+
+  if (std::getenv("NANO_UI_UPDATE_GOLDENS")) {
+    std::cout << "recording golden image " << path << std::endl;
+    return nano::write_png(image, path);
+  }
+
+  nano::pixel_buffer golden;
+  if (!nano::read_png(golden, path)) {
+    std::cout << "missing golden image " << path << ", set NANO_UI_UPDATE_GOLDENS to record it" << std::endl;
+    return false;
+  }
+
+  const nano::image_difference diff = nano::compare(image, golden, golden_tolerance);
+
+  if (diff.same_size && diff.get_different_ratio() <= golden_max_different_ratio) {
+    return true;
+  }
+
+  const std::string output_path = std::string(NANO_UI_RENDER_OUTPUT_DIRECTORY) + "/" + name + ".png";
+  nano::write_png(image, output_path);
+
+  std::cout << name << " does not match its golden image: " << diff.different_pixel_count << "/" << diff.pixel_count
+            << " pixels differ (max component difference " << diff.max_component_difference << "), output written to "
+            << output_path << std::endl;
+  return false;
+}
+
+class solid_view : public nano::view {
+public:
+  solid_view(nano::view* parent, const nano::rect<int>& rect, const nano::color& c)
+      : nano::view(parent, rect)
+      , m_color(c) {}
+
+  solid_view(const nano::rect<int>& rect, const nano::color& c)
+      : nano::view(rect)
+      , m_color(c) {}
+
+protected:
+  void on_draw(nano::graphic_context& gc, const nano::rect<float>& dirty_rect) override {
+    NANO_UNUSED(dirty_rect);
+    gc.set_fill_color(m_color);
+    gc.fill_rect(nano::rect<float>(get_bounds()));
+  }
+
+private:
+  nano::color m_color;
+};
+
+/// the basic example layout (see MainWindow::on_frame_changed) in a detached root view.
+struct basic_layout {
+  basic_layout(int width, int height)
+      : root(nano::rect<int>(0, 0, width, height), nano::color(0x333333FF)) {
+    toolbar = std::make_unique<Toolbar>(&root, nano::rect<int>(0, 0, width, 50));
+    main_view = std::make_unique<MainView>(&root, nano::rect<int>(10, 60, width - 20, height - 70));
+  }
+
+  solid_view root;
+  std::unique_ptr<Toolbar> toolbar;
+  std::unique_ptr<MainView> main_view;
+};
+} // namespace.
+
+TEST_CASE("nano.ui.render", toolbar) {
+  solid_view root(nano::rect<int>(0, 0, 200, 50), nano::color(0x000000FF));
+  Toolbar toolbar(&root, nano::rect<int>(0, 0, 200, 50));
+
+  nano::headless_surface surface(&root);
+  surface.render();
+  EXPECT_TRUE(match_golden("toolbar", surface.get_buffer()));
+}
+
+TEST_CASE("nano.ui.render", main_view) {
+  solid_view root(nano::rect<int>(0, 0, 220, 220), nano::color(0x333333FF));
+  MainView view(&root, nano::rect<int>(10, 10, 200, 200));
+
+  nano::headless_surface surface(&root);
+  surface.render();
+  EXPECT_TRUE(match_golden("main_view", surface.get_buffer()));
+}
+
+TEST_CASE("nano.ui.render", basic_layout) {
+  basic_layout layout(400, 300);
+
+  nano::headless_surface surface(&layout.root);
+  surface.render();
+  EXPECT_TRUE(match_golden("basic_layout", surface.get_buffer()));
+
+  nano::headless_surface retina_surface(&layout.root, 2.0f);
+  retina_surface.render();
+  EXPECT_TRUE(match_golden("basic_layout@2x", retina_surface.get_buffer()));
+}
+
+TEST_CASE("nano.ui.render", basic_layout_partial) {
+  basic_layout layout(400, 300);
+
+  nano::headless_surface surface(&layout.root);
+  surface.render();
+
+  // Rendering a dirty rect over a full render must not change anything.
+  const nano::pixel_buffer full = surface.get_buffer();
+  surface.render(nano::rect<int>(0, 25, 200, 100));
+  EXPECT_EQ(nano::compare(full, surface.get_buffer()).different_pixel_count, 0);
+}
+
+TEST_CASE("nano.ui.render", main_window) {
+  MainWindow window;
+  window.set_window_frame(nano::rect<int>(0, 0, 400, 300));
+
+  nano::headless_surface surface(&window);
+  surface.render();
+
+  // The content size depends on the title bar, the window lays out its views like basic_layout.
+  const nano::size<int> size = window.view::get_frame().size;
+  basic_layout layout(size.width, size.height);
+
+  nano::headless_surface expected(&layout.root);
+  expected.render();
+
+  const nano::image_difference diff = nano::compare(surface.get_buffer(), expected.get_buffer());
+  EXPECT_TRUE(diff.same_size);
+  EXPECT_EQ(diff.different_pixel_count, 0);
+}
+
+TEST_CASE("nano.ui.render", clip_and_opacity) {
+  solid_view root(nano::rect<int>(0, 0, 100, 100), nano::color(0xFFFFFFFF));
+  solid_view parent(&root, nano::rect<int>(10, 10, 60, 60), nano::color(0x0000FFFF));
+  solid_view child(&parent, nano::rect<int>(40, 40, 60, 60), nano::color(0xFF0000FF));
+  solid_view hidden(&root, nano::rect<int>(0, 0, 10, 10), nano::color(0x00FF00FF));
+  parent.set_opacity(0.5f);
+  hidden.set_hidden(true);
+
+  nano::headless_surface surface(&root);
+  surface.render();
+  EXPECT_TRUE(match_golden("clip_and_opacity", surface.get_buffer()));
+
+  // The child is clipped to its parent.
+  EXPECT_EQ(surface.get_buffer().get_pixel(80, 80), nano::make_pixel(255, 255, 255, 255));
+  EXPECT_EQ(surface.get_buffer().get_pixel(5, 5), nano::make_pixel(255, 255, 255, 255));
+}
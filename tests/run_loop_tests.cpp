@@ -0,0 +1,275 @@
+#include "nano/test.h"
+#include <nano/ui/run_loop.h>
+
+#if defined(__linux__)
+
+#include <csignal>
+#include <memory>
+#include <string>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+class counter_message : public nano::message {
+public:
+  counter_message(int& count)
+      : m_count(count) {}
+
+  virtual ~counter_message() override = default;
+
+  virtual void call() override { m_count++; }
+
+private:
+  int& m_count;
+};
+
+class counting_timer : public nano::timer {
+public:
+  int count = 0;
+
+protected:
+  virtual void on_timer() override {
+    if (++count == 3) {
+      stop();
+      nano::application::quit();
+    }
+  }
+};
+
+class test_application : public nano::application {
+public:
+  std::vector<std::string> calls;
+  bool terminate = false;
+
+  virtual std::string get_application_name() const override { return "test"; }
+
+  virtual std::string get_application_version() const override { return "1.0"; }
+
+protected:
+  virtual void prepare() override { calls.push_back("prepare"); }
+
+  virtual void initialise() override {
+    calls.push_back("initialise");
+
+    // Refused first, then accepted.
+    std::raise(SIGTERM);
+    nano::post_message([this]() {
+      terminate = true;
+      std::raise(SIGTERM);
+    });
+  }
+
+  virtual void shutdown() override { calls.push_back("shutdown"); }
+
+  virtual bool should_terminate() override {
+    calls.push_back("should_terminate");
+    return terminate;
+  }
+};
+
+/// returns the number of bytes read until EAGAIN.
+std::size_t drain(int fd) {
+  std::size_t total = 0;
+  char buffer[64];
+  ssize_t size = 0;
+  while ((size = read(fd, buffer, sizeof(buffer))) > 0) {
+    total += static_cast<std::size_t>(size);
+  }
+
+  return total;
+}
+} // namespace.
+
+TEST_CASE("nano.ui", run_loop_messages) {
+  nano::run_loop loop;
+  EXPECT_TRUE(loop.is_valid());
+
+  // A burst of posts wakes the loop once.
+  int count = 0;
+  for (int i = 0; i < 100; i++) {
+    loop.post(std::make_shared<counter_message>(count));
+  }
+
+  EXPECT_EQ(loop.run_once(0), 100u);
+  EXPECT_EQ(count, 100);
+  EXPECT_EQ(loop.get_stats().wakeups, 1u);
+  EXPECT_EQ(loop.run_once(0), 0u);
+
+  // Posted from another thread, run() returns the exit code given to quit().
+  std::thread producer([&]() {
+    for (int i = 0; i < 1000; i++) {
+      loop.post(std::make_shared<counter_message>(count));
+    }
+    loop.quit(7);
+  });
+
+  EXPECT_EQ(loop.run(), 7);
+  producer.join();
+  EXPECT_EQ(count, 1100);
+  EXPECT_FALSE(loop.is_running());
+}
+
+TEST_CASE("nano.ui", run_loop_sources) {
+  nano::run_loop loop;
+
+  int fds[2];
+  EXPECT_EQ(pipe(fds), 0);
+
+  std::string received;
+  EXPECT_TRUE(loop.add_source(fds[0], EPOLLIN, [&](std::uint32_t events) {
+    EXPECT_TRUE(events & EPOLLIN);
+    char buffer[16];
+    const ssize_t size = read(fds[0], buffer, sizeof(buffer));
+    received.append(buffer, static_cast<std::size_t>(size));
+    loop.remove_source(fds[0]);
+  }));
+  EXPECT_FALSE(loop.add_source(fds[0], EPOLLIN, [](std::uint32_t) {}));
+
+  EXPECT_EQ(loop.run_once(0), 0u);
+  EXPECT_EQ(write(fds[1], "abc", 3), 3);
+  EXPECT_EQ(loop.run_once(1000), 1u);
+  EXPECT_EQ(received, "abc");
+
+  // Removed from its callback.
+  EXPECT_EQ(write(fds[1], "d", 1), 1);
+  EXPECT_EQ(loop.run_once(0), 0u);
+  EXPECT_EQ(received, "abc");
+
+  close(fds[0]);
+  close(fds[1]);
+
+  // A timer fires until it is removed.
+  int ticks = 0;
+  const int id = loop.add_timer(1, [&]() { ticks++; });
+  EXPECT_GE(id, 0);
+  while (ticks < 3) {
+    loop.run_once(100);
+  }
+
+  EXPECT_GE(loop.get_stats().timer_expirations, 3u);
+  EXPECT_TRUE(loop.remove_timer(id));
+  EXPECT_FALSE(loop.remove_timer(id));
+  EXPECT_EQ(loop.run_once(5), 0u);
+  EXPECT_EQ(ticks, 3);
+}
+
+TEST_CASE("nano.ui", run_loop_application) {
+  const char* argv[] = { "app", "--headless" };
+  std::unique_ptr<test_application> app = nano::application::create_application<test_application>(2, argv);
+  EXPECT_EQ(app->get_command_line_arguments(), "app --headless");
+
+  // The lifecycle of the native loop, the signals go through should_terminate().
+  EXPECT_EQ(app->run(), 0);
+  const std::vector<std::string> expected
+      = { "prepare", "initialise", "should_terminate", "should_terminate", "shutdown" };
+  EXPECT_TRUE(app->calls == expected);
+
+  // Timers and posted messages use the main loop.
+  counting_timer t;
+  t.start(1);
+  EXPECT_TRUE(t.is_running());
+  EXPECT_EQ(nano::run_loop::get_main().run(), 0);
+  EXPECT_EQ(t.count, 3);
+  EXPECT_FALSE(t.is_running());
+}
+
+TEST_CASE("nano.ui", application_watch_fd) {
+  nano::run_loop& loop = nano::run_loop::get_main();
+
+  int fds[2];
+  EXPECT_EQ(socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds), 0);
+
+  int calls = 0;
+  bool drain_reads = false;
+  std::size_t received = 0;
+  nano::fd_events last_events = nano::fd_events::none;
+  EXPECT_TRUE(nano::application::watch_fd(fds[0], nano::fd_events::readable, [&](int fd, nano::fd_events events) {
+    EXPECT_EQ(fd, fds[0]);
+    calls++;
+    last_events = events;
+    if (drain_reads) {
+      received += drain(fd);
+    }
+  }));
+  EXPECT_FALSE(nano::application::watch_fd(fds[0], nano::fd_events::readable, [](int, nano::fd_events) {}));
+
+  EXPECT_EQ(loop.run_once(0), 0u);
+
+  // Dispatched alongside the posted messages.
+  int messages = 0;
+  nano::post_message([&]() { messages++; });
+  EXPECT_EQ(write(fds[1], "abc", 3), 3);
+  while (!calls || !messages) {
+    loop.run_once(1000);
+  }
+
+  EXPECT_EQ(calls, 1);
+  EXPECT_TRUE((last_events & nano::fd_events::readable) != 0);
+  EXPECT_TRUE((last_events & nano::fd_events::hang_up) == 0);
+
+  // Edge-triggered, the data left unread doesn't call it again.
+  EXPECT_EQ(loop.run_once(10), 0u);
+  EXPECT_EQ(calls, 1);
+
+  // New data does, the callback then reads everything.
+  drain_reads = true;
+  EXPECT_EQ(write(fds[1], "de", 2), 2);
+  EXPECT_EQ(loop.run_once(1000), 1u);
+  EXPECT_EQ(calls, 2);
+  EXPECT_EQ(received, 5u);
+
+  // The peer closing is reported.
+  close(fds[1]);
+  EXPECT_EQ(loop.run_once(1000), 1u);
+  EXPECT_EQ(calls, 3);
+  EXPECT_TRUE((last_events & nano::fd_events::hang_up) != 0);
+
+  EXPECT_TRUE(nano::application::unwatch_fd(fds[0]));
+  EXPECT_FALSE(nano::application::unwatch_fd(fds[0]));
+  close(fds[0]);
+}
+
+TEST_CASE("nano.ui", application_watch_fd_writable) {
+  nano::run_loop& loop = nano::run_loop::get_main();
+
+  int fds[2];
+  EXPECT_EQ(socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds), 0);
+
+  // Fill the socket until it would block.
+  const std::vector<char> chunk(4096, 'x');
+  while (write(fds[0], chunk.data(), chunk.size()) > 0) {
+  }
+
+  int writable = 0;
+  int peer_reads = 0;
+  EXPECT_TRUE(nano::application::watch_fd(fds[0], nano::fd_events::writable, [&](int fd, nano::fd_events events) {
+    EXPECT_TRUE((events & nano::fd_events::writable) != 0);
+    writable++;
+    nano::application::unwatch_fd(fd);
+  }));
+
+  // Full, nothing to do until the peer reads.
+  EXPECT_TRUE(nano::application::watch_fd(fds[1], nano::fd_events::readable, [&](int fd, nano::fd_events) {
+    peer_reads++;
+    drain(fd);
+  }));
+
+  while (!writable) {
+    EXPECT_GT(loop.run_once(1000), 0u);
+  }
+
+  EXPECT_EQ(writable, 1);
+  EXPECT_GE(peer_reads, 1);
+
+  // Unwatched from its callback.
+  EXPECT_FALSE(nano::application::unwatch_fd(fds[0]));
+  EXPECT_TRUE(nano::application::unwatch_fd(fds[1]));
+
+  close(fds[0]);
+  close(fds[1]);
+}
+
+#endif
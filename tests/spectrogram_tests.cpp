@@ -0,0 +1,179 @@
+#include "nano/test.h"
+#include <nano/ui/compositor.h>
+#include <nano/ui/headless.h>
+#include <nano/ui/spectrogram.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <vector>
+
+namespace {
+std::string get_temp_path(const char* name) { return std::string("/tmp/nano_ui_") + name; }
+
+/// 64000 frames of mono float at 48 kHz: a full scale sine of 3.1 kHz, then silence from the frame 32000.
+std::shared_ptr<nano::mapped_audio_file> make_file() {
+  const std::string path = get_temp_path("spectrogram.raw");
+  std::vector<float> samples(64000, 0.0f);
+  for (std::size_t i = 0; i < 32000; i++) {
+    samples[i] = static_cast<float>(std::sin(2.0 * 3.14159265358979323846 * 3100.0 * static_cast<double>(i) / 48000.0));
+  }
+
+  std::FILE* file = std::fopen(path.c_str(), "wb");
+  std::fwrite(samples.data(), sizeof(float), samples.size(), file);
+  std::fclose(file);
+
+  auto mapped = std::make_shared<nano::mapped_audio_file>();
+  mapped->open_raw(path, nano::audio_format{ nano::sample_format::float32, 1, 48000 });
+  return mapped;
+}
+
+nano::spectrogram_data::options make_options() {
+  nano::spectrogram_data::options opts;
+  opts.fft_size = 512;
+  opts.hop_size = 64;
+  opts.row_count = 64;
+  opts.thread_count = 2;
+  return opts;
+}
+} // namespace.
+
+TEST_CASE("nano.ui", spectrogram_data) {
+  const std::string pyramid_path = get_temp_path("spectrogram.pyramid");
+  std::remove(pyramid_path.c_str());
+
+  auto file = make_file();
+  auto data = std::make_shared<nano::spectrogram_data>(file, make_options());
+
+  // 1000 columns: 4 tiles, then 2 and 1.
+  EXPECT_EQ(data->get_level_count(), 3u);
+  EXPECT_EQ(data->get_column_count(0), 1000u);
+  EXPECT_EQ(data->get_tile_count(1), 2u);
+  EXPECT_EQ(data->get_column_count(2), 250u);
+  EXPECT_TRUE(data->get_column(0, 0) == nullptr);
+
+  EXPECT_TRUE(data->build(pyramid_path));
+  data->wait();
+  EXPECT_TRUE(data->is_ready());
+  EXPECT_EQ(data->get_progress(), 1.0f);
+
+  // The sine reads 0 dB in one row, the silence is at the bottom of the range.
+  const std::uint8_t* sine = data->get_column(0, 200);
+  const std::uint8_t* silence = data->get_column(0, 800);
+  EXPECT_NEAR(data->get_db(*std::max_element(sine, sine + 64)), 0.0f, 1.5f);
+  EXPECT_EQ(*std::max_element(silence, silence + 64), 0);
+
+  // A column above is the largest of two below.
+  const std::uint8_t* a = data->get_column(0, 498);
+  const std::uint8_t* b = data->get_column(0, 499);
+  const std::uint8_t* above = data->get_column(1, 249);
+  for (std::size_t r = 0; r < 64; r++) {
+    EXPECT_EQ(above[r], std::max(a[r], b[r]));
+  }
+
+  std::vector<std::uint8_t> expected(data->get_column(2, 100), data->get_column(2, 100) + 64);
+  const int sum = std::accumulate(sine, sine + 64, 0);
+
+  // The complete pyramid is reused without workers.
+  auto reused = std::make_shared<nano::spectrogram_data>(file, make_options());
+  EXPECT_TRUE(reused->build(pyramid_path));
+  EXPECT_TRUE(reused->is_ready());
+  EXPECT_TRUE(std::equal(expected.begin(), expected.end(), reused->get_column(2, 100)));
+
+  // Other options compute it again, a narrower range maps the same levels lower.
+  nano::spectrogram_data::options opts = make_options();
+  opts.min_db = -90.0f;
+  auto other = std::make_shared<nano::spectrogram_data>(file, opts);
+  EXPECT_TRUE(other->build(pyramid_path));
+  other->wait();
+  EXPECT_TRUE(other->is_ready());
+  const std::uint8_t* column = other->get_column(0, 200);
+  EXPECT_LT(std::accumulate(column, column + 64, 0), sum);
+
+  std::remove(pyramid_path.c_str());
+}
+
+TEST_CASE("nano.ui", spectrogram_tile_cache) {
+  auto data = std::make_shared<nano::spectrogram_data>(make_file(), make_options());
+  data->build();
+  data->wait();
+
+  nano::spectrogram_tile_cache tiles;
+  tiles.set_data(data);
+  tiles.set_colormap({ nano::color(0x000000FF), nano::color(0xFFFFFFFF) });
+  tiles.set_range(-120.0f, 0.0f);
+
+  std::shared_ptr<const nano::pixel_buffer> first = tiles.get(0, 0);
+  EXPECT_EQ(first->get_width(), 256);
+  EXPECT_EQ(first->get_height(), 64);
+  EXPECT_EQ(tiles.get(0, 3)->get_width(), 1000 - 768);
+  EXPECT_TRUE(tiles.get(0, 4) == nullptr);
+
+  // The highest frequency is on top, the loudest pixel of the sine is white.
+  const std::uint8_t* column = data->get_column(0, 10);
+  const int loudest = static_cast<int>(std::max_element(column, column + 64) - column);
+  EXPECT_EQ(first->get_pixel(10, 63 - loudest), nano::make_pixel(255, 255, 255, 255));
+  EXPECT_EQ(tiles.get(0, 3)->get_pixel(100, 0), nano::make_pixel(0, 0, 0, 255));
+
+  // Tiles are rendered again only when the colors change.
+  EXPECT_TRUE(tiles.get(0, 0) == first);
+  tiles.set_gain(0.0f);
+  tiles.set_range(-120.0f, 0.0f);
+  EXPECT_TRUE(tiles.get(0, 0) == first);
+  EXPECT_EQ(tiles.get_stats().renders, 2u);
+
+  tiles.set_gain(-12.0f);
+  EXPECT_EQ(tiles.get_stats().entry_count, 0u);
+  std::shared_ptr<const nano::pixel_buffer> darker = tiles.get(0, 0);
+  EXPECT_EQ(tiles.get_stats().renders, 3u);
+  EXPECT_LT(nano::get_pixel_red(darker->get_pixel(10, 63 - loudest)), 255);
+
+  // The least recently used tiles are evicted.
+  tiles.set_capacity(darker->get_byte_size() * 2);
+  tiles.get(0, 1);
+  tiles.get(0, 2);
+  EXPECT_EQ(tiles.get_stats().entry_count, 2u);
+  EXPECT_EQ(tiles.get_stats().evictions, 1u);
+}
+
+TEST_CASE("nano.ui", spectrogram_view) {
+  auto data = std::make_shared<nano::spectrogram_data>(make_file(), make_options());
+  data->build();
+  data->wait();
+
+  auto root = std::make_unique<nano::view>(nano::rect<int>(0, 0, 100, 64));
+  auto view = std::make_unique<nano::spectrogram_view>(root.get(), nano::rect<int>(0, 0, 100, 64));
+  view->set_visible_range(0, 64);
+  EXPECT_EQ(view->get_level(), 0u);
+  view->set_data(data);
+
+  // The tiles are requested when the view draws.
+  if (nano::compositor::can_draw()) {
+    nano::headless_presenter presenter;
+    auto comp = std::make_unique<nano::compositor>(root.get(), &presenter);
+
+    // The visible tile and the next two.
+    comp->commit();
+    comp->flush();
+    EXPECT_EQ(view->get_tile_cache().get_stats().entry_count, 3u);
+
+    // Scrolling into prefetched tiles renders nothing, the one after is prefetched.
+    view->get_tile_cache().reset_stats();
+    view->set_visible_range(64.0 * 300.0, 64);
+    comp->commit();
+    comp->flush();
+    EXPECT_EQ(view->get_tile_cache().get_stats().misses, 1u);
+    EXPECT_EQ(view->get_tile_cache().get_stats().entry_count, 4u);
+
+    comp.reset();
+  }
+
+  // A coarser level when zoomed out.
+  view->set_visible_range(0, 256);
+  EXPECT_EQ(view->get_level(), 2u);
+  view->set_visible_range(0, 100000);
+  EXPECT_EQ(view->get_level(), 2u);
+}
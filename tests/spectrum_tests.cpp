@@ -0,0 +1,163 @@
+#include "nano/test.h"
+#include <nano/ui/spectrum.h>
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+namespace {
+constexpr double pi = 3.14159265358979323846;
+
+std::vector<float> make_sine(std::size_t count, double frequency, double sample_rate, double amplitude = 1.0) {
+  std::vector<float> samples(count);
+  for (std::size_t i = 0; i < count; i++) {
+    samples[i] = static_cast<float>(amplitude * std::sin(2.0 * pi * frequency * static_cast<double>(i) / sample_rate));
+  }
+
+  return samples;
+}
+} // namespace.
+
+TEST_CASE("nano.ui", sample_ring) {
+  nano::sample_ring ring(6, 2);
+  EXPECT_EQ(ring.get_capacity(), 8u);
+
+  const float left[5] = { 1, 2, 3, 4, 5 };
+  const float right[5] = { -1, -2, -3, -4, -5 };
+  const float* input[2] = { left, right };
+
+  float out_left[8];
+  float out_right[8];
+  float* output[2] = { out_left, out_right };
+
+  EXPECT_EQ(ring.write(input, 5), 5u);
+  EXPECT_EQ(ring.read(output, 3), 3u);
+  EXPECT_EQ(out_right[2], -3.0f);
+
+  // Wraps around the end of the storage, the frames that do not fit are dropped.
+  EXPECT_EQ(ring.write(input, 5), 5u);
+  EXPECT_EQ(ring.write(input, 5), 1u);
+  EXPECT_EQ(ring.get_dropped_count(), 4u);
+  EXPECT_EQ(ring.get_read_available(), 8u);
+
+  EXPECT_EQ(ring.skip(2), 2u);
+  EXPECT_EQ(ring.read(output, 8), 6u);
+  EXPECT_EQ(out_left[0], 1.0f);
+  EXPECT_EQ(out_left[4], 5.0f);
+  EXPECT_EQ(out_right[5], -1.0f);
+  EXPECT_EQ(ring.get_read_available(), 0u);
+}
+
+TEST_CASE("nano.ui", triple_buffer) {
+  nano::triple_buffer<int> buffer;
+  buffer.reset(0);
+  EXPECT_FALSE(buffer.update());
+
+  // The reader only sees the latest value.
+  buffer.get_back() = 1;
+  buffer.publish();
+  buffer.get_back() = 2;
+  buffer.publish();
+  EXPECT_TRUE(buffer.update());
+  EXPECT_EQ(buffer.get_front(), 2);
+  EXPECT_FALSE(buffer.update());
+
+  buffer.get_back() = 3;
+  buffer.publish();
+  EXPECT_TRUE(buffer.update());
+  EXPECT_EQ(buffer.get_front(), 3);
+}
+
+TEST_CASE("nano.ui", periodic_worker) {
+  nano::periodic_worker worker;
+  std::atomic<int> count = 0;
+
+  worker.start(200.0f, [&count]() { count++; });
+  EXPECT_TRUE(worker.is_running());
+
+  // Starting again keeps the running thread.
+  worker.start(1.0f, []() {});
+
+  while (count < 3) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  // No call after stop() returned.
+  worker.stop();
+  EXPECT_FALSE(worker.is_running());
+  const int stopped = count;
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_EQ(count, stopped);
+}
+
+TEST_CASE("nano.ui", real_fft) {
+  constexpr std::size_t size = 64;
+  std::vector<float> input(size);
+  for (std::size_t i = 0; i < size; i++) {
+    input[i] = static_cast<float>(std::sin(0.37 * static_cast<double>(i * i)) + 0.25);
+  }
+
+  nano::real_fft fft(size);
+  std::vector<float> real(fft.get_bin_count());
+  std::vector<float> imag(fft.get_bin_count());
+  fft.forward(input.data(), real.data(), imag.data());
+
+  for (std::size_t k = 0; k < fft.get_bin_count(); k++) {
+    double re = 0;
+    double im = 0;
+    for (std::size_t n = 0; n < size; n++) {
+      const double angle = -2.0 * pi * static_cast<double>(k * n) / static_cast<double>(size);
+      re += static_cast<double>(input[n]) * std::cos(angle);
+      im += static_cast<double>(input[n]) * std::sin(angle);
+    }
+
+    EXPECT_NEAR(real[k], re, 1e-3);
+    EXPECT_NEAR(imag[k], im, 1e-3);
+  }
+}
+
+TEST_CASE("nano.ui", spectrum_analyzer) {
+  nano::spectrum_analyzer::options opts;
+  opts.fft_size = 2048;
+  opts.bin_count = 64;
+  opts.channel_count = 2;
+  nano::spectrum_analyzer analyzer(opts);
+
+  EXPECT_FALSE(analyzer.update());
+  EXPECT_FALSE(analyzer.poll());
+
+  // A full scale 1 kHz sine on the left, a -20 dB 5 kHz sine on the right.
+  const std::vector<float> left = make_sine(opts.fft_size, 1000.0, opts.sample_rate);
+  const std::vector<float> right = make_sine(opts.fft_size, 5000.0, opts.sample_rate, 0.1);
+  const float* channels[2] = { left.data(), right.data() };
+  analyzer.push(channels, opts.fft_size);
+
+  EXPECT_TRUE(analyzer.update());
+  EXPECT_TRUE(analyzer.poll());
+  EXPECT_EQ(analyzer.get_frame_index(), 1u);
+
+  const auto get_peak_bin = [&](int channel) {
+    const float* bins = analyzer.get_bins(channel);
+    return static_cast<std::size_t>(std::max_element(bins, bins + opts.bin_count) - bins);
+  };
+
+  const std::size_t left_peak = get_peak_bin(0);
+  const std::size_t right_peak = get_peak_bin(1);
+  EXPECT_NEAR(std::log2(analyzer.get_bin_frequency(left_peak) / 1000.0f), 0.0f, 0.1f);
+  EXPECT_NEAR(std::log2(analyzer.get_bin_frequency(right_peak) / 5000.0f), 0.0f, 0.1f);
+  EXPECT_NEAR(analyzer.get_bins(0)[left_peak], 0.0f, 1.5f);
+  EXPECT_NEAR(analyzer.get_bins(1)[right_peak], -20.0f, 1.5f);
+
+  // Silence makes the bins fall at the falloff rate.
+  const std::vector<float> silence(opts.fft_size / 2, 0.0f);
+  const float* silent[2] = { silence.data(), silence.data() };
+  const float level = analyzer.get_bins(0)[left_peak];
+  analyzer.push(silent, silence.size());
+  EXPECT_TRUE(analyzer.update());
+  EXPECT_TRUE(analyzer.poll());
+
+  const float expected_fall = opts.falloff * static_cast<float>(silence.size()) / opts.sample_rate;
+  EXPECT_NEAR(analyzer.get_bins(0)[left_peak], level - expected_fall, 1e-3f);
+}
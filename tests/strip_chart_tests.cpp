@@ -0,0 +1,111 @@
+#include "nano/test.h"
+#include <nano/ui/compositor.h>
+#include <nano/ui/headless.h>
+#include <nano/ui/strip_chart.h>
+
+#include <memory>
+#include <vector>
+
+namespace {
+/// pushes frame_count frames of a ramp into every channel of a ring.
+void push_ramp(nano::sample_ring& ring, std::size_t frame_count) {
+  std::vector<float> values(frame_count);
+  for (std::size_t i = 0; i < frame_count; i++) {
+    values[i] = static_cast<float>(i % 100) / 100.0f;
+  }
+
+  std::vector<const float*> channels(static_cast<std::size_t>(ring.get_channel_count()), values.data());
+  ring.write(channels.data(), frame_count);
+}
+} // namespace.
+
+TEST_CASE("nano.ui", strip_chart_history) {
+  nano::strip_chart_history history(2, 4);
+  history.set_frames_per_column(4.0);
+
+  std::vector<float> a(32);
+  std::vector<float> b(32);
+  for (std::size_t i = 0; i < a.size(); i++) {
+    a[i] = static_cast<float>(i);
+    b[i] = -static_cast<float>(i);
+  }
+
+  // Two complete columns, the last two frames wait for the third.
+  const float* series[2] = { a.data(), b.data() };
+  EXPECT_EQ(history.append(series, 10), 2u);
+  EXPECT_EQ(history.get_column_count(), 2u);
+  EXPECT_EQ(history.get_column(0, 1).min, 4.0f);
+  EXPECT_EQ(history.get_column(0, 1).max, 7.0f);
+  EXPECT_EQ(history.get_column(1, 1).min, -7.0f);
+  EXPECT_EQ(history.get_column(1, 1).last, -7.0f);
+
+  const float* next[2] = { a.data() + 10, b.data() + 10 };
+  EXPECT_EQ(history.append(next, 2), 1u);
+  EXPECT_EQ(history.get_column(0, 2).min, 8.0f);
+  EXPECT_EQ(history.get_column(0, 2).max, 11.0f);
+
+  // The oldest columns are overwritten.
+  const float* last[2] = { a.data() + 12, b.data() + 12 };
+  EXPECT_EQ(history.append(last, 20), 5u);
+  EXPECT_EQ(history.get_column_count(), 8u);
+  EXPECT_FALSE(history.contains(3));
+  EXPECT_TRUE(history.contains(4));
+  EXPECT_FALSE(history.contains(8));
+  EXPECT_EQ(history.get_column(0, 7).max, 31.0f);
+
+  // Fractional columns alternate between two and three frames.
+  history.set_frames_per_column(2.5);
+  EXPECT_EQ(history.get_column_count(), 0u);
+  EXPECT_EQ(history.append(series, 10), 4u);
+  EXPECT_EQ(history.get_column(0, 1).min, 2.0f);
+  EXPECT_EQ(history.get_column(0, 1).max, 4.0f);
+}
+
+TEST_CASE("nano.ui", strip_chart_view) {
+  if (!nano::compositor::can_draw()) {
+    return;
+  }
+
+  auto root = std::make_unique<nano::view>(nano::rect<int>(0, 0, 100, 50));
+  auto ring = std::make_shared<nano::sample_ring>(4096, 2);
+
+  // 10 frames per column.
+  auto chart = std::make_unique<nano::strip_chart_view>(root.get(), nano::rect<int>(0, 0, 100, 50));
+  chart->set_source(ring, 1000.0f);
+  chart->set_time_span(1.0f);
+  EXPECT_EQ(chart->get_history().get_series_count(), 2);
+  EXPECT_EQ(chart->get_history().get_frames_per_column(), 10.0);
+
+  nano::headless_presenter presenter;
+  auto comp = std::make_unique<nano::compositor>(root.get(), &presenter);
+  comp->commit();
+  comp->flush();
+  std::uint64_t painted = comp->get_stats().painted_pixels;
+
+  // The drawn columns are moved, only the new ones on the right are painted.
+  push_ramp(*ring, 35);
+  EXPECT_EQ(chart->update(), 3u);
+  comp->commit();
+  comp->flush();
+  EXPECT_EQ(comp->get_stats().painted_pixels - painted, 3u * 50u);
+  EXPECT_EQ(comp->get_stats().scrolled_pixels, 97u * 50u);
+
+  // Nothing new, nothing is drawn.
+  const std::uint64_t frames = presenter.get_frame_count();
+  push_ramp(*ring, 4);
+  EXPECT_EQ(chart->update(), 0u);
+  comp->commit();
+  comp->flush();
+  EXPECT_EQ(presenter.get_frame_count(), frames);
+
+  // More columns than the width redraw everything.
+  painted = comp->get_stats().painted_pixels;
+  push_ramp(*ring, 2000);
+  EXPECT_EQ(chart->update(), 200u);
+  comp->commit();
+  comp->flush();
+  EXPECT_EQ(comp->get_stats().painted_pixels - painted, 100u * 50u);
+  EXPECT_EQ(chart->get_history().get_column_count(), 203u);
+
+  comp.reset();
+}
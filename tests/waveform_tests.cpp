@@ -0,0 +1,179 @@
+#include "nano/test.h"
+#include <nano/ui/waveform.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace {
+std::string get_temp_path(const char* name) { return std::string("/tmp/nano_ui_") + name; }
+
+void write_u32(std::FILE* file, std::uint32_t value) {
+  const std::uint8_t bytes[4] = { static_cast<std::uint8_t>(value), static_cast<std::uint8_t>(value >> 8),
+    static_cast<std::uint8_t>(value >> 16), static_cast<std::uint8_t>(value >> 24) };
+  std::fwrite(bytes, 1, 4, file);
+}
+
+void write_u16(std::FILE* file, std::uint16_t value) {
+  const std::uint8_t bytes[2] = { static_cast<std::uint8_t>(value), static_cast<std::uint8_t>(value >> 8) };
+  std::fwrite(bytes, 1, 2, file);
+}
+
+/// 16 bit stereo wav, with a chunk before the samples.
+void write_wav(const std::string& path, const std::vector<std::int16_t>& samples) {
+  std::FILE* file = std::fopen(path.c_str(), "wb");
+  const std::uint32_t data_size = static_cast<std::uint32_t>(samples.size() * sizeof(std::int16_t));
+
+  std::fwrite("RIFF", 1, 4, file);
+  write_u32(file, 4 + 24 + 14 + 8 + data_size);
+  std::fwrite("WAVE", 1, 4, file);
+
+  std::fwrite("fmt ", 1, 4, file);
+  write_u32(file, 16);
+  write_u16(file, 1);
+  write_u16(file, 2);
+  write_u32(file, 44100);
+  write_u32(file, 44100 * 4);
+  write_u16(file, 4);
+  write_u16(file, 16);
+
+  // Odd sized chunks are padded.
+  std::fwrite("LIST", 1, 4, file);
+  write_u32(file, 5);
+  std::fwrite("abcde\0", 1, 6, file);
+
+  std::fwrite("data", 1, 4, file);
+  write_u32(file, data_size);
+  for (std::int16_t s : samples) {
+    write_u16(file, static_cast<std::uint16_t>(s));
+  }
+
+  std::fclose(file);
+}
+
+std::vector<float> make_signal(std::size_t count) {
+  std::vector<float> samples(count);
+  for (std::size_t i = 0; i < count; i++) {
+    const float t = static_cast<float>(i);
+    samples[i] = 0.6f * std::sin(t * 0.013f) * std::sin(t * 0.0007f) + 0.2f * std::sin(t * 0.9f);
+  }
+
+  return samples;
+}
+} // namespace.
+
+TEST_CASE("nano.ui", mapped_audio_file) {
+  const std::string path = get_temp_path("audio_file.wav");
+  write_wav(path, { 0, -32768, 16384, 32767, -16384, 100 });
+
+  nano::mapped_audio_file file;
+  EXPECT_TRUE(file.open_wav(path));
+  EXPECT_EQ(file.get_format().format, nano::sample_format::int16);
+  EXPECT_EQ(file.get_format().channel_count, 2);
+  EXPECT_EQ(file.get_format().sample_rate, 44100);
+  EXPECT_EQ(file.get_frame_count(), 3u);
+  EXPECT_EQ(file.get_sample(0, 1), -1.0f);
+  EXPECT_EQ(file.get_sample(1, 0), 0.5f);
+  EXPECT_EQ(file.get_sample(2, 0), -0.5f);
+
+  float right[3];
+  file.read_channel(0, 3, 1, right);
+  EXPECT_EQ(right[0], -1.0f);
+  EXPECT_EQ(right[2], 100.0f / 32768.0f);
+
+  // Not a wav file.
+  EXPECT_FALSE(file.open_wav(get_temp_path("missing.wav")));
+  EXPECT_FALSE(file.is_open());
+  std::remove(path.c_str());
+}
+
+TEST_CASE("nano.ui", waveform_summary) {
+  constexpr std::size_t frame_count = 300000;
+  const std::vector<float> samples = make_signal(frame_count);
+
+  const std::string path = get_temp_path("waveform.raw");
+  std::FILE* f = std::fopen(path.c_str(), "wb");
+  std::fwrite(samples.data(), sizeof(float), samples.size(), f);
+  std::fclose(f);
+
+  std::shared_ptr<nano::mapped_audio_file> file = std::make_shared<nano::mapped_audio_file>();
+  EXPECT_TRUE(file->open_raw(path, nano::audio_format()));
+  EXPECT_EQ(file->get_frame_count(), frame_count);
+
+  nano::waveform_summary summary(file);
+  EXPECT_EQ(summary.get_level_count(), 7u);
+
+  // Nothing is summarized yet, zoomed in columns are read from the samples.
+  nano::waveform_peak column;
+  summary.get_columns(0, 1000, 2, 1, &column);
+  EXPECT_EQ(column.min, std::min(samples[1000], samples[1001]));
+  EXPECT_EQ(column.max, std::max(samples[1000], samples[1001]));
+
+  summary.build();
+  summary.wait();
+  EXPECT_TRUE(summary.is_ready());
+  EXPECT_EQ(summary.get_progress(), 1.0f);
+
+  // Every zoom matches the samples, the min and max exactly.
+  for (double frames_per_column : { 3.5, 256.0, 300.0, 1000.0, 5000.0, 70000.0 }) {
+    std::vector<nano::waveform_peak> columns(8);
+    const double start = 1234.0;
+    summary.get_columns(0, start, frames_per_column, columns.size(), columns.data());
+
+    for (std::size_t i = 0; i < columns.size(); i++) {
+      const std::uint64_t first
+          = static_cast<std::uint64_t>(std::floor(start + static_cast<double>(i) * frames_per_column));
+      const std::uint64_t last = std::min<std::uint64_t>(
+          static_cast<std::uint64_t>(std::floor(start + static_cast<double>(i + 1) * frames_per_column)), frame_count);
+
+      if (first >= frame_count) {
+        EXPECT_EQ(columns[i].max, 0.0f);
+        continue;
+      }
+
+      // Each column covers exactly its frames, whatever the level it is read from.
+      const std::uint64_t a = first;
+      const std::uint64_t b = std::max(last, first + 1);
+
+      float min = samples[a];
+      float max = samples[a];
+      double sum = 0;
+      for (std::uint64_t k = a; k < b; k++) {
+        min = std::min(min, samples[k]);
+        max = std::max(max, samples[k]);
+        sum += static_cast<double>(samples[k]) * static_cast<double>(samples[k]);
+      }
+
+      EXPECT_EQ(columns[i].min, min);
+      EXPECT_EQ(columns[i].max, max);
+      EXPECT_NEAR(columns[i].mean_square, sum / static_cast<double>(b - a), 1e-4);
+    }
+  }
+
+  // Past the end of the file.
+  summary.get_columns(0, frame_count + 10, 100, 1, &column);
+  EXPECT_EQ(column.max, 0.0f);
+
+  // The sidecar is loaded instead of building again, unless it does not match.
+  const std::string sidecar_path = get_temp_path("waveform.peaks");
+  EXPECT_TRUE(summary.save(sidecar_path));
+
+  nano::waveform_summary loaded(file);
+  EXPECT_TRUE(loaded.load(sidecar_path));
+  EXPECT_TRUE(loaded.is_ready());
+
+  std::vector<nano::waveform_peak> a(16);
+  std::vector<nano::waveform_peak> b(16);
+  summary.get_columns(0, 0, 20000, a.size(), a.data());
+  loaded.get_columns(0, 0, 20000, b.size(), b.data());
+  EXPECT_EQ(std::memcmp(a.data(), b.data(), a.size() * sizeof(nano::waveform_peak)), 0);
+
+  std::shared_ptr<nano::mapped_audio_file> shorter = std::make_shared<nano::mapped_audio_file>();
+  EXPECT_TRUE(shorter->open_raw(path, nano::audio_format(), 4));
+  nano::waveform_summary mismatch(shorter);
+  EXPECT_FALSE(mismatch.load(sidecar_path));
+
+  std::remove(sidecar_path.c_str());
+  std::remove(path.c_str());
+}
@@ -0,0 +1,238 @@
+#include "nano/test.h"
+#include <nano/ui/x11.h>
+
+#if defined(__linux__)
+
+#include <nano/ui/pixel_buffer.h>
+
+#include <memory>
+#include <vector>
+
+#include <X11/Xlib.h>
+#include <X11/Xutil.h>
+
+namespace {
+class recording_view : public nano::view {
+public:
+  using nano::view::view;
+
+  std::vector<nano::event_type> types;
+  nano::point<float> position = { 0, 0 };
+  nano::point<float> wheel_delta = { 0, 0 };
+  std::int64_t click_count = 0;
+  nano::event_modifiers modifiers = nano::event_modifiers::none;
+
+protected:
+  void record(const nano::event& evt) {
+    types.push_back(evt.get_event_type());
+    position = evt.get_position();
+    wheel_delta = evt.get_wheel_delta();
+    click_count = evt.get_click_count();
+    modifiers = evt.get_modifiers();
+  }
+
+  virtual void on_mouse_down(const nano::event& evt) override { record(evt); }
+  virtual void on_mouse_up(const nano::event& evt) override { record(evt); }
+  virtual void on_mouse_dragged(const nano::event& evt) override { record(evt); }
+  virtual void on_mouse_moved(const nano::event& evt) override { record(evt); }
+  virtual void on_scroll_wheel(const nano::event& evt) override { record(evt); }
+};
+
+XEvent make_button_event(int type, unsigned int button, int x, int y, unsigned int state, Time time) {
+  XEvent evt = {};
+  evt.xbutton.type = type;
+  evt.xbutton.button = button;
+  evt.xbutton.x = x;
+  evt.xbutton.y = y;
+  evt.xbutton.x_root = x + 100;
+  evt.xbutton.y_root = y + 200;
+  evt.xbutton.state = state;
+  evt.xbutton.time = time;
+  return evt;
+}
+
+/// returns a connection to the display of the environment, null without one (e.g. not under Xvfb).
+std::unique_ptr<nano::x11_connection> open_display(nano::run_loop& loop) {
+  auto connection = std::make_unique<nano::x11_connection>(loop);
+  return connection->is_valid() ? std::move(connection) : nullptr;
+}
+
+/// reads a pixel of a window as r, g, b.
+std::uint32_t get_window_pixel(nano::x11_connection& connection, nano::x11_window_id window, int x, int y) {
+  XImage* image = XGetImage(connection.get_display(), window, x, y, 1, 1, AllPlanes, ZPixmap);
+  const unsigned long pixel = XGetPixel(image, 0, 0);
+  XDestroyImage(image);
+
+  // The default visuals are b, g, r in memory.
+  return nano::make_pixel(static_cast<std::uint8_t>(pixel >> 16), static_cast<std::uint8_t>(pixel >> 8),
+      static_cast<std::uint8_t>(pixel), 255);
+}
+} // namespace.
+
+TEST_CASE("nano.ui", x11_event) {
+  // The views are not x windows, events are translated to the coordinates of their view.
+  recording_view root(nano::rect<int>(0, 0, 200, 100));
+  recording_view child(&root, nano::rect<int>(50, 20, 100, 50));
+
+  XEvent down = make_button_event(ButtonPress, Button1, 60, 30, ShiftMask, 1000);
+  const nano::event evt(reinterpret_cast<nano::native_event_handle>(&down), &child);
+  EXPECT_TRUE(evt.get_event_type() == nano::event_type::left_mouse_down);
+  EXPECT_EQ(evt.get_position().x, 10.0f);
+  EXPECT_EQ(evt.get_position().y, 10.0f);
+  EXPECT_EQ(evt.get_window_position().x, 60.0f);
+  EXPECT_EQ(evt.get_screen_position().y, 230.0f);
+  EXPECT_EQ(evt.get_click_count(), 1);
+  EXPECT_TRUE(evt.is_shift_down());
+  EXPECT_FALSE(evt.is_ctrl_down());
+  EXPECT_EQ(evt.get_timestamp(), 1000000000u);
+
+  // A second press close in time and space.
+  XEvent second = make_button_event(ButtonPress, Button1, 61, 31, 0, 1200);
+  EXPECT_EQ(nano::event(reinterpret_cast<nano::native_event_handle>(&second), &child).get_click_count(), 2);
+
+  XEvent late = make_button_event(ButtonPress, Button1, 61, 31, 0, 2000);
+  EXPECT_EQ(nano::event(reinterpret_cast<nano::native_event_handle>(&late), &child).get_click_count(), 1);
+
+  // Dragging while the button is down.
+  XEvent motion = {};
+  motion.xmotion.type = MotionNotify;
+  motion.xmotion.x = 80;
+  motion.xmotion.y = 40;
+  motion.xmotion.state = Button1Mask;
+  const nano::event drag(reinterpret_cast<nano::native_event_handle>(&motion), &child);
+  EXPECT_TRUE(drag.get_event_type() == nano::event_type::left_mouse_dragged);
+  EXPECT_TRUE(drag.is_left_button_down());
+  EXPECT_EQ(drag.get_click_position().x, 11.0f);
+
+  // Wheel buttons.
+  XEvent wheel = make_button_event(ButtonPress, Button5, 60, 30, 0, 3000);
+  const nano::event scroll(reinterpret_cast<nano::native_event_handle>(&wheel), &child);
+  EXPECT_TRUE(scroll.get_event_type() == nano::event_type::scroll_wheel);
+  EXPECT_EQ(scroll.get_wheel_delta().y, -1.0f);
+
+  XEvent wheel_up = make_button_event(ButtonRelease, Button5, 60, 30, 0, 3000);
+  EXPECT_TRUE(nano::event(reinterpret_cast<nano::native_event_handle>(&wheel_up), &child).get_event_type()
+      == nano::event_type::none);
+}
+
+TEST_CASE("nano.ui", x11_view_tree) {
+  recording_view root(nano::rect<int>(0, 0, 200, 100));
+  recording_view a(&root, nano::rect<int>(10, 10, 100, 50));
+  recording_view b(&a, nano::rect<int>(20, 5, 30, 30));
+
+  EXPECT_EQ(b.get_position_in_window().x, 30);
+  EXPECT_EQ(b.get_position_in_window().y, 15);
+  EXPECT_EQ(b.convert_to_view(nano::point<int>(1, 1), &root).x, 31);
+  EXPECT_EQ(root.convert_to_view(nano::point<int>(31, 16), &b).y, 1);
+  EXPECT_EQ(b.convert_from_view(nano::point<int>(31, 16), &root).x, 1);
+
+  // Clipped by the parent.
+  a.set_frame(nano::rect<int>(10, 10, 40, 50));
+  const nano::rect<int> visible = b.get_visible_rect();
+  EXPECT_EQ(visible.width, 20);
+  EXPECT_EQ(visible.height, 30);
+
+  b.focus();
+  EXPECT_TRUE(b.is_focused());
+  a.focus();
+  EXPECT_FALSE(b.is_focused());
+  EXPECT_TRUE(a.is_focused());
+  a.unfocus();
+  EXPECT_FALSE(a.is_focused());
+
+  b.set_hidden(true);
+  EXPECT_TRUE(b.is_hidden());
+  EXPECT_FALSE(b.is_window());
+}
+
+TEST_CASE("nano.ui", x11_no_display) {
+  nano::run_loop loop;
+  nano::x11_connection connection(loop, ":4242");
+  EXPECT_FALSE(connection.is_valid());
+  EXPECT_EQ(connection.dispatch_events(), 0u);
+
+  // Nothing is presented without a window.
+  nano::x11_presenter presenter(connection, 0);
+  nano::pixel_buffer frame(16, 16);
+  presenter.present(frame, nano::region(frame.get_bounds()));
+  EXPECT_EQ(presenter.get_stats().frames, 0u);
+}
+
+TEST_CASE("nano.ui", x11_presenter) {
+  nano::run_loop loop;
+  std::unique_ptr<nano::x11_connection> connection = open_display(loop);
+  if (!connection) {
+    return;
+  }
+
+  Display* display = connection->get_display();
+  const nano::x11_window_id window = XCreateSimpleWindow(display, connection->get_root_window(), 0, 0, 64, 64, 0, 0, 0);
+  XMapWindow(display, window);
+  connection->sync();
+
+  nano::x11_presenter presenter(*connection, window);
+  nano::pixel_buffer frame(64, 64);
+  frame.clear(nano::make_pixel(255, 0, 0, 255));
+
+  // The first frame is uploaded whole.
+  presenter.present(frame, nano::region(nano::rect<int>(0, 0, 8, 8)));
+  EXPECT_EQ(presenter.get_stats().uploaded_pixels, 64u * 64u);
+  EXPECT_EQ(presenter.get_stats().allocations, 1u);
+  EXPECT_TRUE(presenter.is_using_shm() == connection->has_shm());
+  EXPECT_EQ(get_window_pixel(*connection, window, 40, 40), nano::make_pixel(255, 0, 0, 255));
+
+  // Then only the damage.
+  frame.clear(nano::make_pixel(0, 0, 255, 255));
+  presenter.present(frame, nano::region(nano::rect<int>(0, 0, 16, 8)));
+  EXPECT_EQ(presenter.get_stats().uploaded_pixels, 64u * 64u + 16u * 8u);
+  EXPECT_EQ(get_window_pixel(*connection, window, 4, 4), nano::make_pixel(0, 0, 255, 255));
+  EXPECT_EQ(get_window_pixel(*connection, window, 40, 40), nano::make_pixel(255, 0, 0, 255));
+
+  // A new size reallocates the image.
+  frame.resize(32, 32);
+  presenter.present(frame, nano::region(nano::rect<int>(0, 0, 1, 1)));
+  EXPECT_EQ(presenter.get_stats().allocations, 2u);
+
+  XDestroyWindow(display, window);
+  connection->sync();
+}
+
+TEST_CASE("nano.ui", x11_window_events) {
+  nano::run_loop& loop = nano::run_loop::get_main();
+  nano::x11_connection& connection = nano::x11_connection::get_main();
+  if (!connection.is_valid()) {
+    return;
+  }
+
+  nano::window win(nano::window_flags::default_flags);
+  EXPECT_TRUE(win.is_window());
+  win.set_title("x11 tests");
+  win.set_window_frame(nano::rect<int>(0, 0, 200, 100));
+
+  recording_view child(&win, nano::rect<int>(50, 20, 100, 50));
+  connection.sync();
+
+  // Events sent to the window go through the connection on the run loop.
+  const nano::x11_window_id id = reinterpret_cast<std::uintptr_t>(win.view::get_native_handle());
+  XEvent press = make_button_event(ButtonPress, Button1, 60, 30, 0, CurrentTime);
+  press.xbutton.window = id;
+  press.xbutton.display = connection.get_display();
+  XEvent release = make_button_event(ButtonRelease, Button1, 300, 30, Button1Mask, CurrentTime);
+  release.xbutton.window = id;
+  release.xbutton.display = connection.get_display();
+
+  XSendEvent(connection.get_display(), id, False, ButtonPressMask, &press);
+  XSendEvent(connection.get_display(), id, False, ButtonReleaseMask, &release);
+  connection.sync();
+
+  while (child.types.size() < 2 && loop.run_once(1000)) {
+  }
+
+  // The release outside of the view goes to the view that got the press.
+  EXPECT_EQ(child.types.size(), 2u);
+  EXPECT_TRUE(child.types.front() == nano::event_type::left_mouse_down);
+  EXPECT_TRUE(child.types.back() == nano::event_type::left_mouse_up);
+  EXPECT_EQ(child.position.x, 250.0f);
+}
+
+#endif